@@ -28,8 +28,11 @@
 #include "mcs_math_const.h"
 #include "mcs_math.h"
 #include "mcs_carrier.h"
+#include "mcs_rate_sched.h"
 
 #define APT_FULL_DUTY 1.0f
+#define SCHED_ISR_CP  0   /* Scheduler ISR id of the compressor carrier, added first */
+#define SCHED_ISR_FAN 1   /* Scheduler ISR id of the fan carrier */
 
 /* Motor parameters */
 /* Np, Rs, Ld, Lq, Psif, J, Nmax, Currmax, PPMR, zShift */
@@ -73,6 +76,9 @@ static MTRCTRL_Handle g_mc;
 /* Motor control handle for fan */
 static MTRCTRL_Handle g_fan;
 
+/* Compressor and fan carrier ISRs with the decimated loops */
+static MRS_Handle g_sched;
+
 /**
   * @brief Initialzer of system tick.
   * @param mtrCtrl Motor control struct handle.
@@ -805,6 +811,28 @@ static void InitSoftware(void)
     g_fan.readCurrBiasCb = readCurrBiasFanCb;
 }
 
+/**
+  * @brief Compressor speed loop and state machine, decimated from its carrier ISR.
+  * @param arg Unused.
+  * @retval None.
+  */
+static void TSK_SpdLoopCp(void *arg)
+{
+    BASE_FUNC_UNUSED(arg);
+    TSK_SystickIsr(&g_mc, g_aptCp);
+}
+
+/**
+  * @brief Fan speed loop and state machine, decimated from its carrier ISR.
+  * @param arg Unused.
+  * @retval None.
+  */
+static void TSK_SpdLoopFan(void *arg)
+{
+    BASE_FUNC_UNUSED(arg);
+    TSK_SystickIsr(&g_fan, g_aptFan);
+}
+
 /**
   * @brief Disable PWM output when IPM temperature too high.
   * @retval None.
@@ -826,18 +854,13 @@ static void OverTempProtProcess(void)
 }
 
 /**
-  * @brief System timer ISR function.
-  * @param param The systick timer handle.
+  * @brief Temperature protection task, decimated from the fan carrier ISR.
+  * @param arg Unused.
   * @retval None.
   */
-void Timer1ITCallBack(void *param)
+static void TSK_OverTempProt(void *arg)
 {
-    MCS_ASSERT_PARAM(param != NULL);
-    BASE_FUNC_UNUSED(param);
-    /* Motor speed loop execution and state control. */
-    TSK_SystickIsr(&g_mc, g_aptCp);
-    TSK_SystickIsr(&g_fan, g_aptFan);
-    /* Temperature protection process. */
+    BASE_FUNC_UNUSED(arg);
     OverTempProtProcess();
 }
 
@@ -846,32 +869,114 @@ volatile float g_mc_u, g_mc_v, g_mc_w;
 volatile float g_fan_u, g_fan_v, g_fan_w;
 volatile float g_currLoopExeTime;
 /**
-  * @brief The carrier ISR wrapper function, entry for both compressor and fan.
-  * @param aptHandle The APT handle.
+  * @brief The compressor carrier process.
+  * @param arg Unused.
   * @retval None.
   */
-void APT3TimerCallback(void *aptHandle)
+static void CarrierProcessCp(void *arg)
 {
     unsigned int start = SYSTICK_GetTimeStampUs();
-    MCS_ASSERT_PARAM(aptHandle != NULL);
+    BASE_FUNC_UNUSED(arg);
     /* the carrierprocess of comp */
     MCS_CarrierProcess(&g_mc);
     g_mc_u = g_mc.iuvw.u;
     g_mc_v = g_mc.iuvw.v;
     g_mc_w = g_mc.iuvw.w;
-    
+    g_currLoopExeTime = (float)(SYSTICK_GetTimeStampUs() - start);
+}
+
+/**
+  * @brief The fan carrier process.
+  * @param arg Unused.
+  * @retval None.
+  */
+static void CarrierProcessFan(void *arg)
+{
+    BASE_FUNC_UNUSED(arg);
     /* the carrierprocess of fan */
     MCS_CarrierProcess(&g_fan);
     g_fan_u = g_fan.iuvw.u;
     g_fan_v = g_fan.iuvw.v;
     g_fan_w = g_fan.iuvw.w;
+}
+
+/**
+  * @brief The compressor carrier ISR wrapper function, on the APT master.
+  * @param aptHandle The APT handle.
+  * @retval None.
+  */
+void APT3TimerCallback(void *aptHandle)
+{
+    MCS_ASSERT_PARAM(aptHandle != NULL);
     BASE_FUNC_UNUSED(aptHandle);
-    g_currLoopExeTime = (float)(SYSTICK_GetTimeStampUs() - start);
+    MRS_IsrRun(&g_sched, SCHED_ISR_CP);
+}
+
+/**
+  * @brief The fan carrier ISR wrapper function, its carrier is phase shifted from the compressor carrier.
+  * @param aptHandle The APT handle.
+  * @retval None.
+  */
+void APT0TimerCallback(void *aptHandle)
+{
+    MCS_ASSERT_PARAM(aptHandle != NULL);
+    BASE_FUNC_UNUSED(aptHandle);
+    MRS_IsrRun(&g_sched, SCHED_ISR_FAN);
+}
+
+/**
+  * @brief Config a slave APT of the compressor carrier.
+  * @param aptx The slave APT handle.
+  * @param isrId The scheduler ISR whose phase the slave carrier takes.
+  * @retval None.
+  */
+static void AptSlaveSet(APT_Handle *aptx, unsigned int isrId)
+{
+    MCS_ASSERT_PARAM(aptx != NULL);
+    APT_SlaveSyncIn slave;
+    MRS_AptSlaveSync(&g_sched, isrId, aptx, &slave);
+    slave.syncInSrc = APT_SYNCIN_SRC_APT3_SYNCOUT;
+    slave.cntrSyncSrc = APT_CNTR_SYNC_SRC_SYNCIN;
+    HAL_APT_SlaveSyncInit(aptx, &slave);
+}
+
+/**
+  * @brief Plan the carrier ISRs and the speed loops, then phase shift the fan carrier.
+  * @retval 0: planned, -1: an ISR or a task cannot be added or the budgets do not fit, the APTs must not be started.
+  */
+static int SchedInit(void)
+{
+    unsigned int spdLoopFreq = (unsigned int)(1.0f / CTRL_SYSTICK_PERIOD + 0.5f);
+    MRS_Init(&g_sched, DCL_SYSTICK_GetTick, SYSTICK_GetCRGHZ(), SCHED_GUARD_NS);
+    /* Compressor carrier on the APT master, then the fan carrier: the carrier callbacks use these ids. */
+    if (MRS_IsrAdd(&g_sched, CarrierProcessCp, NULL, APT_PWM_FREQ, SCHED_CARRIER_NS_CP) != SCHED_ISR_CP ||
+        MRS_IsrAdd(&g_sched, CarrierProcessFan, NULL, APT_PWM_FREQ, SCHED_CARRIER_NS_FAN) != SCHED_ISR_FAN) {
+        DBG_PRINTF("Sched ISR add failed\r\n");
+        return -1;
+    }
+    if (MRS_TaskAdd(&g_sched, SCHED_ISR_CP, TSK_SpdLoopCp, NULL, spdLoopFreq, SCHED_SPD_LOOP_NS) != 0 ||
+        MRS_TaskAdd(&g_sched, SCHED_ISR_FAN, TSK_SpdLoopFan, NULL, spdLoopFreq, SCHED_SPD_LOOP_NS) != 0 ||
+        MRS_TaskAdd(&g_sched, SCHED_ISR_FAN, TSK_OverTempProt, NULL, spdLoopFreq, SCHED_TEMP_PROT_NS) != 0) {
+        DBG_PRINTF("Sched task add failed\r\n");
+        return -1;
+    }
+    if (MRS_Plan(&g_sched) != 0) {
+        DBG_PRINTF("Sched plan failed\r\n");
+        return -1;
+    }
+    /* Compressor phases follow APT3 directly, the fan phases take the planned offset. */
+    HAL_APT_MasterSyncInit(&g_apt3, APT_SYNC_OUT_ON_CNTR_ZERO);
+    AptSlaveSet(&g_apt4, SCHED_ISR_CP);
+    AptSlaveSet(&g_apt5, SCHED_ISR_CP);
+    AptSlaveSet(&g_apt0, SCHED_ISR_FAN);
+    AptSlaveSet(&g_apt1, SCHED_ISR_FAN);
+    AptSlaveSet(&g_apt2, SCHED_ISR_FAN);
+    return 0;
 }
 
 /**
   * @brief User application entry.
-  * @retval BSP_OK.
+  * @retval -1 if the carrier ISRs cannot be planned, otherwise it does not return.
   */
 int MotorMain(void)
 {
@@ -880,14 +985,16 @@ int MotorMain(void)
 
     SystemInit();
 
-    HAL_TIMER_Start(&g_timer1);
-
     /* Disable PWM output before startup. */
     MotorPwmOutputDisable(g_aptCp);
     MotorPwmOutputDisable(g_aptFan);
 
     /* Software initialization. */
     InitSoftware();
+    if (SchedInit() != 0) {
+        /* Overlapping carrier ISRs would overrun each other: keep the PWM clock stopped and the outputs off. */
+        return -1;
+    }
     /* Start the PWM clock. */
     HAL_APT_StartModule(RUN_APT0 | RUN_APT1 | RUN_APT2 | RUN_APT3 | RUN_APT4 | RUN_APT5);
 
@@ -48,6 +48,13 @@
 #define SYSTICK_PERIOD_US    (CTRL_SYSTICK_PERIOD / 0.000001f) /* systick period (us) */
 #define MICROSECOND_NUM_PER_MILLISECOND 1000 /* Conversion between milliseconds and microseconds */
 
+/* Multi-rate scheduler: worst-case execution time measured on target, ns */
+#define SCHED_GUARD_NS          1000u   /* Guard between the compressor and fan carrier ISRs */
+#define SCHED_CARRIER_NS_CP     25000u  /* Compressor carrier ISR */
+#define SCHED_CARRIER_NS_FAN    25000u  /* Fan carrier ISR */
+#define SCHED_SPD_LOOP_NS       5000u   /* Speed loop and state machine of one motor */
+#define SCHED_TEMP_PROT_NS      4000u   /* IPM over temperature detection */
+
 /* Np, Rs, Ld, Lq, Psif, J, Nmax, Currmax, */
 #define MOTOR_PARAM_NP               (4)          /* Pole pairs. */
 #define MOTOR_PARAM_RS               (0.45f)       /* Phase resistance (Ohm). */
@@ -28,7 +28,7 @@
 #include "debug.h"
 #include "mcs_assert.h"
 #include "mcs_user_config.h"
-#include "mcs_status.h"
+#include "mcs_sys_status.h"
 #include "mcs_carrier.h"
 #include "mcs_motor_process.h"
 
@@ -41,6 +41,15 @@ static MtrCtrlHandle g_mc;
 
 static APT_RegStruct* g_aptCp[PHASE_MAX_NUM] = {BRIDGE_CTR_APT_U, BRIDGE_CTR_APT_V, BRIDGE_CTR_APT_W};
 
+/* Comparator inputs and timings of the event-driven commutation. */
+static const BEMF_EventCfg g_bemfEvtCfg = {
+    .phaseIn = {BEMF_ACMP_IN_U, BEMF_ACMP_IN_V, BEMF_ACMP_IN_W},
+    .neutralIn = BEMF_ACMP_IN_NEUTRAL,
+    .zcDelayComp = BEMF_ZC_DELAY_COMP,
+    .blankMin = BEMF_BLANK_MIN,
+    .tickShift = BEMF_TICK_TO_TIMER_SHIFT,
+};
+
 /**
   * @brief Initialzer of system tick.
   * @param mtrCtrl Motor control struct handle.
@@ -91,19 +100,6 @@ static void AptMasterSalveSet(void)
     APT_SyncSlaveInit(&g_apt2);
 }
 
-/**
-  * @brief Read the ADC current sampling value of the compressor.
-  * @param CurrUvw Three-phase current.
-  * @retval None.
-  */
-static void ReadBemfUVWMotor(UVWBemf *bemfUVW)
-{
-    MCS_ASSERT_PARAM(bemfUVW != NULL);
-    bemfUVW->u = (int)(HAL_ADC_GetConvResult(&g_adc0, ADC_SOC_NUM2)&0xFFF);
-    bemfUVW->v = (int)(HAL_ADC_GetConvResult(&g_adc0, ADC_SOC_NUM5)&0xFFF);
-    bemfUVW->w = (int)(HAL_ADC_GetConvResult(&g_adc0, ADC_SOC_NUM6)&0xFFF);
-}
-
 /**
   * @brief Init motor control task.
   * @retval None.
@@ -115,9 +111,8 @@ static void TSK_InitMotor(void)
     /* zeroPoint = IN_VOLTAGE_BUS / 2.0; 4095/3.3 :ADC value corresponding to 1 V */
     g_mc.zeroPoint = ((((float)IN_VOLTAGE_BUS / 2.0) * VOL_DIVIDER_COEFFICIENT) * 4095 / 3.3);
     g_mc.pwmDuty = FORCE_DRAG_MINDUTY;
+    g_mc.sysTickFreq = HAL_CRG_GetIpFreq(SYSTICK_BASE);
 
-    /* Sets the number of sample filtering times for zero-crossing sampling. */
-    g_mc.sysVar.bemfFilterCnt = FILTER_COUNT;
     g_mc.sysVar.dragChangePhaseTime = DRAG_START_INTERVAL;
 
     g_mc.stateMachine = FSM_IDLE;
@@ -139,6 +134,15 @@ static void TSK_InitMotor(void)
     g_mc.stepCtrl.controlApt.u = &g_apt0;
     g_mc.stepCtrl.controlApt.v = &g_apt1;
     g_mc.stepCtrl.controlApt.w = &g_apt2;
+
+    /* Event-driven commutation: comparator on the floating phase, one-shot timer for delay and blanking. */
+    g_mc.bemfEvt.acmp = g_acmp0.baseAddress;
+    g_mc.bemfEvt.timer = g_timer0.baseAddress;
+    g_mc.bemfEvt.stepCtrl = &g_mc.stepCtrl;
+    g_mc.bemfEvt.getTick = DCL_SYSTICK_GetTick;
+    BEMF_EventInit(&g_mc.bemfEvt, &g_bemfEvtCfg);
+    /* Virtual neutral: 12-bit ADC zero point to the 10-bit DAC. */
+    HAL_DAC_SetValue(&g_dac0, g_mc.zeroPoint >> 2); /* 2 : 12-bit to 10-bit. */
 }
 
 
@@ -149,8 +153,6 @@ static void TSK_InitMotor(void)
 static void InitSoftware(void)
 {
     TSK_InitMotor();
-
-    g_mc.readBemfUVW = ReadBemfUVWMotor;
 }
 
 /**
@@ -204,7 +206,6 @@ static void ForceAlign(MtrCtrlHandle *mtrCtrl)
     mtrCtrl->stepCtrl.phaseStep = STEP1;
     SixStepPwm(&mtrCtrl->stepCtrl);
     BASE_FUNC_DELAY_MS(100); /* Delay 100 ms waiting for rotor alignment. */
-    mtrCtrl->sysVar.lastZeroPoint = DCL_SYSTICK_GetTick();
 }
 
 /**
@@ -285,10 +286,8 @@ static void ClearBeforeStartup(MtrCtrlHandle *mtrCtrl)
     MCS_ASSERT_PARAM(mtrCtrl != NULL);
     mtrCtrl->aptMaxcntCmp = g_apt0.waveform.timerPeriod;
 
-    /* Clear bemf parameters. */
-    mtrCtrl->bemf.u = 0;
-    mtrCtrl->bemf.v = 0;
-    mtrCtrl->bemf.w = 0;
+    /* Stop the zero crossing and commutation interrupts. */
+    BEMF_EventStop(&mtrCtrl->bemfEvt);
 
     /* Clear tickcnt. */
     mtrCtrl->msTickCnt = 0;
@@ -304,13 +303,6 @@ static void ClearBeforeStartup(MtrCtrlHandle *mtrCtrl)
     mtrCtrl->sysTickCnt = 0;
 
     mtrCtrl->sysVar.dragChangePhaseTime = DRAG_START_INTERVAL;
-    mtrCtrl->sysVar.changePhaseFlag = 0;
-    mtrCtrl->sysVar.firstEventFilterFlag = 0;
-    mtrCtrl->sysVar.stepTimeNum = 0;
-    mtrCtrl->sysVar.stepTimeFilterEnable = 0;
-    for (int i = 0; i < STEP_MAX_NUM; i++) {
-        mtrCtrl->sysVar.stepTime[i] = 0;
-    }
     /* RMG CLEAR */
     RMG_Clear(&mtrCtrl->spdRmg); /* Clear the history value of speed slope control */
     /* SPDCTRL CLEAR */
@@ -388,11 +380,14 @@ static void TSK_SystickIsr(MtrCtrlHandle *mtrCtrl, APT_RegStruct **aptAddr)
         case FSM_RUN:
             /* Speed ramp control */
             mtrCtrl->spdRefHz = RMG_Exec(&mtrCtrl->spdRmg, mtrCtrl->spdCmdHz);
+            /* The only divide of the speed estimate, at the speed loop rate. */
+            mtrCtrl->spdEstHz = BEMF_EventGetSpdHz(&mtrCtrl->bemfEvt, mtrCtrl->sysTickFreq);
             mtrCtrl->spdPi.error = mtrCtrl->spdRefHz - mtrCtrl->spdEstHz;
             /* Speed loop control */
             mtrCtrl->pwmDuty = PI_Exec(&mtrCtrl->spdPi);
             break;
         case FSM_STOP:
+            BEMF_EventStop(&mtrCtrl->bemfEvt);
             MotorPwmOutputDisable(aptAddr);
             SysRunningClr(statusReg);
             *stateMachine = FSM_IDLE;
@@ -415,6 +410,7 @@ void MotorSysErrCallback(void *aptHandle)
 {
     /* Overcurrent protection callback function. */
     BASE_FUNC_UNUSED(aptHandle);
+    BEMF_EventStop(&g_mc.bemfEvt);
     MotorPwmOutputDisable(g_aptCp);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_aptCp[PHASE_U], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_aptCp[PHASE_V], APT_OC_COMBINE_EVENT_A1);
@@ -431,11 +427,10 @@ void MotorSysErrCallback(void *aptHandle)
   */
 static void MotorBlockageProtect(void)
 {
-    unsigned int currentTick = DCL_SYSTICK_GetTick(); /* Get the current tick value. */
-    unsigned int intervalTick = (currentTick >= g_mc.sysVar.lastZeroPoint)
-                              ? currentTick - g_mc.sysVar.lastZeroPoint
-                              : SYSTICK_MAX_VALUE - g_mc.sysVar.lastZeroPoint + currentTick + 1;
-    if (intervalTick > SYSTICK_GetCRGHZ()) {
+    /* The unsigned difference also holds across the systick wrap. */
+    unsigned int intervalTick = DCL_SYSTICK_GetTick() - g_mc.bemfEvt.lastZcTick;
+    if (intervalTick > g_mc.sysTickFreq) {
+        BEMF_EventStop(&g_mc.bemfEvt);
         MotorPwmOutputDisable(g_aptCp);
         SysErrorSet(&g_mc.statusReg);
         g_mc.spdEstHz = 0;
@@ -459,6 +454,28 @@ void MotorCarrierProcessCallback(void *aptHandle)
     /* USER CODE END APT0_TIMER_INTERRUPT */
 }
 
+/**
+  * @brief Comparator edge interrupt: back-EMF zero crossing of the floating phase.
+  * @param handle The ACMP handle.
+  * @retval None.
+  */
+void MotorBemfZeroCrossCallback(void *handle)
+{
+    BASE_FUNC_UNUSED(handle);
+    BEMF_EventZeroCross(&g_mc.bemfEvt);
+}
+
+/**
+  * @brief One-shot timer interrupt: commutation delay or blanking elapsed.
+  * @param handle The TIMER0 handle.
+  * @retval None.
+  */
+void MotorCommutationCallback(void *handle)
+{
+    BASE_FUNC_UNUSED(handle);
+    BEMF_EventTimer(&g_mc.bemfEvt);
+}
+
 /**
   * @brief Change phase delay callback function.
   * @param handle The TIMER1 Handle.
@@ -51,9 +51,14 @@
 #define DRAG_START_INTERVAL 1000        /* Force drag change phase every 48 ms.(1000 * 60us = 60ms) */
 #define DRAG_STOP_INTERVAL  400         /* Force drag change phase every 24 ms.(200 * 60us = 12ms) */
 
-/* Parameters of the motor in the RUN */
-#define FILTER_COUNT        3           /* Filter Times */
-#define PHASE_OFFSET        9000        /* Phase delay due to filtering */
+/* Parameters of the motor in the RUN: zero crossing by ACMP0 edge interrupt, commutation by TIMER0 one-shot */
+#define BEMF_ACMP_IN_U      ACMP_INPUT_P_SELECT2    /* Comparator input of the U phase divider (GPIO0_5) */
+#define BEMF_ACMP_IN_V      ACMP_INPUT_P_SELECT3    /* Comparator input of the V phase divider (GPIO2_5) */
+#define BEMF_ACMP_IN_W      ACMP_INPUT_P_SELECT4    /* Comparator input of the W phase divider (GPIO3_5) */
+#define BEMF_ACMP_IN_NEUTRAL ACMP_INPUT_N_SELECT0   /* Virtual neutral from the DAC */
+#define BEMF_ZC_DELAY_COMP  1500        /* Comparator filter and interrupt latency, 10us (150 systick per us) */
+#define BEMF_BLANK_MIN      7500        /* Minimum demagnetization blanking after commutation, 50us */
+#define BEMF_TICK_TO_TIMER_SHIFT 0      /* TIMER0 counts at the systick clock without prescaler */
 
 #define APT_DUTYLIMIT_MAX   99.9        /* Maximum duty cycle of the output APT */
 #define APT_DUTYLIMIT_MIN   8.0        /* Minimum duty cycle of the output APT */
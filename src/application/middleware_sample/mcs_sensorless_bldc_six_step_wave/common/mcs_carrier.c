@@ -112,9 +112,7 @@ static void ForceDragAcc(MtrCtrlHandle *mtrCtrl)
     if (mtrCtrl->sysVar.dragChangePhaseTime < DRAG_STOP_INTERVAL) {
         mtrCtrl->sysVar.dragChangePhaseTime = DRAG_STOP_INTERVAL;
         mtrCtrl->sysVar.accTimeCnt = 0;
-        mtrCtrl->sysVar.bemfFilterCnt = 0;
         mtrCtrl->stateMachine = FSM_RUN;
-        mtrCtrl->sysVar.lastZeroPoint = DCL_SYSTICK_GetTick();
         mtrCtrl->spdPi.integral = OP_TO_CL_INTERGRAL;
     }
 
@@ -123,7 +121,7 @@ static void ForceDragAcc(MtrCtrlHandle *mtrCtrl)
     /* 150 : 1us = 150 systick */
     mtrCtrl->sysVar.waitTime = (mtrCtrl->sysVar.dragChangePhaseTime * 83 * 150) >> 1; /* The count period is 83us. */
     /* 2 : Change phase time is 2 the waiting time. */
-    mtrCtrl->spdRefHz = (float)(HAL_CRG_GetIpFreq(SYSTICK_BASE) / (mtrCtrl->sysVar.waitTime * 2)) / STEP_MAX_NUM;
+    mtrCtrl->spdRefHz = (float)(mtrCtrl->sysTickFreq / (mtrCtrl->sysVar.waitTime * 2)) / STEP_MAX_NUM;
     mtrCtrl->spdEstHz = mtrCtrl->spdRefHz;
     mtrCtrl->spdRmg.yLast = mtrCtrl->spdRefHz;
     mtrCtrl->stepCtrl.phaseStep = (mtrCtrl->stepCtrl.phaseStep + 1) % STEP_MAX_NUM;
@@ -136,96 +134,14 @@ static void ForceDragAcc(MtrCtrlHandle *mtrCtrl)
         mtrCtrl->pwmDuty = FORCE_DRAG_MINDUTY;
     }
     MCS_SetCtrAptDuty(mtrCtrl, mtrCtrl->pwmDuty);
-}
-
-/**
-  * @brief Zero-crossing filter.
-  * @param mtrCtrl The motor control handle.
-  * @retval None.
-  */
-static void BemfZeroSampleFilter(MtrCtrlHandle *mtrCtrl)
-{
-    MCS_ASSERT_PARAM(mtrCtrl != NULL);
-    mtrCtrl->sysVar.bemfFilterCnt++;
-    /* Filter the number of samples. */
-    if (mtrCtrl->sysVar.bemfFilterCnt >= FILTER_COUNT) {
-        mtrCtrl->sysVar.bemfFilterCnt = 0;
-        unsigned int currentTick = DCL_SYSTICK_GetTick();
-        if (mtrCtrl->sysVar.firstEventFilterFlag == 0) {
-            mtrCtrl->sysVar.lastZeroPoint = currentTick;
-            mtrCtrl->sysVar.changePhaseFlag = 1;
-            mtrCtrl->sysVar.firstEventFilterFlag = 1;
-            return;
-        }
-        /* Calculate the time interval between the last zero crossing. */
-        mtrCtrl->sysVar.stepTime[mtrCtrl->stepCtrl.phaseStep] = currentTick >= mtrCtrl->sysVar.lastZeroPoint
-            ? currentTick - mtrCtrl->sysVar.lastZeroPoint
-            : SYSTICK_MAX_VALUE - mtrCtrl->sysVar.lastZeroPoint + currentTick + 1;
-        mtrCtrl->sysVar.stepTimeNum++;
-        /* Wait time is half the interval. */
-        mtrCtrl->sysVar.waitTime = mtrCtrl->sysVar.stepTime[mtrCtrl->stepCtrl.phaseStep] >> 1;
-        mtrCtrl->sysVar.waitTime -= PHASE_OFFSET;
-        mtrCtrl->sysVar.lastZeroPoint = currentTick;
-        /* Update flag. */
-        mtrCtrl->sysVar.changePhaseFlag = 1;
-    }
-}
-
-/**
-  * @brief Back EMF zero crossing check.
-  * @param mtrCtrl The motor control handle.
-  * @retval None.
-  */
-static void BemfZeroCheck(MtrCtrlHandle *mtrCtrl)
-{
-    /* The step corresponds to different conditional judgments. */
-    unsigned int bemfCheckTable[STEP_MAX_NUM] = {mtrCtrl->bemf.w < mtrCtrl->zeroPoint ? 1 : 0,
-                                                 mtrCtrl->bemf.v > mtrCtrl->zeroPoint ? 1 : 0,
-                                                 mtrCtrl->bemf.u < mtrCtrl->zeroPoint ? 1 : 0,
-                                                 mtrCtrl->bemf.w > mtrCtrl->zeroPoint ? 1 : 0,
-                                                 mtrCtrl->bemf.v < mtrCtrl->zeroPoint ? 1 : 0,
-                                                 mtrCtrl->bemf.u > mtrCtrl->zeroPoint ? 1 : 0};
-
-    if (bemfCheckTable[mtrCtrl->stepCtrl.phaseStep] == 1) {
-        BemfZeroSampleFilter(mtrCtrl);
-    }
-}
-
-/**
-  * @brief Change phase and speed estimation.
-  * @param mtrCtrl The motor control handle.
-  * @retval None.
-  */
-static void ChangePhase(MtrCtrlHandle *mtrCtrl)
-{
-    unsigned int currentTick = DCL_SYSTICK_GetTick(); /* Get the current tick value. */
-    unsigned int intervalTick = (currentTick >= mtrCtrl->sysVar.lastZeroPoint)
-                              ? currentTick - mtrCtrl->sysVar.lastZeroPoint
-                              : SYSTICK_MAX_VALUE - mtrCtrl->sysVar.lastZeroPoint + currentTick + 1;
-    /* Start average filtering when the number of recorded data reaches six. */
-    if (mtrCtrl->sysVar.stepTimeNum >= STEP_MAX_NUM) {
-        mtrCtrl->sysVar.stepTimeNum = 0;
-        mtrCtrl->sysVar.stepTimeFilterEnable = 1;
-    }
-    /* If the accumulated time is greater than the waiting commutation time, commutation is performed. */
-    if (intervalTick > mtrCtrl->sysVar.waitTime) {
-        if (mtrCtrl->sysVar.stepTimeFilterEnable) { /* 6-step commutation time averaging if filtering is enabled. */
-            unsigned int totalTime = mtrCtrl->sysVar.stepTime[STEP1] + mtrCtrl->sysVar.stepTime[STEP2]
-                                   + mtrCtrl->sysVar.stepTime[STEP3] + mtrCtrl->sysVar.stepTime[STEP4]
-                                   + mtrCtrl->sysVar.stepTime[STEP5] + mtrCtrl->sysVar.stepTime[STEP6];
-            mtrCtrl->spdEstHz = (float)HAL_CRG_GetIpFreq(SYSTICK_BASE) / totalTime;
-        } else {
-            mtrCtrl->spdEstHz = (float)HAL_CRG_GetIpFreq(SYSTICK_BASE) / (mtrCtrl->sysVar.waitTime << 1) / STEP_MAX_NUM;
-        }
-        /* Change phase. */
-        mtrCtrl->stepCtrl.phaseStep = (mtrCtrl->stepCtrl.phaseStep + 1) % STEP_MAX_NUM;
-        SixStepPwm(&mtrCtrl->stepCtrl);
-        mtrCtrl->sysVar.changePhaseFlag = 0;
+    /* From now on the zero crossings and commutations are driven by the comparator and timer interrupts. */
+    if (mtrCtrl->stateMachine == FSM_RUN) {
+        BEMF_EventStart(&mtrCtrl->bemfEvt, mtrCtrl->sysVar.waitTime * 2); /* 2 : Step time is 2 waiting time. */
     }
 }
 
 /**
-  * @brief Zero-crossing detection and change phase
+  * @brief Forced drag in start up, PWM duty update in run.
   * @param mtrCtrl The motor control handle.
   * @retval None.
   */
@@ -237,14 +153,7 @@ void MCS_CarrierProcess(MtrCtrlHandle *mtrCtrl)
         /* Forced drag. */
         ForceDragAcc(mtrCtrl);
     } else if (mtrCtrl->stateMachine == FSM_RUN) {
-        mtrCtrl->readBemfUVW(&mtrCtrl->bemf);
+        /* Zero crossings and commutations are handled by BEMF_EventZeroCross and BEMF_EventTimer. */
         MCS_SetCtrAptDuty(mtrCtrl, mtrCtrl->pwmDuty);
-        if (mtrCtrl->sysVar.changePhaseFlag) {
-            /* Change phase process. */
-            ChangePhase(mtrCtrl);
-        } else {
-            /* Zero-crossing detection procedure. */
-            BemfZeroCheck(mtrCtrl);
-        }
     }
 }
\ No newline at end of file
@@ -22,39 +22,20 @@
 #ifndef McuMagicTag_MCS_CARRIER_H
 #define McuMagicTag_MCS_CARRIER_H
 
-#include "mcs_status.h"
+#include "mcs_sys_status.h"
 #include "mcs_six_step.h"
+#include "mcs_bemf_event.h"
 #include "mcs_ramp_mgmt.h"
 #include "mcs_spd_ctrl.h"
 #include "mcs_fsm.h"
 
-/**
-  * @brief Three-phase static coordinate frame variable.
-  */
-typedef struct {
-    unsigned int u; /**< Component u of the three-phase static coordinate frame variable. */
-    unsigned int v; /**< Component v of the three-phase static coordinate frame variable. */
-    unsigned int w; /**< Component w of the three-phase static coordinate frame variable. */
-} UVWBemf;
-
-typedef void (*ReadBemf)(UVWBemf *bemfUVW);
-
 /**
   * @brief The definition of the systematic global variables
   */
 typedef struct {
-    unsigned char changePhaseFlag;          /**< Flag indicating that delay change phase is required */
-    unsigned char firstEventFilterFlag;     /**< First zero-crossing event filtering flag. */
     unsigned int  dragChangePhaseTime;      /**< Interval for forced drag acceleration */
     unsigned int  accTimeCnt;               /**< Acceleration time count */
-
-    unsigned int  bemfFilterCnt;            /**< Number of sample filtering times for zero-crossing detection. */
-
-    unsigned int  lastZeroPoint;            /**< Time of the last zero point */
     unsigned int  waitTime;                 /**< Time to wait for change phase */
-    unsigned int  stepTime[STEP_MAX_NUM];   /**< Record the time spent on each step */
-    unsigned int  stepTimeNum;              /**< Number of data records in the steptime array. */
-    unsigned int  stepTimeFilterEnable;
 } SysVariable;
 
 typedef struct {
@@ -64,6 +45,7 @@ typedef struct {
     float spdEstHz;                         /**< Actual change phase frequency of feedback */
     float pwmDuty;                          /**< APT duty cycle  */
     unsigned int zeroPoint;                 /**< Adc value of zero point */
+    unsigned int sysTickFreq;               /**< Systick frequency (Hz), the timestamp clock */
     
     unsigned short aptMaxcntCmp;            /**< Apt Maximum Comparison Count */
 
@@ -75,14 +57,12 @@ typedef struct {
     RMG_Handle spdRmg;                       /**< Ramp management struct for the speed controller input reference */
     PID_Handle spdPi;                        /**< PI controller struct in the speed controller. */
 
-    UVWBemf bemf;                           /**< Three-phase back electromotive force */
     SixStepHandle stepCtrl;                 /**< Control structure of six-step square wave */
+    BEMF_EventHandle bemfEvt;               /**< Zero crossing capture and timed commutation in FSM_RUN */
 
     SysVariable sysVar;                     /**< System Variables */
     SysStatusReg statusReg;                 /**< System Status */
     FsmState stateMachine;                  /**< BLDC Motor Control State Machine */
-
-    ReadBemf readBemfUVW;                   /**< Function interface for obtaining the three-phase electromotive force */
 } MtrCtrlHandle;
 
 void MCS_CarrierProcess(MtrCtrlHandle *mtrCtrl);
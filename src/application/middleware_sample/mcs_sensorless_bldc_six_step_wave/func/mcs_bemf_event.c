@@ -0,0 +1,216 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_bemf_event.c
+  * @author    MCU Algorithm Team
+  * @brief     This file provides the event-driven back-EMF zero crossing and commutation.
+  * @details   One comparator watches the floating phase against the virtual neutral and interrupts on the
+  *            crossing edge. The crossing is timestamped, a one-shot timer is loaded with the 30 degree delay
+  *            and the commutation runs from the timer interrupt, so it does not wait for the next PWM period.
+  *            After the commutation the same timer runs the demagnetization blanking before the comparator is
+  *            armed again. The speed comes from the running sum of the last six intervals, no divide is done
+  *            in the interrupts.
+  */
+
+#include "mcs_bemf_event.h"
+#include "mcs_assert.h"
+
+#define BEMF_ACMP_INT_NEG       0x2U    /* Falling edge bit of the ACMP interrupt registers. */
+#define BEMF_ACMP_INT_POS       0x4U    /* Rising edge bit of the ACMP interrupt registers. */
+#define BEMF_ACMP_INT_ALL       0x7U
+#define BEMF_DELAY_DIV          (STEP_MAX_NUM * 2)  /* 30 degree = electrical period / 12. */
+#define BEMF_BLANK_DIV          (STEP_MAX_NUM * 4)  /* 15 degree = electrical period / 24. */
+
+/* Floating phase and direction of its back-EMF in each step. */
+static const unsigned char g_floatPhase[STEP_MAX_NUM] = {W, V, U, W, V, U};
+static const unsigned char g_zcRising[STEP_MAX_NUM] = {0, 1, 0, 1, 0, 1};
+
+/**
+  * @brief Load the one-shot timer.
+  * @param evt Commutation handle.
+  * @param ticks Delay (tick).
+  * @retval None.
+  */
+static void BemfEvtTimerStart(BEMF_EventHandle *evt, unsigned int ticks)
+{
+    unsigned int cnt = ticks >> evt->cfg->tickShift;
+    DCL_TIMER_SetLoad(evt->timer, (cnt == 0) ? 1 : cnt);
+    DCL_TIMER_Enable(evt->timer);
+}
+
+/**
+  * @brief Record a zero crossing and schedule the commutation 30 degree later.
+  * @param evt Commutation handle.
+  * @param zcTick Zero crossing timestamp.
+  * @retval None.
+  */
+static void BemfEvtOnZeroCross(BEMF_EventHandle *evt, unsigned int zcTick)
+{
+    /* The unsigned difference also holds across the counter wrap. */
+    unsigned int interval = zcTick - evt->lastZcTick;
+    evt->lastZcTick = zcTick;
+    evt->periodTicks = evt->periodTicks - evt->stepTicks[evt->stepIdx] + interval;
+    evt->stepTicks[evt->stepIdx] = interval;
+    evt->stepIdx = (evt->stepIdx + 1 >= STEP_MAX_NUM) ? 0 : evt->stepIdx + 1;
+    evt->zcCnt++;
+
+    unsigned int delay = evt->periodTicks / BEMF_DELAY_DIV;
+    delay = (delay > evt->cfg->zcDelayComp) ? (delay - evt->cfg->zcDelayComp) : 0;
+    evt->state = BEMF_EVT_COMMUTATE;
+    BemfEvtTimerStart(evt, delay);
+}
+
+/**
+  * @brief Initialization of the commutation engine, acmp, timer, stepCtrl and getTick are set by the user.
+  * @param evt Commutation handle.
+  * @param cfg Board configuration, must stay valid.
+  * @retval None.
+  */
+void BEMF_EventInit(BEMF_EventHandle *evt, const BEMF_EventCfg *cfg)
+{
+    MCS_ASSERT_PARAM(evt != NULL);
+    MCS_ASSERT_PARAM(cfg != NULL);
+    evt->cfg = cfg;
+    evt->state = BEMF_EVT_IDLE;
+    evt->lastZcTick = 0;
+    evt->periodTicks = 0;
+    evt->stepIdx = 0;
+    evt->zcCnt = 0;
+    evt->lateZcCnt = 0;
+    for (unsigned int i = 0; i < STEP_MAX_NUM; i++) {
+        evt->stepTicks[i] = 0;
+    }
+}
+
+/**
+  * @brief Hand over from the open-loop drag, call it right after a drag commutation.
+  * @param evt Commutation handle.
+  * @param stepTicks Drag step interval (tick), seeds the period estimate.
+  * @retval None.
+  */
+void BEMF_EventStart(BEMF_EventHandle *evt, unsigned int stepTicks)
+{
+    MCS_ASSERT_PARAM(evt != NULL);
+    MCS_ASSERT_PARAM(evt->acmp != NULL && evt->timer != NULL && evt->stepCtrl != NULL && evt->getTick != NULL);
+    for (unsigned int i = 0; i < STEP_MAX_NUM; i++) {
+        evt->stepTicks[i] = stepTicks;
+    }
+    evt->periodTicks = stepTicks * STEP_MAX_NUM;
+    evt->stepIdx = 0;
+    /* The drag commutation is taken as 30 degree after the previous zero crossing. */
+    evt->lastZcTick = evt->getTick() - (stepTicks >> 1);
+
+    unsigned char step = evt->stepCtrl->phaseStep;
+    evt->acmp->ACMP_INTR_MASK.reg = 0;
+    DCL_ACMP_SetInputSwith(evt->acmp, evt->cfg->phaseIn[g_floatPhase[step]], evt->cfg->neutralIn);
+    evt->state = BEMF_EVT_BLANK;
+    BemfEvtTimerStart(evt, evt->cfg->blankMin);
+}
+
+/**
+  * @brief Stop the commutation engine, the bridge output is left to the caller.
+  * @param evt Commutation handle.
+  * @retval None.
+  */
+void BEMF_EventStop(BEMF_EventHandle *evt)
+{
+    MCS_ASSERT_PARAM(evt != NULL);
+    evt->state = BEMF_EVT_IDLE;
+    if (evt->acmp != NULL) {
+        evt->acmp->ACMP_INTR_MASK.reg = 0;
+        evt->acmp->ACMP_INTR.reg = BEMF_ACMP_INT_ALL;
+    }
+    if (evt->timer != NULL) {
+        DCL_TIMER_Disable(evt->timer);
+    }
+}
+
+/**
+  * @brief Comparator edge interrupt, the floating phase crossed the neutral.
+  * @param evt Commutation handle.
+  * @retval None.
+  */
+void BEMF_EventZeroCross(BEMF_EventHandle *evt)
+{
+    MCS_ASSERT_PARAM(evt != NULL);
+    unsigned int zcTick = evt->getTick();
+    evt->acmp->ACMP_INTR_MASK.reg = 0;
+    if (evt->state != BEMF_EVT_WAIT_ZC) {
+        return;
+    }
+    BemfEvtOnZeroCross(evt, zcTick);
+}
+
+/**
+  * @brief One-shot timer interrupt: commutation at the end of the delay, comparator armed at the end of the blanking.
+  * @param evt Commutation handle.
+  * @retval None.
+  */
+void BEMF_EventTimer(BEMF_EventHandle *evt)
+{
+    MCS_ASSERT_PARAM(evt != NULL);
+    SixStepHandle *stepCtrl = evt->stepCtrl;
+    unsigned char step;
+    unsigned int blank;
+
+    switch (evt->state) {
+        case BEMF_EVT_COMMUTATE:
+            step = (stepCtrl->phaseStep + 1 >= STEP_MAX_NUM) ? STEP1 : stepCtrl->phaseStep + 1;
+            stepCtrl->phaseStep = step;
+            SixStepPwm(stepCtrl);
+            /* Watch the new floating phase once its winding current has decayed. */
+            DCL_ACMP_SetInputSwith(evt->acmp, evt->cfg->phaseIn[g_floatPhase[step]], evt->cfg->neutralIn);
+            blank = evt->periodTicks / BEMF_BLANK_DIV;
+            evt->state = BEMF_EVT_BLANK;
+            BemfEvtTimerStart(evt, (blank > evt->cfg->blankMin) ? blank : evt->cfg->blankMin);
+            break;
+
+        case BEMF_EVT_BLANK:
+            step = stepCtrl->phaseStep;
+            evt->state = BEMF_EVT_WAIT_ZC;
+            evt->acmp->ACMP_INTR.reg = BEMF_ACMP_INT_ALL;
+            evt->acmp->ACMP_INTR_MASK.reg = g_zcRising[step] ? BEMF_ACMP_INT_POS : BEMF_ACMP_INT_NEG;
+            /* At high speed the crossing may already be passed: no edge would come, take it now. */
+            if (DCL_ACMP_GetCmpOutValueAfterFilter(evt->acmp) == g_zcRising[step]) {
+                evt->acmp->ACMP_INTR_MASK.reg = 0;
+                evt->acmp->ACMP_INTR.reg = BEMF_ACMP_INT_ALL;
+                evt->lateZcCnt++;
+                BemfEvtOnZeroCross(evt, evt->getTick());
+            }
+            break;
+
+        default:
+            DCL_TIMER_Disable(evt->timer);
+            break;
+    }
+}
+
+/**
+  * @brief Electrical frequency from the period estimate, call it from a slow task.
+  * @param evt Commutation handle.
+  * @param tickFreq Frequency of the timestamp source (Hz).
+  * @retval Electrical frequency (Hz).
+  */
+float BEMF_EventGetSpdHz(const BEMF_EventHandle *evt, unsigned int tickFreq)
+{
+    MCS_ASSERT_PARAM(evt != NULL);
+    unsigned int periodTicks = evt->periodTicks;
+    if (periodTicks == 0) {
+        return 0.0f;
+    }
+    return (float)tickFreq / (float)periodTicks;
+}
@@ -0,0 +1,78 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_bemf_event.h
+  * @author    MCU Algorithm Team
+  * @brief     This file provides the event-driven back-EMF zero crossing and commutation declaration.
+  */
+
+#ifndef McuMagicTag_MCS_BEMF_EVENT_H
+#define McuMagicTag_MCS_BEMF_EVENT_H
+
+#include "acmp.h"
+#include "timer.h"
+#include "mcs_six_step.h"
+
+/**
+  * @brief Commutation engine state, each state waits for one hardware event.
+  */
+typedef enum {
+    BEMF_EVT_IDLE = 0,      /**< Stopped, comparator and timer interrupts unused. */
+    BEMF_EVT_BLANK,         /**< Timer running the demagnetization blanking after a commutation. */
+    BEMF_EVT_WAIT_ZC,       /**< Comparator edge interrupt armed on the floating phase. */
+    BEMF_EVT_COMMUTATE      /**< Timer running the 30 degree delay from the zero crossing. */
+} BEMF_EvtState;
+
+typedef unsigned int (*BEMF_GetTick)(void);
+
+/**
+  * @brief Board configuration of the commutation engine.
+  */
+typedef struct {
+    ACMP_InputPSel phaseIn[PHASE_MAX_NUMS]; /**< Comparator positive input of the U, V, W back-EMF divider. */
+    ACMP_InputNSel neutralIn;               /**< Comparator negative input, the virtual neutral. */
+    unsigned int zcDelayComp;               /**< Comparator filter and interrupt latency (tick). */
+    unsigned int blankMin;                  /**< Minimum blanking after a commutation (tick). */
+    unsigned int tickShift;                 /**< Commutation timer count = tick >> tickShift. */
+} BEMF_EventCfg;
+
+/**
+  * @brief Event-driven six-step commutation handle.
+  */
+typedef struct {
+    ACMP_RegStruct *acmp;                   /**< Comparator switched to the floating phase. */
+    TIMER_RegStruct *timer;                 /**< One-shot timer of the commutation delay and blanking. */
+    SixStepHandle *stepCtrl;                /**< Bridge driven at each commutation. */
+    BEMF_GetTick getTick;                   /**< Zero crossing timestamp source, free running. */
+    const BEMF_EventCfg *cfg;
+    volatile BEMF_EvtState state;
+    volatile unsigned int lastZcTick;       /**< Timestamp of the last zero crossing. */
+    unsigned int stepTicks[STEP_MAX_NUM];   /**< Last six zero crossing intervals. */
+    volatile unsigned int periodTicks;      /**< Running sum of stepTicks: one electrical period (tick). */
+    unsigned char stepIdx;                  /**< Oldest entry of stepTicks. */
+    unsigned int zcCnt;                     /**< Zero crossings seen. */
+    unsigned int lateZcCnt;                 /**< Zero crossings already passed when the blanking ended. */
+} BEMF_EventHandle;
+
+void BEMF_EventInit(BEMF_EventHandle *evt, const BEMF_EventCfg *cfg);
+void BEMF_EventStart(BEMF_EventHandle *evt, unsigned int stepTicks);
+void BEMF_EventStop(BEMF_EventHandle *evt);
+void BEMF_EventZeroCross(BEMF_EventHandle *evt);
+void BEMF_EventTimer(BEMF_EventHandle *evt);
+float BEMF_EventGetSpdHz(const BEMF_EventHandle *evt, unsigned int tickFreq);
+
+#endif
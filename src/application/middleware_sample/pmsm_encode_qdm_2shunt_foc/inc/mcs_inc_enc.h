@@ -28,9 +28,6 @@
 #include "qdm_ip.h"
 #include "mcs_ex_common.h"
 
-/* Macro definitions --------------------------------------------------------------------------- */
-#define SPDBUF_MAXSIZE 20
-
 /**
   * @brief QDM Peripheral management.
   */
@@ -57,12 +54,15 @@ typedef struct {
     unsigned int zShift;  /**< pulse Z shift */
     unsigned int mtrNp;   /**< numbers of pole pairs */
     float ctrlPeriod;     /**< The encoder calculates the control period. */
-    /**< the times of compute the angle, if reach the specified num, it will be reset to 0 again */
-    unsigned int timeNum;
+    unsigned int tsuFreq; /**< QDM time stamp unit clock (Hz) */
+    float obsBdw;         /**< Tracking observer bandwidth (Hz) */
 } MCS_EncInitStru;
 
 /**
   * @brief encoder control data structure.
+  * @details Every control period the position count is read together with the time since the last count edge
+  *          (QCTMRLOCK), which gives an M/T speed and a sub-count position. Both feed an alpha-beta tracking
+  *          observer, so angle and speed are updated every period with no buffer delay.
   */
 typedef struct {
     signed int pulsePerMechRound;           /**< pulses of each mechanical round */
@@ -72,23 +72,28 @@ typedef struct {
     float mechAngle;						/**< motor mechine angle */
     unsigned short cntNow;                  /**< counter for now */
     unsigned short cntPre;                  /**< counter of last record */
-    signed short pulsePos;                  /**< Number of pulses corresponding to mechanical
-                                                  position [-32768, 32767] */
+    signed int elecCnt;                     /**< Count at the last edge in the electrical round
+                                                 [0, pulsePerElecRound-1] */
     float elecSpeed;                        /**< elec speed, in HZ */
-    signed short speedBuf[SPDBUF_MAXSIZE];  /**< speed buffer */
-    signed short speedBufSize;              /**< speed buffer size */
-    signed short speedBufIndex;             /**< speed bufer index */
-    float pulseToHzPu;                      /**< pulse to HZ transition value */
 
-    unsigned short timeCnt;                 /**< times of compute the angle, the carrier ISR call times */
-    /**< the times of compute the angle, if reach the specified num, it will be reset to 0 again */
-    unsigned short timeNum;
+    unsigned int edgeAge;                   /**< TSU ticks since the last count edge */
+    unsigned int edgeAgePre;                /**< edgeAge of the last period */
+    unsigned int standstillTick;            /**< Time without edge after which the M/T speed is zero */
+    float tsuFreq;                          /**< TSU clock (Hz) */
+    float periodTick;                       /**< Control period in TSU ticks */
+    float mtSpeed;                          /**< M/T speed, counts per second */
+
+    float ts;                               /**< Control period (s) */
+    float obsPos;                           /**< Observer position, counts [0, pulsePerElecRound) */
+    float obsSpd;                           /**< Observer speed, counts per second */
+    float obsAlpha;                         /**< Observer position gain */
+    float obsBeta;                          /**< Observer speed gain from the position error */
+    float obsMtGain;                        /**< Observer speed gain from the M/T speed */
+    float pulseToElecAngle;                 /**< pulse to electricity angle (rad) transition */
 
     unsigned short pulZCnt;                 /**< counter of Z pulse */
-    unsigned short pulseAngle;              /**< Number of pulses corresponding to electrical angle.
-                                                 [0, pulsePerElecRound-1] */
-    float pulseToElecAngle;                 /**< pulse to electricity angle transition */
-    unsigned short testAngle;
+    unsigned short zLatched;                /**< Z pulse latched and not yet applied */
+    unsigned short cntValid;                /**< cntPre and edgeAgePre hold a previous sample */
 } EncoderHandle;
 /**
   * @}
@@ -104,6 +109,19 @@ void MCS_GetElecAngleByEnc(EncoderHandle *handle);
 void MCS_GetElecSpeedByEnc(EncoderHandle *handle);
 void MCS_EncoderClear(EncoderHandle *handle);
 void MCS_EncoderInit(EncoderHandle *handle, MCS_EncInitStru *encParam);
+void MCS_EncoderSetPulse(EncoderHandle *handle, signed int pulsePerMechRound, unsigned int mtrNp);
+
+/**
+  * @brief Latch the Z pulse position, called from the index interrupt.
+  * @param enc Encoder handle.
+  * @param zCnt QDM position counter at the index.
+  * @retval None.
+  */
+static inline void MCS_EncoderIndexLatch(EncoderHandle *enc, unsigned short zCnt)
+{
+    enc->pulZCnt = zCnt;
+    enc->zLatched = 1;
+}
 /**
   * @brief Get the QDM position counter.
   * @retval unsigned short QDM SCNT.
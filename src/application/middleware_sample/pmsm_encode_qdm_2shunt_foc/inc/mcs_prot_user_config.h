@@ -36,6 +36,10 @@
 #define OVER_VOLT_RECY_CNT_LIMIT        (100)
 /**< Only several contunuous none fault dectection can trigger elimination of error status. */
 #define LOWER_VOLT_RECY_CNT_LIMIT       (100)
+/**< Detection runs once every several calls, the count limits above are divided by it. */
+#define PROT_OVER_CURR_DET_DECIM        (1)
+#define PROT_VOLT_DET_DECIM             (1)
+#define PROT_TEMP_DET_DECIM             (10)
 
 /**< Over current protection */
 /**< Over current trigger value (A) when in level 1. */
@@ -23,13 +23,13 @@
 #include "crg.h"
 #include "debug.h"
 #include "mcs_math_const.h"
+#include "mcs_math.h"
 
 #define FILTER_TIME_A 100 /* Unit: clock cycles */
 #define FILTER_TIME_B 100 /* Unit: clock cycles */
 #define FILTER_TIME_Z 100 /* Unit: clock cycles */
-#define ENC_SPEED_BUF_SIZE 10
-#define ENC_HALF_PPR 5000u
-#define ENC_MAX_POS  65536u
+#define ENC_TSU_MAX_CNT 0xFFFFFFFFu
+#define ENC_STANDSTILL_TIME 0.05f /* Unit: s, no count edge for this time is zero speed */
 /**
   * @brief QMD Initialization.
   * @param qdmInit MCS_QdmInitStru.
@@ -78,6 +78,11 @@ void MCS_QdmInit(MCS_QdmInitStru *qdmInit)
   */
     qdm->QPOSCNT = 0;
 
+    /* Time stamp every count edge, reading QPOSCNT locks the edge age and period into QCTMRLOCK/QCPRDLOCK. */
+    DCL_QDM_ConfigTSUCap(qdm, QDM_TSU_CLK_DIV_1, QDM_UNIT_POS_EVNT_DIV_1, QDM_TSU_LOCK_ON_SW_READ);
+    DCL_QDM_SetCapMaxCnt(qdm, ENC_TSU_MAX_CNT);
+    DCL_QDM_EnableTSUCap(qdm);
+
     /* QDM Position processing unit PPU enable 1: PPU position counter starts counting */
     qdm->QCTRL.BIT.ppu_en = BASE_CFG_ENABLE;
 
@@ -90,6 +95,27 @@ void MCS_QdmInit(MCS_QdmInitStru *qdmInit)
     }
 }
 
+/**
+  * @brief Electrical count at the last edge after a Z pulse, one modulo per index instead of wrap loops.
+  * @param enc encoder handle.
+  * @retval None.
+  */
+static void MCS_EncoderIndexApply(EncoderHandle *enc)
+{
+    signed int elecCnt = ((signed short)(enc->cntNow - enc->pulZCnt) + enc->zShift) % enc->pulsePerElecRound;
+    if (elecCnt < 0) {
+        elecCnt += enc->pulsePerElecRound;
+    }
+    /* Move the observer with the count so that the re-alignment is not seen as motion. */
+    enc->obsPos += (float)(elecCnt - enc->elecCnt);
+    if (enc->obsPos >= (float)enc->pulsePerElecRound) {
+        enc->obsPos -= (float)enc->pulsePerElecRound;
+    } else if (enc->obsPos < 0.0f) {
+        enc->obsPos += (float)enc->pulsePerElecRound;
+    }
+    enc->elecCnt = elecCnt;
+}
+
 /**
   * @brief Get the Encoder Cnt object.
   * @param enc encoder handle.
@@ -98,47 +124,84 @@ void MCS_QdmInit(MCS_QdmInitStru *qdmInit)
   */
 void MCS_GetEncoderCnt(EncoderHandle *enc, QDM_RegStruct *qdm)
 {
-    signed short tmpS16;
-
-    enc->cntNow = qdm->QPOSCNT;
+    /* Reading QPOSCNT locks the time stamp unit. */
+    enc->cntNow = (unsigned short)qdm->QPOSCNT;
+    unsigned int edgeAge = DCL_QDM_GetCapTimerLock(qdm);
+    unsigned int edgePrd = DCL_QDM_GetCapPeriodLock(qdm);
     /* Get pulse conut in unit period */
-    tmpS16 = (signed short)(enc->cntNow - enc->cntPre);
+    signed short delta = (signed short)(enc->cntNow - enc->cntPre);
+    enc->cntPre = enc->cntNow;
+    enc->edgeAge = edgeAge;
 
-    enc->pulsePos += tmpS16; /* Total number of pulses since power-on. */
-    enc->pulseAngle = (unsigned short)qdm->QPOSCNT;
+    if (enc->zLatched != 0) {
+        enc->zLatched = 0;
+        MCS_EncoderIndexApply(enc);
+    } else {
+        /* Less than one electrical round per period, a single wrap is enough. */
+        enc->elecCnt += delta;
+        if (enc->elecCnt >= enc->pulsePerElecRound) {
+            enc->elecCnt -= enc->pulsePerElecRound;
+        } else if (enc->elecCnt < 0) {
+            enc->elecCnt += enc->pulsePerElecRound;
+        }
+    }
+    if (enc->cntValid == 0) {
+        enc->cntValid = 1;
+        enc->edgeAgePre = edgeAge;
+        return;
+    }
 
-    enc->cntPre = enc->cntNow;
+    float speed = enc->mtSpeed;
+    if (delta != 0) {
+        if (enc->edgeAgePre < enc->standstillTick) {
+            /* M/T: counts over the exact time between the last edges of this and the last period. */
+            float dt = enc->periodTick + (float)enc->edgeAgePre - (float)edgeAge;
+            speed = (dt > 0.0f) ? ((float)delta * enc->tsuFreq / dt) : speed;
+        } else if (edgePrd != 0) {
+            /* First edge after standstill: only the edge period is known. */
+            speed = (delta > 0) ? (enc->tsuFreq / (float)edgePrd) : (-enc->tsuFreq / (float)edgePrd);
+        }
+    } else if (edgeAge >= enc->standstillTick) {
+        speed = 0.0f;
+    } else if (edgeAge != 0 && Abs(speed) * (float)edgeAge > enc->tsuFreq) {
+        /* No edge yet: the speed is at most one count over the time since the last edge. */
+        speed = (speed > 0.0f) ? (enc->tsuFreq / (float)edgeAge) : (-enc->tsuFreq / (float)edgeAge);
+    }
+    enc->mtSpeed = speed;
+    enc->edgeAgePre = edgeAge;
 }
 
 /**
   * @brief Get the Elec Angle By Enc object.
   * @param enc Encoder handle.
-  * @retval signed short elecAngle Angle in electronic, S16degree.
+  * @retval None.
   */
 void MCS_GetElecAngleByEnc(EncoderHandle *enc)
 {
-    signed int tmpS32;
-
-    tmpS32 = enc->pulseAngle - enc->pulZCnt;
-    /* Align electric angle & enc angle */
-    tmpS32 += enc->zShift;
-    /* Limit max value */
-    if (tmpS32 > INT16_MAX) {
-        tmpS32 -= ENC_MAX_POS;
-    }
-    /* Limit min value */
-    if (tmpS32 < -INT16_MAX) {
-        tmpS32 += ENC_MAX_POS;
-    }
-    while (tmpS32 >= enc->pulsePerElecRound) {
-        tmpS32 -= enc->pulsePerElecRound;
+    float ppe = (float)enc->pulsePerElecRound;
+    /* Sub-count position: extrapolate from the last edge, at most one count. */
+    float frac = enc->mtSpeed * (float)enc->edgeAge / enc->tsuFreq;
+    frac = Clamp(frac, 1.0f, -1.0f);
+    float meas = (float)enc->elecCnt + frac;
+
+    /* Tracking observer: predict to this period, then correct with the measured position. */
+    enc->obsPos += enc->obsSpd * enc->ts;
+    float err = meas - enc->obsPos;
+    if (err > 0.5f * ppe) {
+        err -= ppe;
+    } else if (err < -0.5f * ppe) {
+        err += ppe;
     }
-    while (tmpS32 < 0) {
-        tmpS32 += enc->pulsePerElecRound;
+    enc->obsPos += enc->obsAlpha * err;
+    enc->obsSpd += enc->obsBeta * err + enc->obsMtGain * (enc->mtSpeed - enc->obsSpd);
+    if (enc->obsPos >= ppe) {
+        enc->obsPos -= ppe;
+    } else if (enc->obsPos < 0.0f) {
+        enc->obsPos += ppe;
     }
-    float tempElecAngle = (signed short)(tmpS32 * enc->pulseToElecAngle);
-    /* Convert short to float angle type */
-    enc->elecAngle = tempElecAngle * DIGITAL_TO_RAD;
+    /* Convert to -pi ~ pi */
+    float angle = enc->obsPos * enc->pulseToElecAngle;
+    enc->elecAngle = (angle >= ONE_PI) ? (angle - DOUBLE_PI) : angle;
 }
 
 /**
@@ -148,37 +211,8 @@ void MCS_GetElecAngleByEnc(EncoderHandle *enc)
   */
 void MCS_GetElecSpeedByEnc(EncoderHandle *enc)
 {
-    signed int     tmpS32;
-    signed short   halfPPR = ENC_HALF_PPR;
-    unsigned short index   = enc->speedBufIndex;
-
-    enc->timeCnt++;
-    if (enc->timeCnt >= enc->timeNum) {
-        enc->timeCnt = 0;
-    } else {
-        return;
-    }
-
-    /* Get pulse conut in unit period */
-    tmpS32 = enc->pulsePos - enc->speedBuf[index];
-    /* Limit max value */
-    if (tmpS32 > halfPPR) {
-        tmpS32 -= ENC_MAX_POS;
-    }
-    /* Limit min value */
-    if (tmpS32 < -halfPPR) {
-        tmpS32 += ENC_MAX_POS;
-    }
-    /* Convert unit pulse count to Hz */
-    enc->elecSpeed       = tmpS32 * enc->pulseToHzPu;
-    enc->speedBuf[index] = enc->pulsePos;
-    index++;
-    /* Store current speed for calcule the average */
-    if (index >= enc->speedBufSize) {
-        enc->speedBufIndex = 0;
-    } else {
-        enc->speedBufIndex = index;
-    }
+    /* Convert counts per second to Hz */
+    enc->elecSpeed = enc->obsSpd * enc->pulseToElecAngle * ONE_DIV_DOUBLE_PI;
 }
 
 /**
@@ -188,12 +222,33 @@ void MCS_GetElecSpeedByEnc(EncoderHandle *enc)
   */
 void MCS_EncoderClear(EncoderHandle *enc)
 {
-    enc->speedBufIndex = 0;
-    for (unsigned short i = 0; i < enc->speedBufSize; i++) {
-        enc->speedBuf[i] = enc->pulsePos;
-    }
+    enc->obsPos = (float)enc->elecCnt;
+    enc->obsSpd = 0.0f;
+    enc->mtSpeed = 0.0f;
+    enc->elecSpeed = 0.0f;
+    enc->cntValid = 0;
+}
 
-    enc->timeCnt = 0;
+/**
+  * @brief Set the encoder resolution, also used when it is changed online.
+  * @param enc Encoder handle.
+  * @param pulsePerMechRound Counts per mechanical round.
+  * @param mtrNp Numbers of pole pairs.
+  * @retval None.
+  */
+void MCS_EncoderSetPulse(EncoderHandle *enc, signed int pulsePerMechRound, unsigned int mtrNp)
+{
+    if (pulsePerMechRound <= 0 || mtrNp == 0) {
+        return;
+    }
+    enc->pulsePerMechRound = pulsePerMechRound;
+    enc->pulsePerElecRound = pulsePerMechRound / (signed int)mtrNp;
+    /* Convert unit pulse count to electric angle */
+    enc->pulseToElecAngle = DOUBLE_PI / (float)enc->pulsePerElecRound;
+    /* Re-align on the next period. */
+    enc->elecCnt = 0;
+    enc->obsPos = 0.0f;
+    enc->zLatched = 1;
 }
 
 /**
@@ -204,33 +259,28 @@ void MCS_EncoderClear(EncoderHandle *enc)
   */
 void MCS_EncoderInit(EncoderHandle *enc, MCS_EncInitStru *encParam)
 {
-    if (encParam->mtrPPMR == 0 || encParam->mtrNp == 0) {
+    if (encParam->mtrPPMR == 0 || encParam->mtrNp == 0 || encParam->tsuFreq == 0) {
         return;
     }
-
-    enc->pulsePerMechRound = encParam->mtrPPMR;
-    enc->pulsePerElecRound = encParam->mtrPPMR / encParam->mtrNp;
     enc->zShift = encParam->zShift;
     /* Clear count value */
     enc->cntNow = 0;
     enc->cntPre = 0;
-
-    enc->pulsePos   = 0;
-    enc->pulseAngle = 0;
     enc->elecAngle  = 0;
-    /* Initial speed buffer */
-    enc->speedBufSize  = ENC_SPEED_BUF_SIZE;  /* Max = 10 */
-    enc->speedBufIndex = 0;
-    for (unsigned short i = 0; i < enc->speedBufSize; i++) {
-        enc->speedBuf[i] = enc->pulsePos;
-    }
-    /* Clear time count value */
-    enc->timeCnt = 0;
-    enc->timeNum = encParam->timeNum;
-    enc->elecSpeed = 0.0f;  /* Hz */
-    /* Convert unit pulse count to Hz */
-    enc->pulseToHzPu = (float)(1.0f /
-                       (enc->pulsePerElecRound * enc->timeNum * enc->speedBufSize * encParam->ctrlPeriod));
-    /* Convert unit pulse count to electric angle */
-    enc->pulseToElecAngle = (float)(65536.0f / enc->pulsePerElecRound);
-}
\ No newline at end of file
+    /* Before the first Z pulse the position is aligned to count 0. */
+    enc->pulZCnt = 0;
+    MCS_EncoderSetPulse(enc, encParam->mtrPPMR, encParam->mtrNp);
+
+    enc->ts = encParam->ctrlPeriod;
+    enc->tsuFreq = (float)encParam->tsuFreq;
+    enc->periodTick = encParam->ctrlPeriod * enc->tsuFreq;
+    enc->standstillTick = (unsigned int)(ENC_STANDSTILL_TIME * enc->tsuFreq);
+    enc->edgeAge = enc->standstillTick;
+    enc->edgeAgePre = enc->standstillTick;
+    /* Critically damped alpha-beta gains for the observer bandwidth. */
+    float r = 1.0f / (1.0f + DOUBLE_PI * encParam->obsBdw * encParam->ctrlPeriod);
+    enc->obsAlpha = 1.0f - r * r;
+    enc->obsBeta = (1.0f - r) * (1.0f - r) / encParam->ctrlPeriod;
+    enc->obsMtGain = 1.0f - r;
+    MCS_EncoderClear(enc);
+}
@@ -33,6 +33,7 @@
 #include "mcs_prot_user_config.h"
 #include "mcs_math_const.h"
 #include "mcs_motor_process.h"
+#include "mcs_apt_pwm.h"
 #include "mcs_chip_config.h"
 #include "mcs_inc_enc.h"
 #include <math.h>
@@ -42,7 +43,6 @@
 #define US_PER_MS               1000
 #define ANGLE_RANGE_ABS         65536
 #define ANGLE_360_F             65536.0f /* 0 - 65536 indicates 0 to 360. */
-#define APT_FULL_DUTY           1.0f
 #define TEMP_3                  3.0f
 #define TEMP_15                 15.0f
 #define TEMP_30                 30.0f
@@ -61,7 +61,7 @@
 #define ADC_TRIMVALUE_MIN       1800.0f
 #define ADC_TRIMVALUE_MAX       2200.0f
 #define IRQ_QDM0_PRIORITY 7  /* the QDM encoder IRQ priority, highest */
-#define ENC_TIMES_NUM           5
+#define ENC_OBS_BDW             200.0f /* Encoder tracking observer bandwidth, Hz */
 /*------------------------------- Param Definition -----------------------------------------------*/
 /* Motor parameters. */
 /* Np, Rs, Ld, Lq, Psif, J, Nmax, Currmax, PPMR, zShift */
@@ -77,6 +77,11 @@ static PeriphHandle g_periph = {.qdm = {.qdmAddr = QDMBASEADDR,
                                                         .baseAddr = QDMBASEADDR}}};
 /* Motor control handle */
 static MTRCTRL_Handle g_mc = {0};
+/* Protection levels and actions of the board, see mcs_prot_user_config.h */
+static const PROT_FaultCfg g_ocpCfg = OCP_CFG_DEFAULTS;
+static const PROT_FaultCfg g_ovpCfg = OVP_CFG_DEFAULTS;
+static const PROT_FaultCfg g_lvpCfg = LVP_CFG_DEFAULTS;
+static const PROT_FaultCfg g_otpCfg = OTP_CFG_DEFAULTS;
 /* QDM control handle */
 static EncoderHandle g_enc = {0};
 
@@ -97,7 +102,9 @@ static void ISR_QdmzPulses(void* args)
      /* Clear qdm interrupt flag */
     DCL_QDM_ClearInterrupt((QDM_RegStruct*)qdmHandle->baseAddr, QDM_INT_INDEX_EVNT_LATCH);
     IRQ_ClearN(qdmHandle->irqNum);
-    g_enc.pulZCnt = MCS_GetQdmPosCnt(qdmHandle->baseAddr);
+    /* QPOSILOCK holds the count latched at the index edge (pcnt_idx_lock_mode). Reading QPOSCNT here would
+       re-lock the time stamp unit that MCS_GetEncoderCnt() reads in the carrier ISR. */
+    MCS_EncoderIndexLatch(&g_enc, (unsigned short)DCL_QDM_GetPosIndexLock((QDM_RegStruct*)qdmHandle->baseAddr));
     g_mc.motorSpinPos++;
     if (g_mc.encReady == 0) {
         /* The z-pulse flag is used to determine
@@ -207,10 +214,10 @@ static void TSK_Init(void)
     CURRCTRL_InitWrapper(&g_mc.currCtrl, &g_mc.idqRef, &g_mc.idqFbk, CTRL_CURR_PERIOD);
 
     MotorProt_Init(&g_mc.prot); /* Init protection state commond */
-    OCP_Init(&g_mc.prot.ocp, CTRL_CURR_PERIOD);
-    OVP_Init(&g_mc.prot.ovp, CTRL_SYSTICK_PERIOD);
-    LVP_Init(&g_mc.prot.lvp, CTRL_SYSTICK_PERIOD);
-    OTP_Init(&g_mc.prot.otp, CTRL_SYSTICK_PERIOD);
+    OCP_Init(&g_mc.prot.ocp, &g_ocpCfg, CTRL_CURR_PERIOD);
+    OVP_Init(&g_mc.prot.ovp, &g_ovpCfg, CTRL_SYSTICK_PERIOD);
+    LVP_Init(&g_mc.prot.lvp, &g_lvpCfg, CTRL_SYSTICK_PERIOD);
+    OTP_Init(&g_mc.prot.otp, &g_otpCfg, CTRL_SYSTICK_PERIOD);
     STP_Init(&g_mc.prot.stall, CTRL_SYSTICK_PERIOD, PROT_STALLING_CURR_AMP_LIMIT,
         PROT_STALLING_SPD_LIMIT, PROT_STALLING_TIME_LIMIT);
 }
@@ -259,79 +266,6 @@ static void ClearBeforeStartup(MTRCTRL_Handle *mtrCtrl)
     LVP_Clear(&mtrCtrl->prot.lvp);
 }
 
-/**
-  * @brief To set the comparison value of the IGBT single-resistance ADC sampling trigger position.
-  * @param aptx The APT register struct handle.
-  * @param cntCmpA A Count compare reference of time-base counter.
-  * @param cntCmpB B Count compare reference of time-base counter.
-  * @param maxCntCmp Maximum Comparison Value
-  * @retval None.
-  */
-static void MCS_SetAdcCompareR1(APT_RegStruct *aptx, unsigned short cntCmpA,
-                                unsigned short cntCmpB, unsigned short maxCntCmp)
-{
-    unsigned short tmp;
-    /* Sets the A Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpA), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_A, tmp);
-    /* Sets the B Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpB), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_B, tmp);
-}
-
-/**
-  * @brief Open the three-phase lower pipe.
-  * @param aptAddr Three-phase APT address pointer.
-  * @param maxDutyCnt Max duty count.
-  * @retval None.
-  */
-static void AptTurnOnLowSidePwm(APT_RegStruct **aptAddr, unsigned short maxDutyCnt)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    MCS_ASSERT_PARAM(maxDutyCnt != 0);
-    unsigned short dutyCnt;
-    dutyCnt = (unsigned short)(maxDutyCnt * APT_FULL_DUTY);
-    /* Open the three-phase lower pipe */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_C, dutyCnt);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_D, dutyCnt);
-    }
-}
-
-/**
-  * @brief Enable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputEnable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Enable three-phase pwm output */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_UNSET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_UNSET;
-    }
-}
-
-/**
-  * @brief Disable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputDisable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Disable three-phase pwm output. */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_SET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_SET;
-        DCL_APT_ForcePWMOutputLow(aptx);
-    }
-}
-
 /**
   * @brief Construct a new mcs startupswitch object.
   * @param mtrCtrl The motor control handle.
@@ -452,9 +386,9 @@ static void CheckSysCmdStart(MTRCTRL_Handle *mtrCtrl,
         mtrCtrl->sysTickCnt = 0;
         *stateMachine = FSM_CAP_CHARGE;
         /* Preparation for charging the bootstrap capacitor. */
-        AptTurnOnLowSidePwm(aptAddr, mtrCtrl->aptMaxcntCmp);
+        MCS_AptTurnOnLowSide(aptAddr, mtrCtrl->aptMaxcntCmp);
         /* Out put pwm */
-        MotorPwmOutputEnable(aptAddr);
+        MCS_AptPwmOutputEnable(aptAddr);
     }
 }
 
@@ -511,7 +445,7 @@ static void TSK_SystickIsr(MTRCTRL_Handle *mtrCtrl, APT_RegStruct **aptAddr)
             break;
         case FSM_STOP:
             mtrCtrl->spdRefHz = 0.0f;
-            MotorPwmOutputDisable(aptAddr);
+            MCS_AptPwmOutputDisable(aptAddr);
             SysRunningClr(statusReg);
             *stateMachine = FSM_IDLE;
             break;
@@ -622,7 +556,7 @@ static void SetPwmDutyCp(UvwAxis *dutyUvwLeft, UvwAxis *dutyUvwRight)
   */
 static void SetADCTriggerTime(unsigned short cntCmpSOCA, unsigned short cntCmpSOCB)
 {
-    MCS_SetAdcCompareR1(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
+    MCS_AptSetAdcCompare(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
 }
 
 /**
@@ -764,15 +698,12 @@ void MotorStatemachineCallBack(void *param)
     /* Motor over voltage detect. */
     OVP_Det(&g_mc.prot.ovp, &g_mc.prot.motorErrStatus, g_mc.udc);
     OVP_Exec(&g_mc.prot.ovp, &g_mc.spdRefHz, g_apt);
-    OVP_Recy(&g_mc.prot.ovp, &g_mc.prot.motorErrStatus, g_mc.udc);
     /* Motor lower voltage detect. */
     LVP_Det(&g_mc.prot.lvp, &g_mc.prot.motorErrStatus, g_mc.udc);
     LVP_Exec(&g_mc.prot.lvp, &g_mc.spdRefHz, g_apt);
-    LVP_Recy(&g_mc.prot.lvp, &g_mc.prot.motorErrStatus, g_mc.udc);
     /* Power board over temperature detect. */
-    OTP_Det(&g_mc.prot.otp,  &g_mc.prot.motorErrStatus, OTP_IPM_ERR_BIT, g_mc.powerBoardTemp);
+    OTP_Det(&g_mc.prot.otp, &g_mc.prot.motorErrStatus, g_mc.powerBoardTemp);
     OTP_Exec(&g_mc.prot.otp, &g_mc.spdRefHz, g_apt);
-    OTP_Recy(&g_mc.prot.otp, &g_mc.prot.motorErrStatus, OTP_IPM_ERR_BIT, g_mc.powerBoardTemp);
 
     /* If protect level == 4, set motor state as stop. */
     if (g_mc.prot.ovp.protLevel == LEVEL_4 || g_mc.prot.lvp.protLevel == LEVEL_4 \
@@ -796,9 +727,6 @@ void MotorCarrierProcessCallback(void *aptHandle)
     if (g_mc.stateMachine == FSM_RUN || g_mc.stateMachine == FSM_STARTUP) {
         OCP_Det(&g_mc.prot.ocp, &g_mc.prot.motorErrStatus, g_mc.idqFbk);
         OCP_Exec(&g_mc.prot.ocp, &g_mc.idqFbk, g_apt);                       /* Execute over current protect motion */
-        if (g_mc.prot.ocp.protLevel < LEVEL_4) {
-            OCP_Recy(&g_mc.prot.ocp, &g_mc.prot.motorErrStatus);
-        }
     }
 }
 
@@ -812,10 +740,12 @@ void MotorSysErrCallback(void *para)
     MCS_ASSERT_PARAM(para != NULL);
     APT_Handle *handle = (APT_Handle *)para;
     /* The IPM overcurrent triggers and disables the three-phase PWM output. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_U], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_V], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_W], APT_OC_COMBINE_EVENT_A1);
+    /* Record the comparator trip in the over current protection. */
+    OCP_HwTrip(&g_mc.prot.ocp, &g_mc.prot.motorErrStatus);
     /* Status setting error */
     SysErrorSet(&g_mc.statusReg);
     DBG_PRINTF("APT error! \r\n");
@@ -843,7 +773,8 @@ static void InitSoftware(void)
     encMotorParam.mtrPPMR = g_motorParam.mtrPPMR;
     encMotorParam.zShift = g_motorParam.zShift;
     encMotorParam.ctrlPeriod = CTRL_CURR_PERIOD;
-    encMotorParam.timeNum = ENC_TIMES_NUM;
+    encMotorParam.tsuFreq = BASE_FUNC_GetCpuFreqHz(); /* TSU clock is the system clock, not divided. */
+    encMotorParam.obsBdw = ENC_OBS_BDW;
     MCS_EncoderInit(enc, &encMotorParam); /* encoder Initializing Parameter Configurations. */
 
     /* MCU peripheral configuration function used for initial motor control. */
@@ -945,7 +876,7 @@ int MotorMainProcess(void)
 
     AptMasterSalveSet();
     /* Disable PWM output before startup. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     /* Software initialization. */
     InitSoftware();
 
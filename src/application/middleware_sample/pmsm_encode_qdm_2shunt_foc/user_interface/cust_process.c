@@ -184,6 +184,8 @@ static void SetObserverEncParams(EncoderHandle *encHandle, CUSTDATATYPE_DEF *rxD
             break;
         case SET_ENC_ZSHIFT: /* Set encoder zero shift. */
             encHandle->zShift = rxData->data[DATA_SEGMENT_THREE].typeF;
+            /* Re-align on the last index with the new shift. */
+            MCS_EncoderIndexLatch(encHandle, encHandle->pulZCnt);
             ackCode = 0X0E;
             CUST_AckCode(g_uartTxBuf, ackCode, encHandle->zShift);
             break;
@@ -203,7 +205,7 @@ static void CMDCODE_SetObserverParams(MTRCTRL_Handle *mtrCtrl, CUSTDATATYPE_DEF
     int funcCode = (int)(rxData->data[DATA_SEGMENT_ONE].typeF);
     if (funcCode  == FOC_OBSERVERTYPE_ENC) {
         SetObserverEncParams(mtrCtrl->encHandle, rxData);
-        mtrCtrl->encHandle->pulsePerElecRound =  mtrCtrl->encHandle->pulsePerMechRound / mtrCtrl->mtrParam.mtrNp;
+        MCS_EncoderSetPulse(mtrCtrl->encHandle, mtrCtrl->encHandle->pulsePerMechRound, mtrCtrl->mtrParam.mtrNp);
     }
 }
 
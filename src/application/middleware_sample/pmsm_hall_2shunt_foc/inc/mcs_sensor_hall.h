@@ -36,7 +36,8 @@
   * @brief
   */
 
- typedef unsigned int (*MCS_GetHallValue)(void);
+typedef unsigned int (*MCS_GetHallValue)(void);
+typedef unsigned int (*MCS_GetHallTick)(void);
 
 typedef enum {
     SECTOR_ONE = 1,
@@ -71,34 +72,43 @@ typedef enum {
     HALL_DIR_CCW = -1
 } HALL_DIR_STATE;
 
+#define HALL_SECTOR_NUM     6
+
 /**
   * @brief Hall sensor control data structure
+  * @details The transitions are timestamped by the capture unit and handed over with HALL_InformationUpdate().
+  *          The angle inside a sector is interpolated from the time elapsed since the last edge, the per-sector
+  *          speed is the learned width of the sector just left divided by the time spent in it, so that the
+  *          Hall placement error is removed from both angle and speed.
   */
 typedef struct {
-    float ts;                       /**< Control period (s). */
-    float timer;                    /**< Timer count value. */
+    unsigned int tickFreq;          /**< Timestamp clock frequency (Hz). */
+    unsigned int lastEdgeTick;      /**< Timestamp of the last transition. */
+    unsigned int timeoutTick;       /**< Time without transition after which the speed is zero. */
+    unsigned int intervalTick[HALL_SECTOR_NUM];   /**< Last transition intervals, ring buffer. */
+    unsigned int periodTick;        /**< Sum of intervalTick, one electrical period. */
+    unsigned int lastPeriodTick;    /**< periodTick before the last transition. */
+    unsigned int intervalIdx;       /**< Next write position of intervalTick. */
+    unsigned int validEdgeCnt;      /**< Consecutive transitions in the same direction. */
     int currentHallValue;           /**< Current sector. */
     int lastHallValue;              /**< Last sector. */
-    float durationLast1;            /**< Last sector jump interval. */
-    float durationLast2;            /**< The sector jump interval before durationLast1. */
-    float durationLast3;            /**< The sector jump interval before durationLast2. */
-    float durationAvg;              /**< Average transition interval. */
     int dir;                        /**< Rotation direction. */
 
-    float angleComp;                /**< Angle correction parameters. */
-    float angleStartPoint;          /**< The start electrical angle of the current sector.. */
+    float sectorWidth[HALL_SECTOR_NUM];  /**< Learned electrical width of each sector (rad). */
+    float edgeOffset[HALL_SECTOR_NUM];   /**< Placement error of the edge entering each sector in CW (rad). */
+    float edgeAngle;                /**< Electrical angle of the last transition. */
+    float sectorSpd;                /**< Per-sector speed observer output (rad per tick). */
     float phaseShift;               /**< Synchronous electrical angle. */
-    float spd;                      /**< Electrical angle. */
-    float angle;                    /**< Electrical speed. */
-
-    short firstEdgeFilterFlag;      /**< First jump filter flag. */
+    float spd;                      /**< Electrical speed (Hz). */
+    float angle;                    /**< Electrical angle. */
 
     MCS_GetHallValue getHallValue;  /**< Pointer to the function for obtaining the value of the hall sensor. */
+    MCS_GetHallTick getTick;        /**< Pointer to the function reading the timestamp clock. */
 } HALL_Handle;
 
-void HALL_Init(HALL_Handle *hall, float phaseShift, float ts);
+void HALL_Init(HALL_Handle *hall, float phaseShift, unsigned int tickFreq);
 unsigned int HALL_SectorCalc(unsigned int hallValue);
-void HALL_InformationUpdate(HALL_Handle *hall);
+void HALL_InformationUpdate(HALL_Handle *hall, unsigned int edgeTick);
 void HALL_AngSpdCalcExec(HALL_Handle *hall);
 void HALL_ParamClear(HALL_Handle *hall);
 
@@ -1,49 +0,0 @@
-/**
-  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
-  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
-  * following conditions are met:
-  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
-  * disclaimer.
-  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
-  * following disclaimer in the documentation and/or other materials provided with the distribution.
-  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
-  * products derived from this software without specific prior written permission.
-  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
-  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
-  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
-  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
-  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
-  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
-  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  * @file      mcs_temp_prot.h
-  * @author    MCU Algorithm Team
-  * @brief     his file contains over temperature protection api declaration.
-  */
-
-/* Define to prevent recursive inclusion ------------------------------------- */
-#ifndef McuMagicTag_MCS_TEMP_PROT_H
-#define McuMagicTag_MCS_TEMP_PROT_H
-
-/* Includes ------------------------------------------------------------------------------------ */
-#include "mcs_prot_cmm.h"
-#include "apt_ip.h"
-
-typedef struct {
-    unsigned int protCnt;
-    unsigned int recyCnt;
-    unsigned int protCntLimit;
-    unsigned int recyCntLimit;
-    float protValThr[PROT_VAL_THRESHOLD_NUMS]; /* from low current level to high. */
-    float protLimitTime[PROT_LIMIT_TIME_NUMS]; /* from level 3 to level 1. */
-    float recyDelta;
-    float ts;
-    float timer;
-    PROT_Level protLevel;
-} OTP_Handle;
-
-void OTP_Init(OTP_Handle *otp, float ts);
-void OTP_Det(OTP_Handle *otp,  MotorErrStatusReg *motorErrStatus, PROT_ErrBit protBit, float temp);
-void OTP_Exec(OTP_Handle *otp, float *spdRef, APT_RegStruct **aptAddr);
-void OTP_Recy(OTP_Handle *otp,  MotorErrStatusReg *motorErrStatus, PROT_ErrBit protBit, float temp);
-void OTP_Clear(OTP_Handle *otp);
-#endif
\ No newline at end of file
@@ -32,13 +32,13 @@
 #include "mcs_prot_user_config.h"
 #include "mcs_math_const.h"
 #include "mcs_motor_process.h"
+#include "mcs_apt_pwm.h"
 #include "mcs_chip_config.h"
 #include "mcs_sensor_hall.h"
 #include "mcs_carrier.h"
 
 /*------------------------------- Macro Definition -----------------------------------------------*/
 #define US_PER_MS               1000
-#define APT_FULL_DUTY           1.0f
 #define TEMP_3                  3.0f
 #define TEMP_15                 15.0f
 #define TEMP_30                 30.0f
@@ -61,6 +61,8 @@ static APT_RegStruct* g_apt[PHASE_MAX_NUM] = {APT_U, APT_V, APT_W};
 /* Motor control handle */
 static MTRCTRL_Handle g_mc = {0};
 static HALL_Handle g_hall = {0};
+/* CAPM time-stamp ticks to systick ticks. */
+static float g_capmTickScale = 1.0f;
 
 /* Motor speed loop PI param. */
 static void SPDCTRL_InitWrapper(SPDCTRL_Handle *spdHandle, float ts)
@@ -166,7 +168,9 @@ static void TSK_Init(void)
     CURRCTRL_InitWrapper(&g_mc.currCtrl, &g_mc.idqRef, &g_mc.idqFbk, CTRL_CURR_PERIOD);
 
     /* Init hall module */
-    HALL_Init(&g_hall, HALL_PHASESHIFT, CTRL_CURR_PERIOD);
+    g_capmTickScale = (float)HAL_CRG_GetIpFreq(SYSTICK_BASE) * (float)(g_capm0.tscntDiv + 1) /
+        (float)HAL_CRG_GetIpFreq(g_capm0.baseAddress);
+    HALL_Init(&g_hall, HALL_PHASESHIFT, HAL_CRG_GetIpFreq(SYSTICK_BASE));
     PLL_Init(&g_mc.hallAnglePll, CTRL_CURR_PERIOD, HALL_ANGLE_PLL_BDW);
     FOLPF_Init(&g_mc.hallSpdFilter, CTRL_CURR_PERIOD, HALL_SPD_FILTER_FC);
 }
@@ -210,79 +214,6 @@ static void ClearBeforeStartup(MTRCTRL_Handle *mtrCtrl)
     HALL_ParamClear(&g_hall);
 }
 
-/**
-  * @brief To set the comparison value of the IGBT single-resistance ADC sampling trigger position.
-  * @param aptx The APT register struct handle.
-  * @param cntCmpA A Count compare reference of time-base counter.
-  * @param cntCmpB B Count compare reference of time-base counter.
-  * @param maxCntCmp Maximum Comparison Value
-  * @retval None.
-  */
-static void MCS_SetAdcCompareR1(APT_RegStruct *aptx, unsigned short cntCmpA,
-                                unsigned short cntCmpB, unsigned short maxCntCmp)
-{
-    unsigned short tmp;
-    /* Sets the A Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpA), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_A, tmp);
-    /* Sets the B Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpB), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_B, tmp);
-}
-
-/**
-  * @brief Open the three-phase lower pipe.
-  * @param aptAddr Three-phase APT address pointer.
-  * @param maxDutyCnt Max duty count.
-  * @retval None.
-  */
-static void AptTurnOnLowSidePwm(APT_RegStruct **aptAddr, unsigned short maxDutyCnt)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    MCS_ASSERT_PARAM(maxDutyCnt != 0);
-    unsigned short dutyCnt;
-    dutyCnt = (unsigned short)(maxDutyCnt * APT_FULL_DUTY);
-    /* Open the three-phase lower pipe */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_C, dutyCnt);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_D, dutyCnt);
-    }
-}
-
-/**
-  * @brief Enable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputEnable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Enable three-phase pwm output */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_UNSET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_UNSET;
-    }
-}
-
-/**
-  * @brief Disable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputDisable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Disable three-phase pwm output. */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_SET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_SET;
-        DCL_APT_ForcePWMOutputLow(aptx);
-    }
-}
-
 /**
   * @brief Set six step angel at start up stage.
   * @param HALL_Handle Hall struct handle.
@@ -427,9 +358,9 @@ static void CheckSysCmdStart(MTRCTRL_Handle *mtrCtrl,
         mtrCtrl->sysTickCnt = 0;
         *stateMachine = FSM_CAP_CHARGE;
         /* Preparation for charging the bootstrap capacitor. */
-        AptTurnOnLowSidePwm(aptAddr, mtrCtrl->aptMaxcntCmp);
+        MCS_AptTurnOnLowSide(aptAddr, mtrCtrl->aptMaxcntCmp);
         /* Out put pwm */
-        MotorPwmOutputEnable(aptAddr);
+        MCS_AptPwmOutputEnable(aptAddr);
     }
 }
 
@@ -476,7 +407,7 @@ static void TSK_SystickIsr(MTRCTRL_Handle *mtrCtrl, APT_RegStruct **aptAddr)
         case FSM_STOP:
             mtrCtrl->spdRefHz = 0.0f;
             mtrCtrl->controlMode = SIXSTEPWAVE_CONTROLMODE;
-            MotorPwmOutputDisable(aptAddr);
+            MCS_AptPwmOutputDisable(aptAddr);
             SysRunningClr(statusReg);
             *stateMachine = FSM_IDLE;
             break;
@@ -587,7 +518,7 @@ static void SetPwmDutyCp(UvwAxis *dutyUvwLeft, UvwAxis *dutyUvwRight)
   */
 static void SetADCTriggerTime(unsigned short cntCmpSOCA, unsigned short cntCmpSOCB)
 {
-    MCS_SetAdcCompareR1(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
+    MCS_AptSetAdcCompare(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
 }
 
 /**
@@ -701,7 +632,7 @@ void MotorSysErrCallback(void *para)
     MCS_ASSERT_PARAM(para != NULL);
     APT_Handle *handle = (APT_Handle *)para;
     /* The IPM overcurrent triggers and disables the three-phase PWM output. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_U], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_V], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_W], APT_OC_COMBINE_EVENT_A1);
@@ -712,6 +643,26 @@ void MotorSysErrCallback(void *para)
     BASE_FUNC_UNUSED(handle);
 }
 
+/**
+  * @brief Systick timestamp of the edge just captured by a Hall CAPM.
+  * @param handle The capm handle.
+  * @retval Edge timestamp.
+  */
+static unsigned int CapmEdgeTick(CAPM_Handle *handle)
+{
+    unsigned int nowTick = DCL_SYSTICK_GetTick();
+    unsigned int tsr = DCL_CAPM_GetTSR(handle->baseAddress);
+    /* The last loaded ECR is the one before the next to be loaded. */
+    unsigned int ecrNum = (HAL_CAPM_GetNextLoadECRNum(handle) + handle->useCapNum - 1) % handle->useCapNum;
+    unsigned int latency = tsr;
+    /* Without register reset the TSR runs on, the edge is at the captured TSR value. */
+    if (handle->capRegConfig[ecrNum].regReset == CAPM_NOTRESET) {
+        latency = tsr - HAL_CAPM_GetECRValue(handle, (CAPM_ECRNum)ecrNum);
+    }
+    /* Back-date the interrupt by the capture latency, timer resolution instead of interrupt jitter. */
+    return nowTick - (unsigned int)((float)latency * g_capmTickScale);
+}
+
 /**
   * @brief Hall edge jump callback function of the hall sensor.
   * @param param The capm handle.
@@ -722,10 +673,9 @@ void MotorSysErrCallback(void *para)
 void CAPM0EventFinishCallback(void *param, CAPM_IntEvent intFlag)
 {
     CAPM_Handle *handle = (CAPM_Handle *)param;
-    BASE_FUNC_UNUSED(handle);
     BASE_FUNC_UNUSED(intFlag);
     /* USER CODE BEGIN CAPM ITCallBackFunc */
-    HALL_InformationUpdate(&g_hall);
+    HALL_InformationUpdate(&g_hall, CapmEdgeTick(handle));
     g_mc.hallSixStepAngle = CalcSixStepRadian(&g_hall);
     /* USER CODE END CAPM ITCallBackFunc */
 }
@@ -733,10 +683,9 @@ void CAPM0EventFinishCallback(void *param, CAPM_IntEvent intFlag)
 void CAPM1EventFinishCallback(void *param, CAPM_IntEvent intFlag)
 {
     CAPM_Handle *handle = (CAPM_Handle *)param;
-    BASE_FUNC_UNUSED(handle);
     BASE_FUNC_UNUSED(intFlag);
     /* USER CODE BEGIN CAPM ITCallBackFunc */
-    HALL_InformationUpdate(&g_hall);
+    HALL_InformationUpdate(&g_hall, CapmEdgeTick(handle));
     g_mc.hallSixStepAngle = CalcSixStepRadian(&g_hall);
     /* USER CODE END CAPM ITCallBackFunc */
 }
@@ -744,10 +693,9 @@ void CAPM1EventFinishCallback(void *param, CAPM_IntEvent intFlag)
 void CAPM2EventFinishCallback(void *param, CAPM_IntEvent intFlag)
 {
     CAPM_Handle *handle = (CAPM_Handle *)param;
-    BASE_FUNC_UNUSED(handle);
     BASE_FUNC_UNUSED(intFlag);
     /* USER CODE BEGIN CAPM ITCallBackFunc */
-    HALL_InformationUpdate(&g_hall);
+    HALL_InformationUpdate(&g_hall, CapmEdgeTick(handle));
     g_mc.hallSixStepAngle = CalcSixStepRadian(&g_hall);
     /* USER CODE END CAPM ITCallBackFunc */
 }
@@ -784,6 +732,7 @@ static void InitSoftware(void)
     /* Callback function for obtaining the hall speed angle. */
     g_mc.getHallAngSpd = GetHallAngSpd;
     g_hall.getHallValue = GetHallValue;
+    g_hall.getTick = DCL_SYSTICK_GetTick;
     /* Initializing motor control param */
     TSK_Init();
 }
@@ -882,7 +831,7 @@ int MotorMainProcess(void)
 
     AptMasterSalveSet();
     /* Disable PWM output before startup. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     /* Software initialization. */
     InitSoftware();
 
@@ -26,39 +26,80 @@
 #include "mcs_math.h"
 
 #define HALL_INSTALL_CALIBRATION_ENABLE (1)
+#define HALL_ZERO_SPD_TIMEOUT           (0.1f)  /* Time without transition to report zero speed, s. */
+#define HALL_WIDTH_LEARN_GAIN           (0.02f) /* Sector width low-pass gain per transition. */
+#define HALL_STEADY_PERIOD_SHIFT        (4)     /* Learn only while the period changes by less than 1/16. */
+
+/**
+ * @brief Next sector in CW rotation.
+ * @param sector Current sector.
+ * @retval Next sector.
+ */
+static inline int HALL_NextSector(int sector)
+{
+    return (sector % HALL_SECTOR_NUM) + 1;
+}
+
+/**
+ * @brief Previous sector in CW rotation.
+ * @param sector Current sector.
+ * @retval Previous sector.
+ */
+static inline int HALL_PrevSector(int sector)
+{
+    return ((sector + HALL_SECTOR_NUM - 2) % HALL_SECTOR_NUM) + 1;
+}
+
+/**
+ * @brief Clear the transition history, the learned sector widths are kept.
+ * @param handle Hall sensor handle.
+ * @retval None.
+ */
+static void HALL_HistoryClear(HALL_Handle *handle)
+{
+    handle->lastEdgeTick = 0;
+    for (unsigned int i = 0; i < HALL_SECTOR_NUM; i++) {
+        handle->intervalTick[i] = 0;
+    }
+    handle->periodTick = 0;
+    handle->lastPeriodTick = 0;
+    handle->intervalIdx = 0;
+    handle->validEdgeCnt = 0;
+    /* Get motor current position sector. */
+    handle->currentHallValue = HALL_SectorCalc(handle->getHallValue());
+    handle->lastHallValue = handle->currentHallValue;
+    /* Set motor init direction. */
+    handle->dir = HALL_DIR_CW;
+    /* Without any transition the rotor is assumed in the middle of the sector. */
+    handle->edgeAngle = handle->phaseShift + (handle->currentHallValue - 1) * S32_60_PHASE_SHIFT;
+    handle->angle = handle->edgeAngle + ONE_PI_DIV_SIX;
+    handle->sectorSpd = 0.0f;
+    handle->spd = 0.0f;
+}
+
 /**
  * @brief Hall sensor initialization interface.
  * @param handle Hall sensor handle.
  * @param phaseShift Hall sensor synchronous electrical angle.
- * @param ts Execution period.
+ * @param tickFreq Frequency of the timestamp clock (Hz).
  * @retval None.
  */
-void HALL_Init(HALL_Handle *handle, float phaseShift, float ts)
+void HALL_Init(HALL_Handle *handle, float phaseShift, unsigned int tickFreq)
 {
     /* Verifying Parameters. */
     MCS_ASSERT_PARAM(handle != NULL);
-    handle->ts = ts;
-    handle->timer = 0.0f;
-    /* Initializing hall sector. */
-    handle->currentHallValue = HALL_SectorCalc(handle->getHallValue());
-    handle->lastHallValue = HALL_SectorCalc(handle->getHallValue());
-    handle->durationLast1 = 0.0f;
-    handle->durationLast2 = 0.0f;
-    handle->durationLast3 = 0.0f;
-    handle->durationAvg = 0.0f;
-    /* Initialization direction. */
-    handle->dir = HALL_DIR_CW;
-    /* Initialize the basic angle based on the sector. */
-    if (handle->currentHallValue) {
-        handle->angleStartPoint = (handle->currentHallValue - 1) * DOUBLE_PI;
-    } else {
-        handle->angleStartPoint = 0.0f;
-    }
-    handle->angleComp = 0.0f;
+    MCS_ASSERT_PARAM(handle->getHallValue != NULL);
+    MCS_ASSERT_PARAM(handle->getTick != NULL);
+    MCS_ASSERT_PARAM(tickFreq > 0);
+    handle->tickFreq = tickFreq;
+    handle->timeoutTick = (unsigned int)((float)tickFreq * HALL_ZERO_SPD_TIMEOUT);
     handle->phaseShift = phaseShift;
-    handle->angle = handle->angleStartPoint;
-    handle->spd = 0.0f;
-    handle->firstEdgeFilterFlag = 0;
+    /* Start from the ideal 120 degree installation. */
+    for (unsigned int i = 0; i < HALL_SECTOR_NUM; i++) {
+        handle->sectorWidth[i] = S32_60_PHASE_SHIFT;
+        handle->edgeOffset[i] = 0.0f;
+    }
+    HALL_HistoryClear(handle);
 }
 
 /**
@@ -96,82 +137,116 @@ unsigned int HALL_SectorCalc(unsigned int hallValue)
 }
 
 /**
- * @brief Updated the Hall sensor jump duration.
+ * @brief Rebuild the edge placement errors from the learned sector widths.
  * @param handle Hall sensor handle.
  * @retval None.
  */
-static void HALL_DurationUpdate(HALL_Handle *handle)
+static void HALL_EdgeOffsetUpdate(HALL_Handle *handle)
 {
-    /* Verifying Parameters. */
-    MCS_ASSERT_PARAM(handle != NULL);
-    handle->durationLast3 = handle->durationLast2;
-    handle->durationLast2 = handle->durationLast1;
-    handle->durationLast1 = handle->timer;
-    handle->timer = 0.0f;
+    float offset = 0.0f;
+    float sum = 0.0f;
+    /* Edge i+1 follows edge i by the width of sector i+1, the offsets accumulate the width errors. */
+    for (unsigned int i = 0; i < HALL_SECTOR_NUM; i++) {
+        handle->edgeOffset[i] = offset;
+        sum += offset;
+        offset += handle->sectorWidth[i] - S32_60_PHASE_SHIFT;
+    }
+    /* A common offset cannot be told from phaseShift, keep the mean at zero. */
+    sum *= (1.0f / HALL_SECTOR_NUM);
+    for (unsigned int i = 0; i < HALL_SECTOR_NUM; i++) {
+        handle->edgeOffset[i] -= sum;
+    }
 }
 
 /**
- * @brief Judge motor rotation CW direction.
+ * @brief Learn the width of the sector just left from the last electrical period.
  * @param handle Hall sensor handle.
+ * @param interval Time spent in the sector.
  * @retval None.
  */
-static void HALL_DirCw(HALL_Handle *handle)
+static void HALL_SectorWidthLearn(HALL_Handle *handle, unsigned int interval)
 {
-    /* Hall rotation: CW. */
-    if (handle->currentHallValue == SECTOR_ONE && handle->lastHallValue == SECTOR_SIX) {
-        /* Init angele shift is pi. */
-        handle->angleStartPoint = handle->phaseShift;
-    } else if (handle->currentHallValue == SECTOR_TWO && handle->lastHallValue == SECTOR_ONE) {
-        /* Sector 2 && 1, the start angle shift is shift+60 degre. */
-        handle->angleStartPoint = handle->phaseShift + S32_60_PHASE_SHIFT;
-    } else if (handle->currentHallValue == SECTOR_THREE && handle->lastHallValue == SECTOR_TWO) {
-        /* Sector 3 && 2, the start angle shift is shift+120 degre. */
-        handle->angleStartPoint = handle->phaseShift + S32_120_PHASE_SHIFT;
-    } else if (handle->currentHallValue == SECTOR_FOUR && handle->lastHallValue == SECTOR_THREE) {
-        /* Sector 4 && 3, the start angle shift is shift+180 degre. */
-        handle->angleStartPoint = handle->phaseShift + S32_60_PHASE_SHIFT + S32_120_PHASE_SHIFT;
-    } else if (handle->currentHallValue == SECTOR_FIVE && handle->lastHallValue == SECTOR_FOUR) {
-        /* Sector 5 && 4, the start angle shift is shift-120 degre. */
-        handle->angleStartPoint = handle->phaseShift - S32_120_PHASE_SHIFT;
-    } else if (handle->currentHallValue == SECTOR_SIX && handle->lastHallValue == SECTOR_FIVE) {
-        /* Sector 6 && 5, the start angle shift is shift-60 degre. */
-        handle->angleStartPoint = handle->phaseShift - S32_60_PHASE_SHIFT;
+    /* A full period in the same direction is needed. */
+    if (HALL_INSTALL_CALIBRATION_ENABLE == 0 || handle->validEdgeCnt <= HALL_SECTOR_NUM) {
+        return;
+    }
+    /* Acceleration is seen as width error, learn at steady speed only. */
+    unsigned int periodDelta = (handle->periodTick > handle->lastPeriodTick) ?
+        (handle->periodTick - handle->lastPeriodTick) : (handle->lastPeriodTick - handle->periodTick);
+    if (periodDelta > (handle->periodTick >> HALL_STEADY_PERIOD_SHIFT)) {
+        return;
+    }
+    float width = DOUBLE_PI * (float)interval / (float)handle->periodTick;
+    float *learned = &handle->sectorWidth[handle->lastHallValue - 1];
+    *learned += HALL_WIDTH_LEARN_GAIN * (width - *learned);
+    /* Once per electrical period is enough for the edge offsets. */
+    if (handle->currentHallValue == SECTOR_ONE) {
+        HALL_EdgeOffsetUpdate(handle);
     }
 }
 
 /**
- * @brief Updating Hall Sensor Information
+ * @brief Updating Hall Sensor Information, called on each Hall transition.
  * @param handle Hall sensor handle.
+ * @param edgeTick Timestamp of the transition, same clock as getTick.
  * @retval None.
  */
-void HALL_InformationUpdate(HALL_Handle *handle)
+void HALL_InformationUpdate(HALL_Handle *handle, unsigned int edgeTick)
 {
     /* Verifying Parameters. */
     MCS_ASSERT_PARAM(handle != NULL);
+    int sector = (int)HALL_SectorCalc(handle->getHallValue());
+    int last = handle->lastHallValue;
+    int dir;
+    if (sector == last) {
+        return;
+    }
+    if (sector == HALL_NextSector(last)) {
+        dir = HALL_DIR_CW;
+    } else if (sector == HALL_PrevSector(last)) {
+        dir = HALL_DIR_CCW;
+    } else {
+        /* A skipped sector is a wiring or noise problem, restart from the current sector. */
+        HALL_HistoryClear(handle);
+        return;
+    }
+    handle->currentHallValue = sector;
+    /* The edge entering the sector in CW is the one leaving the next sector in CCW. */
+    if (dir == HALL_DIR_CW) {
+        handle->edgeAngle = handle->phaseShift + (sector - 1) * S32_60_PHASE_SHIFT +
+            handle->edgeOffset[sector - 1];
+    } else {
+        handle->edgeAngle = handle->phaseShift + sector * S32_60_PHASE_SHIFT +
+            handle->edgeOffset[sector % HALL_SECTOR_NUM];
+    }
 
-    handle->currentHallValue = HALL_SectorCalc(handle->getHallValue());
-
-    /* The first handle edge change is incorrect and needs to be filtered out. */
-    if (handle->firstEdgeFilterFlag == 0) {
-        handle->firstEdgeFilterFlag = 1;
-        if (handle->currentHallValue) {
-            /* Sector start angle is (current_sector - 1) * 60 degree. */
-            handle->angleStartPoint = (handle->currentHallValue - 1) * S32_60_PHASE_SHIFT;
-        } else {
-            handle->angleStartPoint = 0.0f;
+    unsigned int interval = edgeTick - handle->lastEdgeTick;
+    handle->lastEdgeTick = edgeTick;
+    if (dir != handle->dir || handle->validEdgeCnt == 0 || interval > handle->timeoutTick) {
+        /* The edge position is exact, the interval is not usable: the sector was left through its entry edge. */
+        for (unsigned int i = 0; i < HALL_SECTOR_NUM; i++) {
+            handle->intervalTick[i] = 0;
         }
-        handle->angle = handle->angleStartPoint;
-        handle->lastHallValue = handle->currentHallValue;
+        handle->periodTick = 0;
+        handle->intervalIdx = 0;
+        handle->validEdgeCnt = 1;
+        handle->sectorSpd = 0.0f;
+        handle->dir = dir;
+        handle->lastHallValue = sector;
         return;
     }
-    /* Judgement motor rotation direction */
-    HALL_DirCw(handle);
-
-    /* Updated the Hall sensor jump duration. */
-    if (handle->currentHallValue != handle->lastHallValue) {
-        HALL_DurationUpdate(handle);
-        handle->lastHallValue = handle->currentHallValue;
+    /* Electrical period as running sum of the last six intervals. */
+    handle->lastPeriodTick = handle->periodTick;
+    handle->periodTick += interval - handle->intervalTick[handle->intervalIdx];
+    handle->intervalTick[handle->intervalIdx] = interval;
+    handle->intervalIdx = (handle->intervalIdx + 1) % HALL_SECTOR_NUM;
+    if (handle->validEdgeCnt <= HALL_SECTOR_NUM) {
+        handle->validEdgeCnt++;
     }
+    HALL_SectorWidthLearn(handle, interval);
+    /* Per-sector speed observer: learned width over the time spent in the sector. */
+    handle->sectorSpd = handle->sectorWidth[last - 1] / (float)interval;
+    handle->lastHallValue = sector;
 }
 
 /**
@@ -183,27 +258,29 @@ void HALL_AngSpdCalcExec(HALL_Handle *handle)
 {
     /* Verifying Parameters. */
     MCS_ASSERT_PARAM(handle != NULL);
-    handle->durationAvg = ONE_DIV_THREE * (handle->durationLast1 + handle->durationLast2 + handle->durationLast3);
+    unsigned int elapsed = handle->getTick() - handle->lastEdgeTick;
+    float spdRad = handle->sectorSpd;
+    float delta;
 
-    if (handle->durationAvg <= 0.00001f) {
+    if (handle->validEdgeCnt == 0) {
+        return;
+    }
+    if (spdRad <= 0.0f || elapsed > handle->timeoutTick) {
         handle->spd = 0.0f;
-        handle->angleComp = 0.0f;
-    } else {
-        /* Hall installing calibration. */
-        #if (HALL_INSTALL_CALIBRATION_ENABLE == 0)
-            handle->angleComp = 0.0f;
-        #elif (HALL_INSTALL_CALIBRATION_ENABLE == 1)
-            handle->angleComp = (S32_60_PHASE_SHIFT * ONE_DIV_THREE *
-                (handle->durationLast1 - handle->durationLast3) / handle->durationAvg);
-        #endif
-        /* Speed estimation (Hz). */
-        handle->spd = (float)handle->dir / handle->durationAvg / 6.0f;
-        /* Angle estimation. */
-        handle->angle = handle->angleStartPoint + handle->dir *
-            (handle->timer / handle->durationAvg * ONE_PI_DIV_THREE + handle->angleComp);
-    }
-    /* Update history values. */
-    handle->timer += handle->ts;
+        handle->angle = handle->edgeAngle;
+        return;
+    }
+    float width = handle->sectorWidth[handle->currentHallValue - 1];
+    delta = spdRad * (float)elapsed;
+    /* The next edge is late: stay inside the sector and bound the speed by the elapsed time. */
+    if (delta > width) {
+        delta = width;
+        spdRad = width / (float)elapsed;
+    }
+    /* Speed estimation (Hz). */
+    handle->spd = (float)handle->dir * spdRad * (float)handle->tickFreq * ONE_DIV_DOUBLE_PI;
+    /* Angle estimation. */
+    handle->angle = handle->edgeAngle + (float)handle->dir * delta;
 }
 
 /**
@@ -214,25 +291,6 @@ void HALL_AngSpdCalcExec(HALL_Handle *handle)
 void HALL_ParamClear(HALL_Handle *handle)
 {
     MCS_ASSERT_PARAM(handle != NULL);
-    /* Clear hall parameters. */
-    handle->timer = 0.0f;
-    /* Get motor current value. */
-    handle->currentHallValue = HALL_SectorCalc(handle->getHallValue());
-    /* Get motor current position sector. */
-    handle->lastHallValue = HALL_SectorCalc(handle->getHallValue());
-    handle->durationLast1 = 0.0f;
-    handle->durationLast2 = 0.0f;
-    handle->durationLast3 = 0.0f;
-    handle->durationAvg = 0.0f;
-    /* Set motor init direction. */
-    handle->dir = HALL_DIR_CW;
-    if (handle->currentHallValue) {
-        handle->angleStartPoint = (handle->currentHallValue - 1) * ONE_PI_DIV_THREE;
-    } else {
-        handle->angleStartPoint = 0;
-    }
-    /* Init current angle. */
-    handle->angle = handle->angleStartPoint;
-    handle->spd = 0.0f;
-    handle->firstEdgeFilterFlag = 0;
-}
\ No newline at end of file
+    /* The learned placement belongs to the motor and survives a restart. */
+    HALL_HistoryClear(handle);
+}
@@ -33,6 +33,7 @@
 #include "mcs_prot_user_config.h"
 #include "mcs_math_const.h"
 #include "mcs_motor_process.h"
+#include "mcs_apt_pwm.h"
 #include "mcs_chip_config.h"
 #include <math.h>
 
@@ -41,7 +42,6 @@
 #define US_PER_MS               1000
 #define ANGLE_RANGE_ABS         65536
 #define ANGLE_360_F             65536.0f /* 0 - 65536 indicates 0 to 360. */
-#define APT_FULL_DUTY           1.0f
 #define TEMP_3                  3.0f
 #define TEMP_15                 15.0f
 #define TEMP_30                 30.0f
@@ -66,6 +66,11 @@ static MOTOR_Param g_motorParam = MOTORPARAM_DEFAULTS;
 static APT_RegStruct* g_apt[PHASE_MAX_NUM] = {APT_U, APT_V, APT_W};
 /* Motor control handle */
 static MTRCTRL_Handle g_mc = {0};
+/* Protection levels and actions of the board, see mcs_prot_user_config.h */
+static const PROT_FaultCfg g_ocpCfg = OCP_CFG_DEFAULTS;
+static const PROT_FaultCfg g_ovpCfg = OVP_CFG_DEFAULTS;
+static const PROT_FaultCfg g_lvpCfg = LVP_CFG_DEFAULTS;
+static const PROT_FaultCfg g_otpCfg = OTP_CFG_DEFAULTS;
 
 /* Motor speed loop PI param. */
 static void SPDCTRL_InitWrapper(SPDCTRL_Handle *spdHandle, float ts)
@@ -184,10 +189,10 @@ static void TSK_Init(void)
     STARTUP_Init(&g_mc.startup, USER_SWITCH_SPDBEGIN_HZ, USER_SWITCH_SPDBEGIN_HZ + TEMP_3);
 
     MotorProt_Init(&g_mc.prot); /* Init protect state comond */
-    OCP_Init(&g_mc.prot.ocp, CTRL_CURR_PERIOD);
-    OVP_Init(&g_mc.prot.ovp, CTRL_SYSTICK_PERIOD);
-    LVP_Init(&g_mc.prot.lvp, CTRL_SYSTICK_PERIOD);
-    OTP_Init(&g_mc.prot.otp, CTRL_SYSTICK_PERIOD);
+    OCP_Init(&g_mc.prot.ocp, &g_ocpCfg, CTRL_CURR_PERIOD);
+    OVP_Init(&g_mc.prot.ovp, &g_ovpCfg, CTRL_SYSTICK_PERIOD);
+    LVP_Init(&g_mc.prot.lvp, &g_lvpCfg, CTRL_SYSTICK_PERIOD);
+    OTP_Init(&g_mc.prot.otp, &g_otpCfg, CTRL_SYSTICK_PERIOD);
     STP_Init(&g_mc.prot.stall, CTRL_SYSTICK_PERIOD, PROT_STALLING_CURR_AMP_LIMIT,
         PROT_STALLING_SPD_LIMIT, PROT_STALLING_TIME_LIMIT);
 }
@@ -236,79 +241,6 @@ static void ClearBeforeStartup(MTRCTRL_Handle *mtrCtrl)
     LVP_Clear(&mtrCtrl->prot.lvp);
 }
 
-/**
-  * @brief To set the comparison value of the IGBT single-resistance ADC sampling trigger position.
-  * @param aptx The APT register struct handle.
-  * @param cntCmpA A Count compare reference of time-base counter.
-  * @param cntCmpB B Count compare reference of time-base counter.
-  * @param maxCntCmp Maximum Comparison Value
-  * @retval None.
-  */
-static void MCS_SetAdcCompareR1(APT_RegStruct *aptx, unsigned short cntCmpA,
-                                unsigned short cntCmpB, unsigned short maxCntCmp)
-{
-    unsigned short tmp;
-    /* Sets the A Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpA), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_A, tmp);
-    /* Sets the B Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpB), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_B, tmp);
-}
-
-/**
-  * @brief Open the three-phase lower pipe.
-  * @param aptAddr Three-phase APT address pointer.
-  * @param maxDutyCnt Max duty count.
-  * @retval None.
-  */
-static void AptTurnOnLowSidePwm(APT_RegStruct **aptAddr, unsigned short maxDutyCnt)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    MCS_ASSERT_PARAM(maxDutyCnt != 0);
-    unsigned short dutyCnt;
-    dutyCnt = (unsigned short)(maxDutyCnt * APT_FULL_DUTY);
-    /* Open the three-phase lower pipe */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_C, dutyCnt);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_D, dutyCnt);
-    }
-}
-
-/**
-  * @brief Enable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputEnable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Enable three-phase pwm output */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_UNSET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_UNSET;
-    }
-}
-
-/**
-  * @brief Disable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputDisable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Disable three-phase pwm output. */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_SET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_SET;
-        DCL_APT_ForcePWMOutputLow(aptx);
-    }
-}
-
 /**
   * @brief Smo IF angle difference calculation.
   * @param smoElecAngle Smo electrical angle.
@@ -456,9 +388,9 @@ static void CheckSysCmdStart(MTRCTRL_Handle *mtrCtrl,
         mtrCtrl->sysTickCnt = 0;
         *stateMachine = FSM_CAP_CHARGE;
         /* Preparation for charging the bootstrap capacitor. */
-        AptTurnOnLowSidePwm(aptAddr, mtrCtrl->aptMaxcntCmp);
+        MCS_AptTurnOnLowSide(aptAddr, mtrCtrl->aptMaxcntCmp);
         /* Out put pwm */
-        MotorPwmOutputEnable(aptAddr);
+        MCS_AptPwmOutputEnable(aptAddr);
     }
 }
 
@@ -504,7 +436,7 @@ static void TSK_SystickIsr(MTRCTRL_Handle *mtrCtrl, APT_RegStruct **aptAddr)
             break;
         case FSM_STOP:
             mtrCtrl->spdRefHz = 0.0f;
-            MotorPwmOutputDisable(aptAddr);
+            MCS_AptPwmOutputDisable(aptAddr);
             SysRunningClr(statusReg);
             *stateMachine = FSM_IDLE;
             break;
@@ -614,7 +546,7 @@ static void SetPwmDutyCp(UvwAxis *dutyUvwLeft, UvwAxis *dutyUvwRight)
   */
 static void SetADCTriggerTime(unsigned short cntCmpSOCA, unsigned short cntCmpSOCB)
 {
-    MCS_SetAdcCompareR1(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
+    MCS_AptSetAdcCompare(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
 }
 
 /**
@@ -786,15 +718,12 @@ void MotorStatemachineCallBack(void *param)
     /* Motor over voltage detect. */
     OVP_Det(&g_mc.prot.ovp, &g_mc.prot.motorErrStatus, g_mc.udc);
     OVP_Exec(&g_mc.prot.ovp, &g_mc.spdRefHz, g_apt);
-    OVP_Recy(&g_mc.prot.ovp, &g_mc.prot.motorErrStatus, g_mc.udc);
     /* Motor lower voltage detect. */
     LVP_Det(&g_mc.prot.lvp, &g_mc.prot.motorErrStatus, g_mc.udc);
     LVP_Exec(&g_mc.prot.lvp, &g_mc.spdRefHz, g_apt);
-    LVP_Recy(&g_mc.prot.lvp, &g_mc.prot.motorErrStatus, g_mc.udc);
     /* Power board over temperature detect. */
-    OTP_Det(&g_mc.prot.otp,  &g_mc.prot.motorErrStatus, OTP_IPM_ERR_BIT, g_mc.powerBoardTemp);
+    OTP_Det(&g_mc.prot.otp, &g_mc.prot.motorErrStatus, g_mc.powerBoardTemp);
     OTP_Exec(&g_mc.prot.otp, &g_mc.spdRefHz, g_apt);
-    OTP_Recy(&g_mc.prot.otp, &g_mc.prot.motorErrStatus, OTP_IPM_ERR_BIT, g_mc.powerBoardTemp);
 
     /* If protect level == 4, set motor state as stop. */
     if (g_mc.prot.ovp.protLevel == LEVEL_4 || g_mc.prot.lvp.protLevel == LEVEL_4 \
@@ -818,9 +747,6 @@ void MotorCarrierProcessCallback(void *aptHandle)
     if (g_mc.stateMachine == FSM_RUN || g_mc.stateMachine == FSM_STARTUP) {
         OCP_Det(&g_mc.prot.ocp, &g_mc.prot.motorErrStatus, g_mc.idqFbk);
         OCP_Exec(&g_mc.prot.ocp, &g_mc.idqFbk, g_apt);                       /* Execute over current protect motion */
-        if (g_mc.prot.ocp.protLevel < LEVEL_4) {
-            OCP_Recy(&g_mc.prot.ocp, &g_mc.prot.motorErrStatus);
-        }
     }
 }
 
@@ -834,10 +760,12 @@ void MotorSysErrCallback(void *para)
     MCS_ASSERT_PARAM(para != NULL);
     APT_Handle *handle = (APT_Handle *)para;
     /* The IPM overcurrent triggers and disables the three-phase PWM output. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_U], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_V], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_W], APT_OC_COMBINE_EVENT_A1);
+    /* Record the comparator trip in the over current protection. */
+    OCP_HwTrip(&g_mc.prot.ocp, &g_mc.prot.motorErrStatus);
     /* Status setting error */
     SysErrorSet(&g_mc.statusReg);
     DBG_PRINTF("APT error! \r\n");
@@ -954,7 +882,7 @@ int MotorMainProcess(void)
 
     AptMasterSalveSet();
     /* Disable PWM output before startup. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     /* Software initialization. */
     InitSoftware();
     /* Start the PWM clock. */
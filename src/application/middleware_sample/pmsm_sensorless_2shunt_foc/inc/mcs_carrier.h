@@ -22,7 +22,7 @@
 #ifndef McuMagicTag_MCS_CARRIER_H
 #define McuMagicTag_MCS_CARRIER_H
 
-#include "mcs_status.h"
+#include "mcs_sys_status.h"
 #include "mcs_mtr_param.h"
 #include "mcs_svpwm.h"
 #include "mcs_curr_ctrl.h"
@@ -36,6 +36,7 @@
 #include "mcs_r1_svpwm.h"
 #include "mcs_fw_ctrl.h"
 #include "mcs_prot_user.h"
+#include "scope_capture.h"
 
 typedef void (*MCS_ReadCurrUvwCb)(UvwAxis *CurrUvw);
 typedef void (*MCS_SetPwmDutyCb)(UvwAxis *dutyUvwLeft, UvwAxis *dutyUvwRight);
@@ -135,6 +136,7 @@ typedef struct {
     MCS_SetADCTriggerTimeCb setADCTriggerTimeCb;    /**< Sets the ADC trigger point callback function. */
 
     MotorProtStatus_Handle prot;                    /**< Protection handle. */
+    SCOPE_Handle scope;                             /**< Scope capture, recorded in the carrier ISR. */
 } MTRCTRL_Handle;
 
 void MCS_CarrierProcess(MTRCTRL_Handle *mtrCtrl);
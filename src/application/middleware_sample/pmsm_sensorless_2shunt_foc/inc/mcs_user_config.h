@@ -27,6 +27,10 @@
 
 #define SMO4TH
 
+/* Binary host link (COBS frames, parameters by ID, telemetry subscription), remove to use the 20-byte frames
+   of the IDE host tool */
+#define HOST_LINK
+
 #define SYSTICK_PERIOD_US                 500u /* systick period */
 
 #define INV_CAP_CHARGE_MS                 3u
@@ -41,6 +41,7 @@ ADC_Handle g_adc2;
 DMA_Handle g_dmac;
 GPIO_Handle g_gpio0;
 GPIO_Handle g_gpio2;
+CRC_Handle g_crc;
 /* USER CODE BEGIN 1 */
 /* USER CODE END 1 */
 
@@ -33,6 +33,7 @@
 #include "pga.h"
 #include "crg.h"
 #include "dma.h"
+#include "crc.h"
 
 #define    IO_SPEED_FAST     0x00U
 #define    IO_SPEED_SLOW     0x01U
@@ -68,6 +69,8 @@ extern DMA_Handle g_dmac;
 extern GPIO_Handle g_gpio0;
 extern GPIO_Handle g_gpio2;
 
+extern CRC_Handle g_crc;
+
 BASE_StatusType CRG_Config(CRG_CoreClkSelect *coreClkSelect);
 void SystemInit(void);
 
@@ -76,7 +79,6 @@ void MotorSysErrCallback(void *aptHandle);
 void CheckPotentiometerValueCallback(void *handle);
 void MotorStatemachineCallBack(void *handle);
 void UART0WriteInterruptCallback(UART_Handle *handle);
-void UART0ReadInterruptCallback(UART_Handle *handle);
 void UART0InterruptErrorCallback(UART_Handle *handle);
 
 void UART0_TXDMACallback(UART_Handle *handle);
@@ -62,6 +62,25 @@ static void DMA_Channel0Init(void *handle)
     HAL_DMA_InitChannel(&g_dmac, &dma_param, DMA_CHANNEL_ZERO);
 }
 
+static void DMA_Channel1Init(void *handle)
+{
+    /* enable DMA function for uart data reception */
+    DMA_ChannelParam dma_param;
+    dma_param.direction = DMA_PERIPH_TO_MEMORY_BY_DMAC;
+    dma_param.srcAddrInc = DMA_ADDR_UNALTERED;
+    dma_param.destAddrInc = DMA_ADDR_INCREASE;
+    /* enable UART0 rx mode DMA */
+    dma_param.srcPeriph = DMA_REQUEST_UART0_RX;
+    dma_param.destPeriph = DMA_REQUEST_MEM;
+    dma_param.srcWidth = DMA_TRANSWIDTH_BYTE;
+    dma_param.destWidth = DMA_TRANSWIDTH_BYTE;
+    dma_param.srcBurst = DMA_BURST_LENGTH_1;
+    dma_param.destBurst = DMA_BURST_LENGTH_1;
+    dma_param.pHandle = handle;
+    /* init DMA config module */
+    HAL_DMA_InitChannel(&g_dmac, &dma_param, DMA_CHANNEL_ONE);
+}
+
 static void DMA_Init(void)
 {
     HAL_CRG_IpEnableSet(DMA_BASE, IP_CLK_ENABLE);
@@ -76,6 +95,7 @@ static void DMA_Init(void)
     HAL_DMA_Init(&g_dmac);
 
     DMA_Channel0Init((void *)(&g_uart0));
+    DMA_Channel1Init((void *)(&g_uart0));
 }
 
 static void ACMP1_Init(void)
@@ -544,13 +564,6 @@ __weak void UART0WriteInterruptCallback(UART_Handle *handle)
     /* USER CODE END UART0_WRITE_IT_FINISH */
 }
 
-__weak void UART0ReadInterruptCallback(UART_Handle *handle)
-{
-    BASE_FUNC_UNUSED(handle);
-    /* USER CODE BEGIN UART0_READ_IT_FINISH */
-    /* USER CODE END UART0_READ_IT_FINISH */
-}
-
 __weak void UART0InterruptErrorCallback(UART_Handle *handle)
 {
     BASE_FUNC_UNUSED(handle);
@@ -578,23 +591,33 @@ static void UART0_Init(void)
     g_uart0.stopBits = UART_STOPBITS_ONE;
     g_uart0.parity = UART_PARITY_NONE;
     g_uart0.txMode = UART_MODE_DMA;
-    g_uart0.rxMode = UART_MODE_INTERRUPT;
+    g_uart0.rxMode = UART_MODE_DMA;
     g_uart0.fifoMode = BASE_CFG_ENABLE;
     g_uart0.fifoTxThr = UART_FIFOFULL_ONE_TWO;
     g_uart0.fifoRxThr = UART_FIFOFULL_ONE_TWO;
     g_uart0.hwFlowCtr = BASE_CFG_DISABLE;
     HAL_UART_Init(&g_uart0);
     HAL_UART_RegisterCallBack(&g_uart0, UART_WRITE_IT_FINISH, UART0WriteInterruptCallback);
-    HAL_UART_RegisterCallBack(&g_uart0, UART_READ_IT_FINISH, UART0ReadInterruptCallback);
     HAL_UART_RegisterCallBack(&g_uart0, UART_TRNS_IT_ERROR, UART0InterruptErrorCallback);
     HAL_UART_IRQService(&g_uart0);
     IRQ_SetPriority(g_uart0.irqNum, 1);
     IRQ_EnableN(g_uart0.irqNum);
     g_uart0.dmaHandle = &g_dmac;
     g_uart0.uartDmaTxChn = 0;
+    g_uart0.uartDmaRxChn = 1;
     HAL_UART_RegisterCallBack(&g_uart0, UART_WRITE_DMA_FINISH, UART0_TXDMACallback);
 }
 
+static void CRC_Init(void)
+{
+    HAL_CRG_IpEnableSet(CRC_BASE, IP_CLK_ENABLE);
+
+    g_crc.baseAddress = CRC;
+    g_crc.inputDataFormat = CRC_MODE_BIT8;
+    g_crc.handleEx.algoMode = CRC16_XMODEM; /* Host link frame check */
+    HAL_CRC_Init(&g_crc);
+}
+
 static void IOConfig(void)
 {
     IOConfig_RegStruct *iconfig = IOCONFIG;
@@ -790,6 +813,7 @@ void SystemInit(void)
     TIMER0_Init();
     TIMER1_Init();
     GPIO_Init();
+    CRC_Init();
 
     /* USER CODE BEGIN system_init */
     /* USER CODE END system_init */
@@ -70,6 +70,14 @@
 #define SET_INCREMENT_OF_IF_CURRENT     0x02    /* Set If Step Command Params */
 #define SET_SPEED_RING_BEGIN_SPEED      0x03    /* Set If to Smo Start Speed Command Params */
 
+/* Scope ack code, the ack value is 1 if the command is accepted, 0 if it is refused. */
+#define SCOPE_ACK_SET_CHANNEL           0x30
+#define SCOPE_ACK_SET_TRIGGER           0x31
+#define SCOPE_ACK_ARM                   0x32
+#define SCOPE_ACK_FORCE                 0x33
+#define SCOPE_ACK_STOP                  0x34
+#define SCOPE_ACK_UPLOAD                0x35
+
 static unsigned char ackCode = 0;
 static unsigned char g_uartTxBuf[CUSTACKCODELEN] = {0};
 
@@ -548,6 +556,63 @@ static void CMDCODE_UartHandShake(MTRCTRL_Handle *mtrCtrl, CUSTDATATYPE_DEF *rxD
     CMDCODE_SetAdjustSpdMode(mtrCtrl, rxData);
 }
 
+/**
+  * @brief Send the ack of a scope command.
+  * @param code Ack code.
+  * @param ret Command result.
+  */
+static void ScopeAck(unsigned char code, BASE_StatusType ret)
+{
+    ackCode = code;
+    CUST_AckCode(g_uartTxBuf, ackCode, (ret == BASE_STATUS_OK) ? 1.0f : 0.0f);
+}
+
+/**
+  * @brief Scope capture commands.
+  * @param mtrCtrl The motor control handle.
+  * @param rxData Receive buffer
+  * @param code Instruction code.
+  */
+static void CMDCODE_EXE_Scope(MTRCTRL_Handle *mtrCtrl, CUSTDATATYPE_DEF *rxData, unsigned char code)
+{
+    SCOPE_Handle *scope = &mtrCtrl->scope;
+    switch (code) {
+        case CMDCODE_SCOPE_SET_CHANNEL:     /* Select the variable of a channel. */
+            ScopeAck(SCOPE_ACK_SET_CHANNEL, SCOPE_SetChannel(scope,
+                (unsigned int)rxData->data[DATA_SEGMENT_ONE].typeF,
+                (unsigned int)rxData->data[DATA_SEGMENT_TWO].typeI,
+                (SCOPE_VarType)rxData->data[DATA_SEGMENT_THREE].typeF,
+                rxData->data[DATA_SEGMENT_FOUR].typeF));
+            break;
+        case CMDCODE_SCOPE_SET_TRIGGER:     /* Set the trigger source and condition. */
+            ScopeAck(SCOPE_ACK_SET_TRIGGER, SCOPE_SetTrigger(scope,
+                (unsigned int)rxData->data[DATA_SEGMENT_ONE].typeI,
+                (SCOPE_VarType)rxData->data[DATA_SEGMENT_TWO].typeF,
+                (SCOPE_TrigMode)rxData->data[DATA_SEGMENT_THREE].typeF,
+                rxData->data[DATA_SEGMENT_FOUR].typeF));
+            break;
+        case CMDCODE_SCOPE_ARM:             /* Start recording. */
+            ScopeAck(SCOPE_ACK_ARM, SCOPE_Arm(scope,
+                (unsigned int)rxData->data[DATA_SEGMENT_ONE].typeF,
+                (unsigned int)rxData->data[DATA_SEGMENT_TWO].typeF,
+                (unsigned int)rxData->data[DATA_SEGMENT_THREE].typeF));
+            break;
+        case CMDCODE_SCOPE_FORCE:           /* Trigger now. */
+            SCOPE_Force(scope);
+            ScopeAck(SCOPE_ACK_FORCE, BASE_STATUS_OK);
+            break;
+        case CMDCODE_SCOPE_STOP:            /* Stop recording or uploading. */
+            SCOPE_Stop(scope);
+            ScopeAck(SCOPE_ACK_STOP, BASE_STATUS_OK);
+            break;
+        case CMDCODE_SCOPE_UPLOAD:          /* Upload the finished capture. */
+            ScopeAck(SCOPE_ACK_UPLOAD, SCOPE_StartUpload(scope));
+            break;
+        default:
+            break;
+    }
+}
+
 /**
   * @brief Set Motor Initial Status Parameters.
   * @param mtrCtrl The motor control handle.
@@ -647,6 +712,7 @@ static void CMDCODE_EXE_Process(MTRCTRL_Handle *mtrCtrl, CUSTDATATYPE_DEF *rxDat
     CMDCODE_EXE_SetMotorInitParams(mtrCtrl, rxData, code);
     CMDCODE_EXE_SetMotorState(mtrCtrl, rxData, code);
     CMDCODE_EXE_SetOtherParams(mtrCtrl, rxData, code);
+    CMDCODE_EXE_Scope(mtrCtrl, rxData, code);
 }
 
 /**
@@ -0,0 +1,80 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      host_frame.c
+  * @author    MCU Algorithm Team
+  * @brief     COBS (consistent overhead byte stuffing) framing of the host link.
+  */
+#include "host_frame.h"
+
+/**
+  * @brief Encode a message and append the delimiter.
+  * @param msg Message.
+  * @param len Message length.
+  * @param out Output buffer of at least HOST_FRAME_ENC_LEN(len) bytes, must not overlap msg.
+  * @retval Encoded length, delimiter included.
+  */
+unsigned int HOST_FrameEncode(const unsigned char *msg, unsigned int len, unsigned char *out)
+{
+    unsigned int codeIdx = 0;   /* Code byte of the current block, written once the block is closed */
+    unsigned int outIdx = 1;
+    unsigned char code = 1;
+    for (unsigned int i = 0; i < len; i++) {
+        if (msg[i] != HOST_FRAME_DELIMITER) {
+            out[outIdx++] = msg[i];
+            code++;
+        }
+        /* A zero byte, or a full block, closes the block */
+        if (msg[i] == HOST_FRAME_DELIMITER || code == HOST_FRAME_BLOCK_MAX + 1) {
+            out[codeIdx] = code;
+            codeIdx = outIdx++;
+            code = 1;
+        }
+    }
+    out[codeIdx] = code;
+    out[outIdx++] = HOST_FRAME_DELIMITER;
+    return outIdx;
+}
+
+/**
+  * @brief Decode a received frame in place, the decoded message is never longer than the frame.
+  * @param buf Frame bytes between two delimiters, delimiters excluded.
+  * @param len Frame length.
+  * @retval Message length, 0 if the frame is not valid COBS.
+  */
+unsigned int HOST_FrameDecode(unsigned char *buf, unsigned int len)
+{
+    unsigned int rdIdx = 0;
+    unsigned int wrIdx = 0;
+    while (rdIdx < len) {
+        unsigned int code = buf[rdIdx++];
+        if (code == HOST_FRAME_DELIMITER || rdIdx + code - 1 > len) {
+            return 0;
+        }
+        for (unsigned int i = 1; i < code; i++) {
+            if (buf[rdIdx] == HOST_FRAME_DELIMITER) {
+                return 0;
+            }
+            buf[wrIdx++] = buf[rdIdx++];
+        }
+        /* Every block but a full one and the last one stands for a zero byte */
+        if (code != HOST_FRAME_BLOCK_MAX + 1 && rdIdx < len) {
+            buf[wrIdx++] = HOST_FRAME_DELIMITER;
+        }
+    }
+    return wrIdx;
+}
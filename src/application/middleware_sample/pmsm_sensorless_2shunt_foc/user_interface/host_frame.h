@@ -0,0 +1,50 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      host_frame.h
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions declaration of the COBS framing of the host link.
+  * @details   A message is COBS encoded, so it contains no 0x00 byte, and followed by one 0x00 delimiter. The
+  *            receiver resynchronizes on the next delimiter after any error, whatever the payload holds.
+  */
+#ifndef McsMagicTag_HOST_FRAME_H
+#define McsMagicTag_HOST_FRAME_H
+
+#define HOST_FRAME_DELIMITER        (0x00)
+/* Longest COBS block: a code byte followed by 254 data bytes */
+#define HOST_FRAME_BLOCK_MAX        (254)
+/* Encoded size of a len byte message, delimiter included */
+#define HOST_FRAME_ENC_LEN(len)     ((len) + (len) / HOST_FRAME_BLOCK_MAX + 2)
+
+/**
+  * @brief Result of a host request, first byte of every response payload.
+  */
+typedef enum {
+    HOST_OK = 0,
+    HOST_ERR_MSG,           /* Unknown message type */
+    HOST_ERR_LEN,           /* Payload length does not match the message */
+    HOST_ERR_ID,            /* Unknown parameter ID */
+    HOST_ERR_READ_ONLY,     /* Parameter cannot be written */
+    HOST_ERR_RANGE,         /* Value outside the parameter range */
+    HOST_ERR_SKIPPED,       /* Valid item not applied, another item of the batch failed */
+    HOST_ERR_REFUSED        /* Not possible in the current state */
+} HOST_Status;
+
+unsigned int HOST_FrameEncode(const unsigned char *msg, unsigned int len, unsigned char *out);
+unsigned int HOST_FrameDecode(unsigned char *buf, unsigned int len);
+
+#endif
@@ -0,0 +1,649 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      host_link.c
+  * @author    MCU Algorithm Team
+  * @brief     Binary host link: variable length messages in COBS frames with a CRC16 computed by the CRC
+  *            peripheral, batched parameter read and write by ID, and telemetry streamed at a rate negotiated
+  *            against the line capacity. Responses, telemetry and scope upload frames are queued in one half of
+  *            a double buffer while the UART DMA sends the other half.
+  */
+#include "host_link.h"
+#include "scope_capture.h"
+#include "mcs_ctlmode_config.h"
+#include "mcs_assert.h"
+#include "baseinc.h"
+
+#define HOST_RESP_ITEM_LEN          (7)     /* ID, status, value */
+#define HOST_WRITE_ITEM_LEN         (6)     /* ID, value */
+#define HOST_INFO_ITEM_LEN          (12)    /* ID, type, flags, min, max */
+#define HOST_TELEM_HEAD_LEN         (8)     /* Sample index, systick */
+#define HOST_LINE_BITS_PER_BYTE     (10)    /* Start, 8 data and stop bits */
+#define HOST_US_PER_S               (1000000U)
+
+/**
+  * @brief Read a 16-bit little endian field.
+  * @param p Field.
+  * @retval Value.
+  */
+static inline unsigned int HostGetU16(const unsigned char *p)
+{
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8); /* 8: high byte */
+}
+
+/**
+  * @brief Read a 32-bit little endian field.
+  * @param p Field.
+  * @retval Value.
+  */
+static inline unsigned int HostGetU32(const unsigned char *p)
+{
+    return HostGetU16(p) | (HostGetU16(&p[2]) << 16); /* 2, 16: high half word */
+}
+
+/**
+  * @brief Write a 16-bit little endian field.
+  * @param p Field.
+  * @param value Value.
+  */
+static inline void HostPutU16(unsigned char *p, unsigned int value)
+{
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8); /* 8: high byte */
+}
+
+/**
+  * @brief Write a 32-bit little endian field.
+  * @param p Field.
+  * @param value Value.
+  */
+static inline void HostPutU32(unsigned char *p, unsigned int value)
+{
+    HostPutU16(p, value);
+    HostPutU16(&p[2], value >> 16); /* 2, 16: high half word */
+}
+
+/**
+  * @brief Read a float field.
+  * @param p Field.
+  * @retval Value.
+  */
+static inline float HostGetF32(const unsigned char *p)
+{
+    HOST_ParamValue value;
+    value.u = HostGetU32(p);
+    return value.f;
+}
+
+/**
+  * @brief Status of a request forwarded to a driver or a middleware function.
+  * @param ret Function result.
+  * @retval HOST_OK or HOST_ERR_REFUSED.
+  */
+static inline unsigned char HostStatusOf(BASE_StatusType ret)
+{
+    return (ret == BASE_STATUS_OK) ? HOST_OK : HOST_ERR_REFUSED;
+}
+
+/**
+  * @brief Initialize the host link.
+  * @param link The host link handle.
+  * @param crc CRC handle initialized with CRC16_XMODEM and CRC_MODE_BIT8.
+  * @param baudRate UART baud rate, for the telemetry rate negotiation.
+  * @param tickHz Systick frequency.
+  */
+void HOST_LinkInit(HOST_Link *link, CRC_Handle *crc, unsigned int baudRate, unsigned int tickHz)
+{
+    MCS_ASSERT_PARAM(link != NULL);
+    MCS_ASSERT_PARAM(crc != NULL);
+    MCS_ASSERT_PARAM(baudRate > 0);
+    link->crc = crc;
+    link->baudRate = baudRate;
+    link->tickHz = tickHz;
+    link->pollTick = 0;
+    link->txFill = 0;
+    link->txLen = 0;
+    link->telemNum = 0;
+    link->telemPeriod = 1;
+    link->telemLastTick = 0;
+    link->telemIdx = 0;
+    link->stat.rxCnt = 0;
+    link->stat.crcErrCnt = 0;
+    link->stat.frameErrCnt = 0;
+    link->stat.unknownCnt = 0;
+    link->stat.txDropCnt = 0;
+    link->stat.telemCnt = 0;
+    link->stat.telemLostCnt = 0;
+}
+
+/**
+  * @brief Complete the message in link->msg and queue its frame.
+  * @param link The host link handle.
+  * @param type Message type.
+  * @param seq Sequence number.
+  * @param payloadLen Payload length, the payload is already at link->msg[HOST_LINK_HEAD_LEN].
+  * @retval false if the transmit buffer is full, the message is not sent.
+  */
+static bool HostLinkSend(HOST_Link *link, unsigned char type, unsigned char seq, unsigned int payloadLen)
+{
+    unsigned int msgLen = HOST_LINK_HEAD_LEN + payloadLen + HOST_LINK_CRC_LEN;
+    if (HOST_FRAME_ENC_LEN(msgLen) > HOST_LINK_TX_BUF_LEN - link->txLen) {
+        return false;
+    }
+    unsigned char *msg = link->msg;
+    msg[0] = type;
+    msg[1] = seq;
+    HostPutU16(&msg[2], payloadLen); /* 2: payload length field */
+    unsigned int crc = HAL_CRC_Calculate(link->crc, msg, msgLen - HOST_LINK_CRC_LEN);
+    msg[msgLen - 2] = (unsigned char)(crc >> 8); /* 2, 8: CRC high byte first */
+    msg[msgLen - 1] = (unsigned char)crc;
+    link->txLen += HOST_FrameEncode(msg, msgLen, &link->txBuf[link->txFill][link->txLen]);
+    return true;
+}
+
+/**
+  * @brief Connect: the motor speed is set by the host from now on.
+  * @param link The host link handle.
+  * @param mtrCtrl The motor control handle.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkHello(const HOST_Link *link, MTRCTRL_Handle *mtrCtrl, unsigned char *resp)
+{
+    mtrCtrl->spdAdjustMode = HOST_SPEED_ADJUST;
+    mtrCtrl->uartConnectFlag = CONNECTED;
+    resp[0] = HOST_OK;
+    resp[1] = HOST_LINK_VERSION;
+    HostPutU16(&resp[2], HOST_LINK_PAYLOAD_MAX);    /* 2: payload max */
+    HostPutU16(&resp[4], HOST_ParamNum());          /* 4: parameter number */
+    resp[6] = HOST_TELEM_SIGNAL_MAX;                /* 6: telemetry signal max */
+    HostPutU32(&resp[7], link->baudRate);           /* 7: baud rate */
+    HostPutU32(&resp[11], link->tickHz);            /* 11: tick frequency */
+    return 15; /* 15: response length */
+}
+
+/**
+  * @brief Disconnect: the telemetry stops and the speed is set by the board again.
+  * @param link The host link handle.
+  * @param mtrCtrl The motor control handle.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkBye(HOST_Link *link, MTRCTRL_Handle *mtrCtrl, const unsigned char *req,
+                                unsigned int reqLen, unsigned char *resp)
+{
+    if (reqLen != 1) {
+        resp[0] = HOST_ERR_LEN;
+        return 1;
+    }
+    if (req[0] != 0) {
+        SysCmdStopSet(&mtrCtrl->statusReg);
+        mtrCtrl->motorStateFlag = 0;
+    }
+    mtrCtrl->spdAdjustMode = CUST_SPEED_ADJUST;
+    mtrCtrl->uartConnectFlag = DISCONNECT;
+    link->telemNum = 0;
+    resp[0] = HOST_OK;
+    return 1;
+}
+
+/**
+  * @brief Heartbeat, the payload is echoed.
+  * @param mtrCtrl The motor control handle.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkPing(MTRCTRL_Handle *mtrCtrl, const unsigned char *req, unsigned int reqLen,
+                                 unsigned char *resp)
+{
+    if (reqLen > HOST_LINK_PAYLOAD_MAX - 1) {
+        resp[0] = HOST_ERR_LEN;
+        return 1;
+    }
+    mtrCtrl->uartHeartDetCnt++;
+    resp[0] = HOST_OK;
+    for (unsigned int i = 0; i < reqLen; i++) {
+        resp[1 + i] = req[i];
+    }
+    return 1 + reqLen;
+}
+
+/**
+  * @brief Start, stop or reset.
+  * @param mtrCtrl The motor control handle.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkMotorCmd(MTRCTRL_Handle *mtrCtrl, const unsigned char *req, unsigned int reqLen,
+                                     unsigned char *resp)
+{
+    resp[0] = HOST_OK;
+    if (reqLen != 1) {
+        resp[0] = HOST_ERR_LEN;
+    } else if (req[0] == HOST_MOTOR_START) {
+        if (mtrCtrl->stateMachine != FSM_RUN) {
+            SysCmdStartSet(&mtrCtrl->statusReg);
+            mtrCtrl->motorStateFlag = 1;
+        } else {
+            resp[0] = HOST_ERR_REFUSED;
+        }
+    } else if (req[0] == HOST_MOTOR_STOP) {
+        SysCmdStopSet(&mtrCtrl->statusReg);
+        mtrCtrl->motorStateFlag = 0;
+    } else if (req[0] == HOST_MOTOR_RESET) {
+        BASE_FUNC_SoftReset();
+    } else {
+        resp[0] = HOST_ERR_RANGE;
+    }
+    return 1;
+}
+
+/**
+  * @brief Link statistics.
+  * @param link The host link handle.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkStat(const HOST_Link *link, unsigned char *resp)
+{
+    const unsigned int *cnt = (const unsigned int *)&link->stat;
+    unsigned int num = sizeof(HOST_LinkStat) / sizeof(unsigned int);
+    resp[0] = HOST_OK;
+    for (unsigned int i = 0; i < num; i++) {
+        HostPutU32(&resp[1 + i * 4], cnt[i]); /* 4: bytes per counter */
+    }
+    return 1 + num * 4; /* 4: bytes per counter */
+}
+
+/**
+  * @brief Batched parameter read.
+  * @param mtrCtrl The motor control handle.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkParamRead(const MTRCTRL_Handle *mtrCtrl, const unsigned char *req, unsigned int reqLen,
+                                      unsigned char *resp)
+{
+    unsigned int num = reqLen / 2; /* 2: bytes per ID */
+    if ((reqLen % 2) != 0 || 1 + num * HOST_RESP_ITEM_LEN > HOST_LINK_PAYLOAD_MAX) { /* 2: bytes per ID */
+        resp[0] = HOST_ERR_LEN;
+        return 1;
+    }
+    resp[0] = HOST_OK;
+    unsigned char *item = &resp[1];
+    for (unsigned int i = 0; i < num; i++, item += HOST_RESP_ITEM_LEN) {
+        unsigned int id = HostGetU16(&req[i * 2]); /* 2: bytes per ID */
+        const HOST_ParamEntry *param = HOST_ParamFind((unsigned short)id);
+        HostPutU16(item, id);
+        item[2] = (param != NULL) ? HOST_OK : HOST_ERR_ID;                         /* 2: status */
+        HostPutU32(&item[3], (param != NULL) ? HOST_ParamRead(mtrCtrl, param) : 0); /* 3: value */
+        if (resp[0] == HOST_OK) {
+            resp[0] = item[2]; /* 2: status */
+        }
+    }
+    return 1 + num * HOST_RESP_ITEM_LEN;
+}
+
+/**
+  * @brief Batched parameter write. All the items are checked first: if one of them fails, none is written and the
+  *        valid ones report HOST_ERR_SKIPPED, so related gains are never left half updated.
+  * @param mtrCtrl The motor control handle.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkParamWrite(MTRCTRL_Handle *mtrCtrl, const unsigned char *req, unsigned int reqLen,
+                                       unsigned char *resp)
+{
+    unsigned int num = reqLen / HOST_WRITE_ITEM_LEN;
+    if ((reqLen % HOST_WRITE_ITEM_LEN) != 0 || 1 + num * HOST_RESP_ITEM_LEN > HOST_LINK_PAYLOAD_MAX) {
+        resp[0] = HOST_ERR_LEN;
+        return 1;
+    }
+    resp[0] = HOST_OK;
+    for (unsigned int i = 0; i < num; i++) {
+        const unsigned char *in = &req[i * HOST_WRITE_ITEM_LEN];
+        unsigned char *item = &resp[1 + i * HOST_RESP_ITEM_LEN];
+        const HOST_ParamEntry *param = HOST_ParamFind((unsigned short)HostGetU16(in));
+        item[0] = in[0];
+        item[1] = in[1];
+        item[2] = (param != NULL) ? HOST_ParamCheck(param, HostGetU32(&in[2])) : HOST_ERR_ID; /* 2: status */
+        if (resp[0] == HOST_OK) {
+            resp[0] = item[2]; /* 2: status */
+        }
+    }
+    for (unsigned int i = 0; i < num; i++) {
+        const unsigned char *in = &req[i * HOST_WRITE_ITEM_LEN];
+        unsigned char *item = &resp[1 + i * HOST_RESP_ITEM_LEN];
+        const HOST_ParamEntry *param = HOST_ParamFind((unsigned short)HostGetU16(in));
+        if (resp[0] != HOST_OK) {
+            item[2] = (item[2] == HOST_OK) ? HOST_ERR_SKIPPED : item[2]; /* 2: status */
+        } else {
+            HOST_ParamWrite(mtrCtrl, param, HostGetU32(&in[2])); /* 2: value */
+        }
+        HostPutU32(&item[3], (param != NULL) ? HOST_ParamRead(mtrCtrl, param) : 0); /* 3: value read back */
+    }
+    return 1 + num * HOST_RESP_ITEM_LEN;
+}
+
+/**
+  * @brief Parameter table listing, as many entries as fit from the first index.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkParamInfo(const unsigned char *req, unsigned int reqLen, unsigned char *resp)
+{
+    if (reqLen != 2) { /* 2: first index */
+        resp[0] = HOST_ERR_LEN;
+        return 1;
+    }
+    unsigned int len = 3; /* 3: status and parameter number */
+    resp[0] = HOST_OK;
+    HostPutU16(&resp[1], HOST_ParamNum());
+    const HOST_ParamEntry *param;
+    for (unsigned int idx = HostGetU16(req); (param = HOST_ParamAt(idx)) != NULL &&
+         len + HOST_INFO_ITEM_LEN <= HOST_LINK_PAYLOAD_MAX; idx++) {
+        HOST_ParamValue min = { .f = param->min };
+        HOST_ParamValue max = { .f = param->max };
+        HostPutU16(&resp[len], param->id);
+        resp[len + 2] = param->type;    /* 2: type */
+        resp[len + 3] = param->flags;   /* 3: flags */
+        HostPutU32(&resp[len + 4], min.u); /* 4: min */
+        HostPutU32(&resp[len + 8], max.u); /* 8: max */
+        len += HOST_INFO_ITEM_LEN;
+    }
+    return len;
+}
+
+/**
+  * @brief Shortest telemetry period that keeps the frames within HOST_TELEM_LOAD_PERCENT of the line.
+  * @param link The host link handle.
+  * @param num Signal number.
+  * @retval Period in us.
+  */
+static unsigned int HostTelemPeriodMin(const HOST_Link *link, unsigned int num)
+{
+    unsigned int msgLen = HOST_LINK_HEAD_LEN + HOST_TELEM_HEAD_LEN + num * 4 + HOST_LINK_CRC_LEN; /* 4: value */
+    unsigned int lineBits = HOST_FRAME_ENC_LEN(msgLen) * HOST_LINE_BITS_PER_BYTE;
+    unsigned int bitsPerUs = link->baudRate / 100 * HOST_TELEM_LOAD_PERCENT; /* 100: percent */
+    unsigned int periodUs = (lineBits * HOST_US_PER_S + bitsPerUs - 1) / bitsPerUs;
+    return (periodUs > HOST_TELEM_PERIOD_MIN_US) ? periodUs : HOST_TELEM_PERIOD_MIN_US;
+}
+
+/**
+  * @brief Subscribe the telemetry: the signals and the requested period. The granted period is the requested one,
+  *        raised to what the line can carry. A request without signal stops the telemetry.
+  * @param link The host link handle.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkTelemSub(HOST_Link *link, const unsigned char *req, unsigned int reqLen,
+                                     unsigned char *resp)
+{
+    unsigned int num = (reqLen - 4) / 2; /* 4: period, 2: bytes per ID */
+    if (reqLen < 4 || (reqLen % 2) != 0 || num > HOST_TELEM_SIGNAL_MAX) { /* 4: period, 2: bytes per ID */
+        resp[0] = HOST_ERR_LEN;
+        return 1;
+    }
+    const HOST_ParamEntry *telem[HOST_TELEM_SIGNAL_MAX];
+    for (unsigned int i = 0; i < num; i++) {
+        telem[i] = HOST_ParamFind((unsigned short)HostGetU16(&req[4 + i * 2])); /* 4: period, 2: bytes per ID */
+        if (telem[i] == NULL) {
+            resp[0] = HOST_ERR_ID;
+            return 1;
+        }
+    }
+    unsigned int periodUs = 0;
+    if (num > 0) {
+        unsigned int periodMin = HostTelemPeriodMin(link, num);
+        periodUs = HostGetU32(req);
+        periodUs = (periodUs > periodMin) ? periodUs : periodMin;
+        unsigned long long period = (unsigned long long)periodUs * link->tickHz / HOST_US_PER_S;
+        link->telemPeriod = (period > 0) ? (unsigned int)period : 1;
+        link->telemLastTick = link->pollTick;
+        link->telemIdx = 0;
+        for (unsigned int i = 0; i < num; i++) {
+            link->telem[i] = telem[i];
+        }
+    }
+    link->telemNum = num;
+    resp[0] = HOST_OK;
+    HostPutU32(&resp[1], periodUs);
+    resp[5] = (unsigned char)num; /* 5: signal number */
+    return 6; /* 6: response length */
+}
+
+/**
+  * @brief Scope capture commands, same arguments as the CMDCODE_SCOPE_* frames.
+  * @param mtrCtrl The motor control handle.
+  * @param type Message type.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkScope(MTRCTRL_Handle *mtrCtrl, unsigned char type, const unsigned char *req,
+                                  unsigned int reqLen, unsigned char *resp)
+{
+    SCOPE_Handle *scope = &mtrCtrl->scope;
+    resp[0] = HOST_ERR_LEN;
+    switch (type) {
+        case HOST_MSG_SCOPE_CHANNEL:
+            if (reqLen == 10) { /* 10: index, address, type, scale */
+                resp[0] = HostStatusOf(SCOPE_SetChannel(scope, req[0], HostGetU32(&req[1]),
+                                                        (SCOPE_VarType)req[5], HostGetF32(&req[6])));
+            }
+            break;
+        case HOST_MSG_SCOPE_TRIGGER:
+            if (reqLen == 10) { /* 10: address, type, mode, level */
+                resp[0] = HostStatusOf(SCOPE_SetTrigger(scope, HostGetU32(req), (SCOPE_VarType)req[4],
+                                                        (SCOPE_TrigMode)req[5], HostGetF32(&req[6])));
+            }
+            break;
+        case HOST_MSG_SCOPE_ARM:
+            if (reqLen == 5) { /* 5: channel number, decimation, pre-trigger samples */
+                resp[0] = HostStatusOf(SCOPE_Arm(scope, req[0], HostGetU16(&req[1]), HostGetU16(&req[3])));
+            }
+            break;
+        case HOST_MSG_SCOPE_FORCE:
+            if (reqLen == 0) {
+                SCOPE_Force(scope);
+                resp[0] = HOST_OK;
+            }
+            break;
+        case HOST_MSG_SCOPE_STOP:
+            if (reqLen == 0) {
+                SCOPE_Stop(scope);
+                resp[0] = HOST_OK;
+            }
+            break;
+        default:
+            if (reqLen == 0) {
+                resp[0] = HostStatusOf(SCOPE_StartUpload(scope));
+            }
+            break;
+    }
+    return 1;
+}
+
+/**
+  * @brief Execute a request.
+  * @param link The host link handle.
+  * @param mtrCtrl The motor control handle.
+  * @param type Message type.
+  * @param req Request payload.
+  * @param reqLen Request payload length.
+  * @param resp Response payload.
+  * @retval Response length.
+  */
+static unsigned int HostLinkExec(HOST_Link *link, MTRCTRL_Handle *mtrCtrl, unsigned char type,
+                                 const unsigned char *req, unsigned int reqLen, unsigned char *resp)
+{
+    switch (type) {
+        case HOST_MSG_HELLO:
+            return HostLinkHello(link, mtrCtrl, resp);
+        case HOST_MSG_BYE:
+            return HostLinkBye(link, mtrCtrl, req, reqLen, resp);
+        case HOST_MSG_PING:
+            return HostLinkPing(mtrCtrl, req, reqLen, resp);
+        case HOST_MSG_MOTOR_CMD:
+            return HostLinkMotorCmd(mtrCtrl, req, reqLen, resp);
+        case HOST_MSG_STAT:
+            return HostLinkStat(link, resp);
+        case HOST_MSG_PARAM_READ:
+            return HostLinkParamRead(mtrCtrl, req, reqLen, resp);
+        case HOST_MSG_PARAM_WRITE:
+            return HostLinkParamWrite(mtrCtrl, req, reqLen, resp);
+        case HOST_MSG_PARAM_INFO:
+            return HostLinkParamInfo(req, reqLen, resp);
+        case HOST_MSG_TELEM_SUB:
+            return HostLinkTelemSub(link, req, reqLen, resp);
+        case HOST_MSG_SCOPE_CHANNEL:
+        case HOST_MSG_SCOPE_TRIGGER:
+        case HOST_MSG_SCOPE_ARM:
+        case HOST_MSG_SCOPE_FORCE:
+        case HOST_MSG_SCOPE_STOP:
+        case HOST_MSG_SCOPE_UPLOAD:
+            return HostLinkScope(mtrCtrl, type, req, reqLen, resp);
+        default:
+            link->stat.unknownCnt++;
+            resp[0] = HOST_ERR_MSG;
+            return 1;
+    }
+}
+
+/**
+  * @brief Process a received frame and queue the response.
+  * @param link The host link handle.
+  * @param mtrCtrl The motor control handle.
+  * @param pkt Frame bytes without the delimiter, decoded in place.
+  * @param len Frame length.
+  */
+void HOST_LinkReceive(HOST_Link *link, MTRCTRL_Handle *mtrCtrl, unsigned char *pkt, unsigned int len)
+{
+    MCS_ASSERT_PARAM(link != NULL);
+    MCS_ASSERT_PARAM(mtrCtrl != NULL);
+    MCS_ASSERT_PARAM(pkt != NULL);
+    unsigned int msgLen = HOST_FrameDecode(pkt, len);
+    if (msgLen < HOST_LINK_HEAD_LEN + HOST_LINK_CRC_LEN || msgLen > HOST_LINK_MSG_MAX ||
+        HostGetU16(&pkt[2]) != msgLen - HOST_LINK_HEAD_LEN - HOST_LINK_CRC_LEN) { /* 2: payload length field */
+        link->stat.frameErrCnt++;
+        return;
+    }
+    unsigned int crc = HAL_CRC_Calculate(link->crc, pkt, msgLen - HOST_LINK_CRC_LEN);
+    if (pkt[msgLen - 2] != (unsigned char)(crc >> 8) || pkt[msgLen - 1] != (unsigned char)crc) { /* 2, 8: CRC */
+        link->stat.crcErrCnt++;
+        return;
+    }
+    link->stat.rxCnt++;
+    unsigned int respLen = HostLinkExec(link, mtrCtrl, pkt[0], &pkt[HOST_LINK_HEAD_LEN],
+                                        msgLen - HOST_LINK_HEAD_LEN - HOST_LINK_CRC_LEN,
+                                        &link->msg[HOST_LINK_HEAD_LEN]);
+    if (!HostLinkSend(link, (unsigned char)(pkt[0] | HOST_MSG_RESP), pkt[1], respLen)) {
+        link->stat.txDropCnt++;
+    }
+}
+
+/**
+  * @brief Queue a telemetry sample: the subscribed values read now.
+  * @param link The host link handle.
+  * @param mtrCtrl The motor control handle.
+  * @param tick Systick of the sample.
+  */
+static void HostLinkTelem(HOST_Link *link, const MTRCTRL_Handle *mtrCtrl, unsigned int tick)
+{
+    unsigned char *payload = &link->msg[HOST_LINK_HEAD_LEN];
+    HostPutU32(payload, link->telemIdx);
+    HostPutU32(&payload[4], tick); /* 4: systick */
+    for (unsigned int i = 0; i < link->telemNum; i++) {
+        HostPutU32(&payload[HOST_TELEM_HEAD_LEN + i * 4], HOST_ParamRead(mtrCtrl, link->telem[i])); /* 4: value */
+    }
+    if (HostLinkSend(link, HOST_MSG_TELEM, (unsigned char)link->telemIdx,
+                     HOST_TELEM_HEAD_LEN + link->telemNum * 4)) { /* 4: value */
+        link->stat.telemCnt++;
+    } else {
+        link->stat.telemLostCnt++;
+    }
+    link->telemIdx++;
+}
+
+/**
+  * @brief Queue the telemetry sample when it is due and the next scope upload frame when there is room. Call it
+  *        from the main loop as often as possible.
+  * @param link The host link handle.
+  * @param mtrCtrl The motor control handle.
+  * @param tick Current systick.
+  */
+void HOST_LinkPoll(HOST_Link *link, MTRCTRL_Handle *mtrCtrl, unsigned int tick)
+{
+    MCS_ASSERT_PARAM(link != NULL);
+    MCS_ASSERT_PARAM(mtrCtrl != NULL);
+    link->pollTick = tick;
+    if (link->telemNum > 0 && tick - link->telemLastTick >= link->telemPeriod) {
+        /* Sample slots missed by a late main loop are skipped, their indexes too, so the host sees the gap */
+        unsigned int slots = (tick - link->telemLastTick) / link->telemPeriod;
+        link->telemLastTick += slots * link->telemPeriod;
+        link->telemIdx += slots - 1;
+        link->stat.telemLostCnt += slots - 1;
+        HostLinkTelem(link, mtrCtrl, tick);
+    }
+    /* The upload only takes the room left by the telemetry, a frame at a time */
+    if (mtrCtrl->scope.uploading != 0 &&
+        HOST_FRAME_ENC_LEN(HOST_LINK_MSG_MAX) <= HOST_LINK_TX_BUF_LEN - link->txLen) {
+        unsigned char *payload = &link->msg[HOST_LINK_HEAD_LEN];
+        unsigned short seq;
+        unsigned int len = SCOPE_UploadPayload(&mtrCtrl->scope, &payload[2], HOST_LINK_PAYLOAD_MAX - 2, &seq);
+        if (len > 0) {
+            HostPutU16(payload, seq);
+            HostLinkSend(link, HOST_MSG_SCOPE_DATA, (unsigned char)seq, len + 2); /* 2: upload sequence */
+        }
+    }
+}
+
+/**
+  * @brief Take the queued frames for the UART DMA. Call it only when the DMA has finished the previous ones, the
+  *        returned half stays untouched until the next call.
+  * @param link The host link handle.
+  * @param len Bytes to send.
+  * @retval Frames to send, NULL if nothing is queued.
+  */
+unsigned char *HOST_LinkTxTake(HOST_Link *link, unsigned int *len)
+{
+    MCS_ASSERT_PARAM(link != NULL);
+    MCS_ASSERT_PARAM(len != NULL);
+    if (link->txLen == 0) {
+        return NULL;
+    }
+    unsigned char *txBuf = link->txBuf[link->txFill];
+    *len = link->txLen;
+    link->txFill ^= 1;
+    link->txLen = 0;
+    return txBuf;
+}
@@ -0,0 +1,112 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      host_link.h
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions declaration of the binary host link.
+  * @details   Every message is sent as one COBS frame (host_frame.h):
+  *            type (1), sequence (1), payload length (2), payload, CRC16_XMODEM of the previous bytes (2).
+  *            Multi-byte fields are little endian except the CRC, which is big endian. Floats are IEEE-754 single
+  *            precision. The target answers every request with the request type | HOST_MSG_RESP, the request
+  *            sequence number and a payload starting with the HOST_Status. Frames with a wrong CRC or length are
+  *            dropped without answer, the host repeats the request after a timeout.
+  */
+#ifndef McsMagicTag_HOST_LINK_H
+#define McsMagicTag_HOST_LINK_H
+
+#include "mcs_carrier.h"
+#include "crc.h"
+#include "host_frame.h"
+#include "host_param.h"
+
+#define HOST_LINK_VERSION           (1)
+#define HOST_LINK_HEAD_LEN          (4)
+#define HOST_LINK_CRC_LEN           (2)
+#define HOST_LINK_PAYLOAD_MAX       (192)
+#define HOST_LINK_MSG_MAX           (HOST_LINK_HEAD_LEN + HOST_LINK_PAYLOAD_MAX + HOST_LINK_CRC_LEN)
+/* Largest received frame without its delimiter, size of the receive buffer */
+#define HOST_LINK_PKT_MAX           (HOST_FRAME_ENC_LEN(HOST_LINK_MSG_MAX) - 1)
+/* Each half of the transmit double buffer, holds at least one largest frame */
+#define HOST_LINK_TX_BUF_LEN        (256)
+
+#define HOST_TELEM_SIGNAL_MAX       (32)
+#define HOST_TELEM_PERIOD_MIN_US    (250)
+/* Share of the line the telemetry may take, the rest is left to the responses and the scope upload */
+#define HOST_TELEM_LOAD_PERCENT     (75)
+
+/* Requests and their payload, "->" the response payload after the status */
+#define HOST_MSG_HELLO              0x01    /* -> version (1), payload max (2), parameter number (2),
+                                               telemetry signal max (1), baud rate (4), tick frequency (4) */
+#define HOST_MSG_BYE                0x02    /* Stop the motor (1) */
+#define HOST_MSG_PING               0x03    /* Any payload -> the same payload */
+#define HOST_MSG_MOTOR_CMD          0x04    /* HOST_MotorCmd (1) */
+#define HOST_MSG_STAT               0x05    /* -> HOST_LinkStat, 4 bytes per counter */
+#define HOST_MSG_PARAM_READ         0x10    /* n * ID (2) -> n * (ID (2), status (1), value (4)) */
+#define HOST_MSG_PARAM_WRITE        0x11    /* n * (ID (2), value (4)) -> n * (ID (2), status (1), value (4)) */
+#define HOST_MSG_PARAM_INFO         0x12    /* First index (2) -> parameter number (2),
+                                               k * (ID (2), type (1), flags (1), min (4), max (4)) */
+#define HOST_MSG_TELEM_SUB          0x20    /* Period in us (4), n * ID (2) -> granted period in us (4), n (1) */
+#define HOST_MSG_SCOPE_CHANNEL      0x30    /* Index (1), address (4), SCOPE_VarType (1), scale (4) */
+#define HOST_MSG_SCOPE_TRIGGER      0x31    /* Address (4), SCOPE_VarType (1), SCOPE_TrigMode (1), level (4) */
+#define HOST_MSG_SCOPE_ARM          0x32    /* Channel number (1), decimation (2), pre-trigger samples (2) */
+#define HOST_MSG_SCOPE_FORCE        0x33
+#define HOST_MSG_SCOPE_STOP         0x34
+#define HOST_MSG_SCOPE_UPLOAD       0x35
+/* Messages sent by the target on its own, the sequence number is the low byte of the sample or frame index */
+#define HOST_MSG_TELEM              0x40    /* Sample index (4), systick (4), n * value (4) */
+#define HOST_MSG_SCOPE_DATA         0x41    /* Upload sequence (2), scope upload payload (scope_capture.h) */
+#define HOST_MSG_RESP               0x80
+
+typedef enum {
+    HOST_MOTOR_START = 1,
+    HOST_MOTOR_STOP,
+    HOST_MOTOR_RESET        /* Soft reset of the chip, not answered */
+} HOST_MotorCmd;
+
+typedef struct {
+    unsigned int rxCnt;             /* Requests received */
+    unsigned int crcErrCnt;         /* Frames with a wrong CRC */
+    unsigned int frameErrCnt;       /* Frames with a COBS or length error */
+    unsigned int unknownCnt;        /* Requests of an unknown type */
+    unsigned int txDropCnt;         /* Responses dropped, transmit buffer full */
+    unsigned int telemCnt;          /* Telemetry samples sent */
+    unsigned int telemLostCnt;      /* Telemetry samples skipped, main loop late or transmit buffer full */
+} HOST_LinkStat;
+
+typedef struct {
+    CRC_Handle *crc;                /* CRC16_XMODEM, 8-bit input */
+    unsigned int baudRate;
+    unsigned int tickHz;            /* Systick frequency */
+    unsigned int pollTick;          /* Systick of the last HOST_LinkPoll() */
+    unsigned char msg[HOST_LINK_MSG_MAX];           /* Message being built */
+    unsigned char txBuf[2][HOST_LINK_TX_BUF_LEN];   /* One half filled while the other one is sent */
+    unsigned int txFill;            /* Half being filled */
+    unsigned int txLen;             /* Bytes queued in the half being filled */
+    const HOST_ParamEntry *telem[HOST_TELEM_SIGNAL_MAX];
+    unsigned int telemNum;          /* Subscribed signals, 0 if the telemetry is off */
+    unsigned int telemPeriod;       /* Sample period in systicks */
+    unsigned int telemLastTick;     /* Systick of the last sample slot */
+    unsigned int telemIdx;          /* Index of the next sample */
+    HOST_LinkStat stat;
+} HOST_Link;
+
+void HOST_LinkInit(HOST_Link *link, CRC_Handle *crc, unsigned int baudRate, unsigned int tickHz);
+void HOST_LinkReceive(HOST_Link *link, MTRCTRL_Handle *mtrCtrl, unsigned char *pkt, unsigned int len);
+void HOST_LinkPoll(HOST_Link *link, MTRCTRL_Handle *mtrCtrl, unsigned int tick);
+unsigned char *HOST_LinkTxTake(HOST_Link *link, unsigned int *len);
+
+#endif
@@ -0,0 +1,334 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      host_param.c
+  * @author    MCU Algorithm Team
+  * @brief     Parameter table of the host link. One table entry per ID replaces the per-command switch chains of
+  *            the 20-byte protocol: reads, batched writes and telemetry all go through the same lookup.
+  */
+#include <stddef.h>
+#include "host_param.h"
+#include "mcs_ctlmode_config.h"
+#include "mcs_user_config.h"
+#include "mcs_math_const.h"
+#include "mcs_assert.h"
+
+/* Sanity bounds of the written values */
+#define HOST_GAIN_MAX               (1.0e6f)    /* Controller and observer gains */
+#define HOST_CURR_RANGE             (10.0f)     /* Currents, A */
+#define HOST_SPD_RANGE              (2000.0f)   /* Electrical speeds, Hz */
+#define HOST_BDW_MAX                (0.5f / CTRL_CURR_PERIOD)   /* Bandwidths and cut-off frequencies, Hz */
+#define HOST_RES_MAX                (1000.0f)   /* Ohm */
+#define HOST_IND_MAX                (1.0f)      /* H */
+#define HOST_NP_MAX                 (100.0f)
+
+#define PARAM_RW(id, type, member, min, max, onWrite) \
+    { (id), (type), 0, offsetof(MTRCTRL_Handle, member), (min), (max), (onWrite) }
+#define PARAM_RO(id, type, member) \
+    { (id), (type), HOST_PARAM_READ_ONLY, offsetof(MTRCTRL_Handle, member), 0.0f, 0.0f, NULL }
+
+/**
+  * @brief Both current loop axes share the output limit.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostCurrLimitUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    float limit = mtrCtrl->currCtrl.qAxisPi.upperLimit;
+    PID_SetLimit(&mtrCtrl->currCtrl.qAxisPi, limit);
+    PID_SetLimit(&mtrCtrl->currCtrl.dAxisPi, limit);
+}
+
+/**
+  * @brief Symmetric speed loop output limit.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostSpdLimitUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    PID_SetLimit(&mtrCtrl->spdCtrl.spdPi, mtrCtrl->spdCtrl.spdPi.upperLimit);
+}
+
+/**
+  * @brief Keep the target speed within the maximum motor speed.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostSpdCmdUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    float maxSpd = mtrCtrl->mtrParam.maxElecSpd;
+    if (mtrCtrl->spdCmdHz > maxSpd) {
+        mtrCtrl->spdCmdHz = maxSpd;
+    } else if (mtrCtrl->spdCmdHz < -maxSpd) {
+        mtrCtrl->spdCmdHz = -maxSpd;
+    }
+}
+
+/**
+  * @brief Only the first and the fourth order sliding mode observers can be selected.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostObserverTypeUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    if (mtrCtrl->obserType != FOC_OBSERVERTYPE_SMO4TH) {
+        mtrCtrl->obserType = FOC_OBSERVERTYPE_SMO1TH;
+    }
+}
+
+/**
+  * @brief PLL gains from the bandwidth: kp = 2 * bdw, ki = bdw * bdw.
+  * @param pll The PLL handle.
+  */
+static void HostPllGainUpdate(PLL_Handle *pll)
+{
+    pll->pi.kp = 2.0f * pll->pllBdw; /* kp = 2.0f * pllBdw */
+    pll->pi.ki = pll->pllBdw * pll->pllBdw;
+}
+
+/**
+  * @brief First order observer PLL gains.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostSmoPllUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    HostPllGainUpdate(&mtrCtrl->smo.pll);
+}
+
+/**
+  * @brief Fourth order observer PLL gains.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostSmo4thPllUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    HostPllGainUpdate(&mtrCtrl->smo4th.pll);
+}
+
+/**
+  * @brief First order observer speed filter coefficients from the cut-off frequency.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostSmoSpdFilterUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    FOFLT_Handle *filter = &mtrCtrl->smo.spdFilter;
+    filter->a1 = 1.0f / (1.0f + DOUBLE_PI * filter->fc * CTRL_CURR_PERIOD);
+    filter->b1 = 1.0f - filter->a1;
+}
+
+/**
+  * @brief Current loop voltage limit from the SVPWM voltage per unit.
+  * @param mtrCtrl The motor control handle.
+  */
+static void HostVoltPuUpdate(MTRCTRL_Handle *mtrCtrl)
+{
+    mtrCtrl->currCtrl.outLimit = mtrCtrl->sv.voltPu * ONE_DIV_SQRT3;
+}
+
+/* Sorted by ID for the binary search */
+static const HOST_ParamEntry g_hostParamTable[] = {
+    PARAM_RO(HOST_PID_IQ_FBK, HOST_PARAM_F32, idqFbk.q),
+    PARAM_RO(HOST_PID_ID_FBK, HOST_PARAM_F32, idqFbk.d),
+    PARAM_RO(HOST_PID_IQ_REF, HOST_PARAM_F32, idqRef.q),
+    PARAM_RO(HOST_PID_ID_REF, HOST_PARAM_F32, idqRef.d),
+    PARAM_RO(HOST_PID_SPD_EST, HOST_PARAM_F32, smo.spdEst),
+    PARAM_RO(HOST_PID_SPD_REF, HOST_PARAM_F32, spdRefHz),
+    PARAM_RO(HOST_PID_UDC, HOST_PARAM_F32, udc),
+    PARAM_RO(HOST_PID_BOARD_TEMP, HOST_PARAM_F32, powerBoardTemp),
+    PARAM_RO(HOST_PID_ERR_CODE, HOST_PARAM_U16, prot.motorErrStatus.all),
+    PARAM_RO(HOST_PID_CURR_U, HOST_PARAM_F32, currUvw.u),
+    PARAM_RO(HOST_PID_CURR_V, HOST_PARAM_F32, currUvw.v),
+    PARAM_RO(HOST_PID_CURR_W, HOST_PARAM_F32, currUvw.w),
+    PARAM_RO(HOST_PID_DUTY_U, HOST_PARAM_F32, dutyUvw.u),
+    PARAM_RO(HOST_PID_DUTY_V, HOST_PARAM_F32, dutyUvw.v),
+    PARAM_RO(HOST_PID_DUTY_W, HOST_PARAM_F32, dutyUvw.w),
+    PARAM_RO(HOST_PID_AXIS_ANGLE, HOST_PARAM_F32, axisAngle),
+    PARAM_RO(HOST_PID_VQ_REF, HOST_PARAM_F32, vdqRef.q),
+    PARAM_RO(HOST_PID_VD_REF, HOST_PARAM_F32, vdqRef.d),
+
+    PARAM_RW(HOST_PID_CURRD_KP, HOST_PARAM_F32, currCtrl.dAxisPi.kp, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_CURRD_KI, HOST_PARAM_F32, currCtrl.dAxisPi.ki, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_CURRQ_KP, HOST_PARAM_F32, currCtrl.qAxisPi.kp, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_CURRQ_KI, HOST_PARAM_F32, currCtrl.qAxisPi.ki, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_CURR_LIMIT, HOST_PARAM_F32, currCtrl.qAxisPi.upperLimit, 0.0f, INV_VOLTAGE_BUS,
+             HostCurrLimitUpdate),
+
+    PARAM_RW(HOST_PID_SPD_KP, HOST_PARAM_F32, spdCtrl.spdPi.kp, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_SPD_KI, HOST_PARAM_F32, spdCtrl.spdPi.ki, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_SPD_LIMIT, HOST_PARAM_F32, spdCtrl.spdPi.upperLimit, 0.0f, HOST_CURR_RANGE,
+             HostSpdLimitUpdate),
+    PARAM_RW(HOST_PID_SPD_CMD, HOST_PARAM_F32, spdCmdHz, -HOST_SPD_RANGE, HOST_SPD_RANGE, HostSpdCmdUpdate),
+    PARAM_RW(HOST_PID_SPD_RAMP, HOST_PARAM_F32, spdRmg.delta, 0.0f, HOST_SPD_RANGE, NULL),
+
+    PARAM_RW(HOST_PID_OBSERVER_TYPE, HOST_PARAM_U8, obserType, FOC_OBSERVERTYPE_SMO1TH, FOC_OBSERVERTYPE_SMO4TH,
+             HostObserverTypeUpdate),
+    PARAM_RW(HOST_PID_SMO_GAIN, HOST_PARAM_F32, smo.kSmo, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_SMO_PLL_BDW, HOST_PARAM_F32, smo.pll.pllBdw, 0.0f, HOST_BDW_MAX, HostSmoPllUpdate),
+    PARAM_RW(HOST_PID_SMO_SPD_FC, HOST_PARAM_F32, smo.spdFilter.fc, 0.0f, HOST_BDW_MAX, HostSmoSpdFilterUpdate),
+    PARAM_RW(HOST_PID_SMO_FILCOMP, HOST_PARAM_F32, smo.filCompAngle, -DOUBLE_PI, DOUBLE_PI, NULL),
+    PARAM_RW(HOST_PID_SMO4TH_KD, HOST_PARAM_F32, smo4th.kd, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_SMO4TH_KQ, HOST_PARAM_F32, smo4th.kq, 0.0f, HOST_GAIN_MAX, NULL),
+    PARAM_RW(HOST_PID_SMO4TH_PLL_BDW, HOST_PARAM_F32, smo4th.pll.pllBdw, 0.0f, HOST_BDW_MAX, HostSmo4thPllUpdate),
+
+    PARAM_RW(HOST_PID_IF_TARGET, HOST_PARAM_F32, ifCtrl.targetAmp, 0.0f, HOST_CURR_RANGE, NULL),
+    PARAM_RW(HOST_PID_IF_STEP, HOST_PARAM_F32, ifCtrl.stepAmp, 0.0f, HOST_CURR_RANGE, NULL),
+    PARAM_RW(HOST_PID_SPD_BEGIN, HOST_PARAM_F32, startup.spdBegin, 0.0f, HOST_SPD_RANGE, NULL),
+
+    PARAM_RW(HOST_PID_MTR_NP, HOST_PARAM_U16, mtrParam.mtrNp, 1.0f, HOST_NP_MAX, NULL),
+    PARAM_RW(HOST_PID_MTR_RS, HOST_PARAM_F32, mtrParam.mtrRs, 0.0f, HOST_RES_MAX, NULL),
+    PARAM_RW(HOST_PID_MTR_LD, HOST_PARAM_F32, mtrParam.mtrLd, 0.0f, HOST_IND_MAX, NULL),
+    PARAM_RW(HOST_PID_MTR_LQ, HOST_PARAM_F32, mtrParam.mtrLq, 0.0f, HOST_IND_MAX, NULL),
+    PARAM_RW(HOST_PID_MAX_ELEC_SPD, HOST_PARAM_F32, mtrParam.maxElecSpd, 0.0f, HOST_SPD_RANGE, NULL),
+
+    PARAM_RW(HOST_PID_VOLT_PU, HOST_PARAM_F32, sv.voltPu, 0.0f, INV_VOLTAGE_BUS, HostVoltPuUpdate),
+    PARAM_RW(HOST_PID_ADC_CURR_COFE, HOST_PARAM_F32, adcCurrCofe, 0.0f, 1.0f, NULL),
+    PARAM_RW(HOST_PID_CURR_CTRL_PERIOD, HOST_PARAM_F32, currCtrlPeriod, 1.0e-6f, 1.0e-2f, NULL),
+
+    PARAM_RO(HOST_PID_FSM_STATE, HOST_PARAM_I32, stateMachine),
+    PARAM_RO(HOST_PID_SPD_ADJUST_MODE, HOST_PARAM_U8, spdAdjustMode),
+    PARAM_RO(HOST_PID_MOTOR_RUN, HOST_PARAM_U8, motorStateFlag),
+};
+
+#define HOST_PARAM_NUM              (sizeof(g_hostParamTable) / sizeof(g_hostParamTable[0]))
+
+/**
+  * @brief Number of parameters.
+  * @retval Table length.
+  */
+unsigned int HOST_ParamNum(void)
+{
+    return HOST_PARAM_NUM;
+}
+
+/**
+  * @brief Parameter by table index, to list the table.
+  * @param idx Table index.
+  * @retval Table entry, NULL past the end.
+  */
+const HOST_ParamEntry *HOST_ParamAt(unsigned int idx)
+{
+    return (idx < HOST_PARAM_NUM) ? &g_hostParamTable[idx] : NULL;
+}
+
+/**
+  * @brief Parameter by ID.
+  * @param id Parameter ID.
+  * @retval Table entry, NULL if the ID is unknown.
+  */
+const HOST_ParamEntry *HOST_ParamFind(unsigned short id)
+{
+    unsigned int low = 0;
+    unsigned int high = HOST_PARAM_NUM;
+    while (low < high) {
+        unsigned int mid = (low + high) >> 1;
+        if (g_hostParamTable[mid].id < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < HOST_PARAM_NUM && g_hostParamTable[low].id == id) ? &g_hostParamTable[low] : NULL;
+}
+
+/**
+  * @brief Read a parameter as its 32-bit wire value.
+  * @param mtrCtrl The motor control handle.
+  * @param param Table entry.
+  * @retval Float bits, or the integer widened to 32 bits.
+  */
+unsigned int HOST_ParamRead(const MTRCTRL_Handle *mtrCtrl, const HOST_ParamEntry *param)
+{
+    MCS_ASSERT_PARAM(mtrCtrl != NULL);
+    MCS_ASSERT_PARAM(param != NULL);
+    const volatile unsigned char *addr = (const volatile unsigned char *)mtrCtrl + param->offset;
+    HOST_ParamValue value;
+    switch (param->type) {
+        case HOST_PARAM_F32:
+            value.f = *(const volatile float *)addr;
+            break;
+        case HOST_PARAM_U32:
+            value.u = *(const volatile unsigned int *)addr;
+            break;
+        case HOST_PARAM_I32:
+            value.u = (unsigned int)*(const volatile int *)addr;
+            break;
+        case HOST_PARAM_U16:
+            value.u = *(const volatile unsigned short *)addr;
+            break;
+        default:
+            value.u = *addr;
+            break;
+    }
+    return value.u;
+}
+
+/**
+  * @brief Check a value before writing it.
+  * @param param Table entry.
+  * @param value 32-bit wire value.
+  * @retval HOST_OK, HOST_ERR_READ_ONLY or HOST_ERR_RANGE.
+  */
+HOST_Status HOST_ParamCheck(const HOST_ParamEntry *param, unsigned int value)
+{
+    MCS_ASSERT_PARAM(param != NULL);
+    if ((param->flags & HOST_PARAM_READ_ONLY) != 0) {
+        return HOST_ERR_READ_ONLY;
+    }
+    HOST_ParamValue raw;
+    raw.u = value;
+    float val;
+    if (param->type == HOST_PARAM_F32) {
+        val = raw.f;
+    } else if (param->type == HOST_PARAM_I32) {
+        val = (float)(int)value;
+    } else {
+        val = (float)value;
+    }
+    /* Written this way a NaN fails the check too */
+    if (!(val >= param->min && val <= param->max)) {
+        return HOST_ERR_RANGE;
+    }
+    return HOST_OK;
+}
+
+/**
+  * @brief Write a checked value and update the values derived from it.
+  * @param mtrCtrl The motor control handle.
+  * @param param Table entry.
+  * @param value 32-bit wire value, accepted by HOST_ParamCheck().
+  */
+void HOST_ParamWrite(MTRCTRL_Handle *mtrCtrl, const HOST_ParamEntry *param, unsigned int value)
+{
+    MCS_ASSERT_PARAM(mtrCtrl != NULL);
+    MCS_ASSERT_PARAM(param != NULL);
+    volatile unsigned char *addr = (volatile unsigned char *)mtrCtrl + param->offset;
+    HOST_ParamValue raw;
+    raw.u = value;
+    switch (param->type) {
+        case HOST_PARAM_F32:
+            *(volatile float *)addr = raw.f;
+            break;
+        case HOST_PARAM_U32:
+        case HOST_PARAM_I32:
+            *(volatile unsigned int *)addr = value;
+            break;
+        case HOST_PARAM_U16:
+            *(volatile unsigned short *)addr = (unsigned short)value;
+            break;
+        default:
+            *addr = (unsigned char)value;
+            break;
+    }
+    if (param->onWrite != NULL) {
+        param->onWrite(mtrCtrl);
+    }
+}
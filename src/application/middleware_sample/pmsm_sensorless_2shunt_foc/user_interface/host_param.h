@@ -0,0 +1,129 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      host_param.h
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions declaration of the parameter table of the host link.
+  * @details   Every value the host reads, writes or streams has a 16-bit ID. The high byte groups the IDs:
+  *            0x01 measurements (read only), 0x02 current loop, 0x03 speed loop, 0x04 observers, 0x05 startup,
+  *            0x06 motor, 0x07 board, 0x08 control state (read only). Values are in the units of the control
+  *            code (electrical Hz, A, V, s) and travel as 32 bits, the floats as IEEE-754 single precision.
+  */
+#ifndef McsMagicTag_HOST_PARAM_H
+#define McsMagicTag_HOST_PARAM_H
+
+#include "mcs_carrier.h"
+#include "host_frame.h"
+
+/* Measurements */
+#define HOST_PID_IQ_FBK             0x0100
+#define HOST_PID_ID_FBK             0x0101
+#define HOST_PID_IQ_REF             0x0102
+#define HOST_PID_ID_REF             0x0103
+#define HOST_PID_SPD_EST            0x0104
+#define HOST_PID_SPD_REF            0x0105
+#define HOST_PID_UDC                0x0106
+#define HOST_PID_BOARD_TEMP         0x0107
+#define HOST_PID_ERR_CODE           0x0108
+#define HOST_PID_CURR_U             0x0109
+#define HOST_PID_CURR_V             0x010A
+#define HOST_PID_CURR_W             0x010B
+#define HOST_PID_DUTY_U             0x010C
+#define HOST_PID_DUTY_V             0x010D
+#define HOST_PID_DUTY_W             0x010E
+#define HOST_PID_AXIS_ANGLE         0x010F
+#define HOST_PID_VQ_REF             0x0110
+#define HOST_PID_VD_REF             0x0111
+/* Current loop */
+#define HOST_PID_CURRD_KP           0x0200
+#define HOST_PID_CURRD_KI           0x0201
+#define HOST_PID_CURRQ_KP           0x0202
+#define HOST_PID_CURRQ_KI           0x0203
+#define HOST_PID_CURR_LIMIT         0x0204  /* Output voltage limit of both axes */
+/* Speed loop */
+#define HOST_PID_SPD_KP             0x0300
+#define HOST_PID_SPD_KI             0x0301
+#define HOST_PID_SPD_LIMIT          0x0302  /* Output current limit */
+#define HOST_PID_SPD_CMD            0x0303  /* Target speed, electrical Hz */
+#define HOST_PID_SPD_RAMP           0x0304  /* Speed step per systick period, electrical Hz */
+/* Observers */
+#define HOST_PID_OBSERVER_TYPE      0x0400
+#define HOST_PID_SMO_GAIN           0x0401
+#define HOST_PID_SMO_PLL_BDW        0x0402
+#define HOST_PID_SMO_SPD_FC         0x0403
+#define HOST_PID_SMO_FILCOMP        0x0404
+#define HOST_PID_SMO4TH_KD          0x0410
+#define HOST_PID_SMO4TH_KQ          0x0411
+#define HOST_PID_SMO4TH_PLL_BDW     0x0412
+/* Startup */
+#define HOST_PID_IF_TARGET          0x0500
+#define HOST_PID_IF_STEP            0x0501  /* I/F current step per systick period */
+#define HOST_PID_SPD_BEGIN          0x0502  /* Switch to closed loop speed, electrical Hz */
+/* Motor */
+#define HOST_PID_MTR_NP             0x0600
+#define HOST_PID_MTR_RS             0x0601
+#define HOST_PID_MTR_LD             0x0602
+#define HOST_PID_MTR_LQ             0x0603
+#define HOST_PID_MAX_ELEC_SPD       0x0604
+/* Board */
+#define HOST_PID_VOLT_PU            0x0700
+#define HOST_PID_ADC_CURR_COFE      0x0701
+#define HOST_PID_CURR_CTRL_PERIOD   0x0702
+/* Control state */
+#define HOST_PID_FSM_STATE          0x0800
+#define HOST_PID_SPD_ADJUST_MODE    0x0801
+#define HOST_PID_MOTOR_RUN          0x0802
+
+/**
+  * @brief Storage type of a parameter, values always travel as 32 bits.
+  */
+typedef enum {
+    HOST_PARAM_F32 = 0,
+    HOST_PARAM_U32,
+    HOST_PARAM_I32,
+    HOST_PARAM_U16,
+    HOST_PARAM_U8
+} HOST_ParamType;
+
+#define HOST_PARAM_READ_ONLY        0x01
+
+/**
+  * @brief 32-bit wire value, the bits of a float for HOST_PARAM_F32.
+  */
+typedef union {
+    unsigned int u;
+    float f;
+} HOST_ParamValue;
+
+typedef struct {
+    unsigned short id;
+    unsigned char type;                         /* HOST_ParamType */
+    unsigned char flags;
+    unsigned int offset;                        /* Offset in MTRCTRL_Handle */
+    float min;                                  /* Write range, bounds included */
+    float max;
+    void (*onWrite)(MTRCTRL_Handle *mtrCtrl);   /* Update the values derived from the parameter, may be NULL */
+} HOST_ParamEntry;
+
+unsigned int HOST_ParamNum(void);
+const HOST_ParamEntry *HOST_ParamAt(unsigned int idx);
+const HOST_ParamEntry *HOST_ParamFind(unsigned short id);
+unsigned int HOST_ParamRead(const MTRCTRL_Handle *mtrCtrl, const HOST_ParamEntry *param);
+HOST_Status HOST_ParamCheck(const HOST_ParamEntry *param, unsigned int value);
+void HOST_ParamWrite(MTRCTRL_Handle *mtrCtrl, const HOST_ParamEntry *param, unsigned int value);
+
+#endif
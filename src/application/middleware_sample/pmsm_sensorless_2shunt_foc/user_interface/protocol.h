@@ -37,6 +37,7 @@
 #define  FRAME_LENTH                        20     /* Data length */
 #define  FRAME_SENT                         0X8F
 #define  FRAME_CUSTACK                      0X8A
+#define  FRAME_SCOPE                        0X8B   /* Scope capture upload frame */
 #define  FRAME_START                        0x0F   /* Start frame */
 #define  FRAME_END                          '/'    /* StOP frame */
 #define  FRAME_CHECK_BEGIN                  1     /* Check frame */
@@ -60,6 +61,13 @@
 #define  CMDCODE_SET_ADJUSTSPD_MODE         0x11
 #define  CMDCODE_UART_HANDSHAKE             0x12
 #define  CMDCODE_UART_HEARTDETECT           0x13
+/* Scope capture, the variable addresses are sent as integers, the other values as floats */
+#define  CMDCODE_SCOPE_SET_CHANNEL          0x14   /* Channel index, address, type, scale */
+#define  CMDCODE_SCOPE_SET_TRIGGER          0x15   /* Address, type, trigger mode, level */
+#define  CMDCODE_SCOPE_ARM                  0x16   /* Channel number, decimation, pre-trigger samples */
+#define  CMDCODE_SCOPE_FORCE                0x17
+#define  CMDCODE_SCOPE_STOP                 0x18
+#define  CMDCODE_SCOPE_UPLOAD               0x19
 
 typedef union {
     unsigned char typeCh[4];
@@ -0,0 +1,529 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      scope_capture.c
+  * @author    MCU Algorithm Team
+  * @brief     Triggered scope capture. Selected variables are recorded at carrier rate or a decimated rate into a
+  *            RAM ring with pre/post trigger samples, then uploaded by the UART DMA in delta-encoded frames.
+  */
+#include "scope_capture.h"
+#include "protocol.h"
+#include "drvcommon.h"
+#include "mcs_assert.h"
+
+#define SCOPE_FRAME_HEAD_LEN    (5)         /* Start, code, sequence low, sequence high, payload length */
+#define SCOPE_PAYLOAD_MAX       (255)
+#define SCOPE_VARINT_MAX        (3)         /* Zigzag delta of two 16-bit samples fits in 17 bits */
+#define SCOPE_SAMPLE_MAX        (32767.0f)
+#define SCOPE_SAMPLE_MIN        (-32768.0f)
+
+/**
+  * @brief Frame checksum, same rule as the protocol layer.
+  * @param ptr Pointer to the data to be checked
+  * @param num Number of bytes
+  * @retval unsigned char Checksum
+  */
+static unsigned char ScopeCheckSum(const unsigned char *ptr, unsigned int num)
+{
+    unsigned char sum = 0;
+    for (unsigned int i = 0; i < num; i++) {
+        sum += ptr[i];
+    }
+    return sum;
+}
+
+/**
+  * @brief Read a variable and convert it to float.
+  * @param var Variable address and type.
+  * @retval Variable value.
+  */
+static float ScopeReadVar(const SCOPE_Var *var)
+{
+    switch (var->type) {
+        case SCOPE_VAR_FLOAT:
+            return *(volatile const float *)var->addr;
+        case SCOPE_VAR_INT:
+            return (float)(*(volatile const int *)var->addr);
+        case SCOPE_VAR_UINT:
+            return (float)(*(volatile const unsigned int *)var->addr);
+        case SCOPE_VAR_SHORT:
+            return (float)(*(volatile const short *)var->addr);
+        case SCOPE_VAR_USHORT:
+            return (float)(*(volatile const unsigned short *)var->addr);
+        case SCOPE_VAR_CHAR:
+            return (float)(*(volatile const signed char *)var->addr);
+        case SCOPE_VAR_UCHAR:
+            return (float)(*(volatile const unsigned char *)var->addr);
+        default:
+            return 0.0f;
+    }
+}
+
+/**
+  * @brief Check that a variable can be read by ScopeReadVar() from the carrier interrupt without a bus fault:
+  *        the whole variable lies in SRAM and its address is aligned to its size.
+  * @param addr Variable address.
+  * @param type Variable type.
+  * @retval true if the address is usable.
+  */
+static bool ScopeVarIsValid(unsigned int addr, SCOPE_VarType type)
+{
+    static const unsigned char varSize[SCOPE_VAR_MAX] = {
+        sizeof(float), sizeof(int), sizeof(unsigned int), sizeof(short), sizeof(unsigned short),
+        sizeof(signed char), sizeof(unsigned char)
+    };
+    unsigned int size = varSize[type];
+    return (addr >= SRAM_START && addr <= SRAM_END + 1 - size && (addr & (size - 1)) == 0);
+}
+
+/**
+  * @brief Scale a value to a 16-bit sample, with saturation.
+  * @param value Variable value.
+  * @param scale Channel scale.
+  * @retval Recorded sample.
+  */
+static short ScopeQuantise(float value, float scale)
+{
+    float sample = value * scale;
+    if (sample >= SCOPE_SAMPLE_MAX) {
+        return (short)SCOPE_SAMPLE_MAX;
+    }
+    if (sample <= SCOPE_SAMPLE_MIN) {
+        return (short)SCOPE_SAMPLE_MIN;
+    }
+    return (short)sample;
+}
+
+/**
+  * @brief Check the trigger condition on the current trigger source value.
+  * @param scope The scope handle.
+  * @param value Trigger source value.
+  * @retval true if the condition is met.
+  */
+static bool ScopeTrigHit(const SCOPE_Handle *scope, float value)
+{
+    switch (scope->trigMode) {
+        case SCOPE_TRIG_AUTO:
+            return true;
+        case SCOPE_TRIG_RISING:
+            return scope->trigPrimed != 0 && scope->trigLast < scope->trigLevel && value >= scope->trigLevel;
+        case SCOPE_TRIG_FALLING:
+            return scope->trigPrimed != 0 && scope->trigLast > scope->trigLevel && value <= scope->trigLevel;
+        case SCOPE_TRIG_ABOVE:
+            return value >= scope->trigLevel;
+        case SCOPE_TRIG_BELOW:
+            return value <= scope->trigLevel;
+        default:
+            return false;
+    }
+}
+
+/**
+  * @brief Check that the capture configuration may be changed.
+  * @param scope The scope handle.
+  * @retval true if the ISR is not recording and no upload is in progress.
+  */
+static bool ScopeIsConfigurable(const SCOPE_Handle *scope)
+{
+    return (scope->state == SCOPE_IDLE || scope->state == SCOPE_DONE) && scope->uploading == 0;
+}
+
+/**
+  * @brief Init the scope.
+  * @param scope The scope handle.
+  * @param buff Capture ring of SCOPE_BUFF_LEN words.
+  */
+void SCOPE_Init(SCOPE_Handle *scope, short *buff)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    MCS_ASSERT_PARAM(buff != NULL);
+    for (unsigned int i = 0; i < SCOPE_CHANNEL_MAX; i++) {
+        scope->chn[i].var.addr = NULL;
+        scope->chn[i].var.type = SCOPE_VAR_FLOAT;
+        scope->chn[i].scale = 1.0f;
+    }
+    scope->chnNum = 0;
+    scope->trigVar.addr = NULL;
+    scope->trigVar.type = SCOPE_VAR_FLOAT;
+    scope->trigMode = SCOPE_TRIG_AUTO;
+    scope->trigLevel = 0.0f;
+    scope->trigLast = 0.0f;
+    scope->trigPrimed = 0;
+    scope->buff = buff;
+    scope->depth = 0;
+    scope->preNum = 0;
+    scope->writeIdx = 0;
+    scope->filled = 0;
+    scope->postLeft = 0;
+    scope->decimation = 1;
+    scope->decimCnt = 0;
+    scope->state = SCOPE_IDLE;
+    scope->forceReq = 0;
+    scope->uploading = 0;
+    scope->uploadSeq = 0;
+    scope->uploadCnt = 0;
+}
+
+/**
+  * @brief Select the variable recorded by a channel.
+  * @param scope The scope handle.
+  * @param idx Channel index.
+  * @param addr Variable address, as listed in the map file, in SRAM and aligned to the size of the type.
+  * @param type Variable type.
+  * @param scale Recorded sample = variable * scale, choose it so that the range of interest fills 16 bits.
+  * @retval BASE_STATUS_ERROR if the address is outside SRAM or misaligned, BASE_STATUS_BUSY while recording or
+  *         uploading.
+  */
+BASE_StatusType SCOPE_SetChannel(SCOPE_Handle *scope, unsigned int idx, unsigned int addr,
+                                 SCOPE_VarType type, float scale)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    if (idx >= SCOPE_CHANNEL_MAX || type >= SCOPE_VAR_MAX || !ScopeVarIsValid(addr, type) || scale == 0.0f) {
+        return BASE_STATUS_ERROR;
+    }
+    if (!ScopeIsConfigurable(scope)) {
+        return BASE_STATUS_BUSY;
+    }
+    scope->chn[idx].var.addr = (volatile const void *)addr;
+    scope->chn[idx].var.type = type;
+    scope->chn[idx].scale = scale;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Set the trigger condition.
+  * @param scope The scope handle.
+  * @param addr Trigger source address, any variable in SRAM aligned to the size of the type.
+  *        Not used by SCOPE_TRIG_AUTO.
+  * @param type Trigger source type.
+  * @param mode Trigger condition.
+  * @param level Trigger level, in the unit of the variable.
+  * @retval BASE_STATUS_ERROR if the address is outside SRAM or misaligned, BASE_STATUS_BUSY while recording or
+  *         uploading.
+  */
+BASE_StatusType SCOPE_SetTrigger(SCOPE_Handle *scope, unsigned int addr, SCOPE_VarType type,
+                                 SCOPE_TrigMode mode, float level)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    if (mode >= SCOPE_TRIG_MAX || type >= SCOPE_VAR_MAX) {
+        return BASE_STATUS_ERROR;
+    }
+    if (mode != SCOPE_TRIG_AUTO && !ScopeVarIsValid(addr, type)) {
+        return BASE_STATUS_ERROR;
+    }
+    if (!ScopeIsConfigurable(scope)) {
+        return BASE_STATUS_BUSY;
+    }
+    scope->trigVar.addr = (volatile const void *)addr;
+    scope->trigVar.type = type;
+    scope->trigMode = mode;
+    scope->trigLevel = level;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Start recording and wait for the trigger.
+  * @param scope The scope handle.
+  * @param chnNum Number of channels recorded, starting from channel 0.
+  * @param decimation Record one of every decimation carrier periods, 1 records every period.
+  * @param preNum Samples kept before the trigger sample, less than the ring depth.
+  * @retval BASE_STATUS_BUSY while recording or uploading.
+  */
+BASE_StatusType SCOPE_Arm(SCOPE_Handle *scope, unsigned int chnNum, unsigned int decimation, unsigned int preNum)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    if (chnNum == 0 || chnNum > SCOPE_CHANNEL_MAX || decimation == 0 || decimation > 0xFFFF) {
+        return BASE_STATUS_ERROR;
+    }
+    for (unsigned int i = 0; i < chnNum; i++) {
+        if (scope->chn[i].var.addr == NULL) {
+            return BASE_STATUS_ERROR;
+        }
+    }
+    if (preNum >= SCOPE_BUFF_LEN / chnNum) {
+        return BASE_STATUS_ERROR;
+    }
+    unsigned int key = BASE_FUNC_IntLock();
+    if (!ScopeIsConfigurable(scope)) {
+        BASE_FUNC_IntUnlock(key);
+        return BASE_STATUS_BUSY;
+    }
+    scope->chnNum = chnNum;
+    scope->depth = SCOPE_BUFF_LEN / chnNum;
+    scope->preNum = preNum;
+    scope->writeIdx = 0;
+    scope->filled = 0;
+    scope->postLeft = 0;
+    scope->decimation = (unsigned short)decimation;
+    scope->decimCnt = 0;
+    scope->trigPrimed = 0;
+    scope->forceReq = 0;
+    scope->state = SCOPE_ARMED;
+    BASE_FUNC_IntUnlock(key);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Trigger at the next recorded sample, whatever the trigger condition.
+  * @param scope The scope handle.
+  */
+void SCOPE_Force(SCOPE_Handle *scope)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    unsigned int key = BASE_FUNC_IntLock();
+    if (scope->state == SCOPE_ARMED) {
+        scope->forceReq = 1;
+    }
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+  * @brief Stop recording and abort the upload, the recorded samples are dropped.
+  * @param scope The scope handle.
+  */
+void SCOPE_Stop(SCOPE_Handle *scope)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    unsigned int key = BASE_FUNC_IntLock();
+    scope->state = SCOPE_IDLE;
+    scope->forceReq = 0;
+    scope->uploading = 0;
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+  * @brief Start uploading a finished capture, the frames are then built by SCOPE_UploadFrame().
+  * @param scope The scope handle.
+  * @retval BASE_STATUS_BUSY if no capture is finished.
+  */
+BASE_StatusType SCOPE_StartUpload(SCOPE_Handle *scope)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    if (scope->state != SCOPE_DONE) {
+        return BASE_STATUS_BUSY;
+    }
+    /* Uploading again from the start is allowed, to recover lost frames */
+    scope->uploadSeq = 0;
+    scope->uploadCnt = 0;
+    scope->uploading = 1;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Write a zigzag varint: 7 bits per byte, least significant first, bit 7 set when more bytes follow.
+  * @param out Output buffer.
+  * @param delta Signed difference of two samples.
+  * @retval Bytes written.
+  */
+static unsigned int ScopePutVarint(unsigned char *out, int delta)
+{
+    unsigned int value = (delta >= 0) ? ((unsigned int)delta << 1) : ((((unsigned int)(-delta)) << 1) - 1);
+    unsigned int len = 0;
+    while (value >= 0x80) {
+        out[len++] = (unsigned char)(value | 0x80);
+        value >>= 7; /* 7 bits per byte */
+    }
+    out[len++] = (unsigned char)value;
+    return len;
+}
+
+/**
+  * @brief Recorded sample in upload order: the oldest first, the trigger sample at index preNum.
+  * @param scope The scope handle.
+  * @param n Upload order index.
+  * @retval First channel of the sample.
+  */
+static const short *ScopeSampleAt(const SCOPE_Handle *scope, unsigned int n)
+{
+    /* The ring is full once the capture is done, the oldest sample is the next one to be written */
+    unsigned int idx = scope->writeIdx + n;
+    if (idx >= scope->depth) {
+        idx -= scope->depth;
+    }
+    return &scope->buff[idx * scope->chnNum];
+}
+
+/**
+  * @brief Header payload: channel number, decimation, depth, pre-trigger samples (16 bits little endian) and
+  *        the float scale of each channel, to convert the samples back.
+  * @param scope The scope handle.
+  * @param payload Output buffer.
+  * @retval Payload length.
+  */
+static unsigned int ScopeEncodeHeader(const SCOPE_Handle *scope, unsigned char *payload)
+{
+    unsigned int len = 0;
+    payload[len++] = (unsigned char)scope->chnNum;
+    payload[len++] = (unsigned char)scope->decimation;
+    payload[len++] = (unsigned char)(scope->decimation >> 8);   /* 8: high byte */
+    payload[len++] = (unsigned char)scope->depth;
+    payload[len++] = (unsigned char)(scope->depth >> 8);        /* 8: high byte */
+    payload[len++] = (unsigned char)scope->preNum;
+    payload[len++] = (unsigned char)(scope->preNum >> 8);       /* 8: high byte */
+    for (unsigned int i = 0; i < scope->chnNum; i++) {
+        UNIONDATATYPE_DEF scale;
+        scale.typeF = scope->chn[i].scale;
+        for (unsigned int j = 0; j < FRAME_ONE_DATA_LENTH; j++) {
+            payload[len++] = scale.typeCh[j];
+        }
+    }
+    return len;
+}
+
+/**
+  * @brief Sample payload: sample count, the first sample raw (16 bits little endian per channel), then the
+  *        following samples as per-channel zigzag varint deltas. Every frame decodes on its own.
+  * @param scope The scope handle.
+  * @param payload Output buffer.
+  * @param payloadMax Output buffer size.
+  * @retval Payload length.
+  */
+static unsigned int ScopeEncodeSamples(SCOPE_Handle *scope, unsigned char *payload, unsigned int payloadMax)
+{
+    unsigned int chnNum = scope->chnNum;
+    unsigned int len = 1;
+    unsigned int cnt = 1;
+    const short *prev = ScopeSampleAt(scope, scope->uploadCnt);
+    for (unsigned int i = 0; i < chnNum; i++) {
+        payload[len++] = (unsigned char)prev[i];
+        payload[len++] = (unsigned char)((unsigned short)prev[i] >> 8); /* 8: high byte */
+    }
+    while (scope->uploadCnt + cnt < scope->depth && cnt < 0xFF &&
+           len + chnNum * SCOPE_VARINT_MAX <= payloadMax) {
+        const short *cur = ScopeSampleAt(scope, scope->uploadCnt + cnt);
+        for (unsigned int i = 0; i < chnNum; i++) {
+            len += ScopePutVarint(&payload[len], (int)cur[i] - (int)prev[i]);
+        }
+        prev = cur;
+        cnt++;
+    }
+    payload[0] = (unsigned char)cnt;
+    scope->uploadCnt += cnt;
+    return len;
+}
+
+/**
+  * @brief Build the payload of the next upload frame. Sequence 0 carries the header, the following frames carry
+  *        the samples in upload order.
+  * @param scope The scope handle.
+  * @param payload Payload buffer.
+  * @param payloadMax Payload buffer size, at least SCOPE_UPLOAD_PAYLOAD_MIN.
+  * @param seq Sequence number of the frame.
+  * @retval Payload length, 0 if no upload is in progress.
+  */
+unsigned int SCOPE_UploadPayload(SCOPE_Handle *scope, unsigned char *payload, unsigned int payloadMax,
+                                 unsigned short *seq)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    MCS_ASSERT_PARAM(payload != NULL);
+    MCS_ASSERT_PARAM(seq != NULL);
+    MCS_ASSERT_PARAM(payloadMax >= SCOPE_UPLOAD_PAYLOAD_MIN);
+    if (scope->uploading == 0) {
+        return 0;
+    }
+    if (payloadMax > SCOPE_PAYLOAD_MAX) {
+        payloadMax = SCOPE_PAYLOAD_MAX;
+    }
+    unsigned int len;
+    if (scope->uploadSeq == 0) {
+        len = ScopeEncodeHeader(scope, payload);
+    } else {
+        len = ScopeEncodeSamples(scope, payload, payloadMax);
+    }
+    *seq = scope->uploadSeq;
+    scope->uploadSeq++;
+    if (scope->uploadCnt >= scope->depth) {
+        scope->uploading = 0;
+    }
+    return len;
+}
+
+/**
+  * @brief Build the next upload frame: FRAME_START, FRAME_SCOPE, sequence (16 bits little endian), payload
+  *        length, payload, checksum from the code byte to the payload end, FRAME_END.
+  * @param scope The scope handle.
+  * @param txBuf Frame buffer, handed to the UART DMA by the caller.
+  * @param bufLen Frame buffer size.
+  * @retval Frame length, 0 if no upload is in progress.
+  */
+unsigned int SCOPE_UploadFrame(SCOPE_Handle *scope, unsigned char *txBuf, unsigned int bufLen)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    MCS_ASSERT_PARAM(txBuf != NULL);
+    MCS_ASSERT_PARAM(bufLen > SCOPE_FRAME_OVERHEAD);
+    unsigned short seq;
+    unsigned int len = SCOPE_UploadPayload(scope, &txBuf[SCOPE_FRAME_HEAD_LEN], bufLen - SCOPE_FRAME_OVERHEAD, &seq);
+    if (len == 0) {
+        return 0;
+    }
+    unsigned int i = 0;
+    txBuf[i++] = FRAME_START;
+    txBuf[i++] = FRAME_SCOPE;
+    txBuf[i++] = (unsigned char)seq;
+    txBuf[i++] = (unsigned char)(seq >> 8);   /* 8: high byte */
+    txBuf[i++] = (unsigned char)len;
+    i += len;
+    txBuf[i] = ScopeCheckSum(&txBuf[FRAME_CHECK_BEGIN], i - FRAME_CHECK_BEGIN);
+    i++;
+    txBuf[i++] = FRAME_END;
+    return i;
+}
+
+/**
+  * @brief Record one sample, called from the carrier ISR.
+  * @param scope The scope handle.
+  */
+void SCOPE_Sample(SCOPE_Handle *scope)
+{
+    MCS_ASSERT_PARAM(scope != NULL);
+    SCOPE_State state = scope->state;
+    if (state != SCOPE_ARMED && state != SCOPE_TRIGGERED) {
+        return;
+    }
+    if (scope->decimCnt != 0) {
+        scope->decimCnt--;
+        return;
+    }
+    scope->decimCnt = scope->decimation - 1;
+    short *sample = &scope->buff[scope->writeIdx * scope->chnNum];
+    for (unsigned int i = 0; i < scope->chnNum; i++) {
+        sample[i] = ScopeQuantise(ScopeReadVar(&scope->chn[i].var), scope->chn[i].scale);
+    }
+    scope->writeIdx = (scope->writeIdx + 1 >= scope->depth) ? 0 : scope->writeIdx + 1;
+    if (state == SCOPE_TRIGGERED) {
+        scope->postLeft--;
+        if (scope->postLeft == 0) {
+            scope->state = SCOPE_DONE;
+        }
+        return;
+    }
+    if (scope->filled < scope->depth) {
+        scope->filled++;
+    }
+    /* The trigger source is read even before the pre-trigger samples are recorded, for the edge modes */
+    float value = (scope->trigVar.addr != NULL) ? ScopeReadVar(&scope->trigVar) : 0.0f;
+    bool hit = ScopeTrigHit(scope, value);
+    scope->trigLast = value;
+    scope->trigPrimed = 1;
+    if (scope->filled <= scope->preNum || (!hit && scope->forceReq == 0)) {
+        return;
+    }
+    /* This sample is the trigger sample, preNum samples are before it */
+    scope->forceReq = 0;
+    scope->postLeft = scope->depth - scope->preNum - 1;
+    scope->state = (scope->postLeft == 0) ? SCOPE_DONE : SCOPE_TRIGGERED;
+}
@@ -0,0 +1,122 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      scope_capture.h
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions declaration of the triggered in-RAM scope capture.
+  */
+#ifndef McsMagicTag_SCOPE_CAPTURE_H
+#define McsMagicTag_SCOPE_CAPTURE_H
+
+#include "typedefs.h"
+
+/* Capture ring size in 16-bit words, shared by all channels: depth = SCOPE_BUFF_LEN / chnNum samples */
+#define SCOPE_BUFF_LEN          (2048)
+#define SCOPE_CHANNEL_MAX       (8)
+/* Bytes added around the payload of an upload frame: start, code, sequence, length, checksum, end */
+#define SCOPE_FRAME_OVERHEAD    (7)
+#define SCOPE_HEADER_LEN        (7)     /* Channel number, decimation, depth, pre-trigger samples */
+/* Smallest upload payload buffer: the header and the float scale of every channel */
+#define SCOPE_UPLOAD_PAYLOAD_MIN    (SCOPE_HEADER_LEN + SCOPE_CHANNEL_MAX * 4)
+
+/**
+  * @brief Type of a captured variable, as seen at its address.
+  */
+typedef enum {
+    SCOPE_VAR_FLOAT = 0,
+    SCOPE_VAR_INT,
+    SCOPE_VAR_UINT,
+    SCOPE_VAR_SHORT,
+    SCOPE_VAR_USHORT,
+    SCOPE_VAR_CHAR,
+    SCOPE_VAR_UCHAR,
+    SCOPE_VAR_MAX
+} SCOPE_VarType;
+
+/**
+  * @brief Trigger condition, evaluated on every recorded sample.
+  * @details
+  *          + SCOPE_TRIG_AUTO    -- Trigger as soon as the pre-trigger samples are recorded.
+  *          + SCOPE_TRIG_RISING  -- Previous value below the level, current value at or above it.
+  *          + SCOPE_TRIG_FALLING -- Previous value above the level, current value at or below it.
+  *          + SCOPE_TRIG_ABOVE   -- Current value at or above the level.
+  *          + SCOPE_TRIG_BELOW   -- Current value at or below the level.
+  */
+typedef enum {
+    SCOPE_TRIG_AUTO = 0,
+    SCOPE_TRIG_RISING,
+    SCOPE_TRIG_FALLING,
+    SCOPE_TRIG_ABOVE,
+    SCOPE_TRIG_BELOW,
+    SCOPE_TRIG_MAX
+} SCOPE_TrigMode;
+
+typedef enum {
+    SCOPE_IDLE = 0,
+    SCOPE_ARMED,        /* Recording, waiting for the trigger */
+    SCOPE_TRIGGERED,    /* Recording the post-trigger samples */
+    SCOPE_DONE          /* Ring frozen, ready for upload */
+} SCOPE_State;
+
+typedef struct {
+    volatile const void *addr;
+    SCOPE_VarType type;
+} SCOPE_Var;
+
+typedef struct {
+    SCOPE_Var var;
+    float scale;                    /* Recorded value = variable * scale, saturated to 16 bits */
+} SCOPE_Channel;
+
+typedef struct {
+    SCOPE_Channel chn[SCOPE_CHANNEL_MAX];
+    unsigned int chnNum;
+    SCOPE_Var trigVar;              /* Trigger source, any variable, not necessarily a channel */
+    SCOPE_TrigMode trigMode;
+    float trigLevel;
+    float trigLast;                 /* Trigger source at the previous sample, for the edge modes */
+    unsigned char trigPrimed;       /* trigLast is valid */
+    short *buff;
+    unsigned int depth;             /* Samples in the ring */
+    unsigned int preNum;            /* Samples kept before the trigger sample */
+    unsigned int writeIdx;          /* Ring sample written next, the oldest sample once the ring is full */
+    unsigned int filled;            /* Samples recorded since arming, saturated at depth */
+    unsigned int postLeft;          /* Samples still to record after the trigger */
+    unsigned short decimation;      /* Record one of every decimation calls of SCOPE_Sample */
+    unsigned short decimCnt;
+    volatile SCOPE_State state;
+    unsigned char forceReq;         /* Trigger at the next sample once the pre-trigger samples are recorded */
+    unsigned char uploading;
+    unsigned short uploadSeq;       /* Sequence number of the next upload frame, 0 is the header */
+    unsigned int uploadCnt;         /* Samples uploaded */
+} SCOPE_Handle;
+
+void SCOPE_Init(SCOPE_Handle *scope, short *buff);
+BASE_StatusType SCOPE_SetChannel(SCOPE_Handle *scope, unsigned int idx, unsigned int addr,
+                                 SCOPE_VarType type, float scale);
+BASE_StatusType SCOPE_SetTrigger(SCOPE_Handle *scope, unsigned int addr, SCOPE_VarType type,
+                                 SCOPE_TrigMode mode, float level);
+BASE_StatusType SCOPE_Arm(SCOPE_Handle *scope, unsigned int chnNum, unsigned int decimation, unsigned int preNum);
+void SCOPE_Force(SCOPE_Handle *scope);
+void SCOPE_Stop(SCOPE_Handle *scope);
+BASE_StatusType SCOPE_StartUpload(SCOPE_Handle *scope);
+unsigned int SCOPE_UploadPayload(SCOPE_Handle *scope, unsigned char *payload, unsigned int payloadMax,
+                                 unsigned short *seq);
+unsigned int SCOPE_UploadFrame(SCOPE_Handle *scope, unsigned char *txBuf, unsigned int bufLen);
+void SCOPE_Sample(SCOPE_Handle *scope);
+
+#endif
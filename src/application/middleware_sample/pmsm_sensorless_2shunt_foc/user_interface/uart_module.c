@@ -20,16 +20,15 @@
     * @brief     This file provides functions declaration of Serial port communication.
     */
 #include "uart_module.h"
+#include "uart_rx_stream.h"
 #include "debug.h"
 #include "main.h"
 #include "baseinc.h"
+#include "mcs_user_config.h"
+#include "host_link.h"
 
 /* Buffer size */
 #define UI_TX_BUF_LEN    (96)
-#define UI_RX_BUF_LEN    (96)
-
-/* Receiving Timeout Interval */
-#define UART_TIME_OUT_MS (100)
 
 /* Start sending data to host delay after uart connect success */
 #define UART_UPDATA_DELAY_TIME_MS (50)
@@ -37,11 +36,17 @@
 /* Uart baudrate */
 #define UART0BAUDRATE (1843200)
 
-/* Data buffer */
-unsigned char g_uartRxBuf[UI_RX_BUF_LEN] = {0};
-unsigned char g_uartTxBuf[UI_TX_BUF_LEN] = {0};
 static unsigned int getdeltaSystickCnt = 0;
 static FRAME_Handle g_uartFrame;
+static RX_Stream g_uartRxStream;
+#ifdef HOST_LINK
+static HOST_Link g_hostLink;
+static unsigned char g_uartRxPkt[HOST_LINK_PKT_MAX];
+#else
+/* Data buffer */
+unsigned char g_uartTxBuf[UI_TX_BUF_LEN] = {0};
+#endif
+
 /**
     * @brief Receive Data Clear.
     * @param uartFrame  Receice Data.
@@ -50,15 +55,10 @@ static void FrameRecvClear(FRAME_Handle *uartFrame)
 {
     /* Clear buffer lenth. */
     uartFrame->buffLen = 0;
-    uartFrame->timeOutCnt = 0;
-    uartFrame->frameFlag = 0;
-    /* Clear received data lenth. */
-    uartFrame->rxLen = 0;
-    /* Clear received flag. */
-    uartFrame->rxFlag = 0;
     uartFrame->upDataCnt = 0;
 }
 
+#ifndef HOST_LINK
 /**
   * @brief Set Dma status.
   * @param mtrCtrl The motor control handle.
@@ -76,6 +76,7 @@ static void SetUartDmaStatus(MTRCTRL_Handle *mtrCtrl)
         mtrCtrl->uartTimeStamp = 0;
     }
 }
+#endif
 
 /**
     * @brief Set uart baudRate.
@@ -121,26 +122,6 @@ void UART0WriteInterruptCallback(void *handle)
     /* USER CODE END UART0_WRITE_IT_FINISH */
 }
 
-/**
-  * @brief Uart0 Interruput Read CallBack Function.
-  * @param handle  Uart handle.
-  */
-void UART0ReadInterruptCallback(void *handle)
-{
-    BASE_FUNC_UNUSED(handle);
-    /* USER CODE BEGIN UART0_READ_IT_FINISH */
-    if (g_uartFrame.rxLen >= UI_RX_BUF_LEN - 1) {
-        g_uartFrame.rxLen = 0;
-    }
-    HAL_UART_ReadIT(handle, &g_uartFrame.rxData, 1);
-    g_uartRxBuf[g_uartFrame.rxLen] = g_uartFrame.rxData;
-    g_uartFrame.rxLen++;
-    g_uartFrame.rxFlag = 1;
-    g_uartFrame.uartItTxFlag = 0;
-    return;
-    /* USER CODE END UART0_READ_IT_FINISH */
-}
-
 /**
   * @brief Uart Read Data Init Function.
   * @param void.
@@ -150,7 +131,13 @@ void UartRecvInit(void)
     /* Uart reception initialization */
     FrameRecvClear(&g_uartFrame);
     SetUartBaudRate(UART0BAUDRATE);
-    HAL_UART_ReadIT(&g_uart0, &g_uartFrame.rxData, 1);
+    /* Bytes are stored by the RX DMA ring, no per-byte interrupt */
+    RxStream_Init(&g_uartRxStream, &g_uart0, SYSTICK_GetCRGHZ());
+#ifdef HOST_LINK
+    /* The link sends only what is queued, the DMA is free from the start */
+    g_uartFrame.txFlag = 1;
+    HOST_LinkInit(&g_hostLink, &g_crc, UART0BAUDRATE, SYSTICK_GetCRGHZ());
+#endif
 }
 
 /**
@@ -161,19 +148,26 @@ void UartModuleProcess_Rx(MTRCTRL_Handle *mtrCtrl)
 {
     /* Verify Parameters */
     MCS_ASSERT_PARAM(mtrCtrl != NULL);
+#ifdef HOST_LINK
+    /* Frames are copied out of the DMA ring up to their delimiter, the response is queued at once */
+    unsigned int len = RxStream_GetPacket(&g_uartRxStream, g_uartRxPkt, HOST_LINK_PKT_MAX);
+    while (len > 0) {
+        HOST_LinkReceive(&g_hostLink, mtrCtrl, g_uartRxPkt, len);
+        len = RxStream_GetPacket(&g_uartRxStream, g_uartRxPkt, HOST_LINK_PKT_MAX);
+    }
+#else
     SetUartDmaStatus(mtrCtrl);
-    if (g_uartFrame.rxFlag == 1) {  /* Receive data flag. */
-        if (g_uartFrame.timeOutCnt++ > UART_TIME_OUT_MS) {
-            /* Received data from the host. */
-            g_uartFrame.frameFlag = 1;
-            g_uartFrame.rxFlag = 0;
-            g_uartFrame.timeOutCnt = 0;
-            /* Execute data process. */
-            CUST_DataReceProcss(mtrCtrl, g_uartRxBuf);
-            g_uartFrame.rxLen = 0;
-        }
+    /* Frames are processed as soon as they are complete, in place in the DMA ring */
+    unsigned char *frame = RxStream_GetFrame(&g_uartRxStream);
+    while (frame != NULL) {
+        /* An acknowledge may be sent by interrupt, hold the DMA upload until it is finished. */
+        g_uartFrame.uartItTxFlag = 0;
+        /* Execute data process. */
+        CUST_DataReceProcss(mtrCtrl, frame);
+        RxStream_ReleaseFrame(&g_uartRxStream);
+        frame = RxStream_GetFrame(&g_uartRxStream);
     }
-    g_uartFrame.frameFlag = 0;
+#endif
 }
 
 /**
@@ -184,15 +178,34 @@ void UartModuleProcess_Tx(MTRCTRL_Handle *mtrCtrl)
 {
     /* Verify Parameters */
     MCS_ASSERT_PARAM(mtrCtrl != NULL);
+#ifdef HOST_LINK
+    HOST_LinkPoll(&g_hostLink, mtrCtrl, DCL_SYSTICK_GetTick());
+    if (g_uartFrame.txFlag == 1) {   /* DMA idle, send what has been queued since the last transfer. */
+        unsigned int txLen = 0;
+        unsigned char *txBuf = HOST_LinkTxTake(&g_hostLink, &txLen);
+        if (txBuf != NULL) {
+            g_uartFrame.txFlag = 0;
+            HAL_UART_WriteDMA(&g_uart0, txBuf, txLen);
+        }
+    }
+#else
     if (g_uartFrame.txFlag == 1) {   /* Send data flag. */
             mtrCtrl->uartTimeStamp = (float)getdeltaSystickCnt;  /* Unit data time stamp */
             g_uartFrame.upDataCnt = 0;
             g_uartFrame.txFlag = 0;
-            /* Send data to host. */
-            unsigned int txLen = CUST_TransmitData(mtrCtrl, g_uartTxBuf);
+            unsigned int txLen = 0;
+            /* A requested scope upload replaces the data frames until it is finished. */
+            if (g_uartFrame.uartItTxFlag == 1) {
+                    txLen = SCOPE_UploadFrame(&mtrCtrl->scope, g_uartTxBuf, UI_TX_BUF_LEN);
+            }
+            if (txLen == 0) {
+                    /* Send data to host. */
+                    txLen = CUST_TransmitData(mtrCtrl, g_uartTxBuf);
+            }
             /* If txIT mode send data finish, convert to DMA mode */
             if (g_uartFrame.uartItTxFlag == 1) {
                     HAL_UART_WriteDMA(&g_uart0, g_uartTxBuf, txLen);
             }
     }
+#endif
 }
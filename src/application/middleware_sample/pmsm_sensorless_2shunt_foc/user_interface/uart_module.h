@@ -27,12 +27,7 @@
 
 typedef struct {
     unsigned int buffLen;
-    unsigned int timeOutCnt;
-    unsigned char frameFlag;
-    unsigned int rxLen;
-    unsigned char rxFlag;
     unsigned char txFlag;
-    unsigned char rxData;
     unsigned int upDataCnt;
     unsigned int upDataDelayCnt;
     unsigned char uartItTxFlag;
@@ -0,0 +1,244 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      uart_rx_stream.c
+  * @author    MCU Algorithm Team
+  * @brief     UART receiver on a circular DMA ring. Frames are found and checked in place and handed out as
+  *            pointers into the ring, so the CPU does no per-byte interrupt work and no frame copy. The
+  *            variable length packets of the host link are cut at their delimiter and copied out instead.
+  */
+#include "uart_rx_stream.h"
+#include "host_frame.h"
+#include "mcs_assert.h"
+
+#define RX_STREAM_RING_MASK     (RX_STREAM_RING_LEN - 1)
+
+/* The FRAME_LENTH bytes behind the ring mirror the ring start, so that a frame crossing the ring end is
+   still contiguous. The DMA only writes the first RX_STREAM_RING_LEN bytes. */
+static unsigned char g_rxStreamRing[RX_STREAM_RING_LEN + FRAME_LENTH];
+
+/**
+  * @brief Frame checksum, same rule as the protocol layer.
+  * @param ptr Pointer to the data to be checked
+  * @param num Number of bytes
+  * @retval unsigned char Checksum
+  */
+static unsigned char RxStreamCheckSum(const unsigned char *ptr, unsigned int num)
+{
+    unsigned char sum = 0;
+    for (unsigned int i = 0; i < num; i++) {
+        sum += ptr[i];
+    }
+    return sum;
+}
+
+/**
+  * @brief Start the circular DMA reception into the ring.
+  * @param stream Receiver handle.
+  * @param uart UART handle configured with rxMode UART_MODE_DMA, an RX DMA channel and its baud rate.
+  * @param tickHz Systick frequency.
+  * @retval BASE_StatusType
+  */
+BASE_StatusType RxStream_Init(RX_Stream *stream, UART_Handle *uart, unsigned int tickHz)
+{
+    MCS_ASSERT_PARAM(stream != NULL);
+    MCS_ASSERT_PARAM(uart != NULL);
+    MCS_ASSERT_PARAM(uart->baudRate > 0);
+    unsigned long long byteTicks = (unsigned long long)tickHz * RX_STREAM_BYTE_BITS / uart->baudRate;
+    stream->uart = uart;
+    stream->rdPos = 0;
+    stream->lastWrPos = 0;
+    stream->lastTick = DCL_SYSTICK_GetTick();
+    stream->byteTicks = (byteTicks > 0) ? (unsigned int)byteTicks : 1;
+    stream->idleCnt = 0;
+    stream->pktLen = 0;
+    stream->pktDrop = false;
+    stream->stat.frameCnt = 0;
+    stream->stat.wrapCnt = 0;
+    stream->stat.skipCnt = 0;
+    stream->stat.endErrCnt = 0;
+    stream->stat.checkErrCnt = 0;
+    stream->stat.flushCnt = 0;
+    stream->stat.packetCnt = 0;
+    stream->stat.overLenCnt = 0;
+    stream->stat.lapCnt = 0;
+    return HAL_UART_ReadDMAAndCyclicallyStored(uart, g_rxStreamRing, &stream->node, RX_STREAM_RING_LEN);
+}
+
+/**
+  * @brief Read the DMA write offset and track how long the line has been idle. The cyclic DMA has no lap
+  *        count, so the bytes received since the previous poll are bounded by the time and the baud rate:
+  *        when they may have reached rdPos, the unread bytes are dropped and reading restarts at the write
+  *        offset. The receiver must be polled at least once per systick wrap.
+  * @param stream Receiver handle.
+  * @retval Ring offset of the next byte the DMA writes.
+  */
+static unsigned int RxStreamPoll(RX_Stream *stream)
+{
+    unsigned int tick = DCL_SYSTICK_GetTick();
+    unsigned int wrPos = HAL_UART_ReadDMAGetPos(stream->uart) & RX_STREAM_RING_MASK;
+    /* One more byte for the one being received when the previous poll read the offset */
+    unsigned int maxNew = (DCL_SYSTICK_GetTick() - stream->lastTick) / stream->byteTicks + 1;
+    unsigned int unread = (stream->lastWrPos - stream->rdPos) & RX_STREAM_RING_MASK;
+    stream->lastTick = tick;
+    if (maxNew >= RX_STREAM_RING_LEN - unread) {
+        if (wrPos != stream->rdPos || stream->pktLen > 0) {
+            stream->stat.lapCnt++;
+        }
+        /* The bytes at wrPos may continue a lost packet, drop them up to the next delimiter */
+        stream->pktDrop = (wrPos != stream->lastWrPos);
+        stream->rdPos = wrPos;
+        stream->pktLen = 0;
+    }
+    if (wrPos != stream->lastWrPos) {
+        stream->lastWrPos = wrPos;
+        stream->idleCnt = 0;
+    } else if (stream->idleCnt < RX_STREAM_IDLE_POLLS) {
+        stream->idleCnt++;
+    }
+    return wrPos;
+}
+
+/**
+  * @brief Check a complete candidate frame in place.
+  * @param stream Receiver handle.
+  * @param frame Candidate frame starting with FRAME_START.
+  * @retval true if the frame trailer and checksum are correct.
+  */
+static bool RxStreamCheckFrame(RX_Stream *stream, const unsigned char *frame)
+{
+    unsigned int tailLen = RX_STREAM_RING_LEN - stream->rdPos;
+    if (tailLen < FRAME_LENTH) {
+        /* Mirror the wrapped head bytes behind the ring end */
+        for (unsigned int i = 0; i < FRAME_LENTH - tailLen; i++) {
+            g_rxStreamRing[RX_STREAM_RING_LEN + i] = g_rxStreamRing[i];
+        }
+    }
+    if (frame[FRAME_LENTH - 1] != FRAME_END) {
+        stream->stat.endErrCnt++;
+        return false;
+    }
+    if (RxStreamCheckSum(&frame[FRAME_CHECK_BEGIN], FRAME_CHECK_NUM) != frame[FRAME_CHECKSUM]) {
+        stream->stat.checkErrCnt++;
+        return false;
+    }
+    stream->stat.wrapCnt += (tailLen < FRAME_LENTH) ? 1 : 0;
+    return true;
+}
+
+/**
+  * @brief Return the next complete and checked frame, without copying it out of the ring.
+  *        Bytes in front of a frame and candidate frames that fail the checks are skipped. A partial frame is
+  *        dropped once the line has been idle for RX_STREAM_IDLE_POLLS polls.
+  * @param stream Receiver handle.
+  * @retval Pointer to FRAME_LENTH bytes in the ring, valid until RxStream_ReleaseFrame(); NULL if none.
+  */
+unsigned char *RxStream_GetFrame(RX_Stream *stream)
+{
+    MCS_ASSERT_PARAM(stream != NULL);
+    unsigned int wrPos = RxStreamPoll(stream);
+    unsigned int avail = (wrPos - stream->rdPos) & RX_STREAM_RING_MASK;
+    while (avail > 0) {
+        unsigned char *frame = &g_rxStreamRing[stream->rdPos];
+        if (frame[0] != FRAME_START) {
+            stream->stat.skipCnt++;
+        } else if (avail < FRAME_LENTH) {
+            if (stream->idleCnt >= RX_STREAM_IDLE_POLLS) {
+                /* The host will not complete this frame */
+                stream->stat.flushCnt++;
+                stream->rdPos = wrPos;
+            }
+            return NULL;
+        } else if (RxStreamCheckFrame(stream, frame)) {
+            return frame;
+        }
+        /* Resynchronize on the next byte */
+        stream->rdPos = (stream->rdPos + 1) & RX_STREAM_RING_MASK;
+        avail--;
+    }
+    return NULL;
+}
+
+/**
+  * @brief Release the frame returned by RxStream_GetFrame(), its ring space can be overwritten.
+  * @param stream Receiver handle.
+  */
+void RxStream_ReleaseFrame(RX_Stream *stream)
+{
+    MCS_ASSERT_PARAM(stream != NULL);
+    stream->rdPos = (stream->rdPos + FRAME_LENTH) & RX_STREAM_RING_MASK;
+    stream->stat.frameCnt++;
+}
+
+/**
+  * @brief Copy out the next packet of the host link, the bytes in front of the next HOST_FRAME_DELIMITER.
+  *        Empty packets are skipped. A packet longer than the buffer is dropped up to its delimiter, and a
+  *        partial packet is dropped once the line has been idle for RX_STREAM_IDLE_POLLS polls. The bytes
+  *        already scanned are remembered, so every byte is looked at once.
+  * @param stream Receiver handle.
+  * @param buf Packet buffer.
+  * @param bufLen Packet buffer size, less than RX_STREAM_RING_LEN.
+  * @retval Packet length without the delimiter, 0 if no complete packet is received.
+  */
+unsigned int RxStream_GetPacket(RX_Stream *stream, unsigned char *buf, unsigned int bufLen)
+{
+    MCS_ASSERT_PARAM(stream != NULL);
+    MCS_ASSERT_PARAM(buf != NULL);
+    MCS_ASSERT_PARAM(bufLen < RX_STREAM_RING_LEN);
+    unsigned int wrPos = RxStreamPoll(stream);
+    unsigned int avail = (wrPos - stream->rdPos) & RX_STREAM_RING_MASK;
+    while (stream->pktLen < avail) {
+        unsigned int endPos = (stream->rdPos + stream->pktLen) & RX_STREAM_RING_MASK;
+        if (g_rxStreamRing[endPos] != HOST_FRAME_DELIMITER) {
+            stream->pktLen++;
+            continue;
+        }
+        unsigned int len = stream->pktLen;
+        bool drop = stream->pktDrop;
+        if (!drop && len > bufLen) {
+            stream->stat.overLenCnt++;
+            drop = true;
+        }
+        if (!drop) {
+            for (unsigned int i = 0; i < len; i++) {
+                buf[i] = g_rxStreamRing[(stream->rdPos + i) & RX_STREAM_RING_MASK];
+            }
+        }
+        stream->rdPos = (endPos + 1) & RX_STREAM_RING_MASK;
+        stream->pktLen = 0;
+        stream->pktDrop = false;
+        if (!drop && len > 0) {
+            stream->stat.packetCnt++;
+            return len;
+        }
+        avail = (wrPos - stream->rdPos) & RX_STREAM_RING_MASK;
+    }
+    if (stream->pktLen > bufLen) {
+        /* No buffer can take this packet, free its ring space now and drop the rest at the delimiter */
+        stream->stat.overLenCnt += stream->pktDrop ? 0 : 1;
+        stream->rdPos = (stream->rdPos + stream->pktLen) & RX_STREAM_RING_MASK;
+        stream->pktLen = 0;
+        stream->pktDrop = true;
+    } else if ((stream->pktLen > 0 || stream->pktDrop) && stream->idleCnt >= RX_STREAM_IDLE_POLLS) {
+        /* The host will not complete this packet */
+        stream->stat.flushCnt++;
+        stream->rdPos = wrPos;
+        stream->pktLen = 0;
+        stream->pktDrop = false;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      uart_rx_stream.h
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions declaration of the UART DMA ring receiver.
+  */
+#ifndef McsMagicTag_UART_RX_STREAM_H
+#define McsMagicTag_UART_RX_STREAM_H
+
+#include "protocol.h"
+
+/* DMA ring size in bytes, power of two. It must hold the bytes received between two polls:
+   about 185 bytes per millisecond at 1843200 baud. */
+#define RX_STREAM_RING_LEN       (512)
+/* Polls without a new byte after which the line is idle and a partial frame is dropped */
+#define RX_STREAM_IDLE_POLLS     (2)
+/* Line bits per received byte: start, 8 data and stop bits */
+#define RX_STREAM_BYTE_BITS      (10)
+
+typedef struct {
+    unsigned int frameCnt;          /* Frames handed out and released */
+    unsigned int wrapCnt;           /* Frames crossing the ring end, their head bytes were mirrored */
+    unsigned int skipCnt;           /* Bytes skipped while searching FRAME_START */
+    unsigned int endErrCnt;         /* Candidate frames without FRAME_END */
+    unsigned int checkErrCnt;       /* Candidate frames with a wrong checksum */
+    unsigned int flushCnt;          /* Partial frames dropped on an idle line */
+    unsigned int packetCnt;         /* Delimited packets handed out */
+    unsigned int overLenCnt;        /* Delimited packets longer than the caller buffer, dropped */
+    unsigned int lapCnt;            /* Polls too late to rule out the DMA lapping rdPos, unread bytes dropped */
+} RX_StreamStat;
+
+typedef struct {
+    UART_Handle *uart;
+    DMA_LinkList node;              /* Single node ring list of the RX DMA channel */
+    unsigned int rdPos;             /* Ring offset of the next unread byte */
+    unsigned int lastWrPos;         /* DMA write offset seen by the previous poll */
+    unsigned int lastTick;          /* Systick taken just before the previous poll read the DMA write offset */
+    unsigned int byteTicks;         /* Systicks per received byte, rounded down */
+    unsigned int idleCnt;           /* Polls since the DMA write offset last moved */
+    unsigned int pktLen;            /* Bytes of the current delimited packet already scanned */
+    bool pktDrop;                   /* Current delimited packet is too long, drop it up to its delimiter */
+    RX_StreamStat stat;
+} RX_Stream;
+
+BASE_StatusType RxStream_Init(RX_Stream *stream, UART_Handle *uart, unsigned int tickHz);
+unsigned char *RxStream_GetFrame(RX_Stream *stream);
+void RxStream_ReleaseFrame(RX_Stream *stream);
+unsigned int RxStream_GetPacket(RX_Stream *stream, unsigned char *buf, unsigned int bufLen);
+
+#endif
@@ -22,7 +22,7 @@
 #ifndef McuMagicTag_MCS_CARRIER_H
 #define McuMagicTag_MCS_CARRIER_H
 
-#include "mcs_status.h"
+#include "mcs_sys_status.h"
 #include "mcs_mtr_param.h"
 #include "mcs_svpwm.h"
 #include "mcs_curr_ctrl.h"
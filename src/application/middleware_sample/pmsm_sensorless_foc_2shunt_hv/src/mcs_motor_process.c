@@ -30,6 +30,7 @@
 #include "mcs_ctlmode_config.h"
 #include "mcs_math_const.h"
 #include "mcs_motor_process.h"
+#include "mcs_apt_pwm.h"
 #include "mcs_carrier.h"
 
 
@@ -37,7 +38,6 @@
 #define US_PER_MS               1000
 #define ANGLE_RANGE_ABS         65536
 #define ANGLE_360_F             65536.0f /* 0 - 65536 indicates 0 to 360. */
-#define APT_FULL_DUTY           1.0f
 #define TEMP_3                  3.0f
 #define MOTOR_START_DELAY       2
 #define ADC_READINIT_DELAY      1
@@ -210,79 +210,6 @@ static void ClearBeforeStartup(MTRCTRL_Handle *mtrCtrl)
     R1SVPWM_Clear(&mtrCtrl->r1Sv);
 }
 
-/**
-  * @brief To set the comparison value of the IGBT single-resistance ADC sampling trigger position.
-  * @param aptx The APT register struct handle.
-  * @param cntCmpA A Count compare reference of time-base counter.
-  * @param cntCmpB B Count compare reference of time-base counter.
-  * @param maxCntCmp Maximum Comparison Value
-  * @retval None.
-  */
-static void MCS_SetAdcCompareR1(APT_RegStruct *aptx, unsigned short cntCmpA,
-                                unsigned short cntCmpB, unsigned short maxCntCmp)
-{
-    unsigned short tmp;
-    /* Sets the A Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpA), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_A, tmp);
-    /* Sets the B Count compare reference of time-base counter. */
-    tmp = (unsigned short)Clamp((float)(cntCmpB), (float)(maxCntCmp - 1), 1.0f);
-    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_B, tmp);
-}
-
-/**
-  * @brief Open the three-phase lower pipe.
-  * @param aptAddr Three-phase APT address pointer.
-  * @param maxDutyCnt Max duty count.
-  * @retval None.
-  */
-static void AptTurnOnLowSidePwm(APT_RegStruct **aptAddr, unsigned short maxDutyCnt)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    MCS_ASSERT_PARAM(maxDutyCnt != 0);
-    unsigned short dutyCnt;
-    dutyCnt = (unsigned short)(maxDutyCnt * APT_FULL_DUTY);
-    /* Open the three-phase lower pipe */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_C, dutyCnt);
-        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_D, dutyCnt);
-    }
-}
-
-/**
-  * @brief Enable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputEnable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Enable three-phase pwm output */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_UNSET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_UNSET;
-    }
-}
-
-/**
-  * @brief Disable three-phase pwm output.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-static void MotorPwmOutputDisable(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /* Disable three-phase pwm output. */
-    for (unsigned int i = 0; i < PHASE_MAX_NUM; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_SET;
-        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_SET;
-        DCL_APT_ForcePWMOutputLow(aptx);
-    }
-}
-
 /**
   * @brief Smo IF angle difference calculation.
   * @param smoElecAngle Smo electrical angle.
@@ -432,9 +359,9 @@ static void CheckSysCmdStart(MTRCTRL_Handle *mtrCtrl,
         mtrCtrl->sysTickCnt = 0;
         *stateMachine = FSM_CAP_CHARGE;
         /* Preparation for charging the bootstrap capacitor. */
-        AptTurnOnLowSidePwm(aptAddr, mtrCtrl->aptMaxcntCmp);
+        MCS_AptTurnOnLowSide(aptAddr, mtrCtrl->aptMaxcntCmp);
         /* Enable pwm output */
-        MotorPwmOutputEnable(aptAddr);
+        MCS_AptPwmOutputEnable(aptAddr);
     }
 }
 
@@ -480,7 +407,7 @@ static void TSK_SystickIsr(MTRCTRL_Handle *mtrCtrl, APT_RegStruct **aptAddr)
             break;
         case FSM_STOP:
             mtrCtrl->spdRefHz = 0.0f;
-            MotorPwmOutputDisable(aptAddr);
+            MCS_AptPwmOutputDisable(aptAddr);
             SysRunningClr(statusReg);
             *stateMachine = FSM_IDLE;
             break;
@@ -591,7 +518,7 @@ static void SetPwmDutyCp(UvwAxis *dutyUvwLeft, UvwAxis *dutyUvwRight)
   */
 static void SetADCTriggerTime(unsigned short cntCmpSOCA, unsigned short cntCmpSOCB)
 {
-    MCS_SetAdcCompareR1(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
+    MCS_AptSetAdcCompare(g_apt[PHASE_U], cntCmpSOCA, cntCmpSOCB, g_mc.aptMaxcntCmp);
 }
 
 /**
@@ -631,7 +558,7 @@ void MotorSysErrCallback(void *para)
     APT_Handle *handle = (APT_Handle *)para;
     BASE_FUNC_UNUSED(handle);
     /* The IPM overcurrent triggers and disables the three-phase PWM output. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_U], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_V], APT_OC_COMBINE_EVENT_A1);
     DCL_APT_ClearOutCtrlEventFlag((APT_RegStruct *)g_apt[PHASE_W], APT_OC_COMBINE_EVENT_A1);
@@ -748,7 +675,7 @@ int MotorMainProcess(void)
 
     AptMasterSalveSet();
     /* Disable PWM output before startup. */
-    MotorPwmOutputDisable(g_apt);
+    MCS_AptPwmOutputDisable(g_apt);
     /* Software initialization. */
     InitSoftware();
     /* Start the PWM clock. */
@@ -0,0 +1,178 @@
+#!/usr/bin/env python
+# coding=utf-8
+# Purpose: decode the binary memory log with the prim database created by mk_prim_xml_step2.py
+# Copyright Huawei Technologies Co.,Ltd. 2022-2022. All rights reserved
+# Author:
+
+import argparse
+import re
+import struct
+import sys
+import xml.etree.ElementTree as ET
+
+
+LOG_BIN_MAGIC = 0xA5
+LOG_BIN_HEAD_WORDS = 2
+LEVEL_TAG = ['FATAL', 'ERROR', 'WARNING', 'INFO', 'DEBUG']
+FMT_PATTERN = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)([diuxXpcfs%])')
+
+
+class PrimDb():
+    '''
+    Function description: message lookup table built from the prim xml.
+    '''
+
+    def __init__(self, xml_path):
+        self.msgs = {}
+        root = ET.parse(xml_path).getroot()
+        for module_hdlr in root.iter('Module'):
+            for file_hdlr in module_hdlr.iter('File'):
+                for msg_hdlr in file_hdlr.iter('Msg'):
+                    self.msgs[int(msg_hdlr.get('id'), 0)] = (module_hdlr.get('name'),
+                        msg_hdlr.get('description'))
+
+
+    def lookup(self, xml_id):
+        return self.msgs.get(xml_id)
+
+
+class BinLogDecoder():
+    '''
+    Function description: split the word stream into records and format them.
+    '''
+
+    def __init__(self, prim_db):
+        self.prim_db = prim_db
+
+
+    @staticmethod
+    def format_arg(flags, conv, value):
+        if conv in 'di':
+            value = value - (1 << 32) if value & 0x80000000 else value
+            return ('%' + flags + 'd') % value
+        if conv == 'u':
+            return ('%' + flags + 'u') % value
+        if conv in 'xXp':
+            return ('%' + flags + ('X' if conv == 'X' else 'x')) % value
+        if conv == 'c':
+            return chr(value & 0xFF)
+        if conv == 'f':
+            # float arguments are logged as their raw IEEE-754 bits
+            return ('%' + (flags if flags else '.5') + 'f') % struct.unpack('<f', struct.pack('<I', value))[0]
+        return '0x%x' % value  # %s: only the pointer value is available
+
+
+    @staticmethod
+    def format_msg(fmt, args):
+        out = []
+        pos = 0
+        arg_idx = 0
+        for match in FMT_PATTERN.finditer(fmt):
+            out.append(fmt[pos:match.start()])
+            pos = match.end()
+            if match.group(2) == '%':
+                out.append('%')
+            elif arg_idx < len(args):
+                out.append(BinLogDecoder.format_arg(match.group(1), match.group(2), args[arg_idx]))
+                arg_idx += 1
+            else:
+                out.append(match.group(0))
+        out.append(fmt[pos:])
+        text = ''.join(out)
+        # arguments without a conversion in the message (ExtLogBuf) are appended
+        if arg_idx < len(args):
+            text += ' ' + ' '.join('0x%x' % arg for arg in args[arg_idx:])
+        return text.replace('\\n', '').rstrip('\n')
+
+
+    def format_record(self, head, xml_id, args):
+        level = (head >> 12) & 0xF
+        mod_id = head & 0xFFF
+        line = xml_id & 0xFFFF
+        file_id = xml_id >> 16
+        tag = LEVEL_TAG[level] if level < len(LEVEL_TAG) else str(level)
+        msg = self.prim_db.lookup(xml_id) if self.prim_db else None
+        if msg is None:
+            text = 'file %d line %d' % (file_id, line)
+            if args:
+                text += ' ' + ' '.join('0x%x' % arg for arg in args)
+            return '[%s][mod %d] %s' % (tag, mod_id, text)
+        return '[%s][%s] %s' % (tag, msg[0], BinLogDecoder.format_msg(msg[1], args))
+
+
+    def decode(self, words):
+        '''
+        The oldest record may have been partly overwritten by the ring, so the stream is
+        resynchronized on the magic byte and records running past the end are dropped.
+        '''
+        lines = []
+        idx = 0
+        skipped = 0
+        while idx + LOG_BIN_HEAD_WORDS <= len(words):
+            head = words[idx]
+            argc = (head >> 16) & 0xFF
+            if (head >> 24) != LOG_BIN_MAGIC or idx + LOG_BIN_HEAD_WORDS + argc > len(words):
+                idx += 1
+                skipped += 1
+                continue
+            args = words[idx + LOG_BIN_HEAD_WORDS:idx + LOG_BIN_HEAD_WORDS + argc]
+            lines.append(self.format_record(head, words[idx + 1], args))
+            idx += LOG_BIN_HEAD_WORDS + argc
+        return lines, skipped
+
+
+def words_from_console(text):
+    '''
+    Parse the output of "logcmd print": hex words between "binlog begin" and "binlog end".
+    '''
+    words = []
+    inside = False
+    for line in text.splitlines():
+        line = line.strip()
+        if line.startswith('binlog begin'):
+            inside = True
+            words = []
+        elif line.startswith('binlog end'):
+            inside = False
+        elif inside:
+            words.extend(int(token, 16) for token in line.split())
+    return words
+
+
+def words_from_raw(data, write_pos, log_len):
+    '''
+    Parse a memory dump of MemoryLog.mmzBuf, write_pos and log_len are read from the same structure.
+    '''
+    start = write_pos if log_len == len(data) else 0
+    ordered = data[start:] + data[:start] if start else data[:log_len]
+    count = len(ordered) // 4
+    return list(struct.unpack('<%dI' % count, ordered[:count * 4]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode binary memory log records')
+    parser.add_argument('input', help='console capture of "logcmd print", or raw mmzBuf dump with --raw')
+    parser.add_argument('--db', help='prim xml created by mk_prim_xml_step2.py')
+    parser.add_argument('--raw', action='store_true', help='input is a binary dump of mmzBuf')
+    parser.add_argument('--pos', type=lambda x: int(x, 0), default=0, help='MemoryLog.writePos of the dump')
+    parser.add_argument('--len', type=lambda x: int(x, 0), default=None, help='MemoryLog.logLen of the dump')
+    args = parser.parse_args()
+
+    prim_db = PrimDb(args.db) if args.db else None
+    if args.raw:
+        with open(args.input, 'rb') as fp:
+            data = fp.read()
+        words = words_from_raw(data, args.pos, len(data) if args.len is None else args.len)
+    else:
+        with open(args.input, encoding='utf-8', errors='replace') as fp:
+            words = words_from_console(fp.read())
+
+    lines, skipped = BinLogDecoder(prim_db).decode(words)
+    for line in lines:
+        print(line)
+    if skipped:
+        print('%d words skipped while resynchronizing' % skipped, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
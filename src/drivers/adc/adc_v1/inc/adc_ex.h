@@ -33,6 +33,47 @@
  * @{
  */
 
+/**
+ * @defgroup ADC_EX_PingPong ADC DMA ping-pong acquisition
+ * @{
+ */
+#define ADC_PINGPONG_BUF_NUM    2
+#define ADC_PPB_MAX_NUM         4
+
+/**
+  * @brief PPB offset calibration of one SOC, runs on the DMA completions without blocking.
+  */
+typedef struct {
+    unsigned int    socIdx;     /**< Index of the SOC in the ping-pong buffer */
+    unsigned int    target;     /**< Expected result after calibration, for example the mid-scale code */
+    unsigned int    sampleNum;  /**< Number of conversions to average */
+    unsigned int    sampleCnt;  /**< Conversions accumulated so far */
+    unsigned int    sum;        /**< Accumulated raw results */
+    int             offset;     /**< Offset programmed into the PPB */
+    bool            busy;       /**< Calibration in progress */
+} ADC_PPBCalib;
+
+/**
+  * @brief SOC results streamed by DMA into two buffers used alternately.
+  *        The buffer returned by HAL_ADC_GetPingPongDataEx() is not written by DMA before the next
+  *        conversion group completes.
+  */
+typedef struct {
+    ADC_Handle              *adcHandle;                                 /**< ADC that owns the SOCs */
+    unsigned int             startSoc;                                  /**< First SOC transferred */
+    unsigned int             socNum;                                    /**< Number of SOCs transferred */
+    unsigned int             buf[ADC_PINGPONG_BUF_NUM][SOC_MAX_NUM];    /**< DMA destination buffers */
+    DMA_LinkList             node[ADC_PINGPONG_BUF_NUM];                /**< DMA nodes linked in a ring */
+    volatile unsigned int    seq[ADC_PINGPONG_BUF_NUM];                 /**< Sequence number of each buffer */
+    volatile unsigned int    seqCnt;                                    /**< Conversion groups completed */
+    volatile unsigned int    fillIdx;                                   /**< Buffer being written by DMA */
+    volatile unsigned int    readyIdx;                                  /**< Buffer holding the latest group */
+    ADC_PPBCalib             calib[ADC_PPB_MAX_NUM];                    /**< PPB offset calibration */
+} ADC_PingPong;
+/**
+  * @}
+  */
+
 /**
  * @defgroup ADC_EX_API_Declaration ADC HAL API EX
  * @{
@@ -55,6 +96,12 @@ int HAL_ADC_GetPPBxErrorResultEx(ADC_Handle *adcHandle, ADC_PPBNumber ppb);
 unsigned int HAL_ADC_GetPPBxDelayCntEx(ADC_Handle *adcHandle, ADC_PPBNumber ppb);
 BASE_StatusType HAL_ADC_InitForVddaEx(ADC_RegStruct *adcx, ADC_SOCNumber soc);
 float HAL_ADC_GetVddaEx(ADC_RegStruct *adcx, ADC_SOCNumber soc);
+BASE_StatusType HAL_ADC_StartDmaPingPongEx(ADC_Handle *adcHandle, ADC_PingPong *pingPong,
+                                           unsigned int startSoc, unsigned int endSoc);
+BASE_StatusType HAL_ADC_StartPPBCalibEx(ADC_PingPong *pingPong, ADC_SOCNumber soc, ADC_PPBNumber ppb,
+                                        unsigned int target, unsigned int sampleNum);
+bool HAL_ADC_IsPPBCalibFinishEx(const ADC_PingPong *pingPong);
+const unsigned int *HAL_ADC_GetPingPongDataEx(const ADC_PingPong *pingPong, unsigned int *seq);
 /**
   * @}
   */
@@ -21,6 +21,7 @@
   * @details This file provides firmware functions to manage the following extend function.
   *           + ADC Oversampling Function Configuration and Usage Definition.
   *           + ADC PPB Function Configuration and Usage Definition.
+  *           + ADC DMA Ping-Pong Acquisition and PPB Offset Calibration.
   */
 
 /* Includes ------------------------------------------------------------------*/
@@ -336,3 +337,221 @@ float HAL_ADC_GetVddaEx(ADC_RegStruct *adcx, ADC_SOCNumber soc)
     voltage = 3.0 *3.33333f * ori / 4096.0f;
     return voltage;
 }
+
+/**
+  * @brief Accumulate one conversion group for the PPB calibrations in progress. When enough samples
+  *        are collected the offset is written to the PPB, later groups are already corrected.
+  * @param pingPong ADC ping-pong handle.
+  * @param data Conversion group just completed.
+  * @retval None.
+  */
+static void ADC_PPBCalibUpdate(ADC_PingPong *pingPong, const unsigned int *data)
+{
+    ADC_PPBCalib *calib = NULL;
+    int offset;
+    for (unsigned int ppb = 0; ppb < ADC_PPB_MAX_NUM; ppb++) {
+        calib = &pingPong->calib[ppb];
+        if (!calib->busy) {
+            continue;
+        }
+        calib->sum += data[calib->socIdx];
+        calib->sampleCnt++;
+        if (calib->sampleCnt < calib->sampleNum) {
+            continue;
+        }
+        /* Rounded average, the PPB adds the offset to the raw result */
+        offset = (int)calib->target - (int)((calib->sum + calib->sampleNum / 2) / calib->sampleNum); /* 2: round */
+        offset = (offset > 2047) ? 2047 : ((offset < -2048) ? -2048 : offset); /* Offset Range: -2048 ~ 2047 */
+        calib->offset = offset;
+        HAL_ADC_SetPPBxOffsetEx(pingPong->adcHandle, (ADC_PPBNumber)ppb, offset);
+        calib->busy = false;
+    }
+}
+
+/**
+  * @brief DMA node completion of the ping-pong acquisition, publish the buffer just filled.
+  * @param handle ADC ping-pong handle.
+  * @retval None.
+  */
+static void ADC_PingPongDmaFinish(void *handle)
+{
+    ADC_ASSERT_PARAM(handle != NULL);
+    ADC_PingPong *pingPong = (ADC_PingPong *)handle;
+    unsigned int idx = pingPong->fillIdx;
+
+    pingPong->seqCnt++;
+    pingPong->seq[idx] = pingPong->seqCnt;
+    pingPong->readyIdx = idx;
+    pingPong->fillIdx = idx ^ 1U; /* The nodes are linked in a ring, the other buffer is filled next */
+    ADC_PPBCalibUpdate(pingPong, pingPong->buf[idx]);
+    if (pingPong->adcHandle->userCallBack.DmaFinishCallBack != NULL) {
+        pingPong->adcHandle->userCallBack.DmaFinishCallBack(pingPong->adcHandle);
+    }
+}
+
+/**
+  * @brief DMA error of the ping-pong acquisition.
+  * @param handle ADC ping-pong handle.
+  * @retval None.
+  */
+static void ADC_PingPongDmaError(void *handle)
+{
+    ADC_ASSERT_PARAM(handle != NULL);
+    ADC_PingPong *pingPong = (ADC_PingPong *)handle;
+    if (pingPong->adcHandle->userCallBack.DmaErrorCallBack != NULL) {
+        pingPong->adcHandle->userCallBack.DmaErrorCallBack(pingPong->adcHandle);
+    }
+}
+
+/**
+  * @brief Start streaming the results of SOC startSoc ~ endSoc into the ping-pong buffers by DMA.
+  *        Every conversion group fills one buffer and raises the ADC_CALLBACK_DMA callback, the results
+  *        are never read from the ADC registers by the CPU.
+  * Note:
+  * (1) The DMA channel must be initialized with word width and increasing source/destination addresses.
+  * (2) The last SOC of the group must use ADC_SOCFINISH_DMA.
+  * (3) pingPong must stay valid while the acquisition runs, the DMA nodes live inside it.
+  * @param adcHandle ADC handle.
+  * @param pingPong ADC ping-pong handle.
+  * @param startSoc First SOC of the group.
+  * @param endSoc Last SOC of the group.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_ADC_StartDmaPingPongEx(ADC_Handle *adcHandle, ADC_PingPong *pingPong,
+                                           unsigned int startSoc, unsigned int endSoc)
+{
+    ADC_ASSERT_PARAM(adcHandle != NULL);
+    ADC_ASSERT_PARAM(pingPong != NULL);
+    ADC_ASSERT_PARAM(IsADCInstance(adcHandle->baseAddress));
+    ADC_PARAM_CHECK_WITH_RET(IsADCSOCx(startSoc) == true, BASE_STATUS_ERROR);
+    ADC_PARAM_CHECK_WITH_RET(IsADCSOCx(endSoc) == true, BASE_STATUS_ERROR);
+    ADC_PARAM_CHECK_WITH_RET(startSoc <= endSoc, BASE_STATUS_ERROR);
+    ADC_ASSERT_PARAM(adcHandle->dmaHandle != NULL);
+    ADC_PARAM_CHECK_WITH_RET(IsDmaChannelNum(adcHandle->adcDmaChn) == true, BASE_STATUS_ERROR);
+    DMA_Handle *dmaHandle = adcHandle->dmaHandle;
+    unsigned int channel = adcHandle->adcDmaChn;
+    unsigned int dmaSOCx = 0;
+    DMA_ChannelParam dmaParams;
+
+    pingPong->adcHandle = adcHandle;
+    pingPong->startSoc = startSoc;
+    pingPong->socNum = endSoc - startSoc + 1;
+    pingPong->seqCnt = 0;
+    pingPong->fillIdx = 0;
+    pingPong->readyIdx = 0;
+    for (unsigned int i = 0; i < ADC_PINGPONG_BUF_NUM; i++) {
+        pingPong->seq[i] = 0;
+    }
+    for (unsigned int i = 0; i < ADC_PPB_MAX_NUM; i++) {
+        pingPong->calib[i].busy = false;
+    }
+    for (int i = 0; i < SOC_MAX_NUM; i++) { /* The DMA request is generated by the last SOC */
+        if (adcHandle->ADC_SOCxParam[i].finishMode == ADC_SOCFINISH_DMA) {
+            dmaSOCx = i;
+        }
+    }
+    dmaParams.direction   = dmaHandle->DMA_Channels[channel].direction;
+    dmaParams.srcAddrInc  = dmaHandle->DMA_Channels[channel].srcAddrInc;
+    dmaParams.destAddrInc = dmaHandle->DMA_Channels[channel].destAddrInc;
+    dmaParams.srcPeriph   = dmaHandle->DMA_Channels[channel].srcPeriph;
+    dmaParams.destPeriph  = dmaHandle->DMA_Channels[channel].destPeriph;
+    dmaParams.srcWidth    = dmaHandle->DMA_Channels[channel].srcWidth;
+    dmaParams.destWidth   = dmaHandle->DMA_Channels[channel].destWidth;
+    dmaParams.srcBurst    = dmaHandle->DMA_Channels[channel].srcBurst;
+    dmaParams.destBurst   = dmaHandle->DMA_Channels[channel].destBurst;
+    dmaParams.pHandle     = pingPong;
+    uintptr_t srcAddr = (uintptr_t)(void *)(adcHandle->baseAddress);
+    srcAddr = srcAddr + 4 * startSoc;   /* The base address difference of adjacent SOC result registers is 4 */
+    for (unsigned int i = 0; i < ADC_PINGPONG_BUF_NUM; i++) {
+        if (HAL_DMA_InitNewNode(&pingPong->node[i], &dmaParams, srcAddr, (uintptr_t)(void *)pingPong->buf[i],
+                                pingPong->socNum) != BASE_STATUS_OK) {
+            return BASE_STATUS_ERROR;
+        }
+    }
+    /* Link the two nodes in a ring, both raise the transfer completion interrupt */
+    pingPong->node[0].lliNext = &pingPong->node[1];
+    pingPong->node[1].lliNext = &pingPong->node[0];
+    pingPong->node[0].control.BIT.int_tc_enable = BASE_CFG_ENABLE;
+    pingPong->node[1].control.BIT.int_tc_enable = BASE_CFG_ENABLE;
+
+    DCL_ADC_DMARequestSource(adcHandle->baseAddress, dmaSOCx); /* Enable the DMA function of the ADC */
+    DCL_ADC_EnableDMABurstReq(adcHandle->baseAddress);         /* Enable the DMA burst request */
+    DCL_ADC_EnableDMASingleReq(adcHandle->baseAddress);        /* Enable the DMA single request */
+    dmaHandle->DMA_Channels[channel].pHandle = pingPong;
+    dmaHandle->userCallBack.DMA_CallbackFuns[channel].ChannelFinishCallBack = ADC_PingPongDmaFinish;
+    dmaHandle->userCallBack.DMA_CallbackFuns[channel].ChannelErrorCallBack = ADC_PingPongDmaError;
+    return HAL_DMA_StartListTransfer(dmaHandle, &pingPong->node[0], channel);
+}
+
+/**
+  * @brief Start the offset calibration of one SOC on a PPB. The calibration accumulates the next
+  *        sampleNum conversion groups in the DMA completion and then programs the PPB offset, so the
+  *        caller only polls HAL_ADC_IsPPBCalibFinishEx() instead of busy-waiting for each sample.
+  *        The input must be at its zero point (for example PWM outputs off) while calibrating.
+  * @param pingPong ADC ping-pong handle, the acquisition must be started.
+  * @param soc SOC to be calibrated, within the ping-pong group.
+  * @param ppb PPB used to remove the offset.
+  * @param target Result expected at the zero point after calibration.
+  * @param sampleNum Number of conversions to average.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_ADC_StartPPBCalibEx(ADC_PingPong *pingPong, ADC_SOCNumber soc, ADC_PPBNumber ppb,
+                                        unsigned int target, unsigned int sampleNum)
+{
+    ADC_ASSERT_PARAM(pingPong != NULL);
+    ADC_ASSERT_PARAM(pingPong->adcHandle != NULL);
+    ADC_PARAM_CHECK_WITH_RET(IsADCPostProcessingBlock(ppb), BASE_STATUS_ERROR);
+    ADC_PARAM_CHECK_WITH_RET(soc >= pingPong->startSoc, BASE_STATUS_ERROR);
+    ADC_PARAM_CHECK_WITH_RET(soc < pingPong->startSoc + pingPong->socNum, BASE_STATUS_ERROR);
+    ADC_PARAM_CHECK_WITH_RET(target <= 0xFFF, BASE_STATUS_ERROR);
+    ADC_PARAM_CHECK_WITH_RET(sampleNum > 0 && sampleNum <= 0x100000, BASE_STATUS_ERROR); /* no sum overflow */
+    ADC_PPBCalib *calib = &pingPong->calib[ppb];
+    PPB_Function fun = {0};
+
+    calib->busy = false;
+    fun.offset = BASE_CFG_ENABLE;
+    HAL_ADC_ConfigurePPBxEx(pingPong->adcHandle, soc, ppb, &fun);
+    HAL_ADC_SetPPBxOffsetEx(pingPong->adcHandle, ppb, 0); /* Accumulate raw results */
+    calib->socIdx = soc - pingPong->startSoc;
+    calib->target = target;
+    calib->sampleNum = sampleNum;
+    calib->sampleCnt = 0;
+    calib->sum = 0;
+    calib->offset = 0;
+    calib->busy = true;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Check whether all PPB offset calibrations have finished.
+  * @param pingPong ADC ping-pong handle.
+  * @retval true: finished, false: in progress.
+  */
+bool HAL_ADC_IsPPBCalibFinishEx(const ADC_PingPong *pingPong)
+{
+    ADC_ASSERT_PARAM(pingPong != NULL);
+    for (unsigned int i = 0; i < ADC_PPB_MAX_NUM; i++) {
+        if (pingPong->calib[i].busy) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+  * @brief Get the latest complete conversion group, no copy and no ADC register access.
+  * @param pingPong ADC ping-pong handle.
+  * @param seq Sequence number of the group, may be NULL. Comparing it with the previous call tells
+  *            whether new data arrived or groups were missed.
+  * @retval Results of SOC startSoc ~ endSoc, offset-corrected by the PPBs, NULL before the first group.
+  */
+const unsigned int *HAL_ADC_GetPingPongDataEx(const ADC_PingPong *pingPong, unsigned int *seq)
+{
+    ADC_ASSERT_PARAM(pingPong != NULL);
+    unsigned int idx = pingPong->readyIdx;
+    unsigned int curSeq = pingPong->seq[idx];
+    if (seq != NULL) {
+        *seq = curSeq;
+    }
+    return (curSeq == 0) ? NULL : pingPong->buf[idx];
+}
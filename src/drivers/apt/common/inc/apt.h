@@ -292,6 +292,33 @@ typedef struct _APT_Handle {
     APT_UserCallBack        userCallBack;     /**< Interrupt callback function when APT event happens. */
     APT_ExtendHandle            handleEx;         /**< extra handle */
 } APT_Handle;
+
+#define APT_GROUP_PHASE_NUM     3   /**< Number of APT modules driving a three-phase bridge */
+
+/**
+  * @brief Three-phase APT group updated as a whole through the global buffer load.
+  *        The first APT of the group also generates the ADC triggers (SOCA/SOCB).
+  */
+typedef struct {
+    APT_Handle     *aptHandle[APT_GROUP_PHASE_NUM];     /**< APT of phase U, V and W. */
+    unsigned short  glbLoadEvt;                         /**< Global load event, APT_GLB_LOAD_ON_CNTR_XXX. */
+    unsigned int    refCHigh[APT_GROUP_PHASE_NUM];      /**< Cached upper bits of TC_REFC, written back as is. */
+    unsigned int    refDHigh[APT_GROUP_PHASE_NUM];      /**< Cached upper bits of TC_REFD, written back as is. */
+    unsigned int    refAHigh;                           /**< Cached upper bits of TC_REFA. */
+    unsigned int    refBHigh;                           /**< Cached upper bits of TC_REFB. */
+    unsigned int    glbLoadVal[APT_GROUP_PHASE_NUM];    /**< GLB_LOAD value with the one-shot latch set. */
+    unsigned int    regWriteCnt;                        /**< Register writes done by the last update. */
+} APT_Group;
+
+/**
+  * @brief Count compare values of one three-phase update.
+  */
+typedef struct {
+    unsigned short  cntCmpLeftEdge[APT_GROUP_PHASE_NUM];    /**< Left edge compare of phase U, V and W. */
+    unsigned short  cntCmpRightEdge[APT_GROUP_PHASE_NUM];   /**< Right edge compare of phase U, V and W. */
+    unsigned short  cntCmpSOCA;                             /**< Compare triggering SOCA. */
+    unsigned short  cntCmpSOCB;                             /**< Compare triggering SOCB. */
+} APT_GroupCompare;
 /**
   * @}
   */
@@ -324,6 +351,8 @@ BASE_StatusType HAL_APT_SetPWMDuty(APT_Handle *aptHandle, unsigned short cntCmpL
                                    unsigned short cntCmpRightEdge);
 BASE_StatusType HAL_APT_SetPWMDutyByNumber(APT_Handle *aptHandle, unsigned int duty);
 BASE_StatusType HAL_APT_SetADCTriggerTime(APT_Handle *aptHandle, unsigned short cntCmpSOCA, unsigned short cntCmpSOCB);
+BASE_StatusType HAL_APT_GroupInit(APT_Group *group);
+BASE_StatusType HAL_APT_GroupUpdate(APT_Group *group, const APT_GroupCompare *cmp);
 void HAL_APT_EventIrqHandler(void *handle);
 void HAL_APT_TimerIrqHandler(void *handle);
 void HAL_APT_RegisterCallBack(APT_Handle *aptHandle, APT_InterruputType typeID, APT_CallbackType pCallback);
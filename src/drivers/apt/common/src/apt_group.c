@@ -0,0 +1,116 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file    apt_group.c
+  * @author  MCU Driver Team
+  * @brief   APT module driver.
+  * @details This file provides firmware functions shared by the APT versions to manage the following
+  *          functionalities of APT module.
+  *          + Three-phase group compare update with one-shot global buffer load
+  */
+
+#include "apt.h"
+
+/**
+  * @brief Switch the compare references of a three-phase group to one-shot global buffer load.
+  *        Compare values written afterwards stay in the buffers until HAL_APT_GroupUpdate() arms the
+  *        one-shot latch, they are then loaded together on the next global load event.
+  * Note: The APT modules of the group must be initialized and synchronized, so that their global load
+  *       events happen at the same time.
+  * @param group APT group, aptHandle and glbLoadEvt are set by the user.
+  * @retval BASE_StatusType: OK, ERROR.
+  */
+BASE_StatusType HAL_APT_GroupInit(APT_Group *group)
+{
+    APT_ASSERT_PARAM(group != NULL);
+    APT_PARAM_CHECK_WITH_RET(group->glbLoadEvt > 0, BASE_STATUS_ERROR);
+    APT_PARAM_CHECK_WITH_RET(group->glbLoadEvt <= (APT_GLB_LOAD_ON_CNTR_ZERO | APT_GLB_LOAD_ON_CNTR_PERIOD | \
+                             APT_GLB_LOAD_ON_CNTR_SYNC), BASE_STATUS_ERROR);
+    unsigned int cmpMask = 0xFFFF; /* Counter compare value: bit 0 ~ 15 */
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        APT_ASSERT_PARAM(group->aptHandle[i] != NULL);
+        APT_RegStruct *aptx = group->aptHandle[i]->baseAddress;
+        APT_ASSERT_PARAM(IsAPTInstance(aptx));
+        DCL_APT_SetCompareLoadMode(aptx, APT_COMPARE_REFERENCE_C, APT_BUFFER_GLOBAL_LOAD);
+        DCL_APT_SetCompareLoadMode(aptx, APT_COMPARE_REFERENCE_D, APT_BUFFER_GLOBAL_LOAD);
+        group->aptHandle[i]->waveform.cntCmpLoadMode = APT_BUFFER_GLOBAL_LOAD;
+        DCL_APT_SetGlobalLoadMode(aptx, APT_GLB_LOAD_ONE_SHOT_MODE);
+        DCL_APT_SetGlobalLoadEvent(aptx, group->glbLoadEvt);
+        group->refCHigh[i] = aptx->TC_REFC.reg & (~cmpMask);
+        group->refDHigh[i] = aptx->TC_REFD.reg & (~cmpMask);
+        GLB_LOAD_REG glbLoad;
+        glbLoad.reg = aptx->GLB_LOAD.reg;
+        glbLoad.BIT.rg_latset_otgld = BASE_CFG_SET; /* Written on every update to arm the one-shot load */
+        group->glbLoadVal[i] = glbLoad.reg;
+    }
+    APT_RegStruct *trgApt = group->aptHandle[0]->baseAddress;
+    DCL_APT_SetCompareLoadMode(trgApt, APT_COMPARE_REFERENCE_A, APT_BUFFER_GLOBAL_LOAD);
+    DCL_APT_SetCompareLoadMode(trgApt, APT_COMPARE_REFERENCE_B, APT_BUFFER_GLOBAL_LOAD);
+    group->aptHandle[0]->adcTrg.cntCmpLoadMode = APT_BUFFER_GLOBAL_LOAD;
+    group->refAHigh = trgApt->TC_REFA.reg & (~cmpMask);
+    group->refBHigh = trgApt->TC_REFB.reg & (~cmpMask);
+    group->regWriteCnt = 0;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Update the PWM compare values of the three phases and the ADC triggers in one call.
+  *        Every compare register is written once without read-back, then each APT receives a single
+  *        one-shot latch strobe. The new values take effect together on the next global load event,
+  *        so no PWM period mixes old and new compare values.
+  * Note: Call it well before the next global load event (for example at the start of the carrier
+  *       interrupt), the three latch strobes must all land in the same PWM period.
+  * @param group APT group initialized by HAL_APT_GroupInit().
+  * @param cmp Compare values, each one within 1 ~ (timerPeriod - 1).
+  * @retval BASE_StatusType: OK, ERROR.
+  */
+BASE_StatusType HAL_APT_GroupUpdate(APT_Group *group, const APT_GroupCompare *cmp)
+{
+    APT_ASSERT_PARAM(group != NULL);
+    APT_ASSERT_PARAM(cmp != NULL);
+    unsigned int writeCnt = 0;
+    APT_RegStruct *aptx = NULL;
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        APT_PARAM_CHECK_WITH_RET(cmp->cntCmpLeftEdge[i] > 0, BASE_STATUS_ERROR);
+        APT_PARAM_CHECK_WITH_RET(cmp->cntCmpLeftEdge[i] < group->aptHandle[i]->waveform.timerPeriod, BASE_STATUS_ERROR);
+        APT_PARAM_CHECK_WITH_RET(cmp->cntCmpRightEdge[i] > 0, BASE_STATUS_ERROR);
+        APT_PARAM_CHECK_WITH_RET(cmp->cntCmpRightEdge[i] < group->aptHandle[i]->waveform.timerPeriod, \
+                                 BASE_STATUS_ERROR);
+    }
+    APT_PARAM_CHECK_WITH_RET(cmp->cntCmpSOCA > 0, BASE_STATUS_ERROR);
+    APT_PARAM_CHECK_WITH_RET(cmp->cntCmpSOCA < group->aptHandle[0]->waveform.timerPeriod, BASE_STATUS_ERROR);
+    APT_PARAM_CHECK_WITH_RET(cmp->cntCmpSOCB > 0, BASE_STATUS_ERROR);
+    APT_PARAM_CHECK_WITH_RET(cmp->cntCmpSOCB < group->aptHandle[0]->waveform.timerPeriod, BASE_STATUS_ERROR);
+    /* Fill the buffers, nothing is loaded before the latch strobes */
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        aptx = group->aptHandle[i]->baseAddress;
+        aptx->TC_REFC.reg = group->refCHigh[i] | cmp->cntCmpLeftEdge[i];
+        aptx->TC_REFD.reg = group->refDHigh[i] | cmp->cntCmpRightEdge[i];
+        writeCnt += 2; /* 2: TC_REFC and TC_REFD */
+    }
+    aptx = group->aptHandle[0]->baseAddress;
+    aptx->TC_REFA.reg = group->refAHigh | cmp->cntCmpSOCA;
+    aptx->TC_REFB.reg = group->refBHigh | cmp->cntCmpSOCB;
+    writeCnt += 2; /* 2: TC_REFA and TC_REFB */
+    /* Arm the one-shot global load of each APT */
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        group->aptHandle[i]->baseAddress->GLB_LOAD.reg = group->glbLoadVal[i];
+        writeCnt++;
+    }
+    group->regWriteCnt = writeCnt;
+    return BASE_STATUS_OK;
+}
@@ -0,0 +1,91 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * @file      drvcommon.h
+  * @author    MCU Driver Team
+  * @brief     BASE module driver
+  * @details   Inline helpers shared by the drivers: the machine interrupt lock around state shared with an
+  *            interrupt handler, and the SysTick ticks elapsed since an earlier reading.
+  */
+
+/* Define to prevent recursive inclusion ------------------------------------- */
+#ifndef McuMagicTag_DRVCOMMON_H
+#define McuMagicTag_DRVCOMMON_H
+
+/* Includes ------------------------------------------------------------------ */
+#include "interrupt.h"
+#include "systick.h"
+
+/* Modulo subtraction in BASE_FUNC_TicksSince() relies on a full 32-bit up counter */
+#if SYSTICK_MAX_VALUE != 0xFFFFFFFFUL
+#error "BASE_FUNC_TicksSince() requires a 32-bit SysTick"
+#endif
+
+/**
+  * @defgroup BASE BASE
+  * @brief BASE module.
+  * @{
+  */
+
+/**
+  * @defgroup DRV_COMMON Driver Common Helpers
+  * @brief Definition of the helpers shared by the drivers.
+  * @{
+  */
+
+/**
+  * @brief Mask the machine interrupt, the core has no atomic instructions, so short critical sections
+  *        shared by the caller and an interrupt handler are protected this way.
+  * @param None.
+  * @retval unsigned int Previous mstatus, to be passed to BASE_FUNC_IntUnlock().
+  */
+static inline unsigned int BASE_FUNC_IntLock(void)
+{
+    unsigned int key = READ_CSR(mstatus);
+    CLEAR_CSR(mstatus, MSTATUS_MIE);
+    return key;
+}
+
+/**
+  * @brief Restore the machine interrupt enable saved by BASE_FUNC_IntLock().
+  * @param key Previous mstatus.
+  * @retval None.
+  */
+static inline void BASE_FUNC_IntUnlock(unsigned int key)
+{
+    if ((key & MSTATUS_MIE) != 0) {
+        SET_CSR(mstatus, MSTATUS_MIE);
+    }
+}
+
+/**
+  * @brief SysTick ticks elapsed since an earlier DCL_SYSTICK_GetTick() reading, one wrap of the counter included.
+  * @param preTick Earlier SysTick value.
+  * @retval unsigned int Elapsed ticks.
+  */
+static inline unsigned int BASE_FUNC_TicksSince(unsigned int preTick)
+{
+    return DCL_SYSTICK_GetTick() - preTick;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+#endif /* McuMagicTag_DRVCOMMON_H */
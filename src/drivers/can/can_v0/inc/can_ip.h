@@ -36,6 +36,11 @@
 #define MESSAGE_NUMBER_MIN 1
 #define MESSAGE_NUMBER_MAX 32
 
+#define CAN_TX_OBJ_NUM 8     /* Packet objects 25 ~ 32 are used for send */
+#ifndef CAN_TX_QUEUE_LEN
+#define CAN_TX_QUEUE_LEN 16  /* Frames queued or loaded in send packet objects, at most 255 */
+#endif
+
 #ifdef CAN_PARAM_CHECK
 #define CAN_ASSERT_PARAM BASE_FUNC_ASSERT_PARAM
 #define CAN_PARAM_CHECK_NO_RET BASE_FUNC_PARAMCHECK_NO_RET
@@ -65,12 +70,6 @@
   * @{
   */
 
-/**
- * @brief Extent handle definition of CAN
- */
-typedef struct {
-} CAN_ExtendHandle;
-
 /**
   * @brief Type ID of the callback function registered by the user.
   */
@@ -280,6 +279,46 @@ typedef struct {
     unsigned int filterMask;
 } CAN_FilterConfigure;
 
+/**
+  * @brief Frame waiting in the send queue.
+  */
+typedef struct {
+    CANFrame        frame;          /**< Frame to be sent */
+    unsigned int    rank;           /**< Bus arbitration rank, lower is sent first */
+    unsigned int    arbitration;    /**< IF1_ARBITRATION2 << 16 | IF1_ARBITRATION1 of the frame */
+    unsigned int    queueTick;      /**< Systick when HAL_CAN_Write() accepted the frame */
+    unsigned char   next;           /**< Next node index, CAN_TX_QUEUE_LEN ends the list */
+} CAN_TxNode;
+
+/**
+  * @brief Send statistics, latencies are in systick counts from HAL_CAN_Write() to the write finish interrupt.
+  */
+typedef struct {
+    unsigned int        queueCnt;       /**< Frames accepted by HAL_CAN_Write() */
+    unsigned int        sendCnt;        /**< Frames sent on the bus */
+    unsigned int        fullCnt;        /**< Frames rejected because the send queue was full */
+    unsigned int        cacheHitCnt;    /**< Frames loaded into a packet object already configured for their ID */
+    unsigned int        maxQueueDepth;  /**< Deepest send queue, not counting the frames in packet objects */
+    unsigned int        lastLatency;    /**< Latency of the last sent frame */
+    unsigned int        maxLatency;     /**< Largest latency */
+    unsigned long long  sumLatency;     /**< Sum of the latencies, divided by sendCnt gives the mean */
+} CAN_TxStat;
+
+/**
+ * @brief Extent handle definition of CAN
+ */
+typedef struct {
+    unsigned int    txFreeMap;                          /**< Bit n set: send packet object 25 + n is free */
+    unsigned int    txObjArb[CAN_TX_OBJ_NUM];           /**< Arbitration configured in each send packet object */
+    unsigned char   txObjNode[CAN_TX_OBJ_NUM];          /**< Node loaded in each send packet object */
+    CAN_TxNode      txNode[CAN_TX_QUEUE_LEN];           /**< Storage of the queued and loaded frames */
+    unsigned char   txHead;                             /**< Send queue ordered by rank, FIFO for equal ranks */
+    unsigned char   txFree;                             /**< Free nodes */
+    unsigned int    txDepth;                            /**< Frames in the send queue */
+    CANFrame        txDoneFrame;                        /**< Frame just sent, valid in WriteFinishCallBack */
+    CAN_TxStat      txStat;                             /**< Send statistics */
+} CAN_ExtendHandle;
+
 /**
   * @brief Bit timing parameters.
   */
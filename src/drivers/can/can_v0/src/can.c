@@ -29,6 +29,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "can.h"
 #include "interrupt.h"
+#include "drvcommon.h"
 
 /* Macro definitions ---------------------------------------------------------*/
 
@@ -45,19 +46,22 @@
 #define CAN_ERR_MASK 0x1FFFFFFF /* Omit EFF, RTR, ERR flags */
 #define CAN_TIME_WAIT 11        /* CAN initialization wait time */
 
+#define CAN_TX_NODE_END CAN_TX_QUEUE_LEN  /* End of the send queue and of the free node list */
+#define CAN_TX_CMD_FULL 0xF3              /* Write mask, arbitration, control and data into the packet object */
+#define CAN_TX_CMD_DATA 0x93              /* Write control and data only, the arbitration is kept */
+
 static unsigned int g_stdRecvMap = 0x00000FFF;
 static unsigned int g_extRecvMap = 0x00FFF000;
 static unsigned int g_allSendMap = 0xFF000000;
 static unsigned int g_allRecvMap = 0x00FFFFFF;
 
-static unsigned int g_msgObj[CAN_OBJ_MAXNUM] = {0};
-
 static BASE_StatusType CAN_ReadCallback(CAN_Handle *canHandle, unsigned int objId);
 static BASE_StatusType CAN_ConfigReadReq(CAN_Handle *canHandle, unsigned int objId);
 static BASE_StatusType WriteFinishClear(CAN_Handle *canHandle, unsigned int objId);
 static void CAN_ReceiveFilter(CAN_Handle *canHandle, const CAN_FilterConfigure *filterConfigure, unsigned int objId);
 static void CAN_WaitTime(CAN_Handle *canHandle);
 static void CAN_AutoRetrans(CAN_Handle *canHandle);
+static void CAN_TxQueueInit(CAN_ExtendHandle *handleEx);
 
 /* Initialization and de-initialization functions ----------------------------*/
 /**
@@ -142,8 +146,9 @@ BASE_StatusType HAL_CAN_Init(CAN_Handle *canHandle)
         if (i <= BOUND_ID) {
             CAN_ConfigReadReq(canHandle, i);  /* The default configuration is no filter receive */
         }
-        g_msgObj[i - 1] = 0;
     }
+    /* All send packet objects are cleared above, drop the queue and the cached arbitrations */
+    CAN_TxQueueInit(&canHandle->handleEx);
     CAN_WaitTime(canHandle);
     canHandle->state = CAN_STATE_READY;
     return BASE_STATUS_OK;
@@ -274,7 +279,7 @@ CAN_MessageSendStatus HAL_CAN_MessageSendStatus(CAN_Handle *canHandle)
   * @param data Pointer address of the CAN data frame to be sent, @ref CANFrame
   * @retval None.
   */
-static void WriteData(CAN_Handle *canHandle, CANFrame *data)
+static void WriteData(CAN_Handle *canHandle, const CANFrame *data)
 {
     IF1_DATAA1_REG dataA1;
     dataA1.BIT.DATA0 = data->frame[0];  /* Data of bit 0 */
@@ -295,78 +300,263 @@ static void WriteData(CAN_Handle *canHandle, CANFrame *data)
 }
 
 /**
-  * @brief Send data immediately.
-  * @param canHandle CAN handle.
-  * @param data Pointer address of the CAN data frame to be sent, @ref CANFrame
-  * @retval BASE status type: OK, ERROR, BUSY, TIMEOUT
-  * @note:
-  *      IF1 and IF2 have the same functions. To facilitate management,
-  *      IF1 is used for sending and IF2 is used for receiving.
+  * @brief Empty the send queue, link all nodes into the free list and mark all send packet objects free and
+  *        unconfigured. The statistics are kept.
+  * @param handleEx CAN extend handle.
+  * @retval None.
   */
-BASE_StatusType HAL_CAN_Write(CAN_Handle *canHandle, CANFrame *data)
+static void CAN_TxQueueInit(CAN_ExtendHandle *handleEx)
 {
-    CAN_ASSERT_PARAM(canHandle != NULL && data != NULL);
-    CAN_ASSERT_PARAM(IsCANInstance(canHandle->baseAddress));
-    CAN_PARAM_CHECK_WITH_RET(data->dataLength <= 8, BASE_STATUS_ERROR);  /* CAN frame length: 1 ~ 8 */
-    if (canHandle->state != CAN_STATE_READY) {
-        return BASE_STATUS_BUSY;
-    }
-    canHandle->state = CAN_STATE_BUSY_TX;
-    unsigned int objId = 0;
-    unsigned int id;
-    for (int i = BOUND_ID + 1; i <= CAN_OBJ_MAXNUM; i++) {
-        if (g_msgObj[i - 1] == 0) {
-            g_msgObj[i - 1] = 1;
-            objId = i;
-            break;
-        }
+    unsigned int key = BASE_FUNC_IntLock();
+    for (unsigned int i = 0; i < CAN_TX_QUEUE_LEN; i++) {
+        handleEx->txNode[i].next = (unsigned char)(i + 1);
     }
-    if (objId == 0) {
-        return BASE_STATUS_ERROR;
+    handleEx->txFree = 0;
+    handleEx->txHead = CAN_TX_NODE_END;
+    handleEx->txDepth = 0;
+    for (unsigned int i = 0; i < CAN_TX_OBJ_NUM; i++) {
+        handleEx->txObjArb[i] = 0;
+        handleEx->txObjNode[i] = CAN_TX_NODE_END;
     }
-    /* Step1: write id into register arbitration according frame type */
+    handleEx->txFreeMap = (1U << CAN_TX_OBJ_NUM) - 1;
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+  * @brief Compute the arbitration register values and the bus priority of a frame.
+  * @param data CAN data frame, @ref CANFrame
+  * @param node Queue node, the arbitration and the rank are set.
+  * @retval BASE status type: OK, ERROR.
+  * @note  The rank follows the bits compared in bus arbitration: the 11 base ID bits, then SRR/IDE, which makes a
+  *        standard frame win over an extended frame with the same base ID, then the 18 extended ID bits, then RTR,
+  *        which makes a data frame win over a remote frame with the same ID.
+  */
+static BASE_StatusType CAN_TxArbitration(const CANFrame *data, CAN_TxNode *node)
+{
+    unsigned int id;
+    unsigned int idLow = 0;
+    unsigned int rank;
     switch (data->type) {
         case CAN_TYPEFRAME_STD_DATA:                                /* Standard data frame */
             id = (data->CANId & CAN_STD_MASK) << 2;                 /* Bit[12:2] = CANId */
             id |= 0xA000;                                           /* [15:13] = 0x05 */
-            canHandle->baseAddress->IF1_ARBITRATION1.reg = 0x00;
+            rank = (data->CANId & CAN_STD_MASK) << 20;              /* Base ID in [30:20] */
             break;
         case CAN_TYPEFRAME_EXT_DATA:                                /* Extended data frame */
             id = (data->CANId & CAN_EXT_MASK) >> 16;                /* Bit[12:0] = CANId(28bit~16bit) */
             id |= 0xE000;                                           /* [15:13] = 0x07 */
-            canHandle->baseAddress->IF1_ARBITRATION1.reg = (data->CANId & 0xFFFF);  /* write lower 16bits CANId */
+            idLow = data->CANId & 0xFFFF;                           /* lower 16bits CANId */
+            rank = ((data->CANId & CAN_EXT_MASK) >> 18) << 20;      /* Base ID in [30:20] */
+            rank |= 1U << 19;                                       /* IDE in [19] */
+            rank |= (data->CANId & 0x3FFFF) << 1;                   /* Extended ID in [18:1] */
             break;
         case CAN_TYPEFRAME_STD_REMOTE:                              /* Standard remote frame */
-            id = (data->CANId & CAN_EXT_MASK) << 2;                 /* Bit[12:2] = CANId */
+            id = (data->CANId & CAN_STD_MASK) << 2;                 /* Bit[12:2] = CANId */
             id |= 0x8000;                                           /* [15:13] = 0x04 */
-            canHandle->baseAddress->IF1_ARBITRATION1.reg = 0x00;
+            rank = ((data->CANId & CAN_STD_MASK) << 20) | 1U;       /* RTR in [0] */
             break;
         case CAN_TYPEFRAME_EXT_REMOTE:                              /* Extended remote frame */
             id = (data->CANId & CAN_EXT_MASK) >> 16;                /* Bit[12:0] = CANId(28bit~16bit) */
             id |= 0xC000;                                           /* [15:13] = 0x06 */
-            canHandle->baseAddress->IF1_ARBITRATION1.reg = (data->CANId & 0xFFFF);  /* write lower 16bits CANId */
+            idLow = data->CANId & 0xFFFF;                           /* lower 16bits CANId */
+            rank = ((data->CANId & CAN_EXT_MASK) >> 18) << 20;
+            rank |= (1U << 19) | ((data->CANId & 0x3FFFF) << 1) | 1U;
             break;
         default:
             return BASE_STATUS_ERROR;
     }
-    canHandle->baseAddress->IF1_ARBITRATION2.reg = id;
-    /* Step2: setting mask register 2 */
-    canHandle->baseAddress->IF1_MASK2.reg = 0x8000;
-    /* Step3: setting mask register 1 */
-    canHandle->baseAddress->IF1_MASK1.reg = 0x0000;
-    /* Step4: setting message control register */
-    canHandle->baseAddress->IF1_MESSAGE_CONTROL.reg |= 0x8980;
-    canHandle->baseAddress->IF1_MESSAGE_CONTROL.BIT.DLC = data->dataLength;
+    node->arbitration = (id << 16) | idLow;
+    node->rank = rank;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Choose the send packet object for a frame, called with the interrupts masked.
+  * @param handleEx CAN extend handle.
+  * @param arbitration Arbitration of the frame.
+  * @param cached Set when the object is already configured with this arbitration.
+  * @retval Object index 0 ~ CAN_TX_OBJ_NUM - 1, CAN_TX_OBJ_NUM when the frame has to wait.
+  * @note  An arbitration is configured in one object at most. While that object is still sending, the frame
+  *        waits for it, so frames with the same ID are never reordered by the packet object priority.
+  */
+static unsigned int CAN_TxSelectObj(const CAN_ExtendHandle *handleEx, unsigned int arbitration, bool *cached)
+{
+    unsigned int unused = CAN_TX_OBJ_NUM;
+    unsigned int anyFree = CAN_TX_OBJ_NUM;
+    for (unsigned int i = 0; i < CAN_TX_OBJ_NUM; i++) {
+        bool isFree = (handleEx->txFreeMap & (1U << i)) != 0;
+        if (handleEx->txObjArb[i] == arbitration) {
+            *cached = true;
+            return isFree ? i : CAN_TX_OBJ_NUM;
+        }
+        if (isFree && anyFree == CAN_TX_OBJ_NUM) {
+            anyFree = i;
+        }
+        if (isFree && unused == CAN_TX_OBJ_NUM && handleEx->txObjArb[i] == 0) {
+            unused = i;
+        }
+    }
+    *cached = false;
+    /* Prefer an object never configured, so that periodic IDs keep their own object */
+    return (unused != CAN_TX_OBJ_NUM) ? unused : anyFree;
+}
+
+/**
+  * @brief Load a frame into a send packet object and request the transmission.
+  * @param canHandle CAN handle.
+  * @param node Queue node of the frame.
+  * @param objIdx Send packet object index.
+  * @param cached The object is already configured with the arbitration of the frame.
+  * @retval None.
+  * @note  IF1 and IF2 have the same functions. To facilitate management,
+  *        IF1 is used for sending and IF2 is used for receiving.
+  */
+static void CAN_TxLoad(CAN_Handle *canHandle, const CAN_TxNode *node, unsigned int objIdx, bool cached)
+{
+    unsigned int busy;
+    do {
+        busy = canHandle->baseAddress->IF1_COMMAND_REQUEST.BIT.BUSY;
+    } while (busy == BASE_CFG_ENABLE);
+    if (!cached) {
+        /* Step1: write id into register arbitration according frame type */
+        canHandle->baseAddress->IF1_ARBITRATION1.reg = node->arbitration & 0xFFFF;
+        canHandle->baseAddress->IF1_ARBITRATION2.reg = node->arbitration >> 16;
+        /* Step2 ~ 3: setting mask register 2 and 1 */
+        canHandle->baseAddress->IF1_MASK2.reg = 0x8000;
+        canHandle->baseAddress->IF1_MASK1.reg = 0x0000;
+    }
+    /* Step4: setting message control register, NewDat, TxIE, TxRqst, EoB and DLC */
+    canHandle->baseAddress->IF1_MESSAGE_CONTROL.reg = 0x8980 | node->frame.dataLength;
     /* Step5: write data to be sent */
-    WriteData(canHandle, data);
+    WriteData(canHandle, &node->frame);
     /* Step6: send configuration to packet objects */
-    canHandle->baseAddress->IF1_COMMAND_MASK.reg = 0xF3;
+    canHandle->baseAddress->IF1_COMMAND_MASK.reg = cached ? CAN_TX_CMD_DATA : CAN_TX_CMD_FULL;
     /* Step7: write IF1 request command */
-    canHandle->baseAddress->IF1_COMMAND_REQUEST.BIT.MessageNumber = objId;
+    canHandle->baseAddress->IF1_COMMAND_REQUEST.BIT.MessageNumber = BOUND_ID + 1 + objIdx;
+}
+
+/**
+  * @brief Move queued frames into free send packet objects in rank order, called with the interrupts masked.
+  * @param canHandle CAN handle.
+  * @retval None.
+  * @note  The hardware sends the pending object with the lowest number first, so the priority order is only kept
+  *        among the frames still in the queue. Dispatch stops at a head frame that waits for its own object.
+  */
+static void CAN_TxDispatch(CAN_Handle *canHandle)
+{
+    CAN_ExtendHandle *handleEx = &canHandle->handleEx;
+    bool cached = false;
+    while (handleEx->txHead != CAN_TX_NODE_END && handleEx->txFreeMap != 0) {
+        unsigned int nodeIdx = handleEx->txHead;
+        CAN_TxNode *node = &handleEx->txNode[nodeIdx];
+        unsigned int objIdx = CAN_TxSelectObj(handleEx, node->arbitration, &cached);
+        if (objIdx == CAN_TX_OBJ_NUM) {
+            break;
+        }
+        CAN_TxLoad(canHandle, node, objIdx, cached);
+        handleEx->txStat.cacheHitCnt += cached ? 1 : 0;
+        handleEx->txFreeMap &= ~(1U << objIdx);
+        handleEx->txObjArb[objIdx] = node->arbitration;
+        handleEx->txObjNode[objIdx] = (unsigned char)nodeIdx;
+        handleEx->txHead = node->next;
+        handleEx->txDepth--;
+    }
+}
+
+/**
+  * @brief Queue a CAN data frame for sending, it is loaded into a send packet object at once when one is free.
+  * @param canHandle CAN handle.
+  * @param data Pointer address of the CAN data frame to be sent, @ref CANFrame
+  * @retval BASE status type: OK, ERROR, BUSY, TIMEOUT
+  * @note  Queued frames are sent by bus priority, lowest ID first, frames with the same ID in call order. A frame
+  *        whose ID is still configured in a send packet object only rewrites the control and data registers.
+  *        BASE_STATUS_BUSY is returned when CAN_TX_QUEUE_LEN frames are already queued or sending.
+  */
+BASE_StatusType HAL_CAN_Write(CAN_Handle *canHandle, CANFrame *data)
+{
+    CAN_ASSERT_PARAM(canHandle != NULL && data != NULL);
+    CAN_ASSERT_PARAM(IsCANInstance(canHandle->baseAddress));
+    CAN_PARAM_CHECK_WITH_RET(data->dataLength <= 8, BASE_STATUS_ERROR);  /* CAN frame length: 1 ~ 8 */
+    if (canHandle->state != CAN_STATE_READY) {
+        return BASE_STATUS_BUSY;
+    }
+    CAN_TxNode frameNode;
+    if (CAN_TxArbitration(data, &frameNode) != BASE_STATUS_OK) {
+        return BASE_STATUS_ERROR;
+    }
+    canHandle->state = CAN_STATE_BUSY_TX;
+    CAN_ExtendHandle *handleEx = &canHandle->handleEx;
+    unsigned int queueTick = DCL_SYSTICK_GetTick();
+    unsigned int key = BASE_FUNC_IntLock();
+    unsigned int nodeIdx = handleEx->txFree;
+    if (nodeIdx == CAN_TX_NODE_END) {
+        handleEx->txStat.fullCnt++;
+        BASE_FUNC_IntUnlock(key);
+        canHandle->state = CAN_STATE_READY;
+        return BASE_STATUS_BUSY;
+    }
+    CAN_TxNode *node = &handleEx->txNode[nodeIdx];
+    handleEx->txFree = node->next;
+    node->frame = *data;
+    node->rank = frameNode.rank;
+    node->arbitration = frameNode.arbitration;
+    node->queueTick = queueTick;
+    /* Insert behind all frames of the same or higher priority */
+    unsigned char *link = &handleEx->txHead;
+    while (*link != CAN_TX_NODE_END && handleEx->txNode[*link].rank <= node->rank) {
+        link = &handleEx->txNode[*link].next;
+    }
+    node->next = *link;
+    *link = (unsigned char)nodeIdx;
+    handleEx->txDepth++;
+    if (handleEx->txDepth > handleEx->txStat.maxQueueDepth) {
+        handleEx->txStat.maxQueueDepth = handleEx->txDepth;
+    }
+    handleEx->txStat.queueCnt++;
+    CAN_TxDispatch(canHandle);
+    BASE_FUNC_IntUnlock(key);
     canHandle->state = CAN_STATE_READY;
     return BASE_STATUS_OK;
 }
 
+/**
+  * @brief Obtains the send statistics.
+  * @param canHandle CAN handle.
+  * @param stat Statistics output, @ref CAN_TxStat
+  * @retval None.
+  */
+void HAL_CAN_GetTxStat(CAN_Handle *canHandle, CAN_TxStat *stat)
+{
+    CAN_ASSERT_PARAM(canHandle != NULL);
+    CAN_ASSERT_PARAM(IsCANInstance(canHandle->baseAddress));
+    CAN_PARAM_CHECK_NO_RET(stat != NULL);
+    unsigned int key = BASE_FUNC_IntLock();
+    *stat = canHandle->handleEx.txStat;
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+  * @brief Clear the send statistics.
+  * @param canHandle CAN handle.
+  * @retval None.
+  */
+void HAL_CAN_ClearTxStat(CAN_Handle *canHandle)
+{
+    CAN_ASSERT_PARAM(canHandle != NULL);
+    CAN_ASSERT_PARAM(IsCANInstance(canHandle->baseAddress));
+    CAN_TxStat *stat = &canHandle->handleEx.txStat;
+    unsigned int key = BASE_FUNC_IntLock();
+    stat->queueCnt = 0;
+    stat->sendCnt = 0;
+    stat->fullCnt = 0;
+    stat->cacheHitCnt = 0;
+    stat->maxQueueDepth = 0;
+    stat->lastLatency = 0;
+    stat->maxLatency = 0;
+    stat->sumLatency = 0;
+    BASE_FUNC_IntUnlock(key);
+}
+
 /**
   * @brief Interrupt receiving callback function.
   * @param canHandle CAN handle.
@@ -575,7 +765,30 @@ static BASE_StatusType WriteFinishClear(CAN_Handle *canHandle, unsigned int objI
 static void WriteIrqService(CAN_Handle *canHandle, unsigned int irqIndex)
 {
     WriteFinishClear(canHandle, irqIndex);
-    g_msgObj[irqIndex - 1] = 0;
+    CAN_ExtendHandle *handleEx = &canHandle->handleEx;
+    unsigned int objIdx = irqIndex - BOUND_ID - 1;
+    unsigned int key = BASE_FUNC_IntLock();
+    unsigned int nodeIdx = handleEx->txObjNode[objIdx];
+    if (nodeIdx == CAN_TX_NODE_END) {  /* No frame loaded by this driver */
+        BASE_FUNC_IntUnlock(key);
+        return;
+    }
+    CAN_TxNode *node = &handleEx->txNode[nodeIdx];
+    unsigned int latency = BASE_FUNC_TicksSince(node->queueTick);
+    handleEx->txStat.sendCnt++;
+    handleEx->txStat.lastLatency = latency;
+    handleEx->txStat.sumLatency += latency;
+    if (latency > handleEx->txStat.maxLatency) {
+        handleEx->txStat.maxLatency = latency;
+    }
+    handleEx->txDoneFrame = node->frame;
+    /* Release the node and the object, then refill the free objects from the queue */
+    node->next = handleEx->txFree;
+    handleEx->txFree = (unsigned char)nodeIdx;
+    handleEx->txObjNode[objIdx] = CAN_TX_NODE_END;
+    handleEx->txFreeMap |= 1U << objIdx;
+    CAN_TxDispatch(canHandle);
+    BASE_FUNC_IntUnlock(key);
     if (canHandle->userCallBack.WriteFinishCallBack != NULL) {
         canHandle->userCallBack.WriteFinishCallBack(canHandle);
     }
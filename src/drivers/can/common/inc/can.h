@@ -84,6 +84,8 @@ BASE_StatusType HAL_CAN_Init(CAN_Handle *canHandle);
 BASE_StatusType HAL_CAN_DeInit(CAN_Handle *canHandle);
 BASE_StatusType HAL_CAN_ReadIT(CAN_Handle *canHandle, CANFrame *data, CAN_FilterConfigure *filterConfigure);
 BASE_StatusType HAL_CAN_Write(CAN_Handle *canHandle, CANFrame *data);
+void HAL_CAN_GetTxStat(CAN_Handle *canHandle, CAN_TxStat *stat);
+void HAL_CAN_ClearTxStat(CAN_Handle *canHandle);
 
 /* CAN status */
 CAN_ErrorStatus HAL_CAN_GetErrorStatus(CAN_Handle *canHandle);
@@ -0,0 +1,98 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      crc_ex.h
+  * @author    MCU Driver Team
+  * @brief     CRC module driver
+  * @details   The header file contains the following declaration:
+  *             + CRC DMA calculation functions.
+  *             + CRC table driven software calculation functions.
+  */
+
+#ifndef McuMagicTag_CRC_EX_H
+#define McuMagicTag_CRC_EX_H
+/* Includes ------------------------------------------------------------------*/
+#include "crc.h"
+
+/* Macro definitions ---------------------------------------------------------*/
+#ifndef CRC_DMA_WORD_MIN
+#define CRC_DMA_WORD_MIN    16U    /* Shorter buffers are fed by the CPU, the DMA setup costs more */
+#endif
+
+#ifndef CRC_SOFT_SLICE_MAX
+#define CRC_SOFT_SLICE_MAX  8U     /* Largest slice number of a software table, each slice takes 1 KB */
+#endif
+
+#define CRC_SOFT_TABLE_SIZE 256U
+
+/**
+  * @addtogroup CRC_IP
+  * @{
+  */
+
+/**
+  * @defgroup CRC_EX_Soft_Definition CRC Software Definition
+  * @{
+  */
+
+/**
+  * @brief Table driven software CRC, computing the same algorithms as the calculator selected by
+  *        @ref CRC_AlgorithmMode on a byte stream in memory order.
+  * @details sliceNum 1 processes one byte per table lookup, 4 and 8 process one or two words per step with
+  *          slicing-by-4 and slicing-by-8. The tables are built by HAL_CRC_SoftInitEx(), only the first
+  *          sliceNum slices are used, so CRC_SOFT_SLICE_MAX can be lowered to save RAM.
+  */
+typedef struct {
+    CRC_AlgorithmMode   algoMode;   /**< Algorithm mode */
+    unsigned int        width;      /**< CRC width: 8, 16 or 32 */
+    unsigned int        init;       /**< Init value */
+    unsigned int        xorOut;     /**< Result xor value, 0 when the xor is disabled */
+    bool                refIn;      /**< Input bytes are reflected, the register shifts right */
+    bool                refOut;     /**< Output is reflected */
+    unsigned int        sliceNum;   /**< 1, 4 or 8 */
+    unsigned int        table[CRC_SOFT_SLICE_MAX][CRC_SOFT_TABLE_SIZE]; /**< Lookup tables */
+} CRC_SoftHandle;
+
+/**
+  * @}
+  */
+
+/**
+  * @defgroup CRC_EX_API_Declaration CRC HAL API EX
+  * @{
+  */
+/* DMA calculation, the result is given by handleEx.dmaResult in CalculateFinishCallback */
+BASE_StatusType HAL_CRC_AccumulateDMAEx(CRC_Handle *handle, const void *pData, unsigned int length);
+BASE_StatusType HAL_CRC_CalculateDMAEx(CRC_Handle *handle, const void *pData, unsigned int length);
+
+/* Software calculation */
+BASE_StatusType HAL_CRC_SoftInitEx(CRC_SoftHandle *soft, CRC_AlgorithmMode algoMode, unsigned int sliceNum);
+unsigned int HAL_CRC_SoftStartEx(const CRC_SoftHandle *soft);
+unsigned int HAL_CRC_SoftUpdateEx(const CRC_SoftHandle *soft, unsigned int state, const void *pData,
+                                  unsigned int length);
+unsigned int HAL_CRC_SoftFinishEx(const CRC_SoftHandle *soft, unsigned int state);
+unsigned int HAL_CRC_SoftCalculateEx(const CRC_SoftHandle *soft, const void *pData, unsigned int length);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* McuMagicTag_CRC_EX_H */
@@ -174,12 +174,22 @@ typedef enum {
   */
 typedef struct _CRC_ExtendeHandle {
     CRC_AlgorithmMode   algoMode;    /**< CRC calculate algorithm mode */
+    struct _DMA_Handle *dmaHandle;   /**< DMA used by HAL_CRC_AccumulateDMAEx() */
+    unsigned int        dmaChannel;  /**< Memory to memory channel, word width, fixed destination address */
+    volatile bool       dmaBusy;     /**< DMA calculation in progress */
+    BASE_StatusType     dmaStatus;   /**< Status of the last DMA calculation */
+    unsigned int        dmaResult;   /**< CRC output of the last DMA calculation */
+    unsigned int        dmaSrcAddr;  /**< Next word fed by the DMA */
+    unsigned int        dmaWordLeft; /**< Words not yet given to the DMA */
+    const void         *dmaTail;     /**< Remainder written by the CPU after the DMA */
+    unsigned int        dmaTailLen;  /**< Remainder length in elements of inputDataFormat */
 } CRC_ExtendHandle;
 
 /**
   * @brief CRC user callback.
   */
 typedef struct {
+    void (* CalculateFinishCallback)(void *handle); /**< DMA calculation finished or failed, see dmaStatus */
 } CRC_UserCallBack;
 /**
   * @}
@@ -187,6 +187,9 @@ unsigned int HAL_CRC_Calculate(CRC_Handle *handle, const void *pData, unsigned i
   * @param pData Pointer to the input data buffer.
   * @param length pData array length.
   * @retval unsigned int CRC output data.
+  * @note  The bytes up to the first word boundary and the last remainder bytes are written one by one, the
+  *        aligned middle part is packed four bytes per 32-bit write. The endian mode decides which byte of a word
+  *        the calculator takes first, so the packing follows it and the result equals the byte by byte feed.
   */
 static void CRC_Handle_8(CRC_Handle *handle, const unsigned char *pData, unsigned int length)
 {
@@ -194,7 +197,27 @@ static void CRC_Handle_8(CRC_Handle *handle, const unsigned char *pData, unsigne
     CRC_ASSERT_PARAM(pData != NULL);
     CRC_ASSERT_PARAM(IsCRCInstance(handle->baseAddress));
     volatile unsigned char *crcData8 = (unsigned char *)(void *)(&handle->baseAddress->crc_data_in);
-    for (unsigned int i = 0; i < length; i++) {
+    volatile unsigned int *crcData32 = &handle->baseAddress->crc_data_in;
+    unsigned int i = 0;
+    while ((i < length) && (((uintptr_t)(const void *)&pData[i] & REMAINDER_RANGE_THREE) != 0)) {
+        *(crcData8) = pData[i++]; /* input crc data until word aligned */
+    }
+    unsigned int wordEnd = i + ((length - i) & ~(unsigned int)REMAINDER_RANGE_THREE);
+    if (DCL_CRC_GetEndianMode(handle->baseAddress)) {
+        /* Big endian: the first byte is the most significant one */
+        for (; i < wordEnd; i += WORD_DIV_BYTE_SIZE) {
+            *(crcData32) = ((unsigned int)pData[i] << BIT_SHIFT24) | \
+                           ((unsigned int)pData[i + OFFSET_ONE_BYTE] << BIT_SHIFT16) | \
+                           ((unsigned int)pData[i + OFFSET_TWO_BYTE] << BIT_SHIFT8) | \
+                            (unsigned int)pData[i + OFFSET_THREE_BYTE];
+        }
+    } else {
+        /* Little endian: the memory word already has the first byte in the least significant position */
+        for (; i < wordEnd; i += WORD_DIV_BYTE_SIZE) {
+            *(crcData32) = *(const unsigned int *)(const void *)&pData[i];
+        }
+    }
+    for (; i < length; i++) {
         *(crcData8) = pData[i]; /* input crc data */
     }
 }
@@ -205,6 +228,7 @@ static void CRC_Handle_8(CRC_Handle *handle, const unsigned char *pData, unsigne
   * @param pData Pointer to the input data buffer.
   * @param length pData array length.
   * @retval unsigned int CRC output data.
+  * @note  Halfwords in the word aligned part are packed two per 32-bit write, in the order of the endian mode.
   */
 static void CRC_Handle_16(CRC_Handle *handle, const unsigned short *pData, unsigned int length)
 {
@@ -212,7 +236,22 @@ static void CRC_Handle_16(CRC_Handle *handle, const unsigned short *pData, unsig
     CRC_ASSERT_PARAM(pData != NULL);
     CRC_ASSERT_PARAM(IsCRCInstance(handle->baseAddress));
     volatile unsigned short *crcData16 = (unsigned short *)(void *)(&handle->baseAddress->crc_data_in);
-    for (unsigned int i = 0; i < length; i++) {
+    volatile unsigned int *crcData32 = &handle->baseAddress->crc_data_in;
+    unsigned int i = 0;
+    if ((length > 0) && (((uintptr_t)(const void *)pData & REMAINDER_RANGE_THREE) != 0)) {
+        *(crcData16) = pData[i++]; /* input crc data until word aligned */
+    }
+    unsigned int wordEnd = i + ((length - i) & ~(unsigned int)REMAINDER_RANGE_ONE);
+    if (DCL_CRC_GetEndianMode(handle->baseAddress)) {
+        for (; i < wordEnd; i += WORD_DIV_DOUBLE_SIZE) {
+            *(crcData32) = ((unsigned int)pData[i] << BIT_SHIFT16) | (unsigned int)pData[i + OFFSET_ONE_BYTE];
+        }
+    } else {
+        for (; i < wordEnd; i += WORD_DIV_DOUBLE_SIZE) {
+            *(crcData32) = *(const unsigned int *)(const void *)&pData[i];
+        }
+    }
+    if (i < length) {
         *(crcData16) = pData[i]; /* input crc data */
     }
 }
@@ -278,15 +317,15 @@ unsigned int HAL_CRC_LoadCheckInData(CRC_Handle *handle)
 }
 
 /**
-  * @brief  Register CRC interrupt callback.
+  * @brief  Register CRC interrupt callback, called when a DMA calculation finishes.
   * @param  handle Value of @ref CRC_handle.
   * @param  callBackFunc Value of @ref CRC_CallbackType.
   * @retval None
   */
 void HAL_CRC_RegisterCallback(CRC_Handle *handle, CRC_CallbackType callBackFunc)
 {
-    BASE_FUNC_UNUSED(handle);
-    BASE_FUNC_UNUSED(callBackFunc);
+    CRC_ASSERT_PARAM(handle != NULL);
+    handle->userCallBack.CalculateFinishCallback = callBackFunc;
 }
 
 /**
@@ -0,0 +1,190 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      crc_ex.c
+  * @author    MCU Driver Team
+  * @brief     CRC module driver
+  * @details   This file provides firmware functions to manage the following functionalities of the CRC.
+  *             + DMA calculation functions.
+  */
+
+/* Includes ------------------------------------------------------------------ */
+#include "dma.h"
+#include "crc_ex.h"
+
+#define CRC_WORD_BYTES      4U
+#define CRC_WORD_ALIGN_MASK 3U
+
+static void CRC_DmaFinish(void *handle);
+static void CRC_DmaError(void *handle);
+
+/**
+  * @brief Bytes of one input element.
+  * @param format Value of @ref CRC_InputDataFormat.
+  * @retval unsigned int 1, 2 or 4.
+  */
+static inline unsigned int CRC_ElementBytes(CRC_InputDataFormat format)
+{
+    if (format == CRC_MODE_BIT32) {
+        return 4; /* 4 bytes per element */
+    }
+    return (format == CRC_MODE_BIT16) ? 2 : 1; /* 2 or 1 byte per element */
+}
+
+/**
+  * @brief End the DMA calculation: write the remainder by the CPU and report the result.
+  * @param handle Value of @ref CRC_Handle.
+  * @param status Status of the calculation.
+  * @retval None.
+  */
+static void CRC_DmaComplete(CRC_Handle *handle, BASE_StatusType status)
+{
+    if (status == BASE_STATUS_OK) {
+        handle->handleEx.dmaResult = (handle->handleEx.dmaTailLen == 0) ?
+            DCL_CRC_GetOutputData(handle->baseAddress) :
+            HAL_CRC_Accumulate(handle, handle->handleEx.dmaTail, handle->handleEx.dmaTailLen);
+    }
+    handle->handleEx.dmaStatus = status;
+    handle->handleEx.dmaBusy = false;
+    if (handle->userCallBack.CalculateFinishCallback != NULL) {
+        handle->userCallBack.CalculateFinishCallback(handle);
+    }
+}
+
+/**
+  * @brief Give the next block of words to the DMA, at most TRANSIZE_MAX per transfer.
+  * @param handle Value of @ref CRC_Handle.
+  * @retval BASE_StatusType BASE Status.
+  */
+static BASE_StatusType CRC_DmaNextBlock(CRC_Handle *handle)
+{
+    CRC_ExtendHandle *handleEx = &handle->handleEx;
+    unsigned int words = (handleEx->dmaWordLeft > TRANSIZE_MAX) ? TRANSIZE_MAX : handleEx->dmaWordLeft;
+    unsigned int srcAddr = handleEx->dmaSrcAddr;
+    handleEx->dmaSrcAddr += words * CRC_WORD_BYTES;
+    handleEx->dmaWordLeft -= words;
+    return HAL_DMA_StartIT(handleEx->dmaHandle, srcAddr, (uintptr_t)(void *)&handle->baseAddress->crc_data_in,
+                           words, handleEx->dmaChannel);
+}
+
+/**
+  * @brief DMA finish callback, continues with the next block or ends the calculation.
+  * @param handle Value of @ref CRC_Handle, pHandle of the DMA channel.
+  * @retval None.
+  */
+static void CRC_DmaFinish(void *handle)
+{
+    CRC_ASSERT_PARAM(handle != NULL);
+    CRC_Handle *crcHandle = (CRC_Handle *)handle;
+    if (crcHandle->handleEx.dmaWordLeft == 0) {
+        CRC_DmaComplete(crcHandle, BASE_STATUS_OK);
+        return;
+    }
+    if (CRC_DmaNextBlock(crcHandle) != BASE_STATUS_OK) {
+        CRC_DmaComplete(crcHandle, BASE_STATUS_ERROR);
+    }
+}
+
+/**
+  * @brief DMA error callback.
+  * @param handle Value of @ref CRC_Handle, pHandle of the DMA channel.
+  * @retval None.
+  */
+static void CRC_DmaError(void *handle)
+{
+    CRC_ASSERT_PARAM(handle != NULL);
+    CRC_DmaComplete((CRC_Handle *)handle, BASE_STATUS_ERROR);
+}
+
+/**
+  * @brief Compute the CRC of a buffer with the DMA feeding the calculator, starting with the previously computed
+  *        CRC as initialization value.
+  * @param handle Value of @ref CRC_Handle.
+  * @param pData Pointer to the input data buffer, elements of handle->inputDataFormat.
+  * @param length pData array length.
+  * @retval BASE_StatusType OK, ERROR or BUSY.
+  * @note  handleEx.dmaChannel must be initialized as a memory to memory channel with word source and destination
+  *        width, source address increment, fixed destination address and pHandle pointing to this handle.
+  *        The CPU writes the elements before the first word boundary and after the last one, the DMA writes the
+  *        words in between, TRANSIZE_MAX words per transfer. The calculation ends in
+  *        CalculateFinishCallback, with the status in handleEx.dmaStatus and the CRC in handleEx.dmaResult.
+  *        Buffers shorter than CRC_DMA_WORD_MIN words, and 8 or 16-bit data in big endian mode, which the DMA
+  *        cannot pack, are computed by the CPU before returning, the callback is then called from this function.
+  */
+BASE_StatusType HAL_CRC_AccumulateDMAEx(CRC_Handle *handle, const void *pData, unsigned int length)
+{
+    CRC_ASSERT_PARAM(handle != NULL);
+    CRC_ASSERT_PARAM(IsCRCInstance(handle->baseAddress));
+    CRC_PARAM_CHECK_WITH_RET(pData != NULL, BASE_STATUS_ERROR);
+    CRC_PARAM_CHECK_WITH_RET(handle->handleEx.dmaHandle != NULL, BASE_STATUS_ERROR);
+    CRC_PARAM_CHECK_WITH_RET(IsDmaChannelNum(handle->handleEx.dmaChannel), BASE_STATUS_ERROR);
+    CRC_ExtendHandle *handleEx = &handle->handleEx;
+    if (handleEx->dmaBusy) {
+        return BASE_STATUS_BUSY;
+    }
+    handleEx->dmaBusy = true;
+    unsigned int elemBytes = CRC_ElementBytes(handle->inputDataFormat);
+    const unsigned char *data = (const unsigned char *)pData;
+    /* Elements before the first word boundary */
+    unsigned int misalign = (uintptr_t)(const void *)data & CRC_WORD_ALIGN_MASK;
+    unsigned int headLen = (misalign == 0) ? 0 : ((CRC_WORD_BYTES - misalign) / elemBytes);
+    headLen = (headLen > length) ? length : headLen;
+    unsigned int words = (length - headLen) * elemBytes / CRC_WORD_BYTES;
+    bool cpuOnly = (words < CRC_DMA_WORD_MIN) ||
+                   (handle->inputDataFormat != CRC_MODE_BIT32 && DCL_CRC_GetEndianMode(handle->baseAddress));
+    if (cpuOnly) {
+        handleEx->dmaWordLeft = 0;
+        handleEx->dmaTail = pData;
+        handleEx->dmaTailLen = length;
+        CRC_DmaComplete(handle, BASE_STATUS_OK);
+        return BASE_STATUS_OK;
+    }
+    if (headLen != 0) {
+        HAL_CRC_Accumulate(handle, data, headLen);
+    }
+    data += headLen * elemBytes;
+    handleEx->dmaSrcAddr = (uintptr_t)(const void *)data;
+    handleEx->dmaWordLeft = words;
+    handleEx->dmaTail = data + words * CRC_WORD_BYTES;
+    handleEx->dmaTailLen = length - headLen - words * CRC_WORD_BYTES / elemBytes;
+    handleEx->dmaHandle->userCallBack.DMA_CallbackFuns[handleEx->dmaChannel].ChannelFinishCallBack = CRC_DmaFinish;
+    handleEx->dmaHandle->userCallBack.DMA_CallbackFuns[handleEx->dmaChannel].ChannelErrorCallBack = CRC_DmaError;
+    if (CRC_DmaNextBlock(handle) != BASE_STATUS_OK) {
+        handleEx->dmaBusy = false;
+        return BASE_STATUS_ERROR;
+    }
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Compute the CRC of a buffer with the DMA feeding the calculator, starting with the default
+  *        initialization value.
+  * @param handle Value of @ref CRC_Handle.
+  * @param pData Pointer to the input data buffer, elements of handle->inputDataFormat.
+  * @param length pData array length.
+  * @retval BASE_StatusType OK, ERROR or BUSY.
+  */
+BASE_StatusType HAL_CRC_CalculateDMAEx(CRC_Handle *handle, const void *pData, unsigned int length)
+{
+    CRC_ASSERT_PARAM(handle != NULL);
+    CRC_ASSERT_PARAM(IsCRCInstance(handle->baseAddress));
+    if (handle->handleEx.dmaBusy) {
+        return BASE_STATUS_BUSY;
+    }
+    DCL_CRC_LoadInitValue(handle->baseAddress); /* load init value */
+    return HAL_CRC_AccumulateDMAEx(handle, pData, length);
+}
@@ -0,0 +1,361 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      crc_soft.c
+  * @author    MCU Driver Team
+  * @brief     CRC module driver
+  * @details   This file provides the table driven software CRC, used when the calculator is busy or not present
+  *            and on the host. It has no register access.
+  *             + Table initialization functions.
+  *             + Byte, slicing-by-4 and slicing-by-8 calculation functions.
+  */
+
+/* Includes ------------------------------------------------------------------ */
+#include "crc_ex.h"
+
+#define CRC_SOFT_BYTE_BITS      8
+#define CRC_SOFT_BYTE_MASK      0xFFU
+#define CRC_SOFT_WORD_BITS      32
+#define CRC_SOFT_MSB            0x80000000U
+#define CRC_SOFT_SLICE_ONE      1U
+#define CRC_SOFT_SLICE_FOUR     4U
+#define CRC_SOFT_SLICE_EIGHT    8U
+
+#define CRC_SOFT_POLY_8_07      0x07U
+#define CRC_SOFT_POLY_16_8005   0x8005U
+#define CRC_SOFT_POLY_16_1021   0x1021U
+#define CRC_SOFT_POLY_32_04C11DB7   0x04C11DB7U
+
+#define CRC_SOFT_WIDTH_8        8U
+#define CRC_SOFT_WIDTH_16       16U
+#define CRC_SOFT_WIDTH_32       32U
+
+/* Slice index of the lookup tables */
+#define CRC_T0 0
+#define CRC_T1 1
+#define CRC_T2 2
+#define CRC_T3 3
+#define CRC_T4 4
+#define CRC_T5 5
+#define CRC_T6 6
+#define CRC_T7 7
+
+#define CRC_BYTE0(x) ((x) & CRC_SOFT_BYTE_MASK)
+#define CRC_BYTE1(x) (((x) >> 8) & CRC_SOFT_BYTE_MASK)
+#define CRC_BYTE2(x) (((x) >> 16) & CRC_SOFT_BYTE_MASK)
+#define CRC_BYTE3(x) ((x) >> 24)
+
+/**
+  * @brief Reflect the lower bits of a value.
+  * @param value Value to be reflected.
+  * @param width Number of bits.
+  * @retval unsigned int Reflected value.
+  */
+static unsigned int CRC_SoftReflect(unsigned int value, unsigned int width)
+{
+    unsigned int out = 0;
+    for (unsigned int i = 0; i < width; i++) {
+        out = (out << 1) | ((value >> i) & 1U);
+    }
+    return out;
+}
+
+/**
+  * @brief Mask of a CRC width.
+  * @param width 8, 16 or 32.
+  * @retval unsigned int Mask.
+  */
+static inline unsigned int CRC_SoftMask(unsigned int width)
+{
+    return (width == CRC_SOFT_WIDTH_32) ? 0xFFFFFFFFU : ((1U << width) - 1U);
+}
+
+/**
+  * @brief Fill the handle parameters from the fields of an algorithm mode.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @param algoMode Value of @ref CRC_AlgorithmMode.
+  * @param poly Generator polynomial output.
+  * @retval None.
+  */
+static void CRC_SoftDecode(CRC_SoftHandle *soft, CRC_AlgorithmMode algoMode, unsigned int *poly)
+{
+    switch (algoMode & TYPE_POLY_MASK) {
+        case CRC8_07_POLY_MODE:
+        case CRC8_07_POLY_MODE_BK:
+            soft->width = CRC_SOFT_WIDTH_8;
+            *poly = CRC_SOFT_POLY_8_07;
+            break;
+        case CRC16_8005_POLY_MODE:
+            soft->width = CRC_SOFT_WIDTH_16;
+            *poly = CRC_SOFT_POLY_16_8005;
+            break;
+        case CRC16_1021_POLY_MODE:
+            soft->width = CRC_SOFT_WIDTH_16;
+            *poly = CRC_SOFT_POLY_16_1021;
+            break;
+        default:
+            soft->width = CRC_SOFT_WIDTH_32;
+            *poly = CRC_SOFT_POLY_32_04C11DB7;
+            break;
+    }
+    switch (algoMode & TYPE_INIT_MASK) {
+        case TYPE_CRC_INIT_VALUE_FF:
+            soft->init = CRC_INIT_VALUE_FF;
+            break;
+        case TYPE_CRC_INIT_VALUE_FFFF:
+            soft->init = CRC_INIT_VALUE_FFFF;
+            break;
+        case TYPE_CRC_INIT_VALUE_FFFFFFFF:
+            soft->init = CRC_INIT_VALUE_FFFFFFFF;
+            break;
+        default:
+            soft->init = CRC_INIT_VALUE_00;
+            break;
+    }
+    switch (algoMode & TYPE_XOR_VALUE_MASK) {
+        case TYPE_CRC_XOR_VALUE_55:
+            soft->xorOut = CRC_XOR_VALUE_55;
+            break;
+        case TYPE_CRC_XOR_VALUE_FFFF:
+            soft->xorOut = CRC_XOR_VALUE_FFFF;
+            break;
+        case TYPE_CRC_XOR_VALUE_FFFFFFFF:
+            soft->xorOut = CRC_XOR_VALUE_FFFFFFFF;
+            break;
+        default:
+            soft->xorOut = CRC_XOR_VALUE_00;
+            break;
+    }
+    if ((algoMode & TYPE_XOR_ENABLE_BIT) == 0) {
+        soft->xorOut = 0;
+    }
+    soft->refIn = ((algoMode & TYPE_BYTE_REVERSE_ENABLE_BIT) == TYPE_BYTE_REVERSE_ENABLE_BIT);
+    soft->refOut = ((algoMode & TYPE_OUTPUT_REVERSE_ENABLE_BIT) == TYPE_OUTPUT_REVERSE_ENABLE_BIT);
+}
+
+/**
+  * @brief Build the lookup tables of an algorithm.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @param algoMode Value of @ref CRC_AlgorithmMode.
+  * @param sliceNum 1 for the byte table, 4 for slicing-by-4, 8 for slicing-by-8, at most CRC_SOFT_SLICE_MAX.
+  * @retval BASE_StatusType BASE Status.
+  * @note  Reflected algorithms keep the register right aligned and shift it right. The others keep it left aligned
+  *        in 32 bits and shift it left, so the 8 and 16-bit CRCs share the code of the 32-bit one.
+  */
+BASE_StatusType HAL_CRC_SoftInitEx(CRC_SoftHandle *soft, CRC_AlgorithmMode algoMode, unsigned int sliceNum)
+{
+    CRC_ASSERT_PARAM(soft != NULL);
+    CRC_PARAM_CHECK_WITH_RET(IsCrcAlgorithm(algoMode), BASE_STATUS_ERROR);
+    CRC_PARAM_CHECK_WITH_RET(sliceNum == CRC_SOFT_SLICE_ONE || sliceNum == CRC_SOFT_SLICE_FOUR ||
+                             sliceNum == CRC_SOFT_SLICE_EIGHT, BASE_STATUS_ERROR);
+    CRC_PARAM_CHECK_WITH_RET(sliceNum <= CRC_SOFT_SLICE_MAX, BASE_STATUS_ERROR);
+    unsigned int poly;
+    soft->algoMode = algoMode;
+    soft->sliceNum = sliceNum;
+    CRC_SoftDecode(soft, algoMode, &poly);
+    if (soft->refIn) {
+        unsigned int refPoly = CRC_SoftReflect(poly, soft->width);
+        for (unsigned int b = 0; b < CRC_SOFT_TABLE_SIZE; b++) {
+            unsigned int c = b;
+            for (unsigned int k = 0; k < CRC_SOFT_BYTE_BITS; k++) {
+                c = ((c & 1U) != 0) ? ((c >> 1) ^ refPoly) : (c >> 1);
+            }
+            soft->table[CRC_T0][b] = c;
+        }
+        for (unsigned int s = 1; s < sliceNum; s++) {
+            for (unsigned int b = 0; b < CRC_SOFT_TABLE_SIZE; b++) {
+                unsigned int c = soft->table[s - 1][b];
+                soft->table[s][b] = (c >> CRC_SOFT_BYTE_BITS) ^ soft->table[CRC_T0][CRC_BYTE0(c)];
+            }
+        }
+        return BASE_STATUS_OK;
+    }
+    unsigned int alignPoly = poly << (CRC_SOFT_WORD_BITS - soft->width);
+    for (unsigned int b = 0; b < CRC_SOFT_TABLE_SIZE; b++) {
+        unsigned int c = b << (CRC_SOFT_WORD_BITS - CRC_SOFT_BYTE_BITS);
+        for (unsigned int k = 0; k < CRC_SOFT_BYTE_BITS; k++) {
+            c = ((c & CRC_SOFT_MSB) != 0) ? ((c << 1) ^ alignPoly) : (c << 1);
+        }
+        soft->table[CRC_T0][b] = c;
+    }
+    for (unsigned int s = 1; s < sliceNum; s++) {
+        for (unsigned int b = 0; b < CRC_SOFT_TABLE_SIZE; b++) {
+            unsigned int c = soft->table[s - 1][b];
+            soft->table[s][b] = (c << CRC_SOFT_BYTE_BITS) ^ soft->table[CRC_T0][CRC_BYTE3(c)];
+        }
+    }
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Start value of the calculation state.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @retval unsigned int State holding the init value.
+  */
+unsigned int HAL_CRC_SoftStartEx(const CRC_SoftHandle *soft)
+{
+    CRC_ASSERT_PARAM(soft != NULL);
+    if (soft->refIn) {
+        return CRC_SoftReflect(soft->init, soft->width);
+    }
+    return soft->init << (CRC_SOFT_WORD_BITS - soft->width);
+}
+
+/**
+  * @brief Little endian word from four bytes.
+  * @param p Bytes.
+  * @retval unsigned int Word.
+  */
+static inline unsigned int CRC_SoftLoadLe(const unsigned char *p)
+{
+    /* Byte 0 in bits [7:0], byte 3 in bits [31:24] */
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+/**
+  * @brief Big endian word from four bytes.
+  * @param p Bytes.
+  * @retval unsigned int Word.
+  */
+static inline unsigned int CRC_SoftLoadBe(const unsigned char *p)
+{
+    /* Byte 0 in bits [31:24], byte 3 in bits [7:0] */
+    return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | (unsigned int)p[3];
+}
+
+/**
+  * @brief Calculation of a reflected algorithm, the register shifts right.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @param state Calculation state.
+  * @param p Input bytes.
+  * @param length Number of bytes.
+  * @retval unsigned int New state.
+  */
+static unsigned int CRC_SoftUpdateRef(const CRC_SoftHandle *soft, unsigned int state, const unsigned char *p,
+                                      unsigned int length)
+{
+    const unsigned int (*t)[CRC_SOFT_TABLE_SIZE] = soft->table;
+    unsigned int crc = state;
+    unsigned int len = length;
+    if (soft->sliceNum >= CRC_SOFT_SLICE_EIGHT) {
+        for (; len >= CRC_SOFT_SLICE_EIGHT; len -= CRC_SOFT_SLICE_EIGHT, p += CRC_SOFT_SLICE_EIGHT) {
+            unsigned int w1 = CRC_SoftLoadLe(p) ^ crc;
+            unsigned int w2 = CRC_SoftLoadLe(p + CRC_SOFT_SLICE_FOUR);
+            crc = t[CRC_T7][CRC_BYTE0(w1)] ^ t[CRC_T6][CRC_BYTE1(w1)] ^ t[CRC_T5][CRC_BYTE2(w1)] ^
+                  t[CRC_T4][CRC_BYTE3(w1)] ^ t[CRC_T3][CRC_BYTE0(w2)] ^ t[CRC_T2][CRC_BYTE1(w2)] ^
+                  t[CRC_T1][CRC_BYTE2(w2)] ^ t[CRC_T0][CRC_BYTE3(w2)];
+        }
+    }
+    if (soft->sliceNum >= CRC_SOFT_SLICE_FOUR) {
+        for (; len >= CRC_SOFT_SLICE_FOUR; len -= CRC_SOFT_SLICE_FOUR, p += CRC_SOFT_SLICE_FOUR) {
+            unsigned int w = CRC_SoftLoadLe(p) ^ crc;
+            crc = t[CRC_T3][CRC_BYTE0(w)] ^ t[CRC_T2][CRC_BYTE1(w)] ^ t[CRC_T1][CRC_BYTE2(w)] ^ t[CRC_T0][CRC_BYTE3(w)];
+        }
+    }
+    for (; len > 0; len--, p++) {
+        crc = t[CRC_T0][CRC_BYTE0(crc ^ *p)] ^ (crc >> CRC_SOFT_BYTE_BITS);
+    }
+    return crc;
+}
+
+/**
+  * @brief Calculation of a non reflected algorithm, the register is left aligned and shifts left.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @param state Calculation state.
+  * @param p Input bytes.
+  * @param length Number of bytes.
+  * @retval unsigned int New state.
+  */
+static unsigned int CRC_SoftUpdateNormal(const CRC_SoftHandle *soft, unsigned int state, const unsigned char *p,
+                                         unsigned int length)
+{
+    const unsigned int (*t)[CRC_SOFT_TABLE_SIZE] = soft->table;
+    unsigned int crc = state;
+    unsigned int len = length;
+    if (soft->sliceNum >= CRC_SOFT_SLICE_EIGHT) {
+        for (; len >= CRC_SOFT_SLICE_EIGHT; len -= CRC_SOFT_SLICE_EIGHT, p += CRC_SOFT_SLICE_EIGHT) {
+            unsigned int w1 = CRC_SoftLoadBe(p) ^ crc;
+            unsigned int w2 = CRC_SoftLoadBe(p + CRC_SOFT_SLICE_FOUR);
+            crc = t[CRC_T7][CRC_BYTE3(w1)] ^ t[CRC_T6][CRC_BYTE2(w1)] ^ t[CRC_T5][CRC_BYTE1(w1)] ^
+                  t[CRC_T4][CRC_BYTE0(w1)] ^ t[CRC_T3][CRC_BYTE3(w2)] ^ t[CRC_T2][CRC_BYTE2(w2)] ^
+                  t[CRC_T1][CRC_BYTE1(w2)] ^ t[CRC_T0][CRC_BYTE0(w2)];
+        }
+    }
+    if (soft->sliceNum >= CRC_SOFT_SLICE_FOUR) {
+        for (; len >= CRC_SOFT_SLICE_FOUR; len -= CRC_SOFT_SLICE_FOUR, p += CRC_SOFT_SLICE_FOUR) {
+            unsigned int w = CRC_SoftLoadBe(p) ^ crc;
+            crc = t[CRC_T3][CRC_BYTE3(w)] ^ t[CRC_T2][CRC_BYTE2(w)] ^ t[CRC_T1][CRC_BYTE1(w)] ^ t[CRC_T0][CRC_BYTE0(w)];
+        }
+    }
+    for (; len > 0; len--, p++) {
+        crc = (crc << CRC_SOFT_BYTE_BITS) ^ t[CRC_T0][CRC_BYTE3(crc) ^ *p];
+    }
+    return crc;
+}
+
+/**
+  * @brief Feed bytes to the calculation.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @param state Calculation state from HAL_CRC_SoftStartEx() or a previous update.
+  * @param pData Input bytes, no alignment required.
+  * @param length Number of bytes.
+  * @retval unsigned int New state.
+  */
+unsigned int HAL_CRC_SoftUpdateEx(const CRC_SoftHandle *soft, unsigned int state, const void *pData,
+                                  unsigned int length)
+{
+    CRC_ASSERT_PARAM(soft != NULL);
+    CRC_ASSERT_PARAM(pData != NULL);
+    if (soft->refIn) {
+        return CRC_SoftUpdateRef(soft, state, (const unsigned char *)pData, length);
+    }
+    return CRC_SoftUpdateNormal(soft, state, (const unsigned char *)pData, length);
+}
+
+/**
+  * @brief Result of the calculation, after the output reflection and the result xor.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @param state Calculation state.
+  * @retval unsigned int CRC value.
+  */
+unsigned int HAL_CRC_SoftFinishEx(const CRC_SoftHandle *soft, unsigned int state)
+{
+    CRC_ASSERT_PARAM(soft != NULL);
+    unsigned int crc;
+    if (soft->refIn) {
+        /* The right shifting register already holds the reflected value */
+        crc = soft->refOut ? state : CRC_SoftReflect(state, soft->width);
+    } else {
+        crc = state >> (CRC_SOFT_WORD_BITS - soft->width);
+        crc = soft->refOut ? CRC_SoftReflect(crc, soft->width) : crc;
+    }
+    return (crc ^ soft->xorOut) & CRC_SoftMask(soft->width);
+}
+
+/**
+  * @brief Calculate the CRC of a byte buffer.
+  * @param soft Value of @ref CRC_SoftHandle.
+  * @param pData Input bytes, no alignment required.
+  * @param length Number of bytes.
+  * @retval unsigned int CRC value.
+  */
+unsigned int HAL_CRC_SoftCalculateEx(const CRC_SoftHandle *soft, const void *pData, unsigned int length)
+{
+    unsigned int state = HAL_CRC_SoftStartEx(soft);
+    state = HAL_CRC_SoftUpdateEx(soft, state, pData, length);
+    return HAL_CRC_SoftFinishEx(soft, state);
+}
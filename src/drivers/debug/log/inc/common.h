@@ -26,6 +26,7 @@
 
 #include "type.h"
 #include "ext_log.h"
+#include "drvcommon.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -74,6 +75,7 @@ extern "C" {
 #define EXT_FENCE(void) do {    \
     __asm__("fence\n\r"); \
 } while (0)
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -26,6 +26,11 @@
 
 #include "uart.h"
 
+#ifndef CONSOLE_TX_BUF_SIZE
+#define CONSOLE_TX_BUF_SIZE     1024U /* size of the console TX ring, must be a power of 2 */
+#endif
+#define CONSOLE_TX_CHUNK_SIZE   64U   /* maximum bytes handed to the UART per DMA/interrupt transfer */
+
 /**
   * @addtogroup DEBUG_Log
   * @brief DEBUG external module.
@@ -38,6 +43,29 @@
   * @{
   */
 
+/**
+  * @brief Behaviour of the buffered console when the TX ring is full.
+  */
+typedef enum {
+    CONSOLE_TX_POLICY_DROP = 0,      /**< Drop the new bytes that do not fit */
+    CONSOLE_TX_POLICY_OVERWRITE,     /**< Discard the oldest unsent bytes to keep the newest */
+    CONSOLE_TX_POLICY_BLOCK,         /**< Wait for room, drops instead when interrupts are masked */
+    CONSOLE_TX_POLICY_MAX
+} ConsoleTxPolicy;
+
+/**
+  * @brief Statistics of the buffered console.
+  */
+typedef struct {
+    unsigned int writeBytes;         /**< Bytes accepted into the ring */
+    unsigned int dropBytes;          /**< Bytes lost because of DROP policy or transfer errors */
+    unsigned int overwriteBytes;     /**< Bytes discarded by OVERWRITE policy */
+    unsigned int blockCnt;           /**< Times a writer waited in BLOCK policy */
+    unsigned int chunkCnt;           /**< Transfers started on the UART */
+    unsigned int errCnt;             /**< Transfers that failed to start or completed with error */
+    unsigned int maxUsed;            /**< High-water mark of the ring in bytes */
+} ConsoleTxStat;
+
   /**
   * @brief Read Status Query
   * @{
@@ -63,6 +91,14 @@ int UartPrintf(const char *format, ...);
 
 /* init console uart */
 void ConsoleInit(UART_Handle uart);
+
+/* init console uart in buffered mode, the UART must be configured in DMA or interrupt tx mode */
+BASE_StatusType ConsoleBufferedInit(UART_Handle *uart, ConsoleTxPolicy policy);
+/* flush the TX ring by polling and switch to synchronous output, for fault paths */
+void ConsoleTxFlush(void);
+void ConsoleTxResume(void);
+void ConsoleTxGetStat(ConsoleTxStat *stat);
+void ConsoleTxClearStat(void);
 /**
   * @}
   */
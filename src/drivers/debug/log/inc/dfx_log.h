@@ -38,6 +38,20 @@ extern "C" {
 
 #define LOG_STATEMENT_MAX_LEN 20
 
+/* Binary log record: header word, xml id word (line | file id << 16), then the raw arguments */
+#define LOG_BIN_MAGIC           0xA5U
+#define LOG_BIN_MAGIC_SHIFT     24
+#define LOG_BIN_ARGC_SHIFT      16
+#define LOG_BIN_LEVEL_SHIFT     12
+#define LOG_BIN_MODID_MASK      0xFFFU
+#define LOG_BIN_HEAD_WORDS      2
+#define LOG_BIN_WORDS_PER_LINE  8
+#define LOG_BIN_MAX_ARGS        ((LOG_MEM_POOL_MAX_LEN / 4) - LOG_BIN_HEAD_WORDS) /* 4: bytes per word */
+#define LOG_BIN_HEAD(level, modId, argc)                                                      \
+    (((unsigned int)LOG_BIN_MAGIC << LOG_BIN_MAGIC_SHIFT) |                                   \
+     (((unsigned int)(argc) & 0xFFU) << LOG_BIN_ARGC_SHIFT) |                                 \
+     (((unsigned int)(level) & 0xFU) << LOG_BIN_LEVEL_SHIFT) | ((unsigned int)(modId) & LOG_BIN_MODID_MASK))
+
 /**
   * @addtogroup DEBUG_Log
   * @brief DEBUG external module.
@@ -52,6 +66,7 @@ extern "C" {
 
 struct MemoryLog {
     unsigned char enable;
+    unsigned char binMode; /* records are stored as binary words and formatted on the host */
     unsigned char mmzBuf[LOG_MEM_POOL_MAX_LEN];
     unsigned int writePos;
     unsigned int logLen;
@@ -109,6 +124,15 @@ struct SysDebugSwitch *GetDebugSwitch(void);
  */
 struct MemoryLog *GetMemoryData(void);
 
+/**
+ * @brief switch the memory log between text and binary records, the memory log is cleared.
+ * @attention Binary records are decoded by build/createxml/decode_bin_log.py with the prim database.
+ *
+ * @param enable: 1: binary records, 0: text
+ * @retval None
+ */
+void LogSetBinMode(unsigned char enable);
+
 /**
  * @brief Register the dfx cmd
  * @attention None
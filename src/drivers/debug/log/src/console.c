@@ -28,6 +28,7 @@
 #include "errno.h"
 #include "ext_log.h"
 #include "dfx_log.h"
+#include "common.h"
 #define UART_READ_TIME_MS 1000
 
 #define VA_START(v, l) __builtin_va_start(v, l)
@@ -49,6 +50,22 @@ typedef enum {
 } NumBase;
 UART_Handle g_console_uart;
 
+/* TX ring control, head is written by producers and tail by the drain, both under the interrupt lock */
+typedef struct {
+    UART_Handle *uart;              /* NULL: console works in blocking mode */
+    ConsoleTxPolicy policy;
+    volatile unsigned int head;     /* free-running write index */
+    volatile unsigned int tail;     /* free-running read index */
+    volatile unsigned int inflight; /* bytes in the staging buffer owned by the UART */
+    volatile bool busy;
+    volatile bool faultMode;        /* set by ConsoleTxFlush(), output goes to the TX FIFO directly */
+    ConsoleTxStat stat;
+} ConsoleTxCtrl;
+
+static unsigned char g_consoleTxBuf[CONSOLE_TX_BUF_SIZE];
+static unsigned char g_consoleTxChunk[CONSOLE_TX_CHUNK_SIZE];
+static ConsoleTxCtrl g_consoleTx;
+
 /**
  * @brief query the status of a serial port reading register
  * @param uartHandle: indicates the serial port information corresponding to the value assignment
@@ -61,6 +78,174 @@ static BASE_StatusType QueryUartRxStatus(UART_Handle *uartHandle, unsigned char
     return BASE_STATUS_OK;
 }
 
+/**
+ * @brief Write one byte through the TX FIFO by polling, used when the ring is not available.
+ * @param uartx: UART register base address
+ * @param ch: byte to be sent
+ * @retval None
+ */
+static void ConsoleTxPollByte(UART_RegStruct *uartx, unsigned char ch)
+{
+    while (uartx->UART_FR.BIT.txff == 1) {
+        ;
+    }
+    uartx->UART_DR.BIT.data = ch;
+}
+
+/**
+ * @brief Hand the next contiguous block of the ring to the UART if the transmitter is idle.
+ *        The block is copied to the staging buffer so that the ring space is released at once.
+ * @param None
+ * @retval None
+ */
+static void ConsoleTxKick(void)
+{
+    unsigned int key;
+    unsigned int len;
+    unsigned int pos;
+    BASE_StatusType ret;
+
+    key = BASE_FUNC_IntLock();
+    len = g_consoleTx.head - g_consoleTx.tail;
+    if (g_consoleTx.busy || g_consoleTx.faultMode || len == 0) {
+        BASE_FUNC_IntUnlock(key);
+        return;
+    }
+    len = (len > CONSOLE_TX_CHUNK_SIZE) ? CONSOLE_TX_CHUNK_SIZE : len;
+    for (unsigned int i = 0; i < len; i++) {
+        pos = (g_consoleTx.tail + i) & (CONSOLE_TX_BUF_SIZE - 1);
+        g_consoleTxChunk[i] = g_consoleTxBuf[pos];
+    }
+    g_consoleTx.tail += len;
+    g_consoleTx.busy = true;
+    g_consoleTx.inflight = len;
+    g_consoleTx.stat.chunkCnt++;
+    if (g_consoleTx.uart->txMode == UART_MODE_DMA) {
+        ret = HAL_UART_WriteDMA(g_consoleTx.uart, g_consoleTxChunk, len);
+    } else {
+        ret = HAL_UART_WriteIT(g_consoleTx.uart, g_consoleTxChunk, len);
+    }
+    if (ret != BASE_STATUS_OK) {
+        /* The data has left the ring, account it as lost rather than retry from the ISR */
+        g_consoleTx.busy = false;
+        g_consoleTx.inflight = 0;
+        g_consoleTx.stat.errCnt++;
+        g_consoleTx.stat.dropBytes += len;
+    }
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+ * @brief TX finish callback of the console UART, release the staging buffer and start the next block.
+ * @param handle: UART handle
+ * @retval None
+ */
+static void ConsoleTxDoneCallback(void *handle)
+{
+    BASE_FUNC_UNUSED(handle);
+    g_consoleTx.inflight = 0;
+    g_consoleTx.busy = false;
+    ConsoleTxKick();
+}
+
+/**
+ * @brief TX DMA error callback of the console UART. The UART driver resets its state after this
+ *        callback returns, so the next block is started by the next write.
+ * @param handle: UART handle
+ * @retval None
+ */
+static void ConsoleTxErrCallback(void *handle)
+{
+    BASE_FUNC_UNUSED(handle);
+    if (g_consoleTx.busy) {
+        g_consoleTx.stat.errCnt++;
+        g_consoleTx.stat.dropBytes += g_consoleTx.inflight;
+        g_consoleTx.inflight = 0;
+        g_consoleTx.busy = false;
+    }
+}
+
+/**
+ * @brief Wait until the ring has room for len bytes, used by CONSOLE_TX_POLICY_BLOCK.
+ *        Waiting is impossible with interrupts masked, the caller then falls back to dropping.
+ * @param len: number of bytes to be written
+ * @retval None
+ */
+static void ConsoleTxWaitSpace(unsigned int len)
+{
+    if ((READ_CSR(mstatus) & MSTATUS_MIE) == 0) {
+        return;
+    }
+    if (CONSOLE_TX_BUF_SIZE - (g_consoleTx.head - g_consoleTx.tail) >= len) {
+        return;
+    }
+    g_consoleTx.stat.blockCnt++;
+    while (CONSOLE_TX_BUF_SIZE - (g_consoleTx.head - g_consoleTx.tail) < len) {
+        ConsoleTxKick();
+        if (g_consoleTx.faultMode) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Copy data into the TX ring according to the overflow policy and start the transmitter.
+ *        The interrupt lock only covers the copy, so the cost for the caller is a memcpy.
+ * @param data: bytes to be written
+ * @param len: number of bytes, no more than CONSOLE_TX_BUF_SIZE
+ * @retval None
+ */
+static void ConsoleTxWrite(const unsigned char *data, unsigned int len)
+{
+    unsigned int key;
+    unsigned int freeLen;
+    unsigned int used;
+
+    if (g_consoleTx.policy == CONSOLE_TX_POLICY_BLOCK) {
+        ConsoleTxWaitSpace(len);
+    }
+    key = BASE_FUNC_IntLock();
+    freeLen = CONSOLE_TX_BUF_SIZE - (g_consoleTx.head - g_consoleTx.tail);
+    if (freeLen < len) {
+        if (g_consoleTx.policy == CONSOLE_TX_POLICY_OVERWRITE) {
+            /* Discard the oldest unsent bytes, the block in flight lives in the staging buffer */
+            g_consoleTx.tail += len - freeLen;
+            g_consoleTx.stat.overwriteBytes += len - freeLen;
+        } else {
+            g_consoleTx.stat.dropBytes += len - freeLen;
+            len = freeLen;
+        }
+    }
+    for (unsigned int i = 0; i < len; i++) {
+        g_consoleTxBuf[(g_consoleTx.head + i) & (CONSOLE_TX_BUF_SIZE - 1)] = data[i];
+    }
+    g_consoleTx.head += len;
+    g_consoleTx.stat.writeBytes += len;
+    used = g_consoleTx.head - g_consoleTx.tail;
+    g_consoleTx.stat.maxUsed = (used > g_consoleTx.stat.maxUsed) ? used : g_consoleTx.stat.maxUsed;
+    BASE_FUNC_IntUnlock(key);
+    ConsoleTxKick();
+}
+
+/**
+ * @brief Output bytes through the ring in buffered mode, or synchronously otherwise.
+ * @param data: bytes to be output
+ * @param len: number of bytes
+ * @retval None
+ */
+static void ConsoleOutput(const unsigned char *data, unsigned int len)
+{
+    if (g_consoleTx.uart == NULL) {
+        HAL_UART_WriteBlocking(&g_console_uart, (unsigned char *)data, len, UART_READ_TIME_MS);
+    } else if (g_consoleTx.faultMode) {
+        for (unsigned int i = 0; i < len; i++) {
+            ConsoleTxPollByte(g_consoleTx.uart->baseAddress, data[i]);
+        }
+    } else {
+        ConsoleTxWrite(data, len);
+    }
+}
+
 /**
  * @brief Single Character Output
  * @param c: single character to be output
@@ -68,16 +253,16 @@ static BASE_StatusType QueryUartRxStatus(UART_Handle *uartHandle, unsigned char
  */
 void ConsolePutc(const char c)
 {
-    unsigned int length = 1;
-    unsigned char p;
+    unsigned char p[2]; /* 2: '\n' is extended to "\r\n" */
     /* add newline characters for standby */
-    p = (unsigned char)c;
     if (c == '\n') {
-        p = '\r';
-        HAL_UART_WriteBlocking(&g_console_uart, &p, length, UART_READ_TIME_MS);
-        p = '\n';
+        p[0] = '\r';
+        p[1] = '\n';
+        ConsoleOutput(p, 2); /* 2: "\r\n" */
+        return;
     }
-    HAL_UART_WriteBlocking(&g_console_uart, &p, length, UART_READ_TIME_MS);
+    p[0] = (unsigned char)c;
+    ConsoleOutput(p, 1);
 }
 
 /**
@@ -88,11 +273,21 @@ void ConsolePutc(const char c)
 int ConsolePuts(const char *str)
 {
     int cnt = 0;
-    /* decompose a string into a single character output */
+    unsigned int segLen;
+    /* output the string in segments delimited by '\n', so that each segment is a single ring write */
     while (*str != '\0') {
-        ConsolePutc(*str);
-        str++;
-        cnt++;
+        segLen = 0;
+        while (str[segLen] != '\0' && str[segLen] != '\n' && segLen < CONSOLE_TX_CHUNK_SIZE) {
+            segLen++;
+        }
+        if (segLen == 0) {
+            ConsolePutc(*str);
+            segLen = 1;
+        } else {
+            ConsoleOutput((const unsigned char *)str, segLen);
+        }
+        str += segLen;
+        cnt += (int)segLen;
     }
     return cnt;
 }
@@ -439,4 +634,120 @@ void ConsoleInit(UART_Handle uart)
 {
     g_console_uart = uart;
     DfxCmdRegister();
+}
+
+/**
+ * @brief Init the console in buffered mode, printing only copies data into the TX ring and the UART
+ *        drains it by DMA or TX interrupt according to uart->txMode.
+ * @param uart: initialized UART handle, its TX finish callbacks are taken over by the console
+ * @param policy: behaviour when the ring is full
+ * @retval BASE_STATUS_OK or BASE_STATUS_ERROR
+ */
+BASE_StatusType ConsoleBufferedInit(UART_Handle *uart, ConsoleTxPolicy policy)
+{
+    if (uart == NULL || policy >= CONSOLE_TX_POLICY_MAX) {
+        return BASE_STATUS_ERROR;
+    }
+    if (uart->txMode != UART_MODE_DMA && uart->txMode != UART_MODE_INTERRUPT) {
+        return BASE_STATUS_ERROR;
+    }
+    ConsoleInit(*uart);
+    g_consoleTx.uart = NULL;
+    g_consoleTx.policy = policy;
+    g_consoleTx.head = 0;
+    g_consoleTx.tail = 0;
+    g_consoleTx.inflight = 0;
+    g_consoleTx.busy = false;
+    g_consoleTx.faultMode = false;
+    ConsoleTxClearStat();
+    HAL_UART_RegisterCallBack(uart, UART_WRITE_DMA_FINISH, ConsoleTxDoneCallback);
+    HAL_UART_RegisterCallBack(uart, UART_WRITE_IT_FINISH, ConsoleTxDoneCallback);
+    HAL_UART_RegisterCallBack(uart, UART_TRNS_DMA_ERROR, ConsoleTxErrCallback);
+    g_consoleTx.uart = uart;
+    return BASE_STATUS_OK;
+}
+
+/**
+ * @brief Flush everything pending by polling the TX FIFO and keep the console synchronous afterwards.
+ *        Intended for fault and reset paths, safe to call with interrupts disabled.
+ *        In DMA mode the block in flight is sent again, so a few bytes may be duplicated.
+ * @param None
+ * @retval None
+ */
+void ConsoleTxFlush(void)
+{
+    unsigned int key;
+    UART_Handle *uart = g_consoleTx.uart;
+
+    if (uart == NULL) {
+        return;
+    }
+    key = BASE_FUNC_IntLock();
+    g_consoleTx.faultMode = true;
+    if (g_consoleTx.busy && g_consoleTx.inflight != 0) {
+        unsigned int start = 0;
+        if (uart->txMode == UART_MODE_DMA) {
+            HAL_UART_StopWrite(uart);
+            g_consoleTx.busy = false;
+        } else {
+            /* Interrupt mode knows what has been sent, the driver completes the empty transfer itself */
+            start = g_consoleTx.inflight - uart->txBuffSize;
+            uart->txBuffSize = 0;
+        }
+        for (unsigned int i = start; i < g_consoleTx.inflight; i++) {
+            ConsoleTxPollByte(uart->baseAddress, g_consoleTxChunk[i]);
+        }
+        g_consoleTx.inflight = 0;
+    }
+    while (g_consoleTx.tail != g_consoleTx.head) {
+        ConsoleTxPollByte(uart->baseAddress, g_consoleTxBuf[g_consoleTx.tail & (CONSOLE_TX_BUF_SIZE - 1)]);
+        g_consoleTx.tail++;
+    }
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+ * @brief Leave the synchronous mode entered by ConsoleTxFlush() and resume buffered output.
+ * @param None
+ * @retval None
+ */
+void ConsoleTxResume(void)
+{
+    g_consoleTx.faultMode = false;
+    ConsoleTxKick();
+}
+
+/**
+ * @brief Get the TX ring statistics.
+ * @param stat: pointer to save the statistics
+ * @retval None
+ */
+void ConsoleTxGetStat(ConsoleTxStat *stat)
+{
+    unsigned int key;
+
+    if (stat == NULL) {
+        return;
+    }
+    key = BASE_FUNC_IntLock();
+    *stat = g_consoleTx.stat;
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+ * @brief Clear the TX ring statistics.
+ * @param None
+ * @retval None
+ */
+void ConsoleTxClearStat(void)
+{
+    unsigned int key = BASE_FUNC_IntLock();
+    g_consoleTx.stat.writeBytes = 0;
+    g_consoleTx.stat.dropBytes = 0;
+    g_consoleTx.stat.overwriteBytes = 0;
+    g_consoleTx.stat.blockCnt = 0;
+    g_consoleTx.stat.chunkCnt = 0;
+    g_consoleTx.stat.errCnt = 0;
+    g_consoleTx.stat.maxUsed = 0;
+    BASE_FUNC_IntUnlock(key);
 }
\ No newline at end of file
@@ -88,6 +88,7 @@ struct SysDebugSwitch *GetDebugSwitch(void)
 void InitMemoryData(struct MemoryLog *memData)
 {
     memData->enable = EXT_TRUE;
+    memData->binMode = EXT_FALSE;
     memData->logLen = 0;
     memData->writePos = 0;
 }
@@ -154,6 +155,94 @@ static void PutLogToMem(struct MemoryLog *memLog, const char *src, unsigned char
     }
 }
 
+/**
+ * @brief Store one word into the memory log in little-endian byte order.
+ * @param memLog: memory log, writePos is word aligned in binary mode
+ * @param pos: byte position reserved for the word
+ * @param word: value to be stored
+ * @retval None.
+ */
+static inline void PutBinWord(struct MemoryLog *memLog, unsigned int pos, unsigned int word)
+{
+    unsigned char *dst = memLog->mmzBuf + (pos % LOG_MEM_POOL_MAX_LEN);
+    dst[0] = (unsigned char)word;
+    dst[1] = (unsigned char)(word >> 8);  /* 8: byte 1 */
+    dst[2] = (unsigned char)(word >> 16); /* 2: byte 2, 16: shift */
+    dst[3] = (unsigned char)(word >> 24); /* 3: byte 3, 24: shift */
+}
+
+/**
+ * @brief Write a binary record into the memory log, the ring space is reserved with interrupts
+ *        locked and filled afterwards, so the cost for the caller is a few stores per word.
+ * @param memLog: memory log
+ * @param head: record header, see LOG_BIN_HEAD
+ * @param id: xml id of the log statement
+ * @param args: raw arguments, may be NULL when argc is 0
+ * @param argc: number of arguments
+ * @retval None.
+ */
+static void PutBinLogToMem(struct MemoryLog *memLog, unsigned int head, unsigned int id,
+    const unsigned int *args, unsigned int argc)
+{
+    unsigned int len = (LOG_BIN_HEAD_WORDS + argc) * sizeof(unsigned int);
+    unsigned int pos;
+    unsigned int key = BASE_FUNC_IntLock();
+
+    pos = memLog->writePos;
+    memLog->writePos = (pos + len) % LOG_MEM_POOL_MAX_LEN;
+    memLog->logLen = (memLog->logLen + len > LOG_MEM_POOL_MAX_LEN) ? LOG_MEM_POOL_MAX_LEN : memLog->logLen + len;
+    BASE_FUNC_IntUnlock(key);
+
+    PutBinWord(memLog, pos, head);
+    PutBinWord(memLog, pos + sizeof(unsigned int), id);
+    for (unsigned int i = 0; i < argc; i++) {
+        PutBinWord(memLog, pos + (LOG_BIN_HEAD_WORDS + i) * sizeof(unsigned int), args[i]);
+    }
+}
+
+/**
+ * @brief Write the record in binary form when the memory log works in binary mode.
+ * @param level: Specifies the log level.
+ * @param modId: Device ID
+ * @param id: xml id of the log statement
+ * @param args: raw arguments
+ * @param argc: number of arguments
+ * @retval EXT_SUCCESS if the record has been handled here, EXT_FAILURE to fall back to text output.
+ */
+static int DealBinLog(enum ExtLogLevel level, enum ExtModule modId, unsigned int id,
+    const unsigned int *args, unsigned int argc)
+{
+    struct SysLogCtx *ctx = GetLogCtx();
+
+    if (!ctx->memLog.enable || !ctx->memLog.binMode || modId >= EXT_MODULE_BUTT || argc > LOG_BIN_MAX_ARGS) {
+        return EXT_FAILURE;
+    }
+    if (!ctx->init) { LogCtxInit(ctx); } /* Initialize the structure */
+    /* Filter before doing any work, same rules as the text path */
+    if ((!GetDebugSwitch()->enable && level != EXT_LOG_LEVEL_ERROR) || level > ctx->logLevel[modId]) {
+        return EXT_SUCCESS;
+    }
+    PutBinLogToMem(&ctx->memLog, LOG_BIN_HEAD(level, modId, argc), id, args, argc);
+    return EXT_SUCCESS;
+}
+
+/**
+ * @brief switch the memory log between text and binary records.
+ * @param enable: 1: binary records, 0: text
+ * @retval None.
+ */
+void LogSetBinMode(unsigned char enable)
+{
+    struct SysLogCtx *ctx = GetLogCtx();
+    unsigned int key = BASE_FUNC_IntLock();
+
+    ctx->memLog.binMode = (enable != 0) ? EXT_TRUE : EXT_FALSE;
+    /* Text and binary records can not be mixed, and binary records must stay word aligned */
+    ctx->memLog.writePos = 0;
+    ctx->memLog.logLen = 0;
+    BASE_FUNC_IntUnlock(key);
+}
+
 /**
  * @brief Calculates the length of an int number converted to a character string.
  * @param num: number to calculate.
@@ -205,6 +294,9 @@ int ExtDrvLogOutBuf(enum ExtLogLevel level, enum ExtModule modId, unsigned int i
     /* Check whether the array is empty */
     if (logBuf == NULL)
         return EXT_FAILURE;
+    if (DealBinLog(level, modId, id, logBuf, logBufLen) == EXT_SUCCESS) {
+        return EXT_SUCCESS;
+    }
     /* Value Definition Initialization */
     char buf[LOG_UINT_MAX_LEN] = { 0 };
     int cnt = 0;
@@ -315,6 +407,9 @@ int ExtDrvLogOut0(enum ExtLogLevel level, enum ExtModule modId, unsigned int id)
     /* Check whether the value is out of range */
     if (level > EXT_LOG_LEVEL_BUTT || modId > EXT_MODULE_BUTT)
         return EXT_FAILURE;
+    if (DealBinLog(level, modId, id, NULL, 0) == EXT_SUCCESS) {
+        return EXT_SUCCESS;
+    }
     char buf[LOG_UINT_MAX_LEN] = { 0 };
     int len = 0;
     len = sprintf_s(buf, LOG_UINT_MAX_LEN, "%u\n", id);
@@ -339,6 +434,9 @@ int ExtDrvLogOut1(enum ExtLogLevel level, enum ExtModule modId, unsigned int id,
     /* Check whether the value is out of range */
     if (level > EXT_LOG_LEVEL_BUTT || modId > EXT_MODULE_BUTT)
         return EXT_FAILURE;
+    if (DealBinLog(level, modId, id, &d0, 1) == EXT_SUCCESS) {
+        return EXT_SUCCESS;
+    }
     char buf[LOG_UINT_MAX_LEN] = { 0 };
     int len = 0;
     len = sprintf_s(buf, LOG_UINT_MAX_LEN, "%u %u\n", id, d0);
@@ -364,6 +462,10 @@ int ExtDrvLogOut2(enum ExtLogLevel level, enum ExtModule modId, unsigned int id,
     /* Check whether the value is out of range */
     if (level > EXT_LOG_LEVEL_BUTT || modId > EXT_MODULE_BUTT)
         return EXT_FAILURE;
+    unsigned int args[] = {d0, d1};
+    if (DealBinLog(level, modId, id, args, 2) == EXT_SUCCESS) { /* 2: number of arguments */
+        return EXT_SUCCESS;
+    }
     char buf[LOG_UINT_MAX_LEN] = { 0 };
     int len = 0;
     len = sprintf_s(buf, LOG_UINT_MAX_LEN, "%u %u %u\n", id, d0, d1);
@@ -391,6 +493,10 @@ int ExtDrvLogOut3(enum ExtLogLevel level, enum ExtModule modId, unsigned int id,
     /* Check whether the value is out of range */
     if (level > EXT_LOG_LEVEL_BUTT || modId > EXT_MODULE_BUTT)
         return EXT_FAILURE;
+    unsigned int args[] = {d0, d1, d2};
+    if (DealBinLog(level, modId, id, args, 3) == EXT_SUCCESS) { /* 3: number of arguments */
+        return EXT_SUCCESS;
+    }
     char buf[LOG_UINT_MAX_LEN] = { 0 };
     int len = 0;
     len = sprintf_s(buf, LOG_UINT_MAX_LEN, "%u %u %u %u\n", id, d0, d1, d2);
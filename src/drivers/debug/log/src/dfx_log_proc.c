@@ -94,6 +94,32 @@ static int DrvLogPutLogToMem(unsigned char enable)
     return EXT_SUCCESS;
 }
 
+/**
+ * @brief print the binary records stored in the memory as hex words, oldest first.
+ *        The output is decoded on the host by build/createxml/decode_bin_log.py.
+ * @param memLog: memory log in binary mode
+ * @retval None
+ */
+static void DrvLogPrintBinLog(const struct MemoryLog *memLog)
+{
+    unsigned int start = (memLog->logLen == LOG_MEM_POOL_MAX_LEN) ? memLog->writePos : 0;
+    unsigned int words = memLog->logLen / sizeof(unsigned int);
+    unsigned int pos;
+    unsigned int word;
+
+    EXT_PRINT("binlog begin %u\n", words);
+    for (unsigned int i = 0; i < words; i++) {
+        pos = (start + i * sizeof(unsigned int)) % LOG_MEM_POOL_MAX_LEN;
+        word = memLog->mmzBuf[pos] | ((unsigned int)memLog->mmzBuf[pos + 1] << 8) | /* 8: byte 1 */
+            ((unsigned int)memLog->mmzBuf[pos + 2] << 16) | ((unsigned int)memLog->mmzBuf[pos + 3] << 24); /* 2, 3 */
+        EXT_PRINT("%x ", word);
+        if ((i % LOG_BIN_WORDS_PER_LINE) == (LOG_BIN_WORDS_PER_LINE - 1)) {
+            EXT_PRINT("\n");
+        }
+    }
+    EXT_PRINT("\nbinlog end\n");
+}
+
 /**
  * @brief print the logs stored in the memory
  * @param None
@@ -110,6 +136,10 @@ static void DrvLogPrintMemLog(void)
         EXT_PRINT("mem record log not enable\n");
         return;
     }
+    if (ctx->memLog.binMode) {
+        DrvLogPrintBinLog(&ctx->memLog);
+        return;
+    }
 
     unsigned short i;
     if (ctx->memLog.logLen == LOG_MEM_POOL_MAX_LEN) {
@@ -137,6 +167,7 @@ static void DrvLogCmdHelp(void)
     EXT_PRINT("logcmd show  show log info\n");
     EXT_PRINT("logcmd  setlevel [moduleId][level] set log level(0:F,1:E,2:W,3:I,4:D)\n");
     EXT_PRINT("logcmd  setmem [0/1] enable mem log(1: print to memory, 0: print to console)\n");
+    EXT_PRINT("logcmd  setbin [0/1] memory log format(1: binary records, 0: text)\n");
     EXT_PRINT("logcmd print print log from memory\n");
 }
 
@@ -177,6 +208,12 @@ static int DrvLogCmd(unsigned int argc, const char *argv[])
             EXT_PRINT("set put mem err\n");
             return EXT_FAILURE;
         }
+    } else if (strcmp(argv[1], "setbin") == 0) {
+        if (argc < 3) { /* 3 is argc */
+            DrvLogCmdHelp();
+            return EXT_FAILURE;
+        }
+        LogSetBinMode((unsigned char)strtoul(argv[2], &endp, 0)); /* 2 is argv */
     } else if (strcmp(argv[1], "print") == 0) {
         DrvLogPrintMemLog();
     }
@@ -21,6 +21,7 @@
   * @details This file provides firmware functions to manage the following.
   *          functionalities of the DMA.
   *          + DMA Set Functions
+  *          + Descriptor pool and chained transfer functions
   */
 
 #ifndef McuMagicTag_DMA_EX_H
@@ -29,17 +30,87 @@
 #include "dma.h"
 
 /* Macro definitions ---------------------------------------------------------*/
+#ifndef DMA_DESC_POOL_NUM
+#define DMA_DESC_POOL_NUM   32U /* Linked list descriptors in the static pool shared by all chains */
+#endif
+
 /**
   * @addtogroup DMA_IP
   * @{
   */
 
+/**
+  * @defgroup DMA_EX_Chain_Definition DMA Chain Definition
+  * @{
+  */
+
+/**
+  * @brief State of a DMA chain.
+  */
+typedef enum {
+    DMA_CHAIN_IDLE = 0x00000000U,
+    DMA_CHAIN_WAITING = 0x00000001U,    /**< Started, waiting for a free channel. */
+    DMA_CHAIN_RUNNING = 0x00000002U,
+} DMA_ChainState;
+
+/**
+  * @brief DMA chain statistics.
+  */
+typedef struct {
+    unsigned int    startCnt;   /**< Times the chain was put on a channel. */
+    unsigned int    waitCnt;    /**< Starts that had to wait for a channel. */
+    unsigned int    finishCnt;  /**< Completed runs, or completed segments of a cyclic chain. */
+    unsigned int    errorCnt;   /**< Transfer errors. */
+} DMA_ChainStat;
+
+/**
+  * @brief Reusable chain of linked list descriptors taken from the descriptor pool.
+  * @details Each HAL_DMA_ChainAppendEx() adds one segment, the segment is split into several descriptors when it is
+  *          longer than TRANSIZE_MAX. A one-shot chain interrupts at its last descriptor. A cyclic chain is closed
+  *          into a ring and interrupts at the end of each segment, so it streams until stopped, for example
+  *          ADC to RAM double buffering. The chain is kept after the transfer and can be started again as is.
+  */
+typedef struct _DMA_Chain {
+    DMA_LinkList           *head;           /**< First descriptor. */
+    DMA_LinkList           *tail;           /**< Last descriptor, appending is O(1). */
+    unsigned int            nodeNum;        /**< Descriptors taken from the pool. */
+    unsigned int            segmentNum;     /**< Appended segments. */
+    DMA_ChannelParam        param;          /**< Channel configuration, param.pHandle is the callback argument. */
+    unsigned int            controlVal;     /**< Descriptor control value without the transfer size. */
+    bool                    cyclic;         /**< The tail links back to the head. */
+    DMA_ChannelPriority     priority;       /**< Channel arbitration and bus priority. */
+    volatile DMA_ChainState state;          /**< Chain state. */
+    unsigned int            channel;        /**< Channel of a running chain. */
+    DMA_Handle             *dmaHandle;      /**< DMA handle of a started chain. */
+    DMA_CallbackType        finishCallback; /**< Run finished, or segment finished for a cyclic chain. */
+    DMA_CallbackType        errorCallback;  /**< Transfer error, the chain is stopped. */
+    struct _DMA_Chain      *waitNext;       /**< Next chain waiting for a channel. */
+    DMA_ChainStat           stat;           /**< Statistics. */
+} DMA_Chain;
+/**
+  * @}
+  */
+
 /**
   * @defgroup DMA_EX_API_Declaration DMA HAL API EX
   * @{
   */
 
 void HAL_DMA_SetChannelPriorityEx(DMA_Handle *dmaHandle, unsigned int channel, DMA_ChannelPriority priority);
+
+DMA_LinkList *HAL_DMA_DescAllocEx(void);
+void HAL_DMA_DescFreeEx(DMA_LinkList *node);
+unsigned int HAL_DMA_DescFreeNumEx(void);
+
+BASE_StatusType HAL_DMA_ChainEngineInitEx(DMA_Handle *dmaHandle, unsigned int channelMask);
+BASE_StatusType HAL_DMA_ChainInitEx(DMA_Chain *chain, const DMA_ChannelParam *param,
+                                    DMA_ChannelPriority priority, bool cyclic);
+BASE_StatusType HAL_DMA_ChainAppendEx(DMA_Chain *chain, unsigned int srcAddr, unsigned int destAddr,
+                                      unsigned int tranSize);
+BASE_StatusType HAL_DMA_ChainResetEx(DMA_Chain *chain);
+void HAL_DMA_ChainRegisterCallbackEx(DMA_Chain *chain, DMA_CallbackFun_Type typeID, DMA_CallbackType pCallback);
+BASE_StatusType HAL_DMA_ChainStartEx(DMA_Handle *dmaHandle, DMA_Chain *chain);
+BASE_StatusType HAL_DMA_ChainStopEx(DMA_Chain *chain);
 /**
   * @}
   */
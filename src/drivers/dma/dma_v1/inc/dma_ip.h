@@ -264,6 +264,9 @@ typedef enum {
   * @brief DMA extend handle.
   */
 typedef struct _DMA_ExtendHandle {
+    unsigned int            chainChannelMask;               /**< Channels shared by the DMA chains */
+    struct _DMA_Chain      *chainRunning[CHANNEL_MAX_NUM];  /**< Chain running on each channel */
+    struct _DMA_Chain      *chainWait;                      /**< Chains waiting for a channel, by priority */
 } DMA_ExtendHandle;
 
 /**
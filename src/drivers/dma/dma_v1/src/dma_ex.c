@@ -21,11 +21,19 @@
   * @details This file provides firmware functions to manage the following
   *          functionalities of the DMA.
   *          + DMA Set Functions.
+  *          + Descriptor pool and chained transfer functions.
   */
 
 /* Includes ------------------------------------------------------------------*/
 
+#include "drvcommon.h"
 #include "dma_ex.h"
+
+static DMA_LinkList g_dmaDescPool[DMA_DESC_POOL_NUM];
+static DMA_LinkList *g_dmaDescFree = NULL;
+static unsigned int g_dmaDescFreeNum = 0;
+static bool g_dmaDescPoolReady = false;
+
 /**
   * @brief Configuring the Transmission Channel Priority on the DMA.
   * @param dmaHandle DMA handle.
@@ -39,4 +47,464 @@ void HAL_DMA_SetChannelPriorityEx(DMA_Handle *dmaHandle, unsigned int channel, D
     DMA_PARAM_CHECK_NO_RET(IsDmaChannelNum(channel));
     DMA_PARAM_CHECK_NO_RET(IsDmaPriority(priority));
     dmaHandle->DMA_Channels[channel].channelAddr->DMA_Cn_CONFIG.BIT.ch_priority = priority;
-}
\ No newline at end of file
+}
+
+/**
+  * @brief Link all descriptors of the pool into the free list, called with the interrupts masked.
+  * @param None.
+  * @retval None.
+  */
+static void DMA_DescPoolInit(void)
+{
+    for (unsigned int i = 0; i < DMA_DESC_POOL_NUM - 1; i++) {
+        g_dmaDescPool[i].lliNext = &g_dmaDescPool[i + 1];
+    }
+    g_dmaDescPool[DMA_DESC_POOL_NUM - 1].lliNext = NULL;
+    g_dmaDescFree = &g_dmaDescPool[0];
+    g_dmaDescFreeNum = DMA_DESC_POOL_NUM;
+    g_dmaDescPoolReady = true;
+}
+
+/**
+  * @brief Take a number of descriptors from the pool, all or none.
+  * @param num Number of descriptors.
+  * @param last Output, last descriptor of the returned list.
+  * @retval First descriptor of a NULL terminated list, NULL if the pool has not enough descriptors.
+  */
+static DMA_LinkList *DMA_DescTake(unsigned int num, DMA_LinkList **last)
+{
+    unsigned int key = BASE_FUNC_IntLock();
+    if (!g_dmaDescPoolReady) {
+        DMA_DescPoolInit();
+    }
+    if (num == 0 || g_dmaDescFreeNum < num) {
+        BASE_FUNC_IntUnlock(key);
+        return NULL;
+    }
+    DMA_LinkList *first = g_dmaDescFree;
+    DMA_LinkList *node = first;
+    for (unsigned int i = 1; i < num; i++) {
+        node = node->lliNext;
+    }
+    g_dmaDescFree = node->lliNext;
+    g_dmaDescFreeNum -= num;
+    BASE_FUNC_IntUnlock(key);
+    node->lliNext = NULL;
+    *last = node;
+    return first;
+}
+
+/**
+  * @brief Return a list of descriptors to the pool in O(1).
+  * @param first First descriptor of the list.
+  * @param last Last descriptor of the list.
+  * @param num Number of descriptors in the list.
+  * @retval None.
+  */
+static void DMA_DescGive(DMA_LinkList *first, DMA_LinkList *last, unsigned int num)
+{
+    unsigned int key = BASE_FUNC_IntLock();
+    last->lliNext = g_dmaDescFree;
+    g_dmaDescFree = first;
+    g_dmaDescFreeNum += num;
+    BASE_FUNC_IntUnlock(key);
+}
+
+/**
+  * @brief Take one linked list descriptor from the static descriptor pool.
+  * @param None.
+  * @retval Descriptor with lliNext set to NULL, NULL if the pool is empty.
+  */
+DMA_LinkList *HAL_DMA_DescAllocEx(void)
+{
+    DMA_LinkList *last = NULL;
+    return DMA_DescTake(1, &last);
+}
+
+/**
+  * @brief Return a descriptor taken by HAL_DMA_DescAllocEx() to the descriptor pool.
+  * @param node Descriptor, it must not be in use by a channel.
+  * @retval None.
+  */
+void HAL_DMA_DescFreeEx(DMA_LinkList *node)
+{
+    DMA_ASSERT_PARAM(node != NULL);
+    DMA_PARAM_CHECK_NO_RET(node >= &g_dmaDescPool[0] && node <= &g_dmaDescPool[DMA_DESC_POOL_NUM - 1]);
+    DMA_DescGive(node, node, 1);
+}
+
+/**
+  * @brief Number of free descriptors in the descriptor pool.
+  * @param None.
+  * @retval Free descriptors.
+  */
+unsigned int HAL_DMA_DescFreeNumEx(void)
+{
+    return g_dmaDescPoolReady ? g_dmaDescFreeNum : DMA_DESC_POOL_NUM;
+}
+
+/**
+  * @brief Reserve channels for the DMA chains. Started chains are put on any free reserved channel, and wait in
+  *        priority order while all of them are busy. The reserved channels must not be used by other DMA calls.
+  * @param dmaHandle DMA handle.
+  * @param channelMask Bit n set reserves channel n.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR.
+  */
+BASE_StatusType HAL_DMA_ChainEngineInitEx(DMA_Handle *dmaHandle, unsigned int channelMask)
+{
+    DMA_ASSERT_PARAM(dmaHandle != NULL);
+    DMA_ASSERT_PARAM(IsDMAInstance(dmaHandle->baseAddress));
+    DMA_PARAM_CHECK_WITH_RET(channelMask != 0, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(channelMask < (1U << CHANNEL_MAX_NUM), BASE_STATUS_ERROR);
+    unsigned int key = BASE_FUNC_IntLock();
+    if (!g_dmaDescPoolReady) {
+        DMA_DescPoolInit();
+    }
+    dmaHandle->handleEx.chainChannelMask = channelMask;
+    for (unsigned int i = 0; i < CHANNEL_MAX_NUM; i++) {
+        dmaHandle->handleEx.chainRunning[i] = NULL;
+    }
+    dmaHandle->handleEx.chainWait = NULL;
+    BASE_FUNC_IntUnlock(key);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Initialize an empty DMA chain. Must not be called on a started chain.
+  * @param chain DMA chain.
+  * @param param Channel configuration shared by all segments, param->pHandle is passed to the chain callbacks.
+  * @param priority Priority for the channel arbitration and the bus, @ref DMA_ChannelPriority.
+  * @param cyclic true: the chain is a ring that runs until stopped and interrupts after each segment.
+  *               false: the chain runs once and interrupts after the last segment.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR.
+  */
+BASE_StatusType HAL_DMA_ChainInitEx(DMA_Chain *chain, const DMA_ChannelParam *param,
+                                    DMA_ChannelPriority priority, bool cyclic)
+{
+    DMA_ASSERT_PARAM(chain != NULL);
+    DMA_ASSERT_PARAM(param != NULL);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaDirection(param->direction) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaReqPeriph(param->srcPeriph) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaReqPeriph(param->destPeriph) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaWidth(param->srcWidth) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaWidth(param->destWidth) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaBurstLength(param->srcBurst) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaBurstLength(param->destBurst) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaAddrMode(param->srcAddrInc) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaAddrMode(param->destAddrInc) == true, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaPriority(priority) == true, BASE_STATUS_ERROR);
+    chain->head = NULL;
+    chain->tail = NULL;
+    chain->nodeNum = 0;
+    chain->segmentNum = 0;
+    chain->param = *param;
+    unsigned int val = 0;
+    val |= (param->srcBurst) << 12;         /* Shift left by 12 bits for source burst */
+    val |= (param->destBurst) << 15;        /* Shift left by 15 bits for destination burst */
+    val |= (param->srcWidth) << 18;         /* Shift left by 18 bits for source width */
+    val |= (param->destWidth) << 21;        /* Shift left by 21 bits for destination width */
+    val |= (param->srcAddrInc) << 26;       /* Shift left by 26 bits for source address */
+    val |= (param->destAddrInc) << 27;      /* Shift left by 27 bits for destination address */
+    chain->controlVal = val;
+    chain->cyclic = cyclic;
+    chain->priority = priority;
+    chain->state = DMA_CHAIN_IDLE;
+    chain->channel = CHANNEL_MAX_NUM;
+    chain->dmaHandle = NULL;
+    chain->finishCallback = NULL;
+    chain->errorCallback = NULL;
+    chain->waitNext = NULL;
+    chain->stat.startCnt = 0;
+    chain->stat.waitCnt = 0;
+    chain->stat.finishCnt = 0;
+    chain->stat.errorCnt = 0;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Append a segment to the tail of an idle chain in O(1), the descriptors come from the pool.
+  *        A segment longer than TRANSIZE_MAX is split into blocks of TRANS_BLOCK, the last block takes the rest.
+  * @param chain DMA chain.
+  * @param srcAddr Source address of the segment.
+  * @param destAddr Destination address of the segment.
+  * @param tranSize Transfer size of the segment, in source width units.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR, BASE_STATUS_BUSY.
+  */
+BASE_StatusType HAL_DMA_ChainAppendEx(DMA_Chain *chain, unsigned int srcAddr, unsigned int destAddr,
+                                      unsigned int tranSize)
+{
+    DMA_ASSERT_PARAM(chain != NULL);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaValidAddress(srcAddr), BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaValidAddress(destAddr), BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(tranSize > 0, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaValidAddress(srcAddr + tranSize), BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(IsDmaValidAddress(destAddr + tranSize), BASE_STATUS_ERROR);
+    if (chain->state != DMA_CHAIN_IDLE) {
+        return BASE_STATUS_BUSY;
+    }
+    unsigned int nodeNum = (tranSize > TRANSIZE_MAX) ? ((tranSize + TRANS_BLOCK - 1) / TRANS_BLOCK) : 1;
+    DMA_LinkList *last = NULL;
+    DMA_LinkList *first = DMA_DescTake(nodeNum, &last);
+    if (first == NULL) {
+        return BASE_STATUS_ERROR;
+    }
+    /* Source and destnation address single increment size */
+    unsigned int srcIn = chain->param.srcAddrInc * (1 << chain->param.srcWidth);
+    unsigned int destIn = chain->param.destAddrInc * (1 << chain->param.destWidth);
+    unsigned int remainSize = tranSize;
+    unsigned int index = 0;
+    for (DMA_LinkList *node = first; node != NULL; node = node->lliNext) {
+        /* Same rule as nodeNum: a TRANS_BLOCK per descriptor, so no descriptor is left empty */
+        unsigned int size = (nodeNum == 1 || remainSize < TRANS_BLOCK) ? remainSize : TRANS_BLOCK;
+        node->srcAddr = srcAddr + (index * TRANS_BLOCK * srcIn);
+        node->destAddr = destAddr + (index * TRANS_BLOCK * destIn);
+        node->control.reg = chain->controlVal | size;
+        remainSize -= size;
+        index++;
+    }
+    last->control.BIT.int_tc_enable = 0x01; /* The end of the segment triggers the transfer completion interrupt */
+    if (chain->tail == NULL) {
+        chain->head = first;
+    } else {
+        chain->tail->lliNext = first;
+        if (!chain->cyclic) {
+            chain->tail->control.BIT.int_tc_enable = 0x0; /* A one-shot chain only interrupts at its tail */
+        }
+    }
+    chain->tail = last;
+    chain->tail->lliNext = chain->cyclic ? chain->head : NULL;
+    chain->nodeNum += nodeNum;
+    chain->segmentNum++;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Return all descriptors of an idle chain to the pool in O(1), the chain configuration is kept.
+  * @param chain DMA chain.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_BUSY.
+  */
+BASE_StatusType HAL_DMA_ChainResetEx(DMA_Chain *chain)
+{
+    DMA_ASSERT_PARAM(chain != NULL);
+    if (chain->state != DMA_CHAIN_IDLE) {
+        return BASE_STATUS_BUSY;
+    }
+    if (chain->head != NULL) {
+        DMA_DescGive(chain->head, chain->tail, chain->nodeNum);
+    }
+    chain->head = NULL;
+    chain->tail = NULL;
+    chain->nodeNum = 0;
+    chain->segmentNum = 0;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Register a chain callback, it is called from the DMA interrupt with param.pHandle of the chain.
+  * @param chain DMA chain.
+  * @param typeID DMA_CHANNEL_FINISH or DMA_CHANNEL_ERROR.
+  * @param pCallback Callback function.
+  * @retval None.
+  */
+void HAL_DMA_ChainRegisterCallbackEx(DMA_Chain *chain, DMA_CallbackFun_Type typeID, DMA_CallbackType pCallback)
+{
+    DMA_ASSERT_PARAM(chain != NULL);
+    switch (typeID) {
+        case DMA_CHANNEL_FINISH:
+            chain->finishCallback = pCallback;
+            break;
+        case DMA_CHANNEL_ERROR:
+            chain->errorCallback = pCallback;
+            break;
+        default:
+            return;
+    }
+}
+
+/**
+  * @brief Find a reserved channel that is neither owned by a chain nor enabled.
+  * @param dmaHandle DMA handle.
+  * @retval Channel number, CHANNEL_MAX_NUM if all reserved channels are busy.
+  */
+static unsigned int DMA_ChainFindChannel(DMA_Handle *dmaHandle)
+{
+    unsigned int enabled = dmaHandle->baseAddress->DMA_ENABLED_CHNS.reg;
+    for (unsigned int i = 0; i < CHANNEL_MAX_NUM; i++) {
+        if ((dmaHandle->handleEx.chainChannelMask & (1U << i)) != 0 &&
+            dmaHandle->handleEx.chainRunning[i] == NULL && (enabled & (1U << i)) == 0) {
+            return i;
+        }
+    }
+    return CHANNEL_MAX_NUM;
+}
+
+static void DMA_ChainFinish(void *handle);
+static void DMA_ChainError(void *handle);
+
+/**
+  * @brief Put a chain on a free channel, called with the interrupts masked.
+  * @param chain DMA chain.
+  * @param channel Free channel.
+  * @retval None.
+  */
+static void DMA_ChainRun(DMA_Chain *chain, unsigned int channel)
+{
+    DMA_Handle *dmaHandle = chain->dmaHandle;
+    DMA_ChannelRegStruct *chn = dmaHandle->DMA_Channels[channel].channelAddr;
+    dmaHandle->handleEx.chainRunning[channel] = chain;
+    dmaHandle->DMA_Channels[channel].pHandle = chain;
+    dmaHandle->userCallBack.DMA_CallbackFuns[channel].ChannelFinishCallBack = DMA_ChainFinish;
+    dmaHandle->userCallBack.DMA_CallbackFuns[channel].ChannelErrorCallBack = DMA_ChainError;
+    chain->channel = channel;
+    chain->state = DMA_CHAIN_RUNNING;
+    chain->stat.startCnt++;
+
+    dmaHandle->baseAddress->DMA_INT_TC_CLR.reg = (1U << channel);
+    dmaHandle->baseAddress->DMA_INT_ERR_CLR.reg = (1U << channel);
+    chn->DMA_Cn_SRC_ADDR.reg = chain->head->srcAddr;
+    chn->DMA_Cn_DEST_ADDR.reg = chain->head->destAddr;
+    chn->DMA_Cn_LLI.reg = (uintptr_t)(void *)chain->head->lliNext;
+    chn->DMA_Cn_CONTROL.reg = chain->head->control.reg;
+    /* Flow control, request lines, interrupt masks and priority are written together with the channel enable */
+    DMA_Cn_CONFIG_REG config;
+    config.reg = 0;
+    config.BIT.flow_ctrl = chain->param.direction;
+    if (chain->param.srcPeriph < DMA_REQUEST_MEM) {
+        config.BIT.src_periph = chain->param.srcPeriph;
+    }
+    if (chain->param.destPeriph < DMA_REQUEST_MEM) {
+        config.BIT.dest_periph = chain->param.destPeriph;
+    }
+    config.BIT.err_int_msk = BASE_CFG_ENABLE;
+    config.BIT.tc_int_msk = BASE_CFG_ENABLE;
+    config.BIT.ch_priority = chain->priority;
+    config.BIT.ch_en = BASE_CFG_ENABLE;
+    chn->DMA_Cn_CONFIG.reg = config.reg;
+}
+
+/**
+  * @brief Release the channel of a chain and hand it to the first waiting chain, called with the interrupts masked.
+  * @param chain DMA chain.
+  * @retval None.
+  */
+static void DMA_ChainRelease(DMA_Chain *chain)
+{
+    DMA_Handle *dmaHandle = chain->dmaHandle;
+    unsigned int channel = chain->channel;
+    dmaHandle->handleEx.chainRunning[channel] = NULL;
+    chain->channel = CHANNEL_MAX_NUM;
+    chain->state = DMA_CHAIN_IDLE;
+    DMA_Chain *next = dmaHandle->handleEx.chainWait;
+    if (next != NULL) {
+        dmaHandle->handleEx.chainWait = next->waitNext;
+        next->waitNext = NULL;
+        DMA_ChainRun(next, channel);
+    }
+}
+
+/**
+  * @brief Channel completion callback of a chain, registered by DMA_ChainRun().
+  * @param handle DMA chain.
+  * @retval None.
+  */
+static void DMA_ChainFinish(void *handle)
+{
+    DMA_Chain *chain = (DMA_Chain *)handle;
+    chain->stat.finishCnt++;
+    if (!chain->cyclic) {
+        unsigned int key = BASE_FUNC_IntLock();
+        DMA_ChainRelease(chain);
+        BASE_FUNC_IntUnlock(key);
+    }
+    if (chain->finishCallback != NULL) {
+        chain->finishCallback(chain->param.pHandle);
+    }
+}
+
+/**
+  * @brief Channel error callback of a chain, the controller has disabled the channel.
+  * @param handle DMA chain.
+  * @retval None.
+  */
+static void DMA_ChainError(void *handle)
+{
+    DMA_Chain *chain = (DMA_Chain *)handle;
+    chain->stat.errorCnt++;
+    unsigned int key = BASE_FUNC_IntLock();
+    DMA_ChainRelease(chain);
+    BASE_FUNC_IntUnlock(key);
+    if (chain->errorCallback != NULL) {
+        chain->errorCallback(chain->param.pHandle);
+    }
+}
+
+/**
+  * @brief Start a chain on a free reserved channel, or queue it by priority until a channel is released.
+  *        Equal priorities are served first come first served.
+  * @param dmaHandle DMA handle initialized by HAL_DMA_ChainEngineInitEx().
+  * @param chain DMA chain with at least one segment.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR, BASE_STATUS_BUSY.
+  */
+BASE_StatusType HAL_DMA_ChainStartEx(DMA_Handle *dmaHandle, DMA_Chain *chain)
+{
+    DMA_ASSERT_PARAM(dmaHandle != NULL);
+    DMA_ASSERT_PARAM(chain != NULL);
+    DMA_ASSERT_PARAM(IsDMAInstance(dmaHandle->baseAddress));
+    DMA_PARAM_CHECK_WITH_RET(chain->head != NULL, BASE_STATUS_ERROR);
+    DMA_PARAM_CHECK_WITH_RET(dmaHandle->handleEx.chainChannelMask != 0, BASE_STATUS_ERROR);
+    unsigned int key = BASE_FUNC_IntLock();
+    if (chain->state != DMA_CHAIN_IDLE) {
+        BASE_FUNC_IntUnlock(key);
+        return BASE_STATUS_BUSY;
+    }
+    chain->dmaHandle = dmaHandle;
+    unsigned int channel = DMA_ChainFindChannel(dmaHandle);
+    if (channel < CHANNEL_MAX_NUM) {
+        DMA_ChainRun(chain, channel);
+        BASE_FUNC_IntUnlock(key);
+        return BASE_STATUS_OK;
+    }
+    /* Insert behind the waiting chains of the same or a higher priority */
+    DMA_Chain **pos = &dmaHandle->handleEx.chainWait;
+    while (*pos != NULL && (*pos)->priority >= chain->priority) {
+        pos = &(*pos)->waitNext;
+    }
+    chain->waitNext = *pos;
+    *pos = chain;
+    chain->state = DMA_CHAIN_WAITING;
+    chain->stat.waitCnt++;
+    BASE_FUNC_IntUnlock(key);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Stop a running chain, or remove it from the wait queue. A released channel is handed to the next chain.
+  * @param chain DMA chain.
+  * @retval BASE_StatusType: BASE_STATUS_OK.
+  */
+BASE_StatusType HAL_DMA_ChainStopEx(DMA_Chain *chain)
+{
+    DMA_ASSERT_PARAM(chain != NULL);
+    unsigned int key = BASE_FUNC_IntLock();
+    DMA_Handle *dmaHandle = chain->dmaHandle;
+    if (chain->state == DMA_CHAIN_WAITING) {
+        DMA_Chain **pos = &dmaHandle->handleEx.chainWait;
+        while (*pos != NULL && *pos != chain) {
+            pos = &(*pos)->waitNext;
+        }
+        if (*pos != NULL) {
+            *pos = chain->waitNext;
+        }
+        chain->waitNext = NULL;
+        chain->state = DMA_CHAIN_IDLE;
+    } else if (chain->state == DMA_CHAIN_RUNNING) {
+        unsigned int channel = chain->channel;
+        HAL_DMA_StopChannel(dmaHandle, channel);
+        /* Drop a completion that has not been serviced yet */
+        dmaHandle->baseAddress->DMA_INT_TC_CLR.reg = (1U << channel);
+        dmaHandle->baseAddress->DMA_INT_ERR_CLR.reg = (1U << channel);
+        DMA_ChainRelease(chain);
+    }
+    BASE_FUNC_IntUnlock(key);
+    return BASE_STATUS_OK;
+}
@@ -0,0 +1,307 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file    flash_ex.h
+  * @author  MCU Driver Team
+  * @brief   FLASH module driver.
+  * @details This file provides firmware functions to manage the following functionalities of the FLASH.
+  *          + Log-structured key-value store definition and functions.
+  *          + Program and erase job queue definition and functions.
+  */
+#ifndef McuMagicTag_FLASH_EX_H
+#define McuMagicTag_FLASH_EX_H
+
+/* Includes ---------------------------------------------------------------------*/
+#include "flash.h"
+#include "crc_ex.h"
+
+/* Macro definitions -----------------------------------------------------------*/
+#ifndef FLASH_KV_KEY_NUM
+#define FLASH_KV_KEY_NUM            32U     /* Keys are 0 to FLASH_KV_KEY_NUM - 1, the RAM index has one entry each. */
+#endif
+
+#ifndef FLASH_KV_PAGE_NUM_MAX
+#define FLASH_KV_PAGE_NUM_MAX       8U      /* Largest number of pages given to one store. */
+#endif
+
+#ifndef FLASH_KV_QUEUE_SIZE
+#define FLASH_KV_QUEUE_SIZE         512U    /* Bytes of records waiting to be programmed, multiple of 16. */
+#endif
+
+#ifndef FLASH_KV_WEAR_SPREAD_MAX
+#define FLASH_KV_WEAR_SPREAD_MAX    32U     /* Erase count spread above which cold pages are compacted first. */
+#endif
+
+#ifndef FLASH_JOB_QUEUE_LEN
+#define FLASH_JOB_QUEUE_LEN         8U      /* Jobs waiting or running. */
+#endif
+
+#define FLASH_JOB_ID_NONE           0U
+#define FLASH_JOB_FLAG_LAZY_INVALIDATE  0x00000001U /* Invalidate the cache once the queue drains, not at job end. */
+
+#define FLASH_KV_RECORD_HEAD_SIZE   12U     /* Record header, the data follows it directly. */
+#define FLASH_KV_DATA_MAX           (FLASH_MAX_PGM_BYTE_SIZE - FLASH_KV_RECORD_HEAD_SIZE) /* One program row. */
+#define FLASH_KV_PAGE_NONE          0xFFFFFFFFU
+#define FLASH_KV_ADDR_NONE          0xFFFFFFFFU
+
+/**
+  * @addtogroup FLASH
+  * @{
+  */
+
+/**
+  * @defgroup FLASH_EX FLASH_EX
+  * @brief FLASH_EX: flash_v1
+  * @{
+  */
+
+/**
+  * @defgroup FLASH_KV_Definition FLASH Key-Value Store Definition
+  * @{
+  */
+
+/**
+  * @brief State of a store page.
+  */
+typedef enum {
+    FLASH_KV_PAGE_ERASED = 0x00000000U,     /**< Blank, ready to be opened. */
+    FLASH_KV_PAGE_ACTIVE = 0x00000001U,     /**< Valid page header, holds records. */
+    FLASH_KV_PAGE_DIRTY  = 0x00000002U,     /**< Neither blank nor valid, e.g. an interrupted erase. */
+    FLASH_KV_PAGE_BAD    = 0x00000003U      /**< Erase failed, no longer used. */
+} FLASH_KvPageState;
+
+/**
+  * @brief Flash operation in progress.
+  */
+typedef enum {
+    FLASH_KV_OP_IDLE      = 0x00000000U,
+    FLASH_KV_OP_RECORD    = 0x00000001U,    /**< Programming a queued record. */
+    FLASH_KV_OP_PAGE_HEAD = 0x00000002U,    /**< Programming the header of a newly opened page. */
+    FLASH_KV_OP_COPY      = 0x00000003U,    /**< Programming a live record moved out of the victim page. */
+    FLASH_KV_OP_ERASE     = 0x00000004U     /**< Erasing the victim page or a dirty page. */
+} FLASH_KvOpType;
+
+/**
+  * @brief RAM copy of one store page.
+  */
+typedef struct {
+    FLASH_KvPageState   state;      /**< Page state. */
+    unsigned int        seq;        /**< Opening order, later pages hold newer records. */
+    unsigned int        eraseCnt;   /**< Erase count, kept in the page header. */
+    unsigned int        usedLen;    /**< Bytes used from the page start, page size once the page is closed. */
+    unsigned int        liveLen;    /**< Bytes of records still referenced by the index. */
+} FLASH_KvPage;
+
+/**
+  * @brief Index entry of one key.
+  */
+typedef struct {
+    unsigned int        addr;       /**< Flash address of the newest record, FLASH_KV_ADDR_NONE if never written. */
+    unsigned short      len;        /**< Data length. */
+    unsigned short      deleted;    /**< The newest record is a delete marker. */
+} FLASH_KvIndex;
+
+/**
+  * @brief Store statistics.
+  */
+typedef struct {
+    unsigned int        writeCnt;       /**< Records programmed for the user. */
+    unsigned int        copyCnt;        /**< Records moved by compaction. */
+    unsigned int        compactCnt;     /**< Pages reclaimed by compaction. */
+    unsigned int        eraseCnt;       /**< Page erases. */
+    unsigned int        queueFullCnt;   /**< Writes refused because the queue was full. */
+    unsigned int        storeFullCnt;   /**< Records dropped because no space could be reclaimed. */
+    unsigned int        failCnt;        /**< Program or erase failures. */
+    unsigned int        crcErrCnt;      /**< Corrupted records found by the boot scan. */
+    unsigned int        minPageErase;   /**< Lowest page erase count. */
+    unsigned int        maxPageErase;   /**< Highest page erase count. */
+} FLASH_KvStat;
+
+/**
+  * @brief Log-structured key-value store over two or more flash pages.
+  * @details Records are appended to the head page and never modified, the newest record of a key wins. Each record
+  *          carries a CRC-32 over its header and data, so a record torn by a power failure is found by the boot scan,
+  *          which builds the RAM index in one pass over the pages in opening order. Writes are queued in RAM and
+  *          programmed from the flash interrupt. One erased page is kept in reserve: when no other erased page is
+  *          left, compaction moves the live records of the page with the least live data to the head and erases
+  *          it. Programs and erases go through the job queue of the handle when one is attached. Erased pages are
+  *          opened lowest erase count first, and once the erase count spread exceeds FLASH_KV_WEAR_SPREAD_MAX the
+  *          least worn page is compacted, so static data moves too.
+  */
+typedef struct _FLASH_KvStore {
+    FLASH_Handle           *flash;                          /**< Flash handle, interrupt mode. */
+    const CRC_SoftHandle   *crc;                            /**< Software CRC-32 shared with the application. */
+    unsigned int            baseAddr;                       /**< PE address of the first page. */
+    unsigned int            pageNum;                        /**< Number of pages, 2 to FLASH_KV_PAGE_NUM_MAX. */
+    FLASH_KvPage            page[FLASH_KV_PAGE_NUM_MAX];    /**< Page table. */
+    FLASH_KvIndex           index[FLASH_KV_KEY_NUM];        /**< Newest record of each key. */
+    unsigned int            headPage;                       /**< Page receiving records. */
+    unsigned int            nextSeq;                        /**< Sequence number of the next opened page. */
+    unsigned int            erasedNum;                      /**< Number of erased pages. */
+    unsigned int            victimPage;                     /**< Page being compacted. */
+    unsigned int            victimOffset;                   /**< Next record of the victim page. */
+    volatile FLASH_KvOpType op;                             /**< Flash operation in progress. */
+    unsigned int            opPage;                         /**< Page of the operation. */
+    unsigned int            opAddr;                         /**< Flash address of the operation. */
+    unsigned int            queue[FLASH_KV_QUEUE_SIZE / sizeof(unsigned int)]; /**< Records to program. */
+    unsigned int            queueHead;                      /**< Byte offset of the oldest queued record. */
+    unsigned int            queueTail;                      /**< Byte offset of the next free byte. */
+    unsigned int            queueWrap;                      /**< End of the older records after a wrap, 0 if none. */
+    unsigned int            queueUsed;                      /**< Queued bytes. */
+    unsigned int            copyBuf[FLASH_MAX_PGM_WORD_SIZE]; /**< Record being moved, or the page header. */
+    void (*WriteFinishCallBack)(struct _FLASH_KvStore *kv, unsigned int key, BASE_StatusType status); /**< Record
+                                                            programmed or dropped, called in interrupt context. */
+    FLASH_KvStat            stat;                           /**< Statistics. */
+} FLASH_KvStore;
+
+/**
+ * @brief Key-value store callback function type.
+ */
+typedef void (*FLASH_KvCallbackFunType)(FLASH_KvStore *kv, unsigned int key, BASE_StatusType status);
+
+/**
+  * @}
+  */
+
+/**
+  * @defgroup FLASH_Job_Definition FLASH Job Queue Definition
+  * @{
+  */
+
+/**
+  * @brief Job type.
+  */
+typedef enum {
+    FLASH_JOB_WRITE = 0x00000000U,
+    FLASH_JOB_ERASE = 0x00000001U
+} FLASH_JobType;
+
+/**
+  * @brief When the next program or erase burst starts.
+  */
+typedef enum {
+    FLASH_JOB_START_NOW    = 0x00000000U,  /**< As soon as the previous burst completes. */
+    FLASH_JOB_START_WINDOW = 0x00000001U   /**< In the next HAL_FLASH_JobWindowEx() call, one burst per call. */
+} FLASH_JobStartMode;
+
+/**
+  * @brief Program or erase job.
+  */
+typedef struct {
+    FLASH_JobType   type;       /**< Write or page erase. */
+    unsigned int    flags;      /**< FLASH_JOB_FLAG_* */
+    unsigned int    id;         /**< Job identifier, never FLASH_JOB_ID_NONE. */
+    unsigned int    srcAddr;    /**< Write source address. */
+    unsigned int    destAddr;   /**< PE address, 16 byte aligned for a write, page aligned for an erase. */
+    unsigned int    len;        /**< Write: bytes, erase: pages. */
+    unsigned int    doneLen;    /**< Progress in the unit of len. */
+    unsigned int    submitTick; /**< Systick count at submission. */
+} FLASH_Job;
+
+/**
+  * @brief Job queue statistics, times in systick counts.
+  */
+typedef struct {
+    unsigned int        jobCnt;         /**< Jobs completed. */
+    unsigned int        failCnt;        /**< Jobs ended by an error. */
+    unsigned int        burstCnt;       /**< Program or erase commands issued. */
+    unsigned int        windowWaitCnt;  /**< Bursts held back until a start window. */
+    unsigned int        invalidateCnt;  /**< Cache invalidations. */
+    unsigned int        maxQueueDepth;  /**< Most jobs queued at once. */
+    unsigned int        maxBurstTicks;  /**< Longest burst, command start to completion interrupt. */
+    unsigned int        lastJobTicks;   /**< Submission to completion of the last job. */
+    unsigned int        maxJobTicks;    /**< Longest submission to completion. */
+    unsigned long long  sumJobTicks;    /**< Sum of submission to completion over jobCnt jobs. */
+} FLASH_JobStat;
+
+/**
+  * @brief Program and erase job queue.
+  * @details Jobs run in order from the flash interrupt, one burst at a time: a write is split at the program
+  *          row boundaries into bursts of at most burstMax bytes, an erase runs one page per burst. In
+  *          FLASH_JOB_START_WINDOW mode each burst is started by HAL_FLASH_JobWindowEx(), called from the carrier
+  *          interrupt where the control loop has finished its flash reads for the period. The cache is invalidated
+  *          once per job instead of once per burst, or once per drained queue for lazy jobs. A finished job is
+  *          reported to JobFinishCallBack, then to the FlashCallBack of the handle as a write or erase done or fail
+  *          event with the job destination address, so that the key-value store can run on a shared queue.
+  */
+typedef struct _FLASH_JobQueue {
+    FLASH_Job               job[FLASH_JOB_QUEUE_LEN];   /**< Ring of jobs, the head job is running. */
+    unsigned int            head;                       /**< Slot of the running job. */
+    unsigned int            count;                      /**< Queued jobs. */
+    unsigned int            nextId;                     /**< Identifier of the next job. */
+    FLASH_JobStartMode      startMode;                  /**< Burst start mode. */
+    unsigned int            burstMax;                   /**< Largest program burst in bytes, 16 to 256. */
+    volatile bool           running;                    /**< A burst is in progress. */
+    volatile bool           waitWindow;                 /**< The next burst waits for a start window. */
+    bool                    invalidatePending;          /**< A lazy job completed, the cache is not invalidated. */
+    unsigned int            burstLen;                   /**< Length of the running burst, in the unit of len. */
+    unsigned int            burstTick;                  /**< Systick count at the burst start. */
+    void (*JobFinishCallBack)(FLASH_Handle *handle, unsigned int jobId, BASE_StatusType status); /**< Called in
+                                                           interrupt context when a job completes or fails. */
+    FLASH_JobStat           stat;                       /**< Statistics. */
+} FLASH_JobQueue;
+
+/**
+ * @brief Job completion callback function type.
+ */
+typedef void (*FLASH_JobCallbackFunType)(FLASH_Handle *handle, unsigned int jobId, BASE_StatusType status);
+
+/**
+  * @}
+  */
+
+/**
+  * @defgroup FLASH_EX_API_Declaration FLASH HAL API EX
+  * @{
+  */
+BASE_StatusType HAL_FLASH_KvInitEx(FLASH_KvStore *kv, FLASH_Handle *flash, const CRC_SoftHandle *crc,
+                                   unsigned int baseAddr, unsigned int pageNum);
+BASE_StatusType HAL_FLASH_KvRegisterCallbackEx(FLASH_KvStore *kv, FLASH_KvCallbackFunType pcallback);
+BASE_StatusType HAL_FLASH_KvWriteEx(FLASH_KvStore *kv, unsigned int key, const void *data, unsigned int len);
+BASE_StatusType HAL_FLASH_KvDeleteEx(FLASH_KvStore *kv, unsigned int key);
+BASE_StatusType HAL_FLASH_KvReadEx(FLASH_KvStore *kv, unsigned int key, void *data, unsigned int buffLen,
+                                   unsigned int *len);
+bool HAL_FLASH_KvIsIdleEx(const FLASH_KvStore *kv);
+void HAL_FLASH_KvGetStatEx(const FLASH_KvStore *kv, FLASH_KvStat *stat);
+
+/* Job queue, HAL_FLASH_IrqHandler() and HAL_FLASH_IrqHandlerError() run the jobs */
+BASE_StatusType HAL_FLASH_JobInitEx(FLASH_Handle *handle, FLASH_JobQueue *queue, FLASH_JobStartMode startMode,
+                                    unsigned int burstMax);
+BASE_StatusType HAL_FLASH_JobRegisterCallbackEx(FLASH_Handle *handle, FLASH_JobCallbackFunType pcallback);
+BASE_StatusType HAL_FLASH_JobWriteEx(FLASH_Handle *handle, unsigned int srcAddr, unsigned int destAddr,
+                                     unsigned int srcLen, unsigned int flags, unsigned int *jobId);
+BASE_StatusType HAL_FLASH_JobEraseEx(FLASH_Handle *handle, FLASH_SectorAddr startAddr, unsigned int eraseNum,
+                                     unsigned int flags, unsigned int *jobId);
+void HAL_FLASH_JobWindowEx(FLASH_Handle *handle);
+BASE_StatusType HAL_FLASH_JobGetProgressEx(FLASH_Handle *handle, unsigned int jobId, unsigned int *doneLen,
+                                           unsigned int *totalLen);
+bool HAL_FLASH_JobIsIdleEx(const FLASH_Handle *handle);
+void HAL_FLASH_JobGetStatEx(const FLASH_Handle *handle, FLASH_JobStat *stat);
+void HAL_FLASH_JobClearStatEx(FLASH_Handle *handle);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+#endif /* #ifndef McuMagicTag_FLASH_EX_H */
@@ -293,6 +293,8 @@ typedef enum {
   */
 typedef struct {
     unsigned int onceOperateLen; /* Length of the flash memory to be operaten, write unit: byte, erase unit: page. */
+    struct _FLASH_KvStore *kvStore; /* Key-value store running on this flash handle, NULL if none. */
+    struct _FLASH_JobQueue *jobQueue; /* Job queue attached by HAL_FLASH_JobInitEx(), NULL if none. */
 } FLASH_ExtendHandle;
 
 /**
@@ -25,7 +25,8 @@
   */
 
 /* Includes ------------------------------------------------------------------ */
-#include "flash.h"
+#include "drvcommon.h"
+#include "flash_ex.h"
 
 #define FLASH_CRC_SAVE_BUFFER_LEN   2
 #define FLASH_ALL_INTERRUPT_ENABLE  0x001F0010
@@ -616,6 +617,408 @@ BASE_StatusType HAL_FLASH_Read(FLASH_Handle *handle,
     return BASE_STATUS_OK;
 }
 
+/**
+  * @brief Issue the next burst of the head job: up to the end of the program row and at most burstMax bytes for
+  *        a write, one page for an erase.
+  * @param handle FLASH handle.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_BUSY.
+  */
+static BASE_StatusType FLASH_JobStartBurst(FLASH_Handle *handle)
+{
+    FLASH_JobQueue *queue = handle->handleEx.jobQueue;
+    FLASH_Job *job = &queue->job[queue->head];
+    unsigned int rowLeft;
+    unsigned int burst;
+    BASE_StatusType ret;
+
+    if (job->type == FLASH_JOB_WRITE) {
+        handle->state = FLASH_STATE_PGM;
+        handle->srcAddr = job->srcAddr + job->doneLen;
+        handle->destAddr = (job->destAddr + job->doneLen) / FLASH_ONE_WORD_BYTES_SIZE;
+        rowLeft = FLASH_GetWriteAlignmentWords(handle) * FLASH_ONE_WORD_BYTES_SIZE;
+        burst = job->len - job->doneLen;
+        burst = (rowLeft != 0 && burst > rowLeft) ? rowLeft : burst;
+        burst = (burst > queue->burstMax) ? queue->burstMax : burst;
+        ret = FLASH_WriteWords(handle, handle->srcAddr, handle->destAddr, burst);
+    } else {
+        handle->state = FLASH_STATE_ERASE;
+        handle->destAddr = (job->destAddr + job->doneLen * FLASH_ONE_PAGE_SIZE) / FLASH_ONE_WORD_BYTES_SIZE;
+        burst = 1; /* One page per burst. */
+        ret = FLASH_EraseWithMode(handle, handle->destAddr, FLASH_ERASE_MODE_PAGE);
+    }
+    if (ret != BASE_STATUS_OK) {
+        return ret;
+    }
+    queue->burstLen = burst;
+    queue->burstTick = DCL_SYSTICK_GetTick();
+    queue->running = true;
+    queue->stat.burstCnt++;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Invalidate the flash cache after programming or erasing.
+  * @param handle FLASH handle.
+  * @retval None.
+  */
+static void FLASH_JobInvalidate(FLASH_Handle *handle)
+{
+    handle->baseAddress->CACHE_CTRL.BIT.cache_invalid_req = BASE_CFG_SET;
+    handle->handleEx.jobQueue->invalidatePending = false;
+    handle->handleEx.jobQueue->stat.invalidateCnt++;
+}
+
+static void FLASH_JobKick(FLASH_Handle *handle);
+
+/**
+  * @brief End the head job and report it, to the job callback and as a write or erase event to the flash callback.
+  * @param handle FLASH handle.
+  * @param status Job status.
+  * @retval None.
+  */
+static void FLASH_JobFinish(FLASH_Handle *handle, BASE_StatusType status)
+{
+    FLASH_JobQueue *queue = handle->handleEx.jobQueue;
+    FLASH_Job *job = &queue->job[queue->head];
+    unsigned int jobId = job->id;
+    unsigned int destAddr = job->destAddr;
+    bool ok = (status == BASE_STATUS_OK);
+    FLASH_CallBackEvent event;
+    unsigned int ticks = BASE_FUNC_TicksSince(job->submitTick);
+
+    if (job->type == FLASH_JOB_WRITE) {
+        event = ok ? FLASH_WRITE_EVENT_DONE : FLASH_WRITE_EVENT_FAIL;
+    } else {
+        event = ok ? FLASH_ERASE_EVENT_DONE : FLASH_ERASE_EVENT_FAIL;
+    }
+
+    queue->invalidatePending = true;
+    if ((job->flags & FLASH_JOB_FLAG_LAZY_INVALIDATE) == 0 || queue->count == 1 || status != BASE_STATUS_OK) {
+        FLASH_JobInvalidate(handle);
+    }
+    queue->head = (queue->head + 1) % FLASH_JOB_QUEUE_LEN;
+    queue->count--;
+    queue->stat.jobCnt++;
+    queue->stat.failCnt += (status == BASE_STATUS_OK) ? 0 : 1;
+    queue->stat.lastJobTicks = ticks;
+    queue->stat.maxJobTicks = (ticks > queue->stat.maxJobTicks) ? ticks : queue->stat.maxJobTicks;
+    queue->stat.sumJobTicks += ticks;
+    if (queue->count == 0) {
+        handle->state = FLASH_STATE_READY;
+    }
+    if (queue->JobFinishCallBack != NULL) {
+        queue->JobFinishCallBack(handle, jobId, status);
+    }
+    if (handle->userCallBack.FlashCallBack != NULL) {
+        handle->userCallBack.FlashCallBack(handle, event, destAddr);
+    }
+}
+
+/**
+  * @brief Start the next burst, or leave it for the next start window.
+  * @param handle FLASH handle.
+  * @retval None.
+  */
+static void FLASH_JobKick(FLASH_Handle *handle)
+{
+    FLASH_JobQueue *queue = handle->handleEx.jobQueue;
+    while (!queue->running && !queue->waitWindow && queue->count > 0) {
+        if (queue->startMode == FLASH_JOB_START_WINDOW) {
+            queue->waitWindow = true;
+            queue->stat.windowWaitCnt++;
+            return;
+        }
+        if (FLASH_JobStartBurst(handle) != BASE_STATUS_OK) {
+            FLASH_JobFinish(handle, BASE_STATUS_ERROR);
+        }
+    }
+}
+
+/**
+  * @brief Account a completed burst, called from the flash interrupt.
+  * @param handle FLASH handle.
+  * @param ok The burst completed without error.
+  * @retval None.
+  */
+static void FLASH_JobBurstDone(FLASH_Handle *handle, bool ok)
+{
+    FLASH_JobQueue *queue = handle->handleEx.jobQueue;
+    FLASH_Job *job = &queue->job[queue->head];
+    unsigned int ticks = BASE_FUNC_TicksSince(queue->burstTick);
+
+    queue->running = false;
+    queue->stat.maxBurstTicks = (ticks > queue->stat.maxBurstTicks) ? ticks : queue->stat.maxBurstTicks;
+    if (!ok) {
+        FLASH_JobFinish(handle, BASE_STATUS_ERROR);
+    } else {
+        job->doneLen += queue->burstLen;
+        if (job->doneLen >= job->len) {
+            FLASH_JobFinish(handle, BASE_STATUS_OK);
+        }
+    }
+    FLASH_JobKick(handle);
+}
+
+/**
+  * @brief Queue a job and start it if the queue was idle.
+  * @param handle FLASH handle.
+  * @param job Job to copy into the queue, the id and progress are filled in.
+  * @param jobId Identifier of the queued job, may be NULL.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_BUSY if the queue is full or the flash is used directly.
+  */
+static BASE_StatusType FLASH_JobSubmit(FLASH_Handle *handle, const FLASH_Job *job, unsigned int *jobId)
+{
+    FLASH_JobQueue *queue = handle->handleEx.jobQueue;
+    FLASH_Job *slot = NULL;
+    unsigned int lock = BASE_FUNC_IntLock();
+
+    if (queue->count >= FLASH_JOB_QUEUE_LEN || (queue->count == 0 && handle->state != FLASH_STATE_READY)) {
+        BASE_FUNC_IntUnlock(lock);
+        return BASE_STATUS_BUSY;
+    }
+    slot = &queue->job[(queue->head + queue->count) % FLASH_JOB_QUEUE_LEN];
+    *slot = *job;
+    slot->id = queue->nextId;
+    slot->doneLen = 0;
+    slot->submitTick = DCL_SYSTICK_GetTick();
+    queue->nextId = (queue->nextId == 0xFFFFFFFFU) ? 1 : queue->nextId + 1; /* Skip FLASH_JOB_ID_NONE. */
+    queue->count++;
+    queue->stat.maxQueueDepth = (queue->count > queue->stat.maxQueueDepth) ? queue->count :
+                                queue->stat.maxQueueDepth;
+    if (queue->count == 1) {
+        /* Claim the handle now, so that direct HAL_FLASH_WriteIT() calls are refused until the queue drains. */
+        handle->state = (job->type == FLASH_JOB_WRITE) ? FLASH_STATE_PGM : FLASH_STATE_ERASE;
+    }
+    if (jobId != NULL) {
+        *jobId = slot->id;
+    }
+    FLASH_JobKick(handle);
+    BASE_FUNC_IntUnlock(lock);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Attach a job queue to a flash handle.
+  * @param handle FLASH handle, initialized in interrupt mode.
+  * @param queue Job queue.
+  * @param startMode Burst start mode.
+  * @param burstMax Largest program burst in bytes, multiple of 16 from 16 to 256. Smaller bursts keep each flash
+  *        stall within the idle part of a carrier period.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR.
+  */
+BASE_StatusType HAL_FLASH_JobInitEx(FLASH_Handle *handle, FLASH_JobQueue *queue, FLASH_JobStartMode startMode,
+                                    unsigned int burstMax)
+{
+    FLASH_ASSERT_PARAM(handle != NULL);
+    FLASH_ASSERT_PARAM(queue != NULL);
+    FLASH_ASSERT_PARAM(IsEFCInstance(handle->baseAddress));
+    FLASH_PARAM_CHECK_WITH_RET(handle->peMode == FLASH_PE_OP_IT, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(handle->state == FLASH_STATE_READY, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(startMode == FLASH_JOB_START_NOW || startMode == FLASH_JOB_START_WINDOW,
+                               BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(burstMax >= FLASH_MIN_PGM_BYTES_SIZE && burstMax <= FLASH_MAX_PGM_BYTE_SIZE,
+                               BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET((burstMax % FLASH_MIN_PGM_BYTES_SIZE) == 0, BASE_STATUS_ERROR);
+
+    queue->head = 0;
+    queue->count = 0;
+    queue->nextId = 1;
+    queue->startMode = startMode;
+    queue->burstMax = burstMax;
+    queue->running = false;
+    queue->waitWindow = false;
+    queue->invalidatePending = false;
+    queue->burstLen = 0;
+    queue->burstTick = 0;
+    queue->JobFinishCallBack = NULL;
+    handle->handleEx.jobQueue = queue;
+    HAL_FLASH_JobClearStatEx(handle);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Register the job completion callback.
+  * @param handle FLASH handle.
+  * @param pcallback Callback, called from the flash interrupt.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR.
+  */
+BASE_StatusType HAL_FLASH_JobRegisterCallbackEx(FLASH_Handle *handle, FLASH_JobCallbackFunType pcallback)
+{
+    FLASH_ASSERT_PARAM(handle != NULL);
+    FLASH_PARAM_CHECK_WITH_RET(handle->handleEx.jobQueue != NULL, BASE_STATUS_ERROR);
+    handle->handleEx.jobQueue->JobFinishCallBack = pcallback;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Queue a write job.
+  * @param handle FLASH handle.
+  * @param srcAddr Start address of the data buffer, which must stay valid until the job completes.
+  * @param destAddr Start address of the flash to be written, aligned with the minimum writable unit.
+  * @param srcLen Length of data to be written, unit: bytes.
+  * @param flags FLASH_JOB_FLAG_* values.
+  * @param jobId Identifier of the queued job, may be NULL.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR, BASE_STATUS_BUSY.
+  */
+BASE_StatusType HAL_FLASH_JobWriteEx(FLASH_Handle *handle, unsigned int srcAddr, unsigned int destAddr,
+                                     unsigned int srcLen, unsigned int flags, unsigned int *jobId)
+{
+    FLASH_Job job;
+    FLASH_ASSERT_PARAM(handle != NULL);
+    FLASH_ASSERT_PARAM(IsEFCInstance(handle->baseAddress));
+    FLASH_PARAM_CHECK_WITH_RET(handle->handleEx.jobQueue != NULL, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(IsFlashWriteSrcAddress(srcAddr), BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET((destAddr < FLASH_MAX_SIZE), BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET((destAddr % FLASH_MIN_PGM_BYTES_SIZE) == 0, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(srcLen > 0, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(srcLen <= (FLASH_MAX_SIZE - destAddr), BASE_STATUS_ERROR);
+
+    job.type = FLASH_JOB_WRITE;
+    job.flags = flags;
+    job.srcAddr = srcAddr;
+    job.destAddr = destAddr;
+    job.len = srcLen;
+    return FLASH_JobSubmit(handle, &job, jobId);
+}
+
+/**
+  * @brief Queue a page erase job.
+  * @param handle FLASH handle.
+  * @param startAddr Start address of the flash to be erased, page aligned.
+  * @param eraseNum Number of pages to be erased.
+  * @param flags FLASH_JOB_FLAG_* values.
+  * @param jobId Identifier of the queued job, may be NULL.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR, BASE_STATUS_BUSY.
+  */
+BASE_StatusType HAL_FLASH_JobEraseEx(FLASH_Handle *handle, FLASH_SectorAddr startAddr, unsigned int eraseNum,
+                                     unsigned int flags, unsigned int *jobId)
+{
+    FLASH_Job job;
+    FLASH_ASSERT_PARAM(handle != NULL);
+    FLASH_ASSERT_PARAM(IsEFCInstance(handle->baseAddress));
+    FLASH_PARAM_CHECK_WITH_RET(handle->handleEx.jobQueue != NULL, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET((startAddr <= FLASH_PAGE_MAX), BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET((startAddr % FLASH_ONE_PAGE_SIZE == 0), BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(eraseNum > 0 && eraseNum <= (FLASH_MAX_PAGE_NUM - startAddr / FLASH_ONE_PAGE_SIZE),\
+                               BASE_STATUS_ERROR);
+
+    job.type = FLASH_JOB_ERASE;
+    job.flags = flags;
+    job.srcAddr = 0;
+    job.destAddr = startAddr;
+    job.len = eraseNum;
+    return FLASH_JobSubmit(handle, &job, jobId);
+}
+
+/**
+  * @brief Signal a start window: start the burst held back in FLASH_JOB_START_WINDOW mode. Call it from the carrier
+  *        interrupt after the control loop, so that the flash stall falls into the rest of the period.
+  * @param handle FLASH handle.
+  * @retval None.
+  */
+void HAL_FLASH_JobWindowEx(FLASH_Handle *handle)
+{
+    FLASH_JobQueue *queue = NULL;
+    unsigned int lock;
+    FLASH_ASSERT_PARAM(handle != NULL);
+    queue = handle->handleEx.jobQueue;
+    if (queue == NULL || !queue->waitWindow) {
+        return;
+    }
+    lock = BASE_FUNC_IntLock();
+    if (queue->waitWindow && !queue->running) {
+        queue->waitWindow = false;
+        if (FLASH_JobStartBurst(handle) != BASE_STATUS_OK) {
+            FLASH_JobFinish(handle, BASE_STATUS_ERROR);
+            FLASH_JobKick(handle);
+        }
+    }
+    BASE_FUNC_IntUnlock(lock);
+}
+
+/**
+  * @brief Get the progress of a queued job.
+  * @param handle FLASH handle.
+  * @param jobId Job identifier.
+  * @param doneLen Completed length: bytes for a write, pages for an erase.
+  * @param totalLen Job length.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR if the job is no longer queued.
+  */
+BASE_StatusType HAL_FLASH_JobGetProgressEx(FLASH_Handle *handle, unsigned int jobId, unsigned int *doneLen,
+                                           unsigned int *totalLen)
+{
+    FLASH_JobQueue *queue = NULL;
+    const FLASH_Job *job = NULL;
+    BASE_StatusType ret = BASE_STATUS_ERROR;
+    unsigned int lock;
+    FLASH_ASSERT_PARAM(handle != NULL);
+    FLASH_ASSERT_PARAM(doneLen != NULL);
+    FLASH_ASSERT_PARAM(totalLen != NULL);
+    FLASH_PARAM_CHECK_WITH_RET(handle->handleEx.jobQueue != NULL, BASE_STATUS_ERROR);
+
+    queue = handle->handleEx.jobQueue;
+    lock = BASE_FUNC_IntLock();
+    for (unsigned int i = 0; i < queue->count; i++) {
+        job = &queue->job[(queue->head + i) % FLASH_JOB_QUEUE_LEN];
+        if (job->id == jobId) {
+            *doneLen = job->doneLen;
+            *totalLen = job->len;
+            ret = BASE_STATUS_OK;
+            break;
+        }
+    }
+    BASE_FUNC_IntUnlock(lock);
+    return ret;
+}
+
+/**
+  * @brief Check whether the job queue is empty.
+  * @param handle FLASH handle.
+  * @retval bool true if no job is queued.
+  */
+bool HAL_FLASH_JobIsIdleEx(const FLASH_Handle *handle)
+{
+    FLASH_ASSERT_PARAM(handle != NULL);
+    return handle->handleEx.jobQueue == NULL || handle->handleEx.jobQueue->count == 0;
+}
+
+/**
+  * @brief Get the job queue statistics.
+  * @param handle FLASH handle.
+  * @param stat Statistics.
+  * @retval None.
+  */
+void HAL_FLASH_JobGetStatEx(const FLASH_Handle *handle, FLASH_JobStat *stat)
+{
+    FLASH_ASSERT_PARAM(handle != NULL);
+    FLASH_ASSERT_PARAM(stat != NULL);
+    FLASH_PARAM_CHECK_NO_RET(handle->handleEx.jobQueue != NULL);
+    *stat = handle->handleEx.jobQueue->stat;
+}
+
+/**
+  * @brief Clear the job queue statistics.
+  * @param handle FLASH handle.
+  * @retval None.
+  */
+void HAL_FLASH_JobClearStatEx(FLASH_Handle *handle)
+{
+    FLASH_JobStat *stat = NULL;
+    FLASH_ASSERT_PARAM(handle != NULL);
+    FLASH_PARAM_CHECK_NO_RET(handle->handleEx.jobQueue != NULL);
+    stat = &handle->handleEx.jobQueue->stat;
+    stat->jobCnt = 0;
+    stat->failCnt = 0;
+    stat->burstCnt = 0;
+    stat->windowWaitCnt = 0;
+    stat->invalidateCnt = 0;
+    stat->maxQueueDepth = 0;
+    stat->maxBurstTicks = 0;
+    stat->lastJobTicks = 0;
+    stat->maxJobTicks = 0;
+    stat->sumJobTicks = 0;
+}
+
 /**
  * @brief Interrupt Processing Write.
  * @param handle FLASH handle.
@@ -688,6 +1091,12 @@ void HAL_FLASH_IrqHandler(void *handle)
 
     status = flashHandle->baseAddress->INT_RAW_STATUS.reg;
     flashHandle->baseAddress->INT_CLEAR.reg = status & FLASH_CMD_INTERRUPT_MASK;
+    if (flashHandle->handleEx.jobQueue != NULL && flashHandle->handleEx.jobQueue->running) {
+        if ((status & FLASH_INT_FINISH_MASK) > 0) {
+            FLASH_JobBurstDone(flashHandle, true);
+        }
+        return;
+    }
     /* Invoke the function for programming or erasing. */
     if (flashHandle->state == FLASH_STATE_PGM) { /* If state is FLASH_STATE_PGM, call write callback function. */
         if (flashHandle->writeLen < flashHandle->handleEx.onceOperateLen) {
@@ -728,6 +1137,13 @@ void HAL_FLASH_IrqHandlerError(void *handle)
     FLASH_ASSERT_PARAM(IsEFCInstance(flashHandle->baseAddress));
     status = flashHandle->baseAddress->INT_RAW_STATUS.reg;
     flashHandle->baseAddress->INT_CLEAR.reg = status & FLASH_ERR_INTERRUPT_MASK;
+    if (flashHandle->handleEx.jobQueue != NULL && flashHandle->handleEx.jobQueue->running) {
+        if ((status & (FLASH_INT_ERR_ECC_CHK_MASK | FLASH_INT_ERR_ECC_CORR_MASK |
+                       FLASH_INT_ERR_AHB_MASK | FLASH_INT_ERR_SMWR_MASK | FLASH_INT_ERR_ILLEGAL_MASK)) > 0) {
+            FLASH_JobBurstDone(flashHandle, false);
+        }
+        return;
+    }
     
     /* If any error occurs, call the programming error or erase error callback function. */
     if ((status & (FLASH_INT_ERR_ECC_CHK_MASK | FLASH_INT_ERR_ECC_CORR_MASK |
@@ -0,0 +1,1027 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file    flash_kv.c
+  * @author  MCU Driver Team
+  * @brief   FLASH module driver.
+  * @details This file provides firmware functions to manage the following functionalities of the FLASH.
+  *          + Log-structured key-value store on top of the interrupt mode program and erase functions.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "drvcommon.h"
+#include "flash_ex.h"
+
+#define FLASH_KV_PAGE_MAGIC         0x4B565047U     /* Page header tag. */
+#define FLASH_KV_RECORD_MAGIC       0x5AA5U         /* Record header tag. */
+#define FLASH_KV_FLAG_DELETED       0x0001U         /* The record is a delete marker. */
+#define FLASH_KV_PAGE_HEAD_SIZE     FLASH_MIN_PGM_BYTES_SIZE
+#define FLASH_KV_PAGE_CRC_SPAN      12U             /* Page header bytes covered by its CRC: magic, seq, count. */
+#define FLASH_KV_RECORD_CRC_SPAN    8U              /* Record header bytes covered by its CRC: all but the CRC. */
+#define FLASH_KV_RESERVE_PAGES      1U              /* Erased pages only compaction may open. */
+#define FLASH_KV_BLANK_WORD         0xFFFFFFFFU
+
+/**
+  * @brief Record header as stored in flash, the data follows and the record is padded with 0xFF to the
+  *        minimum program unit. The CRC covers the first 8 bytes of the header and the data.
+  */
+typedef struct {
+    unsigned short magic;
+    unsigned short key;
+    unsigned short len;
+    unsigned short flags;
+    unsigned int crc;
+} FLASH_KvRecordHead;
+
+/**
+  * @brief Update the CRC-32 of the store with a byte stream.
+  * @param kv Key-value store.
+  * @param crc Running CRC, HAL_CRC_SoftStartEx() to start.
+  * @param data Bytes.
+  * @param len Number of bytes.
+  * @retval unsigned int Updated CRC, stored without HAL_CRC_SoftFinishEx(): the final value is not inverted.
+  */
+static inline unsigned int FLASH_KvCrc(const FLASH_KvStore *kv, unsigned int crc, const void *data,
+                                       unsigned int len)
+{
+    return HAL_CRC_SoftUpdateEx(kv->crc, crc, data, len);
+}
+
+/**
+  * @brief Bytes taken in flash by a record.
+  * @param len Data length.
+  * @retval unsigned int Record size, multiple of the minimum program unit.
+  */
+static inline unsigned int FLASH_KvRecordSize(unsigned int len)
+{
+    unsigned int size = FLASH_KV_RECORD_HEAD_SIZE + len;
+    return (size + FLASH_MIN_PGM_BYTES_SIZE - 1) & ~(FLASH_MIN_PGM_BYTES_SIZE - 1);
+}
+
+/**
+  * @brief CPU view of a flash address.
+  * @param addr PE address.
+  * @retval const unsigned char * Read address.
+  */
+static inline const unsigned char *FLASH_KvReadPtr(unsigned int addr)
+{
+    return (const unsigned char *)(uintptr_t)(addr + FLASH_READ_BASE);
+}
+
+/**
+  * @brief PE address of a store page.
+  * @param kv Key-value store.
+  * @param page Page number in the store.
+  * @retval unsigned int Page address.
+  */
+static inline unsigned int FLASH_KvPageAddr(const FLASH_KvStore *kv, unsigned int page)
+{
+    return kv->baseAddr + page * FLASH_ONE_PAGE_SIZE;
+}
+
+/**
+  * @brief Store page holding a flash address.
+  * @param kv Key-value store.
+  * @param addr PE address inside the store.
+  * @retval unsigned int Page number.
+  */
+static inline unsigned int FLASH_KvAddrPage(const FLASH_KvStore *kv, unsigned int addr)
+{
+    return (addr - kv->baseAddr) / FLASH_ONE_PAGE_SIZE;
+}
+
+/**
+  * @brief Check a record header read from flash or from the queue.
+  * @param head Record header.
+  * @retval bool true if the header fields are consistent.
+  */
+static bool FLASH_KvHeadValid(const FLASH_KvRecordHead *head)
+{
+    return (head->magic == FLASH_KV_RECORD_MAGIC) && (head->key < FLASH_KV_KEY_NUM) &&
+           (head->len <= FLASH_KV_DATA_MAX);
+}
+
+/**
+  * @brief Check the CRC of a complete record.
+  * @param kv Key-value store.
+  * @param record Record header, followed by its data.
+  * @retval bool true if the CRC matches.
+  */
+static bool FLASH_KvRecordValid(const FLASH_KvStore *kv, const FLASH_KvRecordHead *record)
+{
+    unsigned int crc = FLASH_KvCrc(kv, HAL_CRC_SoftStartEx(kv->crc), record, FLASH_KV_RECORD_CRC_SPAN);
+    crc = FLASH_KvCrc(kv, crc, (const unsigned char *)record + FLASH_KV_RECORD_HEAD_SIZE, record->len);
+    return crc == record->crc;
+}
+
+/**
+  * @brief Point the index of a key to a new record and move its live length between pages.
+  * @param kv Key-value store.
+  * @param key Key.
+  * @param addr Address of the new record, FLASH_KV_ADDR_NONE to drop the key.
+  * @param len Data length of the new record.
+  * @param deleted The new record is a delete marker.
+  * @retval None.
+  */
+static void FLASH_KvIndexSet(FLASH_KvStore *kv, unsigned int key, unsigned int addr, unsigned int len, bool deleted)
+{
+    FLASH_KvIndex *entry = &kv->index[key];
+    if (entry->addr != FLASH_KV_ADDR_NONE) {
+        kv->page[FLASH_KvAddrPage(kv, entry->addr)].liveLen -= FLASH_KvRecordSize(entry->len);
+    }
+    entry->addr = addr;
+    entry->len = (unsigned short)len;
+    entry->deleted = deleted ? 1 : 0;
+    if (addr != FLASH_KV_ADDR_NONE) {
+        kv->page[FLASH_KvAddrPage(kv, addr)].liveLen += FLASH_KvRecordSize(len);
+    }
+}
+
+/**
+  * @brief Classify a page from its header and build its RAM copy.
+  * @param kv Key-value store.
+  * @param page Page number in the store.
+  * @retval None.
+  */
+static void FLASH_KvPageLoad(FLASH_KvStore *kv, unsigned int page)
+{
+    const unsigned int *head = (const unsigned int *)(const void *)FLASH_KvReadPtr(FLASH_KvPageAddr(kv, page));
+    FLASH_KvPage *info = &kv->page[page];
+    unsigned int i;
+
+    info->usedLen = 0;
+    info->liveLen = 0;
+    info->seq = 0;
+    info->eraseCnt = 0;
+    if (head[0] == FLASH_KV_PAGE_MAGIC &&
+        FLASH_KvCrc(kv, HAL_CRC_SoftStartEx(kv->crc), head, FLASH_KV_PAGE_CRC_SPAN) == head[3]) { /* 3: CRC */
+        info->state = FLASH_KV_PAGE_ACTIVE;
+        info->seq = head[1];
+        info->eraseCnt = head[2];
+        info->usedLen = FLASH_KV_PAGE_HEAD_SIZE;
+        return;
+    }
+    /* Without a valid header the page must be blank, anything else is left by an interrupted erase or open. */
+    info->state = FLASH_KV_PAGE_ERASED;
+    for (i = 0; i < FLASH_ONE_PAGE_WORD_SIZE; i++) {
+        if (head[i] != FLASH_KV_BLANK_WORD) {
+            info->state = FLASH_KV_PAGE_DIRTY;
+            break;
+        }
+    }
+}
+
+/**
+  * @brief Replay the records of an active page into the index.
+  * @param kv Key-value store.
+  * @param page Page number in the store.
+  * @retval None.
+  */
+static void FLASH_KvPageReplay(FLASH_KvStore *kv, unsigned int page)
+{
+    unsigned int pageAddr = FLASH_KvPageAddr(kv, page);
+    unsigned int offset = FLASH_KV_PAGE_HEAD_SIZE;
+    const FLASH_KvRecordHead *record = NULL;
+    unsigned int size;
+
+    while (offset + FLASH_MIN_PGM_BYTES_SIZE <= FLASH_ONE_PAGE_SIZE) {
+        record = (const FLASH_KvRecordHead *)(const void *)FLASH_KvReadPtr(pageAddr + offset);
+        if (*(const unsigned int *)(const void *)record == FLASH_KV_BLANK_WORD) {
+            break; /* End of the log in this page. */
+        }
+        size = FLASH_KvRecordSize(record->len);
+        if (!FLASH_KvHeadValid(record) || offset + size > FLASH_ONE_PAGE_SIZE) {
+            /* The header itself is damaged, nothing after it can be located: close the page. */
+            kv->stat.crcErrCnt++;
+            offset = FLASH_ONE_PAGE_SIZE;
+            break;
+        }
+        if (FLASH_KvRecordValid(kv, record)) {
+            FLASH_KvIndexSet(kv, record->key, pageAddr + offset, record->len,
+                             (record->flags & FLASH_KV_FLAG_DELETED) != 0);
+        } else {
+            kv->stat.crcErrCnt++; /* Torn by a power failure, the space is skipped. */
+        }
+        offset += size;
+    }
+    kv->page[page].usedLen = offset;
+}
+
+/**
+  * @brief Scan the store pages and build the index, pages are replayed in opening order.
+  * @param kv Key-value store.
+  * @retval None.
+  */
+static void FLASH_KvScan(FLASH_KvStore *kv)
+{
+    unsigned int order[FLASH_KV_PAGE_NUM_MAX];
+    unsigned int orderNum = 0;
+    unsigned int maxErase = 0;
+    unsigned int i;
+    unsigned int j;
+
+    for (i = 0; i < kv->pageNum; i++) {
+        FLASH_KvPageLoad(kv, i);
+        if (kv->page[i].state != FLASH_KV_PAGE_ACTIVE) {
+            continue;
+        }
+        maxErase = (kv->page[i].eraseCnt > maxErase) ? kv->page[i].eraseCnt : maxErase;
+        /* Insertion sort by sequence number, the page count is small. */
+        for (j = orderNum; j > 0 && kv->page[order[j - 1]].seq > kv->page[i].seq; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+        orderNum++;
+    }
+    for (i = 0; i < orderNum; i++) {
+        FLASH_KvPageReplay(kv, order[i]);
+    }
+    if (orderNum > 0) {
+        kv->headPage = order[orderNum - 1];
+        kv->nextSeq = kv->page[kv->headPage].seq + 1;
+    }
+    /* The erase count of a blank page is lost with its header, assume the most worn value. */
+    for (i = 0; i < kv->pageNum; i++) {
+        if (kv->page[i].state != FLASH_KV_PAGE_ACTIVE) {
+            kv->page[i].eraseCnt = maxErase;
+        }
+        if (kv->page[i].state == FLASH_KV_PAGE_ERASED) {
+            kv->erasedNum++;
+        }
+    }
+}
+
+/**
+  * @brief Reserve contiguous queue space for a record.
+  * @param kv Key-value store.
+  * @param size Record size.
+  * @retval unsigned int Byte offset in the queue, FLASH_KV_ADDR_NONE if the queue is full.
+  */
+static unsigned int FLASH_KvQueueAlloc(FLASH_KvStore *kv, unsigned int size)
+{
+    unsigned int pos;
+    if (kv->queueUsed == 0) {
+        kv->queueHead = 0;
+        kv->queueTail = 0;
+        kv->queueWrap = 0;
+    }
+    if (kv->queueWrap == 0) {
+        /* Records lie in [head, tail): use the end of the buffer, or wrap to the start. */
+        if (FLASH_KV_QUEUE_SIZE - kv->queueTail >= size) {
+            pos = kv->queueTail;
+        } else if (kv->queueHead >= size) {
+            kv->queueWrap = kv->queueTail;
+            pos = 0;
+        } else {
+            return FLASH_KV_ADDR_NONE;
+        }
+    } else if (kv->queueHead - kv->queueTail >= size) {
+        /* Records lie in [head, wrap) and [0, tail). */
+        pos = kv->queueTail;
+    } else {
+        return FLASH_KV_ADDR_NONE;
+    }
+    kv->queueTail = pos + size;
+    kv->queueUsed += size;
+    return pos;
+}
+
+/**
+  * @brief Release the oldest queued record.
+  * @param kv Key-value store.
+  * @param size Record size.
+  * @retval None.
+  */
+static void FLASH_KvQueuePop(FLASH_KvStore *kv, unsigned int size)
+{
+    kv->queueHead += size;
+    kv->queueUsed -= size;
+    if (kv->queueWrap != 0 && kv->queueHead == kv->queueWrap) {
+        kv->queueHead = 0;
+        kv->queueWrap = 0;
+    }
+}
+
+/**
+  * @brief Queued record at a byte offset.
+  * @param kv Key-value store.
+  * @param pos Byte offset in the queue.
+  * @retval FLASH_KvRecordHead * Record.
+  */
+static inline FLASH_KvRecordHead *FLASH_KvQueueRecord(FLASH_KvStore *kv, unsigned int pos)
+{
+    return (FLASH_KvRecordHead *)(void *)((unsigned char *)kv->queue + pos);
+}
+
+/**
+  * @brief Newest queued record of a key.
+  * @param kv Key-value store.
+  * @param key Key.
+  * @retval FLASH_KvRecordHead * Record, NULL if the key has no queued record.
+  */
+static FLASH_KvRecordHead *FLASH_KvQueueFind(FLASH_KvStore *kv, unsigned int key)
+{
+    FLASH_KvRecordHead *found = NULL;
+    FLASH_KvRecordHead *record = NULL;
+    unsigned int pos = kv->queueHead;
+    unsigned int left = kv->queueUsed;
+    unsigned int size;
+
+    while (left > 0) {
+        if (kv->queueWrap != 0 && pos == kv->queueWrap) {
+            pos = 0;
+        }
+        record = FLASH_KvQueueRecord(kv, pos);
+        if (record->key == key) {
+            found = record;
+        }
+        size = FLASH_KvRecordSize(record->len);
+        pos += size;
+        left -= size;
+    }
+    return found;
+}
+
+/**
+  * @brief Check that the head page can take a record.
+  * @param kv Key-value store.
+  * @param size Record size.
+  * @retval bool true if the record fits.
+  */
+static bool FLASH_KvHeadRoom(const FLASH_KvStore *kv, unsigned int size)
+{
+    if (kv->headPage == FLASH_KV_PAGE_NONE) {
+        return false;
+    }
+    return kv->page[kv->headPage].usedLen + size <= FLASH_ONE_PAGE_SIZE;
+}
+
+/**
+  * @brief Start programming a buffer into the store.
+  * @param kv Key-value store.
+  * @param op Operation type.
+  * @param src RAM source.
+  * @param addr Flash destination.
+  * @param size Bytes.
+  * @retval bool true if the operation started.
+  */
+static bool FLASH_KvProgram(FLASH_KvStore *kv, FLASH_KvOpType op, const void *src, unsigned int addr,
+                            unsigned int size)
+{
+    BASE_StatusType ret;
+    kv->op = op;
+    kv->opAddr = addr;
+    kv->opPage = FLASH_KvAddrPage(kv, addr);
+    /* With a job queue attached the write is queued behind the other jobs, the direct call would be refused. */
+    if (kv->flash->handleEx.jobQueue != NULL) {
+        ret = HAL_FLASH_JobWriteEx(kv->flash, (uintptr_t)src, addr, size, 0, NULL);
+    } else {
+        ret = HAL_FLASH_WriteIT(kv->flash, (uintptr_t)src, addr, size);
+    }
+    if (ret != BASE_STATUS_OK) {
+        kv->op = FLASH_KV_OP_IDLE;
+        kv->stat.failCnt++;
+        return false;
+    }
+    return true;
+}
+
+/**
+  * @brief Start erasing a store page.
+  * @param kv Key-value store.
+  * @param page Page number in the store.
+  * @retval bool true if the operation started.
+  */
+static bool FLASH_KvErase(FLASH_KvStore *kv, unsigned int page)
+{
+    BASE_StatusType ret;
+    kv->op = FLASH_KV_OP_ERASE;
+    kv->opPage = page;
+    kv->opAddr = FLASH_KvPageAddr(kv, page);
+    if (kv->flash->handleEx.jobQueue != NULL) {
+        ret = HAL_FLASH_JobEraseEx(kv->flash, (FLASH_SectorAddr)kv->opAddr, 1, 0, NULL);
+    } else {
+        ret = HAL_FLASH_EraseIT(kv->flash, FLASH_ERASE_MODE_PAGE, (FLASH_SectorAddr)kv->opAddr, 1);
+    }
+    if (ret != BASE_STATUS_OK) {
+        kv->op = FLASH_KV_OP_IDLE;
+        kv->stat.failCnt++;
+        return false;
+    }
+    return true;
+}
+
+/**
+  * @brief Open the least worn erased page as the new head page.
+  * @param kv Key-value store.
+  * @retval bool true if the page header program started.
+  */
+static bool FLASH_KvOpenPage(FLASH_KvStore *kv)
+{
+    unsigned int page = FLASH_KV_PAGE_NONE;
+    for (unsigned int i = 0; i < kv->pageNum; i++) {
+        if (kv->page[i].state == FLASH_KV_PAGE_ERASED &&
+            (page == FLASH_KV_PAGE_NONE || kv->page[i].eraseCnt < kv->page[page].eraseCnt)) {
+            page = i;
+        }
+    }
+    if (page == FLASH_KV_PAGE_NONE) {
+        return false;
+    }
+    kv->copyBuf[0] = FLASH_KV_PAGE_MAGIC;
+    kv->copyBuf[1] = kv->nextSeq;
+    kv->copyBuf[2] = kv->page[page].eraseCnt; /* 2: erase count word */
+    kv->copyBuf[3] = FLASH_KvCrc(kv, HAL_CRC_SoftStartEx(kv->crc), kv->copyBuf, /* 3: CRC word */
+                                 FLASH_KV_PAGE_CRC_SPAN);
+    return FLASH_KvProgram(kv, FLASH_KV_OP_PAGE_HEAD, kv->copyBuf, FLASH_KvPageAddr(kv, page),
+                           FLASH_KV_PAGE_HEAD_SIZE);
+}
+
+/**
+  * @brief Bytes a compaction of a page gives back.
+  * @param kv Key-value store.
+  * @param page Page number in the store.
+  * @retval unsigned int Reclaimable bytes.
+  */
+static unsigned int FLASH_KvReclaimLen(const FLASH_KvStore *kv, unsigned int page)
+{
+    /* The unused end of a closed page is lost as well, the end of the head page is still usable. */
+    unsigned int end = (page == kv->headPage) ? kv->page[page].usedLen : FLASH_ONE_PAGE_SIZE;
+    return end - FLASH_KV_PAGE_HEAD_SIZE - kv->page[page].liveLen;
+}
+
+/**
+  * @brief Choose the page to compact.
+  * @param kv Key-value store.
+  * @param wear Choose the least worn page instead of the one with the most reclaimable space.
+  * @param need Least reclaimable bytes that make a space compaction worth its erase.
+  * @retval unsigned int Page number, FLASH_KV_PAGE_NONE if no page is worth compacting.
+  */
+static unsigned int FLASH_KvSelectVictim(const FLASH_KvStore *kv, bool wear, unsigned int need)
+{
+    unsigned int victim = FLASH_KV_PAGE_NONE;
+    unsigned int best = 0;
+    unsigned int value;
+
+    for (unsigned int i = 0; i < kv->pageNum; i++) {
+        if (kv->page[i].state != FLASH_KV_PAGE_ACTIVE) {
+            continue;
+        }
+        if (wear) {
+            /* The head is still filling, its wear does not matter yet. */
+            if (i == kv->headPage ||
+                kv->page[i].eraseCnt + FLASH_KV_WEAR_SPREAD_MAX >= kv->stat.maxPageErase ||
+                (victim != FLASH_KV_PAGE_NONE && kv->page[i].eraseCnt >= kv->page[victim].eraseCnt)) {
+                continue;
+            }
+            victim = i;
+            continue;
+        }
+        value = FLASH_KvReclaimLen(kv, i);
+        if (value < need || value < best ||
+            (value == best && victim != FLASH_KV_PAGE_NONE && kv->page[i].seq > kv->page[victim].seq)) {
+            continue;
+        }
+        best = value;
+        victim = i;
+    }
+    return victim;
+}
+
+/**
+  * @brief Oldest active page.
+  * @param kv Key-value store.
+  * @param page Page number to check.
+  * @retval bool true if no active page was opened before it.
+  */
+static bool FLASH_KvIsOldest(const FLASH_KvStore *kv, unsigned int page)
+{
+    for (unsigned int i = 0; i < kv->pageNum; i++) {
+        if (kv->page[i].state == FLASH_KV_PAGE_ACTIVE && kv->page[i].seq < kv->page[page].seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+  * @brief Advance the compaction: move the next live record of the victim, or erase it when none is left.
+  * @param kv Key-value store.
+  * @retval bool true if a flash operation started.
+  */
+static bool FLASH_KvCompactStep(FLASH_KvStore *kv)
+{
+    unsigned int pageAddr = FLASH_KvPageAddr(kv, kv->victimPage);
+    const FLASH_KvRecordHead *record = NULL;
+    const unsigned int *src = NULL;
+    unsigned int size;
+    unsigned int i;
+
+    while (kv->victimOffset < kv->page[kv->victimPage].usedLen) {
+        record = (const FLASH_KvRecordHead *)(const void *)FLASH_KvReadPtr(pageAddr + kv->victimOffset);
+        if (*(const unsigned int *)(const void *)record == FLASH_KV_BLANK_WORD || !FLASH_KvHeadValid(record)) {
+            break;
+        }
+        size = FLASH_KvRecordSize(record->len);
+        if (kv->index[record->key].addr != pageAddr + kv->victimOffset) {
+            kv->victimOffset += size; /* Superseded or torn. */
+            continue;
+        }
+        if (kv->index[record->key].deleted != 0 && FLASH_KvIsOldest(kv, kv->victimPage)) {
+            /* No older record of the key can exist, the delete marker has done its job. */
+            FLASH_KvIndexSet(kv, record->key, FLASH_KV_ADDR_NONE, 0, false);
+            kv->victimOffset += size;
+            continue;
+        }
+        if (kv->headPage == kv->victimPage || !FLASH_KvHeadRoom(kv, size)) {
+            /* A full head page is compacted into the next one, which may be the reserve. */
+            if (kv->erasedNum == 0 || !FLASH_KvOpenPage(kv)) {
+                kv->victimPage = FLASH_KV_PAGE_NONE; /* Out of pages, give up until space is freed. */
+                return false;
+            }
+            return true;
+        }
+        src = (const unsigned int *)(const void *)record;
+        for (i = 0; i < size / FLASH_ONE_WORD_BYTES_SIZE; i++) {
+            kv->copyBuf[i] = src[i];
+        }
+        return FLASH_KvProgram(kv, FLASH_KV_OP_COPY, kv->copyBuf,
+                               FLASH_KvPageAddr(kv, kv->headPage) + kv->page[kv->headPage].usedLen, size);
+    }
+    return FLASH_KvErase(kv, kv->victimPage);
+}
+
+/**
+  * @brief Drop the oldest queued record and report it.
+  * @param kv Key-value store.
+  * @param status Reported status.
+  * @retval None.
+  */
+static void FLASH_KvQueueDrop(FLASH_KvStore *kv, BASE_StatusType status)
+{
+    FLASH_KvRecordHead *record = FLASH_KvQueueRecord(kv, kv->queueHead);
+    unsigned int key = record->key;
+    FLASH_KvQueuePop(kv, FLASH_KvRecordSize(record->len));
+    if (kv->WriteFinishCallBack != NULL) {
+        kv->WriteFinishCallBack(kv, key, status);
+    }
+}
+
+/**
+  * @brief Choose and start the next flash operation.
+  * @param kv Key-value store.
+  * @retval bool true if the caller should look for more work, false when nothing can be started.
+  */
+static bool FLASH_KvStep(FLASH_KvStore *kv)
+{
+    FLASH_KvRecordHead *record = NULL;
+    unsigned int size = 0;
+    unsigned int i;
+
+    /* Erase pages left dirty by a power failure first, they give back free space. */
+    for (i = 0; i < kv->pageNum; i++) {
+        if (kv->page[i].state == FLASH_KV_PAGE_DIRTY) {
+            return FLASH_KvErase(kv, i);
+        }
+    }
+    /* A running compaction goes first, the pages it opens must not fill up with new records. */
+    if (kv->victimPage != FLASH_KV_PAGE_NONE) {
+        return FLASH_KvCompactStep(kv);
+    }
+    if (kv->queueUsed > 0) {
+        record = FLASH_KvQueueRecord(kv, kv->queueHead);
+        size = FLASH_KvRecordSize(record->len);
+        if (FLASH_KvHeadRoom(kv, size)) {
+            return FLASH_KvProgram(kv, FLASH_KV_OP_RECORD, record,
+                                   FLASH_KvPageAddr(kv, kv->headPage) + kv->page[kv->headPage].usedLen, size);
+        }
+        if (kv->erasedNum > FLASH_KV_RESERVE_PAGES) {
+            return FLASH_KvOpenPage(kv);
+        }
+    }
+    if (kv->erasedNum <= FLASH_KV_RESERVE_PAGES) {
+        /* A waiting record needs its own size back, a background compaction at least one program row. */
+        kv->victimPage = FLASH_KvSelectVictim(kv, false, (size != 0) ? size : FLASH_MAX_PGM_BYTE_SIZE);
+    } else if (kv->queueUsed == 0) {
+        kv->victimPage = FLASH_KvSelectVictim(kv, true, 0); /* Idle: level the wear. */
+    }
+    kv->victimOffset = FLASH_KV_PAGE_HEAD_SIZE;
+    if (kv->victimPage != FLASH_KV_PAGE_NONE) {
+        return FLASH_KvCompactStep(kv);
+    }
+    if (kv->queueUsed > 0) {
+        /* No page can be opened and nothing can be reclaimed. */
+        kv->stat.storeFullCnt++;
+        FLASH_KvQueueDrop(kv, BASE_STATUS_ERROR);
+        return true;
+    }
+    return false;
+}
+
+/**
+  * @brief Start flash operations until one is running or nothing is left to do. Called with the lock held.
+  * @param kv Key-value store.
+  * @retval None.
+  */
+static void FLASH_KvRun(FLASH_KvStore *kv)
+{
+    while (kv->op == FLASH_KV_OP_IDLE && FLASH_KvStep(kv)) {
+        ;
+    }
+}
+
+/**
+  * @brief Complete a record program.
+  * @param kv Key-value store.
+  * @param ok The program succeeded.
+  * @retval None.
+  */
+static void FLASH_KvRecordDone(FLASH_KvStore *kv, bool ok)
+{
+    FLASH_KvRecordHead *record = FLASH_KvQueueRecord(kv, kv->queueHead);
+    unsigned int size = FLASH_KvRecordSize(record->len);
+    FLASH_KvPage *page = &kv->page[kv->opPage];
+
+    if (!ok) {
+        page->usedLen = FLASH_ONE_PAGE_SIZE; /* Partly programmed space cannot be reused, close the page. */
+        FLASH_KvQueueDrop(kv, BASE_STATUS_ERROR);
+        return;
+    }
+    page->usedLen += size;
+    FLASH_KvIndexSet(kv, record->key, kv->opAddr, record->len, (record->flags & FLASH_KV_FLAG_DELETED) != 0);
+    kv->stat.writeCnt++;
+    FLASH_KvQueueDrop(kv, BASE_STATUS_OK);
+}
+
+/**
+  * @brief Complete the current flash operation.
+  * @param kv Key-value store.
+  * @param ok The operation succeeded.
+  * @retval None.
+  */
+static void FLASH_KvOpDone(FLASH_KvStore *kv, bool ok)
+{
+    FLASH_KvPage *page = &kv->page[kv->opPage];
+    const FLASH_KvRecordHead *record = (const FLASH_KvRecordHead *)(const void *)kv->copyBuf;
+    FLASH_KvOpType op = kv->op;
+
+    kv->op = FLASH_KV_OP_IDLE;
+    kv->stat.failCnt += ok ? 0 : 1;
+    switch (op) {
+        case FLASH_KV_OP_RECORD:
+            FLASH_KvRecordDone(kv, ok);
+            break;
+        case FLASH_KV_OP_PAGE_HEAD:
+            kv->erasedNum--;
+            if (!ok) {
+                page->state = FLASH_KV_PAGE_DIRTY;
+                break;
+            }
+            page->state = FLASH_KV_PAGE_ACTIVE;
+            page->seq = kv->nextSeq++;
+            page->usedLen = FLASH_KV_PAGE_HEAD_SIZE;
+            page->liveLen = 0;
+            kv->headPage = kv->opPage;
+            break;
+        case FLASH_KV_OP_COPY:
+            if (!ok) {
+                page->usedLen = FLASH_ONE_PAGE_SIZE; /* Retried in the next page. */
+                break;
+            }
+            page->usedLen += FLASH_KvRecordSize(record->len);
+            kv->victimOffset += FLASH_KvRecordSize(record->len);
+            FLASH_KvIndexSet(kv, record->key, kv->opAddr, record->len, (record->flags & FLASH_KV_FLAG_DELETED) != 0);
+            kv->stat.copyCnt++;
+            break;
+        case FLASH_KV_OP_ERASE:
+            if (kv->opPage == kv->victimPage) {
+                kv->victimPage = FLASH_KV_PAGE_NONE;
+                kv->stat.compactCnt += ok ? 1 : 0;
+            }
+            if (kv->opPage == kv->headPage) {
+                kv->headPage = FLASH_KV_PAGE_NONE;
+            }
+            page->usedLen = 0;
+            page->liveLen = 0;
+            page->seq = 0;
+            if (!ok) {
+                page->state = FLASH_KV_PAGE_BAD;
+                break;
+            }
+            page->state = FLASH_KV_PAGE_ERASED;
+            page->eraseCnt++;
+            kv->erasedNum++;
+            kv->stat.eraseCnt++;
+            kv->stat.maxPageErase = (page->eraseCnt > kv->stat.maxPageErase) ? page->eraseCnt :
+                                    kv->stat.maxPageErase;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+  * @brief Flash event callback owned by the store, runs in the flash interrupt.
+  * @param handle FLASH handle.
+  * @param event Flash event.
+  * @param opAddr Current operation address, the destination of the finished job when a job queue is attached.
+  * @retval None.
+  */
+static void FLASH_KvFlashCallback(void *handle, FLASH_CallBackEvent event, unsigned int opAddr)
+{
+    FLASH_Handle *flash = (FLASH_Handle *)handle;
+    FLASH_KvStore *kv = flash->handleEx.kvStore;
+    if (kv == NULL || kv->op == FLASH_KV_OP_IDLE) {
+        return;
+    }
+    /* Jobs queued by other users of the flash end here too, only the one of the store is taken. */
+    if (flash->handleEx.jobQueue != NULL && opAddr != kv->opAddr) {
+        return;
+    }
+    switch (event) {
+        case FLASH_WRITE_EVENT_DONE:
+        case FLASH_ERASE_EVENT_DONE:
+            FLASH_KvOpDone(kv, true);
+            break;
+        case FLASH_WRITE_EVENT_FAIL:
+        case FLASH_ERASE_EVENT_FAIL: /* The driver returns to ready without a done event. */
+            FLASH_KvOpDone(kv, false);
+            break;
+        default:
+            return;
+    }
+    FLASH_KvRun(kv);
+}
+
+/**
+  * @brief Mount a key-value store: scan its pages, build the index and take over the flash callback.
+  * @param kv Key-value store.
+  * @param flash FLASH handle, initialized in interrupt mode with HAL_FLASH_IrqHandler() and
+  *        HAL_FLASH_IrqHandlerError() registered. The store owns the flash callback from now on. When a job
+  *        queue is attached by HAL_FLASH_JobInitEx(), the store programs and erases through it and can share
+  *        the handle with other jobs, otherwise it owns the handle.
+  * @param crc Software CRC initialized by HAL_CRC_SoftInitEx() with CRC32, any slice number. It may be shared with
+  *        other users and must stay valid while the store is used.
+  * @param baseAddr PE address of the first page, page aligned.
+  * @param pageNum Number of pages, 2 to FLASH_KV_PAGE_NUM_MAX.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR.
+  */
+BASE_StatusType HAL_FLASH_KvInitEx(FLASH_KvStore *kv, FLASH_Handle *flash, const CRC_SoftHandle *crc,
+                                   unsigned int baseAddr, unsigned int pageNum)
+{
+    unsigned int lock;
+    unsigned int i;
+    FLASH_ASSERT_PARAM(kv != NULL);
+    FLASH_ASSERT_PARAM(flash != NULL);
+    FLASH_ASSERT_PARAM(crc != NULL);
+    FLASH_ASSERT_PARAM(IsEFCInstance(flash->baseAddress));
+    FLASH_PARAM_CHECK_WITH_RET(flash->peMode == FLASH_PE_OP_IT, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(flash->state == FLASH_STATE_READY, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(crc->algoMode == CRC32, BASE_STATUS_ERROR); /* The store format uses CRC-32. */
+    FLASH_PARAM_CHECK_WITH_RET((baseAddr % FLASH_ONE_PAGE_SIZE) == 0, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(pageNum >= 2 && pageNum <= FLASH_KV_PAGE_NUM_MAX, BASE_STATUS_ERROR); /* 2 pages */
+    FLASH_PARAM_CHECK_WITH_RET(baseAddr < FLASH_MAX_SIZE, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(pageNum <= (FLASH_MAX_SIZE - baseAddr) / FLASH_ONE_PAGE_SIZE, BASE_STATUS_ERROR);
+
+    kv->flash = flash;
+    kv->crc = crc;
+    kv->baseAddr = baseAddr;
+    kv->pageNum = pageNum;
+    kv->headPage = FLASH_KV_PAGE_NONE;
+    kv->nextSeq = 1;
+    kv->erasedNum = 0;
+    kv->victimPage = FLASH_KV_PAGE_NONE;
+    kv->victimOffset = 0;
+    kv->op = FLASH_KV_OP_IDLE;
+    kv->queueHead = 0;
+    kv->queueTail = 0;
+    kv->queueWrap = 0;
+    kv->queueUsed = 0;
+    kv->WriteFinishCallBack = NULL;
+    kv->stat.writeCnt = 0;
+    kv->stat.copyCnt = 0;
+    kv->stat.compactCnt = 0;
+    kv->stat.eraseCnt = 0;
+    kv->stat.queueFullCnt = 0;
+    kv->stat.storeFullCnt = 0;
+    kv->stat.failCnt = 0;
+    kv->stat.crcErrCnt = 0;
+    for (i = 0; i < FLASH_KV_KEY_NUM; i++) {
+        kv->index[i].addr = FLASH_KV_ADDR_NONE;
+        kv->index[i].len = 0;
+        kv->index[i].deleted = 0;
+    }
+    FLASH_KvScan(kv);
+    kv->stat.maxPageErase = 0;
+    for (i = 0; i < pageNum; i++) {
+        kv->stat.maxPageErase = (kv->page[i].eraseCnt > kv->stat.maxPageErase) ? kv->page[i].eraseCnt :
+                                kv->stat.maxPageErase;
+    }
+
+    flash->handleEx.kvStore = kv;
+    HAL_FLASH_RegisterCallback(flash, FLASH_KvFlashCallback);
+    lock = BASE_FUNC_IntLock();
+    FLASH_KvRun(kv);
+    BASE_FUNC_IntUnlock(lock);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Register the record completion callback, called from the flash interrupt.
+  * @param kv Key-value store.
+  * @param pcallback Callback, status BASE_STATUS_ERROR means the record was dropped.
+  * @retval BASE_StatusType: BASE_STATUS_OK.
+  */
+BASE_StatusType HAL_FLASH_KvRegisterCallbackEx(FLASH_KvStore *kv, FLASH_KvCallbackFunType pcallback)
+{
+    FLASH_ASSERT_PARAM(kv != NULL);
+    kv->WriteFinishCallBack = pcallback;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Queue a record, the function returns before the flash is programmed.
+  * @param kv Key-value store.
+  * @param key Key, below FLASH_KV_KEY_NUM.
+  * @param data Value.
+  * @param len Value length, at most FLASH_KV_DATA_MAX bytes.
+  * @param flags Record flags.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_BUSY if the queue is full.
+  */
+static BASE_StatusType FLASH_KvQueueRecordAdd(FLASH_KvStore *kv, unsigned int key, const unsigned char *data,
+                                              unsigned int len, unsigned int flags)
+{
+    FLASH_KvRecordHead head;
+    FLASH_KvRecordHead *record = NULL;
+    unsigned char *dst = NULL;
+    unsigned int size = FLASH_KvRecordSize(len);
+    unsigned int lock;
+    unsigned int pos;
+    unsigned int i;
+
+    head.magic = FLASH_KV_RECORD_MAGIC;
+    head.key = (unsigned short)key;
+    head.len = (unsigned short)len;
+    head.flags = (unsigned short)flags;
+    head.crc = FLASH_KvCrc(kv, HAL_CRC_SoftStartEx(kv->crc), &head, FLASH_KV_RECORD_CRC_SPAN);
+    head.crc = FLASH_KvCrc(kv, head.crc, data, len);
+
+    lock = BASE_FUNC_IntLock();
+    pos = FLASH_KvQueueAlloc(kv, size);
+    if (pos == FLASH_KV_ADDR_NONE) {
+        kv->stat.queueFullCnt++;
+        BASE_FUNC_IntUnlock(lock);
+        return BASE_STATUS_BUSY;
+    }
+    record = FLASH_KvQueueRecord(kv, pos);
+    *record = head;
+    dst = (unsigned char *)record + FLASH_KV_RECORD_HEAD_SIZE;
+    for (i = 0; i < len; i++) {
+        dst[i] = data[i];
+    }
+    for (i = FLASH_KV_RECORD_HEAD_SIZE + len; i < size; i++) {
+        ((unsigned char *)record)[i] = 0xFF; /* Erased value for the padding. */
+    }
+    FLASH_KvRun(kv);
+    BASE_FUNC_IntUnlock(lock);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Write a value. The record is queued and programmed from the flash interrupt, the completion is reported
+  *        by the callback. Reads return the new value from the moment the function returns.
+  * @param kv Key-value store.
+  * @param key Key, below FLASH_KV_KEY_NUM.
+  * @param data Value.
+  * @param len Value length, at most FLASH_KV_DATA_MAX bytes.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR, BASE_STATUS_BUSY if the queue is full.
+  */
+BASE_StatusType HAL_FLASH_KvWriteEx(FLASH_KvStore *kv, unsigned int key, const void *data, unsigned int len)
+{
+    FLASH_ASSERT_PARAM(kv != NULL);
+    FLASH_ASSERT_PARAM(data != NULL || len == 0);
+    FLASH_PARAM_CHECK_WITH_RET(key < FLASH_KV_KEY_NUM, BASE_STATUS_ERROR);
+    FLASH_PARAM_CHECK_WITH_RET(len <= FLASH_KV_DATA_MAX, BASE_STATUS_ERROR);
+    return FLASH_KvQueueRecordAdd(kv, key, (const unsigned char *)data, len, 0);
+}
+
+/**
+  * @brief Delete a key by writing a delete marker.
+  * @param kv Key-value store.
+  * @param key Key, below FLASH_KV_KEY_NUM.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR, BASE_STATUS_BUSY if the queue is full.
+  */
+BASE_StatusType HAL_FLASH_KvDeleteEx(FLASH_KvStore *kv, unsigned int key)
+{
+    FLASH_ASSERT_PARAM(kv != NULL);
+    FLASH_PARAM_CHECK_WITH_RET(key < FLASH_KV_KEY_NUM, BASE_STATUS_ERROR);
+    return FLASH_KvQueueRecordAdd(kv, key, NULL, 0, FLASH_KV_FLAG_DELETED);
+}
+
+/**
+  * @brief Read the newest value of a key, queued records included.
+  * @param kv Key-value store.
+  * @param key Key, below FLASH_KV_KEY_NUM.
+  * @param data Buffer for the value.
+  * @param buffLen Buffer size.
+  * @param len Value length.
+  * @retval BASE_StatusType: BASE_STATUS_OK, BASE_STATUS_ERROR if the key is absent or the buffer is too small.
+  */
+BASE_StatusType HAL_FLASH_KvReadEx(FLASH_KvStore *kv, unsigned int key, void *data, unsigned int buffLen,
+                                   unsigned int *len)
+{
+    const FLASH_KvRecordHead *record = NULL;
+    const unsigned char *src = NULL;
+    unsigned char *dst = (unsigned char *)data;
+    unsigned int addr;
+    unsigned int size;
+    unsigned int lock;
+    unsigned int i;
+    bool deleted = false;
+    bool moved = false;
+    FLASH_ASSERT_PARAM(kv != NULL);
+    FLASH_ASSERT_PARAM(data != NULL);
+    FLASH_ASSERT_PARAM(len != NULL);
+    FLASH_PARAM_CHECK_WITH_RET(key < FLASH_KV_KEY_NUM, BASE_STATUS_ERROR);
+
+    do {
+        lock = BASE_FUNC_IntLock();
+        record = FLASH_KvQueueFind(kv, key);
+        if (record != NULL) {
+            /* Queued records live in RAM, copy them under the lock. */
+            size = record->len;
+            if ((record->flags & FLASH_KV_FLAG_DELETED) != 0 || size > buffLen) {
+                BASE_FUNC_IntUnlock(lock);
+                return BASE_STATUS_ERROR;
+            }
+            src = (const unsigned char *)record + FLASH_KV_RECORD_HEAD_SIZE;
+            for (i = 0; i < size; i++) {
+                dst[i] = src[i];
+            }
+            BASE_FUNC_IntUnlock(lock);
+            *len = size;
+            return BASE_STATUS_OK;
+        }
+        addr = kv->index[key].addr;
+        size = kv->index[key].len;
+        deleted = (kv->index[key].deleted != 0);
+        BASE_FUNC_IntUnlock(lock);
+        if (addr == FLASH_KV_ADDR_NONE || deleted || size > buffLen) {
+            return BASE_STATUS_ERROR;
+        }
+        /* Flash is read without the lock, a write or compaction may move the record meanwhile: check and retry. */
+        src = FLASH_KvReadPtr(addr + FLASH_KV_RECORD_HEAD_SIZE);
+        for (i = 0; i < size; i++) {
+            dst[i] = src[i];
+        }
+        lock = BASE_FUNC_IntLock();
+        moved = (kv->index[key].addr != addr || FLASH_KvQueueFind(kv, key) != NULL);
+        BASE_FUNC_IntUnlock(lock);
+    } while (moved);
+    *len = size;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Check whether all queued records are programmed and no compaction is running.
+  * @param kv Key-value store.
+  * @retval bool true if idle.
+  */
+bool HAL_FLASH_KvIsIdleEx(const FLASH_KvStore *kv)
+{
+    FLASH_ASSERT_PARAM(kv != NULL);
+    return kv->op == FLASH_KV_OP_IDLE && kv->queueUsed == 0 && kv->victimPage == FLASH_KV_PAGE_NONE;
+}
+
+/**
+  * @brief Get the store statistics.
+  * @param kv Key-value store.
+  * @param stat Statistics.
+  * @retval None.
+  */
+void HAL_FLASH_KvGetStatEx(const FLASH_KvStore *kv, FLASH_KvStat *stat)
+{
+    FLASH_ASSERT_PARAM(kv != NULL);
+    FLASH_ASSERT_PARAM(stat != NULL);
+    *stat = kv->stat;
+    stat->minPageErase = kv->stat.maxPageErase;
+    for (unsigned int i = 0; i < kv->pageNum; i++) {
+        if (kv->page[i].state != FLASH_KV_PAGE_BAD && kv->page[i].eraseCnt < stat->minPageErase) {
+            stat->minPageErase = kv->page[i].eraseCnt;
+        }
+    }
+}
@@ -20,6 +20,7 @@
   * @brief     I2C module driver
   * @details   The header file contains the following declaration:
   *             + Setting the Special Function Configuration.
+  *             + Master transaction queue definition and functions.
   */
 
 #ifndef McuMagicTag_I2C_EX_H
@@ -28,11 +29,110 @@
 /* Includes ------------------------------------------------------------------*/
 #include "i2c.h"
 /* Macro definitions ---------------------------------------------------------*/
+#ifndef I2C_BUS_QUEUE_LEN
+#define I2C_BUS_QUEUE_LEN       8U      /* Transactions waiting or running. */
+#endif
+
+#ifndef I2C_BUS_POLL_NUM
+#define I2C_BUS_POLL_NUM        4U      /* Periodic polling jobs. */
+#endif
+
+#ifndef I2C_BUS_CMD_MAX
+#define I2C_BUS_CMD_MAX         64U     /* TX FIFO commands of one transaction: starts, addresses, data and stop. */
+#endif
+
+#define I2C_BUS_POLL_NONE       0xFFFFFFFFU
 /**
   * @addtogroup I2C_IP
   * @{
   */
 
+/**
+  * @defgroup I2C_BUS_Definition I2C Transaction Queue Definition
+  * @{
+  */
+
+typedef struct _I2C_BusXfer I2C_BusXfer;
+
+/**
+  * @brief Transaction completion callback, called from the I2C or DMA interrupt.
+  */
+typedef void (*I2C_BusCallbackFunType)(I2C_Handle *handle, const I2C_BusXfer *xfer, BASE_StatusType status);
+
+/**
+  * @brief Master transaction: write txLen bytes, then read rxLen bytes after a repeated start. Either length may
+  *        be zero, not both. The buffers must stay valid until the callback.
+  */
+struct _I2C_BusXfer {
+    unsigned short          devAddr;    /**< Slave device address, same format as HAL_I2C_MasterWriteDMA(). */
+    unsigned char          *txBuff;     /**< Bytes to write, e.g. a register address. */
+    unsigned int            txLen;      /**< Number of bytes to write. */
+    unsigned char          *rxBuff;     /**< Buffer for the bytes read. */
+    unsigned int            rxLen;      /**< Number of bytes to read. */
+    I2C_BusCallbackFunType  callback;   /**< Completion callback, may be NULL. */
+    void                   *param;      /**< User parameter of the callback. */
+};
+
+/**
+  * @brief Queued transaction.
+  */
+typedef struct {
+    I2C_BusXfer     xfer;           /**< Copy of the submitted transaction. */
+    unsigned int    submitTick;     /**< Systick value at submission. */
+    unsigned int    pollId;         /**< Polling job that queued it, I2C_BUS_POLL_NONE for a user submission. */
+} I2C_BusEntry;
+
+/**
+  * @brief Periodic polling job.
+  */
+typedef struct {
+    I2C_BusXfer     xfer;           /**< Transaction queued at each period. */
+    unsigned int    period;         /**< Period in HAL_I2C_BusTickEx() calls. */
+    unsigned int    countdown;      /**< Calls left before the next submission. */
+    bool            enable;         /**< Polling enabled. */
+    volatile bool   pending;        /**< The last submission is still queued or running. */
+} I2C_BusPoll;
+
+/**
+  * @brief Queue statistics, times in systick counts. Bus utilisation is busyTicks / elapsedTicks, elapsedTicks
+  *        is accumulated by HAL_I2C_BusTickEx().
+  */
+typedef struct {
+    unsigned int        xferCnt;        /**< Completed transactions, failed ones included. */
+    unsigned int        errCnt;         /**< Transactions ended by a NACK, arbitration loss, DMA error or timeout. */
+    unsigned int        timeoutCnt;     /**< Transactions aborted by the timeout check of HAL_I2C_BusTickEx(). */
+    unsigned int        queueFullCnt;   /**< Submissions refused because the queue was full. */
+    unsigned int        pollOverrunCnt; /**< Poll periods skipped because the previous poll was not done yet. */
+    unsigned int        maxQueueDepth;  /**< Highest number of queued transactions. */
+    unsigned int        maxWaitTicks;   /**< Longest time from submission to start. */
+    unsigned int        maxXferTicks;   /**< Longest time from start to completion. */
+    unsigned long long  sumWaitTicks;   /**< Sum of the times from submission to start. */
+    unsigned long long  busyTicks;      /**< Time the bus spent running transactions. */
+    unsigned long long  elapsedTicks;   /**< Time covered by the statistics. */
+} I2C_BusStat;
+
+/**
+  * @brief Master transaction queue. Each transaction is built into one TX FIFO command stream and moved by the
+  *        TX DMA channel, read data by the RX DMA channel, and the next transaction is started from the completion
+  *        interrupt, so back-to-back transfers to several devices need no task time.
+  */
+typedef struct _I2C_BusQueue {
+    I2C_BusEntry        entry[I2C_BUS_QUEUE_LEN];   /**< Transaction ring. */
+    unsigned int        head;                       /**< Oldest transaction, the running one. */
+    unsigned int        count;                      /**< Number of queued transactions. */
+    I2C_BusPoll         poll[I2C_BUS_POLL_NUM];     /**< Polling jobs. */
+    unsigned int        pollNum;                    /**< Number of polling jobs added. */
+    unsigned int        cmdBuff[I2C_BUS_CMD_MAX];   /**< TX FIFO command stream of the running transaction. */
+    volatile bool       running;                    /**< A transaction is on the bus. */
+    unsigned int        pending;                    /**< Events left before the running transaction ends. */
+    unsigned int        startTick;                  /**< Systick value when the running transaction started. */
+    unsigned int        lastTick;                   /**< Systick value at the last HAL_I2C_BusTickEx() call. */
+    I2C_BusStat         stat;                       /**< Statistics. */
+} I2C_BusQueue;
+/**
+  * @}
+  */
+
 /**
   * @defgroup I2C_EX_API_Declaration I2C HAL API EX
   * @{
@@ -46,6 +146,18 @@ BASE_StatusType HAL_I2C_SetDeviceIdAddressEnableEx(I2C_Handle *handle);
 BASE_StatusType HAL_I2C_SetStartByteEnableEx(I2C_Handle *handle);
 BASE_StatusType HAL_I2C_SetOwnAddressMaskEx(I2C_Handle *handle, unsigned int addrMask);
 BASE_StatusType HAL_I2C_SetOwnXmbAddressMaskEx(I2C_Handle *handle, unsigned int addrMask);
+
+/* The transaction queue needs the I2C handle in master mode with a DMA handle and two DMA channels. The queue is
+   run from HAL_I2C_IrqHandler() and the DMA interrupt, blocking, IT and DMA calls are refused while it is busy. */
+BASE_StatusType HAL_I2C_BusInitEx(I2C_Handle *handle, I2C_BusQueue *queue);
+BASE_StatusType HAL_I2C_BusSubmitEx(I2C_Handle *handle, const I2C_BusXfer *xfer);
+BASE_StatusType HAL_I2C_BusAddPollEx(I2C_Handle *handle, const I2C_BusXfer *xfer, unsigned int period,
+                                     unsigned int *pollId);
+BASE_StatusType HAL_I2C_BusSetPollEx(I2C_Handle *handle, unsigned int pollId, bool enable);
+void HAL_I2C_BusTickEx(I2C_Handle *handle);
+bool HAL_I2C_BusIsIdleEx(const I2C_Handle *handle);
+void HAL_I2C_BusGetStatEx(const I2C_Handle *handle, I2C_BusStat *stat);
+void HAL_I2C_BusClearStatEx(I2C_Handle *handle);
 /**
   * @}
   */
@@ -171,6 +171,7 @@ typedef struct {
     unsigned int    sdaDelayTime;             /**< The SDA delay sampling configuration. */
     unsigned int    slaveOwnXmbAddressEnable; /**< Enable the I2C second own address function. */
     unsigned int    slaveOwnXmbAddress;       /**< The second own address as slave. */
+    struct _I2C_BusQueue *busQueue;           /**< Transaction queue attached by HAL_I2C_BusInitEx(), NULL if none. */
 } I2C_ExtendHandle;
 
 /**
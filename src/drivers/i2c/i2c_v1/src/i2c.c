@@ -26,7 +26,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "interrupt.h"
-#include "i2c.h"
+#include "drvcommon.h"
+#include "i2c_ex.h"
 
 /* Macro definitions ---------------------------------------------------------*/
 #define I2C_INTERFACE_INDEX_0         0
@@ -58,6 +59,9 @@
 
 /* Enable slv_addr_match_int\slv_rx_ack_unmatch_int\stop_det_int */
 #define I2C_CFG_INTERRUPT_SLAVE       0x300200
+
+/* Enable scl_low_timeout\mst_cmd_done\arb_lost\mst_rx_ack_unmatch, the data moves by DMA */
+#define I2C_CFG_INTERRUPT_MASTER_BUS  0x3801
 #define I2C_TICK_MS_DIV               1000
 
 #define I2C_INTR_RAW_SLAVE_ADDR_MATCH_MASK      (0x1 << 21)
@@ -168,6 +172,22 @@ static BASE_StatusType CheckAllInitParameters(I2C_Handle *handle, unsigned int c
     return BASE_STATUS_OK;
 }
 
+/**
+  * @brief Get the address bytes of a slave device.
+  * @param handle I2C handle.
+  * @param devAddr Slave device address
+  * @retval unsigned int The upper 16 bits are the read operation address, the lower 16 bits the write one.
+  */
+static unsigned int GetSlaveDevAddr(const I2C_Handle *handle, const unsigned int devAddr)
+{
+    if (handle->addrMode == I2C_10_BITS) {
+        return (((devAddr << 16) & I2C_10BIT_SLAVE_READ_ADDR_MASK) | I2C_10BIT_SLAVE_READ_OPT_MASK) |
+               (devAddr & I2C_10BIT_SLAVE_WRITE_ADDR_MASK);
+    }
+    return (((devAddr << 16) & I2C_7BIT_SLAVE_READ_ADDR_MASK) | I2C_7BIT_SLAVE_READ_OPT_MASK) |
+           (devAddr & I2C_7BIT_SLAVE_WRITE_ADDR_MASK);
+}
+
 /**
   * @brief Configuring the I2C Slave Device Address.
   * @param handle I2C handle.
@@ -176,18 +196,8 @@ static BASE_StatusType CheckAllInitParameters(I2C_Handle *handle, unsigned int c
   */
 static void SetSlaveDevAddr(I2C_Handle *handle, const unsigned int devAddr)
 {
-    unsigned int addr;
+    unsigned int addr = GetSlaveDevAddr(handle, devAddr);
 
-    if (handle->addrMode == I2C_10_BITS) {
-        /* The upper 16 bits are the read operation address, and the lower 16 bits are the write operation address. */
-        addr = (((devAddr << 16) & I2C_10BIT_SLAVE_READ_ADDR_MASK) | I2C_10BIT_SLAVE_READ_OPT_MASK) |
-               (devAddr & I2C_10BIT_SLAVE_WRITE_ADDR_MASK);
-    } else {
-        /* The upper 16 bits are the read operation address, and the lower 16 bits are the write operation address. */
-        addr = (((devAddr << 16) & I2C_7BIT_SLAVE_READ_ADDR_MASK) | I2C_7BIT_SLAVE_READ_OPT_MASK) |
-               (devAddr & I2C_7BIT_SLAVE_WRITE_ADDR_MASK);
-    }
-    
     if (handle->baseAddress == I2C0) {
         g_internalConfigParam[I2C_INTERFACE_INDEX_0].slaveAddress = addr;
     } else if (handle->baseAddress == I2C1) {
@@ -2000,6 +2010,514 @@ BASE_StatusType HAL_I2C_SlaveWriteDMA(I2C_Handle *handle, unsigned char *wData,
     return ret;
 }
 
+/**
+  * @brief TX FIFO word of a command and its data.
+  * @param cmd I2C operation command.
+  * @param data Data byte.
+  * @retval unsigned int TX FIFO word.
+  */
+static inline unsigned int I2C_BusCmdWord(I2C_CmdType cmd, unsigned int data)
+{
+    return (((unsigned int)cmd << I2C_TXFIFO_CMD_POS) & I2C_TXFIFO_CMD_MASK) |
+           ((data << I2C_TXFIFO_WDATA_POS) & I2C_TXFIFO_WDATA_MASK);
+}
+
+/**
+  * @brief Number of TX FIFO commands of a transaction.
+  * @param handle I2C handle.
+  * @param xfer Transaction.
+  * @retval unsigned int Number of commands.
+  */
+static unsigned int I2C_BusCmdLen(const I2C_Handle *handle, const I2C_BusXfer *xfer)
+{
+    unsigned int addrLen = (handle->addrMode == I2C_10_BITS) ? 2 : 1; /* 10-bit addresses take two bytes. */
+    unsigned int len = 2; /* Start and stop. */
+
+    if (xfer->txLen > 0) {
+        len += addrLen + xfer->txLen;
+    }
+    if (xfer->rxLen > 0) {
+        /* A repeated start only resends the first byte of a 10-bit address. */
+        len += ((xfer->txLen > 0) ? 2 : addrLen) + xfer->rxLen;
+    }
+    return len;
+}
+
+/**
+  * @brief Build the TX FIFO command stream of a transaction: start, write address, data, then repeated start,
+  *        read address and read commands, the last one not acknowledged, and stop.
+  * @param handle I2C handle.
+  * @param xfer Transaction.
+  * @param cmdBuff Command stream.
+  * @retval unsigned int Number of commands.
+  */
+static unsigned int I2C_BusBuildCmd(const I2C_Handle *handle, const I2C_BusXfer *xfer, unsigned int *cmdBuff)
+{
+    unsigned int addr = GetSlaveDevAddr(handle, xfer->devAddr);
+    unsigned int n = 0;
+    unsigned int i;
+
+    cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_S, 0);
+    if (xfer->txLen > 0) {
+        if (handle->addrMode == I2C_10_BITS) {
+            cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_M_TD_RACK_S_RD_TACK,
+                                          (addr >> I2C_SLAVE_WRITE_ADDR_POS) & I2C_SLAVE_ADDR_MASK);
+        }
+        cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_M_TD_RACK_S_RD_TACK, addr & I2C_SLAVE_ADDR_MASK);
+        for (i = 0; i < xfer->txLen; i++) {
+            cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_M_TD_RACK_S_RD_TACK, xfer->txBuff[i]);
+        }
+    }
+    if (xfer->rxLen > 0) {
+        if (xfer->txLen > 0) {
+            cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_S, 0);
+        }
+        if (handle->addrMode == I2C_10_BITS) {
+            cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_M_TD_RACK_S_RD_TACK,
+                                          (addr >> I2C_SLAVE_READ_FIX_ADDR_POS) & I2C_SLAVE_ADDR_MASK);
+        }
+        if (handle->addrMode != I2C_10_BITS || xfer->txLen == 0) {
+            cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_M_TD_RACK_S_RD_TACK,
+                                          (addr >> I2C_SLAVE_READ_DEV_ADDR_POS) & I2C_SLAVE_ADDR_MASK);
+        }
+        for (i = 1; i < xfer->rxLen; i++) {
+            cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_M_RD_TACK_S_TD_RACK, 0);
+        }
+        cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_M_RD_TNACK_S_TD_RNACK, 0);
+    }
+    cmdBuff[n++] = I2C_BusCmdWord(I2C_CMD_P, 0);
+    return n;
+}
+
+/**
+  * @brief Stop the running transaction and return the controller to idle.
+  * @param handle I2C handle.
+  * @retval None.
+  */
+static void I2C_BusStopHardware(I2C_Handle *handle)
+{
+    handle->baseAddress->I2C_CTRL1.BIT.dma_operation = I2C_DMA_OP_NONE;
+    handle->baseAddress->I2C_CTRL1.BIT.mst_start = BASE_CFG_UNSET;
+    handle->baseAddress->I2C_INTR_EN.reg = I2C_INTR_EN_ALL_DISABLE;
+    handle->baseAddress->I2C_INTR_RAW.reg = I2C_INTR_RAW_ALL_ENABLE;
+}
+
+static void I2C_BusKick(I2C_Handle *handle);
+
+/**
+  * @brief End the running transaction, report it and start the next one.
+  * @param handle I2C handle.
+  * @param status Transaction status.
+  * @retval None.
+  */
+static void I2C_BusFinish(I2C_Handle *handle, BASE_StatusType status)
+{
+    I2C_BusQueue *queue = handle->handleEx.busQueue;
+    I2C_BusEntry *entry = &queue->entry[queue->head];
+    I2C_BusXfer xfer = entry->xfer;
+    unsigned int ticks = BASE_FUNC_TicksSince(queue->startTick);
+
+    if (status != BASE_STATUS_OK) {
+        HAL_DMA_StopChannel(handle->dmaHandle, handle->txDmaCh);
+        HAL_DMA_StopChannel(handle->dmaHandle, handle->rxDmaCh);
+        queue->stat.errCnt++;
+    }
+    I2C_BusStopHardware(handle);
+    queue->running = false;
+    queue->stat.xferCnt++;
+    queue->stat.busyTicks += ticks;
+    queue->stat.maxXferTicks = (ticks > queue->stat.maxXferTicks) ? ticks : queue->stat.maxXferTicks;
+    if (entry->pollId != I2C_BUS_POLL_NONE) {
+        queue->poll[entry->pollId].pending = false;
+    }
+    queue->head = (queue->head + 1) % I2C_BUS_QUEUE_LEN;
+    queue->count--;
+    if (queue->count == 0) {
+        handle->state = I2C_STATE_READY;
+    }
+    if (xfer.callback != NULL) {
+        xfer.callback(handle, &xfer, status);
+    }
+    I2C_BusKick(handle);
+}
+
+/**
+  * @brief Account one completion event of the running transaction: the stop on the bus, and the last byte moved
+  *        by the RX DMA channel when reading.
+  * @param handle I2C handle.
+  * @retval None.
+  */
+static void I2C_BusEventDone(I2C_Handle *handle)
+{
+    I2C_BusQueue *queue = handle->handleEx.busQueue;
+    if (queue->pending > 0) {
+        queue->pending--;
+    }
+    if (queue->pending == 0) {
+        I2C_BusFinish(handle, BASE_STATUS_OK);
+    }
+}
+
+/**
+  * @brief RX DMA completion of a queued transaction.
+  * @param handle I2C handle.
+  * @retval None.
+  */
+static void I2C_BusDmaFinishFun(void *handle)
+{
+    I2C_Handle *i2cHandle = (I2C_Handle *)handle;
+    if (i2cHandle->handleEx.busQueue->running) {
+        I2C_BusEventDone(i2cHandle);
+    }
+}
+
+/**
+  * @brief DMA error of a queued transaction.
+  * @param handle I2C handle.
+  * @retval None.
+  */
+static void I2C_BusDmaErrorFun(void *handle)
+{
+    I2C_Handle *i2cHandle = (I2C_Handle *)handle;
+    if (i2cHandle->handleEx.busQueue->running) {
+        I2C_BusFinish(i2cHandle, BASE_STATUS_ERROR);
+    }
+}
+
+/**
+  * @brief Put the oldest queued transaction on the bus.
+  * @param handle I2C handle.
+  * @retval BASE status type: OK, ERROR.
+  */
+static BASE_StatusType I2C_BusStart(I2C_Handle *handle)
+{
+    I2C_BusQueue *queue = handle->handleEx.busQueue;
+    I2C_BusEntry *entry = &queue->entry[queue->head];
+    unsigned int wait = BASE_FUNC_TicksSince(entry->submitTick);
+    unsigned int cmdLen = I2C_BusBuildCmd(handle, &entry->xfer, queue->cmdBuff);
+    DMA_Handle *dma = handle->dmaHandle;
+
+    queue->stat.sumWaitTicks += wait;
+    queue->stat.maxWaitTicks = (wait > queue->stat.maxWaitTicks) ? wait : queue->stat.maxWaitTicks;
+    queue->startTick = DCL_SYSTICK_GetTick();
+    queue->pending = (entry->xfer.rxLen > 0) ? 2 : 1; /* Stop detected, plus the RX DMA when reading. */
+    queue->running = true;
+    handle->state = (entry->xfer.rxLen > 0) ? I2C_STATE_BUSY_MASTER_RX : I2C_STATE_BUSY_MASTER_TX;
+
+    handle->baseAddress->I2C_INTR_EN.reg = I2C_INTR_EN_ALL_DISABLE;
+    handle->baseAddress->I2C_INTR_RAW.reg = I2C_INTR_RAW_ALL_ENABLE;
+    handle->baseAddress->I2C_CTRL1.BIT.rst_rx_fifo = BASE_CFG_SET;
+    handle->baseAddress->I2C_CTRL1.BIT.rst_tx_fifo = BASE_CFG_SET;
+    dma->userCallBack.DMA_CallbackFuns[handle->txDmaCh].ChannelFinishCallBack = NULL;
+    dma->userCallBack.DMA_CallbackFuns[handle->txDmaCh].ChannelErrorCallBack = I2C_BusDmaErrorFun;
+    dma->userCallBack.DMA_CallbackFuns[handle->rxDmaCh].ChannelFinishCallBack = I2C_BusDmaFinishFun;
+    dma->userCallBack.DMA_CallbackFuns[handle->rxDmaCh].ChannelErrorCallBack = I2C_BusDmaErrorFun;
+    if (entry->xfer.rxLen > 0 &&
+        HAL_DMA_StartIT(dma, (uintptr_t)&(handle->baseAddress->I2C_RX_FIFO), (uintptr_t)entry->xfer.rxBuff,
+                        entry->xfer.rxLen, handle->rxDmaCh) != BASE_STATUS_OK) {
+        return BASE_STATUS_ERROR;
+    }
+    if (HAL_DMA_StartIT(dma, (uintptr_t)queue->cmdBuff, (uintptr_t)&(handle->baseAddress->I2C_TX_FIFO.reg),
+                        cmdLen, handle->txDmaCh) != BASE_STATUS_OK) {
+        return BASE_STATUS_ERROR;
+    }
+    handle->baseAddress->I2C_INTR_EN.reg = I2C_CFG_INTERRUPT_MASTER_BUS;
+    handle->baseAddress->I2C_CTRL1.BIT.mst_start = BASE_CFG_SET;
+    handle->baseAddress->I2C_CTRL1.BIT.dma_operation = (entry->xfer.rxLen > 0) ? I2C_DMA_OP_WRITE_READ :
+                                                       I2C_DMA_OP_WRITE;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Start the next transaction if the bus is idle.
+  * @param handle I2C handle.
+  * @retval None.
+  */
+static void I2C_BusKick(I2C_Handle *handle)
+{
+    I2C_BusQueue *queue = handle->handleEx.busQueue;
+    while (!queue->running && queue->count > 0) {
+        if (I2C_BusStart(handle) != BASE_STATUS_OK) {
+            I2C_BusFinish(handle, BASE_STATUS_ERROR); /* Starts the next one. */
+            return;
+        }
+    }
+}
+
+/**
+  * @brief I2C interrupt of a queued transaction.
+  * @param handle I2C handle.
+  * @param status Masked interrupt status.
+  * @retval None.
+  */
+static void I2C_BusIrqHandle(I2C_Handle *handle, unsigned int status)
+{
+    if ((status & (I2C_ERROR_BIT_MASK | I2C_SCL_LOW_TIMEOUT_MASK)) != 0) {
+        if ((status & I2C_SCL_LOW_TIMEOUT_MASK) != 0) {
+            I2cBusClear(handle);
+        }
+        I2C_BusFinish(handle, BASE_STATUS_ERROR);
+        return;
+    }
+    if ((status & I2C_INTR_RAW_ALL_CMD_DONE_MASK) != 0) {
+        handle->baseAddress->I2C_INTR_EN.BIT.mst_cmd_done_en = BASE_CFG_DISABLE;
+        I2C_BusEventDone(handle);
+    }
+}
+
+/**
+  * @brief Queue a copy of a transaction and start it if the bus is idle.
+  * @param handle I2C handle.
+  * @param xfer Transaction.
+  * @param pollId Polling job that queues it, I2C_BUS_POLL_NONE for a user submission.
+  * @retval BASE status type: OK, BUSY if the queue is full or the handle is used directly.
+  */
+static BASE_StatusType I2C_BusQueueXfer(I2C_Handle *handle, const I2C_BusXfer *xfer, unsigned int pollId)
+{
+    I2C_BusQueue *queue = handle->handleEx.busQueue;
+    I2C_BusEntry *entry = NULL;
+
+    if (queue->count >= I2C_BUS_QUEUE_LEN) {
+        queue->stat.queueFullCnt++;
+        return BASE_STATUS_BUSY;
+    }
+    if (queue->count == 0 && handle->state != I2C_STATE_READY) {
+        return BASE_STATUS_BUSY;
+    }
+    entry = &queue->entry[(queue->head + queue->count) % I2C_BUS_QUEUE_LEN];
+    entry->xfer = *xfer;
+    entry->submitTick = DCL_SYSTICK_GetTick();
+    entry->pollId = pollId;
+    queue->count++;
+    queue->stat.maxQueueDepth = (queue->count > queue->stat.maxQueueDepth) ? queue->count :
+                                queue->stat.maxQueueDepth;
+    if (queue->count == 1) {
+        handle->state = I2C_STATE_BUSY; /* Claim the handle until the queue drains. */
+    }
+    I2C_BusKick(handle);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Check a transaction before it is queued.
+  * @param handle I2C handle.
+  * @param xfer Transaction.
+  * @retval bool true if the transaction can be queued.
+  */
+static bool I2C_BusIsValidXfer(const I2C_Handle *handle, const I2C_BusXfer *xfer)
+{
+    if (xfer->devAddr > I2C_MAX_DEV_ADDR || (xfer->txLen == 0 && xfer->rxLen == 0)) {
+        return false;
+    }
+    if ((xfer->txLen > 0 && xfer->txBuff == NULL) || (xfer->rxLen > 0 && xfer->rxBuff == NULL)) {
+        return false;
+    }
+    if (xfer->txLen > I2C_BUS_CMD_MAX || xfer->rxLen > I2C_BUS_CMD_MAX) {
+        return false;
+    }
+    return I2C_BusCmdLen(handle, xfer) <= I2C_BUS_CMD_MAX;
+}
+
+/**
+  * @brief Attach a transaction queue to an I2C handle.
+  * @param handle I2C handle, master mode with DMA channels configured.
+  * @param queue Transaction queue.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_I2C_BusInitEx(I2C_Handle *handle, I2C_BusQueue *queue)
+{
+    I2C_ASSERT_PARAM(handle != NULL && queue != NULL);
+    I2C_ASSERT_PARAM(IsI2CInstance(handle->baseAddress));
+    I2C_ASSERT_PARAM(handle->dmaHandle != NULL);
+    I2C_PARAM_CHECK_WITH_RET(handle->functionMode == I2C_MODE_SELECT_MASTER_ONLY, BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET((handle->txDmaCh < CHANNEL_MAX_NUM), BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET((handle->rxDmaCh < CHANNEL_MAX_NUM), BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET((handle->rxDmaCh != handle->txDmaCh), BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET(handle->state == I2C_STATE_READY, BASE_STATUS_ERROR);
+
+    queue->head = 0;
+    queue->count = 0;
+    queue->pollNum = 0;
+    queue->running = false;
+    queue->pending = 0;
+    queue->startTick = 0;
+    queue->lastTick = DCL_SYSTICK_GetTick();
+    handle->handleEx.busQueue = queue;
+    HAL_I2C_BusClearStatEx(handle);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Queue a transaction.
+  * @param handle I2C handle.
+  * @param xfer Transaction, copied into the queue.
+  * @retval BASE status type: OK, ERROR, BUSY if the queue is full.
+  */
+BASE_StatusType HAL_I2C_BusSubmitEx(I2C_Handle *handle, const I2C_BusXfer *xfer)
+{
+    BASE_StatusType ret;
+    unsigned int lock;
+    I2C_ASSERT_PARAM(handle != NULL && xfer != NULL);
+    I2C_PARAM_CHECK_WITH_RET(handle->handleEx.busQueue != NULL, BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET(I2C_BusIsValidXfer(handle, xfer), BASE_STATUS_ERROR);
+
+    lock = BASE_FUNC_IntLock();
+    ret = I2C_BusQueueXfer(handle, xfer, I2C_BUS_POLL_NONE);
+    BASE_FUNC_IntUnlock(lock);
+    return ret;
+}
+
+/**
+  * @brief Add a periodic polling job, enabled.
+  * @param handle I2C handle.
+  * @param xfer Transaction queued at each period, copied.
+  * @param period Period in HAL_I2C_BusTickEx() calls.
+  * @param pollId Identifier of the polling job.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_I2C_BusAddPollEx(I2C_Handle *handle, const I2C_BusXfer *xfer, unsigned int period,
+                                     unsigned int *pollId)
+{
+    I2C_BusQueue *queue = NULL;
+    I2C_BusPoll *poll = NULL;
+    unsigned int lock;
+    I2C_ASSERT_PARAM(handle != NULL && xfer != NULL && pollId != NULL);
+    I2C_PARAM_CHECK_WITH_RET(handle->handleEx.busQueue != NULL, BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET(I2C_BusIsValidXfer(handle, xfer), BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET(period > 0, BASE_STATUS_ERROR);
+
+    queue = handle->handleEx.busQueue;
+    lock = BASE_FUNC_IntLock();
+    if (queue->pollNum >= I2C_BUS_POLL_NUM) {
+        BASE_FUNC_IntUnlock(lock);
+        return BASE_STATUS_ERROR;
+    }
+    poll = &queue->poll[queue->pollNum];
+    poll->xfer = *xfer;
+    poll->period = period;
+    poll->countdown = period;
+    poll->pending = false;
+    poll->enable = true;
+    *pollId = queue->pollNum++;
+    BASE_FUNC_IntUnlock(lock);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Enable or disable a polling job, a poll already queued still runs.
+  * @param handle I2C handle.
+  * @param pollId Identifier of the polling job.
+  * @param enable Enable flag.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_I2C_BusSetPollEx(I2C_Handle *handle, unsigned int pollId, bool enable)
+{
+    I2C_BusPoll *poll = NULL;
+    I2C_ASSERT_PARAM(handle != NULL);
+    I2C_PARAM_CHECK_WITH_RET(handle->handleEx.busQueue != NULL, BASE_STATUS_ERROR);
+    I2C_PARAM_CHECK_WITH_RET(pollId < handle->handleEx.busQueue->pollNum, BASE_STATUS_ERROR);
+
+    poll = &handle->handleEx.busQueue->poll[pollId];
+    poll->countdown = poll->period;
+    poll->enable = enable;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Periodic service: queue the due polling jobs, abort a transaction running longer than handle->timeout
+  *        (ms, 0 for no timeout) and accumulate the elapsed time of the statistics. Call it from a timer interrupt
+  *        or the main loop, at least once per systick wrap.
+  * @param handle I2C handle.
+  * @retval None.
+  */
+void HAL_I2C_BusTickEx(I2C_Handle *handle)
+{
+    I2C_BusQueue *queue = NULL;
+    I2C_BusPoll *poll = NULL;
+    unsigned int lock;
+    unsigned long long timeoutTicks;
+    I2C_ASSERT_PARAM(handle != NULL);
+    I2C_PARAM_CHECK_NO_RET(handle->handleEx.busQueue != NULL);
+
+    queue = handle->handleEx.busQueue;
+    timeoutTicks = (unsigned long long)HAL_CRG_GetIpFreq(SYSTICK_BASE) / I2C_TICK_MS_DIV * handle->timeout;
+    lock = BASE_FUNC_IntLock();
+    queue->stat.elapsedTicks += BASE_FUNC_TicksSince(queue->lastTick);
+    queue->lastTick = DCL_SYSTICK_GetTick();
+    if (queue->running && timeoutTicks != 0 && BASE_FUNC_TicksSince(queue->startTick) >= timeoutTicks) {
+        queue->stat.timeoutCnt++;
+        I2C_BusFinish(handle, BASE_STATUS_TIMEOUT);
+    }
+    for (unsigned int i = 0; i < queue->pollNum; i++) {
+        poll = &queue->poll[i];
+        if (!poll->enable || --poll->countdown > 0) {
+            continue;
+        }
+        poll->countdown = poll->period;
+        if (poll->pending) {
+            queue->stat.pollOverrunCnt++;
+        } else if (I2C_BusQueueXfer(handle, &poll->xfer, i) == BASE_STATUS_OK) {
+            poll->pending = true;
+        }
+    }
+    BASE_FUNC_IntUnlock(lock);
+}
+
+/**
+  * @brief Check whether the transaction queue is empty.
+  * @param handle I2C handle.
+  * @retval bool true if no transaction is queued.
+  */
+bool HAL_I2C_BusIsIdleEx(const I2C_Handle *handle)
+{
+    I2C_ASSERT_PARAM(handle != NULL);
+    return handle->handleEx.busQueue == NULL || handle->handleEx.busQueue->count == 0;
+}
+
+/**
+  * @brief Get the transaction queue statistics.
+  * @param handle I2C handle.
+  * @param stat Statistics.
+  * @retval None.
+  */
+void HAL_I2C_BusGetStatEx(const I2C_Handle *handle, I2C_BusStat *stat)
+{
+    unsigned int lock;
+    I2C_ASSERT_PARAM(handle != NULL && stat != NULL);
+    I2C_PARAM_CHECK_NO_RET(handle->handleEx.busQueue != NULL);
+    lock = BASE_FUNC_IntLock();
+    *stat = handle->handleEx.busQueue->stat;
+    BASE_FUNC_IntUnlock(lock);
+}
+
+/**
+  * @brief Clear the transaction queue statistics.
+  * @param handle I2C handle.
+  * @retval None.
+  */
+void HAL_I2C_BusClearStatEx(I2C_Handle *handle)
+{
+    I2C_BusStat *stat = NULL;
+    unsigned int lock;
+    I2C_ASSERT_PARAM(handle != NULL);
+    I2C_PARAM_CHECK_NO_RET(handle->handleEx.busQueue != NULL);
+    stat = &handle->handleEx.busQueue->stat;
+    lock = BASE_FUNC_IntLock();
+    stat->xferCnt = 0;
+    stat->errCnt = 0;
+    stat->timeoutCnt = 0;
+    stat->queueFullCnt = 0;
+    stat->pollOverrunCnt = 0;
+    stat->maxQueueDepth = 0;
+    stat->maxWaitTicks = 0;
+    stat->maxXferTicks = 0;
+    stat->sumWaitTicks = 0;
+    stat->busyTicks = 0;
+    stat->elapsedTicks = 0;
+    handle->handleEx.busQueue->lastTick = DCL_SYSTICK_GetTick();
+    BASE_FUNC_IntUnlock(lock);
+}
+
 /**
   * @brief Interrupt Handling Function.
   * @param handle Handle pointers
@@ -2016,6 +2534,10 @@ void HAL_I2C_IrqHandler(void *handle)
 
     status = i2cHandle->baseAddress->I2C_INTR_STAT.reg;
     i2cHandle->baseAddress->I2C_INTR_RAW.reg = I2C_INTR_RAW_ALL_ENABLE;
+    if (i2cHandle->handleEx.busQueue != NULL && i2cHandle->handleEx.busQueue->running) {
+        I2C_BusIrqHandle(i2cHandle, status);
+        return;
+    }
     if (IsInterruptErrorStatus(i2cHandle, status)) {
         return;
     }
@@ -21,6 +21,7 @@
   * @details   This file provides firmware functions to manage the following.
   *            functionalities of the SPI.
   *            + SPI Set Functions.
+  *            + Master transaction queue definition and functions.
   */
 #ifndef McuMagicTag_SPI_EX_H
 #define McuMagicTag_SPI_EX_H
@@ -28,17 +29,140 @@
 #include "spi.h"
 
 /* Macro definitions ---------------------------------------------------------*/
+#ifndef SPI_BUS_QUEUE_LEN
+#define SPI_BUS_QUEUE_LEN       8U      /* Transactions waiting or running. */
+#endif
+
+#ifndef SPI_BUS_POLL_NUM
+#define SPI_BUS_POLL_NUM        4U      /* Periodic polling jobs. */
+#endif
+
+#define SPI_BUS_DEVICE_NUM      SPI_CHIP_SELECT_CHANNEL_MAX
+#define SPI_BUS_POLL_NONE       0xFFFFFFFFU
 /**
   * @addtogroup SPI_IP
   * @{
   */
 
+/**
+  * @defgroup SPI_BUS_Definition SPI Transaction Queue Definition
+  * @{
+  */
+
+/**
+  * @brief Device on the bus: chip select channel and its own clock settings, applied when the bus switches to it.
+  */
+typedef struct {
+    SPI_ChipSelectChannel   csChannel;      /**< Chip select channel. */
+    unsigned int            clkPolarity;    /**< See HAL_SPI_ClkPol, Motorola frame format. */
+    unsigned int            clkPhase;       /**< See HAL_SPI_ClkPha, Motorola frame format. */
+    unsigned char           freqScr;        /**< Frequency scr, value range: 0 to 255. */
+    unsigned char           freqCpsdvsr;    /**< Frequency Cpsdvsr, an even number ranging from 0 to 254. */
+} SPI_BusDevice;
+
+typedef struct _SPI_BusXfer SPI_BusXfer;
+
+/**
+  * @brief Transaction completion callback, called from the DMA interrupt.
+  */
+typedef void (*SPI_BusCallbackFunType)(SPI_Handle *handle, const SPI_BusXfer *xfer, BASE_StatusType status);
+
+/**
+  * @brief Master transaction: write txLen bytes, then read rxLen bytes, with the device selected throughout.
+  *        With duplex set, rxBuff receives the txLen bytes clocked in while writing and rxLen is ignored.
+  *        The buffers must stay valid until the callback.
+  */
+struct _SPI_BusXfer {
+    unsigned int            devId;      /**< Device returned by HAL_SPI_BusAddDeviceEx(). */
+    unsigned char          *txBuff;     /**< Bytes to write, e.g. a command and register address. */
+    unsigned int            txLen;      /**< Number of bytes to write. */
+    unsigned char          *rxBuff;     /**< Buffer for the bytes read. */
+    unsigned int            rxLen;      /**< Number of bytes to read. */
+    bool                    duplex;     /**< Read while writing instead of after writing. */
+    SPI_BusCallbackFunType  callback;   /**< Completion callback, may be NULL. */
+    void                   *param;      /**< User parameter of the callback. */
+};
+
+/**
+  * @brief Queued transaction.
+  */
+typedef struct {
+    SPI_BusXfer     xfer;           /**< Copy of the submitted transaction. */
+    unsigned int    submitTick;     /**< Systick value at submission. */
+    unsigned int    pollId;         /**< Polling job that queued it, SPI_BUS_POLL_NONE for a user submission. */
+} SPI_BusEntry;
+
+/**
+  * @brief Periodic polling job.
+  */
+typedef struct {
+    SPI_BusXfer     xfer;           /**< Transaction queued at each period. */
+    unsigned int    period;         /**< Period in HAL_SPI_BusTickEx() calls. */
+    unsigned int    countdown;      /**< Calls left before the next submission. */
+    bool            enable;         /**< Polling enabled. */
+    volatile bool   pending;        /**< The last submission is still queued or running. */
+} SPI_BusPoll;
+
+/**
+  * @brief Queue statistics, times in systick counts. Bus utilisation is busyTicks / elapsedTicks, elapsedTicks
+  *        is accumulated by HAL_SPI_BusTickEx().
+  */
+typedef struct {
+    unsigned int        xferCnt;        /**< Completed transactions, failed ones included. */
+    unsigned int        errCnt;         /**< Transactions ended by a DMA error. */
+    unsigned int        switchCnt;      /**< Clock setting changes between devices. */
+    unsigned int        queueFullCnt;   /**< Submissions refused because the queue was full. */
+    unsigned int        pollOverrunCnt; /**< Poll periods skipped because the previous poll was not done yet. */
+    unsigned int        maxQueueDepth;  /**< Highest number of queued transactions. */
+    unsigned int        maxWaitTicks;   /**< Longest time from submission to start. */
+    unsigned int        maxXferTicks;   /**< Longest time from start to completion. */
+    unsigned long long  sumWaitTicks;   /**< Sum of the times from submission to start. */
+    unsigned long long  busyTicks;      /**< Time the bus spent running transactions. */
+    unsigned long long  elapsedTicks;   /**< Time covered by the statistics. */
+} SPI_BusStat;
+
+/**
+  * @brief Master transaction queue. Each phase of a transaction runs as a DMA transfer and the next phase or
+  *        transaction is started from the RX DMA completion interrupt, switching the chip select channel and the
+  *        clock settings as needed, so back-to-back transfers to several devices need no task time.
+  */
+typedef struct _SPI_BusQueue {
+    SPI_BusEntry        entry[SPI_BUS_QUEUE_LEN];   /**< Transaction ring. */
+    unsigned int        head;                       /**< Oldest transaction, the running one. */
+    unsigned int        count;                      /**< Number of queued transactions. */
+    SPI_BusDevice       device[SPI_BUS_DEVICE_NUM]; /**< Devices on the bus. */
+    unsigned int        deviceNum;                  /**< Number of devices added. */
+    SPI_BusPoll         poll[SPI_BUS_POLL_NUM];     /**< Polling jobs. */
+    unsigned int        pollNum;                    /**< Number of polling jobs added. */
+    volatile bool       running;                    /**< A transaction is on the bus. */
+    bool                readPhase;                  /**< The running transaction is in its read phase. */
+    unsigned int        startTick;                  /**< Systick value when the running transaction started. */
+    unsigned int        lastTick;                   /**< Systick value at the last HAL_SPI_BusTickEx() call. */
+    SPI_BusStat         stat;                       /**< Statistics. */
+} SPI_BusQueue;
+/**
+  * @}
+  */
+
 /**
   * @defgroup SPI_EX_API_Declaration SPI HAL API EX
   * @{
   */
 BASE_StatusType HAL_SPI_SetChipConfigSelectEx(SPI_Handle *handle, HAL_SPI_CHIP_CONFIG mode);
 HAL_SPI_CHIP_CONFIG HAL_SPI_GetChipConfigSelectEx(SPI_Handle *handle);
+
+/* The transaction queue needs the SPI handle in master and DMA mode. The queue is run from the DMA interrupt,
+   blocking, IT and DMA calls are refused while it is busy. */
+BASE_StatusType HAL_SPI_BusInitEx(SPI_Handle *handle, SPI_BusQueue *queue);
+BASE_StatusType HAL_SPI_BusAddDeviceEx(SPI_Handle *handle, const SPI_BusDevice *device, unsigned int *devId);
+BASE_StatusType HAL_SPI_BusSubmitEx(SPI_Handle *handle, const SPI_BusXfer *xfer);
+BASE_StatusType HAL_SPI_BusAddPollEx(SPI_Handle *handle, const SPI_BusXfer *xfer, unsigned int period,
+                                     unsigned int *pollId);
+BASE_StatusType HAL_SPI_BusSetPollEx(SPI_Handle *handle, unsigned int pollId, bool enable);
+void HAL_SPI_BusTickEx(SPI_Handle *handle);
+bool HAL_SPI_BusIsIdleEx(const SPI_Handle *handle);
+void HAL_SPI_BusGetStatEx(const SPI_Handle *handle, SPI_BusStat *stat);
+void HAL_SPI_BusClearStatEx(SPI_Handle *handle);
 /**
   * @}
   */
@@ -242,6 +242,7 @@ typedef enum {
   * @brief SPI extend handle.
   */
 typedef struct _SPI_ExtendHandle {
+    struct _SPI_BusQueue *busQueue;     /**< Transaction queue attached by HAL_SPI_BusInitEx(), NULL if none. */
 } SPI_ExtendHandle;
 
 /**
@@ -27,7 +27,8 @@
 /* Includes ------------------------------------------------------------------*/
 #include "interrupt.h"
 #include "systick.h"
-#include "spi.h"
+#include "drvcommon.h"
+#include "spi_ex.h"
 /* Macro definitions ---------------------------------------------------------*/
 #define SPI_WAIT_TIMEOUT   0x400
 
@@ -822,6 +823,8 @@ static void WaitComplete(void *handle)
     }
 }
 
+static void SPI_BusPhaseDone(SPI_Handle *handle, BASE_StatusType status);
+
 /**
   * @brief SPI DMA read completion callback function.
   * @param handle SPI handle.
@@ -834,6 +837,11 @@ static void ReadDmaFinishFun(void *handle)
     SPI_ASSERT_PARAM(IsSPIInstance(spiHandle->baseAddress));
     /* Waiting for SPI data transfer to complete */
     WaitComplete(spiHandle);
+    if (spiHandle->handleEx.busQueue != NULL && spiHandle->handleEx.busQueue->running) {
+        spiHandle->baseAddress->SPIDMACR.BIT.rxdmae = BASE_CFG_UNSET;
+        SPI_BusPhaseDone(spiHandle, BASE_STATUS_OK);
+        return;
+    }
     SpiCsControl(spiHandle, SPI_CHIP_DESELECT);
 
     if (spiHandle->state == HAL_SPI_STATE_BUSY_RX) {
@@ -869,6 +877,11 @@ static void WriteDmaFinishFun(void *handle)
     SPI_ASSERT_PARAM(handle != NULL);
     SPI_Handle *spiHandle = (SPI_Handle *)(handle);
     SPI_ASSERT_PARAM(IsSPIInstance(spiHandle->baseAddress));
+    if (spiHandle->handleEx.busQueue != NULL && spiHandle->handleEx.busQueue->running) {
+        /* The RX channel completion ends the phase, the device stays selected. */
+        spiHandle->baseAddress->SPIDMACR.BIT.txdmae = BASE_CFG_UNSET;
+        return;
+    }
     /* Waiting for SPI data transfer to complete */
     WaitComplete(spiHandle);
     SpiCsControl(spiHandle, SPI_CHIP_DESELECT);
@@ -892,6 +905,10 @@ static void DmaErrorFun(void *handle)
     SPI_ASSERT_PARAM(handle != NULL);
     SPI_Handle *spiHandle = (SPI_Handle *)(handle);
     SPI_ASSERT_PARAM(IsSPIInstance(spiHandle->baseAddress));
+    if (spiHandle->handleEx.busQueue != NULL && spiHandle->handleEx.busQueue->running) {
+        SPI_BusPhaseDone(spiHandle, BASE_STATUS_ERROR);
+        return;
+    }
     SpiCsControl(spiHandle, SPI_CHIP_DESELECT);
     /* Disable rx and tx fifo DMA */
     spiHandle->baseAddress->SPIDMACR.reg = 0;
@@ -1133,6 +1150,423 @@ BASE_StatusType HAL_SPI_ChipSelectChannelGet(SPI_Handle *handle, SPI_ChipSelectC
     return BASE_STATUS_OK;
 }
 
+/**
+  * @brief Switch the bus to a device: select its chip select channel and load its clock settings if they differ
+  *        from the current ones.
+  * @param handle SPI handle.
+  * @param device Device.
+  * @retval None.
+  */
+static void SPI_BusSelectDevice(SPI_Handle *handle, const SPI_BusDevice *device)
+{
+    unsigned int cr0Reg;
+
+    handle->baseAddress->SPICSNCR.BIT.spi_csn_sel = device->csChannel;
+    if (handle->clkPolarity == device->clkPolarity && handle->clkPhase == device->clkPhase &&
+        handle->freqScr == device->freqScr && handle->freqCpsdvsr == device->freqCpsdvsr) {
+        return;
+    }
+    handle->clkPolarity = device->clkPolarity;
+    handle->clkPhase = device->clkPhase;
+    handle->freqScr = device->freqScr;
+    handle->freqCpsdvsr = device->freqCpsdvsr;
+    handle->handleEx.busQueue->stat.switchCnt++;
+    /* The settings are loaded with the port disabled, the next DMA transfer enables it again. */
+    handle->baseAddress->SPICR1.BIT.sse = BASE_CFG_UNSET;
+    cr0Reg = (handle->baseAddress->SPICR0.reg & (~SPI_CR0_SCR_MASK)) |
+             (((unsigned int)handle->freqScr) << SPI_CR0_SCR_POS);
+    handle->baseAddress->SPICR0.reg = cr0Reg;
+    /* Modulo 2 to get an even number */
+    handle->baseAddress->SPICPSR.BIT.cpsdvsr = ((handle->freqCpsdvsr % 2) == 0 ? handle->freqCpsdvsr :
+                                                handle->freqCpsdvsr - 1);
+    if (handle->frameFormat == HAL_SPI_MODE_MOTOROLA) {
+        handle->baseAddress->SPICR0.BIT.sph = handle->clkPhase;
+        handle->baseAddress->SPICR0.BIT.spo = handle->clkPolarity;
+    }
+}
+
+static void SPI_BusKick(SPI_Handle *handle);
+
+/**
+  * @brief End the running transaction, report it and start the next one.
+  * @param handle SPI handle.
+  * @param status Transaction status.
+  * @retval None.
+  */
+static void SPI_BusFinish(SPI_Handle *handle, BASE_StatusType status)
+{
+    SPI_BusQueue *queue = handle->handleEx.busQueue;
+    SPI_BusEntry *entry = &queue->entry[queue->head];
+    SPI_BusXfer xfer = entry->xfer;
+    unsigned int ticks = BASE_FUNC_TicksSince(queue->startTick);
+
+    if (status != BASE_STATUS_OK) {
+        HAL_SPI_DMAStop(handle);
+        handle->baseAddress->SPIDMACR.reg = 0;
+        queue->stat.errCnt++;
+    }
+    SpiCsControl(handle, SPI_CHIP_DESELECT);
+    handle->state = HAL_SPI_STATE_READY;
+    queue->running = false;
+    queue->stat.xferCnt++;
+    queue->stat.busyTicks += ticks;
+    queue->stat.maxXferTicks = (ticks > queue->stat.maxXferTicks) ? ticks : queue->stat.maxXferTicks;
+    if (entry->pollId != SPI_BUS_POLL_NONE) {
+        queue->poll[entry->pollId].pending = false;
+    }
+    queue->head = (queue->head + 1) % SPI_BUS_QUEUE_LEN;
+    queue->count--;
+    if (queue->count > 0) {
+        handle->state = HAL_SPI_STATE_BUSY; /* Keep the handle claimed for the next transaction. */
+    }
+    if (xfer.callback != NULL) {
+        xfer.callback(handle, &xfer, status);
+    }
+    SPI_BusKick(handle);
+}
+
+/**
+  * @brief End of a transaction phase, called from the RX DMA completion or a DMA error: start the read phase
+  *        after the write phase, or end the transaction.
+  * @param handle SPI handle.
+  * @param status Phase status.
+  * @retval None.
+  */
+static void SPI_BusPhaseDone(SPI_Handle *handle, BASE_StatusType status)
+{
+    SPI_BusQueue *queue = handle->handleEx.busQueue;
+    const SPI_BusXfer *xfer = &queue->entry[queue->head].xfer;
+
+    if (status == BASE_STATUS_OK && !queue->readPhase && !xfer->duplex && xfer->rxLen > 0) {
+        /* The device stays selected between the phases. */
+        queue->readPhase = true;
+        handle->state = HAL_SPI_STATE_READY;
+        status = HAL_SPI_ReadDMA(handle, xfer->rxBuff, xfer->rxLen);
+        if (status == BASE_STATUS_OK) {
+            return;
+        }
+    }
+    SPI_BusFinish(handle, status);
+}
+
+/**
+  * @brief Put the oldest queued transaction on the bus.
+  * @param handle SPI handle.
+  * @retval BASE status type: OK, ERROR.
+  */
+static BASE_StatusType SPI_BusStart(SPI_Handle *handle)
+{
+    SPI_BusQueue *queue = handle->handleEx.busQueue;
+    SPI_BusEntry *entry = &queue->entry[queue->head];
+    const SPI_BusXfer *xfer = &entry->xfer;
+    unsigned int wait = BASE_FUNC_TicksSince(entry->submitTick);
+
+    queue->stat.sumWaitTicks += wait;
+    queue->stat.maxWaitTicks = (wait > queue->stat.maxWaitTicks) ? wait : queue->stat.maxWaitTicks;
+    queue->startTick = DCL_SYSTICK_GetTick();
+    queue->running = true;
+    SPI_BusSelectDevice(handle, &queue->device[xfer->devId]);
+    handle->state = HAL_SPI_STATE_READY;
+    if (xfer->duplex) {
+        queue->readPhase = true;
+        return HAL_SPI_WriteReadDMA(handle, xfer->rxBuff, xfer->txBuff, xfer->txLen);
+    }
+    if (xfer->txLen > 0) {
+        queue->readPhase = false;
+        return HAL_SPI_WriteDMA(handle, xfer->txBuff, xfer->txLen);
+    }
+    queue->readPhase = true;
+    return HAL_SPI_ReadDMA(handle, xfer->rxBuff, xfer->rxLen);
+}
+
+/**
+  * @brief Start the next transaction if the bus is idle.
+  * @param handle SPI handle.
+  * @retval None.
+  */
+static void SPI_BusKick(SPI_Handle *handle)
+{
+    SPI_BusQueue *queue = handle->handleEx.busQueue;
+    if (!queue->running && queue->count > 0) {
+        if (SPI_BusStart(handle) != BASE_STATUS_OK) {
+            SPI_BusFinish(handle, BASE_STATUS_ERROR); /* Starts the next one. */
+        }
+    }
+}
+
+/**
+  * @brief Queue a copy of a transaction and start it if the bus is idle.
+  * @param handle SPI handle.
+  * @param xfer Transaction.
+  * @param pollId Polling job that queues it, SPI_BUS_POLL_NONE for a user submission.
+  * @retval BASE status type: OK, BUSY if the queue is full or the handle is used directly.
+  */
+static BASE_StatusType SPI_BusQueueXfer(SPI_Handle *handle, const SPI_BusXfer *xfer, unsigned int pollId)
+{
+    SPI_BusQueue *queue = handle->handleEx.busQueue;
+    SPI_BusEntry *entry = NULL;
+
+    if (queue->count >= SPI_BUS_QUEUE_LEN) {
+        queue->stat.queueFullCnt++;
+        return BASE_STATUS_BUSY;
+    }
+    if (queue->count == 0 && handle->state != HAL_SPI_STATE_READY) {
+        return BASE_STATUS_BUSY;
+    }
+    entry = &queue->entry[(queue->head + queue->count) % SPI_BUS_QUEUE_LEN];
+    entry->xfer = *xfer;
+    entry->submitTick = DCL_SYSTICK_GetTick();
+    entry->pollId = pollId;
+    queue->count++;
+    queue->stat.maxQueueDepth = (queue->count > queue->stat.maxQueueDepth) ? queue->count :
+                                queue->stat.maxQueueDepth;
+    if (queue->count == 1) {
+        handle->state = HAL_SPI_STATE_BUSY; /* Claim the handle until the queue drains. */
+    }
+    SPI_BusKick(handle);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Check a transaction before it is queued.
+  * @param handle SPI handle.
+  * @param xfer Transaction.
+  * @retval bool true if the transaction can be queued.
+  */
+static bool SPI_BusIsValidXfer(const SPI_Handle *handle, const SPI_BusXfer *xfer)
+{
+    if (xfer->devId >= handle->handleEx.busQueue->deviceNum) {
+        return false;
+    }
+    if (xfer->duplex) {
+        return xfer->txLen > 0 && xfer->txBuff != NULL && xfer->rxBuff != NULL;
+    }
+    if (xfer->txLen == 0 && xfer->rxLen == 0) {
+        return false;
+    }
+    return (xfer->txLen == 0 || xfer->txBuff != NULL) && (xfer->rxLen == 0 || xfer->rxBuff != NULL);
+}
+
+/**
+  * @brief Attach a transaction queue to an SPI handle.
+  * @param handle SPI handle, master and DMA mode.
+  * @param queue Transaction queue.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_SPI_BusInitEx(SPI_Handle *handle, SPI_BusQueue *queue)
+{
+    SPI_ASSERT_PARAM(handle != NULL && queue != NULL);
+    SPI_ASSERT_PARAM(IsSPIInstance(handle->baseAddress));
+    SPI_ASSERT_PARAM(handle->dmaHandle != NULL);
+    SPI_PARAM_CHECK_WITH_RET(handle->mode == HAL_SPI_MASTER, BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(handle->xFerMode == HAL_XFER_MODE_DMA, BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(handle->state == HAL_SPI_STATE_READY, BASE_STATUS_ERROR);
+
+    queue->head = 0;
+    queue->count = 0;
+    queue->deviceNum = 0;
+    queue->pollNum = 0;
+    queue->running = false;
+    queue->readPhase = false;
+    queue->startTick = 0;
+    queue->lastTick = DCL_SYSTICK_GetTick();
+    handle->handleEx.busQueue = queue;
+    HAL_SPI_BusClearStatEx(handle);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Add a device to the bus.
+  * @param handle SPI handle.
+  * @param device Device, copied.
+  * @param devId Identifier of the device, used by the transactions.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_SPI_BusAddDeviceEx(SPI_Handle *handle, const SPI_BusDevice *device, unsigned int *devId)
+{
+    SPI_BusQueue *queue = NULL;
+    unsigned int lock;
+    SPI_ASSERT_PARAM(handle != NULL && device != NULL && devId != NULL);
+    SPI_PARAM_CHECK_WITH_RET(handle->handleEx.busQueue != NULL, BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(device->csChannel < SPI_CHIP_SELECT_CHANNEL_MAX, BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(IsSpiClkPolarity(device->clkPolarity), BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(IsSpiClkPhase(device->clkPhase), BASE_STATUS_ERROR);
+
+    queue = handle->handleEx.busQueue;
+    lock = BASE_FUNC_IntLock();
+    if (queue->deviceNum >= SPI_BUS_DEVICE_NUM) {
+        BASE_FUNC_IntUnlock(lock);
+        return BASE_STATUS_ERROR;
+    }
+    queue->device[queue->deviceNum] = *device;
+    *devId = queue->deviceNum++;
+    BASE_FUNC_IntUnlock(lock);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Queue a transaction.
+  * @param handle SPI handle.
+  * @param xfer Transaction, copied into the queue.
+  * @retval BASE status type: OK, ERROR, BUSY if the queue is full.
+  */
+BASE_StatusType HAL_SPI_BusSubmitEx(SPI_Handle *handle, const SPI_BusXfer *xfer)
+{
+    BASE_StatusType ret;
+    unsigned int lock;
+    SPI_ASSERT_PARAM(handle != NULL && xfer != NULL);
+    SPI_PARAM_CHECK_WITH_RET(handle->handleEx.busQueue != NULL, BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(SPI_BusIsValidXfer(handle, xfer), BASE_STATUS_ERROR);
+
+    lock = BASE_FUNC_IntLock();
+    ret = SPI_BusQueueXfer(handle, xfer, SPI_BUS_POLL_NONE);
+    BASE_FUNC_IntUnlock(lock);
+    return ret;
+}
+
+/**
+  * @brief Add a periodic polling job, enabled.
+  * @param handle SPI handle.
+  * @param xfer Transaction queued at each period, copied.
+  * @param period Period in HAL_SPI_BusTickEx() calls.
+  * @param pollId Identifier of the polling job.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_SPI_BusAddPollEx(SPI_Handle *handle, const SPI_BusXfer *xfer, unsigned int period,
+                                     unsigned int *pollId)
+{
+    SPI_BusQueue *queue = NULL;
+    SPI_BusPoll *poll = NULL;
+    unsigned int lock;
+    SPI_ASSERT_PARAM(handle != NULL && xfer != NULL && pollId != NULL);
+    SPI_PARAM_CHECK_WITH_RET(handle->handleEx.busQueue != NULL, BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(SPI_BusIsValidXfer(handle, xfer), BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(period > 0, BASE_STATUS_ERROR);
+
+    queue = handle->handleEx.busQueue;
+    lock = BASE_FUNC_IntLock();
+    if (queue->pollNum >= SPI_BUS_POLL_NUM) {
+        BASE_FUNC_IntUnlock(lock);
+        return BASE_STATUS_ERROR;
+    }
+    poll = &queue->poll[queue->pollNum];
+    poll->xfer = *xfer;
+    poll->period = period;
+    poll->countdown = period;
+    poll->pending = false;
+    poll->enable = true;
+    *pollId = queue->pollNum++;
+    BASE_FUNC_IntUnlock(lock);
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Enable or disable a polling job, a poll already queued still runs.
+  * @param handle SPI handle.
+  * @param pollId Identifier of the polling job.
+  * @param enable Enable flag.
+  * @retval BASE status type: OK, ERROR.
+  */
+BASE_StatusType HAL_SPI_BusSetPollEx(SPI_Handle *handle, unsigned int pollId, bool enable)
+{
+    SPI_BusPoll *poll = NULL;
+    SPI_ASSERT_PARAM(handle != NULL);
+    SPI_PARAM_CHECK_WITH_RET(handle->handleEx.busQueue != NULL, BASE_STATUS_ERROR);
+    SPI_PARAM_CHECK_WITH_RET(pollId < handle->handleEx.busQueue->pollNum, BASE_STATUS_ERROR);
+
+    poll = &handle->handleEx.busQueue->poll[pollId];
+    poll->countdown = poll->period;
+    poll->enable = enable;
+    return BASE_STATUS_OK;
+}
+
+/**
+  * @brief Periodic service: queue the due polling jobs and accumulate the elapsed time of the statistics. Call it
+  *        from a timer interrupt or the main loop, at least once per systick wrap.
+  * @param handle SPI handle.
+  * @retval None.
+  */
+void HAL_SPI_BusTickEx(SPI_Handle *handle)
+{
+    SPI_BusQueue *queue = NULL;
+    SPI_BusPoll *poll = NULL;
+    unsigned int lock;
+    SPI_ASSERT_PARAM(handle != NULL);
+    SPI_PARAM_CHECK_NO_RET(handle->handleEx.busQueue != NULL);
+
+    queue = handle->handleEx.busQueue;
+    lock = BASE_FUNC_IntLock();
+    queue->stat.elapsedTicks += BASE_FUNC_TicksSince(queue->lastTick);
+    queue->lastTick = DCL_SYSTICK_GetTick();
+    for (unsigned int i = 0; i < queue->pollNum; i++) {
+        poll = &queue->poll[i];
+        if (!poll->enable || --poll->countdown > 0) {
+            continue;
+        }
+        poll->countdown = poll->period;
+        if (poll->pending) {
+            queue->stat.pollOverrunCnt++;
+        } else if (SPI_BusQueueXfer(handle, &poll->xfer, i) == BASE_STATUS_OK) {
+            poll->pending = true;
+        }
+    }
+    BASE_FUNC_IntUnlock(lock);
+}
+
+/**
+  * @brief Check whether the transaction queue is empty.
+  * @param handle SPI handle.
+  * @retval bool true if no transaction is queued.
+  */
+bool HAL_SPI_BusIsIdleEx(const SPI_Handle *handle)
+{
+    SPI_ASSERT_PARAM(handle != NULL);
+    return handle->handleEx.busQueue == NULL || handle->handleEx.busQueue->count == 0;
+}
+
+/**
+  * @brief Get the transaction queue statistics.
+  * @param handle SPI handle.
+  * @param stat Statistics.
+  * @retval None.
+  */
+void HAL_SPI_BusGetStatEx(const SPI_Handle *handle, SPI_BusStat *stat)
+{
+    unsigned int lock;
+    SPI_ASSERT_PARAM(handle != NULL && stat != NULL);
+    SPI_PARAM_CHECK_NO_RET(handle->handleEx.busQueue != NULL);
+    lock = BASE_FUNC_IntLock();
+    *stat = handle->handleEx.busQueue->stat;
+    BASE_FUNC_IntUnlock(lock);
+}
+
+/**
+  * @brief Clear the transaction queue statistics.
+  * @param handle SPI handle.
+  * @retval None.
+  */
+void HAL_SPI_BusClearStatEx(SPI_Handle *handle)
+{
+    SPI_BusStat *stat = NULL;
+    unsigned int lock;
+    SPI_ASSERT_PARAM(handle != NULL);
+    SPI_PARAM_CHECK_NO_RET(handle->handleEx.busQueue != NULL);
+    stat = &handle->handleEx.busQueue->stat;
+    lock = BASE_FUNC_IntLock();
+    stat->xferCnt = 0;
+    stat->errCnt = 0;
+    stat->switchCnt = 0;
+    stat->queueFullCnt = 0;
+    stat->pollOverrunCnt = 0;
+    stat->maxQueueDepth = 0;
+    stat->maxWaitTicks = 0;
+    stat->maxXferTicks = 0;
+    stat->sumWaitTicks = 0;
+    stat->busyTicks = 0;
+    stat->elapsedTicks = 0;
+    handle->handleEx.busQueue->lastTick = DCL_SYSTICK_GetTick();
+    BASE_FUNC_IntUnlock(lock);
+}
 
 /**
   * @brief Interrupt Handling Function.
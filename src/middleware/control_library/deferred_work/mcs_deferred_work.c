@@ -0,0 +1,168 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_deferred_work.c
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions of deferred work module.
+  * @details   Interrupts post registered work items, a low priority context (main loop, idle loop or
+  *            a NOS task) drains them with DWQ_Run. The core has no atomic instructions, so instead of a
+  *            shared ring the queue keeps a per-item pending flag: each flag is written by a single store,
+  *            producers never contend with each other and the drain only scans the registration table.
+  */
+
+#include "mcs_deferred_work.h"
+#include "mcs_assert.h"
+#include "systick.h"
+
+/**
+  * @brief Initializer of deferred work queue.
+  * @param dwq Pointer of deferred work queue.
+  * @retval None.
+  */
+void DWQ_Init(DWQ_Handle *dwq)
+{
+    MCS_ASSERT_PARAM(dwq != NULL);
+    for (unsigned int prio = 0; prio < DWQ_PRIO_NUM; prio++) {
+        dwq->workNum[prio] = 0;
+        for (unsigned int i = 0; i < DWQ_WORK_NUM_PER_PRIO; i++) {
+            dwq->work[prio][i] = NULL;
+        }
+    }
+}
+
+/**
+  * @brief Clear statistics of one work item.
+  * @param work Pointer of work item.
+  * @retval None.
+  */
+void DWQ_ClearStat(DWQ_Work *work)
+{
+    MCS_ASSERT_PARAM(work != NULL);
+    work->stat.postCnt = 0;
+    work->stat.coalesceCnt = 0;
+    work->stat.runCnt = 0;
+    work->stat.lastLatency = 0;
+    work->stat.maxLatency = 0;
+    work->stat.maxExecTime = 0;
+}
+
+/**
+  * @brief Register a work item, must be called before interrupts post it.
+  * @param dwq Pointer of deferred work queue.
+  * @param work Pointer of work item.
+  * @param func Work function.
+  * @param arg Argument of the work function.
+  * @param prio Work priority.
+  * @retval 0: success, -1: parameter error or the priority table is full.
+  */
+int DWQ_WorkRegister(DWQ_Handle *dwq, DWQ_Work *work, DWQ_WorkFunc func, void *arg, DWQ_Prio prio)
+{
+    MCS_ASSERT_PARAM(dwq != NULL);
+    MCS_ASSERT_PARAM(work != NULL);
+    MCS_ASSERT_PARAM(func != NULL);
+    if (prio >= DWQ_PRIO_NUM || dwq->workNum[prio] >= DWQ_WORK_NUM_PER_PRIO) {
+        return -1;
+    }
+    work->func = func;
+    work->arg = arg;
+    work->prio = (unsigned char)prio;
+    work->pending = 0;
+    work->postTick = 0;
+    DWQ_ClearStat(work);
+    dwq->work[prio][dwq->workNum[prio]] = work;
+    dwq->workNum[prio]++;
+    return 0;
+}
+
+/**
+  * @brief Post a work item, callable from interrupt context.
+  * @param work Pointer of work item.
+  * @retval None.
+  */
+void DWQ_Post(DWQ_Work *work)
+{
+    MCS_ASSERT_PARAM(work != NULL);
+    work->stat.postCnt++;
+    if (work->pending != 0) {
+        /* Coalesce: the pending run will observe the newest data. */
+        work->stat.coalesceCnt++;
+        return;
+    }
+    work->postTick = DCL_SYSTICK_GetTick();
+    work->pending = 1;
+}
+
+/**
+  * @brief Execute one pending work item and update its statistics.
+  * @param work Pointer of work item.
+  * @retval None.
+  */
+static void DWQ_Exec(DWQ_Work *work)
+{
+    unsigned int startTick = DCL_SYSTICK_GetTick();
+    unsigned int latency = startTick - work->postTick;
+    unsigned int execTime;
+    /* Clear before running so that posts during execution schedule a new run. */
+    work->pending = 0;
+    work->func(work->arg);
+    execTime = DCL_SYSTICK_GetTick() - startTick;
+
+    work->stat.runCnt++;
+    work->stat.lastLatency = latency;
+    work->stat.maxLatency = (latency > work->stat.maxLatency) ? latency : work->stat.maxLatency;
+    work->stat.maxExecTime = (execTime > work->stat.maxExecTime) ? execTime : work->stat.maxExecTime;
+}
+
+/**
+  * @brief Find the first pending work item in priority order.
+  * @param dwq Pointer of deferred work queue.
+  * @retval Pending work item, NULL if the queue is empty.
+  */
+static DWQ_Work *DWQ_FindPending(DWQ_Handle *dwq)
+{
+    for (unsigned int prio = 0; prio < DWQ_PRIO_NUM; prio++) {
+        for (unsigned int i = 0; i < dwq->workNum[prio]; i++) {
+            if (dwq->work[prio][i]->pending != 0) {
+                return dwq->work[prio][i];
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+  * @brief Drain pending work items, highest priority first. The search restarts after every item,
+  *        so work posted by an interrupt during a low priority item runs next.
+  * @param dwq Pointer of deferred work queue.
+  * @param maxWorkNum Maximum number of items executed in this call, 0 means until the queue is empty.
+  * @retval Number of executed items.
+  */
+unsigned int DWQ_Run(DWQ_Handle *dwq, unsigned int maxWorkNum)
+{
+    MCS_ASSERT_PARAM(dwq != NULL);
+    unsigned int runNum = 0;
+    DWQ_Work *work = DWQ_FindPending(dwq);
+    while (work != NULL) {
+        DWQ_Exec(work);
+        runNum++;
+        if (maxWorkNum != 0 && runNum >= maxWorkNum) {
+            break;
+        }
+        work = DWQ_FindPending(dwq);
+    }
+    return runNum;
+}
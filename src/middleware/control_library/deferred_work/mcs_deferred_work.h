@@ -0,0 +1,94 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_deferred_work.h
+  * @author    MCU Algorithm Team
+  * @brief     Deferred work queue for offloading non-critical work out of interrupt context.
+  *            This file provides functions declaration of the deferred work module.
+  */
+
+#ifndef McuMagicTag_MCS_DEFERRED_WORK_H
+#define McuMagicTag_MCS_DEFERRED_WORK_H
+
+/* Macro definitions --------------------------------------------------------------------------- */
+#define DWQ_WORK_NUM_PER_PRIO    8    /**< Maximum number of work items registered per priority. */
+
+/* Typedef definitions ------------------------------------------------------------------------- */
+/**
+  * @brief Work function executed in the drain context.
+  */
+typedef void (*DWQ_WorkFunc)(void *arg);
+
+/**
+  * @brief Work priority, DWQ_PRIO_HIGH is drained first.
+  */
+typedef enum {
+    DWQ_PRIO_HIGH = 0,
+    DWQ_PRIO_MID,
+    DWQ_PRIO_LOW,
+    DWQ_PRIO_NUM
+} DWQ_Prio;
+
+/**
+  * @brief Statistics of one work item, latency and execution time are in systick counts.
+  */
+typedef struct {
+    unsigned int postCnt;       /**< Number of DWQ_Post calls. */
+    unsigned int coalesceCnt;   /**< Posts merged into an already pending run. */
+    unsigned int runCnt;        /**< Number of executions. */
+    unsigned int lastLatency;   /**< Post-to-start latency of the last execution. */
+    unsigned int maxLatency;    /**< Maximum post-to-start latency. */
+    unsigned int maxExecTime;   /**< Maximum execution time of the work function. */
+} DWQ_WorkStat;
+
+/**
+  * @brief Deferred work item.
+  * @note  Posting only writes fields owned by the item, so it is lock-free and O(1) from any
+  *        interrupt. A post while the item is pending is coalesced into the pending run.
+  */
+typedef struct {
+    DWQ_WorkFunc func;             /**< Work function. */
+    void *arg;                     /**< Argument of the work function. */
+    volatile unsigned char pending; /**< Set by the producer, cleared by the drain before running. */
+    unsigned char prio;            /**< Priority, see DWQ_Prio. */
+    volatile unsigned int postTick; /**< Systick count of the first post of the pending run. */
+    DWQ_WorkStat stat;             /**< Latency and coalescing statistics. */
+} DWQ_Work;
+
+/**
+  * @brief Deferred work queue, one registration table per priority.
+  */
+typedef struct {
+    DWQ_Work *work[DWQ_PRIO_NUM][DWQ_WORK_NUM_PER_PRIO];  /**< Registered work items. */
+    unsigned char workNum[DWQ_PRIO_NUM];                 /**< Number of registered items per priority. */
+} DWQ_Handle;
+
+/**
+  * @defgroup DEFERRED_WORK_API  DEFERRED WORK API
+  * @brief The deferred work API definitions.
+  * @{
+  */
+void DWQ_Init(DWQ_Handle *dwq);
+int DWQ_WorkRegister(DWQ_Handle *dwq, DWQ_Work *work, DWQ_WorkFunc func, void *arg, DWQ_Prio prio);
+void DWQ_Post(DWQ_Work *work);
+unsigned int DWQ_Run(DWQ_Handle *dwq, unsigned int maxWorkNum);
+void DWQ_ClearStat(DWQ_Work *work);
+/**
+  * @}
+  */
+
+#endif
@@ -17,11 +17,12 @@
   * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
   * @file      mcs_filter.c
   * @author    MCU Algorithm Team
-  * @brief     This file provides functions of first-order filter.
+  * @brief     This file provides functions of first-order filter and notch filter.
   */
 
 #include "mcs_filter.h"
 #include "mcs_math_const.h"
+#include "mcs_math.h"
 #include "mcs_assert.h"
 
 /**
@@ -91,4 +92,62 @@ void FOLPF_SetTs(FOFLT_Handle *lpfHandle, float ts)
     float wcTs = DOUBLE_PI * lpfHandle->fc * ts;
     lpfHandle->a1 = 1.0f / (1.0f + wcTs); /* wcTs > 0 */
     lpfHandle->b1 = 1.0f - lpfHandle->a1;
-}
\ No newline at end of file
+}
+
+/**
+  * @brief Initialzer of second-order notch filter handle.
+  * @param notchHandle Notch filter handle.
+  * @param ts Control period (s).
+  * @param f0 Notch frequency (Hz), below the Nyquist frequency.
+  * @param q Quality factor, the -3dB width of the notch is f0/q.
+  * @retval None.
+  */
+void NOTCH_Init(NOTCH_Handle *notchHandle, float ts, float f0, float q)
+{
+    MCS_ASSERT_PARAM(notchHandle != NULL);
+    MCS_ASSERT_PARAM(ts > 0.0f);
+    MCS_ASSERT_PARAM(f0 > 0.0f && f0 * ts < 0.5f);
+    MCS_ASSERT_PARAM(q > 0.0f);
+    notchHandle->ts = ts;
+    notchHandle->f0 = f0;
+    notchHandle->q = q;
+
+    NOTCH_Clear(notchHandle);
+
+    /* w = 2*pi*f0*ts, alpha = sin(w)/(2q), all coefficients divided by a0 = 1+alpha */
+    TrigVal trig;
+    TrigCalc(&trig, DOUBLE_PI * f0 * ts);
+    float alpha = trig.sin / (2.0f * q);
+    float a0 = 1.0f + alpha;
+    notchHandle->b0 = 1.0f / a0;
+    notchHandle->b1 = -2.0f * trig.cos / a0;
+    notchHandle->a2 = (1.0f - alpha) / a0;
+}
+
+/**
+  * @brief Clear historical values of notch filter handle.
+  * @param notchHandle Notch filter handle.
+  * @retval None.
+  */
+void NOTCH_Clear(NOTCH_Handle *notchHandle)
+{
+    MCS_ASSERT_PARAM(notchHandle != NULL);
+    notchHandle->s1 = 0.0f;
+    notchHandle->s2 = 0.0f;
+}
+
+/**
+  * @brief Calculation method of notch filter.
+  * @param notchHandle Notch filter handle.
+  * @param u The signal that wants to be filtered.
+  * @retval The signal that is filtered.
+  */
+float NOTCH_Exec(NOTCH_Handle *notchHandle, float u)
+{
+    MCS_ASSERT_PARAM(notchHandle != NULL);
+    float out = notchHandle->b0 * u + notchHandle->s1;
+    /* a1 = b1 and b2 = b0 for a notch */
+    notchHandle->s1 = notchHandle->b1 * (u - out) + notchHandle->s2;
+    notchHandle->s2 = notchHandle->b0 * u - notchHandle->a2 * out;
+    return out;
+}
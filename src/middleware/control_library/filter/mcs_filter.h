@@ -42,6 +42,21 @@ typedef struct {
     float b2;         /**< Coefficient of 1st-order filter. */
 } FOFLT_Handle;
 
+/**
+  * @brief 2nd-order notch filter struct members and parameters, transposed direct form II.
+  * y(k)=b0*u(k)+s1, s1=b1*u(k)-a1*y(k)+s2, s2=b0*u(k)-a2*y(k)
+  */
+typedef struct {
+    float s1;         /**< First state of the notch filter. */
+    float s2;         /**< Second state of the notch filter. */
+    float f0;         /**< Notch frequency (Hz). */
+    float q;          /**< Quality factor, the -3dB width is f0/q. */
+    float ts;         /**< Notch filter running period. */
+    float b0;         /**< Coefficient of notch filter, b2 = b0. */
+    float b1;         /**< Coefficient of notch filter, a1 = b1. */
+    float a2;         /**< Coefficient of notch filter. */
+} NOTCH_Handle;
+
 
 /**
  * @defgroup FILTER_API FILTER API
@@ -53,6 +68,13 @@ void FOLPF_Clear(FOFLT_Handle *lpfHandle);
 float FOLPF_Exec(FOFLT_Handle *lpfHandle, float u);
 void FOLPF_SetTs(FOFLT_Handle *lpfHandle, float ts);
 
+/**
+ * Transfer Func: G(s) = (s^2+w0^2)/(s^2+(w0/q)s+w0^2), bilinear with the notch frequency prewarped.
+ */
+void NOTCH_Init(NOTCH_Handle *notchHandle, float ts, float f0, float q);
+void NOTCH_Clear(NOTCH_Handle *notchHandle);
+float NOTCH_Exec(NOTCH_Handle *notchHandle, float u);
+
 
 /**
   * @}
@@ -0,0 +1,314 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_mtpa_lut.c
+  * @author    MCU Algorithm Team
+  * @brief     This file provides the MTPA and Flux-Weakening reference lookup table for motor control.
+  * @details   The (id, iq) reference is solved from the motor model for a grid of torque and electrical speed
+  *            per bus voltage: the maximum-torque-per-ampere point while the stator voltage has margin, then the
+  *            constant torque point on the voltage limit, then the current and voltage limit intersection when
+  *            the torque cannot be reached. The period task only interpolates the table. Its output is meant as
+  *            idqRefRaw of FW_Exec, which passes it unchanged while the voltage has margin and integrates id down
+  *            when the limit is reached anyway (model error, cells on the limit, bus voltage dips).
+  */
+#include "mcs_mtpa_lut.h"
+#include "mcs_math.h"
+#include "mcs_math_const.h"
+#include "mcs_assert.h"
+
+#define MTPA_BISECT_NUM 24  /* Bisection steps of the solver, the current interval shrinks by 2^24. */
+
+/**
+  * @brief Torque of a dq current.
+  * @param model Motor model.
+  * @param id d-axis current (A).
+  * @param iq q-axis current (A).
+  * @retval Torque (Nm).
+  */
+static float MtpaTorque(const MTPA_Model *model, float id, float iq)
+{
+    return model->trqCoeff * (model->psif + (model->ld - model->lq) * id) * iq;
+}
+
+/**
+  * @brief Square of the stator flux of a dq current, the voltage divided by the speed.
+  * @param model Motor model.
+  * @param id d-axis current (A).
+  * @param iq q-axis current (A).
+  * @retval Square of the stator flux (Wb^2).
+  */
+static float MtpaFluxSquare(const MTPA_Model *model, float id, float iq)
+{
+    float fluxD = model->ld * id + model->psif;
+    float fluxQ = model->lq * iq;
+    return fluxD * fluxD + fluxQ * fluxQ;
+}
+
+/**
+  * @brief d-axis current of the MTPA point for a current amplitude.
+  * @param model Motor model.
+  * @param is Current amplitude (A).
+  * @retval d-axis current (A), 0 for a non-salient motor.
+  */
+static float MtpaIdOfCurr(const MTPA_Model *model, float is)
+{
+    float deltaL = model->lq - model->ld;
+    if (Abs(deltaL) < SMALL_FLOAT) {
+        return 0.0f;
+    }
+    /* dT/d(angle) = 0 on the current circle */
+    return (model->psif - Sqrt(model->psif * model->psif + 8.0f * deltaL * deltaL * is * is)) / (4.0f * deltaL);
+}
+
+/**
+  * @brief q-axis current that gives a torque with a d-axis current.
+  * @param model Motor model.
+  * @param trq Torque (Nm).
+  * @param id d-axis current (A).
+  * @retval q-axis current (A), LARGE_FLOAT when the flux collapses.
+  */
+static float MtpaIqOfTrq(const MTPA_Model *model, float trq, float id)
+{
+    float trqPerIq = model->trqCoeff * (model->psif + (model->ld - model->lq) * id);
+    return (trqPerIq > SMALL_FLOAT) ? (trq / trqPerIq) : LARGE_FLOAT;
+}
+
+/**
+  * @brief MTPA point of a torque.
+  * @param model Motor model.
+  * @param trq Torque (Nm), up to the MTPA torque of the maximum current.
+  * @param idq MTPA current (A).
+  * @retval None.
+  */
+static void MtpaPointOfTrq(const MTPA_Model *model, float trq, DqAxis *idq)
+{
+    float lo = 0.0f;
+    float hi = model->currMax;
+    /* The MTPA torque grows with the current amplitude. */
+    for (unsigned int i = 0; i < MTPA_BISECT_NUM; i++) {
+        float is = 0.5f * (lo + hi);
+        float id = MtpaIdOfCurr(model, is);
+        if (MtpaTorque(model, id, Sqrt(Max(is * is - id * id, 0.0f))) < trq) {
+            lo = is;
+        } else {
+            hi = is;
+        }
+    }
+    idq->d = MtpaIdOfCurr(model, hi);
+    idq->q = Sqrt(Max(hi * hi - idq->d * idq->d, 0.0f));
+}
+
+/**
+  * @brief Point of the current limit that still meets the voltage limit, the highest torque there.
+  * @param model Motor model.
+  * @param fluxMaxSquare Square of the stator flux limit (Wb^2).
+  * @param idq Current on the limit (A).
+  * @retval None.
+  */
+static void MtpaLimitPoint(const MTPA_Model *model, float fluxMaxSquare, DqAxis *idq)
+{
+    float currMax = model->currMax;
+    if (MtpaFluxSquare(model, -currMax, 0.0f) > fluxMaxSquare) {
+        /* Even the whole current on the d-axis leaves no voltage margin, no torque at this speed. */
+        idq->d = (model->ld > SMALL_FLOAT) ? -Min(currMax, model->psif / model->ld) : -currMax;
+        idq->q = 0.0f;
+        return;
+    }
+    /* On the current circle the flux falls as id goes negative, keep the largest id inside the limit. */
+    float lo = -currMax;
+    float hi = MtpaIdOfCurr(model, currMax);
+    for (unsigned int i = 0; i < MTPA_BISECT_NUM; i++) {
+        float id = 0.5f * (lo + hi);
+        if (MtpaFluxSquare(model, id, Sqrt(Max(currMax * currMax - id * id, 0.0f))) <= fluxMaxSquare) {
+            lo = id;
+        } else {
+            hi = id;
+        }
+    }
+    idq->d = lo;
+    idq->q = Sqrt(Max(currMax * currMax - lo * lo, 0.0f));
+}
+
+/**
+  * @brief Motor model of the reference solver.
+  * @param model Motor model.
+  * @param mtrParam Motor parameters, mtrNp, mtrLd, mtrLq and mtrPsif are used.
+  * @param currMax Maximum phase current (A).
+  * @param voltRatio Usable part of the maximum phase voltage udc / sqrt(3), the modulation margin.
+  * @retval None.
+  */
+void MTPA_ModelInit(MTPA_Model *model, const MOTOR_Param *mtrParam, float currMax, float voltRatio)
+{
+    MCS_ASSERT_PARAM(model != NULL);
+    MCS_ASSERT_PARAM(mtrParam != NULL);
+    MCS_ASSERT_PARAM(mtrParam->mtrPsif > 0.0f);
+    MCS_ASSERT_PARAM(currMax > 0.0f);
+    MCS_ASSERT_PARAM(voltRatio > 0.0f && voltRatio <= 1.0f);
+    model->trqCoeff = 1.5f * (float)mtrParam->mtrNp;
+    model->ld = mtrParam->mtrLd;
+    model->lq = mtrParam->mtrLq;
+    model->psif = mtrParam->mtrPsif;
+    model->currMax = currMax;
+    /* we * flux <= voltRatio * udc / sqrt(3), we = 2 * pi * spd */
+    model->fluxCoeff = voltRatio * ONE_DIV_SQRT3 * ONE_DIV_DOUBLE_PI;
+}
+
+/**
+  * @brief Solve the current reference of a torque at an electrical speed per bus voltage, resistance neglected.
+  * @param model Motor model.
+  * @param trq Torque (Nm), not negative.
+  * @param spdPerVolt Electrical speed divided by the bus voltage (Hz/V), not negative.
+  * @param idq Current reference (A).
+  * @retval true if the torque is reached inside the current and voltage limits, false for the limit point.
+  */
+bool MTPA_PointCalc(const MTPA_Model *model, float trq, float spdPerVolt, DqAxis *idq)
+{
+    MCS_ASSERT_PARAM(model != NULL);
+    MCS_ASSERT_PARAM(trq >= 0.0f);
+    MCS_ASSERT_PARAM(spdPerVolt >= 0.0f);
+    MCS_ASSERT_PARAM(idq != NULL);
+    DqAxis mtpa;
+    MtpaPointOfTrq(model, trq, &mtpa);
+    float fluxMax = (spdPerVolt > SMALL_FLOAT) ? (model->fluxCoeff / spdPerVolt) : LARGE_FLOAT;
+    float fluxMaxSquare = fluxMax * fluxMax;
+    if (MtpaFluxSquare(model, mtpa.d, mtpa.q) <= fluxMaxSquare) {
+        *idq = mtpa;
+        return true;
+    }
+    /* Flux-weakening along the constant torque curve: the flux falls and the current grows as id goes negative. */
+    float lo = -model->currMax;
+    float hi = mtpa.d;
+    if (MtpaFluxSquare(model, lo, MtpaIqOfTrq(model, trq, lo)) <= fluxMaxSquare) {
+        for (unsigned int i = 0; i < MTPA_BISECT_NUM; i++) {
+            float id = 0.5f * (lo + hi);
+            if (MtpaFluxSquare(model, id, MtpaIqOfTrq(model, trq, id)) <= fluxMaxSquare) {
+                lo = id;
+            } else {
+                hi = id;
+            }
+        }
+        float iq = MtpaIqOfTrq(model, trq, lo);
+        if (lo * lo + iq * iq <= model->currMax * model->currMax) {
+            idq->d = lo;
+            idq->q = iq;
+            return true;
+        }
+    }
+    MtpaLimitPoint(model, fluxMaxSquare, idq);
+    return false;
+}
+
+/**
+  * @brief Build the lookup table from the motor model, at init or offline.
+  * @param lut Lookup table.
+  * @param model Motor model.
+  * @param spdPerVoltMax Highest electrical speed per bus voltage (Hz/V), maximum speed over the lowest bus voltage.
+  * @retval None.
+  */
+void MTPA_LutBuild(MTPA_Lut *lut, const MTPA_Model *model, float spdPerVoltMax)
+{
+    MCS_ASSERT_PARAM(lut != NULL);
+    MCS_ASSERT_PARAM(model != NULL);
+    MCS_ASSERT_PARAM(spdPerVoltMax > 0.0f);
+    DqAxis top;
+    MtpaPointOfTrq(model, LARGE_FLOAT, &top);
+    lut->trqMax = MtpaTorque(model, top.d, top.q);
+    lut->spdPerVoltMax = spdPerVoltMax;
+    for (unsigned int i = 0; i < MTPA_LUT_TRQ_NUM; i++) {
+        float trq = lut->trqMax * (float)i / (float)(MTPA_LUT_TRQ_NUM - 1);
+        lut->limitMask[i] = 0;
+        for (unsigned int j = 0; j < MTPA_LUT_SPD_NUM; j++) {
+            float spdPerVolt = spdPerVoltMax * (float)j / (float)(MTPA_LUT_SPD_NUM - 1);
+            if (!MTPA_PointCalc(model, trq, spdPerVolt, &lut->point[i][j])) {
+                lut->limitMask[i] |= (1U << j);
+            }
+        }
+    }
+}
+
+/**
+  * @brief MTPA lookup handle initialization.
+  * @param mtpa MTPA lookup handle.
+  * @param lut Lookup table built by MTPA_LutBuild, in RAM or a const table generated offline.
+  * @retval None.
+  */
+void MTPA_Init(MTPA_Handle *mtpa, const MTPA_Lut *lut)
+{
+    MCS_ASSERT_PARAM(mtpa != NULL);
+    MCS_ASSERT_PARAM(lut != NULL);
+    MCS_ASSERT_PARAM(lut->trqMax > 0.0f && lut->spdPerVoltMax > 0.0f);
+    mtpa->lut = lut;
+    mtpa->trqStepInv = (float)(MTPA_LUT_TRQ_NUM - 1) / lut->trqMax;
+    mtpa->spdStepInv = (float)(MTPA_LUT_SPD_NUM - 1) / lut->spdPerVoltMax;
+    mtpa->atLimit = false;
+}
+
+/**
+  * @brief Cell index and weight of a table coordinate.
+  * @param pos Coordinate in table steps, not negative.
+  * @param num Number of table points.
+  * @param idx Index of the lower point of the cell.
+  * @retval Weight of the upper point, 0 ~ 1.
+  */
+static float MtpaCell(float pos, unsigned int num, unsigned int *idx)
+{
+    unsigned int i = (unsigned int)pos;
+    if (i >= num - 1) {
+        *idx = num - 2;
+        return 1.0f;
+    }
+    *idx = i;
+    return pos - (float)i;
+}
+
+/**
+  * @brief Current reference from the lookup table, bilinear interpolation of the four cell corners.
+  * @param mtpa MTPA lookup handle.
+  * @param trqRef Torque reference (Nm), the sign gives the sign of iq.
+  * @param spd Electrical speed (Hz).
+  * @param udc Bus voltage (V).
+  * @param idqRef Current reference (A).
+  * @retval false if the reference is on the current or voltage limit, FW_Exec then has to act.
+  */
+bool MTPA_Exec(MTPA_Handle *mtpa, float trqRef, float spd, float udc, DqAxis *idqRef)
+{
+    MCS_ASSERT_PARAM(mtpa != NULL);
+    MCS_ASSERT_PARAM(udc > 0.0f);
+    MCS_ASSERT_PARAM(idqRef != NULL);
+    const MTPA_Lut *lut = mtpa->lut;
+    float trq = Abs(trqRef);
+    float spdPerVolt = Abs(spd) / udc;
+    unsigned int i;
+    unsigned int j;
+    float wt = MtpaCell(trq * mtpa->trqStepInv, MTPA_LUT_TRQ_NUM, &i);
+    float ws = MtpaCell(spdPerVolt * mtpa->spdStepInv, MTPA_LUT_SPD_NUM, &j);
+    const DqAxis *lo = &lut->point[i][j];
+    const DqAxis *hi = &lut->point[i + 1][j];
+    float idLo = lo[0].d + ws * (lo[1].d - lo[0].d);
+    float idHi = hi[0].d + ws * (hi[1].d - hi[0].d);
+    float iqLo = lo[0].q + ws * (lo[1].q - lo[0].q);
+    float iqHi = hi[0].q + ws * (hi[1].q - hi[0].q);
+    idqRef->d = idLo + wt * (idHi - idLo);
+    idqRef->q = iqLo + wt * (iqHi - iqLo);
+    if (trqRef < 0.0f) {
+        idqRef->q = -idqRef->q;
+    }
+    /* Outside the table or a cell corner on the limit. */
+    unsigned int mask = (lut->limitMask[i] | lut->limitMask[i + 1]) >> j;
+    mtpa->atLimit = (trq > lut->trqMax) || (spdPerVolt > lut->spdPerVoltMax) || ((mask & 0x3U) != 0);
+    return !mtpa->atLimit;
+}
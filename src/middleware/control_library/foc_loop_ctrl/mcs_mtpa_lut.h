@@ -0,0 +1,70 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_mtpa_lut.h
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions declaration of the MTPA and Flux-Weakening reference lookup table.
+  */
+#ifndef McuMagicTag_MCS_MTPA_LUT_H
+#define McuMagicTag_MCS_MTPA_LUT_H
+
+#include "typedefs.h"
+#include "mcs_typedef.h"
+#include "mcs_mtr_param.h"
+
+#define MTPA_LUT_TRQ_NUM    12  /* Torque points, 0 ~ trqMax. */
+#define MTPA_LUT_SPD_NUM    12  /* Speed per bus voltage points, 0 ~ spdPerVoltMax, at most 32. */
+
+/**
+  * @brief Motor model used to solve the current references.
+  */
+typedef struct {
+    float trqCoeff;     /* 1.5 * pole pairs */
+    float ld;           /* d-axis inductance (H) */
+    float lq;           /* q-axis inductance (H) */
+    float psif;         /* permanent magnet flux (Wb) */
+    float currMax;      /* maximum phase current (A) */
+    float fluxCoeff;    /* maximum stator flux times speed per bus voltage, voltRatio / (sqrt(3) * 2 * pi) */
+} MTPA_Model;
+
+/**
+  * @brief Current references over torque and electrical speed per bus voltage, built at init or offline.
+  */
+typedef struct {
+    DqAxis point[MTPA_LUT_TRQ_NUM][MTPA_LUT_SPD_NUM];   /* (id, iq) for positive torque (A) */
+    unsigned int limitMask[MTPA_LUT_TRQ_NUM];   /* bit j: point j is on the current and voltage limit */
+    float trqMax;           /* torque of the last row, MTPA at the maximum current (Nm) */
+    float spdPerVoltMax;    /* electrical speed per bus voltage of the last column (Hz/V) */
+} MTPA_Lut;
+
+typedef struct {
+    const MTPA_Lut *lut;
+    float trqStepInv;       /* rows per Nm */
+    float spdStepInv;       /* columns per Hz/V */
+    bool  atLimit;          /* last reference is on the limit, the voltage feedback FW_Exec has to act */
+} MTPA_Handle;
+
+void MTPA_ModelInit(MTPA_Model *model, const MOTOR_Param *mtrParam, float currMax, float voltRatio);
+
+bool MTPA_PointCalc(const MTPA_Model *model, float trq, float spdPerVolt, DqAxis *idq);
+
+void MTPA_LutBuild(MTPA_Lut *lut, const MTPA_Model *model, float spdPerVoltMax);
+
+void MTPA_Init(MTPA_Handle *mtpa, const MTPA_Lut *lut);
+
+bool MTPA_Exec(MTPA_Handle *mtpa, float trqRef, float spd, float udc, DqAxis *idqRef);
+#endif
@@ -20,8 +20,41 @@
   * @brief     This file provides function of power factor correction(PFC) current control
   */
 #include "pfc_curr_ctrl.h"
+#include "mcs_math.h"
+#include "mcs_math_const.h"
 #include "mcs_assert.h"
 
+/**
+  * @brief Initialzer of power factor correction(PFC) current controller.
+  * @param currCtrl PFC current control structure
+  * @param param Current controller parameters.
+  * @param ts Control period (s), the PWM period of one phase.
+  * @retval None.
+  */
+void PFC_CurrCtrlInit(PFC_CURRCTRL_Handle *currCtrl, const PFC_CurrCtrlParam *param, float ts)
+{
+    MCS_ASSERT_PARAM(currCtrl != NULL);
+    MCS_ASSERT_PARAM(param != NULL);
+    MCS_ASSERT_PARAM(param->phaseNum >= 1 && param->phaseNum <= PFC_PHASE_MAX);
+    MCS_ASSERT_PARAM(param->maxCurrFdbk > 0.0f);
+    MCS_ASSERT_PARAM(ts > 0.0f);
+    MCS_ASSERT_PARAM(param->mode == PFC_CURR_MODE_PI || param->inductance > 0.0f);
+    currCtrl->mode = param->mode;
+    currCtrl->phaseNum = param->phaseNum;
+    currCtrl->maxCurrFdbk = param->maxCurrFdbk;
+    currCtrl->dutyMax = param->dutyMax;
+    currCtrl->dbGain = param->dbGain;
+    currCtrl->indDivTs = param->inductance / ts;
+    currCtrl->tsDivInd = (param->inductance > 0.0f) ? (ts / param->inductance) : 0.0f;
+
+    PID_Reset(&currCtrl->currPiCtrl);
+    currCtrl->currPiCtrl.kp = param->pi.kp;
+    currCtrl->currPiCtrl.ki = param->pi.ki;
+    currCtrl->currPiCtrl.upperLimit = param->pi.upperLim;
+    currCtrl->currPiCtrl.lowerLimit = param->pi.lowerLim;
+    currCtrl->currPiCtrl.ts = ts;
+    PFC_CurrCtrlClear(currCtrl);
+}
 
 /**
   * @brief Clear historical values of power factor correction(PFC) current controller.
@@ -33,10 +66,40 @@ void PFC_CurrCtrlClear(PFC_CURRCTRL_Handle *currCtrl)
     MCS_ASSERT_PARAM(currCtrl != NULL);
     currCtrl->currPiCtrl.differ = 0.0f;
     currCtrl->currPiCtrl.integral = 0.0f;
+    currCtrl->pwmDuty = 0.0f;
+    currCtrl->ffDuty = 0.0f;
+    for (unsigned int i = 0; i < PFC_PHASE_MAX; i++) {
+        currCtrl->phaseDuty[i] = 0.0f;
+    }
+}
+
+/**
+  * @brief Feed-forward and deadbeat duty of the interleaved boost stage.
+  * With the duty d the current of n phases rises by n*(vin-(1-d)*vout)*ts/L in one period. The duty computed
+  * now is loaded at the next period, so the deadbeat first predicts the current when it takes effect.
+  * @param currCtrl PFC current control structure
+  * @param invVout Inverse of the bus voltage, 0 when the current cannot be controlled.
+  * @retval Duty before clamping.
+  */
+static float PfcModelDuty(PFC_CURRCTRL_Handle *currCtrl, float invVout)
+{
+    float vin = currCtrl->rectVoltFdbk;
+    float vout = currCtrl->busVoltFdbk;
+    float ffDuty = (invVout > 0.0f) ? (1.0f - vin * invVout) : 0.0f;
+    float duty = ffDuty + PI_Exec(&currCtrl->currPiCtrl);
+    if (currCtrl->mode == PFC_CURR_MODE_DEADBEAT) {
+        float phaseNum = (float)currCtrl->phaseNum;
+        float currPred = currCtrl->currFdbk +
+                         phaseNum * currCtrl->tsDivInd * (vin - (1.0f - currCtrl->pwmDuty) * vout);
+        duty += currCtrl->dbGain * currCtrl->indDivTs * invVout / phaseNum *
+                (currCtrl->currRef * currCtrl->maxCurrFdbk - currPred);
+    }
+    currCtrl->ffDuty = ffDuty;
+    return duty;
 }
 
 /**
-  * @brief Simplified power factor correction(PFC) current controller PI calculation.
+  * @brief Power factor correction(PFC) current controller, all interleaved phases in one call.
   * @param currCtrl PFC current control structure
   * @retval None.
   */
@@ -45,6 +108,27 @@ void PFC_CurrCtrlExec(PFC_CURRCTRL_Handle *currCtrl)
     MCS_ASSERT_PARAM(currCtrl != NULL);
     /* Calculate the current error of power factor correction(PFC). */
     currCtrl->currPiCtrl.error = currCtrl->currRef - currCtrl->unitCurrFdbk;
-    /* Calculation the output pwm duty of power factor correction(PFC) current. */
-    currCtrl->pwmDuty = PI_Exec(&currCtrl->currPiCtrl);
+    if (currCtrl->mode == PFC_CURR_MODE_PI) {
+        /* Calculation the output pwm duty of power factor correction(PFC) current. */
+        currCtrl->pwmDuty = PI_Exec(&currCtrl->currPiCtrl);
+        for (unsigned int i = 0; i < currCtrl->phaseNum; i++) {
+            currCtrl->phaseDuty[i] = currCtrl->pwmDuty;
+        }
+        return;
+    }
+    /* Below the input voltage the boost stage cannot control the current, only the PI acts. */
+    float vout = currCtrl->busVoltFdbk;
+    float invVout = (vout > currCtrl->rectVoltFdbk && vout > SMALL_FLOAT) ? (1.0f / vout) : 0.0f;
+    currCtrl->pwmDuty = Clamp(PfcModelDuty(currCtrl, invVout), currCtrl->dutyMax, 0.0f);
+    if (currCtrl->phaseNum == 1) {
+        currCtrl->phaseDuty[0] = currCtrl->pwmDuty;
+        return;
+    }
+    /* Each phase is pulled towards the average phase current, balGain is the duty per 1A in one period. */
+    float balGain = currCtrl->dbGain * currCtrl->indDivTs * invVout;
+    float currAvg = currCtrl->currFdbk / (float)currCtrl->phaseNum;
+    for (unsigned int i = 0; i < currCtrl->phaseNum; i++) {
+        float duty = currCtrl->pwmDuty + balGain * (currAvg - currCtrl->phaseCurrFdbk[i]);
+        currCtrl->phaseDuty[i] = Clamp(duty, currCtrl->dutyMax, 0.0f);
+    }
 }
@@ -26,6 +26,9 @@
 /* Includes ------------------------------------------------------------------------------------ */
 #include "mcs_pid_ctrl.h"
 
+/* Macro definitions --------------------------------------------------------------------------- */
+#define PFC_PHASE_MAX 2   /* < interleaved boost phases on phase shifted APT channels */
+
 /**
   * @defgroup PFC_CURRENT_CONTROLLER PFC_CURRENT CONTROLLER MODULE
   * @brief The current controller function.
@@ -39,8 +42,19 @@
   */
 
 /* Typedef definitions ------------------------------------------------------------------------- */
+/**
+  * @brief Duty calculation of the current controller.
+  */
+typedef enum {
+    PFC_CURR_MODE_PI = 0,      /* < PI on the current error only */
+    PFC_CURR_MODE_FF,          /* < PI plus the boost duty feed-forward 1 - vin / vout */
+    PFC_CURR_MODE_DEADBEAT     /* < feed-forward plus the duty that reaches the reference in one period */
+} PFC_CurrMode;
+
 /**
   * @brief current Controller Struct members and parameters.
+  * The PI works on the unitary current (A / maxCurrFdbk) in all modes. The FF and deadbeat modes also use
+  * rectVoltFdbk, busVoltFdbk, currFdbk, and phaseCurrFdbk when more than one phase is interleaved.
   */
 typedef struct {
     float currRef;            /* < current loop control reference current(A) */
@@ -55,7 +69,30 @@ typedef struct {
     float unitRectVoltFdbk;   /* < current loop control rectified feedback unitary voltage */
     float compensation;
     PID_Handle currPiCtrl;     /* < current loop controller define */
+    PFC_CurrMode mode;         /* < duty calculation */
+    unsigned int phaseNum;     /* < interleaved phases, 1 ~ PFC_PHASE_MAX */
+    float busVoltFdbk;         /* < current loop control bus (boost output) feedback voltage(V) */
+    float phaseCurrFdbk[PFC_PHASE_MAX];  /* < inductor feedback current of each phase(A) */
+    float phaseDuty[PFC_PHASE_MAX];      /* < PWM duty of each phase, balanced on the phase currents */
+    float ffDuty;              /* < feed-forward duty of the last period */
+    float dutyMax;             /* < duty upper limit in the FF and deadbeat modes */
+    float dbGain;              /* < deadbeat and phase balance gain, 1 removes the error in one period */
+    float indDivTs;            /* < inductance of one phase divided by the control period (H/s) */
+    float tsDivInd;            /* < control period divided by the inductance of one phase (s/H) */
 } PFC_CURRCTRL_Handle;
+
+/**
+  * @brief Current controller parameters.
+  */
+typedef struct {
+    PFC_CurrMode mode;         /* < duty calculation */
+    unsigned int phaseNum;     /* < interleaved phases, 1 ~ PFC_PHASE_MAX */
+    float inductance;          /* < inductance of one phase(H), used by the FF and deadbeat modes */
+    float maxCurrFdbk;         /* < current of unitary 1(A) */
+    float dutyMax;             /* < duty upper limit */
+    float dbGain;              /* < deadbeat and phase balance gain, 0 ~ 1 */
+    PI_Param pi;               /* < PI, its limits bound the correction around the feed-forward duty */
+} PFC_CurrCtrlParam;
 /**
   * @}
   */
@@ -66,6 +103,8 @@ typedef struct {
   * @{
   */
 
+void PFC_CurrCtrlInit(PFC_CURRCTRL_Handle *currCtrl, const PFC_CurrCtrlParam *param, float ts);
+
 void PFC_CurrCtrlClear(PFC_CURRCTRL_Handle *currCtrl);
 
 void PFC_CurrCtrlExec(PFC_CURRCTRL_Handle *currCtrl);
@@ -1,5 +1,5 @@
 /**
-  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
   * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
   * following conditions are met:
   * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
@@ -15,35 +15,33 @@
   * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
   * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
   * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  * @file      mcs_temp_prot.h
+  * @file      pfc_interleave.c
   * @author    MCU Algorithm Team
-  * @brief     his file contains over temperature protection api declaration.
+  * @brief     This file provides function of power factor correction(PFC) phase interleaving
   */
+#include "pfc_interleave.h"
+#include "mcs_apt_sync.h"
+#include "mcs_assert.h"
 
-/* Define to prevent recursive inclusion ------------------------------------- */
-#ifndef McuMagicTag_MCS_TEMP_PROT_H
-#define McuMagicTag_MCS_TEMP_PROT_H
 
-/* Includes ------------------------------------------------------------------------------------ */
-#include "mcs_prot_cmm.h"
-#include "apt_ip.h"
-
-typedef struct {
-    unsigned int protCnt;
-    unsigned int recyCnt;
-    unsigned int protCntLimit;
-    unsigned int recyCntLimit;
-    float protValThr[PROT_VAL_THRESHOLD_NUMS]; /* from low current level to high. */
-    float protLimitTime[PROT_LIMIT_TIME_NUMS]; /* from level 3 to level 1. */
-    float recyDelta;
-    float ts;
-    float timer;
-    PROT_Level protLevel;
-} OTP_Handle;
-
-void OTP_Init(OTP_Handle *otp, float ts);
-void OTP_Det(OTP_Handle *otp,  MotorErrStatusReg *motorErrStatus, PROT_ErrBit protBit, float temp);
-void OTP_Exec(OTP_Handle *otp, float *spdRef, APT_RegStruct **aptAddr);
-void OTP_Recy(OTP_Handle *otp,  MotorErrStatusReg *motorErrStatus, PROT_ErrBit protBit, float temp);
-void OTP_Clear(OTP_Handle *otp);
-#endif
\ No newline at end of file
+/**
+  * @brief Counter phase of an interleaved PFC phase, for HAL_APT_SlaveSyncInit.
+  * Phase i of n lags the master phase 0 by i/n of the PWM period, so the inductor current ripples of the
+  * phases cancel at the input and the bus sees n times the switching frequency. The APT must be initialized
+  * (count mode and period) and run at the same period as the master, syncInSrc and cntrSyncSrc are left to
+  * the caller.
+  * @param aptx The APT handle of the phase.
+  * @param phaseIdx Index of the phase, 0 is the master.
+  * @param phaseNum Number of interleaved phases.
+  * @param slave The slave sync configuration to fill.
+  * @retval None.
+  */
+void PFC_InterleaveSlaveSync(const APT_Handle *aptx, unsigned int phaseIdx, unsigned int phaseNum,
+                             APT_SlaveSyncIn *slave)
+{
+    MCS_ASSERT_PARAM(aptx != NULL);
+    MCS_ASSERT_PARAM(slave != NULL);
+    MCS_ASSERT_PARAM(phaseNum > 0 && phaseIdx < phaseNum);
+    /* Part of the PWM period the phase has already run when the master counter restarts, in 1/phaseNum. */
+    MCS_AptSlaveSyncPhase(aptx, (phaseNum - phaseIdx) % phaseNum, phaseNum, slave);
+}
@@ -1,5 +1,5 @@
 /**
-  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
   * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
   * following conditions are met:
   * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
@@ -15,29 +15,35 @@
   * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
   * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
   * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  * @file      mcs_prot_cmm.c
+  * @file      pfc_interleave.h
   * @author    MCU Algorithm Team
-  * @brief     This file contains protection common api definition.
+  * @brief     Interleaving of the power factor correction(PFC) boost phases on phase shifted APT channels.
   */
- 
+/* Define to prevent recursive inclusion ------------------------------------------------------- */
+#ifndef McuMagicTag_PFC_INTERLEAVE_H
+#define McuMagicTag_PFC_INTERLEAVE_H
+
 /* Includes ------------------------------------------------------------------------------------ */
-#include "mcs_prot_cmm.h"
 #include "apt.h"
-#include "mcs_assert.h"
 
 /**
-  * @brief Safty-pulse-off function execution to turn off all the power devices.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
+  * @defgroup PFC_INTERLEAVE PFC_INTERLEAVE MODULE
+  * @brief The PFC interleaving function.
+  * @{
+  */
+
+/**
+  * @defgroup PFC_INTERLEAVE_API PFC_INTERLEAVE API
+  * @brief The PFC interleaving API declaration.
+  * @{
+  */
+void PFC_InterleaveSlaveSync(const APT_Handle *aptx, unsigned int phaseIdx, unsigned int phaseNum,
+                             APT_SlaveSyncIn *slave);
+/**
+  * @}
+  */
+
+/**
+  * @}
   */
-void ProtSpo_Exec(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /**< Turn off all the six power devices of the inverter. */
-    for (unsigned int i = 0; i < MOTOR_PHASE_NUMBER; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        DCL_APT_EnableSwContPWMAction(aptx, APT_PWM_CHANNEL_A);
-        DCL_APT_EnableSwContPWMAction(aptx, APT_PWM_CHANNEL_B);
-        DCL_APT_ForcePWMOutputLow(aptx);
-    }
-}
\ No newline at end of file
+#endif  /* McuMagicTag_PFC_INTERLEAVE_H */
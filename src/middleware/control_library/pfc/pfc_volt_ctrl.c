@@ -34,6 +34,27 @@ void PFC_VoltCtrlClear(PFC_VOLTCTRL_Handle *voltCtrl)
     MCS_ASSERT_PARAM(voltCtrl != NULL);
     voltCtrl->voltPiCtrl.differ = 0.0f;
     voltCtrl->voltPiCtrl.integral = 0.0f;
+    if (voltCtrl->notchEnable != 0) {
+        NOTCH_Clear(&voltCtrl->notch);
+    }
+}
+
+/**
+  * @brief Remove the 2x line frequency ripple of the bus voltage from the voltage loop feedback.
+  * Without the ripple in the loop the PI gains can be raised and the voltage loop recovers faster from a load
+  * step, while the current reference stays sinusoidal.
+  * @param voltCtrl PFC voltage control structure
+  * @param lineFreq AC line frequency (Hz).
+  * @param q Quality factor of the notch, the -3dB width is 2 * lineFreq / q.
+  * @param ts Voltage loop period (s).
+  * @retval None.
+  */
+void PFC_VoltCtrlNotchInit(PFC_VOLTCTRL_Handle *voltCtrl, float lineFreq, float q, float ts)
+{
+    MCS_ASSERT_PARAM(voltCtrl != NULL);
+    MCS_ASSERT_PARAM(lineFreq > 0.0f);
+    NOTCH_Init(&voltCtrl->notch, ts, 2.0f * lineFreq, q);
+    voltCtrl->notchEnable = 1;
 }
 
 /**
@@ -44,8 +65,10 @@ void PFC_VoltCtrlClear(PFC_VOLTCTRL_Handle *voltCtrl)
 void PFC_VoltCtrlExec(PFC_VOLTCTRL_Handle *voltCtrl)
 {
     MCS_ASSERT_PARAM(voltCtrl != NULL);
+    voltCtrl->notchVoltFdbk = (voltCtrl->notchEnable != 0) ?
+        NOTCH_Exec(&voltCtrl->notch, voltCtrl->unitVoltFdbk) : voltCtrl->unitVoltFdbk;
     /* Calculate the voltage error of power factor correction(PFC). */
-    voltCtrl->voltPiCtrl.error = voltCtrl->uniVoltRef - voltCtrl->unitVoltFdbk;
+    voltCtrl->voltPiCtrl.error = voltCtrl->uniVoltRef - voltCtrl->notchVoltFdbk;
     /* Calculation the voltage loop control output of power factor correction(PFC). */
     voltCtrl->voltOut = PI_Exec(&voltCtrl->voltPiCtrl);
 }
@@ -25,6 +25,7 @@
 
 /* Includes ------------------------------------------------------------------------------------ */
 #include "mcs_pid_ctrl.h"
+#include "mcs_filter.h"
 
 /**
   * @defgroup VOLTAGE_CONTROLLER VOLTAGE CONTROLLER MODULE
@@ -49,6 +50,9 @@ typedef struct {
     float startVolt;         /* < voltage loop control start voltage(V) */
     float voltOut;           /* < voltage loop control output */
     PID_Handle voltPiCtrl;    /* < voltage loop controller define */
+    float notchVoltFdbk;     /* < unitary feedback voltage without the 2x line frequency ripple */
+    unsigned int notchEnable; /* < remove the 2x line frequency ripple before the PI */
+    NOTCH_Handle notch;      /* < 2x line frequency notch filter */
 } PFC_VOLTCTRL_Handle;
 /**
   * @}
@@ -61,6 +65,8 @@ typedef struct {
   */
 void PFC_VoltCtrlClear(PFC_VOLTCTRL_Handle *voltCtrl);
 
+void PFC_VoltCtrlNotchInit(PFC_VOLTCTRL_Handle *voltCtrl, float lineFreq, float q, float ts);
+
 void PFC_VoltCtrlExec(PFC_VOLTCTRL_Handle *voltCtrl);
 /**
   * @}
@@ -0,0 +1,128 @@
+/**
+  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_curr_prot.c
+  * @author    MCU Algorithm Team
+  * @brief     This file contains current protecion api definition.
+  */
+ 
+/* Includes ------------------------------------------------------------------------------------ */
+#include "mcs_curr_prot.h"
+#include "mcs_math.h"
+#include "mcs_assert.h"
+
+/**
+  * @brief Initilization over current protection function.
+  * @param ocp Over current protection handle.
+  * @param cfg Over current levels on the current amplitude (A), squared, the actions are the current limits (A).
+  * @param ts Ctrl period (s).
+  * @retval None.
+  */
+void OCP_Init(OCP_Handle *ocp, const PROT_FaultCfg *cfg, float ts)
+{
+    MCS_ASSERT_PARAM(ocp != NULL);
+    MCS_ASSERT_PARAM(cfg != NULL);
+    MCS_ASSERT_PARAM(cfg->squared);
+    MCS_ASSERT_PARAM(ts > 0.0f);
+    PROT_FaultInit(ocp, cfg, ts);
+}
+
+/**
+  * @brief Over current protection detection and recovery.
+  * @param ocp Over current protection handle.
+  * @param motorErrStatus Motor error status.
+  * @param idq DQ-axis feedback currents.
+  * @retval None.
+  */
+void OCP_Det(OCP_Handle *ocp, MotorErrStatusReg *motorErrStatus, DqAxis idq)
+{
+    MCS_ASSERT_PARAM(ocp != NULL);
+    MCS_ASSERT_PARAM(motorErrStatus != NULL);
+    /* Level 4 is latched until OCP_Clear, the PWM output is off and the current reads zero. */
+    if (ocp->protLevel == PROT_LEVEL_4) {
+        return;
+    }
+    /* The thresholds are squared, no square root on the detection path. */
+    PROT_FaultUpdate(ocp, idq.d * idq.d + idq.q * idq.q, &motorErrStatus->all);
+}
+
+/**
+  * @brief Over current protection execution.
+  * @param ocp Over current protection handle.
+  * @param idqRef DQ-axis current references.
+  * @param aptAddr Three-phase APT address pointer.
+  * @retval None.
+  */
+void OCP_Exec(OCP_Handle *ocp, DqAxis *idqRef, APT_RegStruct **aptAddr)
+{
+    MCS_ASSERT_PARAM(ocp != NULL);
+    MCS_ASSERT_PARAM(idqRef != NULL);
+    MCS_ASSERT_PARAM(aptAddr != NULL);
+    /* According to protect level, take corresponding action. */
+    switch (ocp->protLevel) {
+        /* level 4: disable all PWM output. */
+        case PROT_LEVEL_4:
+            /* Disable three-phase pwm output. */
+            ProtSpo_Exec(aptAddr);
+            idqRef->d = 0.0f;
+            idqRef->q = 0.0f;
+            break;
+
+        /* level 1 to 3: limit the current to the level action once the level lasted its limit time. */
+        case PROT_LEVEL_3:
+        case PROT_LEVEL_2:
+        case PROT_LEVEL_1:
+            if (PROT_FaultIsTimeout(ocp)) {
+                float currLimit = ocp->cfg->action[ocp->protLevel - 1] / Sqrt(ocp->value);
+                idqRef->d = idqRef->d * currLimit;
+                idqRef->q = idqRef->q * currLimit;
+            }
+            break;
+
+        /* level 0: take no protection action. */
+        case PROT_LEVEL_0:
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+  * @brief Record an over current trip of the comparator path, the APT already forced the PWM output low.
+  * @param ocp Over current protection handle.
+  * @param motorErrStatus Motor error status.
+  * @retval None.
+  */
+void OCP_HwTrip(OCP_Handle *ocp, MotorErrStatusReg *motorErrStatus)
+{
+    MCS_ASSERT_PARAM(ocp != NULL);
+    MCS_ASSERT_PARAM(motorErrStatus != NULL);
+    PROT_FaultHwTrip(ocp, &motorErrStatus->all);
+}
+
+/**
+  * @brief Over current protection error status clear.
+  * @param ocp Over current protection handle.
+  * @retval None.
+  */
+void OCP_Clear(OCP_Handle *ocp)
+{
+    MCS_ASSERT_PARAM(ocp != NULL);
+    /* Clear the history value. */
+    PROT_FaultClear(ocp);
+}
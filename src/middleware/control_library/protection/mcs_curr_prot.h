@@ -26,27 +26,32 @@
 
 /* Includes ------------------------------------------------------------------------------------ */
 #include "mcs_prot_cmm.h"
+#include "mcs_prot_engine.h"
 #include "mcs_typedef.h"
 #include "apt_ip.h"
 
-typedef struct {
-    unsigned int protCnt;
-    unsigned int recyCnt;
-    unsigned int protCntLimit;
-    unsigned int recyCntLimit;
-    float currAmp;
-    float protValThr[PROT_VAL_THRESHOLD_NUMS]; /* from low current level to high. */
-    float protLimitTime[PROT_LIMIT_TIME_NUMS]; /* from level 3 to level 1. */
-    float recyDelta;
-    float timer;
-    float ts;
-    PROT_Level protLevel;
-} OCP_Handle;
+/* Detection on the squared dq current amplitude, levels from low current to high. */
+typedef PROT_Fault OCP_Handle;
 
-void OCP_Init(OCP_Handle *ocp, float ts);
+/* Default table, expanded in the sample with the thresholds of its mcs_prot_user_config.h. */
+#define OCP_CFG_DEFAULTS { \
+    .dir = PROT_FAULT_OVER, \
+    .squared = true, \
+    .errBit = OCP_ERR_BIT, \
+    .decimation = PROT_OVER_CURR_DET_DECIM, \
+    .protCntLimit = PROT_CNT_LIMIT / PROT_OVER_CURR_DET_DECIM, \
+    .recyCntLimit = RECY_CNT_LIMIT / PROT_OVER_CURR_DET_DECIM, \
+    .thr = {PROT_OVER_CURR_POW_DN1, PROT_OVER_CURR_POW_DN2, PROT_OVER_CURR_POW_DN3, PROT_OVER_CURR_POW_OFF}, \
+    .limitTime = {PROT_OVER_CURR_LIMIT1_TIME_SEC, PROT_OVER_CURR_LIMIT2_TIME_SEC, \
+                  PROT_OVER_CURR_LIMIT3_TIME_SEC, 0.0f}, \
+    .recyDelta = PROT_OVER_CURR_RECY_DELTA, \
+    .action = {PROT_MOTOR_RATED_CURR, PROT_MOTOR_RATED_CURR, PROT_MOTOR_RATED_CURR, 0.0f}, \
+}
+
+void OCP_Init(OCP_Handle *ocp, const PROT_FaultCfg *cfg, float ts);
 void OCP_Det(OCP_Handle *ocp, MotorErrStatusReg *motorErrStatus, DqAxis idq);
 void OCP_Exec(OCP_Handle *ocp, DqAxis *idqRef, APT_RegStruct **aptAddr);
-void OCP_Recy(OCP_Handle *ocp, MotorErrStatusReg *motorErrStatus);
+void OCP_HwTrip(OCP_Handle *ocp, MotorErrStatusReg *motorErrStatus);
 void OCP_Clear(OCP_Handle *ocp);
 
 #endif
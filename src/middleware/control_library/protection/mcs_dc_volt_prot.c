@@ -0,0 +1,147 @@
+/**
+  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_dc_volt_prot.c
+  * @author    MCU Algorithm Team
+  * @brief     This file contains dc-link voltage protection api declaration.
+  */
+
+/* Includes ------------------------------------------------------------------------------------ */
+#include "mcs_dc_volt_prot.h"
+#include "mcs_assert.h"
+
+/**
+  * @brief Initilization over dc-link voltage protection function.
+  * @param ovp Over dc-link voltage protection handle.
+  * @param cfg Over voltage levels (V), the actions are the brake loop duties (0-1).
+  * @param ts Ctrl period (s).
+  * @retval None.
+  */
+void OVP_Init(OVP_Handle *ovp, const PROT_FaultCfg *cfg, float ts)
+{
+    MCS_ASSERT_PARAM(ovp != NULL);
+    MCS_ASSERT_PARAM(cfg != NULL);
+    MCS_ASSERT_PARAM(cfg->dir == PROT_FAULT_OVER);
+    MCS_ASSERT_PARAM(ts > 0.0f);
+    PROT_FaultInit(ovp, cfg, ts);
+}
+
+/**
+  * @brief Initilization lower dc-link voltage protection function.
+  * @param lvp Lower dc-link voltage protection handle.
+  * @param cfg Lower voltage levels (V), the actions are the speed reference derating factors (0-1).
+  * @param ts Ctrl period (s).
+  * @retval None.
+  */
+void LVP_Init(LVP_Handle *lvp, const PROT_FaultCfg *cfg, float ts)
+{
+    MCS_ASSERT_PARAM(lvp != NULL);
+    MCS_ASSERT_PARAM(cfg != NULL);
+    MCS_ASSERT_PARAM(cfg->dir == PROT_FAULT_UNDER);
+    MCS_ASSERT_PARAM(ts > 0.0f);
+    PROT_FaultInit(lvp, cfg, ts);
+}
+
+/**
+  * @brief Over dc-link voltage protection detection and recovery.
+  * @param ovp Over dc-link voltage protection handle.
+  * @param motorErrStatus Motor error status.
+  * @param udc DC-link voltage feedback (V).
+  * @retval None.
+  */
+void OVP_Det(OVP_Handle *ovp, MotorErrStatusReg *motorErrStatus, float udc)
+{
+    MCS_ASSERT_PARAM(ovp != NULL);
+    MCS_ASSERT_PARAM(motorErrStatus != NULL);
+    MCS_ASSERT_PARAM(udc > 0.0f);
+    PROT_FaultUpdate(ovp, udc, &motorErrStatus->all);
+}
+
+/**
+  * @brief Lower dc-link voltage protection detection and recovery.
+  * @param lvp Lower dc-link voltage protection handle.
+  * @param motorErrStatus Motor error status.
+  * @param udc DC-link voltage feedback (V).
+  * @retval None.
+  */
+void LVP_Det(LVP_Handle *lvp, MotorErrStatusReg *motorErrStatus, float udc)
+{
+    MCS_ASSERT_PARAM(lvp != NULL);
+    MCS_ASSERT_PARAM(motorErrStatus != NULL);
+    MCS_ASSERT_PARAM(udc > 0.0f);
+    PROT_FaultUpdate(lvp, udc, &motorErrStatus->all);
+}
+
+/**
+  * @brief Over dc-link voltage protection execution.
+  * @param ovp Over dc-link voltage protection handle.
+  * @param duty Brake loop output duty (0-1).
+  * @param aptAddr Three-phase APT address pointer.
+  * @retval None.
+  */
+void OVP_Exec(OVP_Handle *ovp, float *duty, APT_RegStruct **aptAddr)
+{
+    MCS_ASSERT_PARAM(ovp != NULL);
+    MCS_ASSERT_PARAM(duty != NULL);
+    MCS_ASSERT_PARAM(aptAddr != NULL);
+    /* Brake loop duty of the level, level 4 also disables the three-phase pwm output. */
+    *duty = PROT_FaultAction(ovp, *duty);
+    if (ovp->protLevel == PROT_LEVEL_4) {
+        ProtSpo_Exec(aptAddr);
+    }
+}
+
+/**
+  * @brief Lower dc-link voltage protection execution.
+  * @param lvp Lower dc-link voltage protection handle.
+  * @param spdRef Speed Reference (Hz).
+  * @param aptAddr Three-phase APT address pointer.
+  * @retval None.
+  */
+void LVP_Exec(LVP_Handle *lvp, float *spdRef, APT_RegStruct **aptAddr)
+{
+    MCS_ASSERT_PARAM(lvp != NULL);
+    MCS_ASSERT_PARAM(spdRef != NULL);
+    MCS_ASSERT_PARAM(aptAddr != NULL);
+    /* Derate the speed reference by the level, level 4 also disables the three-phase pwm output. */
+    *spdRef *= PROT_FaultAction(lvp, 1.0f);
+    if (lvp->protLevel == PROT_LEVEL_4) {
+        ProtSpo_Exec(aptAddr);
+    }
+}
+
+/**
+  * @brief Over dc-link voltage protection error status clear.
+  * @param ovp Over dc-link voltage protection handle.
+  * @retval None.
+  */
+void OVP_Clear(OVP_Handle *ovp)
+{
+    MCS_ASSERT_PARAM(ovp != NULL);
+    PROT_FaultClear(ovp);
+}
+
+/**
+  * @brief Lower dc-link voltage protection error status clear.
+  * @param lvp Lower dc-link voltage protection handle.
+  * @retval None.
+  */
+void LVP_Clear(LVP_Handle *lvp)
+{
+    MCS_ASSERT_PARAM(lvp != NULL);
+    PROT_FaultClear(lvp);
+}
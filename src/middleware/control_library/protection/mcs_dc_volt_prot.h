@@ -26,44 +26,51 @@
 
 /* Includes ------------------------------------------------------------------------------------ */
 #include "mcs_prot_cmm.h"
+#include "mcs_prot_engine.h"
 #include "apt_ip.h"
 
-typedef struct {
-    unsigned int protCnt;
-    unsigned int recyCnt;
-    unsigned int protCntLimit;
-    unsigned int recyCntLimit;
-    float protValThr[PROT_VAL_THRESHOLD_NUMS];  /* from low voltage level to high. */
-    float protLimitTime[PROT_LIMIT_TIME_NUMS]; /* from level 3 to level 1. */
-    float recyDelta;
-    float timer;
-    float ts;
-    PROT_Level protLevel;
-} OVP_Handle;
+/* Over voltage levels from low voltage to high, lower voltage levels from high voltage to low. */
+typedef PROT_Fault OVP_Handle;
+typedef PROT_Fault LVP_Handle;
 
-typedef struct {
-    unsigned int protCnt;
-    unsigned int recyCnt;
-    unsigned int protCntLimit;
-    unsigned int recyCntLimit;
-    float protValThr[PROT_VAL_THRESHOLD_NUMS];  /* from high voltage level to low. */
-    float protLimitTime[PROT_LIMIT_TIME_NUMS]; /* from level 3 to level 1. */
-    float recyDelta;
-    float timer;
-    float ts;
-    PROT_Level protLevel;
-} LVP_Handle;
+/* Default tables, expanded in the sample with the thresholds of its mcs_prot_user_config.h. */
+#define OVP_CFG_DEFAULTS { \
+    .dir = PROT_FAULT_OVER, \
+    .squared = false, \
+    .errBit = OVP_ERR_BIT, \
+    .decimation = PROT_VOLT_DET_DECIM, \
+    .protCntLimit = PROT_CNT_LIMIT / PROT_VOLT_DET_DECIM, \
+    .recyCntLimit = OVER_VOLT_RECY_CNT_LIMIT / PROT_VOLT_DET_DECIM, \
+    .thr = {PROT_OVER_VOLT_BRK_ON1, PROT_OVER_VOLT_BRK_ON2, PROT_OVER_VOLT_BRK_ON3, PROT_OVER_VOLT_BRK_ALL}, \
+    .limitTime = {PROT_OVER_VOLT_LIMIT1_TIME_SEC, PROT_OVER_VOLT_LIMIT2_TIME_SEC, \
+                  PROT_OVER_VOLT_LIMIT3_TIME_SEC, 0.0f}, \
+    .recyDelta = PROT_OVER_VOLT_RECY_DELTA, \
+    .action = {PROT_OVER_VOLT_BRK_DUTY1, PROT_OVER_VOLT_BRK_DUTY2, PROT_OVER_VOLT_BRK_DUTY3, \
+               PROT_OVER_VOLT_BRK_DUTY4}, \
+}
 
-void OVP_Init(OVP_Handle *ovp, float ts);
+#define LVP_CFG_DEFAULTS { \
+    .dir = PROT_FAULT_UNDER, \
+    .squared = false, \
+    .errBit = LVP_ERR_BIT, \
+    .decimation = PROT_VOLT_DET_DECIM, \
+    .protCntLimit = PROT_CNT_LIMIT / PROT_VOLT_DET_DECIM, \
+    .recyCntLimit = LOWER_VOLT_RECY_CNT_LIMIT / PROT_VOLT_DET_DECIM, \
+    .thr = {PROT_LOWER_VOLT_POW_DN1, PROT_LOWER_VOLT_POW_DN2, PROT_LOWER_VOLT_POW_DN3, PROT_LOWER_VOLT_POW_OFF}, \
+    .limitTime = {PROT_LOWER_VOLT_LIMIT1_TIME_SEC, PROT_LOWER_VOLT_LIMIT2_TIME_SEC, \
+                  PROT_LOWER_VOLT_LIMIT3_TIME_SEC, 0.0f}, \
+    .recyDelta = PROT_LOWER_VOLT_RECY_DELTA, \
+    .action = {PROT_POW_DN1_PCT, PROT_POW_DN1_PCT * PROT_POW_DN2_PCT, PROT_POW_DN2_PCT * PROT_POW_DN3_PCT, 0.0f}, \
+}
+
+void OVP_Init(OVP_Handle *ovp, const PROT_FaultCfg *cfg, float ts);
 void OVP_Det(OVP_Handle *ovp, MotorErrStatusReg *motorErrStatus, float udc);
 void OVP_Exec(OVP_Handle *ovp, float *duty, APT_RegStruct **aptAddr);
-void OVP_Recy(OVP_Handle *ovp, MotorErrStatusReg *motorErrStatus, float udc);
 void OVP_Clear(OVP_Handle *ovp);
 
-void LVP_Init(LVP_Handle *lvp, float ts);
+void LVP_Init(LVP_Handle *lvp, const PROT_FaultCfg *cfg, float ts);
 void LVP_Det(LVP_Handle *lvp, MotorErrStatusReg *motorErrStatus, float udc);
 void LVP_Exec(LVP_Handle *lvp, float *spdRef, APT_RegStruct **aptAddr);
-void LVP_Recy(LVP_Handle *lvp, MotorErrStatusReg *motorErrStatus, float udc);
 void LVP_Clear(LVP_Handle *lvp);
 
 #endif
@@ -22,7 +22,6 @@
 
 /* Includes ------------------------------------------------------------------------------------ */
 #include "mcs_motor_stalling.h"
-#include "mcs_prot_user_config.h"
 #include "mcs_math.h"
 #include "mcs_math_const.h"
 #include "mcs_assert.h"
@@ -65,11 +64,11 @@ void STP_Det_ByCurrSpd(STP_Handle *stall, MotorErrStatusReg *motorErrStatus, flo
     MCS_ASSERT_PARAM(stall != NULL);
     MCS_ASSERT_PARAM(motorErrStatus != NULL);
     MCS_ASSERT_PARAM(Abs(spd) >= 0.0f);
-    /* Calculate current amplitude. */
-    float currAmp = Sqrt(idq.d * idq.d + idq.q * idq.q);
+    /* Compare the squared current amplitude, no square root on the detection path. */
+    float currAmpSq = idq.d * idq.d + idq.q * idq.q;
     float spdAbs = Abs(spd);
     /* Check if value goes over threshold for continuous cycles. */
-    if (currAmp < stall->currAmpLimit || spdAbs > stall->spdLimit) {
+    if (currAmpSq < stall->currAmpLimit * stall->currAmpLimit || spdAbs > stall->spdLimit) {
         stall->timer = 0.0f;
         return;
     }
@@ -30,19 +30,6 @@
 /* Macro definitions --------------------------------------------------------------------------- */
 #define MOTOR_PHASE_NUMBER    (3)
 
-#define PROT_VAL_THRESHOLD_NUMS  (4)
-#define PROT_VAL_THRESHOLD_0     (0)
-#define PROT_VAL_THRESHOLD_1     (1)
-#define PROT_VAL_THRESHOLD_2     (2)
-#define PROT_VAL_THRESHOLD_3     (3)
-
-#define PROT_LIMIT_TIME_NUMS     (3)
-#define PROT_LIMIT_TIME_0        (0)
-#define PROT_LIMIT_TIME_1        (1)
-#define PROT_LIMIT_TIME_2        (2)
-
-#define MOTOR_PHASE_NUMBER    (3)
-
 /**< Motor error status definition. */
 typedef union {
     int all;
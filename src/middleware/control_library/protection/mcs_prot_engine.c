@@ -0,0 +1,260 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_prot_engine.c
+  * @author    MCU Algorithm Team
+  * @brief     This file contains the table-driven protection engine api definition.
+  * @details   Every fault is a PROT_FaultCfg table: four level thresholds, the time each level may last, the
+  *            action of each level, the detection and recovery filters and the detection rate. Magnitudes are
+  *            compared squared, so the detection never takes a square root. Level changes are kept with their
+  *            systick timestamp, including the trips of the hardware comparator path that shuts the PWM down
+  *            without the CPU.
+  */
+
+#include "mcs_prot_engine.h"
+#include "mcs_assert.h"
+#include "systick.h"
+
+/**
+  * @brief Square keeping the sign, so that a negative recovery threshold stays unreachable.
+  * @param x Value.
+  * @retval Signed square.
+  */
+static float ProtSignedSquare(float x)
+{
+    return (x < 0.0f) ? (-x * x) : (x * x);
+}
+
+/**
+  * @brief Check whether the input is on the fault side of a threshold.
+  * @param fault Fault handle.
+  * @param value Detection input.
+  * @param thr Threshold in the input domain.
+  * @retval true if beyond the threshold.
+  */
+static inline bool ProtFaultBeyond(const PROT_Fault *fault, float value, float thr)
+{
+    return (fault->cfg->dir == PROT_FAULT_OVER) ? (value >= thr) : (value <= thr);
+}
+
+/**
+  * @brief Record a level change.
+  * @param fault Fault handle.
+  * @param hwTrip Raised by the hardware comparator path.
+  * @retval None.
+  */
+static void ProtFaultLog(PROT_Fault *fault, unsigned char hwTrip)
+{
+    PROT_FaultEvent *event = &fault->event[fault->eventIdx];
+    event->tick = DCL_SYSTICK_GetTick();
+    event->value = fault->value;
+    event->level = (unsigned char)fault->protLevel;
+    event->hwTrip = hwTrip;
+    fault->eventIdx = (fault->eventIdx + 1 >= PROT_FAULT_EVENT_NUM) ? 0 : fault->eventIdx + 1;
+}
+
+/**
+  * @brief Raise the level once the input stayed beyond the level 1 threshold for protCntLimit detections.
+  * @param fault Fault handle.
+  * @param value Detection input.
+  * @param errStatus Error status word.
+  * @retval None.
+  */
+static void ProtFaultDetect(PROT_Fault *fault, float value, int *errStatus)
+{
+    if (!ProtFaultBeyond(fault, value, fault->trigThr[0])) {
+        fault->protCnt = 0;
+        return;
+    }
+    if (fault->protCnt < fault->cfg->protCntLimit) {
+        fault->protCnt++;
+        return;
+    }
+    /* Highest level whose threshold is crossed. Once in error, the level only drops by recovery. */
+    unsigned int level = PROT_FAULT_LEVEL_NUM;
+    while (level > fault->protLevel && !ProtFaultBeyond(fault, value, fault->trigThr[level - 1])) {
+        level--;
+    }
+    if (level <= fault->protLevel) {
+        return;
+    }
+    fault->protLevel = level;
+    fault->protCnt = 0;
+    fault->recyCnt = 0;
+    fault->timer = 0.0f;
+    fault->tripCnt++;
+    *errStatus |= (1 << fault->cfg->errBit);
+    ProtFaultLog(fault, 0);
+}
+
+/**
+  * @brief Drop one level once the input stayed inside the recovery gap for recyCntLimit detections.
+  * @param fault Fault handle.
+  * @param value Detection input.
+  * @param errStatus Error status word.
+  * @retval None.
+  */
+static void ProtFaultRecover(PROT_Fault *fault, float value, int *errStatus)
+{
+    if (fault->protLevel == 0) {
+        return;
+    }
+    float recyThr = fault->recyThr[fault->protLevel - 1];
+    bool inGap = (fault->cfg->dir == PROT_FAULT_OVER) ? (value < recyThr) : (value > recyThr);
+    if (!inGap) {
+        fault->recyCnt = 0;
+        return;
+    }
+    fault->recyCnt++;
+    if (fault->recyCnt <= fault->cfg->recyCntLimit) {
+        return;
+    }
+    fault->recyCnt = 0;
+    fault->timer = 0.0f;
+    fault->protLevel--;
+    if (fault->protLevel == 0) {
+        *errStatus &= ~(1 << fault->cfg->errBit);
+    }
+    ProtFaultLog(fault, 0);
+}
+
+/**
+  * @brief Initialization of a fault from its configuration table.
+  * @param fault Fault handle.
+  * @param cfg Fault configuration, must stay valid (usually const).
+  * @param ts Period of the PROT_FaultUpdate calls (s).
+  * @retval None.
+  */
+void PROT_FaultInit(PROT_Fault *fault, const PROT_FaultCfg *cfg, float ts)
+{
+    MCS_ASSERT_PARAM(fault != NULL);
+    MCS_ASSERT_PARAM(cfg != NULL);
+    MCS_ASSERT_PARAM(cfg->decimation > 0);
+    MCS_ASSERT_PARAM(ts > 0.0f);
+    fault->cfg = cfg;
+    fault->ts = ts * (float)cfg->decimation;
+    for (unsigned int i = 0; i < PROT_FAULT_LEVEL_NUM; i++) {
+        float recyThr = (cfg->dir == PROT_FAULT_OVER) ? (cfg->thr[i] - cfg->recyDelta) :
+                                                        (cfg->thr[i] + cfg->recyDelta);
+        fault->trigThr[i] = cfg->squared ? ProtSignedSquare(cfg->thr[i]) : cfg->thr[i];
+        fault->recyThr[i] = cfg->squared ? ProtSignedSquare(recyThr) : recyThr;
+    }
+    fault->value = 0.0f;
+    fault->tripCnt = 0;
+    fault->eventIdx = 0;
+    for (unsigned int i = 0; i < PROT_FAULT_EVENT_NUM; i++) {
+        fault->event[i].tick = 0;
+        fault->event[i].value = 0.0f;
+        fault->event[i].level = 0;
+        fault->event[i].hwTrip = 0;
+    }
+    PROT_FaultClear(fault);
+}
+
+/**
+  * @brief Fault detection and recovery, call it at the period given to PROT_FaultInit.
+  * @param fault Fault handle.
+  * @param value Detection input, squared magnitude if the fault is squared.
+  * @param errStatus Error status word, the errBit of the fault follows the level.
+  * @retval true if the detection ran at this call, false if it was skipped by the decimation.
+  */
+bool PROT_FaultUpdate(PROT_Fault *fault, float value, int *errStatus)
+{
+    MCS_ASSERT_PARAM(fault != NULL);
+    MCS_ASSERT_PARAM(errStatus != NULL);
+    if (fault->decimCnt != 0) {
+        fault->decimCnt--;
+        return false;
+    }
+    fault->decimCnt = fault->cfg->decimation - 1;
+    fault->value = value;
+    if (fault->protLevel != 0 && fault->protLevel < PROT_FAULT_LEVEL_OFF) {
+        fault->timer += fault->ts;
+    }
+    ProtFaultDetect(fault, value, errStatus);
+    ProtFaultRecover(fault, value, errStatus);
+    return true;
+}
+
+/**
+  * @brief Check whether the current level lasted longer than its limit time.
+  * @param fault Fault handle.
+  * @retval true if level 1 to 3 is over its limit time.
+  */
+bool PROT_FaultIsTimeout(const PROT_Fault *fault)
+{
+    MCS_ASSERT_PARAM(fault != NULL);
+    if (fault->protLevel == 0 || fault->protLevel >= PROT_FAULT_LEVEL_OFF) {
+        return false;
+    }
+    return fault->timer > fault->cfg->limitTime[fault->protLevel - 1];
+}
+
+/**
+  * @brief Action value of the current level. A level takes the action of the level below until its limit time
+  *        runs out, level 1 takes no action until then and the highest level takes its own action at once.
+  * @param fault Fault handle.
+  * @param noAction Value returned when no action is taken.
+  * @retval Action value.
+  */
+float PROT_FaultAction(const PROT_Fault *fault, float noAction)
+{
+    MCS_ASSERT_PARAM(fault != NULL);
+    unsigned int level = fault->protLevel;
+    if (level == 0) {
+        return noAction;
+    }
+    if (level >= PROT_FAULT_LEVEL_OFF || PROT_FaultIsTimeout(fault)) {
+        return fault->cfg->action[level - 1];
+    }
+    return (level == 1) ? noAction : fault->cfg->action[level - 2];
+}
+
+/**
+  * @brief Record a trip of the hardware path (comparator to APT output control), which already forced the
+  *        PWM output off. The fault goes to the highest level and recovers like a detected one.
+  * @param fault Fault handle.
+  * @param errStatus Error status word.
+  * @retval None.
+  */
+void PROT_FaultHwTrip(PROT_Fault *fault, int *errStatus)
+{
+    MCS_ASSERT_PARAM(fault != NULL);
+    MCS_ASSERT_PARAM(errStatus != NULL);
+    fault->protLevel = PROT_FAULT_LEVEL_OFF;
+    fault->protCnt = 0;
+    fault->recyCnt = 0;
+    fault->timer = 0.0f;
+    fault->tripCnt++;
+    *errStatus |= (1 << fault->cfg->errBit);
+    ProtFaultLog(fault, 1);
+}
+
+/**
+  * @brief Clear the fault state before a restart, the level change records are kept.
+  * @param fault Fault handle.
+  * @retval None.
+  */
+void PROT_FaultClear(PROT_Fault *fault)
+{
+    MCS_ASSERT_PARAM(fault != NULL);
+    fault->protCnt = 0;
+    fault->recyCnt = 0;
+    fault->decimCnt = 0;
+    fault->timer = 0.0f;
+    fault->protLevel = 0;
+}
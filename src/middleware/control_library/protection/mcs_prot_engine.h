@@ -0,0 +1,87 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_prot_engine.h
+  * @author    MCU Algorithm Team
+  * @brief     This file contains the table-driven protection engine data struct and api declaration.
+  */
+
+/* Define to prevent recursive inclusion ------------------------------------------------------- */
+#ifndef McuMagicTag_MCS_PROT_ENGINE_H
+#define McuMagicTag_MCS_PROT_ENGINE_H
+
+#include "typedefs.h"
+
+/* Macro definitions --------------------------------------------------------------------------- */
+#define PROT_FAULT_LEVEL_NUM    (4)     /**< Levels 1 to 4, level 0 is no fault. */
+#define PROT_FAULT_LEVEL_OFF    (4)     /**< Highest level, the PWM output is off. */
+#define PROT_FAULT_EVENT_NUM    (4)     /**< Level changes kept per fault. */
+
+/**< Side of the thresholds where the fault is. */
+typedef enum {
+    PROT_FAULT_OVER = 0,    /**< Fault at or above the thresholds, thresholds increasing with the level. */
+    PROT_FAULT_UNDER        /**< Fault at or below the thresholds, thresholds decreasing with the level. */
+} PROT_FaultDir;
+
+/**
+  * @brief Declarative description of one fault, usually a const table built from the user configuration.
+  */
+typedef struct {
+    PROT_FaultDir dir;
+    bool squared;                           /**< Input is a squared magnitude, e.g. id * id + iq * iq. */
+    unsigned char errBit;                   /**< Bit of the error status set while the level is not 0. */
+    unsigned short decimation;              /**< Detection runs once every decimation calls. */
+    unsigned int protCntLimit;              /**< Continuous detections beyond level 1 before a level rises. */
+    unsigned int recyCntLimit;              /**< Continuous detections inside the recovery gap before it drops. */
+    float thr[PROT_FAULT_LEVEL_NUM];        /**< Level 1 to level 4 thresholds, in the unit of the quantity. */
+    float limitTime[PROT_FAULT_LEVEL_NUM];  /**< Time level 1 to level 3 may last before the stronger action. */
+    float recyDelta;                        /**< Recovery gap below (over) or above (under) the thresholds. */
+    float action[PROT_FAULT_LEVEL_NUM];     /**< Action value of each level: brake duty, derating or current limit. */
+} PROT_FaultCfg;
+
+/**< Level change record. */
+typedef struct {
+    unsigned int tick;          /**< Systick count of the change. */
+    float value;                /**< Detection input at the change, squared if the fault is. */
+    unsigned char level;        /**< New level. */
+    unsigned char hwTrip;       /**< Raised by the hardware comparator path, not by the detection. */
+} PROT_FaultEvent;
+
+typedef struct {
+    const PROT_FaultCfg *cfg;
+    float trigThr[PROT_FAULT_LEVEL_NUM];    /**< Thresholds in the input domain (squared if the fault is). */
+    float recyThr[PROT_FAULT_LEVEL_NUM];    /**< Recovery thresholds in the input domain. */
+    float ts;                               /**< Detection period: call period * decimation (s). */
+    float timer;                            /**< Time spent at the current level (s). */
+    float value;                            /**< Last detection input. */
+    unsigned int protCnt;
+    unsigned int recyCnt;
+    unsigned int tripCnt;                   /**< Level rises, detection and hardware. */
+    unsigned short decimCnt;
+    unsigned char eventIdx;                 /**< Next event slot, the newest event is before it. */
+    unsigned int protLevel;                 /**< Current level, 0 to PROT_FAULT_LEVEL_OFF. */
+    PROT_FaultEvent event[PROT_FAULT_EVENT_NUM];
+} PROT_Fault;
+
+void PROT_FaultInit(PROT_Fault *fault, const PROT_FaultCfg *cfg, float ts);
+bool PROT_FaultUpdate(PROT_Fault *fault, float value, int *errStatus);
+bool PROT_FaultIsTimeout(const PROT_Fault *fault);
+float PROT_FaultAction(const PROT_Fault *fault, float noAction);
+void PROT_FaultHwTrip(PROT_Fault *fault, int *errStatus);
+void PROT_FaultClear(PROT_Fault *fault);
+
+#endif
@@ -22,7 +22,6 @@
 
 /* Includes ------------------------------------------------------------------------------------ */
 #include "mcs_prot_user.h"
-#include "mcs_prot_user_config.h"
 #include "mcs_assert.h"
 
 /**
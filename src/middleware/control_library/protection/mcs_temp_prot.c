@@ -0,0 +1,86 @@
+/**
+  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_temp_prot.c
+  * @author    MCU Algorithm Team
+  * @brief     This file contains over temperature protection api definition.
+  */
+
+/* Includes ------------------------------------------------------------------------------------ */
+#include "mcs_temp_prot.h"
+#include "mcs_assert.h"
+
+/**
+  * @brief Initilization over temperation protection function.
+  * @param otp Over temperature protection handle.
+  * @param cfg Over temperature levels (celsius), the actions are the speed reference derating factors (0-1).
+  * @param ts Ctrl period.
+  * @retval None.
+  */
+void OTP_Init(OTP_Handle *otp, const PROT_FaultCfg *cfg, float ts)
+{
+    MCS_ASSERT_PARAM(otp != NULL);
+    MCS_ASSERT_PARAM(cfg != NULL);
+    MCS_ASSERT_PARAM(cfg->dir == PROT_FAULT_OVER);
+    MCS_ASSERT_PARAM(ts > 0.0f);
+    PROT_FaultInit(otp, cfg, ts);
+}
+
+/**
+  * @brief Over temperatre protection detection and recovery.
+  * @param otp Over temperature protection handle.
+  * @param motorErrStatus Motor error status.
+  * @param temp IPM temperature (celsius).
+  * @retval None.
+  */
+void OTP_Det(OTP_Handle *otp, MotorErrStatusReg *motorErrStatus, float temp)
+{
+    MCS_ASSERT_PARAM(otp != NULL);
+    MCS_ASSERT_PARAM(motorErrStatus != NULL);
+    MCS_ASSERT_PARAM(temp > 0.0f);
+    PROT_FaultUpdate(otp, temp, &motorErrStatus->all);
+}
+
+/**
+  * @brief Over temperature protection execution.
+  * @param otp Over temperature protection handle.
+  * @param spdRef Speed reference (Hz).
+  * @param aptAddr Three-phase APT address pointer.
+  * @retval None.
+  */
+void OTP_Exec(OTP_Handle *otp, float *spdRef, APT_RegStruct **aptAddr)
+{
+    MCS_ASSERT_PARAM(otp != NULL);
+    MCS_ASSERT_PARAM(spdRef != NULL);
+    MCS_ASSERT_PARAM(aptAddr != NULL);
+    /* Derate the speed reference by the level, level 4 also disables the three-phase pwm output. */
+    *spdRef *= PROT_FaultAction(otp, 1.0f);
+    if (otp->protLevel == PROT_LEVEL_4) {
+        ProtSpo_Exec(aptAddr);
+    }
+}
+
+/**
+  * @brief Over temperature protection error status clear.
+  * @param otp Over temperature protection handle.
+  * @retval None.
+  */
+void OTP_Clear(OTP_Handle *otp)
+{
+    MCS_ASSERT_PARAM(otp != NULL);
+    PROT_FaultClear(otp);
+}
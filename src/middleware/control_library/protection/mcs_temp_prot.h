@@ -26,24 +26,30 @@
 
 /* Includes ------------------------------------------------------------------------------------ */
 #include "mcs_prot_cmm.h"
+#include "mcs_prot_engine.h"
 #include "apt_ip.h"
 
-typedef struct {
-    unsigned int protCnt;
-    unsigned int recyCnt;
-    unsigned int protCntLimit;
-    unsigned int recyCntLimit;
-    float protValThr[PROT_VAL_THRESHOLD_NUMS]; /* from low current level to high. */
-    float protLimitTime[PROT_LIMIT_TIME_NUMS]; /* from level 3 to level 1. */
-    float recyDelta;
-    float ts;
-    float timer;
-    PROT_Level protLevel;
-} OTP_Handle;
+/* Over IPM temperature levels from low temperature to high. */
+typedef PROT_Fault OTP_Handle;
 
-void OTP_Init(OTP_Handle *otp, float ts);
-void OTP_Det(OTP_Handle *otp,  MotorErrStatusReg *motorErrStatus, PROT_ErrBit protBit, float temp);
+/* Default table, expanded in the sample with the thresholds of its mcs_prot_user_config.h. */
+#define OTP_CFG_DEFAULTS { \
+    .dir = PROT_FAULT_OVER, \
+    .squared = false, \
+    .errBit = OTP_IPM_ERR_BIT, \
+    .decimation = PROT_TEMP_DET_DECIM, \
+    .protCntLimit = PROT_CNT_LIMIT / PROT_TEMP_DET_DECIM, \
+    .recyCntLimit = RECY_CNT_LIMIT / PROT_TEMP_DET_DECIM, \
+    .thr = {PROT_OVER_IPM_TEMP_POW_DN1, PROT_OVER_IPM_TEMP_POW_DN2, PROT_OVER_IPM_TEMP_POW_DN3, \
+            PROT_OVER_IPM_TEMP_POW_OFF}, \
+    .limitTime = {PROT_OVER_TEMP_LIMIT1_TIME_SEC, PROT_OVER_TEMP_LIMIT2_TIME_SEC, \
+                  PROT_OVER_TEMP_LIMIT3_TIME_SEC, 0.0f}, \
+    .recyDelta = PROT_OVER_IPM_TEMP_RECY_DELTA, \
+    .action = {PROT_POW_DN1_PCT, PROT_POW_DN1_PCT * PROT_POW_DN2_PCT, PROT_POW_DN2_PCT * PROT_POW_DN3_PCT, 0.0f}, \
+}
+
+void OTP_Init(OTP_Handle *otp, const PROT_FaultCfg *cfg, float ts);
+void OTP_Det(OTP_Handle *otp, MotorErrStatusReg *motorErrStatus, float temp);
 void OTP_Exec(OTP_Handle *otp, float *spdRef, APT_RegStruct **aptAddr);
-void OTP_Recy(OTP_Handle *otp,  MotorErrStatusReg *motorErrStatus, PROT_ErrBit protBit, float temp);
 void OTP_Clear(OTP_Handle *otp);
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,469 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_rate_sched.c
+  * @author    MCU Algorithm Team
+  * @brief     This file provides functions of the multi-rate scheduler module.
+  * @details   Each control rate of the system is a carrier ISR (one APT group) or a loop decimated from one.
+  *            MRS_Plan checks the budgets statically over the hyperperiod: the decimated loops are spread
+  *            over the carrier runs so that the longest run is as short as possible, then each carrier,
+  *            fastest first, is given the earliest phase after the master carrier where its runs never
+  *            overlap the runs of the carriers already placed. The phases are applied through the APT slave
+  *            synchronization, so the interrupts follow the plan without any runtime arbitration.
+  */
+
+#include "mcs_rate_sched.h"
+#include "mcs_apt_sync.h"
+#include "mcs_assert.h"
+
+#define MRS_SLOT_NONE   0xFFFFFFFFU
+#define MRS_PHASE_NONE  0xFFFFFFFFU
+
+/**
+  * @brief Greatest common divisor.
+  * @param a First value.
+  * @param b Second value.
+  * @retval Greatest common divisor.
+  */
+static unsigned long long MrsGcd(unsigned long long a, unsigned long long b)
+{
+    while (b != 0) {
+        unsigned long long r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+/**
+  * @brief Conversion of a duration to timestamp counts, rounded up.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param ns Duration (ns).
+  * @retval Timestamp counts.
+  */
+static unsigned int MrsNsToTick(const MRS_Handle *mrs, unsigned int ns)
+{
+    return (unsigned int)(((unsigned long long)ns * mrs->tickFreq + MRS_NS_PER_S - 1) / MRS_NS_PER_S);
+}
+
+/**
+  * @brief Length of one run of a carrier ISR: its own budget and the budgets of the loops due in the run.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param isrId Carrier ISR.
+  * @param run Run in the hyperperiod, may be negative or beyond the hyperperiod.
+  * @retval Run length (ns).
+  */
+static unsigned int MrsRunLen(const MRS_Handle *mrs, unsigned int isrId, long long run)
+{
+    const MRS_Isr *isr = &mrs->isr[isrId];
+    long long runNum = (long long)isr->runNum;
+    unsigned int idx = (unsigned int)(((run % runNum) + runNum) % runNum);
+    unsigned int len = isr->budgetNs;
+    for (unsigned int i = 0; i < mrs->taskNum; i++) {
+        const MRS_Task *task = &mrs->task[i];
+        if (task->isrId == isrId && task->slot != MRS_SLOT_NONE && idx % task->divider == task->slot) {
+            len += task->budgetNs;
+        }
+    }
+    return len;
+}
+
+/**
+  * @brief Hyperperiod of the carriers and loops, and runs of each carrier in it.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @retval 0: success, -1: a carrier period does not divide the master period or the hyperperiod is too long.
+  */
+static int MrsPlanHyperperiod(MRS_Handle *mrs)
+{
+    unsigned long long hyper = mrs->isr[0].periodNs;
+    for (unsigned int i = 1; i < mrs->isrNum; i++) {
+        /* The slaves are synchronized on every master period, so it must hold whole slave periods. */
+        if (mrs->isr[i].periodNs > mrs->isr[0].periodNs || mrs->isr[0].periodNs % mrs->isr[i].periodNs != 0) {
+            return -1;
+        }
+    }
+    for (unsigned int i = 0; i < mrs->taskNum; i++) {
+        unsigned long long period = (unsigned long long)mrs->task[i].divider * mrs->isr[mrs->task[i].isrId].periodNs;
+        hyper = hyper / MrsGcd(hyper, period) * period;
+        if (hyper > 0xFFFFFFFFULL) {
+            return -1;
+        }
+    }
+    mrs->hyperNs = (unsigned int)hyper;
+    for (unsigned int i = 0; i < mrs->isrNum; i++) {
+        mrs->isr[i].runNum = mrs->hyperNs / mrs->isr[i].periodNs;
+        if (mrs->isr[i].runNum > MRS_HYPER_RUN_MAX) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+  * @brief Master carrier period, in the hyperperiod, of the first run of a loop slot.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param isrId Carrier ISR of the loop.
+  * @param slot Loop slot.
+  * @retval Master carrier period index.
+  */
+static unsigned int MrsSlotMasterIdx(const MRS_Handle *mrs, unsigned int isrId, unsigned int slot)
+{
+    return (unsigned int)((unsigned long long)slot * mrs->isr[isrId].periodNs / mrs->isr[0].periodNs);
+}
+
+/**
+  * @brief Spread the decimated loops over the carrier runs, each loop takes the slot whose longest run is the
+  *        shortest, ties go to the master carrier period where fewer loops already run. The loops are placed
+  *        in the order they were added.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @retval 0: success, -1: a carrier run does not fit in its period.
+  */
+static int MrsPlanSlots(MRS_Handle *mrs)
+{
+    for (unsigned int i = 0; i < mrs->taskNum; i++) {
+        mrs->task[i].slot = MRS_SLOT_NONE;
+    }
+    for (unsigned int i = 0; i < mrs->taskNum; i++) {
+        MRS_Task *task = &mrs->task[i];
+        const MRS_Isr *isr = &mrs->isr[task->isrId];
+        unsigned int bestSlot = 0;
+        unsigned int bestLen = 0xFFFFFFFFU;
+        unsigned int bestShare = 0xFFFFFFFFU;
+        for (unsigned int slot = 0; slot < task->divider; slot++) {
+            unsigned int worst = 0;
+            for (unsigned int run = slot; run < isr->runNum; run += task->divider) {
+                unsigned int len = MrsRunLen(mrs, task->isrId, run);
+                worst = (len > worst) ? len : worst;
+            }
+            unsigned int share = 0;
+            for (unsigned int j = 0; j < i; j++) {
+                const MRS_Task *other = &mrs->task[j];
+                share += (MrsSlotMasterIdx(mrs, other->isrId, other->slot) ==
+                          MrsSlotMasterIdx(mrs, task->isrId, slot)) ? 1U : 0U;
+            }
+            if (worst < bestLen || (worst == bestLen && share < bestShare)) {
+                bestLen = worst;
+                bestShare = share;
+                bestSlot = slot;
+            }
+        }
+        task->slot = bestSlot;
+        task->cnt = bestSlot;
+    }
+    for (unsigned int i = 0; i < mrs->isrNum; i++) {
+        MRS_Isr *isr = &mrs->isr[i];
+        isr->windowNs = 0;
+        for (unsigned int run = 0; run < isr->runNum; run++) {
+            unsigned int len = MrsRunLen(mrs, i, run);
+            isr->windowNs = (len > isr->windowNs) ? len : isr->windowNs;
+        }
+        /* A run must end before the next run of the same carrier. */
+        if ((unsigned long long)isr->windowNs + mrs->guardNs > isr->periodNs) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+  * @brief Check that no run of a carrier overlaps a run of the carriers already placed.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param isrId Carrier ISR to place.
+  * @param phase Phase to check (ns).
+  * @retval true if the carrier fits at this phase.
+  */
+static bool MrsPhaseFits(const MRS_Handle *mrs, unsigned int isrId, unsigned int phase)
+{
+    const MRS_Isr *isr = &mrs->isr[isrId];
+    for (unsigned int run = 0; run < isr->runNum; run++) {
+        long long start = (long long)phase + (long long)run * isr->periodNs;
+        long long end = start + MrsRunLen(mrs, isrId, run) + mrs->guardNs;
+        for (unsigned int i = 0; i < mrs->isrNum; i++) {
+            const MRS_Isr *other = &mrs->isr[i];
+            if (i == isrId || other->phaseNs == MRS_PHASE_NONE) {
+                continue;
+            }
+            long long period = (long long)other->periodNs;
+            long long diff = start - (long long)other->phaseNs;
+            /* Last run of the other carrier starting before this run, the earlier ones have ended. */
+            long long m = (diff >= 0) ? (diff / period) : -((-diff + period - 1) / period);
+            for (long long otherStart = other->phaseNs + m * period; otherStart < end; otherStart += period, m++) {
+                if (otherStart + MrsRunLen(mrs, i, m) + mrs->guardNs > start) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+  * @brief Earliest phase of a carrier. A feasible phase can always be moved earlier until a run starts at
+  *        the end of a run of another carrier, so only these ends are tried.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param isrId Carrier ISR to place.
+  * @retval 0: success, -1: no phase fits.
+  */
+static int MrsPlanPhase(MRS_Handle *mrs, unsigned int isrId)
+{
+    MRS_Isr *isr = &mrs->isr[isrId];
+    unsigned int best = 0xFFFFFFFFU;
+    if (MrsPhaseFits(mrs, isrId, 0)) {
+        best = 0;
+    }
+    for (unsigned int i = 0; i < mrs->isrNum && best != 0; i++) {
+        const MRS_Isr *other = &mrs->isr[i];
+        if (i == isrId || other->phaseNs == MRS_PHASE_NONE) {
+            continue;
+        }
+        for (unsigned int run = 0; run < other->runNum; run++) {
+            unsigned long long end = (unsigned long long)other->phaseNs + (unsigned long long)run * other->periodNs +
+                                     MrsRunLen(mrs, i, run) + mrs->guardNs;
+            unsigned int phase = (unsigned int)(end % isr->periodNs);
+            if (phase < best && MrsPhaseFits(mrs, isrId, phase)) {
+                best = phase;
+            }
+        }
+    }
+    if (best == 0xFFFFFFFFU) {
+        return -1;
+    }
+    isr->phaseNs = best;
+    return 0;
+}
+
+/**
+  * @brief Initializer of multi-rate scheduler.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param getTick Free running timestamp for the statistics.
+  * @param tickFreq Timestamp frequency (Hz).
+  * @param guardNs Gap kept after each run for the interrupt latency (ns).
+  * @retval None.
+  */
+void MRS_Init(MRS_Handle *mrs, MRS_GetTick getTick, unsigned int tickFreq, unsigned int guardNs)
+{
+    MCS_ASSERT_PARAM(mrs != NULL);
+    MCS_ASSERT_PARAM(getTick != NULL);
+    MCS_ASSERT_PARAM(tickFreq > 0);
+    mrs->isrNum = 0;
+    mrs->taskNum = 0;
+    mrs->planned = false;
+    mrs->guardNs = guardNs;
+    mrs->hyperNs = 0;
+    mrs->tickFreq = tickFreq;
+    mrs->load = 0.0f;
+    mrs->getTick = getTick;
+}
+
+/**
+  * @brief Add a carrier ISR, the first one added is on the APT master and must have the longest period.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param func Carrier control function.
+  * @param arg Argument of the control function.
+  * @param freqHz Carrier frequency (Hz).
+  * @param budgetNs Worst-case execution time of func with the interrupt entry and exit (ns).
+  * @retval ISR id, -1: parameter error or the ISR table is full.
+  */
+int MRS_IsrAdd(MRS_Handle *mrs, MRS_Func func, void *arg, unsigned int freqHz, unsigned int budgetNs)
+{
+    MCS_ASSERT_PARAM(mrs != NULL);
+    MCS_ASSERT_PARAM(func != NULL);
+    if (mrs->isrNum >= MRS_ISR_NUM || freqHz == 0 || freqHz > MRS_NS_PER_S) {
+        return -1;
+    }
+    MRS_Isr *isr = &mrs->isr[mrs->isrNum];
+    isr->func = func;
+    isr->arg = arg;
+    isr->periodNs = MRS_NS_PER_S / freqHz;
+    isr->budgetNs = budgetNs;
+    isr->phaseNs = 0;
+    isr->windowNs = 0;
+    isr->runNum = 0;
+    isr->periodTick = MrsNsToTick(mrs, isr->periodNs);
+    isr->windowTick = 0;
+    isr->lastTick = 0;
+    mrs->planned = false;
+    return mrs->isrNum++;
+}
+
+/**
+  * @brief Add a loop decimated from a carrier ISR.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param isrId Carrier ISR of the loop.
+  * @param func Loop function.
+  * @param arg Argument of the loop function.
+  * @param freqHz Loop frequency (Hz), the carrier period must divide the loop period.
+  * @param budgetNs Worst-case execution time of func (ns).
+  * @retval 0: success, -1: parameter error or the task table is full.
+  */
+int MRS_TaskAdd(MRS_Handle *mrs, unsigned int isrId, MRS_Func func, void *arg, unsigned int freqHz,
+                unsigned int budgetNs)
+{
+    MCS_ASSERT_PARAM(mrs != NULL);
+    MCS_ASSERT_PARAM(func != NULL);
+    if (mrs->taskNum >= MRS_TASK_NUM || isrId >= mrs->isrNum || freqHz == 0 || freqHz > MRS_NS_PER_S) {
+        return -1;
+    }
+    unsigned int periodNs = MRS_NS_PER_S / freqHz;
+    unsigned int isrPeriodNs = mrs->isr[isrId].periodNs;
+    if (periodNs < isrPeriodNs || periodNs % isrPeriodNs != 0) {
+        return -1;
+    }
+    MRS_Task *task = &mrs->task[mrs->taskNum];
+    task->func = func;
+    task->arg = arg;
+    task->budgetNs = budgetNs;
+    task->divider = periodNs / isrPeriodNs;
+    task->slot = 0;
+    task->cnt = 0;
+    task->maxExecTick = 0;
+    task->isrId = (unsigned char)isrId;
+    mrs->taskNum++;
+    mrs->planned = false;
+    return 0;
+}
+
+/**
+  * @brief Static budget check and placement of the carriers and loops, call it after adding all of them and
+  *        before starting the APT modules.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @retval 0: the budgets fit, -1: they do not fit and the ISRs must not be started.
+  */
+int MRS_Plan(MRS_Handle *mrs)
+{
+    MCS_ASSERT_PARAM(mrs != NULL);
+    mrs->planned = false;
+    if (mrs->isrNum == 0 || MrsPlanHyperperiod(mrs) != 0 || MrsPlanSlots(mrs) != 0) {
+        return -1;
+    }
+    for (unsigned int i = 1; i < mrs->isrNum; i++) {
+        mrs->isr[i].phaseNs = MRS_PHASE_NONE;
+    }
+    mrs->isr[0].phaseNs = 0;
+    /* The faster carriers have less freedom, they are placed first. */
+    for (unsigned int placed = 1; placed < mrs->isrNum; placed++) {
+        unsigned int next = 0;
+        for (unsigned int i = 1; i < mrs->isrNum; i++) {
+            if (mrs->isr[i].phaseNs == MRS_PHASE_NONE &&
+                (next == 0 || mrs->isr[i].periodNs < mrs->isr[next].periodNs)) {
+                next = i;
+            }
+        }
+        if (MrsPlanPhase(mrs, next) != 0) {
+            return -1;
+        }
+    }
+    unsigned long long busy = 0;
+    for (unsigned int i = 0; i < mrs->isrNum; i++) {
+        MRS_Isr *isr = &mrs->isr[i];
+        for (unsigned int run = 0; run < isr->runNum; run++) {
+            busy += MrsRunLen(mrs, i, run);
+        }
+        isr->windowTick = MrsNsToTick(mrs, isr->windowNs);
+    }
+    mrs->load = (float)busy / (float)mrs->hyperNs;
+    MRS_ClearStat(mrs);
+    mrs->planned = true;
+    return 0;
+}
+
+/**
+  * @brief Run a carrier ISR and its due loops, call it from the timer interrupt of the APT group.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @param isrId Carrier ISR.
+  * @retval None.
+  */
+void MRS_IsrRun(MRS_Handle *mrs, unsigned int isrId)
+{
+    MCS_ASSERT_PARAM(mrs != NULL);
+    MCS_ASSERT_PARAM(mrs->planned);
+    MCS_ASSERT_PARAM(isrId < mrs->isrNum);
+    MRS_Isr *isr = &mrs->isr[isrId];
+    unsigned int start = mrs->getTick();
+    if (isr->stat.runCnt != 0) {
+        unsigned int interval = start - isr->lastTick;
+        unsigned int jitter = (interval > isr->periodTick) ? (interval - isr->periodTick) :
+                                                             (isr->periodTick - interval);
+        isr->stat.maxJitterTick = (jitter > isr->stat.maxJitterTick) ? jitter : isr->stat.maxJitterTick;
+    }
+    isr->lastTick = start;
+    isr->stat.runCnt++;
+    isr->func(isr->arg);
+    /* The loops count down the carrier runs, no division in the interrupt. */
+    for (unsigned int i = 0; i < mrs->taskNum; i++) {
+        MRS_Task *task = &mrs->task[i];
+        if (task->isrId != isrId) {
+            continue;
+        }
+        if (task->cnt != 0) {
+            task->cnt--;
+            continue;
+        }
+        task->cnt = task->divider - 1;
+        unsigned int taskStart = mrs->getTick();
+        task->func(task->arg);
+        unsigned int taskExec = mrs->getTick() - taskStart;
+        task->maxExecTick = (taskExec > task->maxExecTick) ? taskExec : task->maxExecTick;
+    }
+    unsigned int exec = mrs->getTick() - start;
+    isr->stat.maxExecTick = (exec > isr->stat.maxExecTick) ? exec : isr->stat.maxExecTick;
+    if (exec > isr->windowTick) {
+        isr->stat.overrunCnt++;
+    }
+}
+
+/**
+  * @brief Slave synchronization of one APT of a carrier group, so that its carrier lags the master carrier by
+  *        the planned phase. The caller sets the sync-in and counter sync sources, then calls
+  *        HAL_APT_SlaveSyncInit. The APT must be initialized (count mode and period).
+  * @param mrs Pointer of multi-rate scheduler, planned.
+  * @param isrId Carrier ISR of the APT group.
+  * @param aptx APT handle.
+  * @param slave Slave synchronization, divPhase, cntPhase and syncCntMode are set.
+  * @retval None.
+  */
+void MRS_AptSlaveSync(const MRS_Handle *mrs, unsigned int isrId, const APT_Handle *aptx, APT_SlaveSyncIn *slave)
+{
+    MCS_ASSERT_PARAM(mrs != NULL);
+    MCS_ASSERT_PARAM(mrs->planned);
+    MCS_ASSERT_PARAM(isrId < mrs->isrNum);
+    MCS_ASSERT_PARAM(aptx != NULL);
+    MCS_ASSERT_PARAM(slave != NULL);
+    const MRS_Isr *isr = &mrs->isr[isrId];
+    /* Time the slave carrier has already run when the master carrier starts. */
+    unsigned long long elapsedNs = (isr->periodNs - isr->phaseNs % isr->periodNs) % isr->periodNs;
+    MCS_AptSlaveSyncPhase(aptx, elapsedNs, isr->periodNs, slave);
+}
+
+/**
+  * @brief Clear the run time statistics.
+  * @param mrs Pointer of multi-rate scheduler.
+  * @retval None.
+  */
+void MRS_ClearStat(MRS_Handle *mrs)
+{
+    MCS_ASSERT_PARAM(mrs != NULL);
+    for (unsigned int i = 0; i < mrs->isrNum; i++) {
+        mrs->isr[i].stat.runCnt = 0;
+        mrs->isr[i].stat.maxExecTick = 0;
+        mrs->isr[i].stat.maxJitterTick = 0;
+        mrs->isr[i].stat.overrunCnt = 0;
+    }
+    for (unsigned int i = 0; i < mrs->taskNum; i++) {
+        mrs->task[i].maxExecTick = 0;
+    }
+}
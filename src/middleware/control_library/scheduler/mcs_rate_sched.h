@@ -0,0 +1,122 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_rate_sched.h
+  * @author    MCU Algorithm Team
+  * @brief     Multi-rate control scheduler for several carrier interrupts on one core.
+  *            This file provides functions declaration of the multi-rate scheduler module.
+  */
+
+#ifndef McuMagicTag_MCS_RATE_SCHED_H
+#define McuMagicTag_MCS_RATE_SCHED_H
+
+#include "typedefs.h"
+#include "apt.h"
+
+/* Macro definitions --------------------------------------------------------------------------- */
+#define MRS_ISR_NUM             4       /**< Carrier ISRs planned together, ISR 0 is on the APT master. */
+#define MRS_TASK_NUM            8       /**< Decimated loops run at the end of the carrier ISRs. */
+#define MRS_HYPER_RUN_MAX       256     /**< Runs of one ISR in the hyperperiod that the plan checks. */
+#define MRS_NS_PER_S            1000000000U
+
+/* Typedef definitions ------------------------------------------------------------------------- */
+/**
+  * @brief Control function of a carrier ISR or of a decimated loop.
+  */
+typedef void (*MRS_Func)(void *arg);
+
+/**
+  * @brief Free running timestamp, usually DCL_SYSTICK_GetTick.
+  */
+typedef unsigned int (*MRS_GetTick)(void);
+
+/**
+  * @brief Run time statistics of a carrier ISR, in timestamp counts.
+  */
+typedef struct {
+    unsigned int runCnt;        /**< Number of runs. */
+    unsigned int maxExecTick;   /**< Longest run, decimated loops included. */
+    unsigned int maxJitterTick; /**< Largest distance of a start from one period after the previous start. */
+    unsigned int overrunCnt;    /**< Runs longer than the planned window, the budgets are too small. */
+} MRS_IsrStat;
+
+/**
+  * @brief Carrier ISR, started by the timer interrupt of its APT group.
+  */
+typedef struct {
+    MRS_Func func;              /**< Carrier control function. */
+    void *arg;                  /**< Argument of the control function. */
+    unsigned int periodNs;      /**< Carrier period (ns). */
+    unsigned int budgetNs;      /**< Worst-case execution time of func with the interrupt entry and exit (ns). */
+    unsigned int phaseNs;       /**< Start after the master ISR (ns), set by MRS_Plan. */
+    unsigned int windowNs;      /**< Longest run with the decimated loops (ns), set by MRS_Plan. */
+    unsigned int runNum;        /**< Runs in the hyperperiod, set by MRS_Plan. */
+    unsigned int periodTick;    /**< Carrier period in timestamp counts. */
+    unsigned int windowTick;    /**< Planned window in timestamp counts. */
+    unsigned int lastTick;      /**< Start of the previous run. */
+    MRS_IsrStat stat;
+} MRS_Isr;
+
+/**
+  * @brief Loop run once every divider runs of its carrier ISR, after the carrier control function.
+  */
+typedef struct {
+    MRS_Func func;              /**< Loop function. */
+    void *arg;                  /**< Argument of the loop function. */
+    unsigned int budgetNs;      /**< Worst-case execution time (ns). */
+    unsigned int divider;       /**< Carrier runs per loop run. */
+    unsigned int slot;          /**< Carrier run, modulo divider, the loop runs in. Set by MRS_Plan. */
+    unsigned int cnt;           /**< Carrier runs left before the next loop run. */
+    unsigned int maxExecTick;   /**< Longest loop run in timestamp counts. */
+    unsigned char isrId;        /**< Carrier ISR of the loop. */
+} MRS_Task;
+
+/**
+  * @brief Multi-rate scheduler. The carrier ISRs never overlap: each one starts at a phase of the master
+  *        carrier where the others have finished, and the decimated loops are spread over the carrier runs.
+  */
+typedef struct {
+    MRS_Isr isr[MRS_ISR_NUM];
+    MRS_Task task[MRS_TASK_NUM];
+    unsigned char isrNum;
+    unsigned char taskNum;
+    bool planned;               /**< MRS_Plan succeeded, the ISRs may run. */
+    unsigned int guardNs;       /**< Gap kept after each window for the interrupt latency (ns). */
+    unsigned int hyperNs;       /**< Hyperperiod of all the ISRs and loops (ns), set by MRS_Plan. */
+    unsigned int tickFreq;      /**< Timestamp frequency (Hz). */
+    float load;                 /**< Planned CPU load of the control ISRs (0-1), set by MRS_Plan. */
+    MRS_GetTick getTick;        /**< Timestamp used for the statistics. */
+} MRS_Handle;
+
+/**
+  * @defgroup RATE_SCHED_API  RATE SCHEDULER API
+  * @brief The multi-rate scheduler API definitions.
+  * @{
+  */
+void MRS_Init(MRS_Handle *mrs, MRS_GetTick getTick, unsigned int tickFreq, unsigned int guardNs);
+int MRS_IsrAdd(MRS_Handle *mrs, MRS_Func func, void *arg, unsigned int freqHz, unsigned int budgetNs);
+int MRS_TaskAdd(MRS_Handle *mrs, unsigned int isrId, MRS_Func func, void *arg, unsigned int freqHz,
+                unsigned int budgetNs);
+int MRS_Plan(MRS_Handle *mrs);
+void MRS_IsrRun(MRS_Handle *mrs, unsigned int isrId);
+void MRS_AptSlaveSync(const MRS_Handle *mrs, unsigned int isrId, const APT_Handle *aptx, APT_SlaveSyncIn *slave);
+void MRS_ClearStat(MRS_Handle *mrs);
+/**
+  * @}
+  */
+
+#endif
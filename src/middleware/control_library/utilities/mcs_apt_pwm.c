@@ -0,0 +1,96 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_apt_pwm.c
+  * @author    MCU Algorithm Team
+  * @brief     This file provides function of the three-phase APT output control.
+  */
+#include "mcs_apt_pwm.h"
+#include "mcs_math.h"
+#include "mcs_assert.h"
+
+/**
+  * @brief Set the ADC trigger points of the APT, clamped into the carrier.
+  * @param aptx APT register base address.
+  * @param cntCmpA Count compare reference A.
+  * @param cntCmpB Count compare reference B.
+  * @param maxCntCmp Maximum count compare value of the carrier.
+  * @retval None.
+  */
+void MCS_AptSetAdcCompare(APT_RegStruct *aptx, unsigned short cntCmpA, unsigned short cntCmpB,
+                          unsigned short maxCntCmp)
+{
+    MCS_ASSERT_PARAM(aptx != NULL);
+    unsigned short tmp;
+    /* Sets the A Count compare reference of time-base counter. */
+    tmp = (unsigned short)Clamp((float)(cntCmpA), (float)(maxCntCmp - 1), 1.0f);
+    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_A, tmp);
+    /* Sets the B Count compare reference of time-base counter. */
+    tmp = (unsigned short)Clamp((float)(cntCmpB), (float)(maxCntCmp - 1), 1.0f);
+    DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_B, tmp);
+}
+
+/**
+  * @brief Turn on the three low-side switches, used to charge the bootstrap capacitors.
+  * @param aptAddr Three-phase APT register base addresses.
+  * @param maxDutyCnt Maximum count compare value of the carrier.
+  * @retval None.
+  */
+void MCS_AptTurnOnLowSide(APT_RegStruct **aptAddr, unsigned short maxDutyCnt)
+{
+    MCS_ASSERT_PARAM(aptAddr != NULL);
+    MCS_ASSERT_PARAM(maxDutyCnt != 0);
+    /* Open the three-phase lower pipe */
+    for (unsigned int i = 0; i < MCS_APT_PHASE_NUM; i++) {
+        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
+        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_C, maxDutyCnt);
+        DCL_APT_SetCounterCompare(aptx, APT_COMPARE_REFERENCE_D, maxDutyCnt);
+    }
+}
+
+/**
+  * @brief Release the forced output of the three-phase APT.
+  * @param aptAddr Three-phase APT register base addresses.
+  * @retval None.
+  */
+void MCS_AptPwmOutputEnable(APT_RegStruct **aptAddr)
+{
+    MCS_ASSERT_PARAM(aptAddr != NULL);
+    /* Enable three-phase pwm output */
+    for (unsigned int i = 0; i < MCS_APT_PHASE_NUM; i++) {
+        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
+        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_UNSET;
+        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_UNSET;
+    }
+}
+
+/**
+  * @brief Force the three-phase APT output low.
+  * @param aptAddr Three-phase APT register base addresses.
+  * @retval None.
+  */
+void MCS_AptPwmOutputDisable(APT_RegStruct **aptAddr)
+{
+    MCS_ASSERT_PARAM(aptAddr != NULL);
+    /* Disable three-phase pwm output. */
+    for (unsigned int i = 0; i < MCS_APT_PHASE_NUM; i++) {
+        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
+        aptx->PG_OUT_FRC.BIT.rg_pga_frc_en = BASE_CFG_SET;
+        aptx->PG_OUT_FRC.BIT.rg_pgb_frc_en = BASE_CFG_SET;
+        DCL_APT_ForcePWMOutputLow(aptx);
+    }
+}
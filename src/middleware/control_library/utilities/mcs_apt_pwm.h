@@ -1,5 +1,5 @@
 /**
-  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
   * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
   * following conditions are met:
   * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
@@ -15,38 +15,43 @@
   * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
   * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
   * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  * @file      mcs_curr_prot.h
+  * @file      mcs_apt_pwm.h
   * @author    MCU Algorithm Team
-  * @brief     This file contains current protection data struct and api declaration.
+  * @brief     Three-phase APT output control shared by the motor samples.
   */
 
-/* Define to prevent recursive inclusion ------------------------------------- */
-#ifndef McuMagicTag_MCS_CURR_PROT_H
-#define McuMagicTag_MCS_CURR_PROT_H
+/* Define to prevent recursive inclusion ------------------------------------------------------- */
+#ifndef McuMagicTag_MCS_APT_PWM_H
+#define McuMagicTag_MCS_APT_PWM_H
 
 /* Includes ------------------------------------------------------------------------------------ */
-#include "mcs_prot_cmm.h"
-#include "mcs_typedef.h"
-#include "apt_ip.h"
+#include "apt.h"
 
-typedef struct {
-    unsigned int protCnt;
-    unsigned int recyCnt;
-    unsigned int protCntLimit;
-    unsigned int recyCntLimit;
-    float currAmp;
-    float protValThr[PROT_VAL_THRESHOLD_NUMS]; /* from low current level to high. */
-    float protLimitTime[PROT_LIMIT_TIME_NUMS]; /* from level 3 to level 1. */
-    float recyDelta;
-    float timer;
-    float ts;
-    PROT_Level protLevel;
-} OCP_Handle;
+/* Macro definitions --------------------------------------------------------------------------- */
+#define MCS_APT_PHASE_NUM   3 /**< One APT per phase: U, V, W. */
 
-void OCP_Init(OCP_Handle *ocp, float ts);
-void OCP_Det(OCP_Handle *ocp, MotorErrStatusReg *motorErrStatus, DqAxis idq);
-void OCP_Exec(OCP_Handle *ocp, DqAxis *idqRef, APT_RegStruct **aptAddr);
-void OCP_Recy(OCP_Handle *ocp, MotorErrStatusReg *motorErrStatus);
-void OCP_Clear(OCP_Handle *ocp);
+/**
+  * @defgroup APT_PWM APT_PWM MODULE
+  * @brief The three-phase APT output function.
+  * @{
+  */
+
+/**
+  * @defgroup APT_PWM_API APT_PWM API
+  * @brief The three-phase APT output API declaration.
+  * @{
+  */
+void MCS_AptSetAdcCompare(APT_RegStruct *aptx, unsigned short cntCmpA, unsigned short cntCmpB,
+                          unsigned short maxCntCmp);
+void MCS_AptTurnOnLowSide(APT_RegStruct **aptAddr, unsigned short maxDutyCnt);
+void MCS_AptPwmOutputEnable(APT_RegStruct **aptAddr);
+void MCS_AptPwmOutputDisable(APT_RegStruct **aptAddr);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
 
 #endif
@@ -0,0 +1,63 @@
+/**
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mcs_apt_sync.c
+  * @author    MCU Algorithm Team
+  * @brief     This file provides function of the slave APT carrier phase shift.
+  */
+#include "mcs_apt_sync.h"
+#include "mcs_assert.h"
+
+/**
+  * @brief Counter phase of a slave APT, for HAL_APT_SlaveSyncInit.
+  * The slave carrier lags the master carrier by whole - elapsed of whole: when the master counter restarts, the
+  * slave carrier has already run elapsed / whole of its period. The APT must be initialized (count mode and period),
+  * syncInSrc and cntrSyncSrc are left to the caller.
+  * @param aptx The slave APT handle.
+  * @param elapsed Part of the carrier period already run by the slave, below whole.
+  * @param whole Carrier period in the unit of elapsed.
+  * @param slave Slave synchronization, divPhase, cntPhase and syncCntMode are set.
+  * @retval None.
+  */
+void MCS_AptSlaveSyncPhase(const APT_Handle *aptx, unsigned long long elapsed, unsigned long long whole,
+                           APT_SlaveSyncIn *slave)
+{
+    MCS_ASSERT_PARAM(aptx != NULL);
+    MCS_ASSERT_PARAM(slave != NULL);
+    MCS_ASSERT_PARAM(whole > 0 && elapsed < whole);
+    unsigned long long period = aptx->waveform.timerPeriod;
+    unsigned long long cnt;
+    slave->divPhase = 0;
+    if (aptx->waveform.cntMode == APT_COUNT_MODE_UP_DOWN) {
+        /* Up from 0 to the period in the first half of the carrier, then down. */
+        cnt = elapsed * 2 * period / whole;
+        if (cnt < period) {
+            slave->syncCntMode = APT_COUNT_MODE_AFTER_SYNC_UP;
+        } else {
+            cnt = 2 * period - cnt;
+            slave->syncCntMode = APT_COUNT_MODE_AFTER_SYNC_DOWN;
+        }
+    } else if (aptx->waveform.cntMode == APT_COUNT_MODE_DOWN) {
+        cnt = period - elapsed * period / whole;
+        slave->syncCntMode = APT_COUNT_MODE_AFTER_SYNC_DOWN;
+    } else {
+        cnt = elapsed * period / whole;
+        slave->syncCntMode = APT_COUNT_MODE_AFTER_SYNC_UP;
+    }
+    /* The counter phase must stay below the period. */
+    slave->cntPhase = (unsigned short)((cnt < period) ? cnt : (period - 1));
+}
@@ -1,5 +1,5 @@
 /**
-  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * @ Copyright (c) HiSilicon (Shanghai) Technologies Co., Ltd. 2022-2023. All rights reserved.
   * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
   * following conditions are met:
   * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
@@ -15,29 +15,37 @@
   * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
   * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
   * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  * @file      mcs_prot_cmm.c
+  * @file      mcs_apt_sync.h
   * @author    MCU Algorithm Team
-  * @brief     This file contains protection common api definition.
+  * @brief     Phase shift of a slave APT carrier against the master carrier.
   */
- 
+
+/* Define to prevent recursive inclusion ------------------------------------------------------- */
+#ifndef McuMagicTag_MCS_APT_SYNC_H
+#define McuMagicTag_MCS_APT_SYNC_H
+
 /* Includes ------------------------------------------------------------------------------------ */
-#include "mcs_prot_cmm.h"
 #include "apt.h"
-#include "mcs_assert.h"
 
 /**
-  * @brief Safty-pulse-off function execution to turn off all the power devices.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
+  * @defgroup APT_SYNC APT_SYNC MODULE
+  * @brief The APT carrier phase shift function.
+  * @{
+  */
+
+/**
+  * @defgroup APT_SYNC_API APT_SYNC API
+  * @brief The APT carrier phase shift API declaration.
+  * @{
   */
-void ProtSpo_Exec(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /**< Turn off all the six power devices of the inverter. */
-    for (unsigned int i = 0; i < MOTOR_PHASE_NUMBER; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        DCL_APT_EnableSwContPWMAction(aptx, APT_PWM_CHANNEL_A);
-        DCL_APT_EnableSwContPWMAction(aptx, APT_PWM_CHANNEL_B);
-        DCL_APT_ForcePWMOutputLow(aptx);
-    }
-}
\ No newline at end of file
+void MCS_AptSlaveSyncPhase(const APT_Handle *aptx, unsigned long long elapsed, unsigned long long whole,
+                           APT_SlaveSyncIn *slave);
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif
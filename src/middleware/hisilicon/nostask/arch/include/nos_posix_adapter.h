@@ -0,0 +1,66 @@
+/**
+  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      nos_posix_adapter.h
+  */
+#ifndef NOS_POSIX_ADAPTER_H
+#define NOS_POSIX_ADAPTER_H
+
+/*
+ * POSIX主机仿真移植：任务上下文使用ucontext，NOS_GetCycle返回虚拟cycle计数，tick中断由虚拟时间驱动。
+ * 编译时定义OS_ARCH_POSIX与OS_OPTION_306X，不编译nos_port.c/nos_dispatch.S的目标板实现，
+ * NOS_TaskInitParam中栈地址为32位，64位主机上以-no-pie链接，使静态分配的任务栈位于4G地址范围内。
+ * 冒烟测试见tools/nossim。
+ * 虚拟时间只在NOS_SimCycleAdvance与Idle任务中推进，相同输入下调度序列完全可复现。
+ */
+
+/* 仿真tick中断钩子，在tick中断上下文中先于内核tick处理执行，对应目标板的SYSTICK回调 */
+typedef void (*NOS_SimIsrFunc)(void);
+
+/* 仿真调度统计 */
+typedef struct {
+    unsigned long long cycle;     /* 当前虚拟cycle */
+    unsigned long long tickCnt;   /* 已响应的tick中断次数 */
+    unsigned long long switchCnt; /* 任务切换次数 */
+    unsigned long long idleCycle; /* Idle任务快进的cycle数 */
+} NOS_SimStat;
+
+/*
+ * 初始化仿真环境，须在NOS_TaskInit之前调用。
+ * cyclePerTick: tick中断周期(虚拟cycle)；endCycle: 虚拟时间到达该值时停止调度，NOS_StartScheduler返回。
+ */
+void NOS_SimInit(unsigned int cyclePerTick, unsigned long long endCycle);
+
+/* 注册tick中断钩子 */
+void NOS_SimSetTickHook(NOS_SimIsrFunc hook);
+
+/* 当前任务消耗cycles个虚拟cycle，期间到期的tick在开中断时立即响应，可能引发任务切换 */
+void NOS_SimCycleAdvance(unsigned int cycles);
+
+/* 在中断上下文中执行isr，退出中断时按需调度，模拟外设中断；关中断时调用无效返回-1 */
+int NOS_SimIrqRun(NOS_SimIsrFunc isr);
+
+/* 停止调度并返回到NOS_StartScheduler的调用点 */
+void NOS_SimStop(void);
+
+/* 获取仿真统计 */
+void NOS_SimStatGet(NOS_SimStat *stat);
+
+/* Idle任务调用：虚拟时间快进到下一个tick */
+void OsSimIdle(void);
+
+#endif
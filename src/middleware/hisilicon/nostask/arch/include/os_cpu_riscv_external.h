@@ -38,9 +38,24 @@
  */
 #define MSTATUS_DEF_RESTORE      (MSTATUS_MPP_M_MODE | MSTATUS_MPIE | MSTATUS_FS)
 
+/* 入参为0时OsGetLMB1的返回值 */
+#define OS_LMB1_INVALID          32
+
 extern void OsTskContextLoad(uintptr_t tcbAddr);
 extern void OsTaskSwitch(void);
+
+#if defined(OS_OPTION_CPU_CLZ)
+/* getLMB1：使用clz指令获取最高位1前的前导零个数，单条指令完成 */
+INLINE unsigned int OsGetLMB1(unsigned int value)
+{
+    if (value == 0) {
+        return OS_LMB1_INVALID;
+    }
+    return (unsigned int)__builtin_clz(value);
+}
+#else
 extern unsigned int OsGetLMB1(unsigned int value);
+#endif
 
 /* task switch */
 INLINE void OsTaskTrap(void)
@@ -17,15 +17,16 @@
   * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
   * @file      nos_port.c
   */
+#if !defined(OS_ARCH_POSIX)
 #include "nos_sys_external.h"
 
-#define INDEX_STEP                  8
-#define HIGH_8BIT_U32_OFFSET        24
+#define HIGH_16BIT_U32_MASK         0xFFFF0000U
+#define HIGH_8BIT_U32_MASK          0xFF000000U
+#define HIGH_4BIT_U32_MASK          0xF0000000U
+#define HALF_WORD_BITS              16
+#define BYTE_BITS                   8
+#define NIBBLE_BITS                 4
 #define HIGH_4BIT_U32_OFFSET        28
-#define LEADING_ZERO_NUM_OF_ZERO    32
-#define OS_MAX_U8 0xFFU
-#define OS_GET_8BIT_HIGH_4BIT(num)      ((num) >> 4)
-#define OS_GET_8BIT_LOW_4BIT(num)       ((num) & 0xFU)
 
 void OsTskContextGet(uintptr_t saveAddr, struct TskContext *context)
 {
@@ -57,30 +58,33 @@ void *OsTskContextInit(unsigned int taskId, unsigned int stackSize, uintptr_t *t
     return (void *)context;
 }
 
+#if !defined(OS_OPTION_CPU_CLZ)
 /* 32表示无效，3、2、1、0表示在4bit位中前导零的个数 */
 unsigned short g_lmb1Idx[16] = { 32, 3, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 };
 
-/* getLMB1 */
+/* getLMB1：无clz指令时的软件实现，固定三次二分后查表，耗时与入参无关 */
 unsigned int OsGetLMB1(unsigned int value)
 {
-    signed int idx;
-    unsigned int check1;
-    unsigned int check2;
+    unsigned int num = 0;
+    unsigned int check = value;
 
-    for (idx = HIGH_8BIT_U32_OFFSET; idx >= 0; idx -= INDEX_STEP) {
-        check1 = (value >> (unsigned int)idx) & OS_MAX_U8;
-
-        if (check1 != 0) {
-            /* get high bit */
-            check2 = OS_GET_8BIT_HIGH_4BIT(check1);
-            if (check2 != 0) {
-                return ((unsigned int)g_lmb1Idx[check2] + (unsigned int)(HIGH_8BIT_U32_OFFSET - idx));
-            }
-
-            /* get low bit */
-            return ((unsigned int)g_lmb1Idx[OS_GET_8BIT_LOW_4BIT(check1)] + (unsigned int)(HIGH_4BIT_U32_OFFSET - idx));
-        }
+    if (check == 0) {
+        return OS_LMB1_INVALID;
+    }
+    if ((check & HIGH_16BIT_U32_MASK) == 0) {
+        num += HALF_WORD_BITS;
+        check <<= HALF_WORD_BITS;
+    }
+    if ((check & HIGH_8BIT_U32_MASK) == 0) {
+        num += BYTE_BITS;
+        check <<= BYTE_BITS;
+    }
+    if ((check & HIGH_4BIT_U32_MASK) == 0) {
+        num += NIBBLE_BITS;
+        check <<= NIBBLE_BITS;
     }
 
-    return LEADING_ZERO_NUM_OF_ZERO;
+    return num + (unsigned int)g_lmb1Idx[check >> HIGH_4BIT_U32_OFFSET];
 }
+#endif
+#endif /* OS_ARCH_POSIX */
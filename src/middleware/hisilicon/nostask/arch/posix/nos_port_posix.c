@@ -0,0 +1,293 @@
+/**
+  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      nos_port_posix.c
+  */
+#if defined(OS_ARCH_POSIX)
+#include <ucontext.h>
+#include <string.h>
+#include "nos_task_external.h"
+#include "nos_306x_adapter.h"
+#include "nos_posix_adapter.h"
+
+#define SIM_MSTATUS_MIE     0x8U
+#define SIM_CYCLE_START     1ULL  /* OsTskTimerAdd认为cycle为0时计时无效，虚拟时间从1开始 */
+
+/* 仿真任务上下文，对应目标板压栈的TskContext */
+struct NosSimContext {
+    ucontext_t uc;
+    uintptr_t entry;
+    unsigned int taskId;
+    unsigned int intEnable;   /* 切回时恢复的mstatus.MIE */
+    unsigned int tickEnable;  /* 切回时恢复的tick中断使能 */
+};
+
+extern void OsMainSchedule(void);
+extern void OsHwiDispatchTick(void);
+
+static struct NosSimContext g_simCtx[OS_MAX_TCB_NUM];
+static struct NosSimContext *g_simSaveCtx = NULL;
+static ucontext_t g_simMainCtx;
+
+static unsigned long long g_simCycle = SIM_CYCLE_START;
+static unsigned long long g_simNextTick;
+static unsigned long long g_simEndCycle;
+static unsigned int g_simCyclePerTick;
+static unsigned int g_simTickPending;
+static unsigned int g_simIntEnable;
+static unsigned int g_simTickEnable = TICK_IRQ_EN_NUM;
+static bool g_simStarted = FALSE;
+static NOS_SimIsrFunc g_simTickHook = NULL;
+static NOS_SimStat g_simStat;
+
+/* 中断使能且不在中断上下文中时，响应挂起的tick */
+static void OsSimIrqCheck(void);
+
+void NOS_SimInit(unsigned int cyclePerTick, unsigned long long endCycle)
+{
+    g_simCycle = SIM_CYCLE_START;
+    g_simCyclePerTick = cyclePerTick;
+    g_simNextTick = g_simCycle + cyclePerTick;
+    g_simEndCycle = endCycle;
+    g_simTickPending = 0;
+    g_simIntEnable = 0;
+    g_simTickEnable = TICK_IRQ_EN_NUM;
+    g_simStarted = FALSE;
+    g_simSaveCtx = NULL;
+    (void)memset(&g_simStat, 0, sizeof(g_simStat));
+}
+
+void NOS_SimSetTickHook(NOS_SimIsrFunc hook)
+{
+    g_simTickHook = hook;
+}
+
+void NOS_SimStatGet(NOS_SimStat *stat)
+{
+    if (stat == NULL) {
+        return;
+    }
+    *stat = g_simStat;
+    stat->cycle = g_simCycle;
+}
+
+void NOS_SimStop(void)
+{
+    g_simStarted = FALSE;
+    g_simIntEnable = 0;
+    (void)setcontext(&g_simMainCtx);
+}
+
+unsigned long long NOS_GetCycle(void)
+{
+    return g_simCycle;
+}
+
+/* 推进虚拟时间并记录到期的tick */
+static void OsSimTimeAdvance(unsigned long long cycles)
+{
+    g_simCycle += cycles;
+    while ((g_simCyclePerTick != 0) && (g_simCycle >= g_simNextTick)) {
+        g_simTickPending++;
+        g_simNextTick += g_simCyclePerTick;
+    }
+}
+
+void NOS_SimCycleAdvance(unsigned int cycles)
+{
+    OsSimTimeAdvance(cycles);
+    if ((g_simEndCycle != 0) && (g_simCycle >= g_simEndCycle)) {
+        NOS_SimStop();
+    }
+    OsSimIrqCheck();
+}
+
+void OsSimIdle(void)
+{
+    unsigned long long idle = (g_simNextTick > g_simCycle) ? (g_simNextTick - g_simCycle) : 1;
+
+    if (g_simCyclePerTick == 0) {
+        /* 无tick时没有任何事件能唤醒任务，直接结束仿真 */
+        NOS_SimStop();
+    }
+    g_simStat.idleCycle += idle;
+    NOS_SimCycleAdvance((unsigned int)idle);
+}
+
+/* 保存当前任务切回时的中断状态并进入调度，对应目标板的OsTaskTrueSwitch/OsHwiPostHandle */
+static void OsSimSwitchFrom(struct TagTskCB *prev, unsigned int intEnable)
+{
+    struct NosSimContext *ctx = (struct NosSimContext *)prev->stackPointer;
+
+    ctx->intEnable = intEnable;
+    ctx->tickEnable = g_simTickEnable;
+    g_simSaveCtx = ctx;
+    /* 最终调用OsTskContextLoad，任务被切回时从这里返回 */
+    OsMainSchedule();
+}
+
+/* 中断退出处理：有调度请求时切换任务，被打断的任务切回后中断为开启状态 */
+static void OsSimHwiPostHandle(void)
+{
+    if ((UNI_FLAG & OS_FLG_TSK_REQ) == 0) {
+        g_simIntEnable = SIM_MSTATUS_MIE;
+        return;
+    }
+    OsSimSwitchFrom(RUNNING_TASK, SIM_MSTATUS_MIE);
+}
+
+int NOS_SimIrqRun(NOS_SimIsrFunc isr)
+{
+    if ((isr == NULL) || (g_simIntEnable == 0) || OS_INT_ACTIVE) {
+        return -1;
+    }
+    g_simIntEnable = 0;
+    UNI_FLAG |= OS_FLG_HWI_ACTIVE;
+    isr();
+    UNI_FLAG &= ~OS_FLG_HWI_ACTIVE;
+    OsSimHwiPostHandle();
+    return 0;
+}
+
+static void OsSimTickIsr(void)
+{
+    if (g_simTickHook != NULL) {
+        g_simTickHook();
+    }
+    g_simStat.tickCnt++;
+    OsHwiDispatchTick();
+}
+
+static void OsSimIrqCheck(void)
+{
+    while (g_simStarted && (g_simTickPending != 0) && (g_simIntEnable != 0) && (g_simTickEnable != 0) &&
+           OS_INT_INACTIVE) {
+        g_simTickPending--;
+        (void)NOS_SimIrqRun(OsSimTickIsr);
+    }
+}
+
+uintptr_t NOS_IntLock(void)
+{
+    uintptr_t intSave = g_simIntEnable;
+
+    g_simIntEnable = 0;
+    return intSave;
+}
+
+uintptr_t NOS_IntUnLock(void)
+{
+    uintptr_t intSave = g_simIntEnable;
+
+    g_simIntEnable = SIM_MSTATUS_MIE;
+    OsSimIrqCheck();
+    return intSave;
+}
+
+void NOS_IntRestore(uintptr_t intSave)
+{
+    if ((intSave & SIM_MSTATUS_MIE) != 0) {
+        g_simIntEnable = SIM_MSTATUS_MIE;
+        OsSimIrqCheck();
+    }
+}
+
+unsigned int NOS_SystickLock(void)
+{
+    unsigned int intSave = g_simTickEnable;
+
+    g_simTickEnable = 0;
+    return intSave;
+}
+
+void NOS_SystickRestore(unsigned int intSave)
+{
+    if ((intSave & TICK_IRQ_EN_NUM) != 0) {
+        g_simTickEnable = TICK_IRQ_EN_NUM;
+        OsSimIrqCheck();
+    }
+}
+
+/* 仿真任务入口，对应目标板首次mret进入任务 */
+static void OsSimTaskEntry(unsigned int taskId)
+{
+    struct NosSimContext *ctx = &g_simCtx[taskId];
+
+    g_simIntEnable = ctx->intEnable;
+    g_simTickEnable = ctx->tickEnable;
+    OsSimIrqCheck();
+    ((void (*)(unsigned int))ctx->entry)(ctx->taskId);
+}
+
+void OsTskContextGet(uintptr_t saveAddr, struct TskContext *context)
+{
+    /* 主机上下文由ucontext保存，不提供RISC-V寄存器现场 */
+    (void)saveAddr;
+    (void)memset(context, 0, sizeof(struct TskContext));
+}
+
+/* 任务上下文初始化，任务栈作为ucontext的执行栈 */
+void *OsTskContextInit(unsigned int taskId, unsigned int stackSize, uintptr_t *topStack, uintptr_t funcTskEntry)
+{
+    struct NosSimContext *ctx = &g_simCtx[taskId];
+
+    (void)getcontext(&ctx->uc);
+    ctx->uc.uc_stack.ss_sp = (void *)topStack;
+    ctx->uc.uc_stack.ss_size = stackSize;
+    ctx->uc.uc_link = NULL;
+    ctx->entry = funcTskEntry;
+    ctx->taskId = taskId;
+    ctx->intEnable = SIM_MSTATUS_MIE;
+    ctx->tickEnable = TICK_IRQ_EN_NUM;
+    makecontext(&ctx->uc, (void (*)(void))OsSimTaskEntry, 1, taskId);
+
+    return (void *)ctx;
+}
+
+void OsTaskSwitch(void)
+{
+    OsSimSwitchFrom(RUNNING_TASK, g_simIntEnable);
+}
+
+void OsTskContextLoad(uintptr_t tcbAddr)
+{
+    struct NosSimContext *next = (struct NosSimContext *)((struct TagTskCB *)tcbAddr)->stackPointer;
+    struct NosSimContext *prev = g_simSaveCtx;
+
+    g_simSaveCtx = NULL;
+    if (prev == next) {
+        /* 中断没有引起切换，回到被打断的任务 */
+        g_simIntEnable = prev->intEnable;
+        g_simTickEnable = prev->tickEnable;
+        return;
+    }
+
+    g_simStat.switchCnt++;
+    if (!g_simStarted) {
+        /* 首次调度，保存主机现场，仿真结束时返回 */
+        g_simStarted = TRUE;
+        (void)swapcontext(&g_simMainCtx, &next->uc);
+        return;
+    }
+
+    (void)swapcontext(&prev->uc, &next->uc);
+    /* 本任务被切回 */
+    g_simIntEnable = prev->intEnable;
+    g_simTickEnable = prev->tickEnable;
+    OsSimIrqCheck();
+}
+#endif
@@ -26,7 +26,9 @@ extern "C" {
 #endif
 #endif
 
+#if !defined(OS_ARCH_POSIX)
 #define OS_ARCH_RISCV                       YES
+#endif
 
 #ifndef OS_HARDWARE_PLATFORM
 #define OS_HARDWARE_PLATFORM                OS_RISCV
@@ -58,6 +60,11 @@ extern "C" {
 
 #define OS_OPTION_TICK                      YES
 
+/* 内核支持clz前导零指令(-femit-clz)，最高优先级查找使用硬件指令 */
+#define OS_OPTION_CPU_CLZ                   YES
+
+/* 调度时延统计(任务就绪到切换完成的cycle数)，需要时打开：#define OS_OPTION_SCHED_LATENCY YES */
+
 #ifdef __cplusplus
 #if __cplusplus
 }
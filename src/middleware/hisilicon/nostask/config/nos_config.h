@@ -34,10 +34,14 @@ extern "C" {
 #define OS_INCLUDE_TASK                                 YES
 /* 最大支持的任务数,软中断和任务最大共支持254个 */
 #define OS_TSK_MAX_SUPPORT_NUM                          5
-/* 缺省的任务栈大小 */
+/* 缺省的任务栈大小与IDLE任务栈的大小，主机仿真时ucontext与libc需要更大的栈 */
+#if defined(OS_ARCH_POSIX)
+#define OS_TSK_DEFAULT_STACK_SIZE                       0x4000
+#define OS_TSK_IDLE_STACK_SIZE                          0x4000
+#else
 #define OS_TSK_DEFAULT_STACK_SIZE                       0x200
-/* IDLE任务栈的大小 */
 #define OS_TSK_IDLE_STACK_SIZE                          0x150
+#endif
 /* 任务栈初始化魔术字，默认是0xCA，只支持配置一个字节 */
 #define OS_TSK_STACK_MAGIC_WORD                         0xCACACACA
 
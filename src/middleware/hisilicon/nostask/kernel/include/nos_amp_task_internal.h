@@ -33,6 +33,7 @@ INLINE void OsEnqueueTaskAmp(struct TagOsRunQue *runQue, struct TagTskCB *tsk)
     unsigned int priority = tsk->priority;
 
     ListTailAdd(&tsk->pendList, &runQue->readyList[priority]);
+    runQue->readyCount[priority]++;
     runQue->taskReadyListBitMap |= (OS_TSK_PRIO_RDY_BIT >> priority);
 }
 
@@ -42,6 +43,7 @@ INLINE void OsEnqueueTaskHeadAmp(struct TagOsRunQue *runQue, struct TagTskCB *ts
     unsigned int priority = tsk->priority;
 
     ListAdd(&tsk->pendList, &runQue->readyList[priority]);
+    runQue->readyCount[priority]++;
     runQue->taskReadyListBitMap |= (OS_TSK_PRIO_RDY_BIT >> priority);
 }
 
@@ -49,11 +51,11 @@ INLINE void OsEnqueueTaskHeadAmp(struct TagOsRunQue *runQue, struct TagTskCB *ts
 INLINE void OsDequeueTaskAmp(struct TagOsRunQue *runQue, struct TagTskCB *tsk)
 {
     unsigned int priority = tsk->priority;
-    struct TagListObject *readyList = &runQue->readyList[priority];
 
     /* 从链表中删除 */
     ListDelete(&tsk->pendList);
-    if (ListEmpty(readyList)) {
+    runQue->readyCount[priority]--;
+    if (runQue->readyCount[priority] == 0) {
         runQue->taskReadyListBitMap &= ~(OS_TSK_PRIO_RDY_BIT >> priority);
     }
 }
@@ -31,8 +31,23 @@
 struct TagOsRunQue {
     unsigned int taskReadyListBitMap;
     struct TagListObject readyList[OS_TSK_NUM_OF_PRIORITIES];
+    /* 各优先级就绪任务数，与readyList同步维护，避免遍历链表计数 */
+    unsigned short readyCount[OS_TSK_NUM_OF_PRIORITIES];
 };
 
+#if defined(OS_OPTION_SCHED_LATENCY)
+/* 调度时延统计，单位cycle：从OsTskSchedule发起切换请求到OsMainSchedule完成切换 */
+struct TagOsSchedLatency {
+    unsigned int reqCycle;
+    unsigned int lastCycle;
+    unsigned int maxCycle;
+    unsigned int minCycle;
+    unsigned int switchCnt;
+};
+
+extern struct TagOsSchedLatency g_schedLatency;
+#endif
+
 struct TagOsTskSortedDelayList {
     /* 延时任务链表 */
     struct TagListObject tskList;
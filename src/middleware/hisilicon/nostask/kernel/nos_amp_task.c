@@ -21,6 +21,9 @@
 
 struct TagOsTskSortedDelayList g_tskSortedDelay;
 struct TagOsRunQue g_runQueue;  // 核的局部运行队列
+#if defined(OS_OPTION_SCHED_LATENCY)
+struct TagOsSchedLatency g_schedLatency = {.minCycle = OS_MAX_U32};
+#endif
 
 /*
  * 描述: Task schedule, switch to the highest task.
@@ -33,6 +36,12 @@ void OsTskSchedule(void)
 
     /* In case that running is not highest then reschedule */
     if ((g_highestTask != RUNNING_TASK) && (g_uniTaskLock == 0)) {
+#if defined(OS_OPTION_SCHED_LATENCY)
+        /* 记录首次发起切换请求的时刻，重复请求不刷新 */
+        if ((UNI_FLAG & OS_FLG_TSK_REQ) == 0) {
+            g_schedLatency.reqCycle = (unsigned int)NOS_GetCycle();
+        }
+#endif
         UNI_FLAG |= OS_FLG_TSK_REQ;
 
         /* only if there is not HWI or SWI or TICK the trap */
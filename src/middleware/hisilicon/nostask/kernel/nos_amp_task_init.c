@@ -50,6 +50,7 @@ unsigned int OsTskAMPInit(void)
     /* Init empty ready list for each priority. */
     for (idx = 0; idx < OS_TSK_NUM_OF_PRIORITIES; idx++) {
         OS_LIST_INIT(&g_runQueue.readyList[idx]);
+        g_runQueue.readyCount[idx] = 0;
     }
 
     OS_LIST_INIT(&g_tskSortedDelay.tskList);
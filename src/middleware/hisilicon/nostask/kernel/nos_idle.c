@@ -18,6 +18,9 @@
   * @file      nos_idle.c
   */
 #include "nos_idle_external.h"
+#if defined(OS_ARCH_POSIX)
+#include "nos_posix_adapter.h"
+#endif
 
 /*
  * 描述: 单次Idle任务
@@ -32,6 +35,10 @@
 void OsIdleTaskExe(void)
 {
     OsErrInHwiProc();
+#if defined(OS_ARCH_POSIX)
+    /* 主机仿真没有WFI，虚拟时间直接快进到下一个tick */
+    OsSimIdle();
+#endif
 }
 
 /*
@@ -19,6 +19,23 @@
   */
 #include "nos_task_external.h"
 
+#if defined(OS_OPTION_SCHED_LATENCY)
+/* 统计本次切换时延，只取cycle低32位，差值在回绕时仍然正确 */
+INLINE void OsSchedLatencyUpdate(void)
+{
+    unsigned int latency = (unsigned int)NOS_GetCycle() - g_schedLatency.reqCycle;
+
+    g_schedLatency.lastCycle = latency;
+    if (latency > g_schedLatency.maxCycle) {
+        g_schedLatency.maxCycle = latency;
+    }
+    if (latency < g_schedLatency.minCycle) {
+        g_schedLatency.minCycle = latency;
+    }
+    g_schedLatency.switchCnt++;
+}
+#endif
+
 /*
  * 描述: 调度的主入口
  * 备注: NA
@@ -30,6 +47,9 @@
         /* 有任务切换钩子&最高优先级任务等待调度 */
         if (RUNNING_TASK != g_highestTask) {
             OsTskSwitchHookCaller(RUNNING_TASK->taskPid, g_highestTask->taskPid);
+#if defined(OS_OPTION_SCHED_LATENCY)
+            OsSchedLatencyUpdate();
+#endif
         }
 
         /* 清除OS_FLG_TSK_REQ标记位 */
@@ -58,11 +58,9 @@ INLINE unsigned int OsTaskYieldProc(unsigned int nextTaskId, unsigned int taskPr
 static unsigned int OsTaskYield(unsigned short taskPrio, unsigned int nextTaskId, unsigned int *yieldTo)
 {
     unsigned int ret;
-    unsigned int tskCount = 0;
     struct TagTskCB *currTask = NULL;
     struct TagTskCB *runTask = NULL;
     struct TagListObject *tskPriorRdyList = NULL;
-    struct TagListObject *currNode = NULL;
 
     runTask = RUNNING_TASK;
 
@@ -74,11 +72,8 @@ static unsigned int OsTaskYield(unsigned short taskPrio, unsigned int nextTaskId
     /* to the end of the queue */
     currTask = GET_TCB_PEND(OS_LIST_FIRST(tskPriorRdyList));
 
-    for (currNode = tskPriorRdyList->next; currNode != tskPriorRdyList; currNode = currNode->next) {
-        tskCount++;
-    }
-
-    if (tskCount > 1) {
+    /* 就绪任务数由入队/出队维护，无需遍历链表 */
+    if (g_runQueue.readyCount[taskPrio] > 1) {
         ret = OsTaskYieldProc(nextTaskId, taskPrio, yieldTo, currTask, tskPriorRdyList);
         if (ret != NOS_OK) {
             OsSpinUnlockTaskRq(runTask);
@@ -19,6 +19,7 @@
   */
 
 #include "nos_base_task.h"
+#include "nos_task_external.h"
 #include "nos_config_internal.h"
 #include "nos_config.h"
 #include "nos_task.h"
@@ -44,6 +45,7 @@ int NOS_TaskInit(NOS_SysConfig *config)
     return 0;
 }
 
+#if !defined(OS_ARCH_POSIX)
 unsigned long long NOS_GetCycle(void)
 {
     unsigned int cycle, cycleh;
@@ -54,6 +56,7 @@ unsigned long long NOS_GetCycle(void)
     unsigned long long longCycle = (unsigned long long)cycle + (unsigned long long)cycleh * 0xFFFFFFFF;
     return longCycle;
 }
+#endif
 
 int NOS_StartScheduler(void)
 {
@@ -166,6 +169,45 @@ int NOS_TaskPriorityGet(unsigned int taskId, unsigned short *priority)
     return (int)NOS_TaskPriorityGetInner(taskId, priority);
 }
 
+/*
+ * 描述: 获取调度时延统计。
+ */
+int NOS_GetSchedLatency(NOS_SchedLatency *latency)
+{
+#if defined(OS_OPTION_SCHED_LATENCY)
+    uintptr_t intSave;
+
+    if (latency == NULL) {
+        return -1;
+    }
+    intSave = NOS_IntLock();
+    latency->lastCycle = g_schedLatency.lastCycle;
+    latency->maxCycle = g_schedLatency.maxCycle;
+    latency->minCycle = g_schedLatency.minCycle;
+    latency->switchCnt = g_schedLatency.switchCnt;
+    NOS_IntRestore(intSave);
+    return 0;
+#else
+    (void)latency;
+    return -1;
+#endif
+}
+
+/*
+ * 描述: 清零调度时延统计。
+ */
+void NOS_ClearSchedLatency(void)
+{
+#if defined(OS_OPTION_SCHED_LATENCY)
+    uintptr_t intSave = NOS_IntLock();
+    g_schedLatency.lastCycle = 0;
+    g_schedLatency.maxCycle = 0;
+    g_schedLatency.minCycle = OS_MAX_U32;
+    g_schedLatency.switchCnt = 0;
+    NOS_IntRestore(intSave);
+#endif
+}
+
 /* **********************timer task********************* */
 
 /*
@@ -45,6 +45,13 @@ typedef struct {
     unsigned int stackAddr;
 }NOS_TimerTaskInitParam;
 
+typedef struct {
+    unsigned int lastCycle; /* 最近一次任务切换时延 */
+    unsigned int maxCycle;
+    unsigned int minCycle;
+    unsigned int switchCnt; /* 已统计的切换次数 */
+} NOS_SchedLatency;
+
 typedef struct {
     unsigned int cyclePerUs;
     unsigned int usecPerTick;
@@ -71,6 +78,12 @@ int NOS_TaskPrioritySet(unsigned int taskId, unsigned short priority);
 
 int NOS_TaskPriorityGet(unsigned int taskId, unsigned short *priority);
 
+/* 获取调度时延统计(单位cycle)，需打开OS_OPTION_SCHED_LATENCY，否则返回-1 */
+int NOS_GetSchedLatency(NOS_SchedLatency *latency);
+
+/* 清零调度时延统计 */
+void NOS_ClearSchedLatency(void);
+
 /* **********************timer task********************* */
 
 int NOS_CreateTimerTask(unsigned int *timerTaskId, NOS_TimerTaskInitParam *timerParam);
@@ -0,0 +1,197 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      crcbench.c
+  * @author    MCU Driver Team
+  * @brief     Host check and benchmark of the software CRC.
+  * @details   Every @ref CRC_AlgorithmMode is checked against its catalogue value for "123456789", then the byte
+  *            table, slicing-by-4 and slicing-by-8 of crc_soft.c are compared with a bit by bit reference on
+  *            random buffers of every length up to 64 bytes and every start offset, and finally timed on a large
+  *            buffer. Usage: crcbench [buffer KB] [rounds]
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "crc_ex.h"
+
+#define BENCH_CHECK_LEN_MAX     64U
+#define BENCH_OFFSET_MAX        8U
+#define BENCH_DEFAULT_KB        1024U
+#define BENCH_DEFAULT_ROUNDS    8U
+
+typedef struct {
+    const char         *name;
+    CRC_AlgorithmMode   mode;
+    unsigned int        check;  /* CRC of "123456789" */
+} BENCH_Algo;
+
+static const BENCH_Algo g_algos[] = {
+    {"CRC8",              CRC8,              0xF4},
+    {"CRC8_ITU",          CRC8_ITU,          0xA1},
+    {"CRC8_ROHC",         CRC8_ROHC,         0xD0},
+    {"CRC16_IBM",         CRC16_IBM,         0xBB3D},
+    {"CRC16_MAXIM",       CRC16_MAXIM,       0x44C2},
+    {"CRC16_USB",         CRC16_USB,         0xB4C8},
+    {"CRC16_MODBUS",      CRC16_MODBUS,      0x4B37},
+    {"CRC16_CCITT",       CRC16_CCITT,       0x2189},
+    {"CRC16_CCITT_FALSE", CRC16_CCITT_FALSE, 0x29B1},
+    {"CRC16_X25",         CRC16_X25,         0x906E},
+    {"CRC16_XMODEM",      CRC16_XMODEM,      0x31C3},
+    {"CRC32",             CRC32,             0xCBF43926},
+    {"CRC32_MPEG2",       CRC32_MPEG2,       0x0376E6E7},
+};
+
+static const unsigned int g_slices[] = {1, 4, 8};
+#define BENCH_ALGO_NUM  (sizeof(g_algos) / sizeof(g_algos[0]))
+#define BENCH_SLICE_NUM (sizeof(g_slices) / sizeof(g_slices[0]))
+
+static CRC_SoftHandle g_soft[BENCH_SLICE_NUM];
+
+static unsigned int Reflect(unsigned int value, unsigned int width)
+{
+    unsigned int out = 0;
+    for (unsigned int i = 0; i < width; i++) {
+        out = (out << 1) | ((value >> i) & 1U);
+    }
+    return out;
+}
+
+/* Bit by bit reference, one shift per input bit like build/packet_create.py */
+static unsigned int BitwiseCrc(const CRC_SoftHandle *param, unsigned int poly, const unsigned char *data,
+                               unsigned int len)
+{
+    unsigned int top = 1U << (param->width - 1);
+    unsigned int mask = (param->width == 32) ? 0xFFFFFFFFU : ((1U << param->width) - 1);
+    unsigned int crc = param->init;
+    for (unsigned int i = 0; i < len; i++) {
+        unsigned int byte = param->refIn ? Reflect(data[i], 8) : data[i];
+        crc ^= byte << (param->width - 8);
+        for (unsigned int k = 0; k < 8; k++) {
+            crc = ((crc & top) != 0) ? ((crc << 1) ^ poly) : (crc << 1);
+        }
+        crc &= mask;
+    }
+    crc = param->refOut ? Reflect(crc, param->width) : crc;
+    return (crc ^ param->xorOut) & mask;
+}
+
+static unsigned int PolyOf(CRC_AlgorithmMode mode)
+{
+    switch (mode & TYPE_POLY_MASK) {
+        case CRC8_07_POLY_MODE:
+        case CRC8_07_POLY_MODE_BK:
+            return 0x07;
+        case CRC16_8005_POLY_MODE:
+            return 0x8005;
+        case CRC16_1021_POLY_MODE:
+            return 0x1021;
+        default:
+            return 0x04C11DB7;
+    }
+}
+
+static double NowSec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned int CheckAlgo(const BENCH_Algo *algo, const unsigned char *rnd)
+{
+    static const unsigned char checkStr[] = "123456789";
+    unsigned int poly = PolyOf(algo->mode);
+    unsigned int errors = 0;
+    for (unsigned int s = 0; s < BENCH_SLICE_NUM; s++) {
+        if (HAL_CRC_SoftInitEx(&g_soft[s], algo->mode, g_slices[s]) != BASE_STATUS_OK) {
+            printf("%-18s slice %u: init failed\n", algo->name, g_slices[s]);
+            return 1;
+        }
+        unsigned int crc = HAL_CRC_SoftCalculateEx(&g_soft[s], checkStr, sizeof(checkStr) - 1);
+        if (crc != algo->check) {
+            printf("%-18s slice %u: check 0x%X, expected 0x%X\n", algo->name, g_slices[s], crc, algo->check);
+            errors++;
+        }
+    }
+    for (unsigned int off = 0; off < BENCH_OFFSET_MAX; off++) {
+        for (unsigned int len = 0; len <= BENCH_CHECK_LEN_MAX; len++) {
+            unsigned int ref = BitwiseCrc(&g_soft[0], poly, rnd + off, len);
+            for (unsigned int s = 0; s < BENCH_SLICE_NUM; s++) {
+                /* Split in two updates to cover the state carried between calls */
+                unsigned int state = HAL_CRC_SoftStartEx(&g_soft[s]);
+                state = HAL_CRC_SoftUpdateEx(&g_soft[s], state, rnd + off, len / 3);
+                state = HAL_CRC_SoftUpdateEx(&g_soft[s], state, rnd + off + len / 3, len - len / 3);
+                unsigned int crc = HAL_CRC_SoftFinishEx(&g_soft[s], state);
+                if (crc != ref) {
+                    printf("%-18s slice %u: offset %u length %u gives 0x%X, reference 0x%X\n",
+                           algo->name, g_slices[s], off, len, crc, ref);
+                    errors++;
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+static void BenchAlgo(const BENCH_Algo *algo, const unsigned char *buf, unsigned int len, unsigned int rounds)
+{
+    unsigned int poly = PolyOf(algo->mode);
+    double mb = (double)len * rounds / (1024.0 * 1024.0);
+    volatile unsigned int sink = 0;
+    printf("%-18s", algo->name);
+    double t0 = NowSec();
+    sink ^= BitwiseCrc(&g_soft[0], poly, buf, len); /* one round, the bitwise loop is slow */
+    printf(" %9.1f", (double)len / (1024.0 * 1024.0) / (NowSec() - t0));
+    for (unsigned int s = 0; s < BENCH_SLICE_NUM; s++) {
+        t0 = NowSec();
+        for (unsigned int r = 0; r < rounds; r++) {
+            sink ^= HAL_CRC_SoftCalculateEx(&g_soft[s], buf, len);
+        }
+        printf(" %9.1f", mb / (NowSec() - t0));
+    }
+    printf("\n");
+    (void)sink;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int kb = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_KB;
+    unsigned int rounds = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : BENCH_DEFAULT_ROUNDS;
+    unsigned int len = (kb == 0 ? 1 : kb) * 1024U;
+    unsigned char *buf = malloc(len);
+    if (buf == NULL) {
+        return 1;
+    }
+    srand(1);
+    for (unsigned int i = 0; i < len; i++) {
+        buf[i] = (unsigned char)rand();
+    }
+    unsigned int errors = 0;
+    for (unsigned int a = 0; a < BENCH_ALGO_NUM; a++) {
+        errors += CheckAlgo(&g_algos[a], buf);
+    }
+    printf("check: %u algorithms, %u errors\n\n", (unsigned int)BENCH_ALGO_NUM, errors);
+    printf("%u KB x %u rounds, MB/s\n", len / 1024U, rounds);
+    printf("%-18s %9s %9s %9s %9s\n", "algorithm", "bitwise", "table", "slice4", "slice8");
+    for (unsigned int a = 0; a < BENCH_ALGO_NUM; a++) {
+        (void)CheckAlgo(&g_algos[a], buf); /* leaves the tables of this algorithm in g_soft */
+        BenchAlgo(&g_algos[a], buf, len, rounds);
+    }
+    free(buf);
+    return (errors == 0) ? 0 : 1;
+}
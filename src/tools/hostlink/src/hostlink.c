@@ -0,0 +1,869 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostlink.c
+  * @author    MCU Algorithm Team
+  * @brief     Host reference implementation of the binary host link of pmsm_sensorless_2shunt_foc.
+  * @details   COBS framing, CRC16_XMODEM, request building and response parsing as described in host_link.h, a
+  *            serial client for Linux and a self-test of the codec: random messages full of zero bytes are sent
+  *            through a stream with corrupted, truncated and inserted bytes, every clean frame must come out and no
+  *            damaged one may be accepted.
+  *            Usage: hostlink selftest [frames]
+  *                   hostlink [-d device] [-b baud] command [arguments]
+  *            Commands: hello, bye [stop], ping [n], start, stop, stat, info, read name..., write name=value...,
+  *                      bench n name=value..., sub periodUs samples name...
+  *            Parameters are given by name (see info) or by ID, e.g. 0x0202.
+  */
+#include <asm/ioctls.h>
+#include <asm/termbits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Same values as host_frame.h and host_link.h of the target */
+#define HL_BLOCK_MAX        254U
+#define HL_ENC_LEN(len)     ((len) + (len) / HL_BLOCK_MAX + 2)
+#define HL_HEAD_LEN         4U
+#define HL_CRC_LEN          2U
+#define HL_PAYLOAD_MAX      192U
+#define HL_MSG_MAX          (HL_HEAD_LEN + HL_PAYLOAD_MAX + HL_CRC_LEN)
+#define HL_PKT_MAX          (HL_ENC_LEN(HL_MSG_MAX) - 1)
+
+#define HL_MSG_HELLO        0x01
+#define HL_MSG_BYE          0x02
+#define HL_MSG_PING         0x03
+#define HL_MSG_MOTOR_CMD    0x04
+#define HL_MSG_STAT         0x05
+#define HL_MSG_PARAM_READ   0x10
+#define HL_MSG_PARAM_WRITE  0x11
+#define HL_MSG_PARAM_INFO   0x12
+#define HL_MSG_TELEM_SUB    0x20
+#define HL_MSG_TELEM        0x40
+#define HL_MSG_SCOPE_DATA   0x41
+#define HL_MSG_RESP         0x80
+
+#define HL_MOTOR_START      1
+#define HL_MOTOR_STOP       2
+
+#define HL_PARAM_MAX        128U    /* Parameters kept from PARAM_INFO */
+#define HL_ITEM_MAX         27U     /* Items of a read or write batch: 1 + 27 * 7 <= HL_PAYLOAD_MAX */
+#define HL_SIGNAL_MAX       32U
+#define HL_TIMEOUT_MS       100
+#define HL_RETRY_NUM        3
+#define HL_BAUD_DEFAULT     1843200U
+
+typedef enum {
+    HL_PARAM_F32 = 0,
+    HL_PARAM_U32,
+    HL_PARAM_I32,
+    HL_PARAM_U16,
+    HL_PARAM_U8
+} HL_ParamType;
+
+typedef union {
+    unsigned int u;
+    float f;
+} HL_Value;
+
+typedef struct {
+    unsigned char type;
+    unsigned char seq;
+    unsigned int len;
+    unsigned char payload[HL_PAYLOAD_MAX];
+} HL_Msg;
+
+/**
+  * @brief Stream receiver: bytes are collected up to the delimiter, then decoded and checked.
+  */
+typedef struct {
+    unsigned char pkt[HL_PKT_MAX];
+    unsigned int len;
+    bool drop;                  /* Frame longer than HL_PKT_MAX, skipped up to its delimiter */
+    unsigned int msgCnt;
+    unsigned int crcErrCnt;
+    unsigned int frameErrCnt;   /* COBS, length or size error */
+} HL_Rx;
+
+typedef struct {
+    unsigned short id;
+    unsigned char type;
+    unsigned char flags;
+    float min;
+    float max;
+} HL_Param;
+
+typedef struct {
+    int fd;
+    HL_Rx rx;
+    unsigned char seq;
+    unsigned int timeoutCnt;
+    HL_Param param[HL_PARAM_MAX];
+    unsigned int paramNum;
+} HL_Client;
+
+typedef struct {
+    unsigned short id;
+    const char *name;
+} HL_Name;
+
+/* Names of the parameter IDs of host_param.h */
+static const HL_Name g_hlNames[] = {
+    {0x0100, "iq_fbk"}, {0x0101, "id_fbk"}, {0x0102, "iq_ref"}, {0x0103, "id_ref"}, {0x0104, "spd_est"},
+    {0x0105, "spd_ref"}, {0x0106, "udc"}, {0x0107, "board_temp"}, {0x0108, "err_code"}, {0x0109, "curr_u"},
+    {0x010A, "curr_v"}, {0x010B, "curr_w"}, {0x010C, "duty_u"}, {0x010D, "duty_v"}, {0x010E, "duty_w"},
+    {0x010F, "axis_angle"}, {0x0110, "vq_ref"}, {0x0111, "vd_ref"},
+    {0x0200, "currd_kp"}, {0x0201, "currd_ki"}, {0x0202, "currq_kp"}, {0x0203, "currq_ki"}, {0x0204, "curr_limit"},
+    {0x0300, "spd_kp"}, {0x0301, "spd_ki"}, {0x0302, "spd_limit"}, {0x0303, "spd_cmd"}, {0x0304, "spd_ramp"},
+    {0x0400, "observer_type"}, {0x0401, "smo_gain"}, {0x0402, "smo_pll_bdw"}, {0x0403, "smo_spd_fc"},
+    {0x0404, "smo_filcomp"}, {0x0410, "smo4th_kd"}, {0x0411, "smo4th_kq"}, {0x0412, "smo4th_pll_bdw"},
+    {0x0500, "if_target"}, {0x0501, "if_step"}, {0x0502, "spd_begin"},
+    {0x0600, "mtr_np"}, {0x0601, "mtr_rs"}, {0x0602, "mtr_ld"}, {0x0603, "mtr_lq"}, {0x0604, "max_elec_spd"},
+    {0x0700, "volt_pu"}, {0x0701, "adc_curr_cofe"}, {0x0702, "curr_ctrl_period"},
+    {0x0800, "fsm_state"}, {0x0801, "spd_adjust_mode"}, {0x0802, "motor_run"},
+};
+
+static const char *g_hlStatus[] = {
+    "ok", "unknown message", "bad length", "unknown id", "read only", "out of range", "skipped", "refused"
+};
+
+static unsigned short g_hlCrcTable[256];
+
+/* ---------------------------------------------------------------- codec */
+
+static void HlCrcInit(void)
+{
+    for (unsigned int i = 0; i < 256; i++) {
+        unsigned int crc = i << 8;
+        for (unsigned int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+        g_hlCrcTable[i] = (unsigned short)crc;
+    }
+}
+
+static unsigned int HlCrc16(const unsigned char *data, unsigned int len)
+{
+    unsigned int crc = 0;
+    for (unsigned int i = 0; i < len; i++) {
+        crc = ((crc << 8) ^ g_hlCrcTable[((crc >> 8) ^ data[i]) & 0xFF]) & 0xFFFF;
+    }
+    return crc;
+}
+
+static unsigned int HlCobsEncode(const unsigned char *msg, unsigned int len, unsigned char *out)
+{
+    unsigned int codeIdx = 0;
+    unsigned int outLen = 1;
+    unsigned char code = 1;
+    for (unsigned int i = 0; i < len; i++) {
+        if (msg[i] != 0) {
+            out[outLen++] = msg[i];
+            code++;
+        }
+        if (msg[i] == 0 || code == HL_BLOCK_MAX + 1) {
+            out[codeIdx] = code;
+            codeIdx = outLen++;
+            code = 1;
+        }
+    }
+    out[codeIdx] = code;
+    out[outLen++] = 0;
+    return outLen;
+}
+
+static unsigned int HlCobsDecode(unsigned char *buf, unsigned int len)
+{
+    unsigned int in = 0;
+    unsigned int out = 0;
+    while (in < len) {
+        unsigned int code = buf[in++];
+        if (code == 0 || in + code - 1 > len) {
+            return 0;
+        }
+        for (unsigned int i = 1; i < code; i++) {
+            if (buf[in] == 0) {
+                return 0;
+            }
+            buf[out++] = buf[in++];
+        }
+        if (code != HL_BLOCK_MAX + 1 && in < len) {
+            buf[out++] = 0;
+        }
+    }
+    return out;
+}
+
+static void HlPutU16(unsigned char *p, unsigned int value)
+{
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+}
+
+static void HlPutU32(unsigned char *p, unsigned int value)
+{
+    HlPutU16(p, value);
+    HlPutU16(&p[2], value >> 16);
+}
+
+static unsigned int HlGetU16(const unsigned char *p)
+{
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8);
+}
+
+static unsigned int HlGetU32(const unsigned char *p)
+{
+    return HlGetU16(p) | (HlGetU16(&p[2]) << 16);
+}
+
+/* Frame of a message, delimiter included, out holds HL_ENC_LEN(HL_MSG_MAX) bytes */
+static unsigned int HlEncode(const HL_Msg *msg, unsigned char *out)
+{
+    unsigned char raw[HL_MSG_MAX];
+    unsigned int len = HL_HEAD_LEN + msg->len;
+    raw[0] = msg->type;
+    raw[1] = msg->seq;
+    HlPutU16(&raw[2], msg->len);
+    memcpy(&raw[HL_HEAD_LEN], msg->payload, msg->len);
+    unsigned int crc = HlCrc16(raw, len);
+    raw[len++] = (unsigned char)(crc >> 8);
+    raw[len++] = (unsigned char)crc;
+    return HlCobsEncode(raw, len, out);
+}
+
+static bool HlRxCheck(HL_Rx *rx, HL_Msg *msg)
+{
+    unsigned int len = HlCobsDecode(rx->pkt, rx->len);
+    if (len < HL_HEAD_LEN + HL_CRC_LEN || len > HL_MSG_MAX ||
+        HlGetU16(&rx->pkt[2]) != len - HL_HEAD_LEN - HL_CRC_LEN) {
+        rx->frameErrCnt++;
+        return false;
+    }
+    if (HlCrc16(rx->pkt, len) != 0) { /* The CRC over the message and its big endian CRC is 0 */
+        rx->crcErrCnt++;
+        return false;
+    }
+    msg->type = rx->pkt[0];
+    msg->seq = rx->pkt[1];
+    msg->len = len - HL_HEAD_LEN - HL_CRC_LEN;
+    memcpy(msg->payload, &rx->pkt[HL_HEAD_LEN], msg->len);
+    rx->msgCnt++;
+    return true;
+}
+
+/* Feed one received byte, true when it completes a valid message */
+static bool HlRxFeed(HL_Rx *rx, unsigned char byte, HL_Msg *msg)
+{
+    if (byte != 0) {
+        if (rx->len < HL_PKT_MAX) {
+            rx->pkt[rx->len++] = byte;
+        } else {
+            rx->drop = true;
+        }
+        return false;
+    }
+    bool valid = false;
+    if (rx->drop) {
+        rx->frameErrCnt++;
+    } else if (rx->len > 0) {
+        valid = HlRxCheck(rx, msg);
+    }
+    rx->len = 0;
+    rx->drop = false;
+    return valid;
+}
+
+/* ---------------------------------------------------------------- self-test */
+
+static unsigned int g_hlRand = 1;
+
+static unsigned int HlRand(void)
+{
+    g_hlRand = g_hlRand * 1103515245U + 12345U;
+    return g_hlRand >> 8;
+}
+
+static void HlRandomMsg(HL_Msg *msg, unsigned int idx)
+{
+    msg->type = (unsigned char)HlRand();
+    msg->seq = (unsigned char)idx;
+    msg->len = HlRand() % (HL_PAYLOAD_MAX + 1);
+    for (unsigned int i = 0; i < msg->len; i++) {
+        /* One byte in four is 0, runs of non-zero bytes also reach the COBS block length */
+        msg->payload[i] = ((HlRand() & 3) == 0) ? 0 : (unsigned char)(HlRand() | 1);
+    }
+    if ((idx % 16) == 0) {
+        memset(msg->payload, 0x55, msg->len);
+    }
+}
+
+/* Damage the body of a frame, never its delimiter: 0 clean, 1 byte changed, 2 truncated, 3 garbage before it */
+static unsigned int HlDamage(unsigned char *frame, unsigned int *len, unsigned char *garbage, unsigned int *garbageLen)
+{
+    unsigned int kind = (HlRand() % 8 == 0) ? (1 + HlRand() % 3) : 0;
+    unsigned int body = *len - 1;
+    *garbageLen = 0;
+    if (kind == 1) {
+        unsigned int pos = HlRand() % body;
+        frame[pos] ^= (unsigned char)(1 + HlRand() % 255);
+    } else if (kind == 2) {
+        unsigned int cut = 1 + HlRand() % body;
+        memmove(&frame[body - cut], &frame[body], 1);
+        *len -= cut;
+    } else if (kind == 3) {
+        *garbageLen = 1 + HlRand() % 64;
+        for (unsigned int i = 0; i < *garbageLen; i++) {
+            garbage[i] = (unsigned char)HlRand();
+        }
+    }
+    return kind;
+}
+
+static int HlSelfTest(unsigned int frameNum)
+{
+    HL_Rx rx;
+    memset(&rx, 0, sizeof(rx));
+    unsigned int damaged = 0;
+    unsigned int lost = 0;
+    unsigned int accepted = 0;
+    unsigned long long bytes = 0;
+    for (unsigned int idx = 0; idx < frameNum; idx++) {
+        HL_Msg sent;
+        HL_Msg got;
+        unsigned char frame[HL_ENC_LEN(HL_MSG_MAX)];
+        unsigned char garbage[64];
+        unsigned int garbageLen;
+        HlRandomMsg(&sent, idx);
+        unsigned int len = HlEncode(&sent, frame);
+        if (len > HL_ENC_LEN(HL_HEAD_LEN + sent.len + HL_CRC_LEN)) {
+            printf("frame %u: encoded length %u above the bound\n", idx, len);
+            return 1;
+        }
+        unsigned int kind = HlDamage(frame, &len, garbage, &garbageLen);
+        damaged += (kind != 0);
+        bool match = false;
+        /* Line noise between two frames: up to the next delimiter, it must not take the frame with it */
+        for (unsigned int i = 0; i < garbageLen; i++) {
+            accepted += HlRxFeed(&rx, garbage[i], &got);
+        }
+        if (garbageLen > 0) {
+            accepted += HlRxFeed(&rx, 0, &got);
+        }
+        for (unsigned int i = 0; i < len; i++) {
+            if (HlRxFeed(&rx, frame[i], &got)) {
+                match = (got.type == sent.type && got.seq == sent.seq && got.len == sent.len &&
+                         memcmp(got.payload, sent.payload, sent.len) == 0);
+                accepted += (kind == 1 || kind == 2 || !match);
+            }
+        }
+        lost += (kind != 1 && kind != 2 && !match);
+        bytes += len + garbageLen;
+    }
+    printf("frames %u, damaged %u, bytes %llu\n", frameNum, damaged, bytes);
+    printf("received %u, crc errors %u, frame errors %u\n", rx.msgCnt, rx.crcErrCnt, rx.frameErrCnt);
+    printf("clean frames lost %u, damaged frames accepted %u\n", lost, accepted);
+    return (lost == 0 && accepted == 0) ? 0 : 1;
+}
+
+/* ---------------------------------------------------------------- serial client */
+
+int ioctl(int fd, unsigned long request, ...);
+
+static int HlSerialOpen(const char *dev, unsigned int baud)
+{
+    int fd = open(dev, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", dev, strerror(errno));
+        return -1;
+    }
+    struct termios2 tio;
+    if (ioctl(fd, TCGETS2, &tio) != 0) {
+        fprintf(stderr, "%s: %s\n", dev, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    /* Raw 8N1 at any baud rate, 1843200 has no Bxxx constant */
+    tio.c_iflag = 0;
+    tio.c_oflag = 0;
+    tio.c_lflag = 0;
+    tio.c_cflag = CS8 | CREAD | CLOCAL | BOTHER;
+    tio.c_ispeed = baud;
+    tio.c_ospeed = baud;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if (ioctl(fd, TCSETS2, &tio) != 0 || ioctl(fd, TCFLSH, TCIOFLUSH) != 0) {
+        fprintf(stderr, "%s: %s\n", dev, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static double HlNowMs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void HlPrintValue(unsigned char type, unsigned int value)
+{
+    HL_Value v = { .u = value };
+    if (type == HL_PARAM_F32) {
+        printf("%g", v.f);
+    } else if (type == HL_PARAM_I32) {
+        printf("%d", (int)value);
+    } else {
+        printf("%u", value);
+    }
+}
+
+static const HL_Param *HlParamFind(const HL_Client *client, unsigned int id)
+{
+    for (unsigned int i = 0; i < client->paramNum; i++) {
+        if (client->param[i].id == id) {
+            return &client->param[i];
+        }
+    }
+    return NULL;
+}
+
+static const char *HlParamName(unsigned int id)
+{
+    for (unsigned int i = 0; i < sizeof(g_hlNames) / sizeof(g_hlNames[0]); i++) {
+        if (g_hlNames[i].id == id) {
+            return g_hlNames[i].name;
+        }
+    }
+    return "?";
+}
+
+static int HlParamId(const char *arg, unsigned int len)
+{
+    for (unsigned int i = 0; i < sizeof(g_hlNames) / sizeof(g_hlNames[0]); i++) {
+        if (strlen(g_hlNames[i].name) == len && strncmp(g_hlNames[i].name, arg, len) == 0) {
+            return g_hlNames[i].id;
+        }
+    }
+    char *end;
+    long id = strtol(arg, &end, 0);
+    return (end == arg + len && id >= 0 && id <= 0xFFFF) ? (int)id : -1;
+}
+
+static void HlPrintAsync(const HL_Msg *msg)
+{
+    if (msg->type == HL_MSG_TELEM && msg->len >= 8) {
+        printf("telem %u tick %u:", HlGetU32(msg->payload), HlGetU32(&msg->payload[4]));
+        for (unsigned int i = 8; i + 4 <= msg->len; i += 4) {
+            HL_Value v = { .u = HlGetU32(&msg->payload[i]) };
+            printf(" %g", v.f);
+        }
+        printf("\n");
+    }
+}
+
+static bool HlReceive(HL_Client *client, HL_Msg *msg, int timeoutMs)
+{
+    double end = HlNowMs() + timeoutMs;
+    for (;;) {
+        unsigned char buf[256];
+        struct pollfd pfd = { .fd = client->fd, .events = POLLIN };
+        int wait = (int)(end - HlNowMs());
+        if (wait < 0 || poll(&pfd, 1, wait) <= 0) {
+            return false;
+        }
+        ssize_t len = read(client->fd, buf, 1);
+        for (ssize_t i = 0; i < len; i++) {
+            if (HlRxFeed(&client->rx, buf[i], msg)) {
+                return true;
+            }
+        }
+    }
+}
+
+/* Send a request and wait for its response, repeated after a timeout. Telemetry received meanwhile is printed. */
+static int HlRequest(HL_Client *client, unsigned char type, const unsigned char *payload, unsigned int len,
+                     HL_Msg *resp)
+{
+    HL_Msg req;
+    unsigned char frame[HL_ENC_LEN(HL_MSG_MAX)];
+    req.type = type;
+    req.len = len;
+    memcpy(req.payload, payload, len);
+    for (int retry = 0; retry < HL_RETRY_NUM; retry++) {
+        req.seq = client->seq++;
+        unsigned int frameLen = HlEncode(&req, frame);
+        if (write(client->fd, frame, frameLen) != (ssize_t)frameLen) {
+            fprintf(stderr, "write: %s\n", strerror(errno));
+            return -1;
+        }
+        while (HlReceive(client, resp, HL_TIMEOUT_MS)) {
+            if (resp->type == (type | HL_MSG_RESP) && resp->seq == req.seq && resp->len > 0) {
+                return resp->payload[0];
+            }
+            HlPrintAsync(resp);
+        }
+        client->timeoutCnt++;
+    }
+    fprintf(stderr, "no response to message 0x%02x\n", type);
+    return -1;
+}
+
+static int HlCheckStatus(int status)
+{
+    if (status > 0) {
+        printf("error: %s\n", (status < 8) ? g_hlStatus[status] : "?"); /* 8: status number */
+    }
+    return (status == 0) ? 0 : 1;
+}
+
+static int HlHello(HL_Client *client, bool verbose)
+{
+    HL_Msg resp;
+    int status = HlRequest(client, HL_MSG_HELLO, NULL, 0, &resp);
+    if (status != 0 || resp.len < 15) {
+        return HlCheckStatus(status == 0 ? 2 : status);
+    }
+    if (verbose) {
+        printf("version %u, payload max %u, parameters %u, signals max %u, baud %u, tick %u Hz\n",
+               resp.payload[1], HlGetU16(&resp.payload[2]), HlGetU16(&resp.payload[4]), resp.payload[6],
+               HlGetU32(&resp.payload[7]), HlGetU32(&resp.payload[11]));
+    }
+    return 0;
+}
+
+/* Parameter table of the target, needed to encode the values */
+static int HlLoadInfo(HL_Client *client)
+{
+    unsigned int total = 1;
+    client->paramNum = 0;
+    while (client->paramNum < total && client->paramNum < HL_PARAM_MAX) {
+        unsigned char req[2];
+        HL_Msg resp;
+        HlPutU16(req, client->paramNum);
+        int status = HlRequest(client, HL_MSG_PARAM_INFO, req, sizeof(req), &resp);
+        if (status != 0 || resp.len < 3 + 12) {
+            return HlCheckStatus(status == 0 ? 2 : status);
+        }
+        total = HlGetU16(&resp.payload[1]);
+        for (unsigned int pos = 3; pos + 12 <= resp.len && client->paramNum < HL_PARAM_MAX; pos += 12) {
+            HL_Param *param = &client->param[client->paramNum++];
+            HL_Value min = { .u = HlGetU32(&resp.payload[pos + 4]) };
+            HL_Value max = { .u = HlGetU32(&resp.payload[pos + 8]) };
+            param->id = (unsigned short)HlGetU16(&resp.payload[pos]);
+            param->type = resp.payload[pos + 2];
+            param->flags = resp.payload[pos + 3];
+            param->min = min.f;
+            param->max = max.f;
+        }
+    }
+    return 0;
+}
+
+static int HlInfo(HL_Client *client)
+{
+    static const char *typeName[] = { "f32", "u32", "i32", "u16", "u8" };
+    for (unsigned int i = 0; i < client->paramNum; i++) {
+        const HL_Param *param = &client->param[i];
+        printf("0x%04x %-18s %-4s", param->id, HlParamName(param->id), (param->type < 5) ? typeName[param->type] : "?");
+        if (param->flags & 1) {
+            printf(" read only\n");
+        } else {
+            printf(" [%g, %g]\n", param->min, param->max);
+        }
+    }
+    return 0;
+}
+
+static int HlPrintItems(const HL_Client *client, const HL_Msg *resp)
+{
+    int ret = 0;
+    for (unsigned int pos = 1; pos + 7 <= resp->len; pos += 7) {
+        unsigned int id = HlGetU16(&resp->payload[pos]);
+        unsigned int status = resp->payload[pos + 2];
+        const HL_Param *param = HlParamFind(client, id);
+        printf("0x%04x %-18s ", id, HlParamName(id));
+        if (status != 0) {
+            printf("%s", (status < 8) ? g_hlStatus[status] : "?");
+            ret = 1;
+        }
+        if (param != NULL) {
+            printf("%s", (status != 0) ? ", " : "");
+            HlPrintValue(param->type, HlGetU32(&resp->payload[pos + 3]));
+        }
+        printf("\n");
+    }
+    return ret;
+}
+
+static int HlRead(HL_Client *client, int argc, char **argv)
+{
+    unsigned char req[HL_ITEM_MAX * 2];
+    unsigned int num = 0;
+    for (int i = 0; i < argc && num < HL_ITEM_MAX; i++) {
+        int id = HlParamId(argv[i], strlen(argv[i]));
+        if (id < 0) {
+            fprintf(stderr, "unknown parameter %s\n", argv[i]);
+            return 1;
+        }
+        HlPutU16(&req[num++ * 2], (unsigned int)id);
+    }
+    HL_Msg resp;
+    int status = HlRequest(client, HL_MSG_PARAM_READ, req, num * 2, &resp);
+    if (status < 0) {
+        return 1;
+    }
+    return HlPrintItems(client, &resp);
+}
+
+/* Write items "name=value", encoded with the type given by the target */
+static int HlBuildWrite(const HL_Client *client, int argc, char **argv, unsigned char *req, unsigned int *len)
+{
+    unsigned int num = 0;
+    for (int i = 0; i < argc && num < HL_ITEM_MAX; i++) {
+        const char *eq = strchr(argv[i], '=');
+        int id = (eq != NULL) ? HlParamId(argv[i], (unsigned int)(eq - argv[i])) : -1;
+        const HL_Param *param = (id >= 0) ? HlParamFind(client, (unsigned int)id) : NULL;
+        if (param == NULL) {
+            fprintf(stderr, "bad item %s, expected name=value\n", argv[i]);
+            return 1;
+        }
+        HL_Value value;
+        if (param->type == HL_PARAM_F32) {
+            value.f = strtof(eq + 1, NULL);
+        } else {
+            value.u = (unsigned int)strtol(eq + 1, NULL, 0);
+        }
+        HlPutU16(&req[num * 6], (unsigned int)id);
+        HlPutU32(&req[num * 6 + 2], value.u);
+        num++;
+    }
+    *len = num * 6;
+    return 0;
+}
+
+static int HlWrite(HL_Client *client, int argc, char **argv)
+{
+    unsigned char req[HL_ITEM_MAX * 6];
+    unsigned int len;
+    if (HlBuildWrite(client, argc, argv, req, &len) != 0) {
+        return 1;
+    }
+    HL_Msg resp;
+    double start = HlNowMs();
+    int status = HlRequest(client, HL_MSG_PARAM_WRITE, req, len, &resp);
+    if (status < 0) {
+        return 1;
+    }
+    printf("%u items in %.2f ms%s\n", len / 6, HlNowMs() - start, (status != 0) ? ", nothing written" : "");
+    return HlPrintItems(client, &resp);
+}
+
+/* Repeat a batch write n times, the round trip time and the error counters of both ends */
+static int HlBench(HL_Client *client, int argc, char **argv)
+{
+    if (argc < 2) {
+        return 1;
+    }
+    unsigned int num = (unsigned int)atoi(argv[0]);
+    unsigned char req[HL_ITEM_MAX * 6];
+    unsigned int len;
+    if (HlBuildWrite(client, argc - 1, &argv[1], req, &len) != 0) {
+        return 1;
+    }
+    double min = 1e9;
+    double max = 0.0;
+    double sum = 0.0;
+    unsigned int fail = 0;
+    for (unsigned int i = 0; i < num; i++) {
+        HL_Msg resp;
+        double start = HlNowMs();
+        fail += (HlRequest(client, HL_MSG_PARAM_WRITE, req, len, &resp) != 0);
+        double rtt = HlNowMs() - start;
+        min = (rtt < min) ? rtt : min;
+        max = (rtt > max) ? rtt : max;
+        sum += rtt;
+    }
+    printf("%u round trips of %u items, %u failed, %u timeouts\n", num, len / 6, fail, client->timeoutCnt);
+    printf("round trip min %.2f ms, mean %.2f ms, max %.2f ms\n", min, sum / num, max);
+    printf("host: crc errors %u, frame errors %u\n", client->rx.crcErrCnt, client->rx.frameErrCnt);
+    HL_Msg resp;
+    if (HlRequest(client, HL_MSG_STAT, NULL, 0, &resp) == 0 && resp.len >= 29) {
+        printf("target: received %u, crc errors %u, frame errors %u, responses dropped %u\n",
+               HlGetU32(&resp.payload[1]), HlGetU32(&resp.payload[5]), HlGetU32(&resp.payload[9]),
+               HlGetU32(&resp.payload[17]));
+    }
+    return (fail == 0 && client->rx.crcErrCnt == 0 && client->rx.frameErrCnt == 0) ? 0 : 1;
+}
+
+static int HlStat(HL_Client *client)
+{
+    static const char *name[] = {
+        "received", "crc errors", "frame errors", "unknown", "responses dropped", "telemetry sent", "telemetry lost"
+    };
+    HL_Msg resp;
+    int status = HlRequest(client, HL_MSG_STAT, NULL, 0, &resp);
+    if (status != 0) {
+        return HlCheckStatus(status);
+    }
+    for (unsigned int i = 0; i < 7 && 1 + i * 4 + 4 <= resp.len; i++) {
+        printf("%-18s %u\n", name[i], HlGetU32(&resp.payload[1 + i * 4]));
+    }
+    return 0;
+}
+
+static int HlPing(HL_Client *client, unsigned int num)
+{
+    unsigned char req[64];
+    double sum = 0.0;
+    for (unsigned int i = 0; i < sizeof(req); i++) {
+        req[i] = (unsigned char)i;
+    }
+    for (unsigned int i = 0; i < num; i++) {
+        HL_Msg resp;
+        double start = HlNowMs();
+        if (HlRequest(client, HL_MSG_PING, req, sizeof(req), &resp) != 0 || resp.len != 1 + sizeof(req) ||
+            memcmp(&resp.payload[1], req, sizeof(req)) != 0) {
+            printf("ping %u failed\n", i);
+            return 1;
+        }
+        sum += HlNowMs() - start;
+    }
+    printf("%u pings, mean round trip %.2f ms\n", num, sum / num);
+    return 0;
+}
+
+/* Subscribe, print the samples and check their indexes, then unsubscribe */
+static int HlSub(HL_Client *client, int argc, char **argv)
+{
+    if (argc < 3) {
+        return 1;
+    }
+    unsigned char req[4 + HL_SIGNAL_MAX * 2];
+    unsigned int num = 0;
+    unsigned int sampleNum = (unsigned int)atoi(argv[1]);
+    HlPutU32(req, (unsigned int)atoi(argv[0]));
+    for (int i = 2; i < argc && num < HL_SIGNAL_MAX; i++) {
+        int id = HlParamId(argv[i], strlen(argv[i]));
+        if (id < 0) {
+            fprintf(stderr, "unknown parameter %s\n", argv[i]);
+            return 1;
+        }
+        HlPutU16(&req[4 + num++ * 2], (unsigned int)id);
+    }
+    HL_Msg msg;
+    int status = HlRequest(client, HL_MSG_TELEM_SUB, req, 4 + num * 2, &msg);
+    if (status != 0) {
+        return HlCheckStatus(status);
+    }
+    printf("granted period %u us\n", HlGetU32(&msg.payload[1]));
+    unsigned int got = 0;
+    unsigned int gap = 0;
+    unsigned int next = 0;
+    while (got < sampleNum && HlReceive(client, &msg, 1000)) { /* 1000: ms */
+        if (msg.type != HL_MSG_TELEM || msg.len != 8 + num * 4) {
+            continue;
+        }
+        unsigned int idx = HlGetU32(msg.payload);
+        gap += (got > 0 && idx != next) ? idx - next : 0;
+        next = idx + 1;
+        got++;
+        HlPrintAsync(&msg);
+    }
+    HlPutU32(req, 0);
+    HlRequest(client, HL_MSG_TELEM_SUB, req, 4, &msg);
+    printf("%u samples, %u missing, crc errors %u, frame errors %u\n", got, gap, client->rx.crcErrCnt,
+           client->rx.frameErrCnt);
+    return 0;
+}
+
+static int HlCommand(HL_Client *client, int argc, char **argv)
+{
+    const char *cmd = argv[0];
+    unsigned char arg = 0;
+    HL_Msg resp;
+    if (strcmp(cmd, "hello") == 0) {
+        return HlHello(client, true);
+    } else if (strcmp(cmd, "bye") == 0) {
+        arg = (argc > 1 && strcmp(argv[1], "stop") == 0);
+        return HlCheckStatus(HlRequest(client, HL_MSG_BYE, &arg, 1, &resp));
+    } else if (strcmp(cmd, "ping") == 0) {
+        return HlPing(client, (argc > 1) ? (unsigned int)atoi(argv[1]) : 1);
+    } else if (strcmp(cmd, "start") == 0 || strcmp(cmd, "stop") == 0) {
+        arg = (cmd[2] == 'a') ? HL_MOTOR_START : HL_MOTOR_STOP;
+        return HlCheckStatus(HlRequest(client, HL_MSG_MOTOR_CMD, &arg, 1, &resp));
+    } else if (strcmp(cmd, "stat") == 0) {
+        return HlStat(client);
+    } else if (strcmp(cmd, "info") == 0) {
+        return HlInfo(client);
+    } else if (strcmp(cmd, "read") == 0) {
+        return HlRead(client, argc - 1, &argv[1]);
+    } else if (strcmp(cmd, "write") == 0) {
+        return HlWrite(client, argc - 1, &argv[1]);
+    } else if (strcmp(cmd, "bench") == 0) {
+        return HlBench(client, argc - 1, &argv[1]);
+    } else if (strcmp(cmd, "sub") == 0) {
+        return HlSub(client, argc - 1, &argv[1]);
+    }
+    fprintf(stderr, "unknown command %s\n", cmd);
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dev = "/dev/ttyUSB0";
+    unsigned int baud = HL_BAUD_DEFAULT;
+    int opt;
+    HlCrcInit();
+    while ((opt = getopt(argc, argv, "+d:b:")) != -1) {
+        if (opt == 'd') {
+            dev = optarg;
+        } else if (opt == 'b') {
+            baud = (unsigned int)atoi(optarg);
+        } else {
+            return 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "usage: hostlink selftest [frames] | hostlink [-d device] [-b baud] command [arguments]\n");
+        return 1;
+    }
+    if (strcmp(argv[optind], "selftest") == 0) {
+        return HlSelfTest((optind + 1 < argc) ? (unsigned int)atoi(argv[optind + 1]) : 100000); /* 100000: frames */
+    }
+    HL_Client client;
+    memset(&client, 0, sizeof(client));
+    client.fd = HlSerialOpen(dev, baud);
+    if (client.fd < 0) {
+        return 1;
+    }
+    /* Every session starts with HELLO, which also gives the speed to the host, and the parameter table */
+    int ret = HlHello(&client, false);
+    if (ret == 0) {
+        ret = HlLoadInfo(&client);
+    }
+    if (ret == 0) {
+        ret = HlCommand(&client, argc - optind, &argv[optind]);
+    }
+    close(client.fd);
+    return ret;
+}
@@ -0,0 +1,135 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostsim.h
+  * @author    MCU Driver Team
+  * @brief     Host register-level peripheral simulation.
+  * @details   The register window of each simulated peripheral is mapped on the host at its silicon base address,
+  *            so the unmodified drivers access it through their *_RegStruct pointers. Every CPU access traps into the
+  *            simulator, which counts it and lets the behavioural model react before a read and after a write.
+  *            Models see the registers through an untrapped alias of the same memory. Interrupt lines are level
+  *            sensitive and the registered IRQ handlers run from HOSTSIM_Step() in the caller's context.
+  *            Host requirements: Linux on x86_64, link with -no-pie and keep the driver handles and DMA buffers in
+  *            static storage, so that the 32-bit uintptr_t of the drivers still holds their addresses.
+  */
+#ifndef HOSTSIM_H
+#define HOSTSIM_H
+
+#include <stdbool.h>
+
+#define HOSTSIM_IRQ_MAX         128U    /* Must cover IRQ_MAX of the simulated chip */
+#define HOSTSIM_IRQ_LOOP_MAX    32U     /* Handler calls per line and step before the line is reported stuck */
+
+/* Host address, the drivers redefine uintptr_t as 32 bits so <stdint.h> cannot be used next to them */
+typedef unsigned long HOSTSIM_Addr;
+
+typedef struct _HOSTSIM_Periph HOSTSIM_Periph;
+
+/**
+  * @brief Register access seen by a model.
+  */
+typedef struct {
+    unsigned int    offset;     /**< Word aligned offset from the peripheral base. */
+    bool            isWrite;    /**< Write access. */
+    bool            byDma;      /**< Access done by the simulated DMA, not by the CPU. */
+    unsigned int    oldVal;     /**< Register value before a write, for write-1-to-clear registers. */
+} HOSTSIM_Access;
+
+/**
+  * @brief Behavioural model of a peripheral, all callbacks are optional.
+  */
+typedef struct {
+    void (*preAccess)(HOSTSIM_Periph *periph, const HOSTSIM_Access *access);  /**< Before the access executes. */
+    void (*postAccess)(HOSTSIM_Periph *periph, const HOSTSIM_Access *access); /**< After the access executes. */
+    void (*step)(HOSTSIM_Periph *periph, unsigned int cycles);                /**< Virtual time advanced. */
+} HOSTSIM_PeriphOps;
+
+/**
+  * @brief Register access statistics.
+  */
+typedef struct {
+    unsigned long long  readCnt;    /**< CPU register reads. */
+    unsigned long long  writeCnt;   /**< CPU register writes. */
+    unsigned long long  dmaCnt;     /**< Register accesses done by the simulated DMA. */
+} HOSTSIM_AccessStat;
+
+/**
+  * @brief Interrupt statistics, the register accesses are counted over all peripherals while the handler runs.
+  */
+typedef struct {
+    unsigned long long  runCnt;         /**< Handler calls. */
+    unsigned long long  regAccessCnt;   /**< Register accesses inside the handler, the ISR path length. */
+    unsigned long long  maxRegAccess;   /**< Longest handler call in register accesses. */
+    unsigned long long  hostNs;         /**< Host time spent in the handler. */
+    unsigned int        stuckCnt;       /**< Steps where the line stayed asserted after HOSTSIM_IRQ_LOOP_MAX calls. */
+} HOSTSIM_IrqStat;
+
+struct _HOSTSIM_Periph {
+    const char                 *name;       /**< Name used in error reports. */
+    HOSTSIM_Addr                base;       /**< Silicon base address, page aligned. */
+    unsigned int                size;       /**< Register window size, multiple of the page size. */
+    void                       *alias;      /**< Untrapped view of the registers, for the model. */
+    const HOSTSIM_PeriphOps    *ops;        /**< Behavioural model. */
+    void                       *model;      /**< Model private data. */
+    HOSTSIM_AccessStat          stat;       /**< Access statistics. */
+    HOSTSIM_Periph             *next;
+};
+
+typedef void (*HOSTSIM_IrqFunc)(void *arg);
+
+/* Core */
+int HOSTSIM_Init(void);
+HOSTSIM_Periph *HOSTSIM_PeriphAdd(const char *name, void *base, unsigned int size,
+                                  const HOSTSIM_PeriphOps *ops, void *model);
+HOSTSIM_Periph *HOSTSIM_PeriphFind(HOSTSIM_Addr addr);
+unsigned int HOSTSIM_BusRead(HOSTSIM_Addr addr);
+void HOSTSIM_BusWrite(HOSTSIM_Addr addr, unsigned int value);
+void HOSTSIM_IrqConnect(unsigned int irqNum, HOSTSIM_IrqFunc func, void *arg);
+void HOSTSIM_IrqEnable(unsigned int irqNum, bool enable);
+void HOSTSIM_IrqSetLevel(unsigned int irqNum, bool level);
+void HOSTSIM_Step(unsigned int cycles);
+unsigned long long HOSTSIM_GetCycle(void);
+void HOSTSIM_GetAccessStat(const HOSTSIM_Periph *periph, HOSTSIM_AccessStat *stat);
+void HOSTSIM_GetIrqStat(unsigned int irqNum, HOSTSIM_IrqStat *stat);
+void HOSTSIM_ClearStat(void);
+
+/* UART model: TX capture and RX injection at a configurable character time */
+HOSTSIM_Periph *HOSTSIM_UartAdd(void *base, unsigned int irqNum, unsigned int txDmaReq, unsigned int rxDmaReq,
+                                unsigned int cyclesPerChar);
+unsigned int HOSTSIM_UartInject(HOSTSIM_Periph *uart, const unsigned char *data, unsigned int len);
+unsigned int HOSTSIM_UartTake(HOSTSIM_Periph *uart, unsigned char *data, unsigned int len);
+
+/* TIMER model: down counter with period interrupt */
+HOSTSIM_Periph *HOSTSIM_TimerAdd(void *base, unsigned int irqNum);
+
+/* DMA model: linked list transfers, completion on the peripheral request lines */
+HOSTSIM_Periph *HOSTSIM_DmaAdd(void *base, unsigned int tcIrqNum, unsigned int errIrqNum);
+bool HOSTSIM_DmaRequest(unsigned int reqLine, unsigned int maxCnt);
+
+/* ADC model: triggered conversions fed by a sample source */
+#define HOSTSIM_ADC_INT_NUM     4U
+typedef unsigned int (*HOSTSIM_AdcSource)(unsigned int soc, unsigned int channel, unsigned long long cycle);
+HOSTSIM_Periph *HOSTSIM_AdcAdd(void *base, const unsigned int intIrqNum[HOSTSIM_ADC_INT_NUM], unsigned int dmaReq,
+                               unsigned int cyclesPerConv, HOSTSIM_AdcSource source);
+void HOSTSIM_AdcTrigger(HOSTSIM_Periph *adc, unsigned int trigSel);
+
+/* APT model: time-base counter and compare reference buffers with the one-shot global load */
+HOSTSIM_Periph *HOSTSIM_AptAdd(void *base);
+unsigned int HOSTSIM_AptGetCompare(const HOSTSIM_Periph *apt, unsigned int ref);
+unsigned int HOSTSIM_AptGetGlobalLoadCnt(const HOSTSIM_Periph *apt);
+
+#endif /* HOSTSIM_H */
@@ -0,0 +1,37 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      interrupt.h
+  * @author    MCU Driver Team
+  * @brief     Host stand-in of the driver interrupt.h.
+  * @details   Includes the driver interrupt.h, then replaces the RISC-V CSR accesses: the simulated interrupts run
+  *            from HOSTSIM_Step() in the caller's context, so the critical sections of the drivers only need to keep
+  *            their read mstatus, clear MIE and restore MIE sequence. The Makefile puts this directory first.
+  */
+#ifndef HOSTSIM_INTERRUPT_H
+#define HOSTSIM_INTERRUPT_H
+
+#include_next "interrupt.h"
+
+#undef READ_CSR
+#undef SET_CSR
+#undef CLEAR_CSR
+#define READ_CSR(csrReg)            MSTATUS_MIE
+#define SET_CSR(csrReg, csrBit)     ((void)(csrBit))
+#define CLEAR_CSR(csrReg, csrBit)   ((void)(csrBit))
+
+#endif /* HOSTSIM_INTERRUPT_H */
@@ -0,0 +1,385 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostsim.c
+  * @author    MCU Driver Team
+  * @brief     Host register-level peripheral simulation core.
+  * @details   Each register window is a memfd mapped twice: at the silicon base address with no access rights, and
+  *            at an arbitrary address read-write for the model. A CPU access to the first view raises SIGSEGV; the
+  *            handler runs the pre-access hook, opens the page and single-steps the faulting instruction with the
+  *            x86 trap flag. The following SIGTRAP runs the post-access hook and closes the page again.
+  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "hostsim.h"
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#error "hostsim needs the x86 trap flag to single-step register accesses"
+#endif
+
+#define HOSTSIM_PF_WRITE    0x2U    /* Page fault error code: write access */
+#define HOSTSIM_EFL_TF      0x100U  /* EFLAGS trap flag */
+
+typedef struct {
+    HOSTSIM_IrqFunc     func;
+    void               *arg;
+    bool                enable;
+    bool                level;
+    HOSTSIM_IrqStat     stat;
+} HOSTSIM_Irq;
+
+static struct {
+    HOSTSIM_Periph     *periphList;
+    HOSTSIM_Periph     *pendPeriph;     /* Peripheral whose page is open for the single-stepped access */
+    HOSTSIM_Access      pendAccess;
+    unsigned long long  cycle;
+    unsigned long long  accessCnt;      /* All register accesses, for the ISR path length */
+    long                pageSize;
+    HOSTSIM_Irq         irq[HOSTSIM_IRQ_MAX];
+} g_hostSim;
+
+static void HOSTSIM_Fatal(const char *msg, HOSTSIM_Addr addr)
+{
+    fprintf(stderr, "hostsim: %s 0x%lx\n", msg, (unsigned long)addr);
+    abort();
+}
+
+HOSTSIM_Periph *HOSTSIM_PeriphFind(HOSTSIM_Addr addr)
+{
+    for (HOSTSIM_Periph *p = g_hostSim.periphList; p != NULL; p = p->next) {
+        if (addr >= p->base && addr - p->base < p->size) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static unsigned int HOSTSIM_AliasRead(HOSTSIM_Periph *periph, unsigned int offset)
+{
+    return *(volatile unsigned int *)((HOSTSIM_Addr)periph->alias + offset);
+}
+
+static void HOSTSIM_SegvHandler(int sig, siginfo_t *info, void *ctx)
+{
+    (void)sig;
+    ucontext_t *uc = (ucontext_t *)ctx;
+    HOSTSIM_Addr addr = (HOSTSIM_Addr)info->si_addr;
+    HOSTSIM_Periph *periph = HOSTSIM_PeriphFind(addr);
+    if (periph == NULL || g_hostSim.pendPeriph != NULL) {
+        HOSTSIM_Fatal("invalid access at", addr);
+    }
+    HOSTSIM_Access *access = &g_hostSim.pendAccess;
+    access->offset = (unsigned int)(addr - periph->base) & ~3U;
+    access->isWrite = ((unsigned long)uc->uc_mcontext.gregs[REG_ERR] & HOSTSIM_PF_WRITE) != 0;
+    access->byDma = false;
+    access->oldVal = HOSTSIM_AliasRead(periph, access->offset);
+    if (periph->ops != NULL && periph->ops->preAccess != NULL) {
+        periph->ops->preAccess(periph, access);
+    }
+    g_hostSim.pendPeriph = periph;
+    mprotect((void *)periph->base, periph->size, PROT_READ | PROT_WRITE);
+    uc->uc_mcontext.gregs[REG_EFL] |= HOSTSIM_EFL_TF;
+}
+
+static void HOSTSIM_TrapHandler(int sig, siginfo_t *info, void *ctx)
+{
+    (void)sig;
+    (void)info;
+    ucontext_t *uc = (ucontext_t *)ctx;
+    HOSTSIM_Periph *periph = g_hostSim.pendPeriph;
+    if (periph == NULL) {
+        HOSTSIM_Fatal("unexpected trap at", (HOSTSIM_Addr)info->si_addr);
+    }
+    uc->uc_mcontext.gregs[REG_EFL] &= ~(long)HOSTSIM_EFL_TF;
+    mprotect((void *)periph->base, periph->size, PROT_NONE);
+    g_hostSim.pendPeriph = NULL;
+    if (g_hostSim.pendAccess.isWrite) {
+        periph->stat.writeCnt++;
+    } else {
+        periph->stat.readCnt++;
+    }
+    g_hostSim.accessCnt++;
+    if (periph->ops != NULL && periph->ops->postAccess != NULL) {
+        periph->ops->postAccess(periph, &g_hostSim.pendAccess);
+    }
+}
+
+/**
+  * @brief Install the access trap handlers, call once before adding peripherals.
+  * @retval 0: success, -1: failure.
+  */
+int HOSTSIM_Init(void)
+{
+    struct sigaction sa;
+    memset(&g_hostSim, 0, sizeof(g_hostSim));
+    g_hostSim.pageSize = sysconf(_SC_PAGESIZE);
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_sigaction = HOSTSIM_SegvHandler;
+    if (sigaction(SIGSEGV, &sa, NULL) != 0) {
+        return -1;
+    }
+    sa.sa_sigaction = HOSTSIM_TrapHandler;
+    return sigaction(SIGTRAP, &sa, NULL);
+}
+
+/**
+  * @brief Map the register window of a peripheral at its silicon base address.
+  * @param name Name used in error reports.
+  * @param base Silicon base address, from baseaddr.h.
+  * @param size Register window size, rounded up to the page size.
+  * @param ops Behavioural model, may be NULL for plain register memory.
+  * @param model Model private data.
+  * @retval Peripheral, NULL if the address range is not free on the host.
+  */
+HOSTSIM_Periph *HOSTSIM_PeriphAdd(const char *name, void *base, unsigned int size,
+                                  const HOSTSIM_PeriphOps *ops, void *model)
+{
+    HOSTSIM_Addr pageMask = (HOSTSIM_Addr)g_hostSim.pageSize - 1;
+    HOSTSIM_Addr start = (HOSTSIM_Addr)base & ~pageMask;
+    unsigned int len = (unsigned int)(((HOSTSIM_Addr)base + size - start + pageMask) & ~pageMask);
+    if (HOSTSIM_PeriphFind(start) != NULL) {
+        return NULL;
+    }
+    HOSTSIM_Periph *periph = calloc(1, sizeof(HOSTSIM_Periph));
+    int fd = memfd_create(name, 0);
+    if (periph == NULL || fd < 0 || ftruncate(fd, len) != 0) {
+        goto FAIL;
+    }
+    void *trapView = mmap((void *)start, len, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+    if (trapView != (void *)start) {
+        if (trapView != MAP_FAILED) { /* Kernel without MAP_FIXED_NOREPLACE took the address as a hint */
+            munmap(trapView, len);
+        }
+        goto FAIL;
+    }
+    periph->alias = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (periph->alias == MAP_FAILED) {
+        munmap(trapView, len);
+        goto FAIL;
+    }
+    close(fd);
+    periph->name = name;
+    periph->base = start;
+    periph->size = len;
+    periph->ops = ops;
+    periph->model = model;
+    periph->next = g_hostSim.periphList;
+    g_hostSim.periphList = periph;
+    return periph;
+FAIL:
+    if (fd >= 0) {
+        close(fd);
+    }
+    free(periph);
+    return NULL;
+}
+
+/**
+  * @brief Register read by the simulated DMA, the model hooks run as for a CPU access.
+  * @param addr Register or RAM address.
+  * @retval Value read.
+  */
+unsigned int HOSTSIM_BusRead(HOSTSIM_Addr addr)
+{
+    HOSTSIM_Periph *periph = HOSTSIM_PeriphFind(addr);
+    if (periph == NULL) {
+        return *(volatile unsigned int *)addr;
+    }
+    HOSTSIM_Access access = {(unsigned int)(addr - periph->base) & ~3U, false, true, 0};
+    access.oldVal = HOSTSIM_AliasRead(periph, access.offset);
+    if (periph->ops != NULL && periph->ops->preAccess != NULL) {
+        periph->ops->preAccess(periph, &access);
+    }
+    unsigned int value = HOSTSIM_AliasRead(periph, access.offset);
+    periph->stat.dmaCnt++;
+    if (periph->ops != NULL && periph->ops->postAccess != NULL) {
+        periph->ops->postAccess(periph, &access);
+    }
+    return value;
+}
+
+/**
+  * @brief Register write by the simulated DMA, the model hooks run as for a CPU access.
+  * @param addr Register or RAM address.
+  * @param value Value written.
+  * @retval None.
+  */
+void HOSTSIM_BusWrite(HOSTSIM_Addr addr, unsigned int value)
+{
+    HOSTSIM_Periph *periph = HOSTSIM_PeriphFind(addr);
+    if (periph == NULL) {
+        *(volatile unsigned int *)addr = value;
+        return;
+    }
+    HOSTSIM_Access access = {(unsigned int)(addr - periph->base) & ~3U, true, true, 0};
+    access.oldVal = HOSTSIM_AliasRead(periph, access.offset);
+    if (periph->ops != NULL && periph->ops->preAccess != NULL) {
+        periph->ops->preAccess(periph, &access);
+    }
+    *(volatile unsigned int *)((HOSTSIM_Addr)periph->alias + access.offset) = value;
+    periph->stat.dmaCnt++;
+    if (periph->ops != NULL && periph->ops->postAccess != NULL) {
+        periph->ops->postAccess(periph, &access);
+    }
+}
+
+/**
+  * @brief Connect an interrupt handler, typically the HAL_XXX_IrqHandler of the driver and its handle.
+  * @param irqNum Interrupt number of the simulated chip.
+  * @param func Handler.
+  * @param arg Handler argument.
+  * @retval None.
+  */
+void HOSTSIM_IrqConnect(unsigned int irqNum, HOSTSIM_IrqFunc func, void *arg)
+{
+    if (irqNum >= HOSTSIM_IRQ_MAX) {
+        HOSTSIM_Fatal("invalid irq", irqNum);
+    }
+    g_hostSim.irq[irqNum].func = func;
+    g_hostSim.irq[irqNum].arg = arg;
+    g_hostSim.irq[irqNum].enable = true;
+}
+
+/**
+  * @brief Enable or disable the delivery of an interrupt line.
+  * @param irqNum Interrupt number.
+  * @param enable Delivery enabled.
+  * @retval None.
+  */
+void HOSTSIM_IrqEnable(unsigned int irqNum, bool enable)
+{
+    if (irqNum < HOSTSIM_IRQ_MAX) {
+        g_hostSim.irq[irqNum].enable = enable;
+    }
+}
+
+/**
+  * @brief Set the level of an interrupt line, called by the models whenever their masked status changes.
+  * @param irqNum Interrupt number.
+  * @param level Line asserted.
+  * @retval None.
+  */
+void HOSTSIM_IrqSetLevel(unsigned int irqNum, bool level)
+{
+    if (irqNum < HOSTSIM_IRQ_MAX) {
+        g_hostSim.irq[irqNum].level = level;
+    }
+}
+
+static unsigned long long HOSTSIM_HostNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec; /* ns per second */
+}
+
+static void HOSTSIM_IrqDispatch(void)
+{
+    for (unsigned int i = 0; i < HOSTSIM_IRQ_MAX; i++) {
+        HOSTSIM_Irq *irq = &g_hostSim.irq[i];
+        unsigned int loop = 0;
+        while (irq->level && irq->enable && irq->func != NULL) {
+            if (loop++ == HOSTSIM_IRQ_LOOP_MAX) {
+                irq->stat.stuckCnt++;
+                break;
+            }
+            unsigned long long accessCnt = g_hostSim.accessCnt;
+            unsigned long long ns = HOSTSIM_HostNs();
+            irq->func(irq->arg);
+            irq->stat.hostNs += HOSTSIM_HostNs() - ns;
+            accessCnt = g_hostSim.accessCnt - accessCnt;
+            irq->stat.regAccessCnt += accessCnt;
+            irq->stat.maxRegAccess = (accessCnt > irq->stat.maxRegAccess) ? accessCnt : irq->stat.maxRegAccess;
+            irq->stat.runCnt++;
+        }
+    }
+}
+
+/**
+  * @brief Advance virtual time: every model steps, then the asserted interrupt lines are served until they drop.
+  * @param cycles Virtual cycles elapsed.
+  * @retval None.
+  */
+void HOSTSIM_Step(unsigned int cycles)
+{
+    g_hostSim.cycle += cycles;
+    for (HOSTSIM_Periph *p = g_hostSim.periphList; p != NULL; p = p->next) {
+        if (p->ops != NULL && p->ops->step != NULL) {
+            p->ops->step(p, cycles);
+        }
+    }
+    HOSTSIM_IrqDispatch();
+}
+
+/**
+  * @brief Get the virtual time.
+  * @retval Virtual cycles since HOSTSIM_Init().
+  */
+unsigned long long HOSTSIM_GetCycle(void)
+{
+    return g_hostSim.cycle;
+}
+
+/**
+  * @brief Get the register access statistics of a peripheral.
+  * @param periph Peripheral.
+  * @param stat Statistics.
+  * @retval None.
+  */
+void HOSTSIM_GetAccessStat(const HOSTSIM_Periph *periph, HOSTSIM_AccessStat *stat)
+{
+    *stat = periph->stat;
+}
+
+/**
+  * @brief Get the statistics of an interrupt line.
+  * @param irqNum Interrupt number.
+  * @param stat Statistics.
+  * @retval None.
+  */
+void HOSTSIM_GetIrqStat(unsigned int irqNum, HOSTSIM_IrqStat *stat)
+{
+    if (irqNum < HOSTSIM_IRQ_MAX) {
+        *stat = g_hostSim.irq[irqNum].stat;
+    }
+}
+
+/**
+  * @brief Clear the access and interrupt statistics, for example between benchmark phases.
+  * @retval None.
+  */
+void HOSTSIM_ClearStat(void)
+{
+    for (HOSTSIM_Periph *p = g_hostSim.periphList; p != NULL; p = p->next) {
+        memset(&p->stat, 0, sizeof(p->stat));
+    }
+    for (unsigned int i = 0; i < HOSTSIM_IRQ_MAX; i++) {
+        memset(&g_hostSim.irq[i].stat, 0, sizeof(HOSTSIM_IrqStat));
+    }
+    g_hostSim.accessCnt = 0;
+}
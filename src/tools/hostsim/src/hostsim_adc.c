@@ -0,0 +1,179 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostsim_adc.c
+  * @author    MCU Driver Team
+  * @brief     ADC behavioural model: SOCs started by software or by HOSTSIM_AdcTrigger() are converted one after
+  *            another, cyclesPerConv each, in SOC order. The result comes from the sample source; the PPBs, the
+  *            oversampling and the priority arbitration are not modelled.
+  */
+#include <stddef.h>
+#include <stdlib.h>
+#include "adc_ip.h"
+#include "hostsim.h"
+
+#define ADC_SIM_SOC_CFG_OFFSET  0x100U  /* Offset of ADC_SOC0_CFG */
+#define ADC_SIM_RESULT_MASK     0xFFFU  /* 12-bit result */
+
+typedef struct {
+    unsigned int        intIrqNum[HOSTSIM_ADC_INT_NUM];
+    unsigned int        dmaReq;
+    unsigned int        cyclesPerConv;
+    HOSTSIM_AdcSource   source;
+    unsigned int        pending;    /* SOCs waiting for conversion */
+    unsigned int        convCycle;  /* Cycles spent on the current conversion */
+} ADC_SimModel;
+
+static void ADC_SimUpdate(HOSTSIM_Periph *periph)
+{
+    ADC_SimModel *m = (ADC_SimModel *)periph->model;
+    ADC_RegStruct *regs = (ADC_RegStruct *)periph->alias;
+    regs->ADC_INT_DATA_MSK.reg = regs->ADC_INT_DATA_FLAG.reg & regs->ADC_DATA_FLAG_MASK.reg;
+    for (unsigned int i = 0; i < HOSTSIM_ADC_INT_NUM; i++) {
+        HOSTSIM_IrqSetLevel(m->intIrqNum[i], (regs->ADC_INT_DATA_MSK.reg & (1U << i)) != 0);
+    }
+}
+
+static void ADC_SimPostAccess(HOSTSIM_Periph *periph, const HOSTSIM_Access *access)
+{
+    ADC_SimModel *m = (ADC_SimModel *)periph->model;
+    ADC_RegStruct *regs = (ADC_RegStruct *)periph->alias;
+    if (!access->isWrite) {
+        return;
+    }
+    switch (access->offset) {
+        case offsetof(ADC_RegStruct, ADC_SOFT_TRIG):
+            m->pending |= regs->ADC_SOFT_TRIG.reg & ((1U << SOC_MAX_NUM) - 1);
+            regs->ADC_SOFT_TRIG.reg = 0; /* Self-clearing */
+            break;
+        case offsetof(ADC_RegStruct, ADC_EOC_FLAG):
+            regs->ADC_EOC_FLAG.reg = access->oldVal & ~regs->ADC_EOC_FLAG.reg; /* Write 1 to clear */
+            break;
+        case offsetof(ADC_RegStruct, ADC_INT_DATA_FLAG):
+            regs->ADC_INT_DATA_FLAG.reg = access->oldVal & ~regs->ADC_INT_DATA_FLAG.reg; /* Write 1 to clear */
+            break;
+        default:
+            if (access->offset < ADC_SIM_SOC_CFG_OFFSET) { /* Result registers are read-only */
+                *(volatile unsigned int *)((HOSTSIM_Addr)periph->alias + access->offset) = access->oldVal;
+            }
+            break;
+    }
+    ADC_SimUpdate(periph);
+}
+
+/**
+  * @brief One conversion finished: store the result, set the flags and request the DMA.
+  */
+static void ADC_SimConvDone(HOSTSIM_Periph *periph, unsigned int soc)
+{
+    ADC_SimModel *m = (ADC_SimModel *)periph->model;
+    ADC_RegStruct *regs = (ADC_RegStruct *)periph->alias;
+    HOSTSIM_Addr addr = (HOSTSIM_Addr)periph->alias;
+    ADC_SOC0_CFG_REG *cfg = (ADC_SOC0_CFG_REG *)(addr + ADC_SIM_SOC_CFG_OFFSET + soc * sizeof(unsigned int));
+    volatile unsigned int *result = (volatile unsigned int *)(addr + soc * sizeof(unsigned int));
+    unsigned int value = (m->source != NULL) ? m->source(soc, cfg->BIT.cfg_soc0_ch_sel, HOSTSIM_GetCycle()) : 0;
+
+    *result = value & ADC_SIM_RESULT_MASK;
+    regs->ADC_EOC_FLAG.reg |= (1U << soc);
+    /* Data interrupt x is raised by the SOCs selected in cfg_intr_data_selx */
+    unsigned int sel[HOSTSIM_ADC_INT_NUM] = {
+        regs->ADC_INT_DATA_0.BIT.cfg_intr_data_sel0, regs->ADC_INT_DATA_0.BIT.cfg_intr_data_sel1,
+        regs->ADC_INT_DATA_1.BIT.cfg_intr_data_sel2, regs->ADC_INT_DATA_1.BIT.cfg_intr_data_sel3,
+    };
+    for (unsigned int i = 0; i < HOSTSIM_ADC_INT_NUM; i++) {
+        if ((sel[i] & (1U << soc)) != 0) {
+            regs->ADC_INT_DATA_FLAG.reg |= (1U << i);
+        }
+    }
+    if (regs->ADC_DMA.BIT.cfg_dma_soc_sel == soc &&
+        (regs->ADC_DMA.BIT.cfg_dma_sing_req_sel || regs->ADC_DMA.BIT.cfg_dma_brst_req_sel)) {
+        HOSTSIM_DmaRequest(m->dmaReq, SOC_MAX_NUM);
+    }
+    if (cfg->BIT.cfg_soc0_cont_en) {
+        m->pending |= (1U << soc);
+    }
+}
+
+static void ADC_SimStep(HOSTSIM_Periph *periph, unsigned int cycles)
+{
+    ADC_SimModel *m = (ADC_SimModel *)periph->model;
+    ADC_RegStruct *regs = (ADC_RegStruct *)periph->alias;
+    if (!regs->ADC_EN.BIT.cfg_adc_en) {
+        return;
+    }
+    m->convCycle = (m->pending != 0) ? (m->convCycle + cycles) : 0;
+    while (m->pending != 0 && m->convCycle >= m->cyclesPerConv) {
+        unsigned int soc = (unsigned int)__builtin_ctz(m->pending);
+        m->pending &= ~(1U << soc);
+        m->convCycle -= m->cyclesPerConv;
+        ADC_SimConvDone(periph, soc);
+    }
+    ADC_SimUpdate(periph);
+}
+
+static const HOSTSIM_PeriphOps g_adcSimOps = {
+    .preAccess = NULL,
+    .postAccess = ADC_SimPostAccess,
+    .step = ADC_SimStep,
+};
+
+/**
+  * @brief Add an ADC model.
+  * @param base ADC base address, for example ADC0_BASE.
+  * @param intIrqNum Interrupt numbers of data interrupt 0 ~ 3.
+  * @param dmaReq DMA request line, for example DMA_REQUEST_ADC0.
+  * @param cyclesPerConv Virtual cycles per conversion.
+  * @param source Sample source, returns the raw 12-bit code of a channel at a virtual time.
+  * @retval ADC peripheral, NULL on failure.
+  */
+HOSTSIM_Periph *HOSTSIM_AdcAdd(void *base, const unsigned int intIrqNum[HOSTSIM_ADC_INT_NUM], unsigned int dmaReq,
+                               unsigned int cyclesPerConv, HOSTSIM_AdcSource source)
+{
+    ADC_SimModel *m = calloc(1, sizeof(ADC_SimModel));
+    if (m == NULL) {
+        return NULL;
+    }
+    for (unsigned int i = 0; i < HOSTSIM_ADC_INT_NUM; i++) {
+        m->intIrqNum[i] = intIrqNum[i];
+    }
+    m->dmaReq = dmaReq;
+    m->cyclesPerConv = (cyclesPerConv == 0) ? 1 : cyclesPerConv;
+    m->source = source;
+    HOSTSIM_Periph *periph = HOSTSIM_PeriphAdd("adc", base, sizeof(ADC_RegStruct), &g_adcSimOps, m);
+    if (periph == NULL) {
+        free(m);
+    }
+    return periph;
+}
+
+/**
+  * @brief Hardware trigger, for example an APT SOCA event: start every SOC whose trigger source is trigSel.
+  * @param adc ADC peripheral.
+  * @param trigSel Trigger source, ADC_TRIGSOC_XXX.
+  * @retval None.
+  */
+void HOSTSIM_AdcTrigger(HOSTSIM_Periph *adc, unsigned int trigSel)
+{
+    ADC_SimModel *m = (ADC_SimModel *)adc->model;
+    HOSTSIM_Addr addr = (HOSTSIM_Addr)adc->alias + ADC_SIM_SOC_CFG_OFFSET;
+    for (unsigned int soc = 0; soc < SOC_MAX_NUM; soc++) {
+        ADC_SOC0_CFG_REG *cfg = (ADC_SOC0_CFG_REG *)(addr + soc * sizeof(unsigned int));
+        if (cfg->BIT.cfg_soc0_trig_sel == trigSel) {
+            m->pending |= (1U << soc);
+        }
+    }
+}
@@ -0,0 +1,205 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostsim_apt.c
+  * @author    MCU Driver Team
+  * @brief     APT behavioural model: time-base counter with the zero and period events, and the compare reference
+  *            buffers of TC_REFA ~ TC_REFD loaded directly, independently or by the one-shot or continuous global
+  *            load. The action qualifier, dead band, protection and SYSCTRL1 APT_RUN are not simulated, the counter
+  *            runs as soon as a period is set.
+  */
+#include <stddef.h>
+#include <stdlib.h>
+#include "apt_ip.h"
+#include "hostsim.h"
+
+#define APT_SIM_REF_NUM         4U      /* TC_REFA ~ TC_REFD */
+#define APT_SIM_REF_STRIDE      4U      /* Address step between the TC_REFx registers */
+#define APT_SIM_BUF_MODE_SHIFT  4U      /* Buffer mode of TC_REFA in TC_BUF_EN */
+#define APT_SIM_BUF_MODE_WIDTH  2U
+#define APT_SIM_LOAD_EVT_WIDTH  8U      /* Load event field of one reference in TC_REF_LOAD */
+#define APT_SIM_LOAD_ZERO       0x1U
+#define APT_SIM_LOAD_PERIOD     0x2U
+#define APT_SIM_CMP_MASK        0xFFFFU
+
+typedef struct {
+    unsigned int    active[APT_SIM_REF_NUM];    /* Compare values used by the counter */
+    unsigned int    pending;                    /* References whose buffer is not loaded yet, one bit each */
+    unsigned int    divCnt;
+    bool            countDown;
+    unsigned int    glbLoadCnt;
+} APT_SimModel;
+
+static APT_BufferLoadMode APT_SimRefMode(const APT_RegStruct *regs, unsigned int ref)
+{
+    unsigned int shift = APT_SIM_BUF_MODE_SHIFT + ref * APT_SIM_BUF_MODE_WIDTH;
+    return (APT_BufferLoadMode)((regs->TC_BUF_EN.reg >> shift) & ((1U << APT_SIM_BUF_MODE_WIDTH) - 1));
+}
+
+static unsigned int APT_SimRefRead(const APT_RegStruct *regs, unsigned int ref)
+{
+    const volatile unsigned int *refReg = &regs->TC_REFA.reg;
+    return refReg[ref] & APT_SIM_CMP_MASK;
+}
+
+static void APT_SimGlobalLoad(HOSTSIM_Periph *periph)
+{
+    APT_SimModel *m = (APT_SimModel *)periph->model;
+    APT_RegStruct *regs = (APT_RegStruct *)periph->alias;
+    for (unsigned int ref = 0; ref < APT_SIM_REF_NUM; ref++) {
+        if (APT_SimRefMode(regs, ref) == APT_BUFFER_GLOBAL_LOAD && (m->pending & (1U << ref)) != 0) {
+            m->active[ref] = APT_SimRefRead(regs, ref);
+            m->pending &= ~(1U << ref);
+        }
+    }
+    regs->GLB_LOAD.BIT.rg_latset_otgld = BASE_CFG_UNSET;
+    m->glbLoadCnt++;
+}
+
+static void APT_SimEvent(HOSTSIM_Periph *periph, unsigned int evt)
+{
+    APT_SimModel *m = (APT_SimModel *)periph->model;
+    APT_RegStruct *regs = (APT_RegStruct *)periph->alias;
+    for (unsigned int ref = 0; ref < APT_SIM_REF_NUM; ref++) {
+        unsigned int loadEvt = regs->TC_REF_LOAD.reg >> (ref * APT_SIM_LOAD_EVT_WIDTH);
+        if (APT_SimRefMode(regs, ref) == APT_BUFFER_INDEPENDENT_LOAD && (m->pending & (1U << ref)) != 0 &&
+            (loadEvt & evt) != 0) {
+            m->active[ref] = APT_SimRefRead(regs, ref);
+            m->pending &= ~(1U << ref);
+        }
+    }
+    unsigned int glbEvt = (regs->GLB_LOAD.BIT.rg_gld_zroen ? APT_SIM_LOAD_ZERO : 0) |
+                          (regs->GLB_LOAD.BIT.rg_gld_prden ? APT_SIM_LOAD_PERIOD : 0);
+    /* One-shot mode: only the first event after the latch strobe passes */
+    if ((glbEvt & evt) != 0 &&
+        (regs->GLB_LOAD.BIT.rg_mode_gld != APT_GLB_LOAD_ONE_SHOT_MODE || regs->GLB_LOAD.BIT.rg_latset_otgld)) {
+        APT_SimGlobalLoad(periph);
+    }
+}
+
+static void APT_SimPostAccess(HOSTSIM_Periph *periph, const HOSTSIM_Access *access)
+{
+    APT_SimModel *m = (APT_SimModel *)periph->model;
+    APT_RegStruct *regs = (APT_RegStruct *)periph->alias;
+    if (!access->isWrite) {
+        return;
+    }
+    if (access->offset >= offsetof(APT_RegStruct, TC_REFA) && access->offset <= offsetof(APT_RegStruct, TC_REFD)) {
+        unsigned int ref = (access->offset - offsetof(APT_RegStruct, TC_REFA)) / APT_SIM_REF_STRIDE;
+        if (APT_SimRefMode(regs, ref) == APT_BUFFER_DISABLE) {
+            m->active[ref] = APT_SimRefRead(regs, ref);
+        } else {
+            m->pending |= 1U << ref;
+        }
+        return;
+    }
+    switch (access->offset) {
+        case offsetof(APT_RegStruct, SYN_FRC):
+            if (regs->SYN_FRC.BIT.rg_gld_frc) {
+                APT_SimGlobalLoad(periph);
+            }
+            regs->SYN_FRC.reg = 0; /* Self-clearing */
+            break;
+        case offsetof(APT_RegStruct, TC_STS):
+        case offsetof(APT_RegStruct, LOAD_STS):
+            /* Read-only, discard the write */
+            *(volatile unsigned int *)((HOSTSIM_Addr)periph->alias + access->offset) = access->oldVal;
+            break;
+        default:
+            break;
+    }
+}
+
+static void APT_SimStep(HOSTSIM_Periph *periph, unsigned int cycles)
+{
+    APT_SimModel *m = (APT_SimModel *)periph->model;
+    APT_RegStruct *regs = (APT_RegStruct *)periph->alias;
+    unsigned int prd = regs->TC_PRD.BIT.rg_cnt_prd;
+    unsigned int mode = regs->TC_MODE.BIT.rg_cnt_mode;
+    if (prd == 0 || mode == APT_COUNT_MODE_FREEZE) {
+        return;
+    }
+    unsigned int div = regs->TC_MODE.BIT.rg_div_fac + 1;
+    unsigned int ticks = (m->divCnt + cycles) / div;
+    m->divCnt = (m->divCnt + cycles) % div;
+    unsigned int cnt = regs->TC_STS.BIT.ro_cnt_val;
+    while (ticks-- != 0) {
+        if (mode == APT_COUNT_MODE_UP) {
+            cnt = (cnt >= prd) ? 0 : cnt + 1;
+        } else if (mode == APT_COUNT_MODE_DOWN) {
+            cnt = (cnt == 0 || cnt > prd) ? prd : cnt - 1;
+        } else {
+            m->countDown = (cnt >= prd) ? true : ((cnt == 0) ? false : m->countDown);
+            cnt = m->countDown ? cnt - 1 : cnt + 1;
+        }
+        if (cnt == 0) {
+            APT_SimEvent(periph, APT_SIM_LOAD_ZERO);
+        }
+        if (cnt == prd) {
+            APT_SimEvent(periph, APT_SIM_LOAD_PERIOD);
+        }
+    }
+    regs->TC_STS.BIT.ro_cnt_val = cnt;
+    regs->TC_STS.BIT.ro_cnt_dir = m->countDown ? 1 : 0;
+}
+
+static const HOSTSIM_PeriphOps g_aptSimOps = {
+    .preAccess = NULL,
+    .postAccess = APT_SimPostAccess,
+    .step = APT_SimStep,
+};
+
+/**
+  * @brief Add an APT model.
+  * @param base APT base address, for example APT0_BASE.
+  * @retval APT peripheral, NULL on failure.
+  */
+HOSTSIM_Periph *HOSTSIM_AptAdd(void *base)
+{
+    APT_SimModel *m = calloc(1, sizeof(APT_SimModel));
+    if (m == NULL) {
+        return NULL;
+    }
+    HOSTSIM_Periph *periph = HOSTSIM_PeriphAdd("apt", base, sizeof(APT_RegStruct), &g_aptSimOps, m);
+    if (periph == NULL) {
+        free(m);
+    }
+    return periph;
+}
+
+/**
+  * @brief Get the compare value used by the counter, that is the last loaded buffer value.
+  * @param apt APT peripheral.
+  * @param ref Compare reference, 0 ~ 3 for TC_REFA ~ TC_REFD.
+  * @retval Active compare value.
+  */
+unsigned int HOSTSIM_AptGetCompare(const HOSTSIM_Periph *apt, unsigned int ref)
+{
+    const APT_SimModel *m = (const APT_SimModel *)apt->model;
+    return (ref < APT_SIM_REF_NUM) ? m->active[ref] : 0;
+}
+
+/**
+  * @brief Get the number of global buffer loads, forced ones included.
+  * @param apt APT peripheral.
+  * @retval Global load count.
+  */
+unsigned int HOSTSIM_AptGetGlobalLoadCnt(const HOSTSIM_Periph *apt)
+{
+    const APT_SimModel *m = (const APT_SimModel *)apt->model;
+    return m->glbLoadCnt;
+}
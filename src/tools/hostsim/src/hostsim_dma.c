@@ -0,0 +1,256 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostsim_dma.c
+  * @author    MCU Driver Team
+  * @brief     DMA behavioural model: linked list transfers of the six channels. Memory to memory transfers run on
+  *            the next step, peripheral transfers move one burst per HOSTSIM_DmaRequest() of their request line.
+  *            Addresses are 32 bits as on silicon, so buffers must be below 4 GiB
+  *            (static data of a -no-pie host build).
+  */
+#include <stddef.h>
+#include <stdlib.h>
+#include "dma_ip.h"
+#include "hostsim.h"
+
+#define DMA_SIM_CH_OFFSET       0x100U  /* Register offset of channel 0 */
+#define DMA_SIM_CH_STRIDE       0x20U   /* Register stride between channels */
+#define DMA_SIM_M2M_NODE_MAX    64U     /* Nodes per step for memory to memory lists, bounds circular lists */
+
+typedef struct {
+    unsigned int    tcIrqNum;
+    unsigned int    errIrqNum;
+    unsigned int    xferCnt[CHANNEL_MAX_NUM];   /* Elements moved, for throughput measurements */
+} DMA_SimModel;
+
+static HOSTSIM_Periph *g_dmaSim = NULL;
+
+static DMA_ChannelRegStruct *DMA_SimChannel(HOSTSIM_Periph *periph, unsigned int ch)
+{
+    return (DMA_ChannelRegStruct *)((HOSTSIM_Addr)periph->alias + DMA_SIM_CH_OFFSET + ch * DMA_SIM_CH_STRIDE);
+}
+
+static void DMA_SimUpdate(HOSTSIM_Periph *periph)
+{
+    DMA_SimModel *m = (DMA_SimModel *)periph->model;
+    DMA_RegStruct *regs = (DMA_RegStruct *)periph->alias;
+    unsigned int tcMask = 0;
+    unsigned int errMask = 0;
+    unsigned int enMask = 0;
+    for (unsigned int ch = 0; ch < CHANNEL_MAX_NUM; ch++) {
+        DMA_Cn_CONFIG_REG config = DMA_SimChannel(periph, ch)->DMA_Cn_CONFIG;
+        tcMask |= (config.BIT.tc_int_msk << ch);
+        errMask |= (config.BIT.err_int_msk << ch);
+        enMask |= (config.BIT.ch_en << ch);
+    }
+    regs->DMA_INT_TC_STAT.reg = regs->DMA_RAW_INT_TC_STAT.reg & tcMask;
+    regs->DMA_INT_ERR_STAT.reg = regs->DMA_RAW_INT_ERR_STAT.reg & errMask;
+    regs->DMA_INT_STAT.reg = regs->DMA_INT_TC_STAT.reg | regs->DMA_INT_ERR_STAT.reg;
+    regs->DMA_ENABLED_CHNS.reg = enMask;
+    HOSTSIM_IrqSetLevel(m->tcIrqNum, regs->DMA_INT_TC_STAT.reg != 0);
+    HOSTSIM_IrqSetLevel(m->errIrqNum, regs->DMA_INT_ERR_STAT.reg != 0);
+}
+
+static unsigned int DMA_SimRead(HOSTSIM_Addr addr, unsigned int width)
+{
+    if (HOSTSIM_PeriphFind(addr) != NULL) {
+        return HOSTSIM_BusRead(addr);
+    }
+    switch (width) {
+        case DMA_TRANSWIDTH_BYTE:
+            return *(volatile unsigned char *)addr;
+        case DMA_TRANSWIDTH_HALFWORD:
+            return *(volatile unsigned short *)addr;
+        default:
+            return *(volatile unsigned int *)addr;
+    }
+}
+
+static void DMA_SimWrite(HOSTSIM_Addr addr, unsigned int width, unsigned int value)
+{
+    if (HOSTSIM_PeriphFind(addr) != NULL) {
+        HOSTSIM_BusWrite(addr, value);
+        return;
+    }
+    switch (width) {
+        case DMA_TRANSWIDTH_BYTE:
+            *(volatile unsigned char *)addr = (unsigned char)value;
+            break;
+        case DMA_TRANSWIDTH_HALFWORD:
+            *(volatile unsigned short *)addr = (unsigned short)value;
+            break;
+        default:
+            *(volatile unsigned int *)addr = value;
+            break;
+    }
+}
+
+/**
+  * @brief Current node finished: flag the completion, then load the next node or stop the channel.
+  */
+static void DMA_SimNodeDone(HOSTSIM_Periph *periph, unsigned int ch)
+{
+    DMA_RegStruct *regs = (DMA_RegStruct *)periph->alias;
+    DMA_ChannelRegStruct *chn = DMA_SimChannel(periph, ch);
+    if (chn->DMA_Cn_CONTROL.BIT.int_tc_enable) {
+        regs->DMA_RAW_INT_TC_STAT.reg |= (1U << ch);
+    }
+    HOSTSIM_Addr lli = chn->DMA_Cn_LLI.reg & ~3U;
+    if (lli == 0) {
+        chn->DMA_Cn_CONFIG.BIT.ch_en = 0;
+        return;
+    }
+    const DMA_LinkList *node = (const DMA_LinkList *)lli;
+    chn->DMA_Cn_SRC_ADDR.reg = node->srcAddr;
+    chn->DMA_Cn_DEST_ADDR.reg = node->destAddr;
+    chn->DMA_Cn_LLI.reg = (unsigned int)(HOSTSIM_Addr)node->lliNext;
+    chn->DMA_Cn_CONTROL.reg = node->control.reg;
+}
+
+/**
+  * @brief Move up to count elements of a channel, the addresses advance as configured.
+  * @retval Number of elements moved.
+  */
+static unsigned int DMA_SimMove(HOSTSIM_Periph *periph, unsigned int ch, unsigned int count)
+{
+    DMA_SimModel *m = (DMA_SimModel *)periph->model;
+    DMA_ChannelRegStruct *chn = DMA_SimChannel(periph, ch);
+    unsigned int moved = 0;
+    while (moved < count && chn->DMA_Cn_CONFIG.BIT.ch_en) {
+        DMA_Cn_CONTROL_REG ctrl = chn->DMA_Cn_CONTROL;
+        if (ctrl.BIT.trans_size == 0) {
+            DMA_SimNodeDone(periph, ch);
+            continue;
+        }
+        unsigned int value = DMA_SimRead(chn->DMA_Cn_SRC_ADDR.reg, ctrl.BIT.swidth);
+        DMA_SimWrite(chn->DMA_Cn_DEST_ADDR.reg, ctrl.BIT.dwidth, value);
+        chn->DMA_Cn_SRC_ADDR.reg += ctrl.BIT.src_incr ? (1U << ctrl.BIT.swidth) : 0;
+        chn->DMA_Cn_DEST_ADDR.reg += ctrl.BIT.dest_incr ? (1U << ctrl.BIT.dwidth) : 0;
+        chn->DMA_Cn_CONTROL.BIT.trans_size = ctrl.BIT.trans_size - 1;
+        moved++;
+        m->xferCnt[ch]++;
+        if (chn->DMA_Cn_CONTROL.BIT.trans_size == 0) {
+            DMA_SimNodeDone(periph, ch);
+        }
+    }
+    return moved;
+}
+
+static void DMA_SimPostAccess(HOSTSIM_Periph *periph, const HOSTSIM_Access *access)
+{
+    DMA_RegStruct *regs = (DMA_RegStruct *)periph->alias;
+    if (!access->isWrite) {
+        return;
+    }
+    if (access->offset == offsetof(DMA_RegStruct, DMA_INT_TC_CLR)) {
+        regs->DMA_RAW_INT_TC_STAT.reg &= ~regs->DMA_INT_TC_CLR.reg;
+        regs->DMA_INT_TC_CLR.reg = 0;
+    } else if (access->offset == offsetof(DMA_RegStruct, DMA_INT_ERR_CLR)) {
+        regs->DMA_RAW_INT_ERR_STAT.reg &= ~regs->DMA_INT_ERR_CLR.reg;
+        regs->DMA_INT_ERR_CLR.reg = 0;
+    } else if (access->offset < offsetof(DMA_RegStruct, DMA_CONFIG)) {
+        /* Status registers are read-only */
+        *(volatile unsigned int *)((HOSTSIM_Addr)periph->alias + access->offset) = access->oldVal;
+    }
+    DMA_SimUpdate(periph);
+}
+
+static unsigned int DMA_SimBurst(unsigned int bsize)
+{
+    return (bsize == 0) ? 1 : (2U << bsize); /* Burst encoding: 1, 4, 8, 16 ... 256 */
+}
+
+static void DMA_SimStep(HOSTSIM_Periph *periph, unsigned int cycles)
+{
+    (void)cycles;
+    DMA_RegStruct *regs = (DMA_RegStruct *)periph->alias;
+    if (!regs->DMA_CONFIG.BIT.dma_enable) {
+        return;
+    }
+    for (unsigned int ch = 0; ch < CHANNEL_MAX_NUM; ch++) {
+        DMA_ChannelRegStruct *chn = DMA_SimChannel(periph, ch);
+        if (!chn->DMA_Cn_CONFIG.BIT.ch_en || chn->DMA_Cn_CONFIG.BIT.flow_ctrl != DMA_MEMORY_TO_MEMORY_BY_DMAC) {
+            continue;
+        }
+        for (unsigned int node = 0; node < DMA_SIM_M2M_NODE_MAX && chn->DMA_Cn_CONFIG.BIT.ch_en; node++) {
+            DMA_SimMove(periph, ch, chn->DMA_Cn_CONTROL.BIT.trans_size);
+        }
+    }
+    DMA_SimUpdate(periph);
+}
+
+static const HOSTSIM_PeriphOps g_dmaSimOps = {
+    .preAccess = NULL,
+    .postAccess = DMA_SimPostAccess,
+    .step = DMA_SimStep,
+};
+
+/**
+  * @brief Add the DMA model, there is one DMA controller per chip.
+  * @param base DMA base address, DMA_BASE.
+  * @param tcIrqNum Transfer completion interrupt number.
+  * @param errIrqNum Error interrupt number.
+  * @retval DMA peripheral, NULL on failure.
+  */
+HOSTSIM_Periph *HOSTSIM_DmaAdd(void *base, unsigned int tcIrqNum, unsigned int errIrqNum)
+{
+    DMA_SimModel *m = calloc(1, sizeof(DMA_SimModel));
+    if (m == NULL || g_dmaSim != NULL) {
+        free(m);
+        return NULL;
+    }
+    m->tcIrqNum = tcIrqNum;
+    m->errIrqNum = errIrqNum;
+    g_dmaSim = HOSTSIM_PeriphAdd("dma", base, sizeof(DMA_RegStruct), &g_dmaSimOps, m);
+    if (g_dmaSim == NULL) {
+        free(m);
+    }
+    return g_dmaSim;
+}
+
+/**
+  * @brief Peripheral request: every enabled channel serving the request line moves one burst.
+  * @param reqLine DMA request line, DMA_REQUEST_XXX.
+  * @param maxCnt Elements the peripheral can take or provide, the burst is cut to this length.
+  * @retval true if at least one element was moved.
+  */
+bool HOSTSIM_DmaRequest(unsigned int reqLine, unsigned int maxCnt)
+{
+    if (g_dmaSim == NULL || !((DMA_RegStruct *)g_dmaSim->alias)->DMA_CONFIG.BIT.dma_enable) {
+        return false;
+    }
+    unsigned int moved = 0;
+    unsigned int burst;
+    for (unsigned int ch = 0; ch < CHANNEL_MAX_NUM; ch++) {
+        DMA_ChannelRegStruct *chn = DMA_SimChannel(g_dmaSim, ch);
+        DMA_Cn_CONFIG_REG config = chn->DMA_Cn_CONFIG;
+        if (!config.BIT.ch_en || config.BIT.flow_ctrl == DMA_MEMORY_TO_MEMORY_BY_DMAC) {
+            continue;
+        }
+        if (config.BIT.src_periph == reqLine && config.BIT.flow_ctrl != DMA_MEMORY_TO_PERIPH_BY_DMAC &&
+            config.BIT.flow_ctrl != DMA_MEMORY_TO_PERIPH_BY_DES) {
+            burst = DMA_SimBurst(chn->DMA_Cn_CONTROL.BIT.sbsize);
+            moved += DMA_SimMove(g_dmaSim, ch, (burst < maxCnt) ? burst : maxCnt);
+        } else if (config.BIT.dest_periph == reqLine && config.BIT.flow_ctrl != DMA_PERIPH_TO_MEMORY_BY_DMAC &&
+                   config.BIT.flow_ctrl != DMA_PERIPH_TO_MEMORY_BY_SRC) {
+            burst = DMA_SimBurst(chn->DMA_Cn_CONTROL.BIT.dbsize);
+            moved += DMA_SimMove(g_dmaSim, ch, (burst < maxCnt) ? burst : maxCnt);
+        }
+    }
+    DMA_SimUpdate(g_dmaSim);
+    return moved != 0;
+}
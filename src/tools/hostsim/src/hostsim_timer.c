@@ -0,0 +1,131 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostsim_timer.c
+  * @author    MCU Driver Team
+  * @brief     TIMER behavioural model: down counter clocked by the virtual cycles through the prescaler, with the
+  *            periodic reload from timerbgload and the period interrupt.
+  */
+#include <stddef.h>
+#include <stdlib.h>
+#include "timer_ip.h"
+#include "hostsim.h"
+
+#define TIMER_SIM_PRE_SHIFT     4U  /* Each prescaler step divides by 16 */
+
+typedef struct {
+    unsigned int    irqNum;
+    unsigned int    remain;     /* Input cycles not yet counted because of the prescaler */
+} TIMER_SimModel;
+
+static void TIMER_SimUpdate(HOSTSIM_Periph *periph)
+{
+    TIMER_SimModel *m = (TIMER_SimModel *)periph->model;
+    TIMER_RegStruct *regs = (TIMER_RegStruct *)periph->alias;
+    regs->TIMERx_MIS.timermis = regs->TIMERx_RIS.timerris & regs->TIMERx_CONTROL.BIT.timerintenable;
+    regs->TIMERx_MIS.dmaovmis = regs->TIMERx_RIS.dmaovris & regs->TIMERx_CONTROL.BIT.dmaovintenable;
+    HOSTSIM_IrqSetLevel(m->irqNum, regs->TIMERx_MIS.timermis || regs->TIMERx_MIS.dmaovmis);
+}
+
+static void TIMER_SimPostAccess(HOSTSIM_Periph *periph, const HOSTSIM_Access *access)
+{
+    TIMER_RegStruct *regs = (TIMER_RegStruct *)periph->alias;
+    if (!access->isWrite) {
+        return;
+    }
+    switch (access->offset) {
+        case offsetof(TIMER_RegStruct, timer_load):
+            regs->timer_value = regs->timer_load; /* Writing the load value restarts the count */
+            break;
+        case offsetof(TIMER_RegStruct, timer_intclr):
+            regs->TIMERx_RIS.timerris = 0;
+            break;
+        case offsetof(TIMER_RegStruct, DMAOV_INTCLR):
+            regs->TIMERx_RIS.dmaovris = 0;
+            regs->DMAOV_INTCLR.reg = 0;
+            break;
+        case offsetof(TIMER_RegStruct, timer_value):
+        case offsetof(TIMER_RegStruct, TIMERx_RIS):
+        case offsetof(TIMER_RegStruct, TIMERx_MIS):
+            /* Read-only, discard the write */
+            *(volatile unsigned int *)((HOSTSIM_Addr)periph->alias + access->offset) = access->oldVal;
+            break;
+        default:
+            break;
+    }
+    TIMER_SimUpdate(periph);
+}
+
+static void TIMER_SimStep(HOSTSIM_Periph *periph, unsigned int cycles)
+{
+    TIMER_SimModel *m = (TIMER_SimModel *)periph->model;
+    TIMER_RegStruct *regs = (TIMER_RegStruct *)periph->alias;
+    if (!regs->TIMERx_CONTROL.BIT.timeren) {
+        return;
+    }
+    unsigned int shift = regs->TIMERx_CONTROL.BIT.timerpre * TIMER_SIM_PRE_SHIFT;
+    unsigned long long ticks = ((unsigned long long)m->remain + cycles) >> shift;
+    unsigned int max = regs->TIMERx_CONTROL.BIT.timersize ? 0xFFFFFFFFU : 0xFFFFU; /* 1: 32-bit counter */
+    m->remain = (m->remain + cycles) & ((1U << shift) - 1);
+    while (ticks != 0) {
+        unsigned int value = regs->timer_value & max;
+        if (ticks < value) {
+            regs->timer_value = value - (unsigned int)ticks;
+            break;
+        }
+        /* Counter reaches zero: raise the interrupt, then reload, wrap or stop */
+        ticks -= value;
+        regs->TIMERx_RIS.timerris = 1;
+        if (regs->TIMERx_CONTROL.BIT.oneshot) {
+            regs->timer_value = 0;
+            regs->TIMERx_CONTROL.BIT.timeren = 0;
+            break;
+        }
+        regs->timer_value = regs->TIMERx_CONTROL.BIT.timermode ? regs->timerbgload : max;
+        if (regs->timer_value == 0) {
+            break;
+        }
+        ticks = (ticks == 0) ? 0 : ticks - 1; /* The reload itself takes one count */
+    }
+    TIMER_SimUpdate(periph);
+}
+
+static const HOSTSIM_PeriphOps g_timerSimOps = {
+    .preAccess = NULL,
+    .postAccess = TIMER_SimPostAccess,
+    .step = TIMER_SimStep,
+};
+
+/**
+  * @brief Add a TIMER model.
+  * @param base TIMER base address, for example TIMER0_BASE.
+  * @param irqNum TIMER interrupt number.
+  * @retval TIMER peripheral, NULL on failure.
+  */
+HOSTSIM_Periph *HOSTSIM_TimerAdd(void *base, unsigned int irqNum)
+{
+    TIMER_SimModel *m = calloc(1, sizeof(TIMER_SimModel));
+    if (m == NULL) {
+        return NULL;
+    }
+    m->irqNum = irqNum;
+    HOSTSIM_Periph *periph = HOSTSIM_PeriphAdd("timer", base, sizeof(TIMER_RegStruct), &g_timerSimOps, m);
+    if (periph == NULL) {
+        free(m);
+    }
+    return periph;
+}
@@ -0,0 +1,236 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      hostsim_uart.c
+  * @author    MCU Driver Team
+  * @brief     UART behavioural model: 16-byte FIFOs drained and filled at one character per cyclesPerChar.
+  *            Transmitted bytes are captured for HOSTSIM_UartTake(), injected bytes arrive on the RX line.
+  */
+#include <stddef.h>
+#include <stdlib.h>
+#include "uart_ip.h"
+#include "hostsim.h"
+
+#define UART_SIM_FIFO_DEPTH     16U
+#define UART_SIM_LINE_SIZE      4096U   /* Captured TX bytes and pending RX bytes, power of 2 */
+#define UART_SIM_RT_CHARS       4U      /* RX timeout after this many idle character times */
+
+typedef struct {
+    unsigned char   buf[UART_SIM_LINE_SIZE];
+    unsigned int    head;
+    unsigned int    tail;
+} UART_SimQueue;
+
+typedef struct {
+    unsigned int    irqNum;
+    unsigned int    txDmaReq;
+    unsigned int    rxDmaReq;
+    unsigned int    cyclesPerChar;
+    unsigned int    txLevel;        /* TX FIFO level, the bytes are already in txLine */
+    unsigned int    txCycle;
+    unsigned int    rxCycle;
+    unsigned int    rxIdle;         /* Character times since the last RX byte or read */
+    bool            rxTimeout;
+    UART_SimQueue   txLine;         /* Bytes sent on the wire, read by HOSTSIM_UartTake */
+    UART_SimQueue   rxLine;         /* Bytes injected, not yet received */
+    UART_SimQueue   rxFifo;
+} UART_SimModel;
+
+static unsigned int UART_SimQueueCnt(const UART_SimQueue *q)
+{
+    return q->tail - q->head;
+}
+
+static void UART_SimQueuePut(UART_SimQueue *q, unsigned char data)
+{
+    if (UART_SimQueueCnt(q) < UART_SIM_LINE_SIZE) {
+        q->buf[q->tail++ & (UART_SIM_LINE_SIZE - 1)] = data;
+    }
+}
+
+static unsigned char UART_SimQueueGet(UART_SimQueue *q)
+{
+    return q->buf[q->head++ & (UART_SIM_LINE_SIZE - 1)];
+}
+
+/**
+  * @brief Recompute the flag, raw and masked interrupt status from the FIFO levels.
+  */
+static void UART_SimUpdate(HOSTSIM_Periph *periph)
+{
+    UART_SimModel *m = (UART_SimModel *)periph->model;
+    UART_RegStruct *regs = (UART_RegStruct *)periph->alias;
+    unsigned int rxCnt = UART_SimQueueCnt(&m->rxFifo);
+    unsigned int rxThreshold = (regs->UART_IFLS.BIT.rxiflsel == 0) ? 1 : regs->UART_IFLS.BIT.rxiflsel;
+
+    regs->UART_FR.BIT.txff = (m->txLevel == UART_SIM_FIFO_DEPTH);
+    regs->UART_FR.BIT.txfe = (m->txLevel == 0);
+    regs->UART_FR.BIT.busy = (m->txLevel != 0);
+    regs->UART_FR.BIT.rxfe = (rxCnt == 0);
+    regs->UART_FR.BIT.rxff = (rxCnt == UART_SIM_FIFO_DEPTH);
+    regs->UART_RIS.BIT.txris = (m->txLevel <= regs->UART_IFLS.BIT.txiflsel);
+    regs->UART_RIS.BIT.txferis = (m->txLevel == 0);
+    regs->UART_RIS.BIT.txfneris = (m->txLevel != 0);
+    regs->UART_RIS.BIT.rxris = (rxCnt >= rxThreshold);
+    regs->UART_RIS.BIT.rxfneris = (rxCnt != 0);
+    regs->UART_RIS.BIT.rxffris = (rxCnt == UART_SIM_FIFO_DEPTH);
+    regs->UART_RIS.BIT.rxferis = (rxCnt == 0);
+    regs->UART_RIS.BIT.rtris = (m->rxTimeout && rxCnt != 0);
+    regs->UART_MIS.reg = regs->UART_RIS.reg & regs->UART_IMSC.reg;
+    HOSTSIM_IrqSetLevel(m->irqNum, regs->UART_MIS.reg != 0);
+}
+
+static void UART_SimPreAccess(HOSTSIM_Periph *periph, const HOSTSIM_Access *access)
+{
+    UART_SimModel *m = (UART_SimModel *)periph->model;
+    UART_RegStruct *regs = (UART_RegStruct *)periph->alias;
+    /* Present the next received byte before DR is read */
+    if (!access->isWrite && access->offset == offsetof(UART_RegStruct, UART_DR)) {
+        regs->UART_DR.reg = (UART_SimQueueCnt(&m->rxFifo) != 0) ? UART_SimQueueGet(&m->rxFifo) : 0;
+        m->rxIdle = 0;
+    }
+}
+
+static void UART_SimPostAccess(HOSTSIM_Periph *periph, const HOSTSIM_Access *access)
+{
+    UART_SimModel *m = (UART_SimModel *)periph->model;
+    UART_RegStruct *regs = (UART_RegStruct *)periph->alias;
+    if (!access->isWrite) {
+        UART_SimUpdate(periph);
+        return;
+    }
+    if (access->offset == offsetof(UART_RegStruct, UART_DR)) {
+        if (m->txLevel < UART_SIM_FIFO_DEPTH) { /* Writes to a full FIFO are lost as on silicon */
+            m->txLevel++;
+            UART_SimQueuePut(&m->txLine, regs->UART_DR.BIT.data);
+        }
+    } else if (access->offset == offsetof(UART_RegStruct, UART_ICR)) {
+        if (regs->UART_ICR.BIT.rtic) {
+            m->rxTimeout = false;
+        }
+        regs->UART_ICR.reg = 0;
+    } else if (access->offset == offsetof(UART_RegStruct, UART_FR) ||
+               access->offset == offsetof(UART_RegStruct, UART_RIS) ||
+               access->offset == offsetof(UART_RegStruct, UART_MIS)) {
+        /* Read-only status, discard the write */
+        *(volatile unsigned int *)((HOSTSIM_Addr)periph->alias + access->offset) = access->oldVal;
+    }
+    UART_SimUpdate(periph);
+}
+
+static void UART_SimStep(HOSTSIM_Periph *periph, unsigned int cycles)
+{
+    UART_SimModel *m = (UART_SimModel *)periph->model;
+    UART_RegStruct *regs = (UART_RegStruct *)periph->alias;
+    /* Wire side: one character per cyclesPerChar in each direction */
+    m->txCycle = (m->txLevel != 0) ? (m->txCycle + cycles) : 0;
+    while (m->txLevel != 0 && m->txCycle >= m->cyclesPerChar) {
+        m->txCycle -= m->cyclesPerChar;
+        m->txLevel--;
+    }
+    m->rxCycle += cycles;
+    while (m->rxCycle >= m->cyclesPerChar) {
+        m->rxCycle -= m->cyclesPerChar;
+        if (UART_SimQueueCnt(&m->rxLine) != 0 && UART_SimQueueCnt(&m->rxFifo) < UART_SIM_FIFO_DEPTH) {
+            UART_SimQueuePut(&m->rxFifo, UART_SimQueueGet(&m->rxLine));
+            m->rxIdle = 0;
+        } else if (++m->rxIdle >= UART_SIM_RT_CHARS) {
+            m->rxTimeout = true;
+        }
+    }
+    /* DMA side: request while there is room or data */
+    while (regs->UART_DMACR.BIT.txdmae && m->txLevel < UART_SIM_FIFO_DEPTH) {
+        if (!HOSTSIM_DmaRequest(m->txDmaReq, UART_SIM_FIFO_DEPTH - m->txLevel)) {
+            break;
+        }
+    }
+    while (regs->UART_DMACR.BIT.rxdmae && UART_SimQueueCnt(&m->rxFifo) != 0) {
+        if (!HOSTSIM_DmaRequest(m->rxDmaReq, UART_SimQueueCnt(&m->rxFifo))) {
+            break;
+        }
+    }
+    UART_SimUpdate(periph);
+}
+
+static const HOSTSIM_PeriphOps g_uartSimOps = {
+    .preAccess = UART_SimPreAccess,
+    .postAccess = UART_SimPostAccess,
+    .step = UART_SimStep,
+};
+
+/**
+  * @brief Add a UART model.
+  * @param base UART base address, for example UART0_BASE.
+  * @param irqNum UART interrupt number.
+  * @param txDmaReq DMA request line of TX, for example DMA_REQUEST_UART0_TX.
+  * @param rxDmaReq DMA request line of RX, for example DMA_REQUEST_UART0_RX.
+  * @param cyclesPerChar Virtual cycles per character on the wire, 10 bits at the simulated baud rate.
+  * @retval UART peripheral, NULL on failure.
+  */
+HOSTSIM_Periph *HOSTSIM_UartAdd(void *base, unsigned int irqNum, unsigned int txDmaReq, unsigned int rxDmaReq,
+                                unsigned int cyclesPerChar)
+{
+    UART_SimModel *m = calloc(1, sizeof(UART_SimModel));
+    if (m == NULL) {
+        return NULL;
+    }
+    m->irqNum = irqNum;
+    m->txDmaReq = txDmaReq;
+    m->rxDmaReq = rxDmaReq;
+    m->cyclesPerChar = (cyclesPerChar == 0) ? 1 : cyclesPerChar;
+    HOSTSIM_Periph *periph = HOSTSIM_PeriphAdd("uart", base, sizeof(UART_RegStruct), &g_uartSimOps, m);
+    if (periph == NULL) {
+        free(m);
+        return NULL;
+    }
+    UART_SimUpdate(periph);
+    return periph;
+}
+
+/**
+  * @brief Queue bytes on the RX line, they reach the RX FIFO one per character time.
+  * @param uart UART peripheral.
+  * @param data Bytes.
+  * @param len Number of bytes.
+  * @retval Number of bytes queued.
+  */
+unsigned int HOSTSIM_UartInject(HOSTSIM_Periph *uart, const unsigned char *data, unsigned int len)
+{
+    UART_SimModel *m = (UART_SimModel *)uart->model;
+    unsigned int i;
+    for (i = 0; i < len && UART_SimQueueCnt(&m->rxLine) < UART_SIM_LINE_SIZE; i++) {
+        UART_SimQueuePut(&m->rxLine, data[i]);
+    }
+    return i;
+}
+
+/**
+  * @brief Take the bytes the driver has written to the TX FIFO.
+  * @param uart UART peripheral.
+  * @param data Buffer.
+  * @param len Buffer size.
+  * @retval Number of bytes copied.
+  */
+unsigned int HOSTSIM_UartTake(HOSTSIM_Periph *uart, unsigned char *data, unsigned int len)
+{
+    UART_SimModel *m = (UART_SimModel *)uart->model;
+    unsigned int i;
+    for (i = 0; i < len && UART_SimQueueCnt(&m->txLine) != 0; i++) {
+        data[i] = UART_SimQueueGet(&m->txLine);
+    }
+    return i;
+}
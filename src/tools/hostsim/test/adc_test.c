@@ -0,0 +1,182 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      adc_test.c
+  * @author    MCU Driver Team
+  * @brief     Host test of the unmodified ADC driver on the ADC model: software and hardware triggered conversions
+  *            reported through HAL_ADC_IrqHandlerInt1()/HAL_ADC_IrqHandlerInt2() and their callbacks.
+  */
+#include <stdio.h>
+#include "adc.h"
+#include "crg.h"
+#include "hostsim.h"
+
+#define TEST_CONV_CYCLES    100U    /* Virtual cycles per conversion */
+#define TEST_STEP           50U     /* Below a conversion, each SOC raises its own interrupt */
+#define TEST_STEP_MAX       40U
+#define TEST_SOFT_SOC_NUM   3U      /* SOC0 ~ SOC2 on data interrupt 1, software triggered */
+#define TEST_HARD_SOC       ADC_SOC_NUM3 /* On data interrupt 2, triggered by APT0 SOCA */
+#define TEST_SOFT_MASK      ((1U << TEST_SOFT_SOC_NUM) - 1)
+
+static ADC_Handle g_adc;            /* Static so that the 32-bit uintptr_t of the driver holds its address */
+static HOSTSIM_Periph *g_adcSim;
+static unsigned int g_int1Cnt;
+static unsigned int g_int1Socs;
+static unsigned int g_int2Cnt;
+static unsigned int g_int2Socs;
+static bool g_resultOk = true;
+static int g_failCnt;
+
+/* Virtual time does not advance while the driver waits */
+void BASE_FUNC_DelayUs(unsigned int us)
+{
+    (void)us;
+}
+
+void BASE_FUNC_Delay(unsigned int delay, BASE_DelayUnit units)
+{
+    (void)delay;
+    (void)units;
+}
+
+/* No CRG or DAC model: only the VDDA calibration of the driver uses them, the test does not run it */
+BASE_StatusType HAL_CRG_IpEnableSet(const void *baseAddress, unsigned int enable)
+{
+    (void)baseAddress;
+    (void)enable;
+    return BASE_STATUS_ERROR;
+}
+
+BASE_StatusType HAL_CRG_IpClkSelectSet(const void *baseAddress, unsigned int select)
+{
+    (void)baseAddress;
+    (void)select;
+    return BASE_STATUS_ERROR;
+}
+
+BASE_StatusType HAL_DAC_Init(DAC_Handle *dacHandle)
+{
+    (void)dacHandle;
+    return BASE_STATUS_ERROR;
+}
+
+static void TEST_Check(bool ok, const char *what, unsigned long long value)
+{
+    printf("%-40s %llu %s\n", what, value, ok ? "ok" : "FAIL");
+    g_failCnt += ok ? 0 : 1;
+}
+
+static unsigned int TEST_Sample(unsigned int soc, unsigned int channel, unsigned long long cycle)
+{
+    (void)cycle;
+    return 0x100U * channel + soc + 1U;
+}
+
+static void TEST_CheckResults(unsigned int socs)
+{
+    for (unsigned int soc = 0; soc < SOC_MAX_NUM; soc++) {
+        if ((socs & (1U << soc)) != 0) {
+            /* Each SOC converts the channel of the same number */
+            g_resultOk = g_resultOk && (HAL_ADC_GetConvResult(&g_adc, soc) == TEST_Sample(soc, soc, 0));
+        }
+    }
+}
+
+static void TEST_Int1Callback(void *handle)
+{
+    ADC_Handle *adc = (ADC_Handle *)handle;
+    g_int1Cnt++;
+    g_int1Socs |= adc->ADC_IntxParam[ADC_INT_NUMBER1].socxFinish;
+    TEST_CheckResults(adc->ADC_IntxParam[ADC_INT_NUMBER1].socxFinish);
+}
+
+static void TEST_Int2Callback(void *handle)
+{
+    ADC_Handle *adc = (ADC_Handle *)handle;
+    g_int2Cnt++;
+    g_int2Socs |= adc->ADC_IntxParam[ADC_INT_NUMBER2].socxFinish;
+    TEST_CheckResults(adc->ADC_IntxParam[ADC_INT_NUMBER2].socxFinish);
+}
+
+static void TEST_Run(void)
+{
+    for (unsigned int i = 0; i < TEST_STEP_MAX; i++) {
+        HOSTSIM_Step(TEST_STEP);
+    }
+}
+
+static BASE_StatusType TEST_SocInit(unsigned int soc, ADC_TrigSource trig, ADC_SOCFinishMode finish)
+{
+    SOC_Param param = {
+        .adcInput = (ADC_Input)soc,
+        .sampleTotalTime = ADC_SOCSAMPLE_10CLK,
+        .trigSource = trig,
+        .continueMode = false,
+        .finishMode = finish,
+    };
+    return HAL_ADC_ConfigureSoc(&g_adc, (ADC_SOCNumber)soc, &param);
+}
+
+int main(void)
+{
+    HOSTSIM_IrqStat irqStat;
+    const unsigned int intIrq[HOSTSIM_ADC_INT_NUM] = {IRQ_ADC0_INT0, IRQ_ADC0_INT1, IRQ_ADC0_INT2, IRQ_ADC0_INT3};
+    if (HOSTSIM_Init() != 0) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    g_adcSim = HOSTSIM_AdcAdd(ADC0_BASE, intIrq, DMA_REQUEST_ADC0, TEST_CONV_CYCLES, TEST_Sample);
+    if (g_adcSim == NULL) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    HOSTSIM_IrqConnect(IRQ_ADC0_INT1, HAL_ADC_IrqHandlerInt1, &g_adc);
+    HOSTSIM_IrqConnect(IRQ_ADC0_INT2, HAL_ADC_IrqHandlerInt2, &g_adc);
+    g_adc.baseAddress = ADC0;
+    g_adc.socPriority = ADC_PRIMODE_ALL_ROUND;
+    TEST_Check(HAL_ADC_Init(&g_adc) == BASE_STATUS_OK, "init", 0);
+    for (unsigned int soc = 0; soc < TEST_SOFT_SOC_NUM; soc++) {
+        TEST_Check(TEST_SocInit(soc, ADC_TRIGSOC_SOFT, ADC_SOCFINISH_INT1) == BASE_STATUS_OK, "soft SOC init", soc);
+    }
+    TEST_Check(TEST_SocInit(TEST_HARD_SOC, ADC_TRIGSOC_APT0_SOCA, ADC_SOCFINISH_INT2) == BASE_STATUS_OK,
+               "hard SOC init", TEST_HARD_SOC);
+    HAL_ADC_RegisterCallBack(&g_adc, ADC_CALLBACK_INT1, TEST_Int1Callback);
+    HAL_ADC_RegisterCallBack(&g_adc, ADC_CALLBACK_INT2, TEST_Int2Callback);
+    TEST_Check(HAL_ADC_StartIt(&g_adc) == BASE_STATUS_OK, "start interrupts", 0);
+    /* Software trigger: one interrupt 1 per SOC, each callback sees its finished SOC and result */
+    ADC_SoftMultiTrig trig;
+    trig.softTrigVal = TEST_SOFT_MASK;
+    HOSTSIM_ClearStat();
+    TEST_Check(HAL_ADC_SoftTrigMultiSample(&g_adc, trig) == BASE_STATUS_OK, "soft trigger", TEST_SOFT_MASK);
+    TEST_Run();
+    TEST_Check(g_int1Cnt == TEST_SOFT_SOC_NUM, "interrupt 1 callbacks", g_int1Cnt);
+    TEST_Check(g_int1Socs == TEST_SOFT_MASK, "interrupt 1 SOCs", g_int1Socs);
+    TEST_Check(g_int2Cnt == 0, "interrupt 2 callbacks", g_int2Cnt);
+    TEST_Check(ADC0->ADC_EOC_FLAG.reg == 0, "EOC flags cleared", ADC0->ADC_EOC_FLAG.reg);
+    HOSTSIM_GetIrqStat(IRQ_ADC0_INT1, &irqStat);
+    TEST_Check(irqStat.runCnt == TEST_SOFT_SOC_NUM, "interrupt 1 handler calls", irqStat.runCnt);
+    TEST_Check(irqStat.stuckCnt == 0, "stuck interrupt line", irqStat.stuckCnt);
+    /* Hardware trigger: only the SOC on APT0 SOCA converts, on interrupt 2 */
+    HOSTSIM_AdcTrigger(g_adcSim, ADC_TRIGSOC_APT0_SOCA);
+    TEST_Run();
+    TEST_Check(g_int2Cnt == 1, "interrupt 2 callbacks", g_int2Cnt);
+    TEST_Check(g_int2Socs == (1U << TEST_HARD_SOC), "interrupt 2 SOCs", g_int2Socs);
+    TEST_Check(g_int1Cnt == TEST_SOFT_SOC_NUM, "no interrupt 1 on the APT trigger", g_int1Cnt);
+    TEST_Check(g_resultOk, "results in the callbacks", 0);
+    printf("%s\n", (g_failCnt == 0) ? "PASS" : "FAIL");
+    return (g_failCnt == 0) ? 0 : 1;
+}
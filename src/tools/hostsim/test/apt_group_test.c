@@ -0,0 +1,131 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      apt_group_test.c
+  * @author    MCU Driver Team
+  * @brief     Host test of HAL_APT_GroupInit()/HAL_APT_GroupUpdate() on three APT models: register accesses of a
+  *            group update against the per-module HAL_APT_SetPWMDuty()/HAL_APT_SetADCTriggerTime() path, and the
+  *            load of the three phases on the same global load event.
+  */
+#include <stdio.h>
+#include "apt.h"
+#include "hostsim.h"
+
+#define TEST_PERIOD         1000U   /* Up-down count: one zero event every 2 * TEST_PERIOD cycles */
+#define TEST_SINGLE_ACCESS  16U     /* Read-modify-write of TC_REFC and TC_REFD per phase, TC_REFA and TC_REFB */
+#define TEST_GROUP_WRITE    11U     /* Two compare writes per phase, TC_REFA, TC_REFB, one latch strobe per phase */
+#define TEST_REF_A          0U
+#define TEST_REF_C          2U
+#define TEST_REF_D          3U
+
+static APT_Handle g_apt[APT_GROUP_PHASE_NUM]; /* Static so that the 32-bit uintptr_t of the driver holds them */
+static APT_Group g_group;
+static HOSTSIM_Periph *g_aptSim[APT_GROUP_PHASE_NUM];
+static int g_failCnt;
+
+static void TEST_Check(bool ok, const char *what, unsigned long long value)
+{
+    printf("%-40s %llu %s\n", what, value, ok ? "ok" : "FAIL");
+    g_failCnt += ok ? 0 : 1;
+}
+
+static void TEST_GetAccess(unsigned long long *readCnt, unsigned long long *writeCnt)
+{
+    HOSTSIM_AccessStat stat;
+    *readCnt = 0;
+    *writeCnt = 0;
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        HOSTSIM_GetAccessStat(g_aptSim[i], &stat);
+        *readCnt += stat.readCnt;
+        *writeCnt += stat.writeCnt;
+    }
+}
+
+static bool TEST_PhaseCompareIs(unsigned int left, unsigned int right)
+{
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        if (HOSTSIM_AptGetCompare(g_aptSim[i], TEST_REF_C) != left + i ||
+            HOSTSIM_AptGetCompare(g_aptSim[i], TEST_REF_D) != right + i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int TEST_Setup(void)
+{
+    APT_RegStruct *aptBase[APT_GROUP_PHASE_NUM] = {APT0, APT1, APT2};
+    if (HOSTSIM_Init() != 0) {
+        return -1;
+    }
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        g_aptSim[i] = HOSTSIM_AptAdd((void *)aptBase[i]);
+        if (g_aptSim[i] == NULL) {
+            return -1;
+        }
+        g_apt[i].baseAddress = aptBase[i];
+        g_apt[i].waveform.timerPeriod = TEST_PERIOD;
+        DCL_APT_SetTimeBasePeriod(aptBase[i], TEST_PERIOD);
+        DCL_APT_SetTimeBaseCountMode(aptBase[i], APT_COUNT_MODE_UP_DOWN);
+        g_group.aptHandle[i] = &g_apt[i];
+    }
+    g_group.glbLoadEvt = APT_GLB_LOAD_ON_CNTR_ZERO;
+    return 0;
+}
+
+int main(void)
+{
+    unsigned long long readCnt;
+    unsigned long long writeCnt;
+    if (TEST_Setup() != 0) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    /* Per-module path, the buffers are still disabled so the values load at once */
+    HOSTSIM_ClearStat();
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        HAL_APT_SetPWMDuty(&g_apt[i], 100 + i, 200 + i); /* 100, 200: initial left and right edges */
+    }
+    HAL_APT_SetADCTriggerTime(&g_apt[0], 300, 400);      /* 300, 400: initial SOCA and SOCB */
+    TEST_GetAccess(&readCnt, &writeCnt);
+    TEST_Check(readCnt + writeCnt == TEST_SINGLE_ACCESS, "per-module register accesses", readCnt + writeCnt);
+    TEST_Check(TEST_PhaseCompareIs(100, 200), "per-module compare loaded", 0);
+    /* Group update: writes only, and nothing loads before the global load event */
+    TEST_Check(HAL_APT_GroupInit(&g_group) == BASE_STATUS_OK, "group init", 0);
+    APT_GroupCompare cmp = {{500, 501, 502}, {600, 601, 602}, 700, 800}; /* New edges, SOCA and SOCB */
+    HOSTSIM_ClearStat();
+    TEST_Check(HAL_APT_GroupUpdate(&g_group, &cmp) == BASE_STATUS_OK, "group update", 0);
+    TEST_GetAccess(&readCnt, &writeCnt);
+    TEST_Check(readCnt == 0, "group update register reads", readCnt);
+    TEST_Check(writeCnt == TEST_GROUP_WRITE, "group update register writes", writeCnt);
+    TEST_Check(g_group.regWriteCnt == TEST_GROUP_WRITE, "group regWriteCnt", g_group.regWriteCnt);
+    TEST_Check(TEST_PhaseCompareIs(100, 200), "compare held until the load event", 0);
+    /* The zero event loads the three phases and the ADC triggers together */
+    HOSTSIM_Step(2 * TEST_PERIOD); /* 2: up then down */
+    TEST_Check(TEST_PhaseCompareIs(500, 600), "phases loaded on the same event", 0);
+    TEST_Check(HOSTSIM_AptGetCompare(g_aptSim[0], TEST_REF_A) == 700, "ADC trigger loaded", 0);
+    for (unsigned int i = 0; i < APT_GROUP_PHASE_NUM; i++) {
+        unsigned int glbLoadCnt = HOSTSIM_AptGetGlobalLoadCnt(g_aptSim[i]);
+        TEST_Check(glbLoadCnt == 1, "global loads", glbLoadCnt);
+    }
+    /* One-shot: a compare write without a latch strobe is not loaded */
+    APT0->TC_REFC.reg = 900; /* 900: stray compare value */
+    HOSTSIM_Step(2 * TEST_PERIOD); /* 2: up then down */
+    TEST_Check(HOSTSIM_AptGetCompare(g_aptSim[0], TEST_REF_C) == 500, "no load without latch strobe", 0);
+    printf("%s\n", (g_failCnt == 0) ? "PASS" : "FAIL");
+    return (g_failCnt == 0) ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      dma_chain_test.c
+  * @author    MCU Driver Team
+  * @brief     Host test of the DMA chains of dma_ex.c on the DMA model: the split of a segment into descriptors for
+  *            sizes around the TRANS_BLOCK multiples, and a memory to memory chain run to its TC interrupt.
+  */
+#include <stdio.h>
+#include <string.h>
+#include "dma_ex.h"
+#include "hostsim.h"
+
+#define TEST_STEP           100U    /* Cycles per simulation step */
+#define TEST_STEP_MAX       100U
+#define TEST_RUN_SIZE       8186U   /* Three descriptors, the last one takes two bytes */
+#define TEST_BUF_SIZE       (3U * TRANS_BLOCK + 8U)
+
+static DMA_Handle g_dma;            /* Static so that the 32-bit uintptr_t of the driver holds their addresses */
+static DMA_Chain g_chain;
+static unsigned char g_src[TEST_BUF_SIZE];
+static unsigned char g_dest[TEST_BUF_SIZE];
+static unsigned int g_finishCnt;
+static bool g_finishCopied;
+static int g_failCnt;
+
+/* Lengths just below, at and just above the TRANS_BLOCK multiples and TRANSIZE_MAX */
+static const unsigned int g_sizes[] = {
+    1, TRANS_BLOCK, TRANSIZE_MAX, TRANSIZE_MAX + 1, 2 * TRANS_BLOCK - 1, 2 * TRANS_BLOCK, 2 * TRANS_BLOCK + 1,
+    2 * TRANS_BLOCK + 2, 2 * TRANS_BLOCK + 3, 2 * TRANS_BLOCK + 4, 3 * TRANS_BLOCK, 3 * TRANS_BLOCK + 1,
+    3 * TRANS_BLOCK + 2, 3 * TRANS_BLOCK + 3, 3 * TRANS_BLOCK + 4,
+};
+
+static void TEST_Check(bool ok, const char *what, unsigned long long value)
+{
+    printf("%-40s %llu %s\n", what, value, ok ? "ok" : "FAIL");
+    g_failCnt += ok ? 0 : 1;
+}
+
+static void TEST_FinishCallback(void *handle)
+{
+    (void)handle;
+    g_finishCnt++;
+    g_finishCopied = (memcmp(g_src, g_dest, TEST_RUN_SIZE) == 0);
+}
+
+static BASE_StatusType TEST_ChainInit(void)
+{
+    DMA_ChannelParam param = {
+        .srcPeriph = DMA_REQUEST_MEM,
+        .destPeriph = DMA_REQUEST_MEM,
+        .direction = DMA_MEMORY_TO_MEMORY_BY_DMAC,
+        .srcAddrInc = DMA_ADDR_INCREASE,
+        .destAddrInc = DMA_ADDR_INCREASE,
+        .srcBurst = DMA_BURST_LENGTH_1,
+        .destBurst = DMA_BURST_LENGTH_1,
+        .srcWidth = DMA_TRANSWIDTH_BYTE,
+        .destWidth = DMA_TRANSWIDTH_BYTE,
+        .pHandle = &g_chain,
+    };
+    return HAL_DMA_ChainInitEx(&g_chain, &param, DMA_PRIORITY_LOW, false);
+}
+
+/**
+  * @brief Append one segment and check its descriptors: none is empty or longer than TRANSIZE_MAX, the addresses
+  *        follow the lengths, and only the last one raises the TC interrupt.
+  * @retval true if all descriptors are as expected.
+  */
+static bool TEST_SplitOk(unsigned int size)
+{
+    unsigned int src = (unsigned int)(HOSTSIM_Addr)g_src;
+    unsigned int dest = (unsigned int)(HOSTSIM_Addr)g_dest;
+    unsigned int expectNum = (size > TRANSIZE_MAX) ? ((size + TRANS_BLOCK - 1) / TRANS_BLOCK) : 1;
+    unsigned int freeNum = HAL_DMA_DescFreeNumEx();
+    if (TEST_ChainInit() != BASE_STATUS_OK || HAL_DMA_ChainAppendEx(&g_chain, src, dest, size) != BASE_STATUS_OK) {
+        return false;
+    }
+    bool ok = (g_chain.nodeNum == expectNum) && (HAL_DMA_DescFreeNumEx() == freeNum - expectNum);
+    unsigned int offset = 0;
+    unsigned int nodeCnt = 0;
+    for (const DMA_LinkList *node = g_chain.head; node != NULL; node = node->lliNext) {
+        unsigned int len = node->control.BIT.trans_size;
+        ok = ok && (len != 0) && (len <= TRANSIZE_MAX);
+        ok = ok && (node->srcAddr == src + offset) && (node->destAddr == dest + offset);
+        ok = ok && (node->control.BIT.int_tc_enable == ((node == g_chain.tail) ? 1U : 0U));
+        offset += len;
+        nodeCnt++;
+    }
+    ok = ok && (offset == size) && (nodeCnt == expectNum);
+    return (HAL_DMA_ChainResetEx(&g_chain) == BASE_STATUS_OK) && ok && (HAL_DMA_DescFreeNumEx() == freeNum);
+}
+
+int main(void)
+{
+    char what[64];
+    HOSTSIM_IrqStat irqStat;
+    if (HOSTSIM_Init() != 0 || HOSTSIM_DmaAdd(DMA_BASE, IRQ_DMA_TC, IRQ_DMA_ERR) == NULL) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    /* Split: one descriptor per TRANS_BLOCK, the last one takes the rest and interrupts */
+    for (unsigned int i = 0; i < sizeof(g_sizes) / sizeof(g_sizes[0]); i++) {
+        (void)snprintf(what, sizeof(what), "split %u bytes", g_sizes[i]);
+        TEST_Check(TEST_SplitOk(g_sizes[i]), what, g_chain.nodeNum);
+    }
+    /* Run: the chain copies everything before its single TC interrupt */
+    for (unsigned int i = 0; i < TEST_BUF_SIZE; i++) {
+        g_src[i] = (unsigned char)(i * 7U + 1U);
+    }
+    g_dma.baseAddress = DMA;
+    HOSTSIM_IrqConnect(IRQ_DMA_TC, HAL_DMA_IrqHandlerTc, &g_dma);
+    TEST_Check(HAL_DMA_Init(&g_dma) == BASE_STATUS_OK, "dma init", 0);
+    TEST_Check(HAL_DMA_ChainEngineInitEx(&g_dma, 1U << DMA_CHANNEL_ZERO) == BASE_STATUS_OK, "chain engine init", 0);
+    TEST_Check(TEST_ChainInit() == BASE_STATUS_OK, "chain init", 0);
+    TEST_Check(HAL_DMA_ChainAppendEx(&g_chain, (unsigned int)(HOSTSIM_Addr)g_src, (unsigned int)(HOSTSIM_Addr)g_dest,
+                                     TEST_RUN_SIZE) == BASE_STATUS_OK, "chain append", g_chain.nodeNum);
+    HAL_DMA_ChainRegisterCallbackEx(&g_chain, DMA_CHANNEL_FINISH, TEST_FinishCallback);
+    HOSTSIM_ClearStat();
+    TEST_Check(HAL_DMA_ChainStartEx(&g_dma, &g_chain) == BASE_STATUS_OK, "chain start", 0);
+    for (unsigned int i = 0; i < TEST_STEP_MAX && g_chain.state != DMA_CHAIN_IDLE; i++) {
+        HOSTSIM_Step(TEST_STEP);
+    }
+    TEST_Check(g_finishCnt == 1, "finish callbacks", g_finishCnt);
+    TEST_Check(g_finishCopied, "copied before the finish callback", TEST_RUN_SIZE);
+    TEST_Check(g_dest[TEST_RUN_SIZE] == 0, "nothing copied past the segment", g_dest[TEST_RUN_SIZE]);
+    HOSTSIM_GetIrqStat(IRQ_DMA_TC, &irqStat);
+    TEST_Check(irqStat.runCnt == 1, "TC handler calls", irqStat.runCnt);
+    TEST_Check(irqStat.stuckCnt == 0, "stuck interrupt line", irqStat.stuckCnt);
+    TEST_Check(g_chain.state == DMA_CHAIN_IDLE && g_chain.stat.finishCnt == 1, "chain released", g_chain.stat.finishCnt);
+    TEST_Check(HAL_DMA_ChainResetEx(&g_chain) == BASE_STATUS_OK && HAL_DMA_DescFreeNumEx() == DMA_DESC_POOL_NUM,
+               "descriptors returned", HAL_DMA_DescFreeNumEx());
+    printf("%s\n", (g_failCnt == 0) ? "PASS" : "FAIL");
+    return (g_failCnt == 0) ? 0 : 1;
+}
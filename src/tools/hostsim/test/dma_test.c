@@ -0,0 +1,116 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      dma_test.c
+  * @author    MCU Driver Team
+  * @brief     Host test of the unmodified DMA driver on the DMA model: a memory to memory transfer completed
+  *            through HAL_DMA_IrqHandlerTc(), and a transfer with the completion interrupt masked.
+  */
+#include <stdio.h>
+#include <string.h>
+#include "dma.h"
+#include "hostsim.h"
+
+#define TEST_STEP           100U    /* Cycles per simulation step */
+#define TEST_STEP_MAX       10U
+#define TEST_WORDS          1000U   /* Below TRANSIZE_MAX, a single transfer */
+#define TEST_CHANNEL        DMA_CHANNEL_ZERO
+
+static DMA_Handle g_dma;            /* Static so that the 32-bit uintptr_t of the driver holds their addresses */
+static unsigned int g_src[TEST_WORDS];
+static unsigned int g_dest[TEST_WORDS + 1];
+static unsigned int g_finishCnt;
+static bool g_finishCopied;
+static void *g_finishArg;
+static int g_failCnt;
+
+static void TEST_Check(bool ok, const char *what, unsigned long long value)
+{
+    printf("%-40s %llu %s\n", what, value, ok ? "ok" : "FAIL");
+    g_failCnt += ok ? 0 : 1;
+}
+
+static void TEST_FinishCallback(void *handle)
+{
+    g_finishCnt++;
+    g_finishArg = handle;
+    g_finishCopied = (memcmp(g_src, g_dest, sizeof(g_src)) == 0);
+}
+
+static void TEST_Run(void)
+{
+    for (unsigned int i = 0; i < TEST_STEP_MAX; i++) {
+        HOSTSIM_Step(TEST_STEP);
+    }
+}
+
+int main(void)
+{
+    HOSTSIM_IrqStat irqStat;
+    DMA_ChannelParam param = {
+        .srcPeriph = DMA_REQUEST_MEM,
+        .destPeriph = DMA_REQUEST_MEM,
+        .direction = DMA_MEMORY_TO_MEMORY_BY_DMAC,
+        .srcAddrInc = DMA_ADDR_INCREASE,
+        .destAddrInc = DMA_ADDR_INCREASE,
+        .srcBurst = DMA_BURST_LENGTH_4,
+        .destBurst = DMA_BURST_LENGTH_4,
+        .srcWidth = DMA_TRANSWIDTH_WORD,
+        .destWidth = DMA_TRANSWIDTH_WORD,
+        .pHandle = &g_dest,
+    };
+    if (HOSTSIM_Init() != 0 || HOSTSIM_DmaAdd(DMA_BASE, IRQ_DMA_TC, IRQ_DMA_ERR) == NULL) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    HOSTSIM_IrqConnect(IRQ_DMA_TC, HAL_DMA_IrqHandlerTc, &g_dma);
+    HOSTSIM_IrqConnect(IRQ_DMA_ERR, HAL_DMA_IrqHandlerError, &g_dma);
+    for (unsigned int i = 0; i < TEST_WORDS; i++) {
+        g_src[i] = 0x5A5A0000U + i;
+    }
+    g_dma.baseAddress = DMA;
+    TEST_Check(HAL_DMA_Init(&g_dma) == BASE_STATUS_OK, "init", 0);
+    TEST_Check(HAL_DMA_InitChannel(&g_dma, &param, TEST_CHANNEL) == BASE_STATUS_OK, "channel init", 0);
+    HAL_DMA_RegisterCallback(&g_dma, DMA_CHANNEL_FINISH, TEST_CHANNEL, TEST_FinishCallback);
+    /* Interrupt mode: one TC interrupt after the last word, the callback gets the channel pHandle */
+    HOSTSIM_ClearStat();
+    TEST_Check(HAL_DMA_StartIT(&g_dma, (unsigned int)(HOSTSIM_Addr)g_src, (unsigned int)(HOSTSIM_Addr)g_dest,
+                               TEST_WORDS, TEST_CHANNEL) == BASE_STATUS_OK, "start with interrupt", 0);
+    TEST_Run();
+    TEST_Check(g_finishCnt == 1, "finish callbacks", g_finishCnt);
+    TEST_Check(g_finishCopied, "copied before the finish callback", TEST_WORDS);
+    TEST_Check(g_finishArg == &g_dest, "callback argument", 0);
+    TEST_Check(g_dest[TEST_WORDS] == 0, "nothing copied past the length", g_dest[TEST_WORDS]);
+    TEST_Check(HAL_DMA_GetChannelState(&g_dma, TEST_CHANNEL) == BASE_STATUS_OK, "channel idle", 0);
+    HOSTSIM_GetIrqStat(IRQ_DMA_TC, &irqStat);
+    TEST_Check(irqStat.runCnt == 1, "TC handler calls", irqStat.runCnt);
+    TEST_Check(irqStat.stuckCnt == 0, "stuck interrupt line", irqStat.stuckCnt);
+    HOSTSIM_GetIrqStat(IRQ_DMA_ERR, &irqStat);
+    TEST_Check(irqStat.runCnt == 0, "error handler calls", irqStat.runCnt);
+    /* Polling mode: the completion interrupt is masked, the data still moves */
+    memset(g_dest, 0, sizeof(g_dest));
+    HOSTSIM_ClearStat();
+    TEST_Check(HAL_DMA_Start(&g_dma, (unsigned int)(HOSTSIM_Addr)g_src, (unsigned int)(HOSTSIM_Addr)g_dest,
+                             TEST_WORDS, TEST_CHANNEL) == BASE_STATUS_OK, "start without interrupt", 0);
+    TEST_Run();
+    TEST_Check(memcmp(g_src, g_dest, sizeof(g_src)) == 0, "copied", TEST_WORDS);
+    TEST_Check(g_finishCnt == 1, "no finish callback when masked", g_finishCnt);
+    HOSTSIM_GetIrqStat(IRQ_DMA_TC, &irqStat);
+    TEST_Check(irqStat.runCnt == 0, "TC handler calls when masked", irqStat.runCnt);
+    printf("%s\n", (g_failCnt == 0) ? "PASS" : "FAIL");
+    return (g_failCnt == 0) ? 0 : 1;
+}
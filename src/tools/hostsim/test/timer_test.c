@@ -0,0 +1,99 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      timer_test.c
+  * @author    MCU Driver Team
+  * @brief     Host test of the unmodified TIMER driver on the TIMER model: period, one-shot and stop behaviour,
+  *            and the register accesses of HAL_TIMER_IrqHandler().
+  */
+#include <stdio.h>
+#include "timer.h"
+#include "hostsim.h"
+
+#define TEST_PERIOD         1000U   /* Cycles per timer period, the reload takes one count */
+#define TEST_PERIOD_NUM     10U
+#define TEST_STEP           100U    /* Cycles per simulation step */
+#define TEST_ISR_ACCESS     3U      /* TIMERx_MIS read twice, timer_intclr written once */
+
+static TIMER_Handle g_timer;        /* Static so that the 32-bit uintptr_t of the driver holds its address */
+static unsigned int g_periodCnt;
+static int g_failCnt;
+
+static void TEST_Check(bool ok, const char *what, unsigned long long value)
+{
+    printf("%-40s %llu %s\n", what, value, ok ? "ok" : "FAIL");
+    g_failCnt += ok ? 0 : 1;
+}
+
+static void TEST_PeriodCallback(void *handle)
+{
+    (void)handle;
+    g_periodCnt++;
+}
+
+static void TEST_Run(unsigned int cycles)
+{
+    for (unsigned int i = 0; i < cycles; i += TEST_STEP) {
+        HOSTSIM_Step(TEST_STEP);
+    }
+}
+
+static BASE_StatusType TEST_TimerInit(TIMER_Mode mode)
+{
+    g_timer.baseAddress = TIMER0;
+    g_timer.mode = mode;
+    g_timer.prescaler = TIMERPRESCALER_NO_DIV;
+    g_timer.size = TIMER_SIZE_32BIT;
+    g_timer.load = TEST_PERIOD - 1;
+    g_timer.bgLoad = TEST_PERIOD - 1;
+    g_timer.interruptEn = BASE_CFG_ENABLE;
+    return HAL_TIMER_Init(&g_timer);
+}
+
+int main(void)
+{
+    HOSTSIM_IrqStat irqStat;
+    if (HOSTSIM_Init() != 0 || HOSTSIM_TimerAdd(TIMER0_BASE, IRQ_TIMER0) == NULL) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    HOSTSIM_IrqConnect(IRQ_TIMER0, HAL_TIMER_IrqHandler, &g_timer);
+    /* Periodic mode: one callback per period */
+    TEST_Check(TEST_TimerInit(TIMER_MODE_RUN_PERIODIC) == BASE_STATUS_OK, "periodic init", 0);
+    HAL_TIMER_RegisterCallback(&g_timer, TIMER_PERIOD_FIN, TEST_PeriodCallback);
+    HOSTSIM_ClearStat();
+    HAL_TIMER_Start(&g_timer);
+    TEST_Run(TEST_PERIOD * TEST_PERIOD_NUM);
+    TEST_Check(g_periodCnt == TEST_PERIOD_NUM, "periodic callbacks", g_periodCnt);
+    HOSTSIM_GetIrqStat(IRQ_TIMER0, &irqStat);
+    TEST_Check(irqStat.runCnt == TEST_PERIOD_NUM, "handler calls", irqStat.runCnt);
+    TEST_Check(irqStat.maxRegAccess == TEST_ISR_ACCESS, "handler register accesses", irqStat.maxRegAccess);
+    TEST_Check(irqStat.stuckCnt == 0, "stuck interrupt line", irqStat.stuckCnt);
+    /* Stop: no callback afterwards, the pending interrupt is cleared */
+    HAL_TIMER_Stop(&g_timer);
+    g_periodCnt = 0;
+    TEST_Run(TEST_PERIOD * TEST_PERIOD_NUM);
+    TEST_Check(g_periodCnt == 0, "callbacks after stop", g_periodCnt);
+    /* One-shot mode: a single callback, then the timer disables itself */
+    TEST_Check(TEST_TimerInit(TIMER_MODE_RUN_ONTSHOT) == BASE_STATUS_OK, "one-shot init", 0);
+    HAL_TIMER_Start(&g_timer);
+    TEST_Run(TEST_PERIOD * TEST_PERIOD_NUM);
+    TEST_Check(g_periodCnt == 1, "one-shot callbacks", g_periodCnt);
+    TEST_Check(TIMER0->TIMERx_CONTROL.BIT.timeren == BASE_CFG_DISABLE, "one-shot timer disabled", 0);
+    printf("%s\n", (g_failCnt == 0) ? "PASS" : "FAIL");
+    return (g_failCnt == 0) ? 0 : 1;
+}
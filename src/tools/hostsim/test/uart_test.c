@@ -0,0 +1,211 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      uart_test.c
+  * @author    MCU Driver Team
+  * @brief     Host test of the unmodified UART driver on the UART FIFO model: interrupt mode reception through the
+  *            FIFO threshold and RX timeout interrupts, interrupt mode and DMA mode transmission, all serviced by
+  *            HAL_UART_IrqHandler() and HAL_DMA_IrqHandlerTc().
+  */
+#include <stdio.h>
+#include <string.h>
+#include "uart.h"
+#include "hostsim.h"
+
+#define TEST_UART_CLOCK     100000000U  /* UART clock returned by the HAL_CRG_GetIpFreq() stand-in */
+#define TEST_CHAR_CYCLES    100U        /* Virtual cycles per character on the wire */
+#define TEST_STEP           50U         /* Cycles per simulation step */
+#define TEST_FIFO_DEPTH     16U
+#define TEST_RX_LEN         37U         /* Over two FIFOs, the tail is below the RX threshold */
+#define TEST_TX_LEN         53U
+#define TEST_DMA_TX_LEN     100U
+#define TEST_DMA_CHANNEL    DMA_CHANNEL_ZERO
+
+static UART_Handle g_uart;          /* Static so that the 32-bit uintptr_t of the driver holds their addresses */
+static DMA_Handle g_dma;
+static HOSTSIM_Periph *g_uartSim;
+static unsigned char g_rxBuf[TEST_RX_LEN];
+static unsigned char g_txBuf[TEST_DMA_TX_LEN];
+static unsigned int g_readCnt;
+static unsigned int g_writeCnt;
+static unsigned int g_dmaWriteCnt;
+static int g_failCnt;
+
+/* No CRG model: the driver takes the UART clock from here */
+unsigned int HAL_CRG_GetIpFreq(const void *ipBaseAddr)
+{
+    (void)ipBaseAddr;
+    return TEST_UART_CLOCK;
+}
+
+static void TEST_Check(bool ok, const char *what, unsigned long long value)
+{
+    printf("%-40s %llu %s\n", what, value, ok ? "ok" : "FAIL");
+    g_failCnt += ok ? 0 : 1;
+}
+
+static void TEST_ReadCallback(void *handle)
+{
+    (void)handle;
+    g_readCnt++;
+}
+
+static void TEST_WriteCallback(void *handle)
+{
+    (void)handle;
+    g_writeCnt++;
+}
+
+static void TEST_DmaWriteCallback(void *handle)
+{
+    (void)handle;
+    g_dmaWriteCnt++;
+}
+
+static void TEST_Run(unsigned int chars)
+{
+    for (unsigned int i = 0; i < chars * TEST_CHAR_CYCLES; i += TEST_STEP) {
+        HOSTSIM_Step(TEST_STEP);
+    }
+}
+
+/**
+  * @brief Step until the counter reaches its target or the time budget runs out.
+  */
+static void TEST_RunUntil(const unsigned int *cnt, unsigned int target, unsigned int chars)
+{
+    for (unsigned int i = 0; i < chars * TEST_CHAR_CYCLES && *cnt < target; i += TEST_STEP) {
+        HOSTSIM_Step(TEST_STEP);
+    }
+}
+
+static BASE_StatusType TEST_UartInit(UART_Transmit_Mode txMode)
+{
+    g_uart.baseAddress = UART0;
+    HAL_UART_DeInit(&g_uart);
+    g_uart.baudRate = 115200;   /* 115200 bit/s */
+    g_uart.dataLength = UART_DATALENGTH_8BIT;
+    g_uart.stopBits = UART_STOPBITS_ONE;
+    g_uart.parity = UART_PARITY_NONE;
+    g_uart.txMode = txMode;
+    g_uart.rxMode = UART_MODE_INTERRUPT;
+    g_uart.fifoMode = true;
+    g_uart.fifoTxThr = UART_FIFODEPTH_SIZE4;
+    g_uart.fifoRxThr = UART_FIFODEPTH_SIZE8;
+    g_uart.hwFlowCtr = UART_HW_FLOWCTR_DISABLE;
+    g_uart.handleEx.overSampleMultiple = UART_OVERSAMPLING_16X;
+    g_uart.dmaHandle = &g_dma;
+    g_uart.uartDmaTxChn = TEST_DMA_CHANNEL;
+    return HAL_UART_Init(&g_uart);
+}
+
+static void TEST_Rx(void)
+{
+    unsigned char data[TEST_RX_LEN];
+    for (unsigned int i = 0; i < TEST_RX_LEN; i++) {
+        data[i] = (unsigned char)(0xA0U + i);
+    }
+    TEST_Check(HAL_UART_ReadIT(&g_uart, g_rxBuf, TEST_RX_LEN) == BASE_STATUS_OK, "read start", 0);
+    TEST_Check(HOSTSIM_UartInject(g_uartSim, data, TEST_RX_LEN) == TEST_RX_LEN, "bytes injected", TEST_RX_LEN);
+    TEST_RunUntil(&g_readCnt, 1, 2 * TEST_RX_LEN);
+    TEST_Check(g_readCnt == 1, "read callbacks", g_readCnt);
+    TEST_Check(memcmp(g_rxBuf, data, TEST_RX_LEN) == 0, "bytes received", TEST_RX_LEN);
+    TEST_Check(g_uart.rxState == UART_STATE_READY, "rx ready", g_uart.rxState);
+}
+
+static void TEST_TxIt(void)
+{
+    unsigned char wire[TEST_DMA_TX_LEN];
+    for (unsigned int i = 0; i < TEST_TX_LEN; i++) {
+        g_txBuf[i] = (unsigned char)(0x30U + i);
+    }
+    TEST_Check(HAL_UART_WriteIT(&g_uart, g_txBuf, TEST_TX_LEN) == BASE_STATUS_OK, "write start", 0);
+    TEST_RunUntil(&g_writeCnt, 1, 2 * TEST_TX_LEN);
+    TEST_Check(g_writeCnt == 1, "write callbacks", g_writeCnt);
+    /* The callback comes with the last byte in the FIFO, HAL_UART_Init() waits for the wire to go idle */
+    TEST_Run(TEST_FIFO_DEPTH);
+    TEST_Check(UART0->UART_FR.BIT.busy == 0, "tx idle", 0);
+    unsigned int len = HOSTSIM_UartTake(g_uartSim, wire, sizeof(wire));
+    TEST_Check(len == TEST_TX_LEN && memcmp(wire, g_txBuf, TEST_TX_LEN) == 0, "bytes sent", len);
+}
+
+static void TEST_TxDma(void)
+{
+    unsigned char wire[TEST_DMA_TX_LEN];
+    DMA_ChannelParam param = {
+        .srcPeriph = DMA_REQUEST_MEM,
+        .destPeriph = DMA_REQUEST_UART0_TX,
+        .direction = DMA_MEMORY_TO_PERIPH_BY_DMAC,
+        .srcAddrInc = DMA_ADDR_INCREASE,
+        .destAddrInc = DMA_ADDR_UNALTERED,
+        .srcBurst = DMA_BURST_LENGTH_1,
+        .destBurst = DMA_BURST_LENGTH_1,
+        .srcWidth = DMA_TRANSWIDTH_BYTE,
+        .destWidth = DMA_TRANSWIDTH_BYTE,
+        .pHandle = &g_uart,
+    };
+    for (unsigned int i = 0; i < TEST_DMA_TX_LEN; i++) {
+        g_txBuf[i] = (unsigned char)(i * 3U);
+    }
+    g_dma.baseAddress = DMA;
+    TEST_Check(HAL_DMA_Init(&g_dma) == BASE_STATUS_OK, "dma init", 0);
+    TEST_Check(HAL_DMA_InitChannel(&g_dma, &param, TEST_DMA_CHANNEL) == BASE_STATUS_OK, "dma channel init", 0);
+    TEST_Check(TEST_UartInit(UART_MODE_DMA) == BASE_STATUS_OK, "dma mode init", 0);
+    HAL_UART_RegisterCallBack(&g_uart, UART_WRITE_DMA_FINISH, TEST_DmaWriteCallback);
+    HOSTSIM_ClearStat();
+    TEST_Check(HAL_UART_WriteDMA(&g_uart, g_txBuf, TEST_DMA_TX_LEN) == BASE_STATUS_OK, "dma write start", 0);
+    TEST_RunUntil(&g_dmaWriteCnt, 1, 2 * TEST_DMA_TX_LEN);
+    TEST_Check(g_dmaWriteCnt == 1, "dma write callbacks", g_dmaWriteCnt);
+    unsigned int len = HOSTSIM_UartTake(g_uartSim, wire, sizeof(wire));
+    TEST_Check(len == TEST_DMA_TX_LEN && memcmp(wire, g_txBuf, TEST_DMA_TX_LEN) == 0, "dma bytes sent", len);
+    HOSTSIM_IrqStat irqStat;
+    HOSTSIM_GetIrqStat(IRQ_DMA_TC, &irqStat);
+    TEST_Check(irqStat.runCnt == 1, "dma TC handler calls", irqStat.runCnt);
+    HOSTSIM_GetIrqStat(IRQ_UART0, &irqStat);
+    TEST_Check(irqStat.runCnt == 0, "uart handler calls in dma mode", irqStat.runCnt);
+}
+
+int main(void)
+{
+    HOSTSIM_IrqStat irqStat;
+    if (HOSTSIM_Init() != 0) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    g_uartSim = HOSTSIM_UartAdd(UART0_BASE, IRQ_UART0, DMA_REQUEST_UART0_TX, DMA_REQUEST_UART0_RX,
+                                TEST_CHAR_CYCLES);
+    if (g_uartSim == NULL || HOSTSIM_DmaAdd(DMA_BASE, IRQ_DMA_TC, IRQ_DMA_ERR) == NULL) {
+        printf("hostsim setup failed\n");
+        return 1;
+    }
+    HOSTSIM_IrqConnect(IRQ_UART0, HAL_UART_IrqHandler, &g_uart);
+    HOSTSIM_IrqConnect(IRQ_DMA_TC, HAL_DMA_IrqHandlerTc, &g_dma);
+    /* Interrupt mode: the FIFO threshold and the RX timeout move the bytes into the buffer */
+    TEST_Check(TEST_UartInit(UART_MODE_INTERRUPT) == BASE_STATUS_OK, "interrupt mode init", 0);
+    HAL_UART_RegisterCallBack(&g_uart, UART_READ_IT_FINISH, TEST_ReadCallback);
+    HAL_UART_RegisterCallBack(&g_uart, UART_WRITE_IT_FINISH, TEST_WriteCallback);
+    HOSTSIM_ClearStat();
+    TEST_Rx();
+    TEST_TxIt();
+    HOSTSIM_GetIrqStat(IRQ_UART0, &irqStat);
+    TEST_Check(irqStat.runCnt > 0, "uart handler calls", irqStat.runCnt);
+    TEST_Check(irqStat.stuckCnt == 0, "stuck interrupt line", irqStat.stuckCnt);
+    /* DMA mode: the TX request line feeds the FIFO, the completion comes from the DMA TC interrupt */
+    TEST_TxDma();
+    printf("%s\n", (g_failCnt == 0) ? "PASS" : "FAIL");
+    return (g_failCnt == 0) ? 0 : 1;
+}
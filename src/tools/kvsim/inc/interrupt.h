@@ -15,29 +15,22 @@
   * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
   * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
   * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  * @file      mcs_prot_cmm.c
-  * @author    MCU Algorithm Team
-  * @brief     This file contains protection common api definition.
+  * @file      interrupt.h
+  * @brief     kvsim使用的interrupt.h主机替身
+  * @details   先包含驱动的interrupt.h，再把RISC-V CSR访问宏替换为主机实现：主机上没有中断，
+  *            flash_kv.c的临界区只需保持读mstatus、清MIE、按需置MIE的调用顺序。
+  *            kvsim的Makefile把本目录放在驱动头文件目录之前。
   */
- 
-/* Includes ------------------------------------------------------------------------------------ */
-#include "mcs_prot_cmm.h"
-#include "apt.h"
-#include "mcs_assert.h"
+#ifndef McuMagicTag_KVSIM_INTERRUPT_H
+#define McuMagicTag_KVSIM_INTERRUPT_H
 
-/**
-  * @brief Safty-pulse-off function execution to turn off all the power devices.
-  * @param aptAddr Three-phase APT address pointer.
-  * @retval None.
-  */
-void ProtSpo_Exec(APT_RegStruct **aptAddr)
-{
-    MCS_ASSERT_PARAM(aptAddr != NULL);
-    /**< Turn off all the six power devices of the inverter. */
-    for (unsigned int i = 0; i < MOTOR_PHASE_NUMBER; i++) {
-        APT_RegStruct *aptx = (APT_RegStruct *)(aptAddr[i]);
-        DCL_APT_EnableSwContPWMAction(aptx, APT_PWM_CHANNEL_A);
-        DCL_APT_EnableSwContPWMAction(aptx, APT_PWM_CHANNEL_B);
-        DCL_APT_ForcePWMOutputLow(aptx);
-    }
-}
\ No newline at end of file
+#include_next "interrupt.h"
+
+#undef READ_CSR
+#undef SET_CSR
+#undef CLEAR_CSR
+#define READ_CSR(csrReg)            MSTATUS_MIE
+#define SET_CSR(csrReg, csrBit)     ((void)(csrBit))
+#define CLEAR_CSR(csrReg, csrBit)   ((void)(csrBit))
+
+#endif /* McuMagicTag_KVSIM_INTERRUPT_H */
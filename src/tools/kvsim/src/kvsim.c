@@ -0,0 +1,510 @@
+/**
+  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      kvsim.c
+  * @brief     FLASH键值存储的主机掉电测试
+  * @details   在主机上编译drivers/flash/flash_v1/src/flash_kv.c与软件CRC，用内存中的NOR flash模型代替
+  *            HAL_FLASH_WriteIT/EraseIT和作业队列接口：编程只允许写入已擦除的字节，擦除把整页置为0xFF。
+  *            随机写入、删除和读回键值，并在随机的编程或擦除中途掉电：写入只完成随机长度的前缀，擦除只
+  *            恢复部分比特，随后重新挂载存储。参考模型记录每个键提交的版本和最后一次回调确认的版本，
+  *            重新挂载后读到的值必须是确认版本或其后提交的版本。分别以直接中断方式和挂接作业队列方式运行，
+  *            作业队列方式中插入其他用户作业的完成事件。全部检查通过时返回0。
+  *            用法: kvsim [随机种子] [轮数]
+  */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "flash_ex.h"
+
+#define SIM_BASE_ADDR       0x8000U     /* 存储所在的flash PE地址，页对齐 */
+#define SIM_PAGE_NUM        4U
+#define SIM_SIZE            (SIM_PAGE_NUM * FLASH_ONE_PAGE_SIZE)
+#define SIM_MAP_SIZE        0x1000U     /* 主机映射按4K对齐 */
+#define SIM_KEY_NUM         12U
+#define SIM_DATA_LEN_MAX    40U
+#define SIM_VER_NUM         64U         /* 每个键保留的未确认版本数，大于队列能容纳的记录数 */
+#define SIM_PEND_NUM        256U
+#define SIM_CUT_RATE        150U        /* 平均每SIM_CUT_RATE轮安排一次掉电 */
+#define SIM_ROUND_DEFAULT   20000U
+#define SIM_FOREIGN_ADDR    0x1000U     /* 作业队列中其他用户作业的目的地址，不在存储范围内 */
+#define SIM_CRC32_CHECK     0x340BC6D9U /* "123456789"的CRC-32在取反之前的值 */
+
+/* 主机地址，驱动的uintptr_t为32位 */
+typedef unsigned long SIM_Addr;
+
+typedef enum {
+    SIM_OP_NONE,
+    SIM_OP_WRITE,
+    SIM_OP_ERASE,
+} SIM_OpType;
+
+typedef struct {
+    bool present;
+    unsigned int len;
+    unsigned char data[SIM_DATA_LEN_MAX];
+} SIM_Value;
+
+/* 键的版本环: [ack, next)为允许在掉电后出现的版本，ack为最后一次确认的版本 */
+typedef struct {
+    SIM_Value ver[SIM_VER_NUM];
+    unsigned int ack;
+    unsigned int next;
+} SIM_Key;
+
+typedef struct {
+    unsigned int key;
+    unsigned int ver;
+} SIM_Pend;
+
+typedef struct {
+    unsigned long opCnt;
+    unsigned int cutCnt;
+    unsigned int foreignCnt;
+    unsigned int readCnt;
+    unsigned int compactCnt;    /* 各次挂载的存储统计之和 */
+    unsigned int eraseCnt;
+    unsigned int crcErrCnt;
+    unsigned int failCnt;
+} SIM_Stat;
+
+static unsigned char *g_simFlash;
+static FLASH_Handle g_simHandle;
+static FLASH_JobQueue g_simJobQueue;
+static FLASH_CallbackFunType g_simCallback;
+static SIM_OpType g_simOp;
+static unsigned int g_simSrc;
+static unsigned int g_simDst;
+static unsigned int g_simLen;
+static unsigned long g_simCutAt;       /* 在第几次操作中掉电，0表示不掉电 */
+static bool g_simDead;
+static CRC_SoftHandle g_simCrc;
+static FLASH_KvStore g_simKv;
+static SIM_Key g_simKey[SIM_KEY_NUM];
+static SIM_Pend g_simPend[SIM_PEND_NUM];
+static unsigned int g_simPendHead;
+static unsigned int g_simPendTail;
+static SIM_Stat g_simStat;
+
+#define SIM_FAIL(...) do { \
+        printf(__VA_ARGS__); \
+        g_simStat.failCnt++; \
+    } while (0)
+
+void AssertErrorLog(char *file, unsigned int line)
+{
+    printf("FAIL: assert %s:%u\n", file, line);
+    exit(1);
+}
+
+/* ---------------- flash模型 ---------------- */
+
+BASE_StatusType HAL_FLASH_RegisterCallback(FLASH_Handle *handle, FLASH_CallbackFunType pcallback)
+{
+    (void)handle;
+    g_simCallback = pcallback;
+    return BASE_STATUS_OK;
+}
+
+static BASE_StatusType SimStart(SIM_OpType op, unsigned int src, unsigned int dst, unsigned int len)
+{
+    if (g_simOp != SIM_OP_NONE) {
+        SIM_FAIL("FAIL: operation started while another one is pending\n");
+        return BASE_STATUS_BUSY;
+    }
+    if (dst < SIM_BASE_ADDR || dst + len > SIM_BASE_ADDR + SIM_SIZE || (dst % FLASH_MIN_PGM_BYTES_SIZE) != 0 ||
+        (len % FLASH_MIN_PGM_BYTES_SIZE) != 0 || len == 0) {
+        SIM_FAIL("FAIL: operation 0x%x+%u outside the store or misaligned\n", dst, len);
+        return BASE_STATUS_ERROR;
+    }
+    g_simOp = op;
+    g_simSrc = src;
+    g_simDst = dst;
+    g_simLen = len;
+    return BASE_STATUS_OK;
+}
+
+static BASE_StatusType SimDirect(FLASH_Handle *handle)
+{
+    if (handle->handleEx.jobQueue != NULL) {
+        SIM_FAIL("FAIL: direct operation while a job queue is attached\n");
+        return BASE_STATUS_ERROR;
+    }
+    return BASE_STATUS_OK;
+}
+
+static BASE_StatusType SimJob(FLASH_Handle *handle, unsigned int flags, unsigned int *jobId)
+{
+    if (handle->handleEx.jobQueue == NULL || flags != 0 || jobId != NULL) {
+        SIM_FAIL("FAIL: unexpected job submission\n");
+        return BASE_STATUS_ERROR;
+    }
+    return BASE_STATUS_OK;
+}
+
+BASE_StatusType HAL_FLASH_WriteIT(FLASH_Handle *handle, unsigned int srcAddr, unsigned int destAddr,
+                                  unsigned int srcLen)
+{
+    BASE_StatusType ret = SimDirect(handle);
+    return (ret != BASE_STATUS_OK) ? ret : SimStart(SIM_OP_WRITE, srcAddr, destAddr, srcLen);
+}
+
+BASE_StatusType HAL_FLASH_EraseIT(FLASH_Handle *handle, FLASH_EraseMode eraseMode, FLASH_SectorAddr startAddr,
+                                  unsigned int eraseNum)
+{
+    BASE_StatusType ret = SimDirect(handle);
+    if (eraseMode != FLASH_ERASE_MODE_PAGE) {
+        SIM_FAIL("FAIL: erase mode %d\n", (int)eraseMode);
+        return BASE_STATUS_ERROR;
+    }
+    return (ret != BASE_STATUS_OK) ? ret :
+           SimStart(SIM_OP_ERASE, 0, (unsigned int)startAddr, eraseNum * FLASH_ONE_PAGE_SIZE);
+}
+
+BASE_StatusType HAL_FLASH_JobWriteEx(FLASH_Handle *handle, unsigned int srcAddr, unsigned int destAddr,
+                                     unsigned int srcLen, unsigned int flags, unsigned int *jobId)
+{
+    BASE_StatusType ret = SimJob(handle, flags, jobId);
+    return (ret != BASE_STATUS_OK) ? ret : SimStart(SIM_OP_WRITE, srcAddr, destAddr, srcLen);
+}
+
+BASE_StatusType HAL_FLASH_JobEraseEx(FLASH_Handle *handle, FLASH_SectorAddr startAddr, unsigned int eraseNum,
+                                     unsigned int flags, unsigned int *jobId)
+{
+    BASE_StatusType ret = SimJob(handle, flags, jobId);
+    return (ret != BASE_STATUS_OK) ? ret :
+           SimStart(SIM_OP_ERASE, 0, (unsigned int)startAddr, eraseNum * FLASH_ONE_PAGE_SIZE);
+}
+
+/* 掉电时的操作：写入随机长度的前缀并使下一个字节部分编程，或只恢复擦除区域中的部分比特 */
+static void SimTear(unsigned char *dst, const unsigned char *src)
+{
+    unsigned int done;
+    unsigned int i;
+    if (g_simOp == SIM_OP_WRITE) {
+        done = (unsigned int)rand() % (g_simLen + 1);
+        for (i = 0; i < done; i++) {
+            dst[i] &= src[i];
+        }
+        if (done < g_simLen) {
+            dst[done] &= (unsigned char)(src[done] | (unsigned int)rand());
+        }
+        return;
+    }
+    for (i = 0; i < g_simLen; i++) {
+        dst[i] |= (unsigned char)rand();
+    }
+}
+
+/* 完成当前操作并在flash中断中上报，作业队列方式下先插入其他用户作业的完成事件 */
+static void SimFlashStep(void)
+{
+    unsigned char *dst = g_simFlash + (g_simDst - SIM_BASE_ADDR);
+    const unsigned char *src = (const unsigned char *)(SIM_Addr)g_simSrc;
+    SIM_OpType op = g_simOp;
+    unsigned int i;
+
+    if (op == SIM_OP_NONE) {
+        return;
+    }
+    if (g_simHandle.handleEx.jobQueue != NULL && rand() % 4 == 0) {
+        g_simStat.foreignCnt++;
+        g_simCallback(&g_simHandle, (rand() % 2 == 0) ? FLASH_WRITE_EVENT_DONE : FLASH_ERASE_EVENT_FAIL,
+                      SIM_FOREIGN_ADDR);
+    }
+    g_simStat.opCnt++;
+    if (g_simStat.opCnt == g_simCutAt) {
+        SimTear(dst, src);
+        g_simOp = SIM_OP_NONE;
+        g_simDead = true;
+        return;
+    }
+    for (i = 0; i < g_simLen; i++) {
+        if (op == SIM_OP_ERASE) {
+            dst[i] = 0xFF;
+        } else if (dst[i] != 0xFF) {
+            SIM_FAIL("FAIL: program over a programmed byte at 0x%x\n", g_simDst + i);
+            break;
+        } else {
+            dst[i] = src[i];
+        }
+    }
+    g_simOp = SIM_OP_NONE;
+    g_simCallback(&g_simHandle, (op == SIM_OP_WRITE) ? FLASH_WRITE_EVENT_DONE : FLASH_ERASE_EVENT_DONE, g_simDst);
+}
+
+/* ---------------- 参考模型 ---------------- */
+
+static void SimKvCallback(FLASH_KvStore *kv, unsigned int key, BASE_StatusType status)
+{
+    SIM_Pend *pend = &g_simPend[g_simPendHead % SIM_PEND_NUM];
+    (void)kv;
+    if (g_simPendHead == g_simPendTail || pend->key != key) {
+        SIM_FAIL("FAIL: completion of key %u out of order\n", key);
+        return;
+    }
+    g_simPendHead++;
+    if (status != BASE_STATUS_OK) {
+        SIM_FAIL("FAIL: record of key %u dropped\n", key);
+        return;
+    }
+    g_simKey[key].ack = pend->ver;
+}
+
+static bool SimValueSame(const SIM_Value *ref, BASE_StatusType ret, const unsigned char *data, unsigned int len)
+{
+    if (!ref->present) {
+        return ret != BASE_STATUS_OK;
+    }
+    return ret == BASE_STATUS_OK && len == ref->len && memcmp(data, ref->data, len) == 0;
+}
+
+/* 读回一个键并与最新提交的版本比较 */
+static void SimCheckNewest(unsigned int key)
+{
+    unsigned char data[FLASH_KV_DATA_MAX];
+    unsigned int len = 0;
+    BASE_StatusType ret = HAL_FLASH_KvReadEx(&g_simKv, key, data, sizeof(data), &len);
+    const SIM_Key *ref = &g_simKey[key];
+    g_simStat.readCnt++;
+    if (!SimValueSame(&ref->ver[(ref->next - 1) % SIM_VER_NUM], ret, data, len)) {
+        SIM_FAIL("FAIL: key %u does not read back its newest value\n", key);
+    }
+}
+
+static void SimSubmit(unsigned int key)
+{
+    SIM_Key *ref = &g_simKey[key];
+    SIM_Value *val = &ref->ver[ref->next % SIM_VER_NUM];
+    BASE_StatusType ret;
+    unsigned int i;
+
+    if (ref->next - ref->ack >= SIM_VER_NUM || g_simPendTail - g_simPendHead >= SIM_PEND_NUM) {
+        return;
+    }
+    val->present = (rand() % 8 != 0);
+    val->len = val->present ? (unsigned int)rand() % (SIM_DATA_LEN_MAX + 1) : 0;
+    for (i = 0; i < val->len; i++) {
+        val->data[i] = (unsigned char)rand();
+    }
+    ret = val->present ? HAL_FLASH_KvWriteEx(&g_simKv, key, val->data, val->len) :
+                         HAL_FLASH_KvDeleteEx(&g_simKv, key);
+    if (ret == BASE_STATUS_BUSY) {
+        return; /* 队列已满，记录未提交 */
+    }
+    if (ret != BASE_STATUS_OK) {
+        SIM_FAIL("FAIL: write of key %u returned %d\n", key, (int)ret);
+        return;
+    }
+    g_simPend[g_simPendTail % SIM_PEND_NUM].key = key;
+    g_simPend[g_simPendTail % SIM_PEND_NUM].ver = ref->next;
+    g_simPendTail++;
+    ref->next++;
+    SimCheckNewest(key);
+}
+
+/* 存储统计在挂载时清零，卸载前累加 */
+static void SimUnmount(void)
+{
+    FLASH_KvStat stat;
+    HAL_FLASH_KvGetStatEx(&g_simKv, &stat);
+    g_simStat.compactCnt += stat.compactCnt;
+    g_simStat.eraseCnt += stat.eraseCnt;
+    g_simStat.crcErrCnt += stat.crcErrCnt;
+}
+
+static void SimMount(void)
+{
+    memset(&g_simKv, 0, sizeof(g_simKv));
+    if (HAL_FLASH_KvInitEx(&g_simKv, &g_simHandle, &g_simCrc, SIM_BASE_ADDR, SIM_PAGE_NUM) != BASE_STATUS_OK) {
+        SIM_FAIL("FAIL: mount\n");
+    }
+    HAL_FLASH_KvRegisterCallbackEx(&g_simKv, SimKvCallback);
+}
+
+/* 掉电后重新挂载：每个键必须是已确认的版本或其后提交的版本，读到的版本成为新的已确认版本 */
+static void SimPowerCycle(void)
+{
+    unsigned char data[FLASH_KV_DATA_MAX];
+    unsigned int len = 0;
+    unsigned int key;
+    unsigned int ver;
+    BASE_StatusType ret;
+    SIM_Key *ref = NULL;
+
+    g_simStat.cutCnt++;
+    g_simDead = false;
+    g_simCutAt = 0;
+    g_simPendHead = g_simPendTail;
+    SimUnmount();
+    SimMount();
+    for (key = 0; key < SIM_KEY_NUM; key++) {
+        ref = &g_simKey[key];
+        ret = HAL_FLASH_KvReadEx(&g_simKv, key, data, sizeof(data), &len);
+        for (ver = ref->next; ver > ref->ack; ver--) {
+            if (SimValueSame(&ref->ver[(ver - 1) % SIM_VER_NUM], ret, data, len)) {
+                break;
+            }
+        }
+        if (ver == ref->ack) {
+            SIM_FAIL("FAIL: key %u lost its acknowledged value after power cut %u\n", key, g_simStat.cutCnt);
+            ver = ref->next;
+        }
+        ref->ver[ref->next % SIM_VER_NUM] = ref->ver[(ver - 1) % SIM_VER_NUM];
+        ref->ack = ref->next;
+        ref->next++;
+    }
+}
+
+static void SimDrain(void)
+{
+    while (g_simOp != SIM_OP_NONE) {
+        SimFlashStep();
+    }
+    if (!HAL_FLASH_KvIsIdleEx(&g_simKv) || g_simPendHead != g_simPendTail) {
+        SIM_FAIL("FAIL: store not idle after draining\n");
+    }
+}
+
+/* 与flash_kv.c无关的按位CRC-32，确认记录格式与替换前的查表实现一致 */
+static unsigned int SimCrc32(unsigned int crc, const unsigned char *data, unsigned int len)
+{
+    unsigned int i;
+    unsigned int bit;
+    for (i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (bit = 0; bit < 8; bit++) { /* 8: bits of a byte */
+            crc = (crc >> 1) ^ (((crc & 1U) != 0) ? 0xEDB88320U : 0U);
+        }
+    }
+    return crc;
+}
+
+static void SimCheckFormat(void)
+{
+    const unsigned int *head = NULL;
+    unsigned int page;
+    unsigned int active = 0;
+
+    if (HAL_CRC_SoftUpdateEx(&g_simCrc, HAL_CRC_SoftStartEx(&g_simCrc), "123456789", 9) != SIM_CRC32_CHECK ||
+        SimCrc32(0xFFFFFFFFU, (const unsigned char *)"123456789", 9) != SIM_CRC32_CHECK) {
+        SIM_FAIL("FAIL: CRC-32 check value\n");
+    }
+    for (page = 0; page < SIM_PAGE_NUM; page++) {
+        head = (const unsigned int *)(const void *)(g_simFlash + page * FLASH_ONE_PAGE_SIZE);
+        if (g_simKv.page[page].state != FLASH_KV_PAGE_ACTIVE) {
+            continue;
+        }
+        active++;
+        if (SimCrc32(0xFFFFFFFFU, (const unsigned char *)head, 12) != head[3]) { /* 12: CRC span, 3: CRC word */
+            SIM_FAIL("FAIL: page %u header CRC differs from the store format\n", page);
+        }
+    }
+    if (active == 0) {
+        SIM_FAIL("FAIL: no active page\n");
+    }
+}
+
+static void SimRun(const char *name, bool jobQueue, unsigned int rounds)
+{
+    FLASH_KvStat stat;
+    unsigned int round;
+    unsigned int key;
+    unsigned int step;
+
+    memset(g_simFlash, 0xFF, SIM_MAP_SIZE);
+    memset(g_simKey, 0, sizeof(g_simKey));
+    memset(&g_simStat, 0, sizeof(g_simStat));
+    for (key = 0; key < SIM_KEY_NUM; key++) {
+        g_simKey[key].next = 1; /* 版本0: 空存储中不存在 */
+    }
+    g_simPendHead = 0;
+    g_simPendTail = 0;
+    g_simOp = SIM_OP_NONE;
+    g_simCutAt = 0;
+    g_simDead = false;
+    memset(&g_simHandle, 0, sizeof(g_simHandle));
+    g_simHandle.baseAddress = EFC;
+    g_simHandle.peMode = FLASH_PE_OP_IT;
+    g_simHandle.state = FLASH_STATE_READY;
+    g_simHandle.handleEx.jobQueue = jobQueue ? &g_simJobQueue : NULL;
+    SimMount();
+
+    for (round = 0; round < rounds; round++) {
+        if (g_simCutAt == 0 && rand() % SIM_CUT_RATE == 0) {
+            g_simCutAt = g_simStat.opCnt + 1 + (unsigned long)(rand() % 4); /* 4: within the next operations */
+        }
+        key = (unsigned int)rand() % SIM_KEY_NUM;
+        if (rand() % 8 == 0) {
+            SimCheckNewest(key);
+        } else {
+            SimSubmit(key);
+        }
+        for (step = (unsigned int)rand() % 3; step > 0 && !g_simDead; step--) { /* 3: 0 to 2 operations per round */
+            SimFlashStep();
+        }
+        if (g_simDead) {
+            SimPowerCycle();
+        }
+    }
+    g_simCutAt = 0;
+    SimDrain();
+    SimCheckFormat();
+    for (key = 0; key < SIM_KEY_NUM; key++) {
+        SimCheckNewest(key);
+    }
+    /* 正常下电后重新挂载，所有键保持最新值 */
+    SimUnmount();
+    SimMount();
+    SimDrain();
+    for (key = 0; key < SIM_KEY_NUM; key++) {
+        SimCheckNewest(key);
+    }
+
+    SimUnmount();
+    HAL_FLASH_KvGetStatEx(&g_simKv, &stat);
+    printf("%-6s ops %lu cuts %u foreign %u reads %u | compact %u erase %u crcErr %u wear %u..%u\n", name,
+           g_simStat.opCnt, g_simStat.cutCnt, g_simStat.foreignCnt, g_simStat.readCnt, g_simStat.compactCnt,
+           g_simStat.eraseCnt, g_simStat.crcErrCnt, stat.minPageErase, stat.maxPageErase);
+    if (g_simStat.cutCnt == 0 || g_simStat.compactCnt == 0 || (jobQueue && g_simStat.foreignCnt == 0)) {
+        SIM_FAIL("FAIL: %s run did not reach power cuts, compaction or foreign jobs\n", name);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int seed = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 0) : 1U;
+    unsigned int rounds = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : SIM_ROUND_DEFAULT;
+    unsigned int failCnt = 0;
+    void *map = mmap((void *)(SIM_Addr)(FLASH_READ_BASE + SIM_BASE_ADDR), SIM_MAP_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (map != (void *)(SIM_Addr)(FLASH_READ_BASE + SIM_BASE_ADDR)) {
+        printf("FAIL: cannot map the flash read window at 0x%x\n", FLASH_READ_BASE + SIM_BASE_ADDR);
+        return 1;
+    }
+    g_simFlash = (unsigned char *)map;
+    HAL_CRC_SoftInitEx(&g_simCrc, CRC32, 4); /* 4: slicing-by-4 */
+    srand(seed);
+    SimRun("direct", false, rounds);
+    failCnt += g_simStat.failCnt;
+    SimRun("job", true, rounds);
+    failCnt += g_simStat.failCnt;
+    printf("%s\n", (failCnt == 0) ? "PASS" : "FAIL");
+    return (failCnt == 0) ? 0 : 1;
+}
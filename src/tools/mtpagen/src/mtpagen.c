@@ -0,0 +1,207 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      mtpagen.c
+  * @author    MCU Algorithm Team
+  * @brief     Host generator and check of the MTPA and Flux-Weakening lookup table.
+  * @details   The table of mcs_mtpa_lut.c is built from the motor parameters, optionally printed as a const
+  *            MTPA_Lut initializer for a table generated offline, and the bilinear lookup of MTPA_Exec is compared
+  *            with the exact solution of MTPA_PointCalc on a fine grid: torque error, stator voltage above the
+  *            limit, and the copper loss against id = 0 control where both are inside the limits.
+  *            Usage: mtpagen [-c] [-p polePairs] [-d ldMh] [-q lqMh] [-f psifWb] [-i currMaxA] [-r voltRatio]
+  *                           [-s maxSpdHz] [-u udcMinV]
+  */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mcs_mtpa_lut.h"
+#include "mcs_math.h"
+
+#define GEN_CHECK_NUM   200U    /* Check points per axis */
+
+/* Host versions of the mcs_math.c functions used here, mcs_math.c needs the RISC-V float instructions. */
+float Sqrt(float val)
+{
+    return sqrtf(val);
+}
+
+float Abs(float val)
+{
+    return fabsf(val);
+}
+
+float Max(float val1, float val2)
+{
+    return (val1 > val2) ? val1 : val2;
+}
+
+float Min(float val1, float val2)
+{
+    return (val1 < val2) ? val1 : val2;
+}
+
+typedef struct {
+    MOTOR_Param param;
+    float currMax;
+    float voltRatio;
+    float maxSpd;
+    float udcMin;
+    bool printTable;
+} GEN_Config;
+
+static int GenParseArgs(int argc, char **argv, GEN_Config *cfg)
+{
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0) {
+            cfg->printTable = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return -1;
+        }
+        float val = strtof(argv[++i], NULL);
+        switch (argv[i - 1][0] == '-' ? argv[i - 1][1] : 0) {
+            case 'p':
+                cfg->param.mtrNp = (unsigned short)val;
+                break;
+            case 'd':
+                cfg->param.mtrLd = val * 1e-3f;
+                break;
+            case 'q':
+                cfg->param.mtrLq = val * 1e-3f;
+                break;
+            case 'f':
+                cfg->param.mtrPsif = val;
+                break;
+            case 'i':
+                cfg->currMax = val;
+                break;
+            case 'r':
+                cfg->voltRatio = val;
+                break;
+            case 's':
+                cfg->maxSpd = val;
+                break;
+            case 'u':
+                cfg->udcMin = val;
+                break;
+            default:
+                return -1;
+        }
+    }
+    return (cfg->param.mtrNp > 0 && cfg->param.mtrPsif > 0.0f && cfg->currMax > 0.0f && cfg->voltRatio > 0.0f &&
+            cfg->voltRatio <= 1.0f && cfg->maxSpd > 0.0f && cfg->udcMin > 0.0f) ? 0 : -1;
+}
+
+static void GenPrintTable(const MTPA_Lut *lut)
+{
+    printf("static const MTPA_Lut g_mtpaLut = {\n    .point = {\n");
+    for (unsigned int i = 0; i < MTPA_LUT_TRQ_NUM; i++) {
+        printf("        {");
+        for (unsigned int j = 0; j < MTPA_LUT_SPD_NUM; j++) {
+            printf("{%.4ff, %.4ff}", lut->point[i][j].d, lut->point[i][j].q);
+            if (j + 1 < MTPA_LUT_SPD_NUM) {
+                printf((j % 4 == 3) ? ",\n         " : ", ");
+            }
+        }
+        printf("},\n");
+    }
+    printf("    },\n    .limitMask = {");
+    for (unsigned int i = 0; i < MTPA_LUT_TRQ_NUM; i++) {
+        printf("%s0x%03XU", (i == 0) ? "" : ", ", lut->limitMask[i]);
+    }
+    printf("},\n    .trqMax = %.5ff,\n    .spdPerVoltMax = %.6ff,\n};\n", lut->trqMax, lut->spdPerVoltMax);
+}
+
+/* Compare the lookup with the exact solution, return the number of lookups above the voltage limit by > 1%. */
+static unsigned int GenCheck(const MTPA_Model *model, const MTPA_Lut *lut, float udc)
+{
+    MTPA_Handle mtpa;
+    MTPA_Init(&mtpa, lut);
+    unsigned int inside = 0, limit = 0, overVolt = 0, lossNum = 0;
+    float maxTrqErr = 0.0f, maxFluxOver = 0.0f;
+    double lossMtpa = 0.0, lossIdZero = 0.0;
+    for (unsigned int a = 0; a <= GEN_CHECK_NUM; a++) {
+        float trq = lut->trqMax * (float)a / GEN_CHECK_NUM;
+        for (unsigned int b = 0; b <= GEN_CHECK_NUM; b++) {
+            float spdPerVolt = lut->spdPerVoltMax * (float)b / GEN_CHECK_NUM;
+            DqAxis exact, look;
+            bool ok = MTPA_PointCalc(model, trq, spdPerVolt, &exact);
+            bool lookOk = MTPA_Exec(&mtpa, trq, spdPerVolt * udc, udc, &look);
+            if (!ok || !lookOk) {
+                limit++;
+                continue;
+            }
+            inside++;
+            float trqLook = model->trqCoeff * (model->psif + (model->ld - model->lq) * look.d) * look.q;
+            maxTrqErr = fmaxf(maxTrqErr, fabsf(trqLook - trq) / lut->trqMax);
+            /* Stator flux of the lookup against the limit at this speed */
+            float fluxD = model->ld * look.d + model->psif;
+            float fluxQ = model->lq * look.q;
+            float fluxMax = (spdPerVolt > 0.0f) ? model->fluxCoeff / spdPerVolt : INFINITY;
+            float over = sqrtf(fluxD * fluxD + fluxQ * fluxQ) / fluxMax - 1.0f;
+            maxFluxOver = fmaxf(maxFluxOver, over);
+            overVolt += (over > 0.01f) ? 1 : 0;
+            /* id = 0 control: iq = trq / (1.5 * Np * psif), only where it meets both limits */
+            float iqZero = trq / (model->trqCoeff * model->psif);
+            float fluxZero = sqrtf(model->psif * model->psif + model->lq * model->lq * iqZero * iqZero);
+            if (trq > 0.0f && iqZero <= model->currMax && fluxZero <= fluxMax) {
+                lossMtpa += look.d * look.d + look.q * look.q;
+                lossIdZero += iqZero * iqZero;
+                lossNum++;
+            }
+        }
+    }
+    printf("check %u points: %u inside the limits, %u on the limit (FW_Exec acts)\n", inside + limit, inside, limit);
+    printf("lookup torque error max %.2f%% of trqMax, stator voltage above the limit max %.2f%%, %u points > 1%%\n",
+           maxTrqErr * 100.0f, fmaxf(maxFluxOver, 0.0f) * 100.0f, overVolt);
+    if (lossNum > 0) {
+        printf("copper loss against id = 0 over %u points: %.1f%%\n", lossNum, 100.0 * lossMtpa / lossIdZero);
+    }
+    return overVolt;
+}
+
+int main(int argc, char **argv)
+{
+    /* Default: interior permanent magnet compressor motor */
+    GEN_Config cfg = {
+        .param = {.mtrNp = 3, .mtrLd = 8e-3f, .mtrLq = 18e-3f, .mtrPsif = 0.12f},
+        .currMax = 10.0f,
+        .voltRatio = 0.95f,
+        .maxSpd = 300.0f,
+        .udcMin = 300.0f,
+    };
+    if (GenParseArgs(argc, argv, &cfg) != 0) {
+        fprintf(stderr, "usage: mtpagen [-c] [-p polePairs] [-d ldMh] [-q lqMh] [-f psifWb] [-i currMaxA] "
+                "[-r voltRatio] [-s maxSpdHz] [-u udcMinV]\n");
+        return 2;
+    }
+    MTPA_Model model;
+    static MTPA_Lut lut;
+    MTPA_ModelInit(&model, &cfg.param, cfg.currMax, cfg.voltRatio);
+    MTPA_LutBuild(&lut, &model, cfg.maxSpd / cfg.udcMin);
+    if (cfg.printTable) {
+        GenPrintTable(&lut);
+        return 0;
+    }
+    printf("Np %u Ld %.2f mH Lq %.2f mH psif %.4f Wb, Imax %.1f A, %.0f Hz at %.0f V: trqMax %.3f Nm, "
+           "table %ux%u (%u bytes)\n", cfg.param.mtrNp, cfg.param.mtrLd * 1e3f, cfg.param.mtrLq * 1e3f,
+           cfg.param.mtrPsif, cfg.currMax, cfg.maxSpd, cfg.udcMin, lut.trqMax, MTPA_LUT_TRQ_NUM, MTPA_LUT_SPD_NUM,
+           (unsigned int)sizeof(lut));
+    return (GenCheck(&model, &lut, cfg.udcMin) == 0) ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/**
+  * @copyright Copyright (c) 2023, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      nossim.c
+  * @brief     NOS POSIX仿真移植的主机冒烟测试
+  * @details   在虚拟时间上运行三个任务：周期定时器任务、NOS_TaskDelay延时任务和消耗cycle的后台任务，
+  *            检查tick次数、定时器任务和延时任务的执行次数与唤醒时延、后台任务被抢占后仍能推进，
+  *            相同配置下两次运行的调度统计完全一致。全部检查通过时返回0。
+  *            用法: nossim [仿真tick数]
+  */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nos_config.h"
+#include "nos_task.h"
+#include "nos_base_task.h"
+#include "nos_posix_adapter.h"
+
+#define SIM_CYCLE_PER_US    200U    /* 200MHz */
+#define SIM_US_PER_TICK     100U
+#define SIM_CYCLE_PER_TICK  (SIM_CYCLE_PER_US * SIM_US_PER_TICK)
+#define SIM_TIMER_US        500U    /* 定时器任务周期 */
+#define SIM_DELAY_US        1000U   /* 延时任务每次延时 */
+#define SIM_BUSY_STEP       1000U   /* 后台任务每次消耗的cycle */
+#define SIM_WORK_CYCLE      300U    /* 定时器和延时任务每次执行消耗的cycle */
+#define SIM_TICK_DEFAULT    10000U
+#define SIM_STACK_SIZE      OS_TSK_DEFAULT_STACK_SIZE
+
+typedef struct {
+    unsigned int timerCnt;
+    unsigned int delayCnt;
+    unsigned long long busyCnt;
+    unsigned long long delayWakeMax;    /* 延时任务实际唤醒与期望唤醒的最大差值(cycle) */
+    unsigned long long timerGapMax;     /* 相邻两次定时器任务执行的最大间隔(cycle) */
+    unsigned long long timerLast;
+    NOS_SimStat stat;
+} SIM_Result;
+
+/* 任务栈须在4G地址范围内，以-no-pie链接时静态数据满足该条件 */
+static unsigned char g_simStack[3][SIM_STACK_SIZE] __attribute__((aligned(16)));
+static SIM_Result g_simRes;
+
+static void SimTimerTask(void *param)
+{
+    (void)param;
+    unsigned long long now = NOS_GetCycle();
+    if (g_simRes.timerCnt > 0 && now - g_simRes.timerLast > g_simRes.timerGapMax) {
+        g_simRes.timerGapMax = now - g_simRes.timerLast;
+    }
+    g_simRes.timerLast = now;
+    g_simRes.timerCnt++;
+    NOS_SimCycleAdvance(SIM_WORK_CYCLE);
+}
+
+static void SimDelayTask(void *param)
+{
+    (void)param;
+    while (1) {
+        unsigned long long due = NOS_GetCycle() + SIM_DELAY_US * SIM_CYCLE_PER_US;
+        (void)NOS_TaskDelay(SIM_DELAY_US);
+        unsigned long long now = NOS_GetCycle();
+        unsigned long long late = (now > due) ? now - due : 0;
+        g_simRes.delayWakeMax = (late > g_simRes.delayWakeMax) ? late : g_simRes.delayWakeMax;
+        g_simRes.delayCnt++;
+        NOS_SimCycleAdvance(SIM_WORK_CYCLE);
+    }
+}
+
+static void SimBusyTask(void *param)
+{
+    (void)param;
+    while (1) {
+        g_simRes.busyCnt++;
+        NOS_SimCycleAdvance(SIM_BUSY_STEP);
+    }
+}
+
+static int SimRun(unsigned int tickNum, SIM_Result *res)
+{
+    NOS_SysConfig config = {
+        .cyclePerUs = SIM_CYCLE_PER_US,
+        .usecPerTick = SIM_US_PER_TICK,
+        .getTickFunc = NOS_GetCycle,
+    };
+    NOS_TaskInitParam delayParam = {
+        .name = "delay", .taskEntry = SimDelayTask, .priority = 2,
+        .stackAddr = (unsigned int)(uintptr_t)g_simStack[1], .stackSize = SIM_STACK_SIZE,
+    };
+    NOS_TaskInitParam busyParam = {
+        .name = "busy", .taskEntry = SimBusyTask, .priority = 4,
+        .stackAddr = (unsigned int)(uintptr_t)g_simStack[2], .stackSize = SIM_STACK_SIZE,
+    };
+    NOS_TimerTaskInitParam timerParam = {
+        .name = "timer", .timeout = SIM_TIMER_US, .callback = SimTimerTask, .priority = 1,
+        .stackAddr = (unsigned int)(uintptr_t)g_simStack[0], .stackSize = SIM_STACK_SIZE,
+    };
+    unsigned int delayId;
+    unsigned int busyId;
+    unsigned int timerId;
+
+    (void)memset(&g_simRes, 0, sizeof(g_simRes));
+    NOS_SimInit(SIM_CYCLE_PER_TICK, 1ULL + (unsigned long long)tickNum * SIM_CYCLE_PER_TICK);
+    if (NOS_TaskInit(&config) != 0 || NOS_TaskCreate(&delayParam, &delayId) != 0 ||
+        NOS_TaskCreate(&busyParam, &busyId) != 0 || NOS_CreateTimerTask(&timerId, &timerParam) != 0 ||
+        NOS_StartTimerTask(timerId) != 0) {
+        printf("task creation failed\n");
+        return -1;
+    }
+    (void)NOS_StartScheduler();
+    NOS_SimStatGet(&g_simRes.stat);
+    *res = g_simRes;
+    return 0;
+}
+
+static int SimCheck(const char *name, unsigned long long value, unsigned long long min, unsigned long long max)
+{
+    int ok = (value >= min && value <= max);
+    printf("%-28s %10llu  [%llu, %llu] %s\n", name, value, min, max, ok ? "ok" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int tickNum = (argc > 1) ? (unsigned int)atoi(argv[1]) : SIM_TICK_DEFAULT;
+    unsigned long long simUs = (unsigned long long)tickNum * SIM_US_PER_TICK;
+    SIM_Result res;
+    SIM_Result again;
+    int fail = 0;
+
+    if (tickNum < 100 || SimRun(tickNum, &res) != 0) { /* 100: 至少覆盖数个定时器和延时周期 */
+        return 1;
+    }
+    fail += SimCheck("ticks", res.stat.tickCnt, tickNum - 1, tickNum);
+    fail += SimCheck("timer task runs", res.timerCnt, simUs / SIM_TIMER_US - 2, simUs / SIM_TIMER_US);
+    fail += SimCheck("timer period max (cycle)", res.timerGapMax, 0, (SIM_TIMER_US + SIM_US_PER_TICK) *
+                     SIM_CYCLE_PER_US);
+    /* 每次延时加上执行时间，唤醒在延时到期后的第一个tick */
+    fail += SimCheck("delay task runs", res.delayCnt, simUs / (SIM_DELAY_US + SIM_US_PER_TICK) - 1,
+                     simUs / SIM_DELAY_US);
+    fail += SimCheck("delay wake late max (cycle)", res.delayWakeMax, 0, SIM_CYCLE_PER_TICK + SIM_BUSY_STEP);
+    fail += SimCheck("busy task steps", res.busyCnt, (unsigned long long)tickNum * SIM_CYCLE_PER_TICK /
+                     SIM_BUSY_STEP / 2, (unsigned long long)tickNum * SIM_CYCLE_PER_TICK / SIM_BUSY_STEP);
+    /* 同一tick唤醒的两个任务依次执行，每次唤醒至少一次切换 */
+    fail += SimCheck("task switches", res.stat.switchCnt, (unsigned long long)res.timerCnt + res.delayCnt, ~0ULL);
+    printf("idle cycles %llu, end cycle %llu\n", res.stat.idleCycle, res.stat.cycle);
+
+    /* 虚拟时间下调度可复现 */
+    if (SimRun(tickNum, &again) != 0) {
+        return 1;
+    }
+    fail += SimCheck("rerun identical", memcmp(&res, &again, sizeof(res)) == 0, 1, 1);
+    printf("%s\n", (fail == 0) ? "PASS" : "FAIL");
+    return (fail == 0) ? 0 : 1;
+}
@@ -0,0 +1,365 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      pfcsim.c
+  * @author    MCU Algorithm Team
+  * @brief     Host boost converter simulation of the power factor correction(PFC) control.
+  * @details   A switched model of a 1 or 2 phase interleaved boost PFC (rectified sine input, per-phase
+  *            inductors with diode conduction, bus capacitor, resistive load) runs in small steps, and the
+  *            unmodified pfc_curr_ctrl.c and pfc_volt_ctrl.c control it once per PWM period with one period
+  *            of duty delay, as on the APT shadow registers. The phase currents are sampled at the master
+  *            counter zero, the middle of the on time of phase 0 and of the off time of phase 1. Each
+  *            scenario settles at half power, then the load steps to full power. The simulation reports the
+  *            input current THD (harmonics 2 ~ 40, without the switching ripple) and power factor, the current
+  *            tracking error, the phase imbalance and the bus ripple at full power, and the voltage dip and
+  *            recovery after the load step.
+  *            Usage: pfcsim [-f pwmHz] [-p powerW] [-l inductanceUh] [-m phase1InductancePct]
+  */
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pfc_curr_ctrl.h"
+#include "pfc_volt_ctrl.h"
+#include "mcs_math.h"
+
+#define SIM_LINE_VRMS       220.0f
+#define SIM_LINE_FREQ       50.0f
+#define SIM_BUS_REF         390.0f
+#define SIM_BUS_CAP         1000e-6f
+#define SIM_VOLT_BASE       400.0f      /* Voltage of unitary 1 (V) */
+#define SIM_CURR_BASE       20.0f       /* Current of unitary 1 (A) */
+#define SIM_DUTY_MAX        0.95f
+#define SIM_STEPS_PER_PWM   200U
+#define SIM_VLOOP_DIV       8U          /* PWM periods per voltage loop run */
+#define SIM_RAMP_TIME       0.1f        /* Bus reference ramp from the rectified peak (s) */
+#define SIM_STEP_TIME       0.3f        /* Load step from half to full power (s) */
+#define SIM_MEAS_START      0.8f        /* Steady state window at full power, 10 line cycles (s) */
+#define SIM_END_TIME        1.0f
+#define SIM_RECOVER_BAND    0.01f       /* Recovered once the half line cycle average stays within 1% */
+#define SIM_NOTCH_Q         1.0f
+#define SIM_HARMONIC_MAX    40U         /* THD over the harmonics 2 ~ 40 of the PWM period averages */
+
+typedef struct {
+    const char *name;
+    unsigned int phaseNum;
+    PFC_CurrMode mode;
+    bool notch;
+    PI_Param currPi;
+    PI_Param voltPi;
+} SIM_Scenario;
+
+typedef struct {
+    float thd;          /* Input current THD up to SIM_HARMONIC_MAX (%) */
+    float pf;           /* Power factor */
+    float trackErr;     /* RMS current error at the samples, % of the peak reference */
+    float imbalance;    /* Mean |i0 - i1| over the mean phase current (%) */
+    float ripple;       /* Bus ripple peak to peak (V) */
+    float busAvg;       /* Bus average in the steady state window (V) */
+    float dip;          /* Lowest bus voltage below the reference after the load step (V) */
+    float recoverMs;    /* Recovery time after the load step (ms), negative if never */
+} SIM_Result;
+
+typedef struct {
+    float pwmFreq;
+    float power;
+    float inductance;
+    float phase1Pct;    /* Inductance of phase 1 in percent of phase 0 */
+} SIM_Config;
+
+/* Scenarios: the single channel PI of before, then interleaving, feed-forward, deadbeat and the notch. */
+static const SIM_Scenario g_scenario[] = {
+    {"1ph PI", 1, PFC_CURR_MODE_PI, false, {0.3f, 1500.0f, SIM_DUTY_MAX, 0.0f}, {2.5f, 30.0f, 0.8f, 0.0f}},
+    {"2ph PI", 2, PFC_CURR_MODE_PI, false, {0.3f, 1500.0f, SIM_DUTY_MAX, 0.0f}, {2.5f, 30.0f, 0.8f, 0.0f}},
+    {"2ph FF", 2, PFC_CURR_MODE_FF, false, {0.3f, 1500.0f, 0.3f, -0.3f}, {2.5f, 30.0f, 0.8f, 0.0f}},
+    {"2ph deadbeat", 2, PFC_CURR_MODE_DEADBEAT, false, {0.0f, 1000.0f, 0.2f, -0.2f}, {2.5f, 30.0f, 0.8f, 0.0f}},
+    {"2ph db + notch", 2, PFC_CURR_MODE_DEADBEAT, true, {0.0f, 1000.0f, 0.2f, -0.2f}, {8.0f, 300.0f, 0.8f, 0.0f}},
+};
+
+/* Host versions of the mcs_math.c functions used here, mcs_math.c needs the RISC-V float instructions. */
+float Clamp(float val, float upperLimit, float lowerLimit)
+{
+    return (val > upperLimit) ? upperLimit : ((val < lowerLimit) ? lowerLimit : val);
+}
+
+float Max(float val1, float val2)
+{
+    return (val1 > val2) ? val1 : val2;
+}
+
+float Min(float val1, float val2)
+{
+    return (val1 < val2) ? val1 : val2;
+}
+
+void TrigCalc(TrigVal *val, float angle)
+{
+    val->sin = sinf(angle);
+    val->cos = cosf(angle);
+}
+
+static int SimParseArgs(int argc, char **argv, SIM_Config *cfg)
+{
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            return -1;
+        }
+        float val = strtof(argv[i + 1], NULL);
+        if (strcmp(argv[i], "-f") == 0) {
+            cfg->pwmFreq = val;
+        } else if (strcmp(argv[i], "-p") == 0) {
+            cfg->power = val;
+        } else if (strcmp(argv[i], "-l") == 0) {
+            cfg->inductance = val * 1e-6f;
+        } else if (strcmp(argv[i], "-m") == 0) {
+            cfg->phase1Pct = val;
+        } else {
+            return -1;
+        }
+        i++;
+    }
+    return (cfg->pwmFreq > 0.0f && cfg->power > 0.0f && cfg->inductance > 0.0f && cfg->phase1Pct > 0.0f) ? 0 : -1;
+}
+
+static void SimCtrlInit(const SIM_Scenario *sc, const SIM_Config *cfg, PFC_CURRCTRL_Handle *curr,
+                        PFC_VOLTCTRL_Handle *volt)
+{
+    float ts = 1.0f / cfg->pwmFreq;
+    PFC_CurrCtrlParam param = {
+        .mode = sc->mode,
+        .phaseNum = sc->phaseNum,
+        .inductance = cfg->inductance,
+        .maxCurrFdbk = SIM_CURR_BASE,
+        .dutyMax = SIM_DUTY_MAX,
+        .dbGain = 0.8f,
+        .pi = sc->currPi,
+    };
+    memset(curr, 0, sizeof(*curr));
+    PFC_CurrCtrlInit(curr, &param, ts);
+
+    memset(volt, 0, sizeof(*volt));
+    PID_Reset(&volt->voltPiCtrl);
+    volt->voltPiCtrl.kp = sc->voltPi.kp;
+    volt->voltPiCtrl.ki = sc->voltPi.ki;
+    volt->voltPiCtrl.upperLimit = sc->voltPi.upperLim;
+    volt->voltPiCtrl.lowerLimit = sc->voltPi.lowerLim;
+    volt->voltPiCtrl.ts = ts * SIM_VLOOP_DIV;
+    if (sc->notch) {
+        PFC_VoltCtrlNotchInit(volt, SIM_LINE_FREQ, SIM_NOTCH_Q, ts * SIM_VLOOP_DIV);
+    }
+    PFC_VoltCtrlClear(volt);
+}
+
+/* Triangle carrier of an up-down counter, 0 at the counter zero and 1 at the period. */
+static float SimCarrier(double pwmPos)
+{
+    double frac = pwmPos - floor(pwmPos);
+    return (float)(1.0 - fabs(2.0 * frac - 1.0));
+}
+
+/* THD of the PWM period averages, the window starts at a line zero crossing and holds whole line cycles. */
+static float SimThd(const float *avg, unsigned int num, float pwmFreq)
+{
+    double amp2[SIM_HARMONIC_MAX + 1] = {0.0};
+    for (unsigned int h = 1; h <= SIM_HARMONIC_MAX; h++) {
+        double sumSin = 0.0;
+        double sumCos = 0.0;
+        for (unsigned int i = 0; i < num; i++) {
+            double w = 2.0 * M_PI * SIM_LINE_FREQ * h * (i + 0.5) / pwmFreq;
+            sumSin += avg[i] * sin(w);
+            sumCos += avg[i] * cos(w);
+        }
+        amp2[h] = (sumSin * sumSin + sumCos * sumCos) / ((double)num * num);
+    }
+    double harm2 = 0.0;
+    for (unsigned int h = 2; h <= SIM_HARMONIC_MAX; h++) {
+        harm2 += amp2[h];
+    }
+    return (num == 0 || amp2[1] <= 0.0) ? 0.0f : (float)(100.0 * sqrt(harm2 / amp2[1]));
+}
+
+static void SimRun(const SIM_Scenario *sc, const SIM_Config *cfg, SIM_Result *res)
+{
+    PFC_CURRCTRL_Handle curr;
+    PFC_VOLTCTRL_Handle volt;
+    SimCtrlInit(sc, cfg, &curr, &volt);
+
+    const float vPeak = SIM_LINE_VRMS * sqrtf(2.0f);
+    const double dt = 1.0 / (cfg->pwmFreq * SIM_STEPS_PER_PWM);
+    const float loadFull = SIM_BUS_REF * SIM_BUS_REF / cfg->power;
+    float ind[PFC_PHASE_MAX] = {cfg->inductance, cfg->inductance * cfg->phase1Pct / 100.0f};
+    float iL[PFC_PHASE_MAX] = {0.0f, 0.0f};
+    float duty[PFC_PHASE_MAX] = {0.0f, 0.0f};
+    float dutyNext[PFC_PHASE_MAX] = {0.0f, 0.0f};
+    float vBus = vPeak;
+    float busRef = vPeak;
+    unsigned int pwmCnt = 0;
+
+    /* Steady state window sums */
+    double sumP = 0.0, sumV2 = 0.0, sumI2 = 0.0, sumErr2 = 0.0, sumImb = 0.0, sumPeriod = 0.0;
+    double sumPhase = 0.0, sumBus = 0.0;
+    unsigned long long steps = 0, samples = 0;
+    float busMin = 1e9f, busMax = 0.0f;
+    float refPeak = 0.0f;
+
+    /* Load step: half line cycle averages */
+    double halfSum = 0.0;
+    unsigned long long halfCnt = 0;
+    unsigned long long halfSteps = (unsigned long long)(1.0 / (2.0 * SIM_LINE_FREQ) / dt + 0.5);
+    float lastOut = 0.0f;
+    res->dip = 0.0f;
+
+    /* Input current averaged over each PWM period in the steady state window, for the harmonics. */
+    unsigned int avgMax = (unsigned int)((SIM_END_TIME - SIM_MEAS_START) * cfg->pwmFreq) + 1;
+    unsigned int avgNum = 0;
+    float *avg = malloc(avgMax * sizeof(float));
+    if (avg == NULL) {
+        avgMax = 0;
+    }
+
+    unsigned long long endStep = (unsigned long long)(SIM_END_TIME / dt);
+    for (unsigned long long k = 0; k < endStep; k++) {
+        double t = k * dt;
+        double pwmPos = t * cfg->pwmFreq;
+        float vac = vPeak * (float)sin(2.0 * M_PI * SIM_LINE_FREQ * t);
+        float vin = fabsf(vac);
+
+        /* Control at the master counter zero, the duties are loaded at the next one. */
+        if (k % SIM_STEPS_PER_PWM == 0) {
+            for (unsigned int n = 0; n < sc->phaseNum; n++) {
+                duty[n] = dutyNext[n];
+            }
+            busRef = (t < SIM_RAMP_TIME) ? (vPeak + (SIM_BUS_REF - vPeak) * (float)(t / SIM_RAMP_TIME)) : SIM_BUS_REF;
+            if (pwmCnt++ % SIM_VLOOP_DIV == 0) {
+                volt.uniVoltRef = busRef / SIM_VOLT_BASE;
+                volt.unitVoltFdbk = vBus / SIM_VOLT_BASE;
+                PFC_VoltCtrlExec(&volt);
+            }
+            float iSum = 0.0f;
+            for (unsigned int n = 0; n < sc->phaseNum; n++) {
+                curr.phaseCurrFdbk[n] = iL[n];
+                iSum += iL[n];
+            }
+            curr.currRef = volt.voltOut * vin / vPeak;
+            curr.currFdbk = iSum;
+            curr.unitCurrFdbk = iSum / SIM_CURR_BASE;
+            curr.rectVoltFdbk = vin;
+            curr.busVoltFdbk = vBus;
+            PFC_CurrCtrlExec(&curr);
+            for (unsigned int n = 0; n < sc->phaseNum; n++) {
+                dutyNext[n] = curr.phaseDuty[n];
+            }
+            if (t >= SIM_MEAS_START) {
+                float err = curr.currRef * SIM_CURR_BASE - iSum;
+                sumErr2 += (double)err * err;
+                refPeak = fmaxf(refPeak, curr.currRef * SIM_CURR_BASE);
+                if (sc->phaseNum > 1) {
+                    sumImb += fabsf(iL[0] - iL[1]);
+                    sumPhase += iSum / sc->phaseNum;
+                }
+                samples++;
+            }
+        }
+
+        /* Power stage: inductor on when the carrier is below the duty, phase n lags by n/phaseNum. */
+        float iDiode = 0.0f;
+        for (unsigned int n = 0; n < sc->phaseNum; n++) {
+            bool on = SimCarrier(pwmPos - (double)n / sc->phaseNum) < duty[n];
+            float vL = on ? vin : (vin - vBus);
+            iL[n] += vL / ind[n] * (float)dt;
+            if (iL[n] < 0.0f) {
+                iL[n] = 0.0f;   /* Diode blocks, discontinuous conduction */
+            }
+            iDiode += on ? 0.0f : iL[n];
+        }
+        float load = (t < SIM_STEP_TIME) ? 2.0f * loadFull : loadFull;
+        vBus += (iDiode - vBus / load) / SIM_BUS_CAP * (float)dt;
+        if (vBus < vin) {
+            vBus = vin;         /* Bridge charges the bus directly */
+        }
+
+        float iIn = 0.0f;
+        for (unsigned int n = 0; n < sc->phaseNum; n++) {
+            iIn += iL[n];
+        }
+        float iac = (vac >= 0.0f) ? iIn : -iIn;
+        if (t >= SIM_MEAS_START) {
+            sumP += (double)vac * iac;
+            sumV2 += (double)vac * vac;
+            sumI2 += (double)iac * iac;
+            sumPeriod += iac;
+            if ((k + 1) % SIM_STEPS_PER_PWM == 0 && avgNum < avgMax) {
+                avg[avgNum++] = (float)(sumPeriod / SIM_STEPS_PER_PWM);
+                sumPeriod = 0.0;
+            }
+            sumBus += vBus;
+            busMin = fminf(busMin, vBus);
+            busMax = fmaxf(busMax, vBus);
+            steps++;
+        }
+        if (t >= SIM_STEP_TIME && t < SIM_MEAS_START) {
+            res->dip = fmaxf(res->dip, SIM_BUS_REF - vBus);
+            halfSum += vBus;
+            if (++halfCnt == halfSteps) {
+                float avg = (float)(halfSum / halfCnt);
+                if (fabsf(avg - SIM_BUS_REF) > SIM_BUS_REF * SIM_RECOVER_BAND) {
+                    lastOut = (float)(t - SIM_STEP_TIME);
+                }
+                halfSum = 0.0;
+                halfCnt = 0;
+            }
+        }
+    }
+
+    double iRms = sqrt(sumI2 / steps);
+    res->pf = (float)((sumP / steps) / (sqrt(sumV2 / steps) * iRms));
+    res->thd = SimThd(avg, avgNum, cfg->pwmFreq);
+    free(avg);
+    res->trackErr = (float)(100.0 * sqrt(sumErr2 / samples) / refPeak);
+    res->imbalance = (sumPhase > 0.0) ? (float)(100.0 * sumImb / sumPhase) : 0.0f;
+    res->ripple = busMax - busMin;
+    res->busAvg = (float)(sumBus / steps);
+    /* Still out of the band in the last half line cycle: not recovered. */
+    res->recoverMs = (lastOut >= SIM_MEAS_START - SIM_STEP_TIME - 1.0f / SIM_LINE_FREQ) ? -1.0f : lastOut * 1000.0f;
+}
+
+int main(int argc, char **argv)
+{
+    SIM_Config cfg = {.pwmFreq = 40000.0f, .power = 2000.0f, .inductance = 500e-6f, .phase1Pct = 90.0f};
+    if (SimParseArgs(argc, argv, &cfg) != 0) {
+        fprintf(stderr, "usage: pfcsim [-f pwmHz] [-p powerW] [-l inductanceUh] [-m phase1InductancePct]\n");
+        return 2;
+    }
+    printf("%.0f Vrms %.0f Hz -> %.0f V, %.0f W, PWM %.0f Hz, L %.0f uH (phase 1 %.0f%%), C %.0f uF\n",
+           SIM_LINE_VRMS, SIM_LINE_FREQ, SIM_BUS_REF, cfg.power, cfg.pwmFreq, cfg.inductance * 1e6f,
+           cfg.phase1Pct, SIM_BUS_CAP * 1e6f);
+    printf("%-16s %8s %7s %9s %9s %9s %9s %8s %10s\n", "scenario", "THD(%)", "PF", "track(%)", "imbal(%)",
+           "ripple(V)", "bus(V)", "dip(V)", "recov(ms)");
+    int ret = 0;
+    for (unsigned int i = 0; i < sizeof(g_scenario) / sizeof(g_scenario[0]); i++) {
+        SIM_Result res;
+        SimRun(&g_scenario[i], &cfg, &res);
+        printf("%-16s %8.2f %7.4f %9.2f %9.2f %9.2f %9.1f %8.1f %10.0f\n", g_scenario[i].name, res.thd, res.pf,
+               res.trackErr, res.imbalance, res.ripple, res.busAvg, res.dip, res.recoverMs);
+        /* Every scenario must regulate the bus and recover from the load step. */
+        if (fabsf(res.busAvg - SIM_BUS_REF) > SIM_BUS_REF * SIM_RECOVER_BAND || res.recoverMs < 0.0f) {
+            ret = 1;
+        }
+    }
+    return ret;
+}
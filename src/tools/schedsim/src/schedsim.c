@@ -0,0 +1,247 @@
+/**
+  * @copyright Copyright (c) 2022, HiSilicon (Shanghai) Technologies Co., Ltd. All rights reserved.
+  * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+  * following conditions are met:
+  * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+  * disclaimer.
+  * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the
+  * following disclaimer in the documentation and/or other materials provided with the distribution.
+  * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote
+  * products derived from this software without specific prior written permission.
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+  * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+  * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+  * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  * @file      schedsim.c
+  * @author    MCU Algorithm Team
+  * @brief     Host timeline simulation of the multi-rate control scheduler.
+  * @details   The plan of mcs_rate_sched.c is computed for a set of carrier ISRs and decimated loops, then the
+  *            interrupts are replayed on a single non-preemptive core in virtual time: every carrier raises
+  *            its interrupt at its phase, the pending interrupt with the lowest ISR id runs when the core is
+  *            free, and each control function takes a random execution time between execMin and 100 percent
+  *            of its budget. The simulation reports the start latency and the delayed runs per carrier and
+  *            draws the first hyperperiod. With -n the phases are forced to 0, as without the scheduler.
+  *            Usage: schedsim [-n] [-g guardNs] [-p hyperperiods] [-e execMinPct]
+  *                            [-i freqHz:budgetNs]... [-t isrId:freqHz:budgetNs]...
+  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mcs_rate_sched.h"
+
+#define SIM_DEFAULT_GUARD_NS    500U
+#define SIM_DEFAULT_PERIODS     1000U
+#define SIM_DEFAULT_EXEC_MIN    70U
+#define SIM_TIMELINE_COLS       100U
+
+typedef struct {
+    unsigned int budgetNs;
+    unsigned int maxExecNs;
+} SIM_Func;
+
+typedef struct {
+    unsigned long long nextArrival;     /* Next interrupt request (ns) */
+    unsigned long long pendingSince;    /* Request time of the pending interrupt */
+    bool pending;
+    unsigned long long maxLatency;      /* Longest request-to-start delay (ns) */
+    unsigned int delayCnt;              /* Runs started after their request, another carrier had the core */
+    unsigned int lostCnt;               /* Requests raised while the previous one was still pending */
+} SIM_Line;
+
+static unsigned long long g_now;
+static unsigned int g_execMinPct = SIM_DEFAULT_EXEC_MIN;
+static SIM_Func g_isrFunc[MRS_ISR_NUM];
+static SIM_Func g_taskFunc[MRS_TASK_NUM];
+static SIM_Line g_line[MRS_ISR_NUM];
+
+static unsigned int SimGetTick(void)
+{
+    return (unsigned int)g_now;
+}
+
+/* Control function: consume a random part of the budget in virtual time. */
+static void SimExec(void *arg)
+{
+    SIM_Func *func = (SIM_Func *)arg;
+    unsigned int minNs = (unsigned int)((unsigned long long)func->budgetNs * g_execMinPct / 100U);
+    unsigned int execNs = minNs + ((func->budgetNs > minNs) ? (unsigned int)rand() % (func->budgetNs - minNs + 1) : 0);
+    func->maxExecNs = (execNs > func->maxExecNs) ? execNs : func->maxExecNs;
+    g_now += execNs;
+}
+
+/* Default system: compressor and fan FOC at 16 kHz, interleaved PFC at 32 kHz, speed and voltage loops. */
+static void SimDefault(MRS_Handle *mrs)
+{
+    static const unsigned int isrCfg[][2] = {{16000, 11000}, {32000, 5000}, {16000, 11000}};
+    static const unsigned int taskCfg[][3] = {{0, 1000, 6000}, {2, 1000, 6000}, {1, 2000, 4000}};
+    for (unsigned int i = 0; i < sizeof(isrCfg) / sizeof(isrCfg[0]); i++) {
+        g_isrFunc[i].budgetNs = isrCfg[i][1];
+        MRS_IsrAdd(mrs, SimExec, &g_isrFunc[i], isrCfg[i][0], isrCfg[i][1]);
+    }
+    for (unsigned int i = 0; i < sizeof(taskCfg) / sizeof(taskCfg[0]); i++) {
+        g_taskFunc[i].budgetNs = taskCfg[i][2];
+        MRS_TaskAdd(mrs, taskCfg[i][0], SimExec, &g_taskFunc[i], taskCfg[i][1], taskCfg[i][2]);
+    }
+}
+
+static int SimParseArgs(int argc, char **argv, MRS_Handle *mrs, bool *noPhase, unsigned int *periods)
+{
+    unsigned int guardNs = SIM_DEFAULT_GUARD_NS;
+    bool custom = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0) {
+            *noPhase = true;
+        } else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc) {
+            guardNs = (unsigned int)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            *periods = (unsigned int)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            g_execMinPct = (unsigned int)strtoul(argv[++i], NULL, 0);
+        } else if ((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "-t") == 0) && i + 1 < argc) {
+            custom = true;
+            i++;
+        } else {
+            return -1;
+        }
+    }
+    mrs->guardNs = guardNs;
+    if (!custom) {
+        SimDefault(mrs);
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        unsigned int a, b, c;
+        if (strcmp(argv[i], "-i") == 0 && sscanf(argv[i + 1], "%u:%u", &a, &b) == 2) {
+            g_isrFunc[mrs->isrNum].budgetNs = b;
+            if (MRS_IsrAdd(mrs, SimExec, &g_isrFunc[mrs->isrNum], a, b) < 0) {
+                return -1;
+            }
+        } else if (strcmp(argv[i], "-t") == 0 && sscanf(argv[i + 1], "%u:%u:%u", &a, &b, &c) == 3) {
+            g_taskFunc[mrs->taskNum].budgetNs = c;
+            if (MRS_TaskAdd(mrs, a, SimExec, &g_taskFunc[mrs->taskNum], b, c) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void SimPrintPlan(const MRS_Handle *mrs)
+{
+    printf("hyperperiod %u ns, planned load %.1f%%\n", mrs->hyperNs, mrs->load * 100.0f);
+    for (unsigned int i = 0; i < mrs->isrNum; i++) {
+        const MRS_Isr *isr = &mrs->isr[i];
+        printf("isr %u: period %6u ns budget %6u ns window %6u ns phase %6u ns\n", i, isr->periodNs, isr->budgetNs,
+               isr->windowNs, isr->phaseNs);
+    }
+    for (unsigned int i = 0; i < mrs->taskNum; i++) {
+        const MRS_Task *task = &mrs->task[i];
+        printf("task %u: isr %u every %u runs at run %u, budget %u ns\n", i, task->isrId, task->divider,
+               task->slot, task->budgetNs);
+    }
+}
+
+/* Draw which carrier owns the core in the first hyperperiod, '.' is idle and '*' two carriers in a column. */
+static void SimTimelineMark(char *timeline, const MRS_Handle *mrs, unsigned long long start, unsigned long long end,
+                            unsigned int isrId)
+{
+    if (start >= mrs->hyperNs) {
+        return;
+    }
+    unsigned long long colNs = (mrs->hyperNs + SIM_TIMELINE_COLS - 1) / SIM_TIMELINE_COLS;
+    for (unsigned long long col = start / colNs; col * colNs < end && col < SIM_TIMELINE_COLS; col++) {
+        char mark = (char)('0' + isrId);
+        timeline[col] = (timeline[col] == '.' || timeline[col] == mark) ? mark : '*';
+    }
+}
+
+static void SimRun(MRS_Handle *mrs, unsigned int periods)
+{
+    char timeline[SIM_TIMELINE_COLS + 1];
+    memset(timeline, '.', SIM_TIMELINE_COLS);
+    timeline[SIM_TIMELINE_COLS] = '\0';
+    for (unsigned int i = 0; i < mrs->isrNum; i++) {
+        memset(&g_line[i], 0, sizeof(g_line[i]));
+        g_line[i].nextArrival = mrs->isr[i].phaseNs;
+    }
+    unsigned long long stop = (unsigned long long)mrs->hyperNs * periods;
+    g_now = 0;
+    while (g_now < stop) {
+        /* Raise the requests up to now, the core was busy or idle until now. */
+        unsigned long long nextEvent = stop;
+        for (unsigned int i = 0; i < mrs->isrNum; i++) {
+            SIM_Line *line = &g_line[i];
+            while (line->nextArrival <= g_now) {
+                line->lostCnt += line->pending ? 1U : 0U;
+                if (!line->pending) {
+                    line->pendingSince = line->nextArrival;
+                }
+                line->pending = true;
+                line->nextArrival += mrs->isr[i].periodNs;
+            }
+            nextEvent = (line->nextArrival < nextEvent) ? line->nextArrival : nextEvent;
+        }
+        unsigned int run = mrs->isrNum;
+        for (unsigned int i = 0; i < mrs->isrNum && run == mrs->isrNum; i++) {
+            run = g_line[i].pending ? i : run;
+        }
+        if (run == mrs->isrNum) {
+            g_now = nextEvent;
+            continue;
+        }
+        SIM_Line *line = &g_line[run];
+        unsigned long long latency = g_now - line->pendingSince;
+        line->maxLatency = (latency > line->maxLatency) ? latency : line->maxLatency;
+        line->delayCnt += (latency != 0) ? 1U : 0U;
+        line->pending = false;
+        unsigned long long start = g_now;
+        MRS_IsrRun(mrs, run);
+        SimTimelineMark(timeline, mrs, start, g_now, run);
+    }
+    printf("timeline of the first hyperperiod, %u ns per column:\n%s\n",
+           (unsigned int)((mrs->hyperNs + SIM_TIMELINE_COLS - 1) / SIM_TIMELINE_COLS), timeline);
+}
+
+static int SimReport(const MRS_Handle *mrs)
+{
+    int fail = 0;
+    for (unsigned int i = 0; i < mrs->isrNum; i++) {
+        const MRS_Isr *isr = &mrs->isr[i];
+        const SIM_Line *line = &g_line[i];
+        printf("isr %u: runs %u max exec %u ns max latency %llu ns max jitter %u ns delayed %u overruns %u "
+               "lost %u\n", i, isr->stat.runCnt, isr->stat.maxExecTick, line->maxLatency, isr->stat.maxJitterTick,
+               line->delayCnt, isr->stat.overrunCnt, line->lostCnt);
+        fail |= (line->delayCnt != 0 || isr->stat.overrunCnt != 0 || line->lostCnt != 0) ? 1 : 0;
+    }
+    return fail;
+}
+
+int main(int argc, char **argv)
+{
+    MRS_Handle mrs;
+    bool noPhase = false;
+    unsigned int periods = SIM_DEFAULT_PERIODS;
+    /* Virtual time in ns, the timestamp counts are ns. */
+    MRS_Init(&mrs, SimGetTick, MRS_NS_PER_S, SIM_DEFAULT_GUARD_NS);
+    if (SimParseArgs(argc, argv, &mrs, &noPhase, &periods) != 0 || g_execMinPct > 100U) {
+        fprintf(stderr, "usage: schedsim [-n] [-g guardNs] [-p hyperperiods] [-e execMinPct] "
+                "[-i freqHz:budgetNs]... [-t isrId:freqHz:budgetNs]...\n");
+        return 2;
+    }
+    if (MRS_Plan(&mrs) != 0) {
+        printf("plan failed: the budgets do not fit or the periods are not harmonic\n");
+        return 1;
+    }
+    if (noPhase) {
+        for (unsigned int i = 0; i < mrs.isrNum; i++) {
+            mrs.isr[i].phaseNs = 0;
+        }
+    }
+    SimPrintPlan(&mrs);
+    srand(1);
+    SimRun(&mrs, periods);
+    return SimReport(&mrs);
+}